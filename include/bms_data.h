@@ -10,12 +10,15 @@
 //
 // 📋 MODULE INFO:
 //    Module: BMS Data Structures and Management (Header-Only)
-//    Version: v4.0.2
+//    Version: v4.0.5
 //    Created: 13.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.0.5 - 18.10.2026 - Raw fixed-point frame fields (frames 190/290/310/390/510) for integer register encoding
+//    v4.0.4 - 18.10.2026 - Field quality and frame age register offsets
+//    v4.0.3 - 18.10.2026 - Slot map management functions
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v4.0.1 - 13.08.2025 - Fixed field naming and added multiplexed data support
 //    v4.0.0 - 13.08.2025 - Initial BMS data structure implementation
@@ -67,6 +70,10 @@ struct BMSData {
   float batteryCurrent = 0.0;          // [A] Prąd baterii (+ = ładowanie, - = rozładowanie)
   float remainingEnergy = 0.0;         // [kWh] Pozostała energia
   float soc = 0.0;                     // [%] Stan naładowania
+  uint16_t batteryVoltageRaw = 0;      // [0.01 V] Surowe wartości z ramki - float wyżej liczony z nich
+  uint16_t batteryCurrentRaw = 0;      // [0.01 A]
+  uint16_t remainingEnergyRaw = 0;     // [0.01 kWh]
+  uint8_t socRaw = 0;                  // [0.5 %]
   
   // Frame 0x190 - flagi błędów (NAPRAWIONE NAZWY)
   bool masterError = false;            // Master error flag
@@ -81,6 +88,8 @@ struct BMSData {
   // Frame 0x290 - napięcia ogniw
   float cellMinVoltage = 0.0;          // [V] Minimalne napięcie ogniwa
   float cellMeanVoltage = 0.0;         // [V] Średnie napięcie ogniwa
+  uint16_t cellMinVoltageRaw = 0;      // [0.1 mV]
+  uint16_t cellMeanVoltageRaw = 0;     // [0.1 mV]
   uint8_t minVoltageBlock = 0;         // Blok z min napięciem
   uint8_t minVoltageCell = 0;          // Ogniwo z min napięciem
   uint8_t minVoltageString = 0;        // String z min napięciem
@@ -93,6 +102,8 @@ struct BMSData {
   int8_t cellMinTemperature = 0;       // [°C] Minimalna temperatura ogniwa
   int8_t cellMeanTemperature = 0;      // [°C] Średnia temperatura ogniwa
   float dcir = 0.0;                    // [mΩ] Impedancja wewnętrzna DC
+  uint16_t sohRaw = 0;                 // [0.01 %]
+  uint16_t dcirRaw = 0;                // [0.01 mΩ]
   bool nonEqualStringsRamp = false;    // Non-equal strings ramp
   bool dynamicLimitationTimer = false; // Dynamic limitation timer
   bool overcurrentTimer = false;       // Overcurrent timer
@@ -101,6 +112,8 @@ struct BMSData {
   // Frame 0x390 - maksymalne napięcia ogniw
   float cellMaxVoltage = 0.0;          // [V] Maksymalne napięcie ogniwa
   float cellVoltageDelta = 0.0;        // [V] Delta napięć ogniw
+  uint16_t cellMaxVoltageRaw = 0;      // [0.1 mV]
+  uint16_t cellVoltageDeltaRaw = 0;    // [0.1 mV]
   uint8_t maxVoltageBlock = 0;         // Blok z max napięciem
   uint8_t maxVoltageCell = 0;          // Ogniwo z max napięciem
   uint8_t maxVoltageString = 0;        // String z max napięciem
@@ -118,6 +131,8 @@ struct BMSData {
   // Frame 0x510 - limity mocy i I/O
   float dccl = 0.0;                    // [A] Discharge Current Continuous Limit
   float ddcl = 0.0;                    // [A] Discharge Power Continuous Limit
+  uint16_t dcclRaw = 0;                // [0.1 A]
+  uint16_t ddclRaw = 0;                // [0.1 A]
   uint8_t inputs = 0;                  // Raw input byte
   uint8_t outputs = 0;                 // Raw output byte
   bool input_IN02 = false;             // Wejście IN02
@@ -231,6 +246,10 @@ bool initializeBMSData();
 void resetBMSData(uint8_t nodeId);
 void resetAllBMSData();
 
+// Slot map management (live reconfiguration without reboot)
+void rebuildBMSNodeSlotMap();                                       // Przebuduj mapę nodeId -> slot z systemConfig
+bool remapBMSDataSlots(const uint8_t* oldNodeIds, int oldNodeCount); // Przenieś dane węzłów do nowych slotów
+
 // Data access functions
 BMSData* getBMSData(uint8_t nodeId);
 int getBMSIndexByNodeId(uint8_t nodeId);
@@ -312,6 +331,21 @@ inline bool getBMSMasterError(uint8_t nodeId) {
 #define BMS_REG_CANOPEN_STATE       110  // CANopen state
 #define BMS_REG_COMM_OK             111  // Communication OK (0/1)
 #define BMS_REG_PACKETS_RECEIVED    112  // Packets received count
+#define BMS_REG_QUALITY_BASE        140  // Field quality, 2 bits per register Base+0..133 (17 registers)
+#define BMS_REG_QUALITY_SUMMARY     157  // Worst quality of the core frames 190-510 (0-3)
+#define BMS_REG_FRAME_AGE_BASE      160  // Age per BMSFrameType_t [0.1s], 0xFFFF = never (9 registers)
+#define BMS_REG_COMM_AGE            169  // Age of the node's last frame [0.1s], 0xFFFF = never
+
+// === FIELD QUALITY ===
+// 2-bit codes, TrioDataQuality_t levels folded to four steps
+#define BMS_QUALITY_FIELDS          134  // Base+0..133 carry a quality code
+#define BMS_QUALITY_CODE_INVALID    0    // Never received, reserved, or older than the timeout
+#define BMS_QUALITY_CODE_POOR       1    // Older than BMS_QUALITY_LATE_MS
+#define BMS_QUALITY_CODE_FAIR       2    // Older than BMS_QUALITY_FRESH_MS
+#define BMS_QUALITY_CODE_GOOD       3
+#define BMS_QUALITY_FRESH_MS        5000
+#define BMS_QUALITY_LATE_MS         15000 // POOR until BMS_COMMUNICATION_TIMEOUT_MS, then INVALID
+#define BMS_FRAME_AGE_REGISTERS     1    // 0 = leave Base+160-169 at zero
 
 // === MULTIPLEXER TYPE FUNCTIONS ===
 const char* getMultiplexerTypeName(uint8_t type);
@@ -10,12 +10,19 @@
 //
 // 📋 MODULE INFO:
 //    Module: BMS Protocol Parser and CAN Interface
-//    Version: v4.0.2
+//    Version: v4.0.9
 //    Created: 17.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.0.9 - 18.10.2026 - Failed CAN re-init flagged in BMSReconfigStats_t, effective bitrate accessor
+//    v4.0.8 - 18.10.2026 - CAN error counters and bus-off recovery moved to the per-channel layer (can_bus)
+//    v4.0.7 - 18.10.2026 - Identical payloads of slow-changing frames skip decode (freshness only)
+//    v4.0.6 - 18.10.2026 - Side-effect-free frame decoder shared by the parsers and the signal table check
+//    v4.0.5 - 18.10.2026 - Budgeted CAN dispatch slices with backlog statistics
+//    v4.0.4 - 18.10.2026 - MCP2515 error counter sampling and automatic bus-off recovery
+//    v4.0.3 - 18.10.2026 - Live reconfiguration API and reconfig statistics
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v4.0.1 - 17.08.2025 - Added all main functions and CAN handling (replaced can_handler)
 //    v4.0.0 - 17.08.2025 - Initial BMS protocol implementation with 9 parsers
@@ -100,6 +107,7 @@ bool initializeCAN();
 bool initializeMCP2515();
 void shutdownCAN();
 bool isCANInitialized();
+bool recoverCANController();       // Bus-off recovery of the primary MCP2515 (called by can_bus)
 
 // CAN processing
 void processCANMessages();         // Rzeczywiste przetwarzanie ramek CAN
@@ -128,6 +136,9 @@ void parseBMSFrame490(uint8_t nodeId, unsigned char* data);  // 🔥 Multiplexed
 void parseBMSFrame1B0(uint8_t nodeId, unsigned char* data);  // Additional data
 void parseBMSFrame710(uint8_t nodeId, unsigned char* data);  // CANopen status
 
+// Field decoding of the parsers without counters, timestamps or events
+void decodeBMSFrameData(BMSFrameType_t frameType, const unsigned char* data, BMSData* bms);
+
 // === 🔥 FRAME TYPE DETECTION ===
 
 bool isFrame190(unsigned long canId);  // Basic data
@@ -262,6 +273,85 @@ typedef struct {
   
 } BMSProtocolStats_t;
 
+// === 🔥 LIVE RECONFIGURATION (bez restartu urządzenia) ===
+
+typedef struct {
+  unsigned long reconfigCount;       // Applied reconfigurations (node list and/or CAN speed)
+  unsigned long canReinitCount;      // Reconfigurations that re-initialized the MCP2515
+  unsigned long failedReconfigCount; // CAN re-init failures during reconfiguration
+  unsigned long lastDowntimeUs;      // Time frame processing was suspended by the last reconfig
+  unsigned long maxDowntimeUs;       // Worst reconfiguration downtime since boot
+  unsigned long lastReconfigTime;    // millis() of the last reconfiguration
+  uint8_t activeCanSpeed;            // Bitrate currently programmed into the MCP2515
+  bool reinitFailed;                 // Last CAN re-init failed; cleared by the next successful one
+  uint8_t failedCanSpeed;            // Bitrate the failed re-init tried
+  unsigned long lastFailureTime;     // millis() of the last failed re-init
+} BMSReconfigStats_t;
+
+bool applyBMSReconfiguration(const uint8_t* nodeIds, int nodeCount, uint8_t canSpeed);
+bool requestBMSReconfiguration(const uint8_t* nodeIds, int nodeCount, uint8_t canSpeed, bool persist);
+bool isBMSReconfigurationPending();
+const BMSReconfigStats_t* getBMSReconfigStats();
+uint16_t getCANSpeedKbps(uint8_t canSpeed);
+uint8_t getEffectiveCANSpeed(uint8_t canSpeed);  // What the MCP2515 is programmed with for a configured value
+
+// === 🔥 CAN DISPATCH BUDGET (ograniczony czas na przebieg pętli) ===
+
+// One processCANMessages() call dispatches at most a frame budget that grows
+// with the ring backlog (MIN when nearly empty, MAX when full) and stops at
+// the time budget; what is left is served on the next loop pass.
+#define CAN_SLICE_MIN_FRAMES            8
+#define CAN_SLICE_MAX_FRAMES            48
+#define CAN_SLICE_BUDGET_US             2000
+#define CAN_SLICE_OVERLOAD_DEPTH        48    // Ring backlog that doubles the time budget
+
+typedef struct {
+  unsigned long slices;              // processCANMessages() calls that had frames
+  unsigned long framesDispatched;
+  unsigned long frameLimitHits;      // Slice ended on the frame budget
+  unsigned long timeLimitHits;       // Slice ended on the time budget
+  unsigned long backlogSlices;       // Slices that left frames for the next pass
+  uint8_t lastFrameBudget;
+  uint8_t lastBacklog;               // Frames left after the last slice
+  uint8_t peakBacklog;
+  unsigned long lastSliceUs;
+  unsigned long maxSliceUs;
+} CANSliceStats_t;
+
+uint16_t getCANBacklog();          // Frames waiting in all channel rings
+uint8_t getCANSliceFrameBudget(uint16_t backlog);
+const CANSliceStats_t* getCANSliceStats();
+
+// === 🔥 DUPLICATE PAYLOAD SUPPRESSION (ramki bez zmian) ===
+
+// Slow-changing frames repeat the same payload cycle after cycle. The last
+// payload is cached per (node, frame type); an identical one only refreshes
+// the node's freshness (timestamps, frame counter, communication status) and
+// skips decoding, the frame event and so the Modbus remap. A repeated
+// payload is still fully parsed every BMS_DEDUP_REPARSE_MS.
+#define BMS_DEDUP_DEFAULT_TYPES         ((1U << BMS_FRAME_TYPE_310) | (1U << BMS_FRAME_TYPE_390) | \
+                                         (1U << BMS_FRAME_TYPE_410) | (1U << BMS_FRAME_TYPE_1B0) | \
+                                         (1U << BMS_FRAME_TYPE_710))
+#define BMS_DEDUP_REPARSE_MS            1000
+#define BMS_DEDUP_TIMING_SAMPLE         16    // One eligible frame in 16 is timed
+
+typedef struct {
+  bool enabled;
+  uint16_t typeMask;                 // Eligible BMS frame types (1 << BMSFrameType_t)
+  unsigned long parsed[BMS_FRAME_TYPE_COUNT];      // Eligible frames fully parsed
+  unsigned long suppressed[BMS_FRAME_TYPE_COUNT];  // Identical payloads, freshness only
+  unsigned long parseUs[BMS_FRAME_TYPE_COUNT];     // Sampled full parses: time
+  unsigned long parseSamples[BMS_FRAME_TYPE_COUNT];
+  unsigned long suppressedUs;        // Sampled suppressed frames: time
+  unsigned long suppressedSamples;
+  unsigned long savedUs;             // suppressed x (mean parse - mean suppressed frame)
+} BMSDedupStats_t;
+
+void setBMSDedupEnabled(bool enabled);
+void setBMSDedupTypes(uint16_t typeMask);
+void resetBMSDedupStats();          // Also empties the payload cache
+const BMSDedupStats_t* getBMSDedupStats();
+
 // Statistics functions
 BMSProtocolStats_t* getBMSProtocolStats();
 void resetBMSProtocolStats();
@@ -0,0 +1,167 @@
+// =====================================================================
+// === bms_sdo.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: BMS CANopen SDO Client
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Expedited/segmented SDO upload, per-node pipelining, value cache
+//
+// 🎯 DEPENDENCIES:
+//    Internal: bms_protocol.h (CAN controller, frame routing), bms_data.h (node slots)
+//    External: Arduino.h, MCP2515 library
+//
+// 📝 DESCRIPTION:
+//    On-demand reads of BMS object dictionary entries over CANopen SDO
+//    (request 0x600 + node, response 0x580 + node) instead of waiting for the
+//    frame 0x490 multiplex cycle. Each node has one SDO channel, so one
+//    transfer is outstanding per node while different nodes are served in
+//    parallel. Results land in a small cache tagged with status and the time
+//    they were read; a request with a max age is answered from the cache
+//    without bus traffic when the entry is young enough.
+//
+//    Requests can come from the main loop (Modbus) or from the web server
+//    task; the queue and the cache are guarded by a spinlock, the channels
+//    are only touched from processBMSSdo() and the CAN receive path.
+//
+// 🔧 CONFIGURATION:
+//    - Channels: one per BMS slot (MAX_BMS_NODES)
+//    - Queue: 32 requests, cache: 48 objects of up to 32 bytes
+//    - Response timeout: 200ms, 1 retry
+//    - Modbus window: 5300-5327 (see BMS_SDO_REG_* below)
+//
+// ⚠️  KNOWN ISSUES:
+//    - Upload (read) only; download and block transfers are not implemented
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Expedited read: 1 request + 1 response frame (~2ms at 125 kbps)
+//    - Segmented read: 1 + 2 frames per 7 data bytes
+//    - Cache hit: no bus traffic, answered immediately
+//    - Memory: ~3.5KB (cache ~2.5KB, channels ~0.8KB, queue ~0.2KB)
+//
+// =====================================================================
+
+#ifndef BMS_SDO_H
+#define BMS_SDO_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// === SDO CONSTANTS ===
+#define BMS_SDO_REQUEST_BASE          0x600   // Client -> server (0x600 + node)
+#define BMS_SDO_RESPONSE_BASE         0x580   // Server -> client (0x580 + node)
+#define BMS_SDO_MAX_DATA              32      // Largest object kept in the cache [bytes]
+#define BMS_SDO_CACHE_SIZE            48
+#define BMS_SDO_QUEUE_SIZE            32
+#define BMS_SDO_TIMEOUT_MS            200
+#define BMS_SDO_MAX_RETRIES           1
+#define BMS_SDO_DEFAULT_MAX_AGE_MS    1000
+
+// SDO abort codes (CiA 301) used by the client
+#define BMS_SDO_ABORT_TOGGLE          0x05030000UL  // Toggle bit not alternated
+#define BMS_SDO_ABORT_TIMEOUT         0x05040000UL  // SDO protocol timed out
+#define BMS_SDO_ABORT_COMMAND         0x05040001UL  // Command specifier not valid
+#define BMS_SDO_ABORT_OUT_OF_MEMORY   0x05040005UL  // Object larger than the cache slot
+
+// === MODBUS WINDOW (directly after the TRIO HP parameter window) ===
+#define BMS_SDO_MODBUS_START_REGISTER 5300
+#define BMS_SDO_REG_NODE              0   // RW: node ID to read from
+#define BMS_SDO_REG_INDEX             1   // RW: object index
+#define BMS_SDO_REG_SUBINDEX          2   // RW: object sub-index
+#define BMS_SDO_REG_MAX_AGE           3   // RW: accepted cache age [ms]
+#define BMS_SDO_REG_COMMAND           4   // W: 1 = read (cache if fresh), 2 = force read
+#define BMS_SDO_REG_STATUS            5   // R: BMSSdoStatus_t of the selected object
+#define BMS_SDO_REG_AGE               6   // R: age of the cached value [ms], saturating
+#define BMS_SDO_REG_LENGTH            7   // R: data length [bytes]
+#define BMS_SDO_REG_ABORT_HI          8   // R: abort code bits 31-16
+#define BMS_SDO_REG_ABORT_LO          9   // R: abort code bits 15-0
+#define BMS_SDO_REG_VALUE_HI          10  // R: value bits 31-16 (objects up to 4 bytes)
+#define BMS_SDO_REG_VALUE_LO          11  // R: value bits 15-0
+#define BMS_SDO_REG_DATA              12  // R: raw bytes, 2 per register, first byte high
+#define BMS_SDO_MODBUS_REGISTERS      (BMS_SDO_REG_DATA + BMS_SDO_MAX_DATA / 2)
+
+#define BMS_SDO_CMD_READ              1
+#define BMS_SDO_CMD_FORCE_READ        2
+
+// === CACHED OBJECT STATUS (freshness tag) ===
+typedef enum {
+  BMS_SDO_STATUS_EMPTY = 0,     // Never requested
+  BMS_SDO_STATUS_PENDING,       // Queued or in transfer
+  BMS_SDO_STATUS_VALID,         // Value read successfully
+  BMS_SDO_STATUS_ABORTED,       // Server or client aborted, see abortCode
+  BMS_SDO_STATUS_TIMEOUT,       // No response after retries
+  BMS_SDO_STATUS_UNAVAILABLE    // Node unknown, stopped or CAN down
+} BMSSdoStatus_t;
+
+// === CACHE ENTRY ===
+typedef struct {
+  uint8_t nodeId;
+  uint16_t index;
+  uint8_t subIndex;
+  uint8_t status;               // BMSSdoStatus_t
+  uint8_t length;               // Valid bytes in data
+  uint8_t data[BMS_SDO_MAX_DATA];
+  uint32_t abortCode;
+  unsigned long requestedAt;    // millis() when the current read was requested
+  unsigned long updatedAt;      // millis() of the last completed read (any result)
+  unsigned long validAt;        // millis() of the last successful read
+  bool everValid;               // validAt/data hold a previous good value
+} BMSSdoEntry_t;
+
+// === CLIENT STATISTICS ===
+typedef struct {
+  unsigned long requests;          // Accepted read requests
+  unsigned long cacheHits;         // Answered from cache without bus traffic
+  unsigned long expeditedReads;    // Completed in one frame
+  unsigned long segmentedReads;    // Completed with upload segments
+  unsigned long aborts;            // Aborted by server or client
+  unsigned long timeouts;          // No response after retries
+  unsigned long retries;           // Re-sent initiate requests
+  unsigned long sendErrors;        // MCP2515 refused the request frame
+  unsigned long queueOverflows;    // Requests rejected on a full queue
+  unsigned long lastLatencyMs;     // Request to value of the last read
+  unsigned long maxLatencyMs;      // Worst request to value since boot
+  unsigned long avgLatencyMs;      // Running average request to value
+  uint8_t queued;                  // Requests waiting for a free channel
+  uint8_t inFlight;                // Channels with an open transfer
+} BMSSdoStats_t;
+
+// === SDO CLIENT FUNCTIONS ===
+void initBMSSdo();
+void processBMSSdo();                                             // Main loop: dispatch and timeouts
+bool isBMSSdoResponseFrame(unsigned long canId);
+void handleBMSSdoResponse(unsigned long canId, const unsigned char* buf);  // From parseCANFrame
+
+// Request a read; true if queued or already fresh in the cache
+bool requestBMSSdoRead(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                       unsigned long maxAgeMs = BMS_SDO_DEFAULT_MAX_AGE_MS);
+
+// === CACHE ACCESS (safe from any task) ===
+bool getBMSSdoEntry(uint8_t nodeId, uint16_t index, uint8_t subIndex, BMSSdoEntry_t* out);
+bool getBMSSdoEntryAt(uint8_t slot, BMSSdoEntry_t* out);  // Cache slot 0..CACHE_SIZE-1, false if empty
+bool getBMSSdoStats(BMSSdoStats_t* out);
+const char* getBMSSdoStatusName(uint8_t status);
+void printBMSSdoStatus();
+
+// === MODBUS WINDOW ===
+bool isBMSSdoRegisterRange(uint16_t startAddress, uint16_t count);
+bool readBMSSdoRegister(uint16_t address, uint16_t* value);
+bool writeBMSSdoRegister(uint16_t address, uint16_t value);
+
+#endif // BMS_SDO_H
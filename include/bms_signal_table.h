@@ -0,0 +1,101 @@
+// =====================================================================
+// === bms_signal_table.h - generated by scripts/dbc_compile.py from docs/bms_frames.dbc ===
+// === Do not edit: regenerate from the DBC ===
+// =====================================================================
+
+#ifndef BMS_SIGNAL_TABLE_H
+#define BMS_SIGNAL_TABLE_H
+
+#include <Arduino.h>
+
+static const uint8_t bmsSignalTable[1392] __attribute__((aligned(4))) = {
+  0x53, 0x49, 0x47, 0x54, 0x01, 0x00, 0x08, 0x00, 0x23, 0x00, 0xD8, 0x01, 0x00, 0x00, 0x00, 0x00,
+  0x91, 0x01, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x91, 0x02, 0x00, 0x00, 0x08, 0x00, 0x05, 0x08,
+  0x11, 0x03, 0x00, 0x00, 0x0D, 0x00, 0x04, 0x08, 0x91, 0x03, 0x00, 0x00, 0x11, 0x00, 0x05, 0x08,
+  0x11, 0x04, 0x00, 0x00, 0x16, 0x00, 0x07, 0x08, 0x91, 0x04, 0x00, 0x00, 0x1D, 0x00, 0x01, 0x08,
+  0x11, 0x05, 0x00, 0x00, 0x1E, 0x00, 0x04, 0x08, 0x11, 0x07, 0x00, 0x00, 0x22, 0x00, 0x01, 0x01,
+  0x30, 0x10, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0A, 0xD7, 0x23, 0x3C, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x66, 0xD6, 0x23, 0x44, 0x20, 0x10, 0x01, 0x00, 0x0F, 0x00, 0x00, 0x00,
+  0x0A, 0xD7, 0x23, 0x3C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x66, 0xD6, 0x23, 0x44,
+  0x10, 0x10, 0x01, 0x00, 0x1E, 0x00, 0x00, 0x00, 0x0A, 0xD7, 0x23, 0x3C, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x66, 0xD6, 0x23, 0x44, 0x30, 0x08, 0x00, 0x00, 0x2E, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x42,
+  0x38, 0x01, 0x00, 0x00, 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x39, 0x01, 0x00, 0x00, 0x3E, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F,
+  0x3A, 0x01, 0x00, 0x00, 0x4F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x3B, 0x01, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F,
+  0x00, 0x10, 0x00, 0x00, 0x71, 0x00, 0x00, 0x00, 0x17, 0xB7, 0xD1, 0x38, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x46, 0xB6, 0xD1, 0x40, 0x10, 0x10, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00,
+  0x17, 0xB7, 0xD1, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46, 0xB6, 0xD1, 0x40,
+  0x20, 0x08, 0x00, 0x00, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43, 0x28, 0x08, 0x00, 0x00, 0xA1, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43,
+  0x30, 0x08, 0x00, 0x00, 0xB1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43, 0x00, 0x10, 0x00, 0x00, 0xC0, 0x00, 0x00, 0x00,
+  0x0A, 0xD7, 0x23, 0x3C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x66, 0xD6, 0x23, 0x44,
+  0x10, 0x10, 0x00, 0x00, 0xC4, 0x00, 0x00, 0x00, 0x0A, 0xD7, 0x23, 0x3C, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x66, 0xD6, 0x23, 0x44, 0x20, 0x08, 0x00, 0x00, 0xC9, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x20, 0xC2, 0x00, 0x00, 0x20, 0xC2, 0x00, 0x00, 0x57, 0x43,
+  0x28, 0x08, 0x00, 0x00, 0xDC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x20, 0xC2,
+  0x00, 0x00, 0x20, 0xC2, 0x00, 0x00, 0x57, 0x43, 0x00, 0x10, 0x00, 0x00, 0xF0, 0x00, 0x00, 0x00,
+  0x17, 0xB7, 0xD1, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46, 0xB6, 0xD1, 0x40,
+  0x10, 0x10, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x17, 0xB7, 0xD1, 0x38, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x46, 0xB6, 0xD1, 0x40, 0x20, 0x08, 0x00, 0x00, 0x10, 0x01, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43,
+  0x28, 0x08, 0x00, 0x00, 0x21, 0x01, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43, 0x30, 0x08, 0x00, 0x00, 0x31, 0x01, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43,
+  0x00, 0x08, 0x00, 0x00, 0x40, 0x01, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x20, 0xC2,
+  0x00, 0x00, 0x20, 0xC2, 0x00, 0x00, 0x57, 0x43, 0x08, 0x08, 0x00, 0x00, 0x53, 0x01, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43,
+  0x10, 0x08, 0x00, 0x00, 0x61, 0x01, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43, 0x18, 0x08, 0x00, 0x00, 0x6F, 0x01, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43,
+  0x20, 0x08, 0x00, 0x00, 0x7C, 0x01, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43, 0x28, 0x01, 0x00, 0x00, 0x8A, 0x01, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F,
+  0x29, 0x01, 0x00, 0x00, 0x98, 0x01, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x08, 0x04, 0x00, 0xA9, 0x01, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x42,
+  0x00, 0x10, 0x00, 0x00, 0xB1, 0x01, 0x00, 0x00, 0xCD, 0xCC, 0xCC, 0x3D, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0xCC, 0xCC, 0x45, 0x10, 0x10, 0x00, 0x00, 0xB6, 0x01, 0x00, 0x00,
+  0xCD, 0xCC, 0xCC, 0x3D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xCC, 0xCC, 0x45,
+  0x20, 0x08, 0x00, 0x00, 0xBB, 0x01, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43, 0x28, 0x08, 0x00, 0x00, 0xC2, 0x01, 0x00, 0x00,
+  0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43,
+  0x00, 0x08, 0x00, 0x00, 0xCA, 0x01, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x43, 0x42, 0x61, 0x74, 0x74, 0x65, 0x72, 0x79, 0x56,
+  0x6F, 0x6C, 0x74, 0x61, 0x67, 0x65, 0x00, 0x42, 0x61, 0x74, 0x74, 0x65, 0x72, 0x79, 0x43, 0x75,
+  0x72, 0x72, 0x65, 0x6E, 0x74, 0x00, 0x52, 0x65, 0x6D, 0x61, 0x69, 0x6E, 0x69, 0x6E, 0x67, 0x45,
+  0x6E, 0x65, 0x72, 0x67, 0x79, 0x00, 0x53, 0x6F, 0x63, 0x00, 0x4D, 0x61, 0x73, 0x74, 0x65, 0x72,
+  0x45, 0x72, 0x72, 0x6F, 0x72, 0x00, 0x43, 0x65, 0x6C, 0x6C, 0x56, 0x6F, 0x6C, 0x74, 0x61, 0x67,
+  0x65, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x00, 0x43, 0x65, 0x6C, 0x6C, 0x54, 0x65, 0x6D, 0x70, 0x4D,
+  0x69, 0x6E, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x00, 0x43, 0x65, 0x6C, 0x6C, 0x54, 0x65, 0x6D, 0x70,
+  0x4D, 0x61, 0x78, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x00, 0x43, 0x65, 0x6C, 0x6C, 0x4D, 0x69, 0x6E,
+  0x56, 0x6F, 0x6C, 0x74, 0x61, 0x67, 0x65, 0x00, 0x43, 0x65, 0x6C, 0x6C, 0x4D, 0x65, 0x61, 0x6E,
+  0x56, 0x6F, 0x6C, 0x74, 0x61, 0x67, 0x65, 0x00, 0x4D, 0x69, 0x6E, 0x56, 0x6F, 0x6C, 0x74, 0x61,
+  0x67, 0x65, 0x53, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x00, 0x4D, 0x69, 0x6E, 0x56, 0x6F, 0x6C, 0x74,
+  0x61, 0x67, 0x65, 0x42, 0x6C, 0x6F, 0x63, 0x6B, 0x00, 0x4D, 0x69, 0x6E, 0x56, 0x6F, 0x6C, 0x74,
+  0x61, 0x67, 0x65, 0x43, 0x65, 0x6C, 0x6C, 0x00, 0x53, 0x6F, 0x68, 0x00, 0x44, 0x63, 0x69, 0x72,
+  0x00, 0x43, 0x65, 0x6C, 0x6C, 0x4D, 0x69, 0x6E, 0x54, 0x65, 0x6D, 0x70, 0x65, 0x72, 0x61, 0x74,
+  0x75, 0x72, 0x65, 0x00, 0x43, 0x65, 0x6C, 0x6C, 0x4D, 0x65, 0x61, 0x6E, 0x54, 0x65, 0x6D, 0x70,
+  0x65, 0x72, 0x61, 0x74, 0x75, 0x72, 0x65, 0x00, 0x43, 0x65, 0x6C, 0x6C, 0x4D, 0x61, 0x78, 0x56,
+  0x6F, 0x6C, 0x74, 0x61, 0x67, 0x65, 0x00, 0x43, 0x65, 0x6C, 0x6C, 0x56, 0x6F, 0x6C, 0x74, 0x61,
+  0x67, 0x65, 0x44, 0x65, 0x6C, 0x74, 0x61, 0x00, 0x4D, 0x61, 0x78, 0x56, 0x6F, 0x6C, 0x74, 0x61,
+  0x67, 0x65, 0x53, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x00, 0x4D, 0x61, 0x78, 0x56, 0x6F, 0x6C, 0x74,
+  0x61, 0x67, 0x65, 0x42, 0x6C, 0x6F, 0x63, 0x6B, 0x00, 0x4D, 0x61, 0x78, 0x56, 0x6F, 0x6C, 0x74,
+  0x61, 0x67, 0x65, 0x43, 0x65, 0x6C, 0x6C, 0x00, 0x43, 0x65, 0x6C, 0x6C, 0x4D, 0x61, 0x78, 0x54,
+  0x65, 0x6D, 0x70, 0x65, 0x72, 0x61, 0x74, 0x75, 0x72, 0x65, 0x00, 0x43, 0x65, 0x6C, 0x6C, 0x54,
+  0x65, 0x6D, 0x70, 0x44, 0x65, 0x6C, 0x74, 0x61, 0x00, 0x4D, 0x61, 0x78, 0x54, 0x65, 0x6D, 0x70,
+  0x53, 0x74, 0x72, 0x69, 0x6E, 0x67, 0x00, 0x4D, 0x61, 0x78, 0x54, 0x65, 0x6D, 0x70, 0x42, 0x6C,
+  0x6F, 0x63, 0x6B, 0x00, 0x4D, 0x61, 0x78, 0x54, 0x65, 0x6D, 0x70, 0x53, 0x65, 0x6E, 0x73, 0x6F,
+  0x72, 0x00, 0x52, 0x65, 0x61, 0x64, 0x79, 0x54, 0x6F, 0x43, 0x68, 0x61, 0x72, 0x67, 0x65, 0x00,
+  0x52, 0x65, 0x61, 0x64, 0x79, 0x54, 0x6F, 0x44, 0x69, 0x73, 0x63, 0x68, 0x61, 0x72, 0x67, 0x65,
+  0x00, 0x4D, 0x75, 0x78, 0x54, 0x79, 0x70, 0x65, 0x00, 0x44, 0x63, 0x63, 0x6C, 0x00, 0x44, 0x64,
+  0x63, 0x6C, 0x00, 0x49, 0x6E, 0x70, 0x75, 0x74, 0x73, 0x00, 0x4F, 0x75, 0x74, 0x70, 0x75, 0x74,
+  0x73, 0x00, 0x43, 0x61, 0x6E, 0x6F, 0x70, 0x65, 0x6E, 0x53, 0x74, 0x61, 0x74, 0x65, 0x00, 0x00,
+};
+
+#endif // BMS_SIGNAL_TABLE_H
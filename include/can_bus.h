@@ -0,0 +1,213 @@
+// =====================================================================
+// === can_bus.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: CAN Channel Layer (multi-bus)
+//    Version: v1.4.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Two CAN channels, protocol binding, per-channel ingest ring and stats
+//    v1.1.0 - 18.10.2026 - Exact frame bit-times (with stuffing) from the load estimator
+//    v1.2.0 - 18.10.2026 - RX interrupt wake-up for the main loop, burst replay into the ring
+//    v1.3.0 - 18.10.2026 - Transmit on an explicit channel (virtual BMS emitter)
+//    v1.4.0 - 18.10.2026 - TEC/REC sampling and bus-off recovery per channel (MCP2515 EFLG, TWAI status)
+//
+// 🎯 DEPENDENCIES:
+//    Internal: config.h (CAN2_* options), bms_protocol.h (primary MCP2515)
+//    External: MCP2515 library, ESP-IDF TWAI driver (only with CAN2_DRIVER_TWAI)
+//
+// 📝 DESCRIPTION:
+//    Channel 0 is the primary MCP2515 owned by bms_protocol (initialization,
+//    live reconfiguration). Channel 1 is an optional second
+//    controller selected at build time with CAN2_DRIVER: a second MCP2515 on
+//    the shared SPI bus or the on-chip TWAI peripheral. Each protocol stack
+//    (BMS, TRIO HP) is bound to a channel; with a second channel present the
+//    TRIO HP command/poll traffic moves off the BMS bus by default.
+//
+//    Received frames are drained from the controller into a per-channel
+//    ingest ring and dispatched from there, so the small hardware RX buffers
+//    (2 on the MCP2515) are emptied before parsing starts.
+//
+//    The primary MCP2515's INT line wakes the main loop when it is idle
+//    (canBusWaitForFrame), so a frame does not wait for a full tick. For
+//    load tests a burst of recently received frames can be replayed into a
+//    ring as if the controller had just delivered them.
+//
+//    Every channel samples its error counters (MCP2515 EFLG/TEC/REC, TWAI
+//    status info) and recovers from bus-off on its own backoff schedule:
+//    the MCP2515 is re-initialized, the TWAI controller runs its 128x11
+//    recessive-bit recovery and is restarted.
+//
+// 🔧 CONFIGURATION:
+//    - CAN2_DRIVER: CAN2_DRIVER_NONE (default), CAN2_DRIVER_MCP2515, CAN2_DRIVER_TWAI
+//    - Ring: 64 frames per channel
+//    - Utilisation window: 1s, exact frame length with stuff bits (can_load)
+//
+// ⚠️  KNOWN ISSUES:
+//    - Error frames are estimated from TEC/REC increments (lower bound under load)
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Drain: one SPI read per frame (MCP2515) or one queue pop (TWAI)
+//    - Memory: ~1.3KB ring + ~170 bytes stats per channel
+//    - Error sampling: 3 SPI register reads (MCP2515) per channel every 100ms
+//
+// =====================================================================
+
+#ifndef CAN_BUS_H
+#define CAN_BUS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// === CHANNELS AND PROTOCOLS ===
+#define CAN_CHANNEL_COUNT             2
+#define CAN_CHANNEL_PRIMARY           0    // MCP2515 on CAN_CS_PIN
+#define CAN_CHANNEL_SECONDARY         1    // CAN2_DRIVER
+#define CAN_RING_SIZE                 64   // Power of two
+#define CAN_UTILISATION_WINDOW_MS     1000
+
+typedef enum {
+  CAN_DRIVER_NONE = 0,
+  CAN_DRIVER_MCP2515,
+  CAN_DRIVER_TWAI
+} CANDriverType_t;
+
+typedef enum {
+  CAN_PROTOCOL_BMS = 0,
+  CAN_PROTOCOL_TRIO,
+  CAN_PROTOCOL_COUNT
+} CANProtocol_t;
+
+// === FRAME ===
+typedef struct {
+  unsigned long id;
+  bool extended;
+  uint8_t len;
+  uint8_t data[8];
+} CANFrame_t;
+
+// === ERROR MONITORING (TEC/REC, bus-off recovery) ===
+
+// MCP2515 EFLG register bits (TWAI status is mapped onto the same flags)
+#define CAN_EFLG_RX1OVR                 0x80
+#define CAN_EFLG_RX0OVR                 0x40
+#define CAN_EFLG_TXBO                   0x20  // Bus-off (TEC > 255)
+#define CAN_EFLG_TXEP                   0x10  // TX error-passive (TEC >= 128)
+#define CAN_EFLG_RXEP                   0x08  // RX error-passive (REC >= 128)
+#define CAN_EFLG_TXWAR                  0x04
+#define CAN_EFLG_RXWAR                  0x02
+#define CAN_EFLG_EWARN                  0x01  // TEC or REC >= 96
+
+#define CAN_ERROR_SAMPLE_INTERVAL_MS    100
+#define CAN_BUSOFF_BACKOFF_MIN_MS       100   // First recovery attempt after bus-off detection
+#define CAN_BUSOFF_BACKOFF_MAX_MS       5000  // Backoff doubles up to this
+#define CAN_ERROR_RATE_ALPHA            0.2f  // Error frame rate smoothing
+
+typedef enum {
+  CAN_ERROR_STATE_ACTIVE = 0,
+  CAN_ERROR_STATE_WARNING,
+  CAN_ERROR_STATE_PASSIVE,
+  CAN_ERROR_STATE_BUS_OFF
+} CANErrorState_t;
+
+typedef struct {
+  uint8_t state;                     // CANErrorState_t from the last sample
+  uint8_t tec;                       // Transmit error counter
+  uint8_t rec;                       // Receive error counter
+  uint8_t eflg;                      // EFLG register (MCP2515) or equivalent flags (TWAI)
+  uint8_t peakTec;
+  uint8_t peakRec;
+  unsigned long samples;
+  unsigned long warningCount;        // Transitions into each state
+  unsigned long errorPassiveCount;
+  unsigned long busOffCount;
+  unsigned long rxOverflowCount;     // RX overflow seen (EFLG flag set / TWAI overrun count grew)
+  unsigned long errorFrameEstimate;  // Error frames inferred from TEC/REC increments
+  float errorFrameRate;              // Smoothed estimate [frames/s]
+  bool recoveryActive;               // Bus-off detected, not yet recovered
+  unsigned long recoveryAttempts;    // MCP2515 re-initializations / TWAI recovery starts
+  unsigned long recoveries;          // Bus-off episodes that ended
+  unsigned long failedRecoveries;    // Attempts the controller refused
+  unsigned long currentBackoffMs;
+  unsigned long lastBusOffTime;      // millis() of the last bus-off detection
+  unsigned long lastRecoveryMs;      // Bus-off detection to error-active/warning
+  unsigned long maxRecoveryMs;
+} CANErrorStats_t;
+
+// === PER-CHANNEL STATISTICS ===
+typedef struct {
+  uint8_t driver;                   // CANDriverType_t
+  bool initialized;
+  uint16_t bitrateKbps;
+  unsigned long rxFrames;           // Drained into the ring
+  unsigned long txFrames;
+  unsigned long rxReadErrors;       // Controller reported a frame but read failed
+  unsigned long txErrors;           // Controller refused a frame
+  unsigned long ringOverflows;      // Frames dropped on a full ring
+  unsigned long replayedFrames;     // Injected by a burst replay (not counted as RX)
+  uint8_t ringDepth;                // Frames waiting right now
+  uint8_t ringPeakDepth;
+  unsigned long windowBits;         // On-wire bits in the current window (RX + TX)
+  float utilisation;                // Last complete window [%]
+  float peakUtilisation;            // Highest window since boot [%]
+  CANErrorStats_t errors;           // Controller error state and bus-off recovery
+} CANChannelStats_t;
+
+// === CHANNEL FUNCTIONS ===
+bool initCANBus();                  // After initializeCAN(); channel 1 and bindings survive BMS restarts
+bool isCANChannelAvailable(uint8_t channel);
+
+// Protocol binding
+bool bindCANProtocol(CANProtocol_t protocol, uint8_t channel);
+uint8_t getCANProtocolChannel(CANProtocol_t protocol);
+CANProtocol_t getCANFrameProtocol(uint8_t channel, bool extended);  // Owner of a received frame
+
+// Transmit on the channel bound to the protocol
+bool canBusSend(CANProtocol_t protocol, unsigned long id, bool extended, uint8_t len, const uint8_t* data);
+// Transmit on a given channel; the frame is accounted to the protocol in the stats
+bool canBusSendChannel(uint8_t channel, CANProtocol_t protocol, unsigned long id, bool extended,
+                       uint8_t len, const uint8_t* data);
+
+// Receive: drain controller into the ring, then pop frames
+uint8_t canBusDrain(uint8_t channel);
+bool canBusPop(uint8_t channel, CANFrame_t* frame);
+uint8_t canBusBacklog(uint8_t channel);           // Frames waiting in the ring
+
+// Idle wait: returns early when the primary MCP2515 signals a frame on CAN_INT_PIN
+bool canBusWaitForFrame(uint32_t timeoutMs);
+
+// Load testing: on each of the next `bursts` drains, re-inject the last `frames`
+// frames received on the channel (at most CAN_RING_SIZE - 1)
+bool requestCANBurstReplay(uint8_t channel, uint8_t frames, uint16_t bursts);
+
+// === ERROR MONITORING ===
+void sampleCANErrorCounters();      // Every channel, rate-limited (main loop, also while a channel is down)
+void updateCANErrorCounters(uint8_t channel, uint8_t eflg, uint8_t tec, uint8_t rec,
+                            unsigned long now);  // One sample, also used by host mocks
+const CANErrorStats_t* getCANErrorStats(uint8_t channel);
+const char* getCANErrorStateName(uint8_t state);
+
+// === STATISTICS ===
+void updateCANBusUtilisation();     // Closes the window every CAN_UTILISATION_WINDOW_MS
+const CANChannelStats_t* getCANChannelStats(uint8_t channel);
+float getCANCombinedUtilisation();  // Both channels' traffic as if on channel 0 [%]
+const char* getCANDriverName(uint8_t driver);
+const char* getCANProtocolName(uint8_t protocol);
+void printCANBusStatus();
+
+#endif // CAN_BUS_H
@@ -0,0 +1,146 @@
+// =====================================================================
+// === can_load.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: CAN Bus Load Estimator
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Exact frame bit-times, per-ID/node/protocol windows, alerts, poll budget
+//
+// 🎯 DEPENDENCIES:
+//    Internal: can_bus.h (channels, protocol binding), trio_hp_protocol.h (TRIO HP addresses)
+//    External: Arduino.h
+//
+// 📝 DESCRIPTION:
+//    Every frame received or sent through can_bus is charged with its exact
+//    on-wire length: the frame is serialised (SOF..CRC, CRC-15 computed),
+//    stuff bits counted, and the fixed tail (delimiters, ACK, EOF, IFS)
+//    added. The worst-case length for an ID format and DLC is available
+//    separately for planning (Davis et al.: 135 bits standard / 160 bits
+//    extended at DLC 8).
+//
+//    Bits are kept in 1s buckets per channel, protocol, CAN ID and node;
+//    the last bucket gives the current load, the last 10 buckets the
+//    sliding-window load. A channel above the alert threshold raises an
+//    alert (with hysteresis). Pollers ask canLoadAdmit() before a burst:
+//    it fails when the burst, at worst-case length, would push the channel
+//    above the budget target.
+//
+// 🔧 CONFIGURATION:
+//    - Buckets: 1s, sliding window 10 buckets
+//    - Tracked: 48 CAN IDs, 32 nodes (inactive entries are reused)
+//    - Alert: above 70%, cleared below 60%; poll budget target 60%
+//
+// ⚠️  KNOWN ISSUES:
+//    - Error frames and retransmissions are not on the ingest path and are
+//      not counted (see getCANErrorStats(channel) for the error frame estimate)
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Exact length: ~130 bit iterations per frame, a few us on the S3
+//    - Memory: ~5KB (ID table ~2.9KB, node table ~1.8KB)
+//
+// =====================================================================
+
+#ifndef CAN_LOAD_H
+#define CAN_LOAD_H
+
+#include <Arduino.h>
+#include "can_bus.h"
+
+// === ESTIMATOR CONFIGURATION ===
+#define CAN_LOAD_BUCKET_MS            1000
+#define CAN_LOAD_WINDOW_BUCKETS       10     // Sliding window = 10 complete buckets
+#define CAN_LOAD_MAX_IDS              48
+#define CAN_LOAD_MAX_NODES            32
+#define CAN_LOAD_ALERT_PERCENT        70.0f
+#define CAN_LOAD_ALERT_CLEAR_PERCENT  60.0f
+#define CAN_LOAD_BUDGET_PERCENT       60.0f  // Pollers keep the channel below this
+#define CAN_LOAD_RETRY_MS             250    // Deferred poll burst retried after this
+#define CAN_LOAD_NODE_NONE            0xFF
+
+// === PER-CHANNEL LOAD ===
+typedef struct {
+  unsigned long frames;
+  unsigned long bits;               // Total on-wire bits since boot
+  unsigned long stuffBits;          // Of which stuff bits
+  float loadNow;                    // Last complete bucket [%]
+  float loadWindow;                 // Sliding window [%]
+  float peakLoad;                   // Highest bucket since boot [%]
+  bool alertActive;
+  unsigned long alerts;             // Alert raises since boot
+  unsigned long lastAlertAt;        // millis() of the last raise
+} CANLoadChannelStats_t;
+
+// === PER-PROTOCOL LOAD ===
+typedef struct {
+  unsigned long frames;
+  unsigned long bits;
+  float loadNow;                    // Share of its channel [%]
+  float loadWindow;
+  unsigned long admitted;           // Poll bursts allowed by the budget
+  unsigned long deferred;           // Poll bursts pushed back by the budget
+} CANLoadProtocolStats_t;
+
+// === PER-ID / PER-NODE SNAPSHOT ===
+typedef struct {
+  unsigned long id;
+  bool extended;
+  uint8_t channel;
+  uint8_t protocol;                 // CANProtocol_t
+  uint8_t node;                     // CAN_LOAD_NODE_NONE if not derivable
+  unsigned long frames;             // Since the entry was created
+  uint16_t lastFrameBits;           // Exact length of the last frame
+  float loadNow;
+  float loadWindow;
+} CANLoadIdStats_t;
+
+typedef struct {
+  uint8_t protocol;
+  uint8_t node;
+  uint8_t channel;
+  unsigned long frames;
+  float loadNow;
+  float loadWindow;
+} CANLoadNodeStats_t;
+
+// === FRAME LENGTH ===
+uint16_t canFrameBitsExact(unsigned long id, bool extended, uint8_t len, const uint8_t* data,
+                           uint8_t* stuffBitsOut = nullptr);
+uint16_t canFrameBitsWorstCase(bool extended, uint8_t len);
+
+// === ESTIMATOR FUNCTIONS ===
+void initCANLoad();
+uint16_t canLoadAccountFrame(uint8_t channel, CANProtocol_t protocol, unsigned long id,
+                             bool extended, uint8_t len, const uint8_t* data);  // Returns exact bits
+void updateCANLoad();               // Main loop: closes buckets, evaluates alerts
+
+// Budget for pollers: true if `bits` more this bucket keep the protocol's
+// channel below CAN_LOAD_BUDGET_PERCENT; counted as admitted/deferred
+bool canLoadAdmit(CANProtocol_t protocol, uint32_t bits);
+float getCANLoadHeadroom(CANProtocol_t protocol);  // Budget target minus current load [%], >= 0
+
+// === STATISTICS ===
+const CANLoadChannelStats_t* getCANLoadChannelStats(uint8_t channel);
+const CANLoadProtocolStats_t* getCANLoadProtocolStats(uint8_t protocol);
+bool getCANLoadIdStats(uint8_t slot, CANLoadIdStats_t* out);      // Slot 0..MAX_IDS-1, false if free
+bool getCANLoadNodeStats(uint8_t slot, CANLoadNodeStats_t* out);  // Slot 0..MAX_NODES-1, false if free
+unsigned long getCANLoadUntrackedFrames();
+void printCANLoadStatus();
+
+#endif // CAN_LOAD_H
@@ -0,0 +1,143 @@
+// =====================================================================
+// === can_rules.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Runtime CAN-to-Register Mapping Rules
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - JSON rules on LittleFS compiled into a hashed dispatch table
+//
+// 🎯 DEPENDENCIES:
+//    Internal: bms_data.h (holding registers)
+//    External: Arduino.h, LittleFS
+//
+// 📝 DESCRIPTION:
+//    Third-party CAN devices are mapped to Modbus holding registers without
+//    new parser code. /can_rules.json on LittleFS (uploaded with
+//    "pio run -t uploadfs") holds the rules:
+//
+//      { "rules": [
+//        { "name": "pack_v", "id": "0x351", "byte": 0, "length": 16,
+//          "endian": "little", "scale": 0.1, "register": 3000 },
+//        { "name": "pack_i", "id": "0x351", "byte": 2, "length": 16,
+//          "signed": true, "scale": 0.1, "register": 3001 },
+//        { "name": "alarm", "id": "0x18FF0000", "mask": "0x1FFF0000",
+//          "extended": true, "byte": 7, "bit": 3, "length": 1, "register": 3002 }
+//      ] }
+//
+//    Required: "id", "byte", "length", "register". "byte" is the first
+//    byte of the field in the frame, "bit" the offset of its least
+//    significant bit (0-7, default 0), "length" 1-32 bits. "endian" is
+//    "little" (default) or "big"; big endian fields start with their most
+//    significant byte at "byte". Register value = round(raw * scale +
+//    offset) (defaults 1 and 0), stored as 16-bit two's complement. "mask"
+//    defaults to all ID bits, "extended" to id > 0x7FF; with several masks
+//    the most specific one that matches wins.
+//
+//    Loading compiles the rules into extraction ops (shift, value mask,
+//    sign bit and scaling decided once) grouped by CAN ID, and an
+//    open-addressing hash table per distinct mask. A frame costs one hash
+//    probe per mask in use plus one shift/mask per field. A broken file
+//    leaves the previous table active. Frames matched by a rule that are
+//    not BMS frames are not passed to the BMS parsers.
+//
+// 🔧 CONFIGURATION:
+//    - Rules: 64, distinct masks: 4, hash table: 128 buckets
+//    - Rule file: up to 8KB
+//
+// ⚠️  KNOWN ISSUES:
+//    - Target registers are the BMS holding registers (0-3199): use the
+//      slots of BMS nodes that are not configured
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Frame without a rule: one multiplicative hash + probe per mask
+//    - benchmarkCANRules() times the rule path against a hand-written
+//      decoder of the same fields (BMS frame 190 layout)
+//    - Memory: ~6KB active table; loading and the benchmark allocate a
+//      staging table on the heap while they run
+//
+// =====================================================================
+
+#ifndef CAN_RULES_H
+#define CAN_RULES_H
+
+#include <Arduino.h>
+
+// === RULE CONFIGURATION ===
+#define CAN_RULES_FILE                "/can_rules.json"
+#define CAN_RULES_MAX                 64
+#define CAN_RULES_MAX_MASKS           4
+#define CAN_RULES_TABLE_SIZE          128    // Power of two, >= 2 x distinct IDs
+#define CAN_RULES_MAX_FILE_SIZE       8192
+#define CAN_RULES_NAME_LENGTH         16
+
+// === RULE INFO (as loaded) ===
+typedef struct {
+  char name[CAN_RULES_NAME_LENGTH];
+  uint32_t id;
+  uint32_t mask;
+  bool extended;
+  uint8_t byte;
+  uint8_t bit;
+  uint8_t length;
+  bool bigEndian;
+  bool isSigned;
+  float scale;
+  float offset;
+  uint16_t reg;
+  unsigned long hits;
+} CANRuleInfo_t;
+
+typedef struct {
+  unsigned long loads;
+  unsigned long loadErrors;
+  char lastError[64];
+  uint8_t rules;
+  uint8_t ids;                      // Distinct (id, mask, extended)
+  uint8_t masks;
+  uint8_t maxProbe;                 // Longest probe sequence in the table
+  unsigned long framesMatched;
+  unsigned long fieldsDecoded;
+  unsigned long loadedAt;           // millis()
+} CANRulesStats_t;
+
+typedef struct {
+  uint32_t iterations;
+  float handNsPerFrame;             // Hand-written decoder of the same fields
+  float rulesNsPerFrame;            // Hash lookup + compiled ops
+  float ratio;                      // rules / hand
+  bool outputsMatch;
+} CANRulesBenchmark_t;
+
+// === RULE FUNCTIONS ===
+bool initCANRules();                // Mounts LittleFS and loads CAN_RULES_FILE
+bool loadCANRules(const char* path);
+bool loadCANRulesFromText(const char* json, size_t length);
+bool applyCANRules(unsigned long id, bool extended, uint8_t len, const uint8_t* data);  // true if a rule matched
+void requestCANRulesReload();       // From another task; applied by processCANRulesReload()
+void processCANRulesReload();       // Main loop
+
+// === STATISTICS ===
+const CANRulesStats_t* getCANRulesStats();
+uint8_t getCANRuleCount();
+bool getCANRuleInfo(uint8_t index, CANRuleInfo_t* out);
+bool benchmarkCANRules(uint32_t iterations, CANRulesBenchmark_t* out);
+void printCANRulesStatus();
+
+#endif // CAN_RULES_H
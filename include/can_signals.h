@@ -0,0 +1,156 @@
+// =====================================================================
+// === can_signals.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: DBC Signal Tables and Bit-Extraction Kernel
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Binary signal tables compiled from DBC, generic decode kernel, BMS parser check
+//
+// 🎯 DEPENDENCIES:
+//    Internal: bms_protocol.h (parser check), bms_signal_table.h (generated)
+//    External: Arduino.h, LittleFS
+//
+// 📝 DESCRIPTION:
+//    Vendor DBC files are compiled on the host by scripts/dbc_compile.py
+//    into a compact binary table (layout in the script header) and
+//    uploaded as /signals.bin. The table is used in place: no per-signal
+//    setup at load, the image is only validated.
+//
+//    The kernel loads the frame once as a little endian 64-bit word and
+//    byte-swaps it for Motorola signals; a signal is then
+//    (word >> shift) & (~0 >> (64 - length)), a sign extension by shift
+//    pair for signed signals and one multiply-add. Multiplexed signals
+//    whose mux value differs from the frame's multiplexor, and signals the
+//    frame is too short for, decode to NAN.
+//
+//    Decoded values of the loaded table are kept per signal for
+//    /api/can/signals. docs/bms_frames.dbc describes our BMS frames; its
+//    compiled table (bms_signal_table.h) is checked against the BMS
+//    parsers (decodeBMSFrameData) at boot and on request.
+//
+// 🔧 CONFIGURATION:
+//    - Table file: /signals.bin, up to 16KB
+//    - Parser check: 64 payloads per BMS frame type
+//
+// ⚠️  KNOWN ISSUES:
+//    - Values are float: raw values above 2^24 lose precision
+//    - Only simple multiplexing (one multiplexor per message)
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Message lookup: binary search over sorted IDs
+//    - Per signal: shift, mask, optional sign extension, multiply-add
+//    - Memory: table file size + 4 bytes per signal (last values)
+//
+// =====================================================================
+
+#ifndef CAN_SIGNALS_H
+#define CAN_SIGNALS_H
+
+#include <Arduino.h>
+
+// === TABLE FORMAT ===
+#define SIGNAL_TABLE_MAGIC            0x54474953UL   // "SIGT"
+#define SIGNAL_TABLE_VERSION          1
+#define SIGNAL_TABLE_FILE             "/signals.bin"
+#define SIGNAL_TABLE_MAX_FILE_SIZE    16384
+#define SIGNAL_ID_EXTENDED            0x80000000UL   // Message id flag (DBC convention)
+
+#define SIGNAL_FLAG_MOTOROLA          0x01
+#define SIGNAL_FLAG_SIGNED            0x02
+#define SIGNAL_FLAG_MULTIPLEXOR       0x04
+#define SIGNAL_FLAG_MULTIPLEXED       0x08
+
+#define SIGNAL_VERIFY_PAYLOADS        64
+
+typedef struct {
+  uint32_t magic;
+  uint8_t version;
+  uint8_t flags;
+  uint16_t messageCount;
+  uint16_t signalCount;
+  uint16_t stringBytes;
+  uint32_t reserved;
+} SignalTableHeader_t;              // 16 bytes
+
+typedef struct {
+  uint32_t id;                      // SIGNAL_ID_EXTENDED for 29-bit IDs
+  uint16_t firstSignal;
+  uint8_t signalCount;
+  uint8_t dlc;
+} SignalMessage_t;                  // 8 bytes
+
+typedef struct {
+  uint8_t shift;                    // Into the little (Intel) or big (Motorola) endian frame word
+  uint8_t length;                   // 1-64 bits
+  uint8_t flags;                    // SIGNAL_FLAG_*
+  uint8_t muxValue;                 // Multiplexed signals
+  uint16_t nameOffset;              // Into the string block
+  uint16_t reserved;
+  float scale;
+  float offset;
+  float minimum;
+  float maximum;
+} SignalDef_t;                      // 24 bytes
+
+// Validated view of a table image
+typedef struct {
+  const SignalTableHeader_t* header;
+  const SignalMessage_t* messages;
+  const SignalDef_t* signals;
+  const char* strings;
+} SignalTable_t;
+
+typedef struct {
+  bool loaded;
+  uint16_t messages;
+  uint16_t signals;
+  uint32_t tableBytes;
+  unsigned long framesDecoded;
+  unsigned long signalsDecoded;
+  unsigned long outOfRange;         // Outside the DBC [min|max]
+  unsigned long loadErrors;
+  char lastError[48];
+} CANSignalsStats_t;
+
+typedef struct {
+  uint32_t checks;                  // Field comparisons
+  uint32_t mismatches;
+  char firstMismatch[48];           // "<signal> 0x<payload>"
+} SignalVerifyResult_t;
+
+// === KERNEL ===
+bool openSignalTable(const uint8_t* image, size_t size, SignalTable_t* table);
+const SignalMessage_t* findSignalMessage(const SignalTable_t* table, uint32_t id, bool extended);
+uint8_t decodeSignals(const SignalTable_t* table, const SignalMessage_t* message,
+                      const uint8_t* data, uint8_t len, float* values);   // Returns signals decoded
+const char* getSignalName(const SignalTable_t* table, uint16_t signal);
+
+// === LOADED TABLE ===
+bool initCANSignals();              // Loads SIGNAL_TABLE_FILE, checks the BMS table
+bool applyCANSignals(unsigned long id, bool extended, uint8_t len, const uint8_t* data);  // true if the message is in the table
+const SignalTable_t* getCANSignalTable();   // nullptr without a table
+float getCANSignalValue(uint16_t signal);   // NAN before the first frame
+const CANSignalsStats_t* getCANSignalsStats();
+
+// === BMS PARSER CHECK ===
+bool verifyBMSSignalTable(SignalVerifyResult_t* result);
+void printCANSignalsStatus();
+
+#endif // CAN_SIGNALS_H
@@ -10,12 +10,13 @@
 //
 // 📋 MODULE INFO:
 //    Module: System Configuration and EEPROM Management
-//    Version: v4.0.2
+//    Version: v4.0.3
 //    Created: 13.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.0.3 - 18.10.2026 - Optional second CAN channel (MCP2515 or TWAI) for TRIO HP traffic
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v4.0.1 - 13.08.2025 - Fixed all compilation errors and missing definitions
 //    v4.0.0 - 13.08.2025 - Initial configuration system implementation
@@ -190,6 +191,18 @@ const char* const WIFI_PASSWORD = "PiotrStrzykalskiNieIstnieje"; // to poprawne
 // === CAN PIN DEFINITIONS ===
 #define CAN_CS_PIN SPI_CS_PIN
 
+// === SECOND CAN CHANNEL (optional, dedicated TRIO HP bus) ===
+#define CAN2_DRIVER_NONE     0
+#define CAN2_DRIVER_MCP2515  1    // Second MCP2515 on the shared SPI bus
+#define CAN2_DRIVER_TWAI     2    // On-chip TWAI controller + external transceiver
+#ifndef CAN2_DRIVER
+#define CAN2_DRIVER CAN2_DRIVER_NONE
+#endif
+#define CAN2_CS_PIN       10
+#define CAN2_TWAI_TX_PIN  17
+#define CAN2_TWAI_RX_PIN  18
+#define CAN2_SPEED        CAN_125KBPS
+
 // CAN speed constants are defined in mcp_can_dfs.h
 
 // === DEBUG MACROS ===
@@ -0,0 +1,141 @@
+// =====================================================================
+// === event_bus.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Internal Event Bus (publish/subscribe)
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Typed events, per-subscriber SPSC queues, drop/depth statistics
+//
+// 🎯 DEPENDENCIES:
+//    Internal: none
+//    External: Arduino.h, FreeRTOS (task handle of the producer)
+//
+// 📝 DESCRIPTION:
+//    Subsystems publish typed events once; every subscriber whose mask
+//    matches gets its own copy in a bounded single-producer/single-consumer
+//    ring. The producer is the main loop task (CAN receive, TRIO HP
+//    manager, Modbus TCP); each subscriber polls its ring from its own
+//    task. Head and tail are written by one side each, with acquire/
+//    release ordering, so neither side ever takes a lock.
+//
+//    A full ring drops the new event for that subscriber only and counts
+//    it. Consumers that mirror state (Modbus registers, fleet limits)
+//    watch their drop counter and resynchronise from the source when it
+//    moves, so a drop costs a full refresh rather than stale data.
+//
+// 🔧 CONFIGURATION:
+//    - Subscribers: up to 6, registered during setup
+//    - Queue: 64 events (16 bytes) per subscriber
+//
+// ⚠️  KNOWN ISSUES:
+//    - Publishing from a task other than the producer is refused (counted),
+//      since it would break the single-producer rings
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Publish: one 16-byte copy per matching subscriber, no allocation
+//    - Memory: ~6.3KB (6 x 64 x 16 bytes + counters)
+//
+// =====================================================================
+
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <Arduino.h>
+
+// === BUS CONFIGURATION ===
+#define EVENT_BUS_MAX_SUBSCRIBERS     6
+#define EVENT_QUEUE_SIZE              64     // Power of two
+#define EVENT_SUBSCRIBER_NAME_LENGTH  12
+#define EVENT_MASK(type)              (1UL << (type))
+#define EVENT_MASK_ALL                0xFFFFFFFFUL
+
+// === EVENT TYPES ===
+typedef enum {
+  EVENT_BMS_FRAME_PARSED = 0,       // source = BMS node, bmsFrame.frameType = BMSFrameType_t
+  EVENT_MODULE_STATE_CHANGED,       // source = TRIO HP module, moduleState.*
+  EVENT_LIMITS_CHANGED,             // limits.* (effective fleet DCCL/DDCL)
+  EVENT_REGISTER_WRITTEN,           // registers.* (Modbus write, any window)
+  EVENT_TYPE_COUNT
+} EventType_t;
+
+// === EVENT ===
+typedef struct {
+  uint8_t type;                     // EventType_t
+  uint8_t source;                   // Node/module ID, 0 if not applicable
+  unsigned long timestamp;          // millis() at publish
+  union {
+    struct {
+      uint8_t frameType;
+    } bmsFrame;
+    struct {
+      uint8_t oldState;             // TrioModuleState_t
+      uint8_t newState;
+    } moduleState;
+    struct {
+      float dccl;                   // Effective discharge limit [A]
+      float ddcl;                   // Effective charge limit [A]
+    } limits;
+    struct {
+      uint16_t address;             // First register
+      uint16_t count;
+      uint16_t value;               // Value of the first register
+    } registers;
+  } data;
+} Event_t;
+
+// === SUBSCRIBER STATISTICS ===
+typedef struct {
+  char name[EVENT_SUBSCRIBER_NAME_LENGTH];
+  uint32_t typeMask;
+  unsigned long enqueued;           // Written by the producer
+  unsigned long dropped;            // Producer found the ring full
+  unsigned long consumed;           // Written by the consumer
+  uint8_t depth;                    // Events waiting
+  uint8_t peakDepth;
+} EventSubscriberStats_t;
+
+typedef struct {
+  unsigned long published[EVENT_TYPE_COUNT];
+  unsigned long foreignPublishes;   // Refused: not the producer task
+  uint8_t subscribers;
+} EventBusStats_t;
+
+// === BUS FUNCTIONS ===
+void initEventBus();                                            // Producer = calling task
+int8_t subscribeEvents(const char* name, uint32_t typeMask);   // During setup; same name = same handle
+
+// Producer side (main loop task), never blocks
+void publishEvent(Event_t* event);
+void publishBMSFrameEvent(uint8_t nodeId, uint8_t frameType);
+void publishModuleStateEvent(uint8_t moduleId, uint8_t oldState, uint8_t newState);
+void publishLimitsEvent(float dccl, float ddcl);
+void publishRegisterWriteEvent(uint16_t address, uint16_t count, uint16_t value);
+
+// Consumer side (subscriber's own task)
+bool pollEvent(int8_t subscriber, Event_t* event);
+unsigned long getEventDrops(int8_t subscriber);
+
+// === STATISTICS ===
+bool getEventSubscriberStats(int8_t subscriber, EventSubscriberStats_t* out);
+const EventBusStats_t* getEventBusStats();
+const char* getEventTypeName(uint8_t type);
+void printEventBusStatus();
+
+#endif // EVENT_BUS_H
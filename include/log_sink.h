@@ -0,0 +1,171 @@
+// =====================================================================
+// === log_sink.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Asynchronous Log Sink
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Lock-free ring, drain task, per-module levels, per-site rate limit
+//
+// 🎯 DEPENDENCIES:
+//    Internal: none
+//    External: Arduino.h, FreeRTOS (drain task), WiFiUdp.h (syslog)
+//
+// 📝 DESCRIPTION:
+//    Operational messages go through LOG_E/LOG_W/LOG_I/LOG_D instead of
+//    Serial.printf:
+//
+//        LOG_W(LOG_MODULE_TRIO_LIMITS, "E-STOP ACTIVE (GPIO%d)", pin);
+//
+//    A message below the module's runtime level costs one byte compare.
+//    Otherwise the call site's token bucket is charged, the text is
+//    formatted straight into a slot of a lock-free multi-producer ring and
+//    the caller returns; it never waits for Serial. A low-priority task
+//    drains the ring to Serial and, when a target is set, to UDP syslog.
+//
+//    Each call site has its own token bucket (LOG_SITE_RATE_PER_S, burst
+//    LOG_SITE_BURST). Messages over the budget are counted, not formatted;
+//    the next message that passes from that site carries "(+N suppressed)".
+//    A full ring drops the message and counts it per module.
+//
+// 🔧 CONFIGURATION:
+//    - Ring: 64 slots x 120 characters
+//    - Rate limit: 2 messages/s per call site, burst 5
+//    - Drain task: priority 1, core 0, every 20ms
+//    - Syslog: off by default, RFC 3164 over UDP, facility local0
+//
+// ⚠️  KNOWN ISSUES:
+//    - Longer messages are truncated to the slot size
+//    - Messages logged before initLogSink() go straight to Serial
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Filtered message: one compare, no call
+//    - Logged message: token bucket, CAS on the ring head, vsnprintf into the slot
+//    - Memory: ~8KB ring + 3KB drain task stack
+//
+// =====================================================================
+
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+#include <Arduino.h>
+
+// === SINK CONFIGURATION ===
+#define LOG_RING_SLOTS                64     // Power of two
+#define LOG_MESSAGE_LENGTH            120
+#define LOG_SITE_RATE_PER_S           2      // Tokens refilled per second per call site
+#define LOG_SITE_BURST                5
+#define LOG_DRAIN_TASK_STACK_SIZE     3072
+#define LOG_DRAIN_TASK_PRIORITY       1
+#define LOG_DRAIN_TASK_CORE           0
+#define LOG_DRAIN_INTERVAL_MS         20
+#define LOG_SYSLOG_DEFAULT_PORT       514
+
+// === LEVELS ===
+typedef enum {
+  LOG_LEVEL_NONE = 0,
+  LOG_LEVEL_ERROR,
+  LOG_LEVEL_WARN,
+  LOG_LEVEL_INFO,
+  LOG_LEVEL_DEBUG
+} LogLevel_t;
+
+// === MODULES ===
+typedef enum {
+  LOG_MODULE_SYSTEM = 0,
+  LOG_MODULE_CAN,
+  LOG_MODULE_BMS,
+  LOG_MODULE_MODBUS,
+  LOG_MODULE_WIFI,
+  LOG_MODULE_WEB,
+  LOG_MODULE_TRIO_MANAGER,
+  LOG_MODULE_TRIO_MONITOR,
+  LOG_MODULE_TRIO_CONTROL,
+  LOG_MODULE_TRIO_LIMITS,
+  LOG_MODULE_COUNT
+} LogModule_t;
+
+// === CALL SITE STATE ===
+// One per LOG_* statement (function-local static)
+typedef struct {
+  uint16_t milliTokens;             // 1000 = one message
+  unsigned long lastRefill;         // millis()
+  unsigned long suppressed;         // Since the last message that passed
+} LogSite_t;
+
+#define LOG_SITE_INIT { LOG_SITE_BURST * 1000, 0, 0 }
+
+// === STATISTICS ===
+typedef struct {
+  unsigned long logged;             // Written to the ring
+  unsigned long suppressed;         // Rate limited
+  unsigned long dropped;            // Ring full
+} LogModuleStats_t;
+
+typedef struct {
+  unsigned long drained;
+  unsigned long syslogSent;
+  unsigned long syslogErrors;
+  uint16_t peakDepth;               // Slots in use
+} LogSinkStats_t;
+
+// Runtime levels, read inline by the LOG_* macros
+extern volatile uint8_t logModuleLevels[LOG_MODULE_COUNT];
+
+// === LOGGING MACROS ===
+#define LOG_AT(module, level, fmt, ...) \
+  do { \
+    if ((uint8_t)(level) <= logModuleLevels[(module)]) { \
+      static LogSite_t logSite_ = LOG_SITE_INIT; \
+      logWrite((module), (level), &logSite_, fmt, ##__VA_ARGS__); \
+    } \
+  } while (0)
+
+#define LOG_E(module, fmt, ...) LOG_AT(module, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOG_W(module, fmt, ...) LOG_AT(module, LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_I(module, fmt, ...) LOG_AT(module, LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_D(module, fmt, ...) LOG_AT(module, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+// === SINK FUNCTIONS ===
+bool initLogSink();                                   // Starts the drain task
+void logWrite(uint8_t module, uint8_t level, LogSite_t* site, const char* format, ...)
+  __attribute__((format(printf, 4, 5)));
+uint16_t drainLogSink(uint16_t maxMessages);          // Drain task body; callable for a final flush
+
+// === LEVEL CONTROL ===
+void setLogLevel(uint8_t module, uint8_t level);
+uint8_t getLogLevel(uint8_t module);
+void setAllLogLevels(uint8_t level);
+const char* getLogModuleName(uint8_t module);
+const char* getLogLevelName(uint8_t level);
+int findLogModule(const char* name);                  // -1 if unknown
+int findLogLevel(const char* name);                   // -1 if unknown
+
+// === SYSLOG ===
+bool setLogSyslogTarget(const char* host, uint16_t port);   // host nullptr/"" = off
+const char* getLogSyslogHost();
+uint16_t getLogSyslogPort();
+
+// === STATISTICS ===
+const LogModuleStats_t* getLogModuleStats(uint8_t module);
+const LogSinkStats_t* getLogSinkStats();
+uint16_t getLogRingDepth();
+void printLogSinkStatus();
+
+#endif // LOG_SINK_H
@@ -0,0 +1,130 @@
+// =====================================================================
+// === mem_pool.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Static Memory Pools, Render Arenas and Heap Metrics
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Fixed-block pools, text arenas, heap fragmentation tracking
+//
+// 🎯 DEPENDENCIES:
+//    Internal: none
+//    External: Arduino.h, esp_heap_caps.h (heap statistics)
+//
+// 📝 DESCRIPTION:
+//    Services that need a buffer per request take it from a fixed-block
+//    pool whose storage is a static array (MEM_POOL_DEFINE), so steady
+//    operation never touches the heap. A block can back a text arena:
+//    a bump buffer that responses are rendered into with arenaAppend/
+//    arenaAppendf and that is released as a whole when the response has
+//    been sent.
+//
+//    Heap metrics sample the 8-bit capable heap every 10s: free bytes,
+//    largest free block, fragmentation (1 - largest/free) and the number
+//    of allocated blocks. After a warm-up period the allocated block count
+//    is taken as a baseline; any growth past it is counted as a
+//    steady-state allocation, the figure that should stay at zero.
+//
+// 🔧 CONFIGURATION:
+//    - Pools: up to 8 registered, up to 32 blocks each
+//    - Heap sampling: 10s, steady-state baseline after 60s
+//
+// ⚠️  KNOWN ISSUES:
+//    - A pool is not locked: all alloc/free calls for one pool must come
+//      from the same task (Modbus pool: main loop, web pool: async web task)
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Alloc/free: one bit scan on a 32-bit mask, O(1)
+//    - Heap sample: one heap_caps_get_info() walk every 10s
+//
+// =====================================================================
+
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+#include <Arduino.h>
+
+// === POOL CONFIGURATION ===
+#define MEM_POOL_MAX_POOLS            8
+#define MEM_POOL_MAX_BLOCKS           32     // Free mask is 32 bits
+#define HEAP_METRICS_INTERVAL_MS      10000
+#define HEAP_STEADY_STATE_AFTER_MS    60000  // Boot-time allocations settle before the baseline
+
+// === FIXED-BLOCK POOL ===
+typedef struct {
+  const char* name;
+  uint8_t* storage;                 // blockSize * blockCount bytes
+  uint16_t blockSize;
+  uint8_t blockCount;
+  uint32_t freeMask;                // Bit set = block free
+  uint8_t inUse;
+  uint8_t peakInUse;
+  unsigned long allocations;
+  unsigned long failures;           // Pool exhausted
+} MemPool_t;
+
+// Storage and descriptor with static lifetime; memPoolInit() before first use
+#define MEM_POOL_DEFINE(var, poolName, size, count)                                  \
+  static uint8_t var##Storage[(size) * (count)] __attribute__((aligned(4)));         \
+  static MemPool_t var = { poolName, var##Storage, (size), (count), 0, 0, 0, 0, 0 }
+
+// === TEXT ARENA ===
+typedef struct {
+  char* buffer;
+  size_t capacity;
+  size_t used;                      // Excluding the terminating NUL
+  bool overflow;                    // An append did not fit (output truncated)
+} MemArena_t;
+
+// === HEAP METRICS ===
+typedef struct {
+  uint32_t freeBytes;
+  uint32_t minFreeBytes;            // Low-water mark since boot
+  uint32_t largestFreeBlock;
+  uint32_t minLargestFreeBlock;
+  float fragmentation;              // 100 * (1 - largest / free) [%]
+  float peakFragmentation;
+  uint32_t allocatedBlocks;
+  uint32_t baselineBlocks;          // Allocated blocks when steady state began
+  bool steadyState;
+  unsigned long steadyStateAllocations;  // Growth in allocated blocks past the baseline
+  unsigned long samples;
+} HeapMetrics_t;
+
+// === POOL FUNCTIONS ===
+void memPoolInit(MemPool_t* pool);  // Resets the pool, registers it for statistics
+void* memPoolAlloc(MemPool_t* pool);
+void memPoolFree(MemPool_t* pool, void* block);
+
+// === ARENA FUNCTIONS ===
+void arenaInit(MemArena_t* arena, void* buffer, size_t capacity);
+void arenaReset(MemArena_t* arena);
+bool arenaAppend(MemArena_t* arena, const char* text);
+bool arenaAppendf(MemArena_t* arena, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+// === HEAP METRICS ===
+void updateHeapMetrics();           // Main loop, samples every HEAP_METRICS_INTERVAL_MS
+const HeapMetrics_t* getHeapMetrics();
+
+// === STATISTICS ===
+uint8_t getMemPoolCount();
+const MemPool_t* getMemPool(uint8_t index);
+void printMemPoolStatus();
+
+#endif // MEM_POOL_H
@@ -0,0 +1,134 @@
+// =====================================================================
+// === modbus_cov.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Modbus Change-of-Value Subscriptions
+//    Version: v1.0.1
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.1 - 18.10.2026 - SELECT kept per Modbus TCP connection instead of one for all clients
+//    v1.0.0 - 18.10.2026 - Range subscriptions with deadband, "changed since N" window
+//
+// 🎯 DEPENDENCIES:
+//    Internal: bms_data.h (holding registers), config.h
+//    External: Arduino.h
+//
+// 📝 DESCRIPTION:
+//    Instead of polling all 3200 holding registers, a client subscribes to
+//    address ranges and reads back which registers changed. A subscription
+//    is a range (up to one BMS block) plus a deadband in raw register units.
+//    Every scan compares the range against the last reported values; a
+//    register that moved further than the deadband gets the subscription's
+//    next sequence number.
+//
+//    Client cycle over the window (one subscription selected at a time;
+//    every connection has its own selection, 0 when it connects):
+//      1. write SINCE = last SEQUENCE it has seen (0 after subscribing)
+//      2. read +5..+22: SEQUENCE, changed count, first changed, flags and
+//         the change bitmap (bit i = register START + i changed since SINCE)
+//      3. read only the changed ranges from the holding registers
+//    A subscription that is not accessed for the lease time is released.
+//
+// 🔧 CONFIGURATION:
+//    - Subscriptions: 8, up to 200 registers each
+//    - Scan: every 100ms from the main loop
+//    - Lease: 120s without window access
+//    - Modbus window: 5400-5422 (see MODBUS_COV_REG_* below)
+//
+// ⚠️  KNOWN ISSUES:
+//    - Subscriptions are shared by all clients; clients have to agree on
+//      which slot each one uses (only the selection is per connection)
+//    - Only the BMS holding registers (0-3199) can be subscribed
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Scan: one compare per subscribed register every 100ms
+//    - Memory: ~6.5KB (8 x 200 x (reference + sequence))
+//
+// =====================================================================
+
+#ifndef MODBUS_COV_H
+#define MODBUS_COV_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// === SUBSCRIPTION CONFIGURATION ===
+#define MODBUS_COV_MAX_SUBSCRIPTIONS  8
+#define MODBUS_COV_MAX_RANGE          200    // One BMS block
+#define MODBUS_COV_SCAN_MS            100
+#define MODBUS_COV_LEASE_MS           120000
+#define MODBUS_COV_HISTORY            0x4000 // Sequences a SINCE value may lag before a resync
+
+// === MODBUS WINDOW (directly after the BMS SDO window) ===
+#define MODBUS_COV_START_REGISTER     5400
+#define MODBUS_COV_REG_SELECT         0   // RW: subscription slot 0..7 (per connection)
+#define MODBUS_COV_REG_START          1   // RW: first subscribed holding register
+#define MODBUS_COV_REG_COUNT          2   // RW: registers in the range, 0 = release
+#define MODBUS_COV_REG_DEADBAND       3   // RW: raw units, 0 = any change
+#define MODBUS_COV_REG_SINCE          4   // RW: last sequence the client has seen
+#define MODBUS_COV_REG_SEQUENCE       5   // R: current sequence of the subscription
+#define MODBUS_COV_REG_CHANGED        6   // R: registers changed since SINCE
+#define MODBUS_COV_REG_FIRST_CHANGED  7   // R: offset of the first changed register, 0xFFFF = none
+#define MODBUS_COV_REG_FLAGS          8   // R: MODBUS_COV_FLAG_*
+#define MODBUS_COV_REG_RESERVED       9
+#define MODBUS_COV_REG_BITMAP         10  // R: change bitmap, 16 registers per bitmap register
+#define MODBUS_COV_MODBUS_REGISTERS   (MODBUS_COV_REG_BITMAP + (MODBUS_COV_MAX_RANGE + 15) / 16)
+
+#define MODBUS_COV_FLAG_ACTIVE        0x0001
+#define MODBUS_COV_FLAG_RESYNC        0x0002  // SINCE too old or unknown: everything reported changed
+
+// === SUBSCRIPTION STATUS ===
+typedef struct {
+  bool active;
+  uint16_t start;
+  uint16_t count;
+  uint16_t deadband;
+  uint16_t sequence;
+  uint16_t since;
+  unsigned long lastAccess;         // millis() of the last window access
+  unsigned long changes;            // Register changes past the deadband
+  unsigned long reads;              // Bitmap reads
+} ModbusCOVSubscription_t;
+
+typedef struct {
+  unsigned long scans;
+  unsigned long changes;
+  unsigned long expired;            // Released by the lease
+  unsigned long lastScanUs;
+  unsigned long maxScanUs;
+} ModbusCOVStats_t;
+
+// === SUBSCRIPTION FUNCTIONS ===
+void initModbusCOV();
+void processModbusCOV();            // Main loop, scans every MODBUS_COV_SCAN_MS
+bool subscribeModbusCOV(uint8_t slot, uint16_t start, uint16_t count, uint16_t deadband);
+void releaseModbusCOV(uint8_t slot);
+
+// === STATISTICS ===
+bool getModbusCOVSubscription(uint8_t slot, ModbusCOVSubscription_t* out);
+const ModbusCOVStats_t* getModbusCOVStats();
+void printModbusCOVStatus();
+
+// === MODBUS WINDOW ===
+bool isModbusCOVRegisterRange(uint16_t startAddress, uint16_t count);
+// client = transport slot of the requesting connection (0..MODBUS_TCP_MAX_CLIENTS-1)
+void setModbusCOVClientSession(uint8_t client, uint32_t session);   // New session: selection back to 0
+bool readModbusCOVRegister(uint8_t client, uint16_t address, uint16_t* value);
+bool writeModbusCOVRegister(uint8_t client, uint16_t address, uint16_t value);
+
+#endif // MODBUS_COV_H
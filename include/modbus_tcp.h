@@ -10,12 +10,14 @@
 //
 // 📋 MODULE INFO:
 //    Module: Modbus TCP Server Implementation
-//    Version: v4.0.2
+//    Version: v4.0.4
 //    Created: 13.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.0.4 - 18.10.2026 - Register table lock for writers racing the lwIP-thread FC03 copy
+//    v4.0.3 - 18.10.2026 - Handlers answer on a transport connection (lwIP raw API), FC03 fast-path builder
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v4.0.1 - 13.08.2025 - Fixed state definition conflicts and missing functions
 //    v4.0.0 - 13.08.2025 - Initial Modbus TCP server implementation
@@ -62,6 +64,7 @@
 #include <WiFiClient.h>
 #include "config.h"        // Zawiera ModbusState_t - NIE DUPLIKUJEMY!
 #include "bms_data.h"
+#include "modbus_transport.h"
 
 // === MODBUS TCP PROTOCOL CONSTANTS ===
 
@@ -160,14 +163,17 @@ bool restartModbusTCP();
 
 // Processing functions
 void processModbusTCP();
-void handleModbusRequest(WiFiClient& client);
-void sendModbusResponse(WiFiClient& client, uint8_t* response, int length);
+void sendModbusResponse(ModbusConnection_t* conn, uint8_t* response, int length);
+
+// FC03 of the holding register table, answered in the lwIP thread: response
+// length, 0 if the request needs the main loop (writes, windows, errors)
+int buildModbusReadResponse(const uint8_t* request, int requestLength, uint8_t* response);
 
 // Request handler functions
-void handleReadHoldingRegisters(WiFiClient& client, uint8_t* request, int requestLength);
-void handleWriteSingleRegister(WiFiClient& client, uint8_t* request, int requestLength);
-void handleWriteMultipleRegisters(WiFiClient& client, uint8_t* request, int requestLength);
-void sendErrorResponse(WiFiClient& client, uint8_t functionCode, uint8_t exceptionCode, uint16_t transactionId);
+void handleReadHoldingRegisters(ModbusConnection_t* conn, uint8_t* request, int requestLength);
+void handleWriteSingleRegister(ModbusConnection_t* conn, uint8_t* request, int requestLength);
+void handleWriteMultipleRegisters(ModbusConnection_t* conn, uint8_t* request, int requestLength);
+void sendErrorResponse(ModbusConnection_t* conn, uint8_t functionCode, uint8_t exceptionCode, uint16_t transactionId);
 
 // State and health functions
 bool isModbusServerActive();
@@ -179,6 +185,13 @@ bool readHoldingRegisters(uint16_t startAddress, uint16_t count, uint16_t* value
 bool writeSingleRegister(uint16_t address, uint16_t value);
 bool writeMultipleRegisters(uint16_t startAddress, uint16_t count, uint16_t* values);
 
+// Register table lock: FC03 blocks are copied in the lwIP thread, possibly on
+// the other core. Writers of more than one register store under it, so a read
+// sees a block either before or after an update (single registers need no lock)
+void lockModbusRegisters();
+void unlockModbusRegisters();
+void storeModbusRegisters(uint16_t startAddress, const uint16_t* values, uint16_t count);  // No range check
+
 // Utility functions
 uint16_t calculateModbusCRC(uint8_t* data, int length);
 bool validateModbusFrame(uint8_t* frame, int length);
@@ -195,6 +208,7 @@ float modbusRegisters32ToFloat(uint16_t highReg, uint16_t lowReg);
 void updateModbusRegisters(uint8_t nodeId);
 void updateAllModbusRegisters();
 void mapBMSDataToModbus(uint8_t nodeId, const BMSData& bmsData);
+void mapBMSQualityToModbus(int batteryIndex, const BMSData& bmsData);  // Base+140-169
 
 // TRIO HP data mapping functions
 void updateTrioHPModbusRegisters();
@@ -0,0 +1,122 @@
+// =====================================================================
+// === modbus_transport.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Modbus TCP Transport (lwIP raw API)
+//    Version: v1.0.1
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.1 - 18.10.2026 - Fast-path request/byte counters, connection slot and session accessors
+//    v1.0.0 - 18.10.2026 - Listener on the lwIP raw API, MBAP reassembly from pbufs, reads served in the receive callback
+//
+// 🎯 DEPENDENCIES:
+//    Internal: modbus_tcp.h (read fast path), statistics.h (request latency)
+//    External: Arduino.h, lwIP raw TCP API (tcpip thread via tcpip_api_call)
+//
+// 📝 DESCRIPTION:
+//    Replaces WiFiServer/WiFiClient for port 502. Connections live on the
+//    lwIP raw API with Nagle disabled; everything below runs in the lwIP
+//    (tcpip) thread, the main loop reaches it through tcpip_api_call().
+//
+//    Receive: the callback walks the pbuf chain and cuts it into ADUs by the
+//    MBAP length field. An ADU that lies in one pbuf is parsed in place;
+//    only ADUs split across segments are copied into the connection's
+//    reassembly buffer. Consumed bytes are freed from the chain and opened
+//    in the receive window right away.
+//
+//    Service: plain FC03 reads of the holding register table are answered
+//    from the callback (buildModbusReadResponse). The response is built in
+//    the connection's TX buffer and written without copy as one segment,
+//    then pushed with tcp_output(). Everything else (writes, the parameter,
+//    SDO and COV windows, errors) is handed to the main loop, which owns the
+//    event bus and those modules; the connection stops consuming until the
+//    main loop has answered, so requests are answered in order.
+//
+//    Backpressure: an ADU is only taken when the send buffer has room for
+//    the largest response; otherwise the pbufs stay held and the window
+//    closes until the client reads its responses.
+//
+//    LATENCY_MODBUS_REQUEST is recorded here (lwIP thread only): from the
+//    first byte of the ADU in the receive callback to the response queued.
+//
+// 🔧 CONFIGURATION:
+//    - Port: MODBUS_TCP_PORT, up to MODBUS_TCP_MAX_CLIENTS connections
+//    - Idle connections closed after MODBUS_TCP_TIMEOUT_MS
+//
+// ⚠️  KNOWN ISSUES:
+//    - Fast-path reads run in the lwIP thread, possibly on the other core:
+//      the copy is taken under the register table lock (modbus_tcp.h), so
+//      only writers that store blocks under it are seen whole
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: host test test_modbus_transport (fake lwIP)
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - FC03: no main loop hop, no copy in, one register pass, no copy out
+//    - Memory: 2 x MODBUS_MAX_FRAME_SIZE per connection (RX reassembly, TX)
+//
+// =====================================================================
+
+#ifndef MODBUS_TRANSPORT_H
+#define MODBUS_TRANSPORT_H
+
+#include <Arduino.h>
+
+#define MODBUS_TRANSPORT_POLL_INTERVAL  4      // lwIP poll ticks (500ms each) between idle checks
+#define MODBUS_TRANSPORT_BACKLOG        2
+
+typedef struct ModbusConnection ModbusConnection_t;   // Opaque connection slot
+
+typedef struct {
+  uint8_t activeConnections;
+  unsigned long accepted;
+  unsigned long rejected;           // No free slot
+  unsigned long closed;             // By the client, an error or the idle timeout
+  unsigned long idleClosed;
+  unsigned long fastRequests;       // Answered in the receive callback
+  unsigned long fastResponses;      // Of those, written to the send buffer
+  unsigned long fastBytesReceived;
+  unsigned long fastBytesSent;
+  unsigned long lastFastRequestMs;  // millis() of the last one
+  unsigned long queuedRequests;     // Handed to the main loop
+  unsigned long reassembled;        // ADUs split across pbufs (copied)
+  unsigned long framingErrors;      // Bad MBAP length: connection aborted
+  unsigned long copiedResponses;    // TX buffer still in flight, written with copy
+  unsigned long txErrors;
+  unsigned long stalls;             // ADU left held for lack of send buffer
+  unsigned long bytesReceived;
+  unsigned long bytesSent;
+} ModbusTransportStats_t;
+
+// === LISTENER ===
+bool startModbusTransport(uint16_t port);
+void stopModbusTransport();         // Aborts open connections
+
+// === MAIN LOOP SIDE ===
+// ADU waiting for the main loop on connection slot `slot`, nullptr if none.
+// Answer with sendModbusTransport() (any number of times, usually once),
+// then completeModbusTransport() to let the connection continue.
+ModbusConnection_t* getModbusTransportRequest(uint8_t slot, uint8_t** request, int* length);
+bool sendModbusTransport(ModbusConnection_t* conn, const uint8_t* response, int length);
+void completeModbusTransport(ModbusConnection_t* conn);
+uint8_t getModbusTransportSlot(const ModbusConnection_t* conn);
+uint32_t getModbusTransportSession(const ModbusConnection_t* conn);   // New value per accepted connection
+
+// === STATISTICS ===
+const ModbusTransportStats_t* getModbusTransportStats();
+uint32_t getModbusTransportRemoteIP(uint8_t slot);   // 0 = slot free
+void printModbusTransportStatus();
+
+#endif // MODBUS_TRANSPORT_H
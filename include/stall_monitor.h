@@ -0,0 +1,174 @@
+// =====================================================================
+// === stall_monitor.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Loop Stall Watchdog and Profiling Zones
+//    Version: v1.3.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Zone timing, stall records with backtrace, ranked sources
+//    v1.1.0 - 18.10.2026 - Per-zone service gap (worst time between two entries)
+//    v1.2.0 - 18.10.2026 - Backtrace sampled by the watchdog while the stall is in progress
+//    v1.3.0 - 18.10.2026 - Watchdog task samples without suspending the loop
+//
+// 🎯 DEPENDENCIES:
+//    Internal: none
+//    External: Arduino.h, FreeRTOS task snapshot, esp_debug_helpers.h (backtrace)
+//
+// 📝 DESCRIPTION:
+//    Code that may block (CAN processing, WiFi, Modbus, EEPROM commits,
+//    heartbeat/diagnostic printing) runs inside a profiling zone:
+//
+//        { PROFILE_ZONE(PROFILE_ZONE_EEPROM); EEPROM.commit(); }
+//
+//    Zones nest; leaving a zone that took longer than the stall threshold
+//    records a stall: the zone, the enclosing zone, its duration and a
+//    backtrace of the blocking call. The watchdog takes that backtrace from
+//    the main task's saved stack while the zone is still stalled and the
+//    task is blocked; a stall that ends before the next tick, or where the
+//    loop was busy computing, gets the backtrace at the zone's exit.
+//    Stalls are aggregated per (zone, calling site) into a table ranked by
+//    total stalled time, so the worst sources are fixed first. A loop()
+//    pass over the threshold that no zone accounts for is recorded under
+//    PROFILE_ZONE_LOOP.
+//
+//    A low-priority watchdog task, ticking every 20ms on the other core,
+//    catches passes that have not finished yet (a hang, a long blocking
+//    connect) and reports the zone and the backtrace of the main loop while
+//    it is still stuck - or, if the loop is busy, the call site that
+//    entered the zone. It never suspends the loop task.
+//
+//    The gap between two entries of a zone is the service latency of that
+//    subsystem (how long Modbus or TRIO HP waited for its turn); the worst
+//    gap per zone shows whether one subsystem starves the others, e.g.
+//    during a replayed CAN burst after resetProfileZoneGaps().
+//
+// 🔧 CONFIGURATION:
+//    - Stall threshold: 50ms; watchdog report: 1s into a pass
+//    - Sources: 16 (zone, site) entries; recent stalls: 16
+//    - Backtrace: 8 frames
+//
+// ⚠️  KNOWN ISSUES:
+//    - Zones are for the main loop task only; other tasks are not tracked
+//    - Stalls shorter than threshold + one watchdog tick (70ms) may not be
+//      sampled: their backtrace is the zone's exit
+//    - A loop busy computing (not blocked) has no saved context: no stack
+//      sample, only the zone's entry site in the watchdog report
+//    - Backtrace PCs are raw addresses: resolve with addr2line against the
+//      firmware ELF
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Zone enter/leave: two micros() reads and a few stores
+//    - Backtrace only on a stall: one stack sample per stalled zone
+//    - Memory: ~1.5KB (sources + recent stalls)
+//
+// =====================================================================
+
+#ifndef STALL_MONITOR_H
+#define STALL_MONITOR_H
+
+#include <Arduino.h>
+
+// === MONITOR CONFIGURATION ===
+#define STALL_THRESHOLD_US            50000
+#define STALL_WATCHDOG_TICK_MS        20
+#define STALL_WATCHDOG_REPORT_MS      1000
+#define STALL_MAX_SOURCES             16
+#define STALL_RECENT_COUNT            16     // Power of two
+#define STALL_BACKTRACE_DEPTH         8
+#define STALL_ZONE_STACK_DEPTH        6
+#define STALL_WATCHDOG_TASK_STACK_SIZE 3072
+#define STALL_WATCHDOG_TASK_PRIORITY  1
+#define STALL_WATCHDOG_TASK_CORE      0      // The loop task runs on core 1
+
+// === PROFILING ZONES ===
+typedef enum {
+  PROFILE_ZONE_LOOP = 0,            // loop() outside any other zone
+  PROFILE_ZONE_CAN,                 // BMS protocol / CAN receive
+  PROFILE_ZONE_TRIO_HP,             // TRIO HP manager, monitor, controllers
+  PROFILE_ZONE_WIFI,                // WiFi manager, connect
+  PROFILE_ZONE_MODBUS,              // Modbus TCP server
+  PROFILE_ZONE_HEARTBEAT,           // Heartbeat report
+  PROFILE_ZONE_DIAGNOSTICS,         // Diagnostics report
+  PROFILE_ZONE_EEPROM,              // EEPROM.commit() / NVS writes
+  PROFILE_ZONE_LED,                 // Blocking LED blink fallback
+  PROFILE_ZONE_COUNT
+} ProfileZone_t;
+
+// === STALL RECORDS ===
+typedef struct {
+  uint8_t zone;                     // ProfileZone_t
+  uint8_t parentZone;
+  uint32_t site;                    // First backtrace PC outside the monitor
+  unsigned long count;
+  unsigned long totalUs;
+  unsigned long maxUs;
+  unsigned long lastAt;             // millis()
+  uint32_t backtrace[STALL_BACKTRACE_DEPTH];  // Of the longest stall
+  uint8_t depth;
+  bool sampled;                     // Backtrace taken while blocked (false: at the zone's exit)
+} StallSource_t;
+
+typedef struct {
+  uint8_t zone;
+  uint8_t parentZone;
+  bool live;                        // Reported by the watchdog while still stalled
+  unsigned long durationUs;
+  unsigned long at;                 // millis()
+  uint32_t site;                    // First PC of the stall's backtrace, 0 if none
+} StallEvent_t;
+
+typedef struct {
+  unsigned long loopPasses;
+  unsigned long stalls;
+  unsigned long liveStalls;         // Watchdog reports
+  unsigned long droppedSources;     // Source table full
+  unsigned long longestUs;
+  unsigned long zoneUs[PROFILE_ZONE_COUNT];      // Time spent per zone (exclusive of nested zones)
+  unsigned long zoneMaxUs[PROFILE_ZONE_COUNT];   // Longest single stay
+  unsigned long zoneMaxGapUs[PROFILE_ZONE_COUNT];  // Longest time between two entries
+  uint32_t liveBacktrace[STALL_BACKTRACE_DEPTH];   // Main task at the last watchdog report
+  uint8_t liveDepth;
+} StallStats_t;
+
+// === MONITOR FUNCTIONS ===
+bool initStallMonitor();
+void stallLoopBegin();              // Start of loop()
+void stallLoopEnd();                // End of loop()
+uint8_t enterProfileZone(uint8_t zone);   // Returns the enclosing zone
+void leaveProfileZone();
+
+// Scope guard: leaves the zone on every return path
+class ProfileZoneScope {
+public:
+  explicit ProfileZoneScope(uint8_t zone) { enterProfileZone(zone); }
+  ~ProfileZoneScope() { leaveProfileZone(); }
+};
+#define PROFILE_ZONE_CONCAT2(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT2(a, b)
+#define PROFILE_ZONE(zone) ProfileZoneScope PROFILE_ZONE_CONCAT(profileZone_, __LINE__)(zone)
+
+// === REPORTS ===
+uint8_t getStallSources(StallSource_t* out, uint8_t max);   // Ranked by total stalled time
+uint8_t getRecentStalls(StallEvent_t* out, uint8_t max);    // Newest first
+const StallStats_t* getStallStats();
+const char* getProfileZoneName(uint8_t zone);
+void resetProfileZoneGaps();        // Start a fresh worst-gap measurement
+void printStallReport();
+
+#endif // STALL_MONITOR_H
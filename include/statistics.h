@@ -10,17 +10,19 @@
 //
 // = MODULE INFO:
 //    Module: System Performance and Usage Statistics
-//    Version: v4.0.2
+//    Version: v4.1.1
 //    Created: 27.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // = VERSION HISTORY:
+//    v4.1.1 - 18.10.2026 - Percentiles of caller-held histogram deltas
+//    v4.1.0 - 18.10.2026 - Background soak sampler: heap, queues, latency percentiles, drift
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers and structure
 //    v4.0.0 - 27.08.2025 - Initial statistics module implementation
 //
 // < DEPENDENCIES:
-//    Internal: config, bms_data modules for data access
+//    Internal: config, mem_pool (heap metrics), event_bus, can_bus (queue depths)
 //    External: Arduino.h for core functionality
 //
 // = DESCRIPTION:
@@ -30,6 +32,14 @@
 //    Provides real-time statistics collection and historical data analysis
 //    for BMS communication, Modbus TCP operations, and system performance.
 //
+//    A low-priority task samples every 10s: heap free/low-water/largest
+//    block/fragmentation, the deepest event bus and CAN receive queue, and
+//    per-period latency percentiles from log2 histograms fed by the main
+//    loop, the Modbus server and the web server. The last 64 samples are
+//    kept; a least-squares slope over them flags drift (heap falling, or
+//    fragmentation or p99 latency rising) long before it becomes a field
+//    failure. Everything is exported on /metrics.
+//
 // =' CONFIGURATION:
 //    - Statistics Collection: Real-time data gathering
 //    - Error Rate Tracking: Per-BMS and system-wide error monitoring
@@ -48,7 +58,8 @@
 // = PERFORMANCE NOTES:
 //    - Statistics overhead: <1% CPU usage
 //    - Memory per statistic: ~4 bytes average
-//    - Collection interval: 1 second default
+//    - Collection interval: 10 seconds (sampler task, core 0)
+//    - Recording a latency: one clz and one increment
 //    - Report generation: <10ms for standard report
 //
 // =====================================================================
@@ -59,7 +70,69 @@
 #include <Arduino.h>
 #include "config.h"
 
-// Forward declarations and basic structure
-// (Full implementation to be developed as needed)
+// === SAMPLING CONFIGURATION ===
+#define STATS_SAMPLE_INTERVAL_MS          10000
+#define STATS_HISTORY_SAMPLES             64     // ~10 min of samples for drift fitting
+#define STATS_DRIFT_MIN_SAMPLES           30     // 5 min before drift is judged
+#define STATS_TASK_STACK_SIZE             4096
+#define STATS_TASK_PRIORITY               1
+#define STATS_TASK_CORE                   0      // Arduino loop runs on core 1
+
+// Drift limits (least-squares slope over the history window)
+#define STATS_HEAP_DRIFT_BYTES_PER_HOUR   4096.0f   // Free heap falling faster than this
+#define STATS_FRAG_DRIFT_PCT_PER_HOUR     5.0f      // Fragmentation rising faster than this
+#define STATS_LATENCY_DRIFT_PCT_PER_HOUR  50.0f     // p99 rising faster than this share of its mean
+
+// === LATENCY HISTOGRAMS ===
+// Bucket 0 = 0us, bucket i = [2^(i-1), 2^i) us; the last bucket is open-ended
+#define STATS_LATENCY_BUCKETS             24
+
+typedef enum {
+  LATENCY_MAIN_LOOP = 0,            // One loop() pass (processing, periodic checks, heartbeat)
+  LATENCY_MODBUS_REQUEST,           // Request received to response written
+  LATENCY_WEB_REQUEST,              // JSON/metrics render and hand-off
+  LATENCY_CHANNEL_COUNT
+} LatencyChannel_t;
+
+// === SAMPLE ===
+typedef struct {
+  unsigned long timestamp;          // millis()
+  uint32_t freeHeap;
+  uint32_t minFreeHeap;             // Low-water mark since boot
+  uint32_t largestFreeBlock;
+  float fragmentation;              // [%]
+  uint16_t eventQueueDepth;         // Deepest event bus subscriber ring
+  uint8_t canRingDepth;             // Deepest CAN receive ring
+  uint32_t statsStackFree;          // Sampler task stack high-water [bytes]
+  unsigned long latencyCount[LATENCY_CHANNEL_COUNT];  // Events in this sample period
+  float latencyP50[LATENCY_CHANNEL_COUNT];            // [us], this sample period
+  float latencyP99[LATENCY_CHANNEL_COUNT];
+} StatsSample_t;
+
+// === DRIFT ===
+typedef struct {
+  uint8_t samples;                  // History points used for the fit
+  float heapSlope;                  // Free heap [bytes/hour]
+  float fragmentationSlope;         // [%/hour]
+  float latencySlope[LATENCY_CHANNEL_COUNT];  // p99 [% of mean/hour]
+  bool heapDrift;
+  bool fragmentationDrift;
+  bool latencyDrift[LATENCY_CHANNEL_COUNT];
+  unsigned long driftAlerts;        // Raises since boot (any metric)
+} StatsDrift_t;
+
+// === STATISTICS FUNCTIONS ===
+bool initStatistics();              // Starts the sampler task
+void recordLatency(LatencyChannel_t channel, unsigned long us);  // One writer task per channel
+
+// === ACCESSORS (any task) ===
+bool getLatestStatsSample(StatsSample_t* out);
+void getStatsDrift(StatsDrift_t* out);
+void getLatencyHistogram(LatencyChannel_t channel, uint32_t* out);  // STATS_LATENCY_BUCKETS counts since boot
+float getLatencyBucketUpperUs(uint8_t bucket);
+float getLatencyPercentile(const uint32_t* counts, float fraction);  // STATS_LATENCY_BUCKETS counts, e.g. a delta
+const char* getLatencyChannelName(uint8_t channel);
+bool isStatsDriftActive();
+void printStatisticsStatus();
 
-#endif // STATISTICS_H
\ No newline at end of file
+#endif // STATISTICS_H
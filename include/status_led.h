@@ -0,0 +1,110 @@
+// =====================================================================
+// === status_led.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Status LED Pattern Engine
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Timer-driven blink sequences encoding system state
+//
+// 🎯 DEPENDENCIES:
+//    Internal: config.h (LED_PIN)
+//    External: Arduino.h, esp_timer (periodic tick)
+//
+// 📝 DESCRIPTION:
+//    The LED is driven by a 50ms esp_timer tick, never by the main loop.
+//    The main loop only describes the system state; it is encoded as one
+//    repeating sequence:
+//      - system error: continuous fast blink (100ms on/off), nothing else
+//      - AP mode: 1s on, then the normal sequence
+//      - packs: one short blink (150ms) per active BMS, or one 500ms
+//        blink when no BMS is communicating
+//      - TRIO HP: after a gap, long blinks (600ms): 1 = off, 2 = operational,
+//        3 = health below 50%; none when the manager is not running
+//      - 2s pause
+//    A new state takes effect at the end of the running sequence, so a
+//    sequence is never cut in the middle. blinkLED() requests play as a
+//    one-shot pattern that interrupts the sequence and then restarts it.
+//
+// 🔧 CONFIGURATION:
+//    - Tick: 50ms, step durations 1..255 ticks
+//    - Pattern: up to 64 on/off steps
+//
+// ⚠️  KNOWN ISSUES:
+//    - A one-shot requested while another is playing replaces it
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Main loop: pattern build (<10us) once per STATUS_LED_UPDATE_MS
+//    - Timer tick: a counter decrement, GPIO write on step change
+//
+// =====================================================================
+
+#ifndef STATUS_LED_H
+#define STATUS_LED_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// === ENGINE CONFIGURATION ===
+#define STATUS_LED_TICK_MS            50
+#define STATUS_LED_MAX_STEPS          64
+#define STATUS_LED_UPDATE_MS          1000   // Main loop state refresh
+
+// === TRIO HP CODE (number of long blinks) ===
+typedef enum {
+  STATUS_LED_TRIO_NONE = 0,         // Manager not running
+  STATUS_LED_TRIO_OFF,
+  STATUS_LED_TRIO_OPERATIONAL,
+  STATUS_LED_TRIO_FAULT
+} StatusLedTrio_t;
+
+// === SYSTEM STATE SHOWN ===
+typedef struct {
+  uint8_t packCount;                // Communicating BMS
+  bool systemError;
+  bool apMode;
+  uint8_t trio;                     // StatusLedTrio_t
+} StatusLedState_t;
+
+// === PATTERN ===
+// Steps alternate on/off starting with on, each lasting steps[i] ticks
+typedef struct {
+  uint8_t steps[STATUS_LED_MAX_STEPS];
+  uint8_t length;
+} StatusLedPattern_t;
+
+typedef struct {
+  unsigned long ticks;
+  unsigned long cycles;             // Completed status sequences
+  unsigned long patternChanges;     // New status sequences taken over
+  unsigned long oneShots;
+} StatusLedStats_t;
+
+// === ENGINE FUNCTIONS ===
+bool initStatusLED();                                        // Starts the tick timer
+bool isStatusLEDRunning();
+void setStatusLEDState(const StatusLedState_t* state);       // Applied at the end of the running sequence
+void playStatusLEDOnce(uint8_t count, uint16_t durationMs);  // count x (on, off) of durationMs
+void buildStatusLEDPattern(const StatusLedState_t* state, StatusLedPattern_t* pattern);
+
+// === STATISTICS ===
+const StatusLedStats_t* getStatusLEDStats();
+void printStatusLEDStatus();
+
+#endif // STATUS_LED_H
@@ -0,0 +1,156 @@
+// =====================================================================
+// === virtual_bms.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Virtual Aggregated BMS Emitter
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Fleet-level 190/290/510 frames on a configurable ID set and period
+//
+// 🎯 DEPENDENCIES:
+//    Internal: event_bus.h (frame events), bms_data.h, can_bus.h (TX),
+//              trio_hp_limits.h (fleet DCCL/DDCL)
+//    External: Arduino.h, Preferences.h
+//
+// 📝 DESCRIPTION:
+//    Upstream inverters that expect a single battery see the whole fleet
+//    as one virtual BMS. Three frames are synthesized in the layout of our
+//    own BMS frames, so the bridge's parsers (and the DBC in docs/) decode
+//    them unchanged:
+//
+//      190  mean pack voltage, summed current, summed energy, mean SOC,
+//           error flags ORed over the packs (master error when no pack
+//           is fresh)
+//      290  lowest cell voltage of the fleet with its string/block/cell,
+//           mean of the pack mean cell voltages
+//      510  fleet DCCL/DDCL as aggregated and derated by trio_hp_limits,
+//           inputs/outputs ORed; zero limits when the aggregate is invalid
+//
+//    Sums are kept per pack slot and updated incrementally from
+//    EVENT_BMS_FRAME_PARSED (old contribution out, new one in); building a
+//    frame does not walk the fleet. Packs without a frame for
+//    VBMS_PACK_TIMEOUT_MS are dropped by a sweep.
+//
+//    Frames are sent from the main loop against absolute deadlines
+//    (deadline += period, the three frames a third of a period apart), so
+//    lateness never accumulates into drift. Deadlines more than a period
+//    behind are skipped and counted, not sent in a burst. Lateness against
+//    the deadline is measured for every frame.
+//
+// 🔧 CONFIGURATION:
+//    - Disabled by default; settings persist in NVS ("vbms")
+//    - Default IDs 0x180/0x280/0x500 (node 0: below every BMS node range)
+//    - Period: 20-5000 ms (default 100 ms)
+//
+// ⚠️  KNOWN ISSUES:
+//    - Frame 190 current is unsigned (as parsed by bms_protocol): the sum
+//      saturates at 0 and 655.35 A
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Per frame event: O(1), plus a 16-slot rescan when the lowest cell rises
+//    - Per emitted frame: one encode, one canBusSendChannel()
+//    - Jitter bound: one main loop pass (idle wait is one tick)
+//
+// =====================================================================
+
+#ifndef VIRTUAL_BMS_H
+#define VIRTUAL_BMS_H
+
+#include <Arduino.h>
+
+// === EMITTER CONFIGURATION ===
+#define VBMS_NVS_NAMESPACE            "vbms"
+#define VBMS_DEFAULT_ID_190           0x180
+#define VBMS_DEFAULT_ID_290           0x280
+#define VBMS_DEFAULT_ID_510           0x500
+#define VBMS_DEFAULT_PERIOD_MS        100
+#define VBMS_MIN_PERIOD_MS            20
+#define VBMS_MAX_PERIOD_MS            5000
+#define VBMS_PACK_TIMEOUT_MS          5000
+#define VBMS_SWEEP_MS                 250
+#define VBMS_MAX_JITTER_US            5000   // Later than this counts as late
+
+typedef enum {
+  VBMS_FRAME_190 = 0,
+  VBMS_FRAME_290,
+  VBMS_FRAME_510,
+  VBMS_FRAME_COUNT
+} VirtualBMSFrame_t;
+
+typedef enum {
+  VBMS_JITTER_UNDER_250US = 0,
+  VBMS_JITTER_UNDER_1MS,
+  VBMS_JITTER_UNDER_5MS,
+  VBMS_JITTER_OVER_5MS,
+  VBMS_JITTER_BUCKETS
+} VirtualBMSJitterBucket_t;
+
+typedef struct {
+  bool enabled;
+  uint8_t channel;                  // CAN_CHANNEL_*
+  bool extended;
+  uint32_t ids[VBMS_FRAME_COUNT];
+  uint16_t periodMs;
+} VirtualBMSConfig_t;
+
+// === FLEET AGGREGATE (as last emitted) ===
+typedef struct {
+  uint8_t packs190;                 // Fresh packs in the 190 sums
+  uint8_t packs290;
+  float voltage;                    // Mean pack voltage [V]
+  float current;                    // Sum [A]
+  float energy;                     // Sum [kWh]
+  float soc;                        // Mean [%]
+  uint8_t errorFlags;               // Frame 190 byte 7
+  float cellMinVoltage;             // [V]
+  float cellMeanVoltage;            // [V]
+  uint8_t cellMinNode;
+  float dccl;                       // [A]
+  float ddcl;                       // [A]
+} VirtualBMSAggregate_t;
+
+typedef struct {
+  unsigned long sent[VBMS_FRAME_COUNT];
+  unsigned long txErrors;
+  unsigned long skipped;            // Deadlines missed by more than a period
+  unsigned long saturated;          // Values clamped to the frame field range
+  unsigned long rebuilds;           // Full rebuilds after missed events
+  unsigned long lateFrames;         // Lateness above VBMS_MAX_JITTER_US
+  uint32_t lastLatenessUs;
+  uint32_t maxLatenessUs;
+  float meanLatenessUs;
+  unsigned long jitterHistogram[VBMS_JITTER_BUCKETS];
+} VirtualBMSStats_t;
+
+// === EMITTER FUNCTIONS ===
+bool initVirtualBMS();              // Loads the NVS settings, subscribes to frame events
+void processVirtualBMS();           // Main loop: folds frame events, sends due frames
+bool setVirtualBMSConfig(const VirtualBMSConfig_t* config);   // Validates, persists, restarts the schedule
+const VirtualBMSConfig_t* getVirtualBMSConfig();
+
+// Frame payloads for the current aggregate (also used by /api/vbms)
+void buildVirtualBMSFrame(VirtualBMSFrame_t frame, uint8_t* data);
+
+// === STATISTICS ===
+const VirtualBMSAggregate_t* getVirtualBMSAggregate();
+const VirtualBMSStats_t* getVirtualBMSStats();
+void resetVirtualBMSStats();
+void printVirtualBMSStatus();
+
+#endif // VIRTUAL_BMS_H
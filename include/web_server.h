@@ -10,12 +10,24 @@
 //
 // 📋 MODULE INFO:
 //    Module: Web Configuration Server Interface
-//    Version: v4.0.2
+//    Version: v4.1.4
 //    Created: 17.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.1.4 - 18.10.2026 - Heap thresholds for starting the server at boot
+//    v4.1.3 - 18.10.2026 - Virtual BMS emitter API (aggregate, frames, jitter, settings)
+//    v4.1.2 - 18.10.2026 - DBC signal table API (messages, decoded values, BMS parser check)
+//    v4.1.1 - 18.10.2026 - CAN mapping rules API (list, reload, decode benchmark)
+//    v4.1.0 - 18.10.2026 - CAN dispatch budget / burst replay API
+//    v4.0.9 - 18.10.2026 - Log sink levels/syslog API
+//    v4.0.8 - 18.10.2026 - Loop stall report API
+//    v4.0.7 - 18.10.2026 - Prometheus /metrics endpoint
+//    v4.0.6 - 18.10.2026 - TRIO HP JSON rendered into a memory arena
+//    v4.0.5 - 18.10.2026 - Event bus API
+//    v4.0.4 - 18.10.2026 - CAN bus load API
+//    v4.0.3 - 18.10.2026 - BMS SDO on-demand read API
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v1.0.0 - 17.08.2025 - Initial web server implementation
 //
@@ -60,9 +72,12 @@
 #include <ESPAsyncWebServer.h>
 #include <AsyncTCP.h>
 #include "config.h"
+#include "mem_pool.h"
 
 // === WEB SERVER CONFIGURATION ===
 #define WEB_SERVER_PORT 80
+#define WEB_SERVER_MIN_FREE_HEAP 49152      // Boot start skipped below this free heap
+#define WEB_SERVER_MIN_LARGEST_BLOCK 16384  // ... or below this largest free block
 #define CONFIG_JSON_MAX_SIZE 2048
 
 // === SYSTEM STATUS BAR STRUCTURE ===
@@ -107,7 +122,7 @@ private:
   String generateTrioHPDashboardPage();
   String generateTrioHPConfigPage();
   String generateTrioHPEfficiencyPage();
-  String generateTrioHPDataJSON();
+  void renderTrioHPDataJSON(MemArena_t* arena);
   
   // System status bar
   String generateSystemStatusBar();
@@ -138,6 +153,36 @@ private:
   // System status API handler
   void handleSystemStatusAPI(AsyncWebServerRequest *request);
   
+  // BMS SDO on-demand read API handler
+  void handleBMSSdoAPI(AsyncWebServerRequest *request);
+  
+  // CAN bus load estimator API handler
+  void handleCANLoadAPI(AsyncWebServerRequest *request);
+  
+  // Event bus recent events / queue statistics API handler
+  void handleEventsAPI(AsyncWebServerRequest *request);
+  
+  // Soak metrics (Prometheus text format) handler
+  void handleMetrics(AsyncWebServerRequest *request);
+  
+  // Loop stall sources / recent stalls API handler
+  void handleStallsAPI(AsyncWebServerRequest *request);
+  
+  // Log sink levels / syslog target / counters API handler
+  void handleLogAPI(AsyncWebServerRequest *request);
+  
+  // CAN dispatch slices / backlog / burst replay API handler
+  void handleCANDispatchAPI(AsyncWebServerRequest *request);
+  
+  // CAN mapping rules / reload / benchmark API handler
+  void handleCANRulesAPI(AsyncWebServerRequest *request);
+  
+  // DBC signal table / decoded values / parser check API handler
+  void handleCANSignalsAPI(AsyncWebServerRequest *request);
+  
+  // Virtual aggregated BMS emitter API handler
+  void handleVirtualBMSAPI(AsyncWebServerRequest *request);
+  
   // Utility functions
   String getContentType(String filename);
   bool validateIPAddress(const String& ip);
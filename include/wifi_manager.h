@@ -10,12 +10,13 @@
 //
 // 📋 MODULE INFO:
 //    Module: WiFi Connection Management with AP Fallback
-//    Version: v4.0.2
+//    Version: v4.0.3
 //    Created: 13.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.0.3 - 18.10.2026 - Scan results and profiles in fixed arrays (no std::vector)
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v4.0.1 - 13.08.2025 - Fixed WiFi mode conflicts and callback functions
 //    v4.0.0 - 13.08.2025 - Initial WiFi management implementation
@@ -59,7 +60,6 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include <vector>
 #include "config.h"
 
 // === WIFI CONFIGURATION ===
@@ -68,6 +68,8 @@
 #define WIFI_MAX_CONNECT_ATTEMPTS   3
 #define WIFI_SCAN_TIMEOUT_MS        10000
 #define WIFI_AP_FALLBACK_DELAY_MS   5000
+#define WIFI_MAX_SCAN_RESULTS       16     // Strongest first as returned by the scan
+#define WIFI_MAX_PROFILES           4
 
 // === AP MODE CONFIGURATION ===
 #define AP_SSID_PREFIX     "ESP32S3-CAN-"
@@ -83,7 +85,7 @@ typedef void (*WiFiDisconnectedCallback)();
 
 // === NETWORK SCAN RESULT ===
 struct WiFiNetwork {
-  String ssid;
+  char ssid[33];
   int32_t rssi;
   wifi_auth_mode_t authMode;
   int32_t channel;
@@ -113,7 +115,8 @@ private:
   WiFiDisconnectedCallback disconnectedCallback;
   
   // Network scanning
-  std::vector<WiFiNetwork> scannedNetworks;
+  WiFiNetwork scannedNetworks[WIFI_MAX_SCAN_RESULTS];
+  uint8_t scannedNetworkCount;
   bool scanInProgress;
   
   // Statistics
@@ -194,7 +197,7 @@ public:
   bool startScan();
   bool isScanComplete() const;
   int getScanResults(WiFiNetwork* networks, int maxResults);
-  const std::vector<WiFiNetwork>& getScannedNetworks() const { return scannedNetworks; }
+  int getScannedNetworkCount() const { return scannedNetworkCount; }
   void clearScanResults();
   
   // === DIAGNOSTICS ===
@@ -301,8 +304,8 @@ inline int rssiToPercent(int rssi) {
 
 // Connection profiles
 struct WiFiProfile {
-  String ssid;
-  String password;
+  char ssid[33];
+  char password[65];
   bool hidden;
   int priority;
   bool autoConnect;
@@ -311,7 +314,8 @@ struct WiFiProfile {
 // Connection manager for multiple profiles
 class WiFiConnectionManager {
 private:
-  std::vector<WiFiProfile> profiles;
+  WiFiProfile profiles[WIFI_MAX_PROFILES];
+  uint8_t profileCount;
   int currentProfileIndex;
   
 public:
@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+
+# =====================================================================
+# === dbc_compile.py - ESP32S3 CAN to Modbus TCP Bridge ===
+# =====================================================================
+#
+# = PROJECT INFO:
+#    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+#    Project: ESP32S3 CAN to Modbus TCP Bridge
+#    Branch: main
+#    Created: 18.10.2026 (Warsaw Time)
+#
+# = MODULE INFO:
+#    Module: DBC to Signal Table Compiler (host tool)
+#    Version: v1.0.0
+#    Created: 18.10.2026 (Warsaw Time)
+#    Last Modified: 18.10.2026 (Warsaw Time)
+#    Author: ESP32 Development Team
+#
+# = DESCRIPTION:
+#    Compiles the messages and signals of a vendor DBC file into the
+#    binary signal table executed by can_signals.cpp. Bit positions are
+#    resolved here: every signal is stored as a right shift into the
+#    little endian (Intel) or big endian (Motorola) 64-bit frame word, so
+#    the firmware never interprets DBC bit numbering.
+#
+#    Table layout (little endian, 4-byte aligned):
+#      header   16 B  magic "SIGT", version, flags, message count,
+#                     signal count, string bytes, reserved
+#      message   8 B  id (bit 31 = extended), first signal, signal count, dlc
+#      signal   24 B  shift, length, flags, mux value, name offset,
+#                     reserved, scale, offset, min, max (float32)
+#      strings        NUL-terminated signal names
+#    Messages are sorted by id (binary search on the device); the
+#    multiplexor of a message is its first signal.
+#
+#    Supported: standard/extended IDs, Intel and Motorola byte order,
+#    signed values, simple multiplexing (M / mNN). Not supported:
+#    extended multiplexing (SG_MUL_VAL_), signals over 64 bits, float
+#    signals (SIG_VALTYPE_).
+#
+# = USAGE:
+#    python scripts/dbc_compile.py vendor.dbc -o data/signals.bin
+#    python scripts/dbc_compile.py docs/bms_frames.dbc --header include/bms_signal_table.h --name bmsSignalTable
+#    python scripts/dbc_compile.py vendor.dbc --list
+#
+#    data/signals.bin is uploaded with "pio run -t uploadfs" and loaded
+#    from /signals.bin at boot.
+#
+# =====================================================================
+
+import argparse
+import re
+import struct
+import sys
+
+TABLE_MAGIC = b"SIGT"
+TABLE_VERSION = 1
+
+FLAG_MOTOROLA = 0x01
+FLAG_SIGNED = 0x02
+FLAG_MULTIPLEXOR = 0x04
+FLAG_MULTIPLEXED = 0x08
+
+HEADER_FORMAT = "<4sBBHHHI"
+MESSAGE_FORMAT = "<IHBB"
+SIGNAL_FORMAT = "<BBBBHHffff"
+
+BO_PATTERN = re.compile(r"^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+)")
+SG_PATTERN = re.compile(
+    r"^SG_\s+(\w+)\s*(M|m\d+)?\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*"
+    r"\(\s*([^,]+?)\s*,\s*([^)]+?)\s*\)\s*\[\s*([^|\]]+?)\s*\|\s*([^\]]+?)\s*\]\s*\"([^\"]*)\"")
+
+
+class DbcError(Exception):
+    pass
+
+
+def parse_dbc(text):
+    messages = []
+    current = None
+    for number, raw in enumerate(text.splitlines(), 1):
+        line = raw.strip()
+        if line.startswith("BO_ "):
+            match = BO_PATTERN.match(line)
+            if not match:
+                raise DbcError("line %d: bad BO_ definition" % number)
+            raw_id = int(match.group(1))
+            extended = bool(raw_id & 0x80000000)
+            can_id = raw_id & 0x1FFFFFFF
+            if raw_id == 0xC0000000:       # VECTOR__INDEPENDENT_SIG_MSG
+                current = None
+                continue
+            if not extended and can_id > 0x7FF:
+                raise DbcError("line %d: standard id 0x%X exceeds 11 bits" % (number, can_id))
+            current = {"id": can_id, "extended": extended, "name": match.group(2),
+                       "dlc": int(match.group(3)), "signals": []}
+            messages.append(current)
+        elif line.startswith("SG_ "):
+            if current is None:
+                continue
+            match = SG_PATTERN.match(line)
+            if not match:
+                raise DbcError("line %d: bad SG_ definition" % number)
+            current["signals"].append(parse_signal(match, number))
+        elif line.startswith("SG_MUL_VAL_"):
+            raise DbcError("line %d: extended multiplexing is not supported" % number)
+        elif line.startswith("SIG_VALTYPE_"):
+            raise DbcError("line %d: float signals are not supported" % number)
+    return messages
+
+
+def parse_signal(match, number):
+    name, mux, start, length, order, sign = match.group(1, 2, 3, 4, 5, 6)
+    start = int(start)
+    length = int(length)
+    motorola = order == "0"
+    if length < 1 or length > 64:
+        raise DbcError("line %d: %s has length %d" % (number, name, length))
+
+    if motorola:
+        # DBC start bit is the MSB in sawtooth numbering; byte 0 is the top of the big endian word
+        msb = (7 - start // 8) * 8 + start % 8
+        shift = msb - (length - 1)
+    else:
+        shift = start
+    if shift < 0 or shift + length > 64:
+        raise DbcError("line %d: %s does not fit in 8 bytes" % (number, name))
+
+    flags = (FLAG_MOTOROLA if motorola else 0) | (FLAG_SIGNED if sign == "-" else 0)
+    mux_value = 0
+    if mux == "M":
+        flags |= FLAG_MULTIPLEXOR
+    elif mux:
+        flags |= FLAG_MULTIPLEXED
+        mux_value = int(mux[1:])
+        if mux_value > 255:
+            raise DbcError("line %d: %s mux value %d exceeds 255" % (number, name, mux_value))
+
+    return {"name": name, "shift": shift, "length": length, "flags": flags, "mux": mux_value,
+            "scale": float(match.group(7)), "offset": float(match.group(8)),
+            "min": float(match.group(9)), "max": float(match.group(10)), "unit": match.group(11)}
+
+
+def build_table(messages):
+    messages = sorted(messages, key=lambda m: m["id"] | (0x80000000 if m["extended"] else 0))
+    message_bytes = b""
+    signal_bytes = b""
+    strings = b""
+    first = 0
+
+    for message in messages:
+        signals = message["signals"]
+        multiplexors = [s for s in signals if s["flags"] & FLAG_MULTIPLEXOR]
+        if len(multiplexors) > 1:
+            raise DbcError("%s has more than one multiplexor" % message["name"])
+        if any(s["flags"] & FLAG_MULTIPLEXED for s in signals) and not multiplexors:
+            raise DbcError("%s has multiplexed signals without a multiplexor" % message["name"])
+        if len(signals) > 255:
+            raise DbcError("%s has more than 255 signals" % message["name"])
+        signals = multiplexors + [s for s in signals if not s["flags"] & FLAG_MULTIPLEXOR]
+
+        raw_id = message["id"] | (0x80000000 if message["extended"] else 0)
+        message_bytes += struct.pack(MESSAGE_FORMAT, raw_id, first, len(signals), message["dlc"])
+        for signal in signals:
+            if len(strings) > 0xFFFF:
+                raise DbcError("signal names exceed 64KB")
+            signal_bytes += struct.pack(SIGNAL_FORMAT, signal["shift"], signal["length"], signal["flags"],
+                                        signal["mux"], len(strings), 0, signal["scale"],
+                                        signal["offset"], signal["min"], signal["max"])
+            strings += signal["name"].encode("ascii") + b"\0"
+        first += len(signals)
+        if first > 0xFFFF:
+            raise DbcError("more than 65535 signals")
+
+    strings += b"\0" * (-len(strings) % 4)
+    header = struct.pack(HEADER_FORMAT, TABLE_MAGIC, TABLE_VERSION, 0, len(messages), first, len(strings), 0)
+    return header + message_bytes + signal_bytes + strings
+
+
+def write_header(path, name, table, source):
+    guard = re.sub(r"[^A-Z0-9]", "_", path.replace("\\", "/").split("/")[-1].upper())
+    lines = [
+        "// =====================================================================",
+        "// === %s - generated by scripts/dbc_compile.py from %s ===" % (path.replace("\\", "/").split("/")[-1], source),
+        "// === Do not edit: regenerate from the DBC ===",
+        "// =====================================================================",
+        "",
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        "#include <Arduino.h>",
+        "",
+        "static const uint8_t %s[%d] __attribute__((aligned(4))) = {" % (name, len(table)),
+    ]
+    for offset in range(0, len(table), 16):
+        chunk = table[offset:offset + 16]
+        lines.append("  " + ", ".join("0x%02X" % b for b in chunk) + ",")
+    lines += ["};", "", "#endif // %s" % guard, ""]
+    with open(path, "w", newline="\n") as handle:
+        handle.write("\n".join(lines))
+
+
+def list_messages(messages):
+    for message in sorted(messages, key=lambda m: m["id"]):
+        print("0x%X%s %s (dlc %d)" % (message["id"], "x" if message["extended"] else "",
+                                      message["name"], message["dlc"]))
+        for s in message["signals"]:
+            mux = "M" if s["flags"] & FLAG_MULTIPLEXOR else ("m%d" % s["mux"] if s["flags"] & FLAG_MULTIPLEXED else "")
+            print("    %-24s %-4s shift %2d len %2d %s %s x%g %+g [%g..%g] %s" % (
+                s["name"], mux, s["shift"], s["length"], "BE" if s["flags"] & FLAG_MOTOROLA else "LE",
+                "s" if s["flags"] & FLAG_SIGNED else "u", s["scale"], s["offset"], s["min"], s["max"], s["unit"]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile a DBC file into a binary CAN signal table")
+    parser.add_argument("dbc")
+    parser.add_argument("-o", "--output", help="binary table (e.g. data/signals.bin)")
+    parser.add_argument("--header", help="C header with the table as a byte array")
+    parser.add_argument("--name", default="signalTable", help="array name for --header")
+    parser.add_argument("--list", action="store_true", help="print the compiled layout")
+    args = parser.parse_args()
+
+    try:
+        with open(args.dbc, encoding="latin-1") as handle:
+            messages = parse_dbc(handle.read())
+        table = build_table(messages)
+    except (DbcError, ValueError) as error:
+        print("dbc_compile: %s" % error, file=sys.stderr)
+        return 1
+
+    if args.list:
+        list_messages(messages)
+    if args.output:
+        with open(args.output, "wb") as handle:
+            handle.write(table)
+    if args.header:
+        write_header(args.header, args.name, table, args.dbc.replace("\\", "/"))
+    print("%d messages, %d signals, %d bytes" % (len(messages), sum(len(m["signals"]) for m in messages), len(table)),
+          file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
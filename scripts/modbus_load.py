@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+
+# =====================================================================
+# === modbus_load.py - ESP32S3 CAN to Modbus TCP Bridge ===
+# =====================================================================
+#
+# = PROJECT INFO:
+#    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+#    Project: ESP32S3 CAN to Modbus TCP Bridge
+#    Branch: main
+#    Created: 18.10.2026 (Warsaw Time)
+#
+# = MODULE INFO:
+#    Module: Modbus TCP Load Generator (host tool)
+#    Version: v1.0.0
+#    Created: 18.10.2026 (Warsaw Time)
+#    Last Modified: 18.10.2026 (Warsaw Time)
+#    Author: ESP32 Development Team
+#
+# = DESCRIPTION:
+#    Drives the bridge's Modbus TCP server with FC03 reads and reports the
+#    request round trip as seen by the client socket (TCP_NODELAY on both
+#    ends). Every connection runs in its own thread with one request in
+#    flight (or --pipeline requests), the way SCADA pollers do.
+#
+#    Round trip = request written to the last response byte read. On the
+#    device side the same request is recorded in LATENCY_MODBUS_REQUEST
+#    (/metrics, bridge_latency_seconds{path="modbus"}), which excludes the
+#    network; the difference between the two is Wi-Fi and the host stack.
+#
+#    Responses are checked (transaction ID, function, byte count);
+#    exceptions and mismatches are counted as errors.
+#
+# = USAGE:
+#    python scripts/modbus_load.py 192.168.1.50
+#    python scripts/modbus_load.py 192.168.1.50 -c 3 -n 125 --duration 30
+#    python scripts/modbus_load.py 192.168.1.50 --start 0 --span 3200 --pipeline 4
+#
+# =====================================================================
+
+import argparse
+import random
+import socket
+import struct
+import sys
+import threading
+import time
+
+
+def recv_exact(sock, length):
+    data = b""
+    while len(data) < length:
+        chunk = sock.recv(length - len(data))
+        if not chunk:
+            raise ConnectionError("connection closed by the server")
+        data += chunk
+    return data
+
+
+def read_response(sock):
+    header = recv_exact(sock, 7)
+    transaction, protocol, length, unit = struct.unpack(">HHHB", header)
+    return transaction, recv_exact(sock, length - 1)
+
+
+class Worker(threading.Thread):
+    def __init__(self, args, deadline, seed):
+        super().__init__(daemon=True)
+        self.args = args
+        self.deadline = deadline
+        self.random = random.Random(seed)
+        self.samples = []
+        self.errors = 0
+        self.failure = None
+
+    def request(self, transaction):
+        span = max(1, self.args.span - self.args.registers + 1)
+        start = self.args.start + self.random.randrange(span)
+        return struct.pack(">HHHBBHH", transaction, 0, 6, self.args.unit, 3, start, self.args.registers)
+
+    def run(self):
+        try:
+            sock = socket.create_connection((self.args.host, self.args.port), timeout=self.args.timeout)
+            sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        except OSError as error:
+            self.failure = str(error)
+            return
+
+        transaction = 0
+        in_flight = {}
+        try:
+            while time.monotonic() < self.deadline:
+                while len(in_flight) < self.args.pipeline:
+                    transaction = (transaction + 1) & 0xFFFF
+                    in_flight[transaction] = time.perf_counter()
+                    sock.sendall(self.request(transaction))
+                reply_id, pdu = read_response(sock)
+                sent = in_flight.pop(reply_id, None)
+                if sent is None or pdu[0] != 3 or pdu[1] != 2 * self.args.registers:
+                    self.errors += 1
+                    continue
+                self.samples.append(time.perf_counter() - sent)
+        except (OSError, ConnectionError) as error:
+            self.failure = str(error)
+        finally:
+            sock.close()
+
+
+def percentile(ordered, fraction):
+    if not ordered:
+        return 0.0
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Modbus TCP FC03 load generator")
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=502)
+    parser.add_argument("--unit", type=int, default=1, help="unit (slave) id")
+    parser.add_argument("-c", "--connections", type=int, default=1)
+    parser.add_argument("-n", "--registers", type=int, default=10, help="registers per read (1-125)")
+    parser.add_argument("--start", type=int, default=0, help="first register of the read area")
+    parser.add_argument("--span", type=int, default=200, help="registers in the read area")
+    parser.add_argument("--pipeline", type=int, default=1, help="requests in flight per connection")
+    parser.add_argument("--duration", type=float, default=10.0, help="seconds")
+    parser.add_argument("--timeout", type=float, default=2.0, help="socket timeout [s]")
+    args = parser.parse_args()
+
+    if not 1 <= args.registers <= 125:
+        parser.error("--registers must be 1-125")
+
+    deadline = time.monotonic() + args.duration
+    workers = [Worker(args, deadline, seed) for seed in range(args.connections)]
+    for worker in workers:
+        worker.start()
+    for worker in workers:
+        worker.join()
+
+    samples = sorted(s for worker in workers for s in worker.samples)
+    errors = sum(worker.errors for worker in workers)
+    for index, worker in enumerate(workers):
+        if worker.failure:
+            print(f"connection {index}: {worker.failure}", file=sys.stderr)
+
+    print(f"{len(samples)} responses in {args.duration:.1f} s "
+          f"({len(samples) / args.duration:.0f}/s), {errors} errors, "
+          f"{args.connections} connection(s), {args.registers} registers, pipeline {args.pipeline}")
+    if samples:
+        print("round trip [ms]: min {:.3f}  p50 {:.3f}  p90 {:.3f}  p99 {:.3f}  max {:.3f}".format(
+            samples[0] * 1e3, percentile(samples, 0.5) * 1e3, percentile(samples, 0.9) * 1e3,
+            percentile(samples, 0.99) * 1e3, samples[-1] * 1e3))
+    return 0 if samples and not any(worker.failure for worker in workers) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
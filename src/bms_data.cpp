@@ -10,12 +10,13 @@
 //
 // 📋 MODULE INFO:
 //    Module: BMS Data Management Implementation
-//    Version: v4.0.2
+//    Version: v4.0.3
 //    Created: 12.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.0.3 - 18.10.2026 - O(1) node -> slot map, slot remapping for live reconfig
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v4.0.0 - 12.08.2025 - Initial BMS data management implementation
 //
@@ -59,6 +60,11 @@
 BMSData bmsModules[MAX_BMS_NODES];
 uint16_t holdingRegisters[MODBUS_MAX_HOLDING_REGISTERS];
 
+// Node ID -> slot lookup, rebuilt whenever the BMS node list changes
+#define BMS_SLOT_NONE -1
+static int8_t nodeSlotMap[256];
+static bool nodeSlotMapValid = false;
+
 // ================================
 // === MULTIPLEXER UTILITIES ===
 // ================================
@@ -122,7 +128,7 @@ float convertMultiplexerValue(uint8_t type, uint16_t rawValue) {
 bool initializeBMSData() {
     // Initialize all BMS modules
     for (int i = 0; i < MAX_BMS_NODES; i++) {
-        memset(&bmsModules[i], 0, sizeof(BMSData));
+        bmsModules[i] = BMSData{};
         bmsModules[i].communicationOk = false;
     }
     
@@ -131,20 +137,99 @@ bool initializeBMSData() {
         holdingRegisters[i] = 0;
     }
     
+    rebuildBMSNodeSlotMap();
+    return true;
+}
+
+void rebuildBMSNodeSlotMap() {
+    extern SystemConfig systemConfig;
+    memset(nodeSlotMap, BMS_SLOT_NONE, sizeof(nodeSlotMap));
+    
+    // First occurrence wins - duplicated IDs keep the lower slot like the old linear search
+    for (int i = systemConfig.activeBmsNodes - 1; i >= 0; i--) {
+        if (i >= MAX_BMS_NODES) continue;
+        nodeSlotMap[systemConfig.bmsNodeIds[i]] = (int8_t)i;
+    }
+    nodeSlotMapValid = true;
+}
+
+bool remapBMSDataSlots(const uint8_t* oldNodeIds, int oldNodeCount) {
+    extern SystemConfig systemConfig;
+    if (!oldNodeIds || oldNodeCount < 0 || oldNodeCount > MAX_BMS_NODES) return false;
+    
+    // srcSlot[newSlot] = old slot whose data moves there, or -1 for a new node
+    int8_t srcSlot[MAX_BMS_NODES];
+    bool oldSlotUsed[MAX_BMS_NODES] = {false};
+    bool freshSlot[MAX_BMS_NODES] = {false};
+    int newCount = min(systemConfig.activeBmsNodes, MAX_BMS_NODES);
+    
+    for (int i = 0; i < MAX_BMS_NODES; i++) {
+        srcSlot[i] = BMS_SLOT_NONE;
+        if (i >= newCount) continue;
+        for (int j = 0; j < oldNodeCount; j++) {
+            if (!oldSlotUsed[j] && oldNodeIds[j] == systemConfig.bmsNodeIds[i]) {
+                srcSlot[i] = j;
+                oldSlotUsed[j] = true;
+                break;
+            }
+        }
+    }
+    
+    // Complete the permutation with released slots so it can be applied in place
+    int nextFree = 0;
+    for (int i = 0; i < MAX_BMS_NODES; i++) {
+        if (srcSlot[i] != BMS_SLOT_NONE) continue;
+        while (oldSlotUsed[nextFree]) nextFree++;
+        srcSlot[i] = nextFree;
+        oldSlotUsed[nextFree] = true;
+        freshSlot[i] = true;
+    }
+    
+    // Cycle-following permutation with a single temporary record
+    static BMSData tmp;
+    bool moved[MAX_BMS_NODES] = {false};
+    for (int start = 0; start < MAX_BMS_NODES; start++) {
+        if (moved[start] || srcSlot[start] == start) {
+            moved[start] = true;
+            continue;
+        }
+        tmp = bmsModules[start];
+        int dst = start;
+        while (true) {
+            moved[dst] = true;
+            int src = srcSlot[dst];
+            if (src == start) {
+                bmsModules[dst] = tmp;
+                break;
+            }
+            bmsModules[dst] = bmsModules[src];
+            dst = src;
+        }
+    }
+    
+    // Slots that now hold a different (or no) node start from a clean record
+    for (int i = 0; i < MAX_BMS_NODES; i++) {
+        if (freshSlot[i]) {
+            bmsModules[i] = BMSData{};
+            bmsModules[i].communicationOk = false;
+        }
+    }
+    
+    rebuildBMSNodeSlotMap();
     return true;
 }
 
 void resetBMSData(uint8_t nodeId) {
     int index = getBMSIndexByNodeId(nodeId);
     if (index >= 0 && index < MAX_BMS_NODES) {
-        memset(&bmsModules[index], 0, sizeof(BMSData));
+        bmsModules[index] = BMSData{};
         bmsModules[index].communicationOk = false;
     }
 }
 
 void resetAllBMSData() {
     for (int i = 0; i < MAX_BMS_NODES; i++) {
-        memset(&bmsModules[i], 0, sizeof(BMSData));
+        bmsModules[i] = BMSData{};
         bmsModules[i].communicationOk = false;
     }
 }
@@ -158,14 +243,11 @@ BMSData* getBMSData(uint8_t nodeId) {
 }
 
 int getBMSIndexByNodeId(uint8_t nodeId) {
-    // Find the index in the active BMS nodes list
-    extern SystemConfig systemConfig;
-    for (int i = 0; i < systemConfig.activeBmsNodes && i < MAX_BMS_NODES; i++) {
-        if (systemConfig.bmsNodeIds[i] == nodeId) {
-            return i;
-        }
+    // O(1) lookup in the node -> slot map (built from systemConfig.bmsNodeIds)
+    if (!nodeSlotMapValid) {
+        rebuildBMSNodeSlotMap();
     }
-    return -1; // Not found
+    return nodeSlotMap[nodeId]; // -1 when not configured
 }
 
 int getBatteryIndexFromNodeId(uint8_t nodeId) {
@@ -10,12 +10,28 @@
 //
 // 📋 MODULE INFO:
 //    Module: BMS Protocol and CAN Interface Implementation
-//    Version: v4.0.2
+//    Version: v4.1.8
 //    Created: 17.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.1.8 - 18.10.2026 - Debug print formats match their arguments (frame counters, 410 temperatures)
+//    v4.1.7 - 18.10.2026 - Failed CAN re-init on restart/reconfiguration kept visible in the reconfig stats
+//    v4.1.6 - 18.10.2026 - Error sampling and bus-off scheduling moved to can_bus (per channel); MCP2515 re-init kept here
+//    v4.1.5 - 18.10.2026 - BMS register area cleared under the register table lock on reconfiguration
+//    v4.1.4 - 18.10.2026 - Decoder keeps raw fixed-point values next to the floats
+//    v4.1.3 - 18.10.2026 - Per (node, frame type) payload cache: identical slow frames refresh freshness only
+//    v4.1.2 - 18.10.2026 - Field decoding split from the parsers (decodeBMSFrameData), DBC signal table dispatch
+//    v4.1.1 - 18.10.2026 - Runtime CAN mapping rules applied before protocol parsing
+//    v4.1.0 - 18.10.2026 - Frame dispatch bounded per call (frame/time budget), channels served round-robin
+//    v4.0.9 - 18.10.2026 - Parsed frames published on the event bus (Modbus/limits subscribe)
+//    v4.0.8 - 18.10.2026 - CAN load estimator buckets closed from the receive path
+//    v4.0.7 - 18.10.2026 - Frames drained per CAN channel into ingest rings, dispatched by protocol binding
+//    v4.0.6 - 18.10.2026 - TEC/REC sampling, error frame rate, bus-off recovery with backoff
+//    v4.0.5 - 18.10.2026 - SDO responses (0x580 + node) routed to the SDO client
+//    v4.0.4 - 18.10.2026 - Frames 510/410 feed TRIO HP fleet limit aggregation
+//    v4.0.3 - 18.10.2026 - Live reconfiguration of node list/CAN speed, downtime stats
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v4.0.1 - 17.08.2025 - Added main lifecycle functions and complete CAN handling
 //    v4.0.0 - 17.08.2025 - Initial BMS protocol implementation with 9 parsers
@@ -60,6 +76,12 @@
 #include "modbus_tcp.h"
 #include "utils.h"
 #include "trio_hp_manager.h"
+#include "bms_sdo.h"
+#include "can_bus.h"
+#include "can_load.h"
+#include "event_bus.h"
+#include "can_rules.h"
+#include "can_signals.h"
 #include <esp_task_wdt.h>
 
 // === 🔥 GLOBAL VARIABLES ===
@@ -89,7 +111,32 @@ static const uint32_t ERROR_RECOVERY_COOLDOWN = 60000; // 1 minute
 MCP_CAN* canController = nullptr;
 
 // 🔥 Protocol statistics
-BMSProtocolStats_t protocolStats = {0};
+BMSProtocolStats_t protocolStats = {};
+
+// 🔥 Live reconfiguration state (survives protocol restarts)
+static BMSReconfigStats_t reconfigStats = {};
+static portMUX_TYPE reconfigMux = portMUX_INITIALIZER_UNLOCKED;
+static volatile bool reconfigPending = false;
+static bool reconfigPersist = false;
+static uint8_t pendingNodeIds[MAX_BMS_NODES];
+static int pendingNodeCount = 0;
+static uint8_t pendingCanSpeed = CAN_125KBPS;
+
+// 🔥 CAN dispatch budget state
+static CANSliceStats_t sliceStats = {};
+static uint8_t sliceFirstChannel = 0;               // Round-robin start, alternates per slice
+
+// 🔥 Duplicate payload suppression state (indexed by BMS slot)
+typedef struct {
+  uint8_t data[8];
+  uint8_t nodeId;                    // 0 = empty
+  unsigned long parsedAt;            // millis() of the last full parse
+} BMSPayloadCacheEntry_t;
+
+static BMSPayloadCacheEntry_t payloadCache[MAX_BMS_NODES][BMS_FRAME_TYPE_COUNT];
+static BMSDedupStats_t dedupStats = {};
+static bool dedupDefaultsApplied = false;    // Runtime settings survive protocol restarts
+static uint8_t dedupTimingCounter = 0;
 
 // 🔥 Protocol configuration
 static BMSProtocolConfig_t protocolConfig = {
@@ -119,7 +166,7 @@ void checkStackUsage() {
   if (freeStack < STACK_WARNING_THRESHOLD) {
     stackOverflowCount++;
     DEBUG_PRINTF("⚠️ Stack warning: Only %lu bytes free (used: %lu bytes)\n", 
-                 freeStack, usedStack);
+                 (unsigned long)freeStack, (unsigned long)usedStack);
   }
 }
 
@@ -131,7 +178,7 @@ bool checkRecursionDepth(const char* functionName) {
   
   if (recursionDepth > MAX_RECURSION_DEPTH) {
     DEBUG_PRINTF("❌ Recursion depth exceeded in %s: %lu\n", 
-                 functionName, recursionDepth);
+                 functionName, (unsigned long)recursionDepth);
     recursionDepth--; // Restore depth before returning
     return false;
   }
@@ -154,7 +201,7 @@ void exitRecursionTracking() {
 void printStackStats() {
   uint32_t freeStack = uxTaskGetStackHighWaterMark(NULL);
   DEBUG_PRINTF("📊 Stack Stats: Max used=%lu, Current free=%lu, Warnings=%lu\n",
-               maxStackUsage, freeStack, stackOverflowCount);
+               (unsigned long)maxStackUsage, (unsigned long)freeStack, (unsigned long)stackOverflowCount);
 }
 
 // === 🔥 ERROR RECOVERY FUNCTIONS ===
@@ -189,7 +236,7 @@ bool attemptErrorRecovery() {
   lastErrorRecovery = now;
   errorRecoveryCount++;
   
-  DEBUG_PRINTF("🔧 Attempting error recovery (attempt #%lu)\n", errorRecoveryCount);
+  DEBUG_PRINTF("🔧 Attempting error recovery (attempt #%lu)\n", (unsigned long)errorRecoveryCount);
   
   // Recovery steps
   bool recovered = false;
@@ -229,10 +276,10 @@ bool attemptErrorRecovery() {
 void emergencySystemRestart() {
   systemRestartCount++;
   
-  DEBUG_PRINTF("🚨 EMERGENCY RESTART #%lu - System recovery failed\n", systemRestartCount);
-  DEBUG_PRINTF("   Stack overflows: %lu\n", stackOverflowCount);
-  DEBUG_PRINTF("   Recovery attempts: %lu\n", errorRecoveryCount);
-  DEBUG_PRINTF("   Max stack usage: %lu bytes\n", maxStackUsage);
+  DEBUG_PRINTF("🚨 EMERGENCY RESTART #%lu - System recovery failed\n", (unsigned long)systemRestartCount);
+  DEBUG_PRINTF("   Stack overflows: %lu\n", (unsigned long)stackOverflowCount);
+  DEBUG_PRINTF("   Recovery attempts: %lu\n", (unsigned long)errorRecoveryCount);
+  DEBUG_PRINTF("   Max stack usage: %lu bytes\n", (unsigned long)maxStackUsage);
   
   // Give time for debug output
   delay(2000);
@@ -246,14 +293,68 @@ void emergencySystemRestart() {
  */
 void printErrorRecoveryStats() {
   DEBUG_PRINTF("📊 Error Recovery Stats:\n");
-  DEBUG_PRINTF("   Recovery attempts: %lu\n", errorRecoveryCount);
-  DEBUG_PRINTF("   System restarts: %lu\n", systemRestartCount);
+  DEBUG_PRINTF("   Recovery attempts: %lu\n", (unsigned long)errorRecoveryCount);
+  DEBUG_PRINTF("   System restarts: %lu\n", (unsigned long)systemRestartCount);
   DEBUG_PRINTF("   Last recovery: %lu ms ago\n", 
                millis() - lastErrorRecovery);
 }
 
 // === 🔥 GŁÓWNE FUNKCJE PROTOKOŁU (wymagane przez main.cpp) ===
 
+/**
+ * @brief Prędkość, z jaką MCP2515 faktycznie zostanie zainicjalizowany
+ */
+uint8_t getEffectiveCANSpeed(uint8_t canSpeed) {
+  return getCANSpeedKbps(canSpeed) == 0 ? CAN_125KBPS : canSpeed;  // Unsupported value - BMS default
+}
+
+/**
+ * @brief Zapisz wynik re-inicjalizacji CAN (błąd zostaje widoczny do następnej udanej)
+ */
+static void recordCANReinitResult(bool success, uint8_t canSpeed) {
+  if (success) return;  // Cleared by initializeMCP2515() itself
+  
+  reconfigStats.failedReconfigCount++;
+  reconfigStats.reinitFailed = true;
+  reconfigStats.failedCanSpeed = getEffectiveCANSpeed(canSpeed);
+  reconfigStats.lastFailureTime = millis();
+  Serial.printf("[BMS] CAN re-init at %u kbps failed\n", getCANSpeedKbps(reconfigStats.failedCanSpeed));
+}
+
+/**
+ * @brief Wyzeruj stan timeoutów wszystkich skonfigurowanych węzłów
+ */
+static void resetNodeCommunicationState() {
+  for (int i = 0; i < systemConfig.activeBmsNodes; i++) {
+    uint8_t nodeId = systemConfig.bmsNodeIds[i];
+    BMSData* bms = getBMSData(nodeId);
+    if (bms) {
+      memset(bms->frameTimestamps, 0, sizeof(bms->frameTimestamps));
+      bms->lastCommunication = 0;
+      bms->communicationActive = false;
+    }
+  }
+}
+
+/**
+ * @brief Zapisz czas przestoju przetwarzania ramek podczas rekonfiguracji
+ */
+static void recordReconfigDowntime(unsigned long startUs, bool canReinitialized) {
+  unsigned long downtimeUs = micros() - startUs;
+  
+  reconfigStats.reconfigCount++;
+  if (canReinitialized) reconfigStats.canReinitCount++;
+  reconfigStats.lastDowntimeUs = downtimeUs;
+  if (downtimeUs > reconfigStats.maxDowntimeUs) {
+    reconfigStats.maxDowntimeUs = downtimeUs;
+  }
+  reconfigStats.lastReconfigTime = millis();
+  
+  Serial.printf("[BMS] Reconfiguration done in %lu us (CAN re-init: %s, %u kbps, %d nodes)\n",
+                downtimeUs, canReinitialized ? "yes" : "no",
+                getCANSpeedKbps(reconfigStats.activeCanSpeed), systemConfig.activeBmsNodes);
+}
+
 /**
  * @brief Inicjalizacja protokołu BMS + CAN
  * @return true jeśli sukces, false jeśli błąd
@@ -264,8 +365,19 @@ bool setupBMSProtocol() {
   protocolStartTime = millis();
   protocolHealthy = false;
   
+  if (!dedupDefaultsApplied) {
+    dedupStats.enabled = true;
+    dedupStats.typeMask = BMS_DEDUP_DEFAULT_TYPES;
+    dedupDefaultsApplied = true;
+  }
+  
   // 1. Initialize CAN controller
-  if (!initializeCAN()) {
+  bool canReady = initializeCAN();
+  
+  // 1b. Channel layer (a second bus comes up even if the primary failed)
+  initCANBus();
+  
+  if (!canReady) {
     DEBUG_PRINTF("❌ Failed to initialize CAN controller\n");
     return false;
   }
@@ -275,22 +387,17 @@ bool setupBMSProtocol() {
   protocolStats.startTime = millis();
   
   // 3. Reset all BMS communication timestamps
-  for (int i = 0; i < systemConfig.activeBmsNodes; i++) {
-    uint8_t nodeId = systemConfig.bmsNodeIds[i];
-    BMSData* bms = getBMSData(nodeId);
-    if (bms) {
-      memset(bms->frameTimestamps, 0, sizeof(bms->frameTimestamps));
-      bms->lastCommunication = 0;
-      bms->communicationActive = false;
-    }
-  }
+  resetNodeCommunicationState();
+  
+  // 4. SDO client (on-demand object dictionary reads)
+  initBMSSdo();
   
   protocolHealthy = true;
   lastCANActivity = millis();
   
   DEBUG_PRINTF("✅ BMS Protocol initialized successfully\n");
   DEBUG_PRINTF("   🎯 Monitoring %d BMS nodes\n", systemConfig.activeBmsNodes);
-  DEBUG_PRINTF("   🚌 CAN Bus: 125 kbps, MCP2515 controller\n");
+  DEBUG_PRINTF("   🚌 CAN Bus: %u kbps, MCP2515 controller\n", getCANSpeedKbps(reconfigStats.activeCanSpeed));
   DEBUG_PRINTF("   📊 Frame validation: %s\n", protocolConfig.enableFrameValidation ? "enabled" : "disabled");
   
   return true;
@@ -315,22 +422,241 @@ void shutdownBMSProtocol() {
 
 /**
  * @brief Restart protokołu BMS
+ * 
+ * MCP2515 jest inicjalizowany ponownie tylko gdy zmieniła się prędkość CAN
+ * (lub kontroler nie działa). W przeciwnym razie resetowany jest tylko stan
+ * protokołu, a kontroler dalej odbiera ramki.
  * @return true jeśli sukces, false jeśli błąd
  */
 bool restartBMSProtocol() {
   DEBUG_PRINTF("🔄 Restarting BMS Protocol...\n");
   
-  shutdownBMSProtocol();
-  delay(1000);  // Give time for cleanup
+  unsigned long startUs = micros();
+  bool bitrateChanged = !isCANInitialized() ||
+                        reconfigStats.activeCanSpeed != getEffectiveCANSpeed(systemConfig.canSpeed);
+  bool success;
   
-  return setupBMSProtocol();
+  if (bitrateChanged) {
+    shutdownBMSProtocol();
+    delay(10);  // Let the transceiver settle before re-programming the bit timing
+    success = setupBMSProtocol();
+  } else {
+    resetBMSProtocolStats();
+    resetNodeCommunicationState();
+    protocolHealthy = true;
+    lastCANActivity = millis();
+    success = true;
+  }
+  
+  if (bitrateChanged) recordCANReinitResult(success, systemConfig.canSpeed);
+  recordReconfigDowntime(startUs, bitrateChanged);
+  return success;
+}
+
+// === 🔥 LIVE RECONFIGURATION ===
+
+/**
+ * @brief Zastosuj nową listę węzłów BMS i prędkość CAN bez restartu urządzenia
+ * 
+ * Dane węzłów, które pozostają w konfiguracji, są przenoszone do nowych slotów
+ * (liczniki energii i stan nie są tracone), mapa nodeId -> slot oraz bloki
+ * rejestrów Modbus są budowane od nowa. MCP2515 jest re-inicjalizowany tylko
+ * przy zmianie prędkości. Musi być wołane z pętli głównej.
+ * @return true jeśli sukces, false jeśli błąd
+ */
+bool applyBMSReconfiguration(const uint8_t* nodeIds, int nodeCount, uint8_t canSpeed) {
+  if (!nodeIds || nodeCount < 1 || nodeCount > MAX_BMS_NODES) {
+    return false;
+  }
+  
+  unsigned long startUs = micros();
+  
+  // Snapshot the current node list so slot data can follow its node
+  uint8_t oldNodeIds[MAX_BMS_NODES];
+  int oldNodeCount = min(systemConfig.activeBmsNodes, MAX_BMS_NODES);
+  memcpy(oldNodeIds, systemConfig.bmsNodeIds, sizeof(oldNodeIds));
+  
+  systemConfig.activeBmsNodes = nodeCount;
+  memcpy(systemConfig.bmsNodeIds, nodeIds, nodeCount);
+  systemConfig.canSpeed = canSpeed;
+  
+  // 1. Node -> slot map and per-slot data (acceptance is decided by the slot map)
+  remapBMSDataSlots(oldNodeIds, oldNodeCount);
+  
+  // Cached payloads belong to the old slots
+  memset(payloadCache, 0, sizeof(payloadCache));
+  
+  // 2. Register blocks follow the slots - rebuild the whole BMS area
+  lockModbusRegisters();
+  memset(holdingRegisters, 0, MAX_BMS_NODES * BMS_REGISTERS_PER_MODULE * sizeof(uint16_t));
+  unlockModbusRegisters();
+  for (int i = 0; i < systemConfig.activeBmsNodes; i++) {
+    updateModbusRegisters(systemConfig.bmsNodeIds[i]);
+  }
+  
+  // 3. CAN controller only when the bitrate actually changes
+  bool bitrateChanged = !isCANInitialized() || reconfigStats.activeCanSpeed != getEffectiveCANSpeed(canSpeed);
+  bool success = true;
+  if (bitrateChanged) {
+    shutdownCAN();
+    success = initializeCAN();
+    recordCANReinitResult(success, canSpeed);
+  }
+  protocolHealthy = success;
+  
+  recordReconfigDowntime(startUs, bitrateChanged);
+  return success;
+}
+
+/**
+ * @brief Zgłoś rekonfigurację z innego zadania (np. handler HTTP)
+ * 
+ * Konfiguracja jest kopiowana i stosowana w następnym wywołaniu
+ * processBMSProtocol(), więc nie koliduje z przetwarzaniem ramek.
+ * @return true jeśli przyjęto, false jeśli parametry są niepoprawne
+ */
+bool requestBMSReconfiguration(const uint8_t* nodeIds, int nodeCount, uint8_t canSpeed, bool persist) {
+  if (!nodeIds || nodeCount < 1 || nodeCount > MAX_BMS_NODES) {
+    return false;
+  }
+  
+  portENTER_CRITICAL(&reconfigMux);
+  memcpy(pendingNodeIds, nodeIds, nodeCount);
+  pendingNodeCount = nodeCount;
+  pendingCanSpeed = canSpeed;
+  reconfigPersist = persist;
+  reconfigPending = true;
+  portEXIT_CRITICAL(&reconfigMux);
+  
+  return true;
+}
+
+/**
+ * @brief Czy czeka rekonfiguracja do zastosowania
+ */
+bool isBMSReconfigurationPending() {
+  return reconfigPending;
+}
+
+/**
+ * @brief Zastosuj oczekującą rekonfigurację (wołane z pętli głównej)
+ */
+static void processPendingReconfiguration() {
+  if (!reconfigPending) return;
+  
+  uint8_t nodeIds[MAX_BMS_NODES];
+  int nodeCount;
+  uint8_t canSpeed;
+  bool persist;
+  
+  portENTER_CRITICAL(&reconfigMux);
+  memcpy(nodeIds, pendingNodeIds, sizeof(nodeIds));
+  nodeCount = pendingNodeCount;
+  canSpeed = pendingCanSpeed;
+  persist = reconfigPersist;
+  reconfigPending = false;
+  portEXIT_CRITICAL(&reconfigMux);
+  
+  applyBMSReconfiguration(nodeIds, nodeCount, canSpeed);
+  
+  if (persist && !saveConfiguration()) {
+    Serial.println("[BMS] Failed to persist reconfigured BMS settings");
+  }
+}
+
+/**
+ * @brief Pobierz statystyki rekonfiguracji
+ */
+const BMSReconfigStats_t* getBMSReconfigStats() {
+  return &reconfigStats;
+}
+
+/**
+ * @brief Prędkość CAN w kbps dla stałej biblioteki mcp_can
+ */
+uint16_t getCANSpeedKbps(uint8_t canSpeed) {
+  switch (canSpeed) {
+    case CAN_125KBPS:  return 125;
+    case CAN_250KBPS:  return 250;
+    case CAN_500KBPS:  return 500;
+    case CAN_1000KBPS: return 1000;
+    default:           return 0;
+  }
+}
+
+/**
+ * @brief Rozdziel ramkę z kanału do stosu protokołu przypisanego do tego kanału
+ */
+static void dispatchCANFrame(uint8_t channel, CANFrame_t* frame) {
+  CANProtocol_t protocol = getCANFrameProtocol(channel, frame->extended);
+  if (getCANProtocolChannel(protocol) != channel) return;  // Nothing bound to this channel
+  
+  // Runtime mapping rules and the DBC signal table (third-party devices) see every frame of a bound channel
+  bool mapped = applyCANRules(frame->id, frame->extended, frame->len, frame->data);
+  mapped |= applyCANSignals(frame->id, frame->extended, frame->len, frame->data);
+  
+  if (protocol == CAN_PROTOCOL_TRIO) {
+    processTrioHPCanFrame(frame->id, frame->data, frame->len);
+    return;
+  }
+  
+  unsigned long canId = frame->id;
+  unsigned char len = frame->len;
+  unsigned char* buf = frame->data;
+  
+  // 🔥 DETAILED FRAME DEBUG (like in working code)
+  DEBUG_PRINTF("🔍 CAN%d: ID=0x%lX Len=%d Data=[", channel, canId, len);
+  for (int i = 0; i < len; i++) {
+    DEBUG_PRINTF("%02X", buf[i]);
+    if (i < len - 1) DEBUG_PRINTF(" ");
+  }
+  
+  // 🔥 FIXED: Add frame type analysis like in working code (using ranges)
+  if (len != 8) {
+    DEBUG_PRINTF("] ⚠️ Invalid frame length: %d (expected 8)\n", len);
+  } else if (canId >= CAN_FRAME_190_BASE && canId < CAN_FRAME_190_BASE + 32) {
+    DEBUG_PRINTF("] (Basic data)\n");
+  } else if (canId >= CAN_FRAME_290_BASE && canId < CAN_FRAME_290_BASE + 32) {
+    DEBUG_PRINTF("] (Cell voltages)\n");
+  } else if (canId >= CAN_FRAME_310_BASE && canId < CAN_FRAME_310_BASE + 32) {
+    DEBUG_PRINTF("] (Multiplexed)\n");
+  } else if (canId >= CAN_FRAME_1B0_BASE && canId < CAN_FRAME_1B0_BASE + 32) {
+    DEBUG_PRINTF("] (Additional)\n");
+  } else if (canId >= CAN_FRAME_710_BASE && canId < CAN_FRAME_710_BASE + 32) {
+    DEBUG_PRINTF("] (CANopen)\n");
+  } else if (trioHPIsHeartbeatFrame(canId)) {
+    DEBUG_PRINTF("] (TRIO HP Heartbeat)\n");
+  } else {
+    DEBUG_PRINTF("] (Type unknown)\n");
+  }
+  
+  protocolStats.totalFramesReceived++;
+  lastCANActivity = millis();
+  
+  // Frame of a mapped device, not a BMS frame: decoded, nothing to validate
+  if (mapped && !isValidBMSFrame(canId)) return;
+  
+  // Validate frame
+  if (validateFrameData(canId, len, buf)) {
+    // Process the frame
+    parseCANFrame(canId, len, buf);
+    protocolStats.validBMSFrameCount++;
+  } else {
+    protocolStats.invalidFrameCount++;
+    DEBUG_PRINTF("⚠️ Frame validation failed for ID=0x%lX len=%d\n", canId, len);
+  }
 }
 
 /**
  * @brief Przetwarza wiadomości CAN (rzeczywista implementacja)
+ * 
+ * Każdy kanał jest najpierw opróżniany do swojego bufora pierścieniowego,
+ * potem ramki są rozdzielane według przypisania protokołów do kanałów.
+ * Rozdzielanie jest ograniczone budżetem (ramki/czas) - reszta czeka w
+ * buforze na następny przebieg pętli, żeby Modbus i TRIO HP nie czekały.
  */
 void processCANMessages() {
-  if (!canController || !canInitialized) {
+  if (!isCANChannelAvailable(CAN_CHANNEL_PRIMARY) && !isCANChannelAvailable(CAN_CHANNEL_SECONDARY)) {
     static unsigned long lastErrorMsg = 0;
     if (millis() - lastErrorMsg > 10000) { // Warn every 10 seconds
       DEBUG_PRINTF("⚠️ CAN not available: controller=%p initialized=%d\n", canController, canInitialized);
@@ -358,76 +684,66 @@ void processCANMessages() {
                  protocolStats.readErrorCount);
   }
   
-  unsigned long canId;
-  unsigned char len = 0;
-  unsigned char buf[8];
-  
-  // 🔥 HARDWARE DEBUG: Check for available messages
-  uint8_t checkResult = canController->checkReceive();
-  
-  static unsigned long lastDebugCheck = 0;
-  if (millis() - lastDebugCheck > 2000) { // Debug every 2 seconds
-    DEBUG_PRINTF("🔍 CAN checkReceive() result: %d (CAN_MSGAVAIL=%d)\n", checkResult, CAN_MSGAVAIL);
-    lastDebugCheck = millis();
+  // Controllers are always emptied completely (the MCP2515 holds two frames)
+  uint16_t backlog = 0;
+  for (uint8_t channel = 0; channel < CAN_CHANNEL_COUNT; channel++) {
+    if (!isCANChannelAvailable(channel)) continue;
+    
+    const CANChannelStats_t* channelStats = getCANChannelStats(channel);
+    unsigned long readErrors = channelStats->rxReadErrors;
+    uint8_t drained = canBusDrain(channel);
+    protocolStats.readErrorCount += channelStats->rxReadErrors - readErrors;
+    
+    if (drained > 0) {
+      DEBUG_PRINTF("🔍 CAN%d: %d frames drained (ring depth %d)\n", channel, drained, channelStats->ringDepth);
+    }
+    backlog += canBusBacklog(channel);
   }
   
-  // Check for available messages and process them
-  while (checkResult == CAN_MSGAVAIL) {
-    DEBUG_PRINTF("🔍 CAN message available, attempting to read...\n");
-    
-    uint8_t readResult = canController->readMsgBuf(&len, buf);
-    DEBUG_PRINTF("🔍 readMsgBuf() result: %d (CAN_OK=%d)\n", readResult, CAN_OK);
+  // Dispatch one budgeted slice, one frame per channel in turn
+  if (backlog > 0) {
+    uint8_t frameBudget = getCANSliceFrameBudget(backlog);
+    unsigned long timeBudgetUs = backlog >= CAN_SLICE_OVERLOAD_DEPTH ? 2 * CAN_SLICE_BUDGET_US : CAN_SLICE_BUDGET_US;
+    unsigned long sliceStart = micros();
+    uint8_t dispatched = 0;
+    bool timeUp = false;
+    bool popped = true;
     
-    if (readResult == CAN_OK) {
-      canId = canController->getCanId();
-      
-      // 🔥 DETAILED FRAME DEBUG (like in working code)
-      DEBUG_PRINTF("🔍 CAN: ID=0x%lX Len=%d Data=[", canId, len);
-      for (int i = 0; i < len; i++) {
-        DEBUG_PRINTF("%02X", buf[i]);
-        if (i < len - 1) DEBUG_PRINTF(" ");
+    while (popped && dispatched < frameBudget && !timeUp) {
+      popped = false;
+      for (uint8_t i = 0; i < CAN_CHANNEL_COUNT && dispatched < frameBudget; i++) {
+        uint8_t channel = (sliceFirstChannel + i) % CAN_CHANNEL_COUNT;
+        CANFrame_t frame;
+        if (!isCANChannelAvailable(channel) || !canBusPop(channel, &frame)) continue;
+        dispatchCANFrame(channel, &frame);
+        dispatched++;
+        popped = true;
       }
-      
-      // 🔥 FIXED: Add frame type analysis like in working code (using ranges)
-      if (len != 8) {
-        DEBUG_PRINTF("] ⚠️ Invalid frame length: %d (expected 8)\n", len);
-      } else if (canId >= CAN_FRAME_190_BASE && canId < CAN_FRAME_190_BASE + 32) {
-        DEBUG_PRINTF("] (Basic data)\n");
-      } else if (canId >= CAN_FRAME_290_BASE && canId < CAN_FRAME_290_BASE + 32) {
-        DEBUG_PRINTF("] (Cell voltages)\n");
-      } else if (canId >= CAN_FRAME_310_BASE && canId < CAN_FRAME_310_BASE + 32) {
-        DEBUG_PRINTF("] (Multiplexed)\n");
-      } else if (canId >= CAN_FRAME_1B0_BASE && canId < CAN_FRAME_1B0_BASE + 32) {
-        DEBUG_PRINTF("] (Additional)\n");
-      } else if (canId >= CAN_FRAME_710_BASE && canId < CAN_FRAME_710_BASE + 32) {
-        DEBUG_PRINTF("] (CANopen)\n");
-      } else if (trioHPIsHeartbeatFrame(canId)) {
-        DEBUG_PRINTF("] (TRIO HP Heartbeat)\n");
-      } else {
-        DEBUG_PRINTF("] (Type unknown)\n");
-      }
-      
-      protocolStats.totalFramesReceived++;
-      lastCANActivity = millis();
-      
-      // Validate frame
-      if (validateFrameData(canId, len, buf)) {
-        // Process the frame
-        parseCANFrame(canId, len, buf);
-        protocolStats.validBMSFrameCount++;
+      timeUp = micros() - sliceStart >= timeBudgetUs;
+    }
+    sliceFirstChannel = (sliceFirstChannel + 1) % CAN_CHANNEL_COUNT;
+    
+    uint8_t left = getCANBacklog();
+    sliceStats.slices++;
+    sliceStats.framesDispatched += dispatched;
+    sliceStats.lastFrameBudget = frameBudget;
+    sliceStats.lastBacklog = left;
+    if (left > sliceStats.peakBacklog) sliceStats.peakBacklog = left;
+    if (left > 0) {
+      sliceStats.backlogSlices++;
+      if (timeUp) {
+        sliceStats.timeLimitHits++;
       } else {
-        protocolStats.invalidFrameCount++;
-        DEBUG_PRINTF("⚠️ Frame validation failed for ID=0x%lX len=%d\n", canId, len);
+        sliceStats.frameLimitHits++;
       }
-    } else {
-      protocolStats.readErrorCount++;
-      DEBUG_PRINTF("❌ CAN readMsgBuf failed with result: %d\n", readResult);
     }
-    
-    // Check for next message
-    checkResult = canController->checkReceive();
+    sliceStats.lastSliceUs = micros() - sliceStart;
+    if (sliceStats.lastSliceUs > sliceStats.maxSliceUs) sliceStats.maxSliceUs = sliceStats.lastSliceUs;
   }
   
+  updateCANBusUtilisation();
+  updateCANLoad();
+  
   // Exit recursion tracking
   exitRecursionTracking();
 }
@@ -436,7 +752,23 @@ void processCANMessages() {
  * @brief Główna pętla przetwarzania protokołu BMS (zastępuje processCAN)
  */
 void processBMSProtocol() {
+  // Live reconfiguration requested from another task (web server)
+  processPendingReconfiguration();
+  
+  // Rule file reload requested from the web server
+  processCANRulesReload();
+  
+  // SDO dispatch/timeouts run even without CAN so queued reads fail instead of hanging
+  processBMSSdo();
+  
+  // Error counters and bus-off recovery on every CAN channel (also while a controller is down)
+  sampleCANErrorCounters();
+  
   if (!protocolHealthy || !canInitialized) {
+    // TRIO HP on its own channel keeps running while the BMS bus is down
+    if (getCANProtocolChannel(CAN_PROTOCOL_TRIO) != CAN_CHANNEL_PRIMARY) {
+      processCANMessages();
+    }
     return;
   }
   
@@ -483,6 +815,10 @@ bool isBMSProtocolHealthy() {
     return false;
   }
   
+  if (getCANErrorStats(getCANProtocolChannel(CAN_PROTOCOL_BMS))->state == CAN_ERROR_STATE_BUS_OFF) {
+    return false;
+  }
+  
   // Check if we have recent CAN activity
   unsigned long timeSinceActivity = millis() - lastCANActivity;
   if (timeSinceActivity > protocolConfig.frameTimeoutMs) {
@@ -560,7 +896,7 @@ bool initializeCAN() {
   
   DEBUG_PRINTF("✅ CAN controller initialized successfully\n");
   DEBUG_PRINTF("   📍 CS Pin: %d\n", CAN_CS_PIN);
-  DEBUG_PRINTF("   🚌 Baud Rate: 125 kbps\n");
+  DEBUG_PRINTF("   🚌 Baud Rate: %u kbps\n", getCANSpeedKbps(reconfigStats.activeCanSpeed));
   DEBUG_PRINTF("   🎯 Frame filters: BMS protocols\n");
   
   return true;
@@ -576,7 +912,9 @@ bool initializeMCP2515() {
     return false;
   }
   
-  DEBUG_PRINTF("🔄 Initializing CAN at 125 kbps (fixed)...\n");
+  uint8_t canSpeed = getEffectiveCANSpeed(systemConfig.canSpeed);
+  
+  DEBUG_PRINTF("🔄 Initializing CAN at %u kbps...\n", getCANSpeedKbps(canSpeed));
   
   // 🔥 Additional CS pin manipulation before begin (like in working code)
   DEBUG_PRINTF("🔍 CS pin manipulation: LOW->HIGH\n");
@@ -588,13 +926,13 @@ bool initializeMCP2515() {
   // 🔥 HARDWARE DEBUG: Test SPI communication before CAN init
   DEBUG_PRINTF("🔍 Testing SPI communication with MCP2515...\n");
   
-  // Initialize MCP2515 with 125kbps (compatible with BMS)
-  DEBUG_PRINTF("🔍 Calling canController->begin(CAN_125KBPS)...\n");
-  uint8_t initResult = canController->begin(CAN_125KBPS);
+  // Initialize MCP2515 with the configured bitrate
+  DEBUG_PRINTF("🔍 Calling canController->begin(%u kbps)...\n", getCANSpeedKbps(canSpeed));
+  uint8_t initResult = canController->begin(canSpeed);
   DEBUG_PRINTF("🔍 canController->begin() returned: %d (CAN_OK=%d)\n", initResult, CAN_OK);
   
   if (initResult != CAN_OK) {
-    DEBUG_PRINTF("❌ MCP2515 initialization failed at 125 kbps! Result: %d\n", initResult);
+    DEBUG_PRINTF("❌ MCP2515 initialization failed at %u kbps! Result: %d\n", getCANSpeedKbps(canSpeed), initResult);
     DEBUG_PRINTF("   Possible causes:\n");
     DEBUG_PRINTF("   - SPI wiring issue\n");
     DEBUG_PRINTF("   - CS pin incorrect (%d)\n", CAN_CS_PIN);
@@ -603,8 +941,11 @@ bool initializeMCP2515() {
     return false;
   }
   
-  DEBUG_PRINTF("✅ CAN initialized at 125 kbps (fixed)\n");
-  DEBUG_PRINTF("📋 CAN controller ready at 125 kbps\n");
+  reconfigStats.activeCanSpeed = canSpeed;
+  reconfigStats.reinitFailed = false;
+  
+  DEBUG_PRINTF("✅ CAN initialized at %u kbps\n", getCANSpeedKbps(canSpeed));
+  DEBUG_PRINTF("📋 CAN controller ready at %u kbps\n", getCANSpeedKbps(canSpeed));
   
   // 🔥 HARDWARE DEBUG: Test if controller responds
   DEBUG_PRINTF("🔍 Testing CAN controller responsiveness...\n");
@@ -655,6 +996,36 @@ bool isCANInitialized() {
   return canInitialized && canController != nullptr;
 }
 
+/**
+ * @brief Ponowna inicjalizacja MCP2515 po bus-off (harmonogram prób w can_bus)
+ * @return true jeśli kontroler odpowiada po re-inicjalizacji
+ */
+bool recoverCANController() {
+  if (!canController) return false;
+  canInitialized = false;
+  canInitialized = initializeMCP2515();
+  return canInitialized;
+}
+
+// === 🔥 CAN DISPATCH BUDGET ===
+
+uint16_t getCANBacklog() {
+  uint16_t backlog = 0;
+  for (uint8_t channel = 0; channel < CAN_CHANNEL_COUNT; channel++) {
+    backlog += canBusBacklog(channel);
+  }
+  return backlog;
+}
+
+uint8_t getCANSliceFrameBudget(uint16_t backlog) {
+  if (backlog > CAN_RING_SIZE) backlog = CAN_RING_SIZE;
+  return CAN_SLICE_MIN_FRAMES + (uint16_t)(CAN_SLICE_MAX_FRAMES - CAN_SLICE_MIN_FRAMES) * backlog / CAN_RING_SIZE;
+}
+
+const CANSliceStats_t* getCANSliceStats() {
+  return &sliceStats;
+}
+
 /**
  * @brief Legacy processCAN wrapper - directly calls processCANMessages to avoid recursion
  */
@@ -670,6 +1041,114 @@ void processCAN() {
 /**
  * @brief Główna funkcja przetwarzania ramek CAN
  */
+// === 🔥 DUPLICATE PAYLOAD SUPPRESSION ===
+
+typedef void (*BMSFrameParser_t)(uint8_t nodeId, unsigned char* data);
+
+static void countBMSFrame(BMSData* bms, BMSFrameType_t frameType) {
+  switch (frameType) {
+    case BMS_FRAME_TYPE_190: bms->frame190Count++; break;
+    case BMS_FRAME_TYPE_290: bms->frame290Count++; break;
+    case BMS_FRAME_TYPE_310: bms->frame310Count++; break;
+    case BMS_FRAME_TYPE_390: bms->frame390Count++; break;
+    case BMS_FRAME_TYPE_410: bms->frame410Count++; break;
+    case BMS_FRAME_TYPE_510: bms->frame510Count++; break;
+    case BMS_FRAME_TYPE_490: bms->frame490Count++; break;
+    case BMS_FRAME_TYPE_1B0: bms->frame1B0Count++; break;
+    case BMS_FRAME_TYPE_710: bms->frame710Count++; break;
+    default: break;
+  }
+}
+
+/**
+ * @brief Uruchom parser ramki BMS, chyba że payload się nie zmienił
+ * 
+ * Identyczny payload (ten sam węzeł i typ ramki, pełny parse nie starszy
+ * niż BMS_DEDUP_REPARSE_MS) odświeża tylko świeżość węzła: licznik ramek,
+ * status komunikacji i timestamp typu ramki. Dekodowanie, zdarzenie
+ * EVENT_BMS_FRAME_PARSED i remap rejestrów Modbus są pomijane - dane są
+ * już takie, jakie dałby parser.
+ */
+static void runBMSParser(uint8_t nodeId, BMSFrameType_t frameType, BMSFrameParser_t parser, unsigned char* buf) {
+  if (nodeId == 0) return;
+  if (!dedupStats.enabled || !(dedupStats.typeMask & (1U << frameType))) {
+    parser(nodeId, buf);
+    return;
+  }
+  
+  int slot = getBMSIndexByNodeId(nodeId);  // Accepted by extractNodeId()
+  BMSData* bms = getBMSData(nodeId);
+  if (slot < 0 || slot >= MAX_BMS_NODES || !bms) return;
+  
+  BMSPayloadCacheEntry_t* entry = &payloadCache[slot][frameType];
+  // Timing every frame would cost about as much as the decode it measures
+  bool timed = (++dedupTimingCounter % BMS_DEDUP_TIMING_SAMPLE) == 0;
+  unsigned long startUs = timed ? micros() : 0;
+  unsigned long now = millis();
+  
+  if (entry->nodeId == nodeId && now - entry->parsedAt < BMS_DEDUP_REPARSE_MS &&
+      memcmp(entry->data, buf, 8) == 0) {
+    // updateCommunicationStatus() and the timestamp, with one clock read
+    countBMSFrame(bms, frameType);
+    bms->lastCommunication = now;
+    bms->communicationActive = true;
+    bms->frameTimestamps[frameType] = now;
+    protocolStats.lastActivity = now;
+    dedupStats.suppressed[frameType]++;
+    if (timed) {
+      dedupStats.suppressedUs += micros() - startUs;
+      dedupStats.suppressedSamples++;
+    }
+    return;
+  }
+  
+  parser(nodeId, buf);
+  memcpy(entry->data, buf, 8);
+  entry->nodeId = nodeId;
+  entry->parsedAt = now;
+  dedupStats.parsed[frameType]++;
+  if (timed) {
+    dedupStats.parseUs[frameType] += micros() - startUs;
+    dedupStats.parseSamples[frameType]++;
+  }
+}
+
+void setBMSDedupEnabled(bool enabled) {
+  if (enabled && !dedupStats.enabled) {
+    memset(payloadCache, 0, sizeof(payloadCache));  // Payloads seen while off were parsed without caching
+  }
+  dedupStats.enabled = enabled;
+}
+
+void setBMSDedupTypes(uint16_t typeMask) {
+  dedupStats.typeMask = typeMask & ((1U << BMS_FRAME_TYPE_COUNT) - 1);
+  memset(payloadCache, 0, sizeof(payloadCache));
+}
+
+void resetBMSDedupStats() {
+  bool enabled = dedupStats.enabled;
+  uint16_t typeMask = dedupStats.typeMask;
+  memset(&dedupStats, 0, sizeof(dedupStats));
+  dedupStats.enabled = enabled;
+  dedupStats.typeMask = typeMask;
+  memset(payloadCache, 0, sizeof(payloadCache));
+}
+
+const BMSDedupStats_t* getBMSDedupStats() {
+  // Saving per type: suppressed frames x (mean full parse - mean suppressed frame)
+  float hitUs = dedupStats.suppressedSamples > 0 ?
+                (float)dedupStats.suppressedUs / dedupStats.suppressedSamples : 0.0f;
+  
+  float saved = 0.0f;
+  for (uint8_t t = 0; t < BMS_FRAME_TYPE_COUNT; t++) {
+    if (dedupStats.parseSamples[t] == 0 || dedupStats.suppressed[t] == 0) continue;
+    float parseUs = (float)dedupStats.parseUs[t] / dedupStats.parseSamples[t];
+    if (parseUs > hitUs) saved += (parseUs - hitUs) * dedupStats.suppressed[t];
+  }
+  dedupStats.savedUs = (unsigned long)saved;
+  return &dedupStats;
+}
+
 void parseCANFrame(unsigned long canId, unsigned char len, unsigned char* buf) {
   // 🔍 CAN FRAME DEBUG MONITOR - Show all incoming frames
   DEBUG_PRINTF("📥 CAN RX: ID=0x%03lX Len=%d Data=[", canId, len);
@@ -698,6 +1177,8 @@ void parseCANFrame(unsigned long canId, unsigned char len, unsigned char* buf) {
     DEBUG_PRINTF("1B0 NodeID=%ld", canId - CAN_FRAME_1B0_BASE + 1);
   } else if (canId >= CAN_FRAME_710_BASE && canId < CAN_FRAME_710_BASE + 32) {
     DEBUG_PRINTF("710 NodeID=%ld", canId - CAN_FRAME_710_BASE + 1);
+  } else if (isBMSSdoResponseFrame(canId)) {
+    DEBUG_PRINTF("SDO NodeID=%ld", canId - BMS_SDO_RESPONSE_BASE);
   } else if (trioHPIsHeartbeatFrame(canId)) {
     DEBUG_PRINTF("TRIO-HP HeartBeat");
   } else {
@@ -726,32 +1207,25 @@ void parseCANFrame(unsigned long canId, unsigned char len, unsigned char* buf) {
   
   // 🔥 FIXED: Route to appropriate parser based on CAN ID RANGES (not mask!)
   if (canId >= CAN_FRAME_190_BASE && canId < CAN_FRAME_190_BASE + 32) {
-    uint8_t nodeId = extractNodeId(canId, CAN_FRAME_190_BASE);
-    if (nodeId > 0) parseBMSFrame190(nodeId, buf);
+    runBMSParser(extractNodeId(canId, CAN_FRAME_190_BASE), BMS_FRAME_TYPE_190, parseBMSFrame190, buf);
   } else if (canId >= CAN_FRAME_290_BASE && canId < CAN_FRAME_290_BASE + 32) {
-    uint8_t nodeId = extractNodeId(canId, CAN_FRAME_290_BASE);
-    if (nodeId > 0) parseBMSFrame290(nodeId, buf);
+    runBMSParser(extractNodeId(canId, CAN_FRAME_290_BASE), BMS_FRAME_TYPE_290, parseBMSFrame290, buf);
   } else if (canId >= CAN_FRAME_310_BASE && canId < CAN_FRAME_310_BASE + 32) {
-    uint8_t nodeId = extractNodeId(canId, CAN_FRAME_310_BASE);
-    if (nodeId > 0) parseBMSFrame310(nodeId, buf);
+    runBMSParser(extractNodeId(canId, CAN_FRAME_310_BASE), BMS_FRAME_TYPE_310, parseBMSFrame310, buf);
   } else if (canId >= CAN_FRAME_390_BASE && canId < CAN_FRAME_390_BASE + 32) {
-    uint8_t nodeId = extractNodeId(canId, CAN_FRAME_390_BASE);
-    if (nodeId > 0) parseBMSFrame390(nodeId, buf);
+    runBMSParser(extractNodeId(canId, CAN_FRAME_390_BASE), BMS_FRAME_TYPE_390, parseBMSFrame390, buf);
   } else if (canId >= CAN_FRAME_410_BASE && canId < CAN_FRAME_410_BASE + 32) {
-    uint8_t nodeId = extractNodeId(canId, CAN_FRAME_410_BASE);
-    if (nodeId > 0) parseBMSFrame410(nodeId, buf);
+    runBMSParser(extractNodeId(canId, CAN_FRAME_410_BASE), BMS_FRAME_TYPE_410, parseBMSFrame410, buf);
   } else if (canId >= CAN_FRAME_510_BASE && canId < CAN_FRAME_510_BASE + 32) {
-    uint8_t nodeId = extractNodeId(canId, CAN_FRAME_510_BASE);
-    if (nodeId > 0) parseBMSFrame510(nodeId, buf);
+    runBMSParser(extractNodeId(canId, CAN_FRAME_510_BASE), BMS_FRAME_TYPE_510, parseBMSFrame510, buf);
   } else if (canId >= CAN_FRAME_490_BASE && canId < CAN_FRAME_490_BASE + 32) {
-    uint8_t nodeId = extractNodeId(canId, CAN_FRAME_490_BASE);
-    if (nodeId > 0) parseBMSFrame490(nodeId, buf);
+    runBMSParser(extractNodeId(canId, CAN_FRAME_490_BASE), BMS_FRAME_TYPE_490, parseBMSFrame490, buf);
   } else if (canId >= CAN_FRAME_1B0_BASE && canId < CAN_FRAME_1B0_BASE + 32) {
-    uint8_t nodeId = extractNodeId(canId, CAN_FRAME_1B0_BASE);
-    if (nodeId > 0) parseBMSFrame1B0(nodeId, buf);
+    runBMSParser(extractNodeId(canId, CAN_FRAME_1B0_BASE), BMS_FRAME_TYPE_1B0, parseBMSFrame1B0, buf);
   } else if (canId >= CAN_FRAME_710_BASE && canId < CAN_FRAME_710_BASE + 32) {
-    uint8_t nodeId = extractNodeId(canId, CAN_FRAME_710_BASE);
-    if (nodeId > 0) parseBMSFrame710(nodeId, buf);
+    runBMSParser(extractNodeId(canId, CAN_FRAME_710_BASE), BMS_FRAME_TYPE_710, parseBMSFrame710, buf);
+  } else if (isBMSSdoResponseFrame(canId)) {
+    handleBMSSdoResponse(canId, buf);
   } else {
     // 🚨 UNRECOGNIZED FRAME - This might be the missing Node 26 frames!
     DEBUG_PRINTF("🚨 UNRECOGNIZED CAN Frame: ID=0x%03lX (Base would be 0x%03lX)\n", canId, canId & 0xFF80);
@@ -769,13 +1243,8 @@ void parseCANFrame(unsigned long canId, unsigned char len, unsigned char* buf) {
 uint8_t extractNodeId(unsigned long canId, uint16_t baseId) {
   uint8_t nodeId = canId - baseId + 1;  // 🔥 Fix: Node ID = (CAN_ID - BASE) + 1
   
-  // Validate node ID is in our configured list
-  for (int i = 0; i < systemConfig.activeBmsNodes; i++) {
-    if (systemConfig.bmsNodeIds[i] == nodeId) {
-      return nodeId;
-    }
-  }
-  return 0; // Invalid node ID
+  // Validate node ID against the slot map (software acceptance filter)
+  return getBMSIndexByNodeId(nodeId) >= 0 ? nodeId : 0;
 }
 
 /**
@@ -843,12 +1312,16 @@ void checkCommunicationTimeouts() {
 
 /**
  * @brief Aktualizuj timestamp dla konkretnego typu ramki
+ * 
+ * Wywoływane przez każdy parser po zapisaniu danych, więc tu też
+ * publikowane jest zdarzenie EVENT_BMS_FRAME_PARSED (Modbus, limity).
  */
 void updateFrameTimestamp(uint8_t nodeId, BMSFrameType_t frameType) {
   BMSData* bms = getBMSData(nodeId);
   if (!bms || frameType >= BMS_FRAME_TYPE_COUNT) return;
   
   bms->frameTimestamps[frameType] = millis();
+  publishBMSFrameEvent(nodeId, frameType);
 }
 
 /**
@@ -911,12 +1384,7 @@ uint8_t extractNodeIdFromCanId(unsigned long canId) {
  * @brief Sprawdź czy Node ID jest poprawny
  */
 bool isValidBMSNodeId(uint8_t nodeId) {
-  for (int i = 0; i < systemConfig.activeBmsNodes; i++) {
-    if (systemConfig.bmsNodeIds[i] == nodeId) {
-      return true;
-    }
-  }
-  return false;
+  return getBMSIndexByNodeId(nodeId) >= 0;
 }
 
 /**
@@ -1008,15 +1476,15 @@ void printAllFramesAnalysis(uint8_t nodeId) {
   
   DEBUG_PRINTF("\n📊 === BMS%d FRAME ANALYSIS ===\n", nodeId);
   DEBUG_PRINTF("Frame Counters:\n");
-  DEBUG_PRINTF("   190 (Basic): %lu\n", bms->frame190Count);
-  DEBUG_PRINTF("   290 (Cell V): %lu\n", bms->frame290Count);
-  DEBUG_PRINTF("   310 (SOH): %lu\n", bms->frame310Count);
-  DEBUG_PRINTF("   390 (Max V): %lu\n", bms->frame390Count);
-  DEBUG_PRINTF("   410 (Temp): %lu\n", bms->frame410Count);
-  DEBUG_PRINTF("   510 (Power): %lu\n", bms->frame510Count);
-  DEBUG_PRINTF("   490 (Mux): %lu\n", bms->frame490Count);
-  DEBUG_PRINTF("   1B0 (Add): %lu\n", bms->frame1B0Count);
-  DEBUG_PRINTF("   710 (CAN): %lu\n", bms->frame710Count);
+  DEBUG_PRINTF("   190 (Basic): %d\n", bms->frame190Count);
+  DEBUG_PRINTF("   290 (Cell V): %d\n", bms->frame290Count);
+  DEBUG_PRINTF("   310 (SOH): %d\n", bms->frame310Count);
+  DEBUG_PRINTF("   390 (Max V): %d\n", bms->frame390Count);
+  DEBUG_PRINTF("   410 (Temp): %d\n", bms->frame410Count);
+  DEBUG_PRINTF("   510 (Power): %d\n", bms->frame510Count);
+  DEBUG_PRINTF("   490 (Mux): %d\n", bms->frame490Count);
+  DEBUG_PRINTF("   1B0 (Add): %d\n", bms->frame1B0Count);
+  DEBUG_PRINTF("   710 (CAN): %d\n", bms->frame710Count);
   
   DEBUG_PRINTF("\nCommunication Status:\n");
   DEBUG_PRINTF("   Active: %s\n", bms->communicationActive ? "YES" : "NO");
@@ -1055,6 +1523,33 @@ void printBMSProtocolStatistics() {
   DEBUG_PRINTF("Max Processing Time: %lu ms\n", protocolStats.maxProcessingTime);
   DEBUG_PRINTF("Last Activity: %lu ms ago\n", millis() - protocolStats.lastActivity);
   
+  const CANErrorStats_t* canErrors = getCANErrorStats(getCANProtocolChannel(CAN_PROTOCOL_BMS));
+  DEBUG_PRINTF("CAN Error State: %s (TEC=%u REC=%u, peak %u/%u)\n",
+               getCANErrorStateName(canErrors->state), canErrors->tec, canErrors->rec,
+               canErrors->peakTec, canErrors->peakRec);
+  DEBUG_PRINTF("Error Frames (est.): %lu, %.2f/s; RX overflows: %lu\n",
+               canErrors->errorFrameEstimate, canErrors->errorFrameRate, canErrors->rxOverflowCount);
+  DEBUG_PRINTF("Bus-off: %lu (recovered %lu, attempts %lu, last %lu ms, max %lu ms)\n",
+               canErrors->busOffCount, canErrors->recoveries, canErrors->recoveryAttempts,
+               canErrors->lastRecoveryMs, canErrors->maxRecoveryMs);
+  DEBUG_PRINTF("Dispatch slices: %lu, %lu frames, budget %u (backlog %u, peak %u)\n",
+               sliceStats.slices, sliceStats.framesDispatched, sliceStats.lastFrameBudget,
+               sliceStats.lastBacklog, sliceStats.peakBacklog);
+  DEBUG_PRINTF("Slices with backlog: %lu (frame limit %lu, time limit %lu), slice %lu us (max %lu us)\n",
+               sliceStats.backlogSlices, sliceStats.frameLimitHits, sliceStats.timeLimitHits,
+               sliceStats.lastSliceUs, sliceStats.maxSliceUs);
+  const BMSDedupStats_t* dedup = getBMSDedupStats();
+  unsigned long parsed = 0, suppressed = 0;
+  for (uint8_t t = 0; t < BMS_FRAME_TYPE_COUNT; t++) {
+    parsed += dedup->parsed[t];
+    suppressed += dedup->suppressed[t];
+  }
+  DEBUG_PRINTF("Duplicate payloads: %s, %lu suppressed / %lu parsed, ~%lu us parse time saved\n",
+               dedup->enabled ? "ON" : "off", suppressed, parsed, dedup->savedUs);
+  printCANBusStatus();
+  printCANLoadStatus();
+  printEventBusStatus();
+  
   DEBUG_PRINTF("==================================\n\n");
   
   // Print individual BMS statistics
@@ -1166,7 +1661,7 @@ void printFrame1B0Diagnostics(uint8_t nodeId) {
   if (!bms) return;
   
   DEBUG_PRINTF("\n🔍 BMS%d Frame 1B0 Diagnostics:\n", nodeId);
-  DEBUG_PRINTF("   Count: %lu\n", bms->frame1B0Count);
+  DEBUG_PRINTF("   Count: %d\n", bms->frame1B0Count);
   DEBUG_PRINTF("   Raw Data: ");
   for (int i = 0; i < 8; i++) {
     DEBUG_PRINTF("%02X ", bms->frame1B0Data[i]);
@@ -1182,7 +1677,7 @@ void printFrame710Diagnostics(uint8_t nodeId) {
   if (!bms) return;
   
   DEBUG_PRINTF("\n🔍 BMS%d Frame 710 Diagnostics:\n", nodeId);
-  DEBUG_PRINTF("   Count: %lu\n", bms->frame710Count);
+  DEBUG_PRINTF("   Count: %d\n", bms->frame710Count);
   DEBUG_PRINTF("   CANopen State: 0x%02X\n", bms->canopenState);
 }
 
@@ -1194,7 +1689,7 @@ void printMultiplexerDiagnostics(uint8_t nodeId) {
   if (!bms) return;
   
   DEBUG_PRINTF("\n🔍 BMS%d Multiplexer Diagnostics:\n", nodeId);
-  DEBUG_PRINTF("   Frame 490 Count: %lu\n", bms->frame490Count);
+  DEBUG_PRINTF("   Frame 490 Count: %d\n", bms->frame490Count);
   DEBUG_PRINTF("   Last Mux Type: 0x%02X\n", bms->mux490Type);
   DEBUG_PRINTF("   Raw Data: ");
   for (int i = 0; i < 8; i++) {
@@ -1214,7 +1709,7 @@ void printBMSHeartbeatExtended(uint8_t nodeId) {
   DEBUG_PRINTF("   Status: %s\n", bms->communicationActive ? "ACTIVE" : "TIMEOUT");
   DEBUG_PRINTF("   Voltage: %.2fV Current: %.1fA SOC: %.1f%%\n", 
                bms->batteryVoltage, bms->batteryCurrent, bms->soc);
-  DEBUG_PRINTF("   Frames: 190:%lu 290:%lu 310:%lu 490:%lu\n", 
+  DEBUG_PRINTF("   Frames: 190:%d 290:%d 310:%d 490:%d\n", 
                bms->frame190Count, bms->frame290Count, bms->frame310Count, bms->frame490Count);
   DEBUG_PRINTF("   Last Comm: %lu ms ago\n", millis() - bms->lastCommunication);
 }
@@ -1240,31 +1735,121 @@ void printSystemHeartbeat() {
   DEBUG_PRINTF("========================\n\n");
 }
 
+// === 🔥 FRAME DECODER ===
+// Pola ramek bez liczników, znaczników czasu i zdarzeń - parsery poniżej i
+// kontrola tablicy sygnałów (docs/bms_frames.dbc) dekodują tym samym kodem.
+// Pola stałoprzecinkowe zostają też w surowej postaci (*Raw) - rejestry
+// Modbus są z nich liczone całkowitoliczbowo, float tylko dla JSON/logiki
+void decodeBMSFrameData(BMSFrameType_t frameType, const unsigned char* data, BMSData* bms) {
+  switch (frameType) {
+    case BMS_FRAME_TYPE_190:
+      // Basic data
+      bms->batteryVoltageRaw = (data[0] << 8) | data[1];
+      bms->batteryCurrentRaw = (data[2] << 8) | data[3];
+      bms->remainingEnergyRaw = (data[4] << 8) | data[5];
+      bms->socRaw = data[6];
+      bms->batteryVoltage = bms->batteryVoltageRaw * 0.01f;         // [V]
+      bms->batteryCurrent = bms->batteryCurrentRaw * 0.01f;         // [A]
+      bms->remainingEnergy = bms->remainingEnergyRaw * 0.01f;       // [kWh]
+      bms->soc = bms->socRaw * 0.5f;                                 // [%]
+      
+      // Error flags from data[7]
+      bms->masterError = (data[7] & 0x01) != 0;
+      bms->cellVoltageError = (data[7] & 0x02) != 0;
+      bms->cellTempMinError = (data[7] & 0x04) != 0;
+      bms->cellTempMaxError = (data[7] & 0x08) != 0;
+      break;
+      
+    case BMS_FRAME_TYPE_290:
+      // Cell voltage data
+      bms->cellMinVoltageRaw = (data[1] << 8) | data[0];
+      bms->cellMeanVoltageRaw = (data[3] << 8) | data[2];
+      bms->cellMinVoltage = bms->cellMinVoltageRaw * 0.0001;  // V
+      bms->cellMeanVoltage = bms->cellMeanVoltageRaw * 0.0001;  // V
+      bms->minVoltageString = data[4];
+      bms->minVoltageBlock = data[5];
+      bms->minVoltageCell = data[6];
+      break;
+      
+    case BMS_FRAME_TYPE_310:
+      // SOH and resistance data
+      bms->sohRaw = (data[1] << 8) | data[0];
+      bms->dcirRaw = (data[3] << 8) | data[2];
+      bms->soh = bms->sohRaw * 0.01;  // %
+      bms->dcir = bms->dcirRaw * 0.01;  // mΩ
+      bms->cellMinTemperature = data[4] - 40;  // °C
+      bms->cellMeanTemperature = data[5] - 40;  // °C
+      break;
+      
+    case BMS_FRAME_TYPE_390:
+      // Maximum cell voltage data
+      bms->cellMaxVoltageRaw = (data[1] << 8) | data[0];
+      bms->cellVoltageDeltaRaw = (data[3] << 8) | data[2];
+      bms->cellMaxVoltage = bms->cellMaxVoltageRaw * 0.0001;  // V
+      bms->cellVoltageDelta = bms->cellVoltageDeltaRaw * 0.0001;  // V
+      bms->maxVoltageString = data[4];
+      bms->maxVoltageBlock = data[5];
+      bms->maxVoltageCell = data[6];
+      break;
+      
+    case BMS_FRAME_TYPE_410:
+      // Temperature and ready state data
+      bms->cellMaxTemperature = data[0] - 40;  // °C
+      bms->cellTempDelta = data[1];  // °C
+      bms->maxTempString = data[2];
+      bms->maxTempBlock = data[3];
+      bms->maxTempSensor = data[4];
+      bms->readyToCharge = (data[5] & 0x01) != 0;
+      bms->readyToDischarge = (data[5] & 0x02) != 0;
+      break;
+      
+    case BMS_FRAME_TYPE_510:
+      // Power limits and I/O data
+      bms->dcclRaw = (data[1] << 8) | data[0];
+      bms->ddclRaw = (data[3] << 8) | data[2];
+      bms->dccl = bms->dcclRaw * 0.1;  // A
+      bms->ddcl = bms->ddclRaw * 0.1;  // A
+      bms->inputs = data[4];
+      bms->outputs = data[5];
+      break;
+      
+    case BMS_FRAME_TYPE_490:
+      // Multiplexer type from first byte, raw frame data for specific parsers
+      bms->mux490Type = data[0];
+      for (int i = 0; i < 8; i++) {
+        bms->frame490Data[i] = data[i];
+      }
+      break;
+      
+    case BMS_FRAME_TYPE_1B0:
+      // Raw data for future processing
+      for (int i = 0; i < 8; i++) {
+        bms->frame1B0Data[i] = data[i];
+      }
+      break;
+      
+    case BMS_FRAME_TYPE_710:
+      // CANopen state
+      bms->canopenState = data[0];
+      break;
+      
+    default:
+      break;
+  }
+}
+
 // === 🔥 FRAME 190 PARSER - BASIC DATA ===
 void parseBMSFrame190(uint8_t nodeId, unsigned char* data) {
   BMSData* bms = getBMSData(nodeId);
   if (!bms) return;
   
-  // Parse basic data from frame 190
-  bms->batteryVoltage = ((data[0] << 8) | data[1]) * 0.01f;     // [V]
-  bms->batteryCurrent = ((data[2] << 8) | data[3]) * 0.01f;     // [A]  
-  bms->remainingEnergy = ((data[4] << 8) | data[5]) * 0.01f;    // [kWh]
-  bms->soc = data[6] * 0.5f;                                     // [%]
-  
-  // Parse error flags from data[7]
-  bms->masterError = (data[7] & 0x01) != 0;
-  bms->cellVoltageError = (data[7] & 0x02) != 0;
-  bms->cellTempMinError = (data[7] & 0x04) != 0;
-  bms->cellTempMaxError = (data[7] & 0x08) != 0;
+  decodeBMSFrameData(BMS_FRAME_TYPE_190, data, bms);
   
   // Update frame counter and communication status
   bms->frame190Count++;
   updateCommunicationStatus(nodeId);
   updateFrameTimestamp(nodeId, BMS_FRAME_TYPE_190);
   
-  // Update Modbus registers
-  updateModbusRegisters(nodeId);
-  
   if (protocolLoggingEnabled) {
     DEBUG_PRINTF("📊 BMS%d-190: V=%.2fV I=%.1fA SOC=%.1f%% E=%.1fkWh Err=%d\n", 
                  nodeId, bms->batteryVoltage, bms->batteryCurrent, 
@@ -1277,12 +1862,7 @@ void parseBMSFrame290(uint8_t nodeId, unsigned char* data) {
   BMSData* bms = getBMSData(nodeId);
   if (!bms) return;
   
-  // Parse cell voltage data
-  bms->cellMinVoltage = ((data[1] << 8) | data[0]) * 0.0001;  // V
-  bms->cellMeanVoltage = ((data[3] << 8) | data[2]) * 0.0001;  // V
-  bms->minVoltageString = data[4];
-  bms->minVoltageBlock = data[5];
-  bms->minVoltageCell = data[6];
+  decodeBMSFrameData(BMS_FRAME_TYPE_290, data, bms);
   
   // Update frame counter and communication status
   bms->frame290Count++;
@@ -1301,11 +1881,7 @@ void parseBMSFrame310(uint8_t nodeId, unsigned char* data) {
   BMSData* bms = getBMSData(nodeId);
   if (!bms) return;
   
-  // Parse SOH and resistance data
-  bms->soh = ((data[1] << 8) | data[0]) * 0.01;  // %
-  bms->dcir = ((data[3] << 8) | data[2]) * 0.01;  // mΩ
-  bms->cellMinTemperature = data[4] - 40;  // °C
-  bms->cellMeanTemperature = data[5] - 40;  // °C
+  decodeBMSFrameData(BMS_FRAME_TYPE_310, data, bms);
   
   // Update frame counter and communication status
   bms->frame310Count++;
@@ -1324,12 +1900,7 @@ void parseBMSFrame390(uint8_t nodeId, unsigned char* data) {
   BMSData* bms = getBMSData(nodeId);
   if (!bms) return;
   
-  // Parse maximum cell voltage data
-  bms->cellMaxVoltage = ((data[1] << 8) | data[0]) * 0.0001;  // V
-  bms->cellVoltageDelta = ((data[3] << 8) | data[2]) * 0.0001;  // V
-  bms->maxVoltageString = data[4];
-  bms->maxVoltageBlock = data[5];
-  bms->maxVoltageCell = data[6];
+  decodeBMSFrameData(BMS_FRAME_TYPE_390, data, bms);
   
   // Update frame counter and communication status
   bms->frame390Count++;
@@ -1348,14 +1919,7 @@ void parseBMSFrame410(uint8_t nodeId, unsigned char* data) {
   BMSData* bms = getBMSData(nodeId);
   if (!bms) return;
   
-  // Parse temperature and ready state data
-  bms->cellMaxTemperature = data[0] - 40;  // °C
-  bms->cellTempDelta = data[1];  // °C
-  bms->maxTempString = data[2];
-  bms->maxTempBlock = data[3];
-  bms->maxTempSensor = data[4];
-  bms->readyToCharge = (data[5] & 0x01) != 0;
-  bms->readyToDischarge = (data[5] & 0x02) != 0;
+  decodeBMSFrameData(BMS_FRAME_TYPE_410, data, bms);
   
   // Update frame counter and communication status
   bms->frame410Count++;
@@ -1363,7 +1927,7 @@ void parseBMSFrame410(uint8_t nodeId, unsigned char* data) {
   updateFrameTimestamp(nodeId, BMS_FRAME_TYPE_410);
   
   if (protocolLoggingEnabled) {
-    DEBUG_PRINTF("📊 BMS%d-410: TempMax=%d°C Delta=%d°C Pos=S%dB%dS%d RtC=%d RtD=%d\n", 
+    DEBUG_PRINTF("📊 BMS%d-410: TempMax=%.0f°C Delta=%.0f°C Pos=S%dB%dS%d RtC=%d RtD=%d\n", 
                  nodeId, bms->cellMaxTemperature, bms->cellTempDelta,
                  bms->maxTempString, bms->maxTempBlock, bms->maxTempSensor,
                  bms->readyToCharge, bms->readyToDischarge);
@@ -1375,11 +1939,7 @@ void parseBMSFrame510(uint8_t nodeId, unsigned char* data) {
   BMSData* bms = getBMSData(nodeId);
   if (!bms) return;
   
-  // Parse power limits and I/O data
-  bms->dccl = ((data[1] << 8) | data[0]) * 0.1;  // A
-  bms->ddcl = ((data[3] << 8) | data[2]) * 0.1;  // A
-  bms->inputs = data[4];
-  bms->outputs = data[5];
+  decodeBMSFrameData(BMS_FRAME_TYPE_510, data, bms);
   
   // Update frame counter and communication status
   bms->frame510Count++;
@@ -1397,14 +1957,9 @@ void parseBMSFrame490(uint8_t nodeId, unsigned char* data) {
   BMSData* bms = getBMSData(nodeId);
   if (!bms) return;
   
-  // Extract multiplexer type from first byte
-  uint8_t muxType = data[0];
-  bms->mux490Type = muxType;
-  
-  // Save raw frame data for specific parsers
-  for (int i = 0; i < 8; i++) {
-    bms->frame490Data[i] = data[i];
-  }
+  // Multiplexer type (first byte) and raw frame data
+  decodeBMSFrameData(BMS_FRAME_TYPE_490, data, bms);
+  uint8_t muxType = bms->mux490Type;
   
   // Parse based on multiplexer type (54 different types!)
   // Implementation note: Due to space constraints, showing key types only
@@ -1444,10 +1999,7 @@ void parseBMSFrame1B0(uint8_t nodeId, unsigned char* data) {
   BMSData* bms = getBMSData(nodeId);
   if (!bms) return;
   
-  // Save raw data for future processing
-  for (int i = 0; i < 8; i++) {
-    bms->frame1B0Data[i] = data[i];
-  }
+  decodeBMSFrameData(BMS_FRAME_TYPE_1B0, data, bms);
   
   // Update frame counter and communication status
   bms->frame1B0Count++;
@@ -1466,8 +2018,7 @@ void parseBMSFrame710(uint8_t nodeId, unsigned char* data) {
   BMSData* bms = getBMSData(nodeId);
   if (!bms) return;
   
-  // Parse CANopen state
-  bms->canopenState = data[0];
+  decodeBMSFrameData(BMS_FRAME_TYPE_710, data, bms);
   
   // Update frame counter and communication status
   bms->frame710Count++;
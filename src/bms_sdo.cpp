@@ -0,0 +1,589 @@
+// =====================================================================
+// === bms_sdo.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: BMS CANopen SDO Client Implementation
+//    Version: v1.0.2
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Expedited/segmented SDO upload, per-node pipelining, value cache
+//    v1.0.1 - 18.10.2026 - Requests sent on the CAN channel bound to BMS
+//    v1.0.2 - 18.10.2026 - Queued requests wait while the BMS channel is over the load budget
+//
+// 🎯 DEPENDENCIES:
+//    Internal: bms_sdo.h, bms_protocol.h, bms_data.h, can_bus.h (frame transmission)
+//    External: Arduino.h
+//
+// 📝 DESCRIPTION:
+//    A read request first reserves a cache entry (marked PENDING, so the
+//    same object is never queued twice) and then waits in the queue until
+//    the channel of its node is idle. Channels are indexed by BMS slot.
+//    The previous value of an entry stays readable while it is refreshed;
+//    validAt tells how old it is.
+//
+// =====================================================================
+
+#include "bms_sdo.h"
+#include "bms_protocol.h"
+#include "bms_data.h"
+#include "can_bus.h"
+#include "can_load.h"
+
+// === CHANNEL STATES ===
+typedef enum {
+  SDO_CHANNEL_IDLE = 0,
+  SDO_CHANNEL_INITIATE,      // Initiate upload sent, waiting for response
+  SDO_CHANNEL_SEGMENT        // Upload segment requested, waiting for data
+} SdoChannelState_t;
+
+typedef struct {
+  uint8_t state;             // SdoChannelState_t
+  uint8_t nodeId;
+  uint8_t entry;             // Cache entry being filled
+  uint16_t index;
+  uint8_t subIndex;
+  uint8_t toggle;
+  uint8_t retries;
+  uint8_t length;            // Bytes received so far
+  uint32_t expectedSize;     // Size announced by the server, 0 if not indicated
+  unsigned long sentAt;
+  uint8_t data[BMS_SDO_MAX_DATA];
+} SdoChannel_t;
+
+typedef struct {
+  uint8_t nodeId;
+  uint16_t index;
+  uint8_t subIndex;
+  uint8_t entry;
+} SdoRequest_t;
+
+// === GLOBAL VARIABLES ===
+static SdoChannel_t sdoChannels[MAX_BMS_NODES];
+static BMSSdoEntry_t sdoCache[BMS_SDO_CACHE_SIZE];
+static SdoRequest_t sdoQueue[BMS_SDO_QUEUE_SIZE];
+static uint8_t sdoQueueCount = 0;
+static BMSSdoStats_t sdoStats;
+static portMUX_TYPE sdoMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Modbus window selection
+static uint8_t sdoModbusNode = 0;
+static uint16_t sdoModbusIndex = 0;
+static uint8_t sdoModbusSubIndex = 0;
+static uint16_t sdoModbusMaxAge = BMS_SDO_DEFAULT_MAX_AGE_MS;
+
+// === PRIVATE HELPERS ===
+
+static uint32_t readLE32(const unsigned char* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Caller holds sdoMux
+static int findEntry(uint8_t nodeId, uint16_t index, uint8_t subIndex) {
+  for (int i = 0; i < BMS_SDO_CACHE_SIZE; i++) {
+    const BMSSdoEntry_t* e = &sdoCache[i];
+    if (e->status != BMS_SDO_STATUS_EMPTY && e->nodeId == nodeId &&
+        e->index == index && e->subIndex == subIndex) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Caller holds sdoMux. Free entry first, otherwise the least recently
+// completed one; entries with a transfer pending are never evicted.
+static int allocateEntry() {
+  int victim = -1;
+  for (int i = 0; i < BMS_SDO_CACHE_SIZE; i++) {
+    const BMSSdoEntry_t* e = &sdoCache[i];
+    if (e->status == BMS_SDO_STATUS_EMPTY) return i;
+    if (e->status == BMS_SDO_STATUS_PENDING) continue;
+    if (victim < 0 || (long)(e->updatedAt - sdoCache[victim].updatedAt) < 0) victim = i;
+  }
+  return victim;
+}
+
+static bool sendSdoFrame(uint8_t nodeId, const unsigned char* data) {
+  return canBusSend(CAN_PROTOCOL_BMS, BMS_SDO_REQUEST_BASE + nodeId, false, 8, data);
+}
+
+static bool sendInitiateUpload(SdoChannel_t* ch) {
+  unsigned char frame[8] = {0x40, (unsigned char)(ch->index & 0xFF), (unsigned char)(ch->index >> 8),
+                            ch->subIndex, 0, 0, 0, 0};
+  ch->sentAt = millis();
+  return sendSdoFrame(ch->nodeId, frame);
+}
+
+static bool sendUploadSegment(SdoChannel_t* ch) {
+  unsigned char frame[8] = {(unsigned char)(0x60 | (ch->toggle << 4)), 0, 0, 0, 0, 0, 0, 0};
+  ch->sentAt = millis();
+  return sendSdoFrame(ch->nodeId, frame);
+}
+
+static void sendAbort(const SdoChannel_t* ch, uint32_t abortCode) {
+  unsigned char frame[8] = {0x80, (unsigned char)(ch->index & 0xFF), (unsigned char)(ch->index >> 8),
+                            ch->subIndex,
+                            (unsigned char)(abortCode & 0xFF), (unsigned char)((abortCode >> 8) & 0xFF),
+                            (unsigned char)((abortCode >> 16) & 0xFF), (unsigned char)(abortCode >> 24)};
+  sendSdoFrame(ch->nodeId, frame);
+}
+
+// Store the result of a request in its cache entry and update statistics
+static void completeEntry(uint8_t entry, BMSSdoStatus_t status, uint32_t abortCode,
+                          const uint8_t* data, uint8_t length, bool segmented) {
+  unsigned long now = millis();
+
+  portENTER_CRITICAL(&sdoMux);
+  BMSSdoEntry_t* e = &sdoCache[entry];
+  e->status = status;
+  e->abortCode = abortCode;
+  e->updatedAt = now;
+
+  if (status == BMS_SDO_STATUS_VALID) {
+    memcpy(e->data, data, length);
+    e->length = length;
+    e->validAt = now;
+    e->everValid = true;
+
+    unsigned long latency = now - e->requestedAt;
+    sdoStats.lastLatencyMs = latency;
+    if (latency > sdoStats.maxLatencyMs) sdoStats.maxLatencyMs = latency;
+    unsigned long reads = sdoStats.expeditedReads + sdoStats.segmentedReads;
+    sdoStats.avgLatencyMs = (sdoStats.avgLatencyMs * reads + latency) / (reads + 1);
+    if (segmented) sdoStats.segmentedReads++;
+    else sdoStats.expeditedReads++;
+  } else if (status == BMS_SDO_STATUS_ABORTED) {
+    sdoStats.aborts++;
+  } else if (status == BMS_SDO_STATUS_TIMEOUT) {
+    sdoStats.timeouts++;
+  }
+  portEXIT_CRITICAL(&sdoMux);
+}
+
+static void finishChannel(SdoChannel_t* ch, BMSSdoStatus_t status, uint32_t abortCode) {
+  completeEntry(ch->entry, status, abortCode, ch->data, ch->length, ch->state == SDO_CHANNEL_SEGMENT);
+  ch->state = SDO_CHANNEL_IDLE;
+}
+
+static bool isNodeReachable(uint8_t nodeId) {
+  int slot = getBMSIndexByNodeId(nodeId);
+  if (slot < 0 || !isCANChannelAvailable(getCANProtocolChannel(CAN_PROTOCOL_BMS))) return false;
+  // SDO server is not active in STOPPED state
+  return bmsModules[slot].canopenState != CANOPEN_STATE_STOPPED;
+}
+
+// Move queued requests to idle channels, at most one per node
+static void dispatchQueuedRequests() {
+  SdoRequest_t started[MAX_BMS_NODES];
+  uint8_t startedCount = 0;
+  bool claimed[MAX_BMS_NODES] = {false};
+
+  portENTER_CRITICAL(&sdoMux);
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < sdoQueueCount; i++) {
+    const SdoRequest_t* req = &sdoQueue[i];
+    int slot = getBMSIndexByNodeId(req->nodeId);
+    if (slot < 0 || (sdoChannels[slot].state == SDO_CHANNEL_IDLE && !claimed[slot])) {
+      if (slot >= 0) claimed[slot] = true;
+      started[startedCount++] = *req;
+    } else {
+      sdoQueue[kept++] = *req;
+    }
+  }
+  sdoQueueCount = kept;
+  sdoStats.queued = kept;
+  portEXIT_CRITICAL(&sdoMux);
+
+  for (uint8_t i = 0; i < startedCount; i++) {
+    const SdoRequest_t* req = &started[i];
+    if (!isNodeReachable(req->nodeId)) {
+      completeEntry(req->entry, BMS_SDO_STATUS_UNAVAILABLE, 0, nullptr, 0, false);
+      continue;
+    }
+
+    SdoChannel_t* ch = &sdoChannels[getBMSIndexByNodeId(req->nodeId)];
+    ch->nodeId = req->nodeId;
+    ch->entry = req->entry;
+    ch->index = req->index;
+    ch->subIndex = req->subIndex;
+    ch->toggle = 0;
+    ch->retries = 0;
+    ch->length = 0;
+    ch->expectedSize = 0;
+    ch->state = SDO_CHANNEL_INITIATE;
+
+    if (!sendInitiateUpload(ch)) {
+      portENTER_CRITICAL(&sdoMux);
+      sdoStats.sendErrors++;
+      portEXIT_CRITICAL(&sdoMux);
+      finishChannel(ch, BMS_SDO_STATUS_UNAVAILABLE, 0);
+    }
+  }
+}
+
+static void checkChannelTimeouts() {
+  unsigned long now = millis();
+  uint8_t inFlight = 0;
+
+  for (int slot = 0; slot < MAX_BMS_NODES; slot++) {
+    SdoChannel_t* ch = &sdoChannels[slot];
+    if (ch->state == SDO_CHANNEL_IDLE) continue;
+
+    // Node removed from the slot map by a live reconfiguration
+    if (getBMSIndexByNodeId(ch->nodeId) != slot) {
+      finishChannel(ch, BMS_SDO_STATUS_UNAVAILABLE, 0);
+      continue;
+    }
+
+    if (now - ch->sentAt >= BMS_SDO_TIMEOUT_MS) {
+      // Only the initiate request is safe to repeat; a lost segment breaks the toggle sequence
+      if (ch->state == SDO_CHANNEL_INITIATE && ch->retries < BMS_SDO_MAX_RETRIES) {
+        ch->retries++;
+        portENTER_CRITICAL(&sdoMux);
+        sdoStats.retries++;
+        portEXIT_CRITICAL(&sdoMux);
+        if (sendInitiateUpload(ch)) {
+          inFlight++;
+          continue;
+        }
+      }
+      sendAbort(ch, BMS_SDO_ABORT_TIMEOUT);
+      finishChannel(ch, BMS_SDO_STATUS_TIMEOUT, BMS_SDO_ABORT_TIMEOUT);
+      continue;
+    }
+    inFlight++;
+  }
+
+  sdoStats.inFlight = inFlight;
+}
+
+static void abortChannel(SdoChannel_t* ch, uint32_t abortCode) {
+  sendAbort(ch, abortCode);
+  finishChannel(ch, BMS_SDO_STATUS_ABORTED, abortCode);
+}
+
+static void handleInitiateResponse(SdoChannel_t* ch, const unsigned char* buf) {
+  uint16_t index = buf[1] | (buf[2] << 8);
+  if (index != ch->index || buf[3] != ch->subIndex) return;  // Late answer to an older request
+
+  bool expedited = buf[0] & 0x02;
+  bool sizeIndicated = buf[0] & 0x01;
+
+  if (expedited) {
+    uint8_t unused = sizeIndicated ? (buf[0] >> 2) & 0x03 : 0;
+    ch->length = 4 - unused;
+    memcpy(ch->data, &buf[4], ch->length);
+    finishChannel(ch, BMS_SDO_STATUS_VALID, 0);
+    return;
+  }
+
+  ch->expectedSize = sizeIndicated ? readLE32(&buf[4]) : 0;
+  if (ch->expectedSize > BMS_SDO_MAX_DATA) {
+    abortChannel(ch, BMS_SDO_ABORT_OUT_OF_MEMORY);
+    return;
+  }
+
+  ch->state = SDO_CHANNEL_SEGMENT;
+  ch->toggle = 0;
+  if (!sendUploadSegment(ch)) {
+    portENTER_CRITICAL(&sdoMux);
+    sdoStats.sendErrors++;
+    portEXIT_CRITICAL(&sdoMux);
+    finishChannel(ch, BMS_SDO_STATUS_UNAVAILABLE, 0);
+  }
+}
+
+static void handleSegmentResponse(SdoChannel_t* ch, const unsigned char* buf) {
+  if (((buf[0] >> 4) & 0x01) != ch->toggle) {
+    abortChannel(ch, BMS_SDO_ABORT_TOGGLE);
+    return;
+  }
+
+  uint8_t count = 7 - ((buf[0] >> 1) & 0x07);
+  if (ch->length + count > BMS_SDO_MAX_DATA) {
+    abortChannel(ch, BMS_SDO_ABORT_OUT_OF_MEMORY);
+    return;
+  }
+  memcpy(&ch->data[ch->length], &buf[1], count);
+  ch->length += count;
+
+  if (buf[0] & 0x01) {  // Last segment
+    finishChannel(ch, BMS_SDO_STATUS_VALID, 0);
+    return;
+  }
+
+  ch->toggle ^= 1;
+  if (!sendUploadSegment(ch)) {
+    portENTER_CRITICAL(&sdoMux);
+    sdoStats.sendErrors++;
+    portEXIT_CRITICAL(&sdoMux);
+    finishChannel(ch, BMS_SDO_STATUS_UNAVAILABLE, 0);
+  }
+}
+
+// === SDO CLIENT FUNCTIONS ===
+
+void initBMSSdo() {
+  portENTER_CRITICAL(&sdoMux);
+  memset(sdoChannels, 0, sizeof(sdoChannels));
+  memset(sdoCache, 0, sizeof(sdoCache));
+  memset(&sdoStats, 0, sizeof(sdoStats));
+  sdoQueueCount = 0;
+  portEXIT_CRITICAL(&sdoMux);
+
+  Serial.printf("[BMS SDO] Client ready: %d channels, %d cache entries, timeout %dms\n",
+                MAX_BMS_NODES, BMS_SDO_CACHE_SIZE, BMS_SDO_TIMEOUT_MS);
+}
+
+void processBMSSdo() {
+  checkChannelTimeouts();
+  // Initiate + expedited response at worst-case length; stay queued over budget
+  if (sdoQueueCount > 0 && canLoadAdmit(CAN_PROTOCOL_BMS, 2 * canFrameBitsWorstCase(false, 8))) {
+    dispatchQueuedRequests();
+  }
+}
+
+bool isBMSSdoResponseFrame(unsigned long canId) {
+  return canId > BMS_SDO_RESPONSE_BASE && canId < BMS_SDO_RESPONSE_BASE + 0x80;
+}
+
+void handleBMSSdoResponse(unsigned long canId, const unsigned char* buf) {
+  uint8_t nodeId = canId - BMS_SDO_RESPONSE_BASE;
+  int slot = getBMSIndexByNodeId(nodeId);
+  if (slot < 0) return;
+
+  SdoChannel_t* ch = &sdoChannels[slot];
+  if (ch->state == SDO_CHANNEL_IDLE || ch->nodeId != nodeId) return;
+
+  uint8_t scs = buf[0] >> 5;
+  if (scs == 4) {  // Abort transfer
+    uint16_t index = buf[1] | (buf[2] << 8);
+    if (index == ch->index && buf[3] == ch->subIndex) {
+      finishChannel(ch, BMS_SDO_STATUS_ABORTED, readLE32(&buf[4]));
+    }
+    return;
+  }
+
+  if (ch->state == SDO_CHANNEL_INITIATE && scs == 2) {
+    handleInitiateResponse(ch, buf);
+  } else if (ch->state == SDO_CHANNEL_SEGMENT && scs == 0) {
+    handleSegmentResponse(ch, buf);
+  } else {
+    abortChannel(ch, BMS_SDO_ABORT_COMMAND);
+  }
+}
+
+bool requestBMSSdoRead(uint8_t nodeId, uint16_t index, uint8_t subIndex, unsigned long maxAgeMs) {
+  if (getBMSIndexByNodeId(nodeId) < 0) return false;
+
+  unsigned long now = millis();
+  bool accepted = false;
+
+  portENTER_CRITICAL(&sdoMux);
+  int entry = findEntry(nodeId, index, subIndex);
+  BMSSdoEntry_t* e = entry >= 0 ? &sdoCache[entry] : nullptr;
+
+  if (e && e->status == BMS_SDO_STATUS_PENDING) {
+    accepted = true;  // Already on its way
+  } else if (e && e->status == BMS_SDO_STATUS_VALID && maxAgeMs > 0 && now - e->validAt <= maxAgeMs) {
+    sdoStats.cacheHits++;
+    accepted = true;
+  } else if (sdoQueueCount >= BMS_SDO_QUEUE_SIZE) {
+    sdoStats.queueOverflows++;
+  } else {
+    if (entry < 0) {
+      entry = allocateEntry();
+      if (entry >= 0) {
+        e = &sdoCache[entry];
+        memset(e, 0, sizeof(BMSSdoEntry_t));
+        e->nodeId = nodeId;
+        e->index = index;
+        e->subIndex = subIndex;
+      }
+    }
+    if (entry >= 0) {
+      e->status = BMS_SDO_STATUS_PENDING;
+      e->requestedAt = now;
+
+      SdoRequest_t* req = &sdoQueue[sdoQueueCount++];
+      req->nodeId = nodeId;
+      req->index = index;
+      req->subIndex = subIndex;
+      req->entry = entry;
+      sdoStats.queued = sdoQueueCount;
+      sdoStats.requests++;
+      accepted = true;
+    } else {
+      sdoStats.queueOverflows++;  // Every cache entry has a transfer pending
+    }
+  }
+  portEXIT_CRITICAL(&sdoMux);
+
+  return accepted;
+}
+
+// === CACHE ACCESS ===
+
+bool getBMSSdoEntry(uint8_t nodeId, uint16_t index, uint8_t subIndex, BMSSdoEntry_t* out) {
+  if (out == nullptr) return false;
+
+  portENTER_CRITICAL(&sdoMux);
+  int entry = findEntry(nodeId, index, subIndex);
+  if (entry >= 0) *out = sdoCache[entry];
+  portEXIT_CRITICAL(&sdoMux);
+
+  return entry >= 0;
+}
+
+bool getBMSSdoEntryAt(uint8_t slot, BMSSdoEntry_t* out) {
+  if (out == nullptr || slot >= BMS_SDO_CACHE_SIZE) return false;
+
+  portENTER_CRITICAL(&sdoMux);
+  *out = sdoCache[slot];
+  portEXIT_CRITICAL(&sdoMux);
+
+  return out->status != BMS_SDO_STATUS_EMPTY;
+}
+
+bool getBMSSdoStats(BMSSdoStats_t* out) {
+  if (out == nullptr) return false;
+  portENTER_CRITICAL(&sdoMux);
+  *out = sdoStats;
+  portEXIT_CRITICAL(&sdoMux);
+  return true;
+}
+
+const char* getBMSSdoStatusName(uint8_t status) {
+  switch (status) {
+    case BMS_SDO_STATUS_EMPTY:       return "EMPTY";
+    case BMS_SDO_STATUS_PENDING:     return "PENDING";
+    case BMS_SDO_STATUS_VALID:       return "VALID";
+    case BMS_SDO_STATUS_ABORTED:     return "ABORTED";
+    case BMS_SDO_STATUS_TIMEOUT:     return "TIMEOUT";
+    case BMS_SDO_STATUS_UNAVAILABLE: return "UNAVAILABLE";
+    default:                         return "UNKNOWN";
+  }
+}
+
+void printBMSSdoStatus() {
+  BMSSdoStats_t stats;
+  getBMSSdoStats(&stats);
+
+  Serial.println("=== BMS SDO CLIENT ===");
+  Serial.printf("Requests: %lu, cache hits: %lu, queued: %d, in flight: %d\n",
+                stats.requests, stats.cacheHits, stats.queued, stats.inFlight);
+  Serial.printf("Reads: %lu expedited, %lu segmented; aborts: %lu, timeouts: %lu, retries: %lu\n",
+                stats.expeditedReads, stats.segmentedReads, stats.aborts, stats.timeouts, stats.retries);
+  Serial.printf("Latency: last %lums, avg %lums, max %lums; send errors: %lu, overflows: %lu\n",
+                stats.lastLatencyMs, stats.avgLatencyMs, stats.maxLatencyMs,
+                stats.sendErrors, stats.queueOverflows);
+
+  BMSSdoEntry_t entry;
+  const BMSSdoEntry_t* e = &entry;
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < BMS_SDO_CACHE_SIZE; i++) {
+    if (!getBMSSdoEntryAt(i, &entry)) continue;
+    Serial.printf("  Node %d 0x%04X:%02X %-11s len %d age %lums",
+                  e->nodeId, e->index, e->subIndex, getBMSSdoStatusName(e->status), e->length,
+                  e->everValid ? now - e->validAt : 0UL);
+    if (e->abortCode) Serial.printf(" abort 0x%08lX", (unsigned long)e->abortCode);
+    Serial.println();
+  }
+}
+
+// === MODBUS WINDOW ===
+
+bool isBMSSdoRegisterRange(uint16_t startAddress, uint16_t count) {
+  uint32_t end = (uint32_t)startAddress + count;
+  return count > 0 &&
+         startAddress >= BMS_SDO_MODBUS_START_REGISTER &&
+         end <= BMS_SDO_MODBUS_START_REGISTER + BMS_SDO_MODBUS_REGISTERS;
+}
+
+bool readBMSSdoRegister(uint16_t address, uint16_t* value) {
+  if (value == nullptr || !isBMSSdoRegisterRange(address, 1)) return false;
+  uint16_t offset = address - BMS_SDO_MODBUS_START_REGISTER;
+
+  switch (offset) {
+    case BMS_SDO_REG_NODE:     *value = sdoModbusNode; return true;
+    case BMS_SDO_REG_INDEX:    *value = sdoModbusIndex; return true;
+    case BMS_SDO_REG_SUBINDEX: *value = sdoModbusSubIndex; return true;
+    case BMS_SDO_REG_MAX_AGE:  *value = sdoModbusMaxAge; return true;
+    case BMS_SDO_REG_COMMAND:  *value = 0; return true;
+    default: break;
+  }
+
+  BMSSdoEntry_t e;
+  if (!getBMSSdoEntry(sdoModbusNode, sdoModbusIndex, sdoModbusSubIndex, &e)) {
+    memset(&e, 0, sizeof(e));
+  }
+
+  uint32_t number = 0;
+  if (e.everValid && e.length <= 4) {
+    for (int i = e.length - 1; i >= 0; i--) number = (number << 8) | e.data[i];
+  }
+
+  switch (offset) {
+    case BMS_SDO_REG_STATUS:
+      *value = e.status;
+      break;
+    case BMS_SDO_REG_AGE: {
+      unsigned long age = e.everValid ? millis() - e.validAt : 0xFFFF;
+      *value = age > 0xFFFF ? 0xFFFF : (uint16_t)age;
+      break;
+    }
+    case BMS_SDO_REG_LENGTH:   *value = e.everValid ? e.length : 0; break;
+    case BMS_SDO_REG_ABORT_HI: *value = e.abortCode >> 16; break;
+    case BMS_SDO_REG_ABORT_LO: *value = e.abortCode & 0xFFFF; break;
+    case BMS_SDO_REG_VALUE_HI: *value = number >> 16; break;
+    case BMS_SDO_REG_VALUE_LO: *value = number & 0xFFFF; break;
+    default: {
+      uint8_t byteIndex = (offset - BMS_SDO_REG_DATA) * 2;
+      uint8_t hi = (e.everValid && byteIndex < e.length) ? e.data[byteIndex] : 0;
+      uint8_t lo = (e.everValid && byteIndex + 1 < e.length) ? e.data[byteIndex + 1] : 0;
+      *value = (hi << 8) | lo;
+      break;
+    }
+  }
+  return true;
+}
+
+bool writeBMSSdoRegister(uint16_t address, uint16_t value) {
+  if (!isBMSSdoRegisterRange(address, 1)) return false;
+
+  switch (address - BMS_SDO_MODBUS_START_REGISTER) {
+    case BMS_SDO_REG_NODE:
+      if (value == 0 || value > 127) return false;
+      sdoModbusNode = value;
+      return true;
+    case BMS_SDO_REG_INDEX:
+      sdoModbusIndex = value;
+      return true;
+    case BMS_SDO_REG_SUBINDEX:
+      if (value > 0xFF) return false;
+      sdoModbusSubIndex = value;
+      return true;
+    case BMS_SDO_REG_MAX_AGE:
+      sdoModbusMaxAge = value;
+      return true;
+    case BMS_SDO_REG_COMMAND:
+      if (value == BMS_SDO_CMD_READ) {
+        return requestBMSSdoRead(sdoModbusNode, sdoModbusIndex, sdoModbusSubIndex, sdoModbusMaxAge);
+      }
+      if (value == BMS_SDO_CMD_FORCE_READ) {
+        return requestBMSSdoRead(sdoModbusNode, sdoModbusIndex, sdoModbusSubIndex, 0);
+      }
+      return false;
+    default:
+      return false;  // Result registers are read-only
+  }
+}
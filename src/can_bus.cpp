@@ -0,0 +1,613 @@
+// =====================================================================
+// === can_bus.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: CAN Channel Layer Implementation
+//    Version: v1.4.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Two CAN channels, protocol binding, per-channel ingest ring and stats
+//    v1.1.0 - 18.10.2026 - Exact frame bit-times (with stuffing) from the load estimator
+//    v1.2.0 - 18.10.2026 - RX interrupt wake-up for the main loop, burst replay into the ring
+//    v1.3.0 - 18.10.2026 - Transmit on an explicit channel (virtual BMS emitter)
+//    v1.4.0 - 18.10.2026 - TEC/REC sampling and bus-off recovery per channel (MCP2515 EFLG, TWAI status)
+//
+// 🎯 DEPENDENCIES:
+//    Internal: can_bus.h, can_load.h (frame bit-times), bms_protocol.h (canController, active bitrate, MCP2515 re-init)
+//    External: MCP2515 library, driver/twai.h (CAN2_DRIVER_TWAI only)
+//
+// 📝 DESCRIPTION:
+//    All channel state is owned by the main loop (drain, pop, send), so the
+//    rings need no locking. Utilisation counts the exact on-wire length of
+//    every frame received or sent (stuff bits and IFS included, computed by
+//    can_load), over a 1s window. The INT pin ISR only notifies the task that
+//    called initCANBus() (the main loop task); replay requests from other
+//    tasks are picked up by the next drain.
+//
+//    Error sampling keeps one state machine per channel. TWAI status info is
+//    mapped onto MCP2515 EFLG bits so both drivers share it; recovery of the
+//    primary MCP2515 goes through bms_protocol (which owns canController).
+//
+// =====================================================================
+
+#include "can_bus.h"
+#include "can_load.h"
+#include "bms_protocol.h"
+
+#if CAN2_DRIVER == CAN2_DRIVER_TWAI
+#include "driver/twai.h"
+#endif
+
+// === CHANNEL STATE ===
+typedef struct {
+  CANFrame_t ring[CAN_RING_SIZE];
+  uint8_t head;                     // Next write
+  uint8_t tail;                     // Next read
+  CANChannelStats_t stats;
+  unsigned long lastWindowBits;     // Bits of the last complete window
+  volatile uint16_t replayBursts;   // Pending burst replays
+  volatile uint8_t replayFrames;
+  unsigned long lastErrorSample;
+  unsigned long nextRecoveryAttempt;
+  unsigned long episodeRecoveryAttempts;  // Attempts in the current bus-off episode
+  uint32_t lastRxOverruns;          // TWAI rx_overrun_count at the last sample
+} CANChannel_t;
+
+static CANChannel_t canChannels[CAN_CHANNEL_COUNT];
+static uint8_t protocolChannel[CAN_PROTOCOL_COUNT] = {CAN_CHANNEL_PRIMARY, CAN_CHANNEL_PRIMARY};
+static unsigned long windowStart = 0;
+static bool bindingsInitialized = false;
+static TaskHandle_t rxWaitTask = nullptr;
+
+#if CAN2_DRIVER == CAN2_DRIVER_MCP2515
+static MCP_CAN* secondaryController = nullptr;
+#endif
+
+// === PRIVATE HELPERS ===
+
+static void countFrame(CANChannel_t* ch, CANProtocol_t protocol, unsigned long id, bool extended,
+                       uint8_t len, const uint8_t* data) {
+  uint8_t channel = ch - canChannels;
+  ch->stats.windowBits += canLoadAccountFrame(channel, protocol, id, extended, len, data);
+}
+
+static void pushFrame(CANChannel_t* ch, const CANFrame_t* frame) {
+  uint8_t next = (ch->head + 1) & (CAN_RING_SIZE - 1);
+  countFrame(ch, getCANFrameProtocol(ch - canChannels, frame->extended),
+             frame->id, frame->extended, frame->len, frame->data);
+  ch->stats.rxFrames++;
+
+  if (next == ch->tail) {
+    ch->stats.ringOverflows++;
+    return;
+  }
+  ch->ring[ch->head] = *frame;
+  ch->head = next;
+
+  uint8_t depth = (ch->head - ch->tail) & (CAN_RING_SIZE - 1);
+  ch->stats.ringDepth = depth;
+  if (depth > ch->stats.ringPeakDepth) ch->stats.ringPeakDepth = depth;
+}
+
+// Copies of the last frames received, still in ring memory behind head
+static void replayBurst(CANChannel_t* ch) {
+  uint8_t count = ch->replayFrames;
+  if (count > ch->stats.rxFrames) count = ch->stats.rxFrames;
+  CANFrame_t burst[CAN_RING_SIZE - 1];
+  for (uint8_t i = 0; i < count; i++) {
+    burst[i] = ch->ring[(ch->head - count + i) & (CAN_RING_SIZE - 1)];
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t next = (ch->head + 1) & (CAN_RING_SIZE - 1);
+    ch->stats.replayedFrames++;
+    if (next == ch->tail) {
+      ch->stats.ringOverflows++;
+      continue;
+    }
+    ch->ring[ch->head] = burst[i];
+    ch->head = next;
+  }
+  uint8_t depth = (ch->head - ch->tail) & (CAN_RING_SIZE - 1);
+  ch->stats.ringDepth = depth;
+  if (depth > ch->stats.ringPeakDepth) ch->stats.ringPeakDepth = depth;
+  ch->replayBursts--;
+}
+
+static void IRAM_ATTR canRxInterrupt() {
+  BaseType_t woken = pdFALSE;
+  if (rxWaitTask != nullptr) vTaskNotifyGiveFromISR(rxWaitTask, &woken);
+  if (woken == pdTRUE) portYIELD_FROM_ISR();
+}
+
+static MCP_CAN* mcpForChannel(uint8_t channel) {
+  if (channel == CAN_CHANNEL_PRIMARY) return isCANInitialized() ? canController : nullptr;
+#if CAN2_DRIVER == CAN2_DRIVER_MCP2515
+  if (channel == CAN_CHANNEL_SECONDARY && canChannels[channel].stats.initialized) return secondaryController;
+#endif
+  return nullptr;
+}
+
+static uint8_t drainMCP2515(CANChannel_t* ch, MCP_CAN* mcp) {
+  uint8_t drained = 0;
+  CANFrame_t frame;
+
+  // Bounded so a babbling node cannot pin the main loop here
+  while (drained < CAN_RING_SIZE && mcp->checkReceive() == CAN_MSGAVAIL) {
+    if (mcp->readMsgBuf(&frame.len, frame.data) != CAN_OK) {
+      ch->stats.rxReadErrors++;
+      break;
+    }
+    frame.id = mcp->getCanId();
+    frame.extended = mcp->isExtendedFrame();
+    if (frame.len > 8) frame.len = 8;
+    pushFrame(ch, &frame);
+    drained++;
+  }
+  return drained;
+}
+
+#if CAN2_DRIVER == CAN2_DRIVER_TWAI
+static bool initTWAI(uint8_t canSpeed) {
+  twai_general_config_t general = TWAI_GENERAL_CONFIG_DEFAULT((gpio_num_t)CAN2_TWAI_TX_PIN,
+                                                              (gpio_num_t)CAN2_TWAI_RX_PIN,
+                                                              TWAI_MODE_NORMAL);
+  general.rx_queue_len = CAN_RING_SIZE;
+  twai_timing_config_t timing;
+  switch (canSpeed) {
+    case CAN_250KBPS:  timing = TWAI_TIMING_CONFIG_250KBITS(); break;
+    case CAN_500KBPS:  timing = TWAI_TIMING_CONFIG_500KBITS(); break;
+    case CAN_1000KBPS: timing = TWAI_TIMING_CONFIG_1MBITS(); break;
+    default:           timing = TWAI_TIMING_CONFIG_125KBITS(); break;
+  }
+  twai_filter_config_t filter = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+
+  if (twai_driver_install(&general, &timing, &filter) != ESP_OK) return false;
+  if (twai_start() != ESP_OK) {
+    twai_driver_uninstall();
+    return false;
+  }
+  return true;
+}
+
+static uint8_t drainTWAI(CANChannel_t* ch) {
+  uint8_t drained = 0;
+  twai_message_t msg;
+  CANFrame_t frame;
+
+  while (drained < CAN_RING_SIZE && twai_receive(&msg, 0) == ESP_OK) {
+    if (msg.rtr) continue;
+    frame.id = msg.identifier;
+    frame.extended = msg.extd;
+    frame.len = msg.data_length_code > 8 ? 8 : msg.data_length_code;
+    memcpy(frame.data, msg.data, frame.len);
+    pushFrame(ch, &frame);
+    drained++;
+  }
+  return drained;
+}
+#endif
+
+// === CHANNEL FUNCTIONS ===
+
+bool initCANBus() {
+  CANChannel_t* primary = &canChannels[CAN_CHANNEL_PRIMARY];
+  primary->stats.driver = CAN_DRIVER_MCP2515;
+  primary->stats.initialized = isCANInitialized();
+  primary->head = primary->tail = 0;
+
+  CANChannel_t* secondary = &canChannels[CAN_CHANNEL_SECONDARY];
+  if (!secondary->stats.initialized) {
+#if CAN2_DRIVER == CAN2_DRIVER_MCP2515
+    secondary->stats.driver = CAN_DRIVER_MCP2515;
+    if (!secondaryController) secondaryController = new MCP_CAN(CAN2_CS_PIN);
+    pinMode(CAN2_CS_PIN, OUTPUT);
+    digitalWrite(CAN2_CS_PIN, HIGH);
+    secondary->stats.initialized = secondaryController->begin(CAN2_SPEED) == CAN_OK;
+#elif CAN2_DRIVER == CAN2_DRIVER_TWAI
+    secondary->stats.driver = CAN_DRIVER_TWAI;
+    secondary->stats.initialized = initTWAI(CAN2_SPEED);
+#else
+    secondary->stats.driver = CAN_DRIVER_NONE;
+#endif
+    secondary->stats.bitrateKbps = getCANSpeedKbps(CAN2_SPEED);
+  }
+
+  // TRIO HP traffic gets its own bus whenever one is available (once; explicit bindings are kept)
+  if (!bindingsInitialized) {
+    protocolChannel[CAN_PROTOCOL_BMS] = CAN_CHANNEL_PRIMARY;
+    protocolChannel[CAN_PROTOCOL_TRIO] = secondary->stats.initialized ? CAN_CHANNEL_SECONDARY : CAN_CHANNEL_PRIMARY;
+    bindingsInitialized = true;
+  }
+  windowStart = millis();
+  initCANLoad();
+
+  // MCP2515 INT (active low while a receive buffer is full) wakes the idle main loop
+  if (rxWaitTask == nullptr) {
+    rxWaitTask = xTaskGetCurrentTaskHandle();
+    pinMode(CAN_INT_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(CAN_INT_PIN), canRxInterrupt, FALLING);
+  }
+
+  if (secondary->stats.driver != CAN_DRIVER_NONE) {
+    Serial.printf("🚌 CAN channel 1 (%s, %u kbps): %s\n", getCANDriverName(secondary->stats.driver),
+                  secondary->stats.bitrateKbps, secondary->stats.initialized ? "ready" : "FAILED");
+  }
+  Serial.printf("🚌 CAN binding: BMS -> channel %d, TRIO HP -> channel %d\n",
+                protocolChannel[CAN_PROTOCOL_BMS], protocolChannel[CAN_PROTOCOL_TRIO]);
+  return true;
+}
+
+bool isCANChannelAvailable(uint8_t channel) {
+  if (channel == CAN_CHANNEL_PRIMARY) return isCANInitialized();
+  return channel < CAN_CHANNEL_COUNT && canChannels[channel].stats.initialized;
+}
+
+bool bindCANProtocol(CANProtocol_t protocol, uint8_t channel) {
+  if (protocol >= CAN_PROTOCOL_COUNT || !isCANChannelAvailable(channel)) return false;
+  protocolChannel[protocol] = channel;
+  Serial.printf("🚌 CAN binding: %s -> channel %d\n", getCANProtocolName(protocol), channel);
+  return true;
+}
+
+uint8_t getCANProtocolChannel(CANProtocol_t protocol) {
+  return protocol < CAN_PROTOCOL_COUNT ? protocolChannel[protocol] : CAN_CHANNEL_PRIMARY;
+}
+
+CANProtocol_t getCANFrameProtocol(uint8_t channel, bool extended) {
+  bool bmsHere = protocolChannel[CAN_PROTOCOL_BMS] == channel;
+  bool trioHere = protocolChannel[CAN_PROTOCOL_TRIO] == channel;
+  // TRIO HP uses 29-bit identifiers, BMS/CANopen traffic is 11-bit
+  return (trioHere && (extended || !bmsHere)) ? CAN_PROTOCOL_TRIO : CAN_PROTOCOL_BMS;
+}
+
+bool canBusSend(CANProtocol_t protocol, unsigned long id, bool extended, uint8_t len, const uint8_t* data) {
+  return canBusSendChannel(getCANProtocolChannel(protocol), protocol, id, extended, len, data);
+}
+
+bool canBusSendChannel(uint8_t channel, CANProtocol_t protocol, unsigned long id, bool extended,
+                       uint8_t len, const uint8_t* data) {
+  if (channel >= CAN_CHANNEL_COUNT) return false;
+  CANChannel_t* ch = &canChannels[channel];
+  bool sent = false;
+
+  MCP_CAN* mcp = mcpForChannel(channel);
+  if (mcp) {
+    sent = mcp->sendMsgBuf(id, extended ? 1 : 0, len, (uint8_t*)data) == CAN_OK;
+  }
+#if CAN2_DRIVER == CAN2_DRIVER_TWAI
+  else if (channel == CAN_CHANNEL_SECONDARY && ch->stats.initialized) {
+    twai_message_t msg = {};
+    msg.identifier = id;
+    msg.extd = extended;
+    msg.data_length_code = len;
+    memcpy(msg.data, data, len);
+    sent = twai_transmit(&msg, 0) == ESP_OK;
+  }
+#endif
+
+  if (sent) {
+    ch->stats.txFrames++;
+    countFrame(ch, protocol, id, extended, len, data);
+  } else {
+    ch->stats.txErrors++;
+  }
+  return sent;
+}
+
+uint8_t canBusDrain(uint8_t channel) {
+  if (channel >= CAN_CHANNEL_COUNT) return 0;
+  CANChannel_t* ch = &canChannels[channel];
+  if (ch->replayBursts > 0) replayBurst(ch);
+
+  MCP_CAN* mcp = mcpForChannel(channel);
+  if (mcp) return drainMCP2515(ch, mcp);
+#if CAN2_DRIVER == CAN2_DRIVER_TWAI
+  if (channel == CAN_CHANNEL_SECONDARY && ch->stats.initialized) return drainTWAI(ch);
+#endif
+  return 0;
+}
+
+uint8_t canBusBacklog(uint8_t channel) {
+  if (channel >= CAN_CHANNEL_COUNT) return 0;
+  const CANChannel_t* ch = &canChannels[channel];
+  return (ch->head - ch->tail) & (CAN_RING_SIZE - 1);
+}
+
+bool canBusWaitForFrame(uint32_t timeoutMs) {
+  if (rxWaitTask == nullptr) {
+    delay(timeoutMs);
+    return false;
+  }
+  TickType_t ticks = pdMS_TO_TICKS(timeoutMs);
+  return ulTaskNotifyTake(pdTRUE, ticks > 0 ? ticks : 1) > 0;
+}
+
+bool requestCANBurstReplay(uint8_t channel, uint8_t frames, uint16_t bursts) {
+  if (channel >= CAN_CHANNEL_COUNT || !isCANChannelAvailable(channel)) return false;
+  if (frames == 0 || frames >= CAN_RING_SIZE) return false;
+  CANChannel_t* ch = &canChannels[channel];
+  ch->replayFrames = frames;
+  ch->replayBursts = bursts;
+  Serial.printf("🚌 CAN%d: replaying %u x %u-frame bursts\n", channel, bursts, frames);
+  return true;
+}
+
+bool canBusPop(uint8_t channel, CANFrame_t* frame) {
+  if (channel >= CAN_CHANNEL_COUNT || frame == nullptr) return false;
+  CANChannel_t* ch = &canChannels[channel];
+  if (ch->tail == ch->head) return false;
+
+  *frame = ch->ring[ch->tail];
+  ch->tail = (ch->tail + 1) & (CAN_RING_SIZE - 1);
+  ch->stats.ringDepth = (ch->head - ch->tail) & (CAN_RING_SIZE - 1);
+  return true;
+}
+
+// === ERROR MONITORING ===
+
+// Current EFLG/TEC/REC of a channel; false while the controller is not available
+static bool readChannelErrors(uint8_t channel, uint8_t* eflg, uint8_t* tec, uint8_t* rec) {
+  MCP_CAN* mcp = mcpForChannel(channel);
+  if (mcp) {
+    *eflg = mcp->getError();
+    *tec = mcp->errorCountTX();
+    *rec = mcp->errorCountRX();
+    return true;
+  }
+#if CAN2_DRIVER == CAN2_DRIVER_TWAI
+  if (channel == CAN_CHANNEL_SECONDARY && canChannels[channel].stats.initialized) {
+    twai_status_info_t info;
+    if (twai_get_status_info(&info) != ESP_OK) return false;
+    CANChannel_t* ch = &canChannels[channel];
+    *tec = info.tx_error_counter > 255 ? 255 : info.tx_error_counter;
+    *rec = info.rx_error_counter > 255 ? 255 : info.rx_error_counter;
+    *eflg = 0;
+    // Stopped after a completed recovery counts as bus-off until twai_start()
+    if (info.state != TWAI_STATE_RUNNING) *eflg |= CAN_EFLG_TXBO;
+    if (*tec >= 128) *eflg |= CAN_EFLG_TXEP;
+    if (*rec >= 128) *eflg |= CAN_EFLG_RXEP;
+    if (*tec >= 96 || *rec >= 96) *eflg |= CAN_EFLG_EWARN;
+    if (info.rx_overrun_count != ch->lastRxOverruns) *eflg |= CAN_EFLG_RX0OVR;
+    ch->lastRxOverruns = info.rx_overrun_count;
+    return true;
+  }
+#endif
+  return false;
+}
+
+// One recovery step: MCP2515 re-initialization, TWAI recovery start or restart
+static bool recoverChannel(uint8_t channel) {
+  if (channel == CAN_CHANNEL_PRIMARY) {
+    canChannels[channel].stats.initialized = recoverCANController();
+    return canChannels[channel].stats.initialized;
+  }
+#if CAN2_DRIVER == CAN2_DRIVER_MCP2515
+  CANChannelStats_t* stats = &canChannels[channel].stats;
+  stats->initialized = secondaryController != nullptr && secondaryController->begin(CAN2_SPEED) == CAN_OK;
+  return stats->initialized;
+#elif CAN2_DRIVER == CAN2_DRIVER_TWAI
+  twai_status_info_t info;
+  if (twai_get_status_info(&info) != ESP_OK) return false;
+  if (info.state == TWAI_STATE_BUS_OFF) return twai_initiate_recovery() == ESP_OK;  // 128 x 11 recessive bits
+  if (info.state == TWAI_STATE_STOPPED) return twai_start() == ESP_OK;
+  return true;  // Recovering or already running
+#else
+  return false;
+#endif
+}
+
+// Recovery attempts with a doubling interval while the channel is bus-off
+static void attemptBusOffRecovery(uint8_t channel, unsigned long now) {
+  CANChannel_t* ch = &canChannels[channel];
+  CANErrorStats_t* err = &ch->stats.errors;
+  if (!err->recoveryActive || (long)(now - ch->nextRecoveryAttempt) < 0) return;
+
+  err->recoveryAttempts++;
+  if (++ch->episodeRecoveryAttempts > 1) {
+    err->currentBackoffMs = min(err->currentBackoffMs * 2, (unsigned long)CAN_BUSOFF_BACKOFF_MAX_MS);
+  }
+  bool ok = recoverChannel(channel);
+  if (!ok) err->failedRecoveries++;
+
+  Serial.printf("🚌 CAN%d bus-off recovery attempt %lu (%s): %s (next in %lu ms)\n", channel,
+                ch->episodeRecoveryAttempts, getCANDriverName(ch->stats.driver), ok ? "started" : "FAILED",
+                err->currentBackoffMs);
+
+  ch->nextRecoveryAttempt = now + err->currentBackoffMs;
+}
+
+/**
+ * TEC grows by 8 per transmit error and REC by 1 per receive error, so the
+ * counter increments give an approximate error frame count (successful
+ * frames decrement the counters, so under load this is a lower bound).
+ */
+void updateCANErrorCounters(uint8_t channel, uint8_t eflg, uint8_t tec, uint8_t rec, unsigned long now) {
+  if (channel >= CAN_CHANNEL_COUNT) return;
+  CANChannel_t* ch = &canChannels[channel];
+  CANErrorStats_t* err = &ch->stats.errors;
+
+  uint8_t state;
+  if (eflg & CAN_EFLG_TXBO) {
+    state = CAN_ERROR_STATE_BUS_OFF;
+  } else if (eflg & (CAN_EFLG_TXEP | CAN_EFLG_RXEP)) {
+    state = CAN_ERROR_STATE_PASSIVE;
+  } else if (eflg & CAN_EFLG_EWARN) {
+    state = CAN_ERROR_STATE_WARNING;
+  } else {
+    state = CAN_ERROR_STATE_ACTIVE;
+  }
+
+  // Error frame estimate from counter increments (not meaningful across bus-off/re-init)
+  if (err->samples > 0 && state != CAN_ERROR_STATE_BUS_OFF && err->state != CAN_ERROR_STATE_BUS_OFF) {
+    unsigned long errors = 0;
+    if (tec > err->tec) errors += (tec - err->tec + 7) / 8;
+    if (rec > err->rec) errors += rec - err->rec;
+    err->errorFrameEstimate += errors;
+
+    unsigned long dt = now - ch->lastErrorSample;
+    if (dt > 0) {
+      float rate = errors * 1000.0f / dt;
+      err->errorFrameRate += CAN_ERROR_RATE_ALPHA * (rate - err->errorFrameRate);
+    }
+  }
+
+  bool overflow = eflg & (CAN_EFLG_RX0OVR | CAN_EFLG_RX1OVR);
+  bool wasOverflow = err->eflg & (CAN_EFLG_RX0OVR | CAN_EFLG_RX1OVR);
+  if (overflow && !wasOverflow) err->rxOverflowCount++;
+
+  // State transitions
+  if (state != err->state) {
+    if (state == CAN_ERROR_STATE_WARNING) err->warningCount++;
+    if (state == CAN_ERROR_STATE_PASSIVE) err->errorPassiveCount++;
+
+    if (state == CAN_ERROR_STATE_BUS_OFF) {
+      err->busOffCount++;
+      err->lastBusOffTime = now;
+      if (!err->recoveryActive) {
+        err->recoveryActive = true;
+        ch->episodeRecoveryAttempts = 0;
+        err->currentBackoffMs = CAN_BUSOFF_BACKOFF_MIN_MS;
+        ch->nextRecoveryAttempt = now + CAN_BUSOFF_BACKOFF_MIN_MS;
+      }
+    } else if (err->recoveryActive && state <= CAN_ERROR_STATE_WARNING) {
+      err->recoveryActive = false;
+      err->recoveries++;
+      err->lastRecoveryMs = now - err->lastBusOffTime;
+      if (err->lastRecoveryMs > err->maxRecoveryMs) err->maxRecoveryMs = err->lastRecoveryMs;
+      Serial.printf("✅ CAN%d recovered from bus-off in %lu ms (%lu attempts)\n",
+                    channel, err->lastRecoveryMs, ch->episodeRecoveryAttempts);
+    }
+
+    Serial.printf("🚌 CAN%d error state: %s -> %s (TEC=%u REC=%u)\n", channel,
+                  getCANErrorStateName(err->state), getCANErrorStateName(state), tec, rec);
+  }
+
+  err->state = state;
+  err->eflg = eflg;
+  err->tec = tec;
+  err->rec = rec;
+  if (tec > err->peakTec) err->peakTec = tec;
+  if (rec > err->peakRec) err->peakRec = rec;
+  err->samples++;
+  ch->lastErrorSample = now;
+
+  if (state == CAN_ERROR_STATE_BUS_OFF) {
+    attemptBusOffRecovery(channel, now);
+  }
+}
+
+void sampleCANErrorCounters() {
+  unsigned long now = millis();
+  for (uint8_t channel = 0; channel < CAN_CHANNEL_COUNT; channel++) {
+    CANChannel_t* ch = &canChannels[channel];
+    if (ch->stats.driver == CAN_DRIVER_NONE) continue;
+    if (now - ch->lastErrorSample < CAN_ERROR_SAMPLE_INTERVAL_MS) continue;
+
+    uint8_t eflg, tec, rec;
+    if (readChannelErrors(channel, &eflg, &tec, &rec)) {
+      updateCANErrorCounters(channel, eflg, tec, rec, now);
+    } else {
+      // Controller not responding after a failed recovery: keep retrying on the backoff schedule
+      ch->lastErrorSample = now;
+      attemptBusOffRecovery(channel, now);
+    }
+  }
+}
+
+const CANErrorStats_t* getCANErrorStats(uint8_t channel) {
+  if (channel >= CAN_CHANNEL_COUNT) return nullptr;
+  return &canChannels[channel].stats.errors;
+}
+
+const char* getCANErrorStateName(uint8_t state) {
+  switch (state) {
+    case CAN_ERROR_STATE_ACTIVE:  return "ERROR_ACTIVE";
+    case CAN_ERROR_STATE_WARNING: return "WARNING";
+    case CAN_ERROR_STATE_PASSIVE: return "ERROR_PASSIVE";
+    case CAN_ERROR_STATE_BUS_OFF: return "BUS_OFF";
+    default:                      return "UNKNOWN";
+  }
+}
+
+// === STATISTICS ===
+
+void updateCANBusUtilisation() {
+  unsigned long now = millis();
+  unsigned long elapsed = now - windowStart;
+  if (elapsed < CAN_UTILISATION_WINDOW_MS) return;
+
+  canChannels[CAN_CHANNEL_PRIMARY].stats.initialized = isCANInitialized();
+  canChannels[CAN_CHANNEL_PRIMARY].stats.bitrateKbps = getCANSpeedKbps(getBMSReconfigStats()->activeCanSpeed);
+
+  for (int i = 0; i < CAN_CHANNEL_COUNT; i++) {
+    CANChannelStats_t* stats = &canChannels[i].stats;
+    if (stats->bitrateKbps > 0) {
+      // bits / (kbit/s * ms) = fraction
+      stats->utilisation = stats->windowBits * 100.0f / ((float)stats->bitrateKbps * elapsed);
+      if (stats->utilisation > stats->peakUtilisation) stats->peakUtilisation = stats->utilisation;
+    }
+    canChannels[i].lastWindowBits = stats->windowBits;
+    stats->windowBits = 0;
+  }
+  windowStart = now;
+}
+
+const CANChannelStats_t* getCANChannelStats(uint8_t channel) {
+  if (channel >= CAN_CHANNEL_COUNT) return nullptr;
+  return &canChannels[channel].stats;
+}
+
+float getCANCombinedUtilisation() {
+  uint16_t kbps = canChannels[CAN_CHANNEL_PRIMARY].stats.bitrateKbps;
+  if (kbps == 0) return 0.0f;
+  unsigned long bits = canChannels[CAN_CHANNEL_PRIMARY].lastWindowBits +
+                       canChannels[CAN_CHANNEL_SECONDARY].lastWindowBits;
+  return bits * 100.0f / ((float)kbps * CAN_UTILISATION_WINDOW_MS);
+}
+
+const char* getCANDriverName(uint8_t driver) {
+  switch (driver) {
+    case CAN_DRIVER_MCP2515: return "MCP2515";
+    case CAN_DRIVER_TWAI:    return "TWAI";
+    default:                 return "none";
+  }
+}
+
+const char* getCANProtocolName(uint8_t protocol) {
+  switch (protocol) {
+    case CAN_PROTOCOL_BMS:  return "BMS";
+    case CAN_PROTOCOL_TRIO: return "TRIO HP";
+    default:                return "UNKNOWN";
+  }
+}
+
+void printCANBusStatus() {
+  Serial.println("=== CAN CHANNELS ===");
+  for (int i = 0; i < CAN_CHANNEL_COUNT; i++) {
+    const CANChannelStats_t* s = &canChannels[i].stats;
+    if (s->driver == CAN_DRIVER_NONE) continue;
+    Serial.printf("Channel %d: %s %u kbps %s, load %.1f%% (peak %.1f%%)\n", i, getCANDriverName(s->driver),
+                  s->bitrateKbps, s->initialized ? "up" : "DOWN", s->utilisation, s->peakUtilisation);
+    Serial.printf("  RX %lu, TX %lu, read errors %lu, TX errors %lu, ring %u (peak %u), overflows %lu\n",
+                  s->rxFrames, s->txFrames, s->rxReadErrors, s->txErrors,
+                  s->ringDepth, s->ringPeakDepth, s->ringOverflows);
+    if (s->replayedFrames > 0) Serial.printf("  Replayed: %lu frames\n", s->replayedFrames);
+    Serial.printf("  Errors: %s TEC %u REC %u (peak %u/%u), est. %lu frames, bus-off %lu (recovered %lu, attempts %lu)\n",
+                  getCANErrorStateName(s->errors.state), s->errors.tec, s->errors.rec, s->errors.peakTec,
+                  s->errors.peakRec, s->errors.errorFrameEstimate, s->errors.busOffCount,
+                  s->errors.recoveries, s->errors.recoveryAttempts);
+  }
+  Serial.printf("BMS -> channel %d, TRIO HP -> channel %d; single-bus equivalent load %.1f%%\n",
+                protocolChannel[CAN_PROTOCOL_BMS], protocolChannel[CAN_PROTOCOL_TRIO],
+                getCANCombinedUtilisation());
+}
@@ -0,0 +1,438 @@
+// =====================================================================
+// === can_load.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: CAN Bus Load Estimator Implementation
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Exact frame bit-times, per-ID/node/protocol windows, alerts, poll budget
+//
+// 🎯 DEPENDENCIES:
+//    Internal: can_load.h, can_bus.h, trio_hp_protocol.h
+//    External: Arduino.h for millis() and Serial functions
+//
+// 📝 DESCRIPTION:
+//    Each counter is a ring of CAN_LOAD_WINDOW_BUCKETS + 1 buckets: the
+//    current (open) bucket plus the complete ones forming the window.
+//    Everything runs in the main loop (can_bus drain/send, updateCANLoad),
+//    so no locking; readers in other tasks may see a bucket mid-update.
+//
+//    Nodes: BMS/CANopen 11-bit IDs carry the node in the low 7 bits, TRIO
+//    HP 29-bit IDs carry the module address as source (responses) or
+//    target (commands from the controller).
+//
+// =====================================================================
+
+#include "can_load.h"
+#include "trio_hp_protocol.h"
+
+#define CAN_LOAD_SLOTS (CAN_LOAD_WINDOW_BUCKETS + 1)
+
+// === TRACKING STRUCTURES ===
+typedef struct {
+  bool used;
+  unsigned long id;
+  bool extended;
+  uint8_t channel;
+  uint8_t protocol;
+  uint8_t node;
+  unsigned long frames;
+  uint16_t lastFrameBits;
+  uint32_t bits[CAN_LOAD_SLOTS];
+} CANLoadIdEntry_t;
+
+typedef struct {
+  bool used;
+  uint8_t protocol;
+  uint8_t node;
+  uint8_t channel;
+  unsigned long frames;
+  uint32_t bits[CAN_LOAD_SLOTS];
+} CANLoadNodeEntry_t;
+
+typedef struct {
+  uint16_t crc;
+  uint8_t last;                     // Last transmitted level, 2 = none yet
+  uint8_t run;
+  uint8_t stuff;
+} CANBitStream_t;
+
+// === GLOBAL VARIABLES ===
+static CANLoadChannelStats_t channelLoad[CAN_CHANNEL_COUNT];
+static CANLoadProtocolStats_t protocolLoad[CAN_PROTOCOL_COUNT];
+static uint32_t channelBits[CAN_CHANNEL_COUNT][CAN_LOAD_SLOTS];
+static uint32_t protocolBits[CAN_PROTOCOL_COUNT][CAN_LOAD_SLOTS];
+static CANLoadIdEntry_t idTable[CAN_LOAD_MAX_IDS];
+static CANLoadNodeEntry_t nodeTable[CAN_LOAD_MAX_NODES];
+static unsigned long untrackedFrames = 0;
+
+static uint8_t currentBucket = 0;
+static uint8_t bucketsFilled = 0;   // Complete buckets in the window
+static unsigned long bucketStart = 0;
+static bool loadInitialized = false;
+
+// === BIT-LEVEL FRAME LENGTH ===
+
+// MSB first; CRC-15 over SOF..data, stuffing over SOF..CRC
+static void streamBits(CANBitStream_t* s, uint32_t value, uint8_t count, bool crc) {
+  for (int8_t i = count - 1; i >= 0; i--) {
+    uint8_t bit = (value >> i) & 1;
+
+    if (crc) {
+      uint8_t next = bit ^ ((s->crc >> 14) & 1);
+      s->crc = (s->crc << 1) & 0x7FFF;
+      if (next) s->crc ^= 0x4599;
+    }
+
+    if (bit == s->last) {
+      if (++s->run == 5) {
+        // Complementary stuff bit starts the next run
+        s->stuff++;
+        s->last = !bit;
+        s->run = 1;
+      }
+    } else {
+      s->last = bit;
+      s->run = 1;
+    }
+  }
+}
+
+uint16_t canFrameBitsExact(unsigned long id, bool extended, uint8_t len, const uint8_t* data,
+                           uint8_t* stuffBitsOut) {
+  if (len > 8) len = 8;
+  CANBitStream_t s = {0, 2, 0, 0};
+
+  streamBits(&s, 0, 1, true);                             // SOF
+  if (extended) {
+    streamBits(&s, (id >> 18) & 0x7FF, 11, true);         // Base ID
+    streamBits(&s, 0x3, 2, true);                         // SRR, IDE (recessive)
+    streamBits(&s, id & 0x3FFFF, 18, true);               // ID extension
+    streamBits(&s, 0, 3, true);                           // RTR, r1, r0
+  } else {
+    streamBits(&s, id & 0x7FF, 11, true);
+    streamBits(&s, 0, 3, true);                           // RTR, IDE, r0
+  }
+  streamBits(&s, len, 4, true);                           // DLC
+  for (uint8_t i = 0; i < len; i++) {
+    streamBits(&s, data ? data[i] : 0, 8, true);
+  }
+  uint16_t crc = s.crc;
+  streamBits(&s, crc, 15, false);
+
+  if (stuffBitsOut) *stuffBitsOut = s.stuff;
+  // + CRC delimiter, ACK slot + delimiter, EOF (7), IFS (3)
+  return (extended ? 67 : 47) + 8 * len + s.stuff;
+}
+
+uint16_t canFrameBitsWorstCase(bool extended, uint8_t len) {
+  if (len > 8) len = 8;
+  uint16_t stuffable = (extended ? 54 : 34) + 8 * len;  // SOF..CRC
+  return (extended ? 67 : 47) + 8 * len + (stuffable - 1) / 4;
+}
+
+// === PRIVATE HELPERS ===
+
+static uint8_t previousBucket() {
+  return (currentBucket + CAN_LOAD_SLOTS - 1) % CAN_LOAD_SLOTS;
+}
+
+static uint32_t lastBucketBits(const uint32_t* bits) {
+  return bucketsFilled > 0 ? bits[previousBucket()] : 0;
+}
+
+static uint32_t windowBits(const uint32_t* bits) {
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < CAN_LOAD_SLOTS; i++) {
+    if (i != currentBucket) sum += bits[i];
+  }
+  return sum;
+}
+
+static bool bucketsIdle(const uint32_t* bits) {
+  for (uint8_t i = 0; i < CAN_LOAD_SLOTS; i++) {
+    if (bits[i]) return false;
+  }
+  return true;
+}
+
+static uint16_t channelKbps(uint8_t channel) {
+  const CANChannelStats_t* stats = getCANChannelStats(channel);
+  return stats ? stats->bitrateKbps : 0;
+}
+
+// bits / (kbit/s * ms) = fraction
+static float toPercent(uint32_t bits, uint8_t channel, uint8_t buckets) {
+  uint16_t kbps = channelKbps(channel);
+  if (kbps == 0 || buckets == 0) return 0.0f;
+  return bits * 100.0f / ((float)kbps * CAN_LOAD_BUCKET_MS * buckets);
+}
+
+static uint8_t deriveNode(CANProtocol_t protocol, unsigned long id, bool extended) {
+  if (protocol == CAN_PROTOCOL_TRIO && extended) {
+    uint8_t source = (id >> TRIO_HP_SOURCE_ADDR_SHIFT) & TRIO_HP_SOURCE_ADDR_MASK;
+    uint8_t target = (id >> TRIO_HP_TARGET_ADDR_SHIFT) & TRIO_HP_TARGET_ADDR_MASK;
+    return source == TRIO_HP_ADDR_CONTROLLER ? target : source;
+  }
+  if (protocol == CAN_PROTOCOL_BMS && !extended) {
+    uint8_t node = id & 0x7F;  // CANopen COB-ID = function code + node
+    return node ? node : CAN_LOAD_NODE_NONE;
+  }
+  return CAN_LOAD_NODE_NONE;
+}
+
+static CANLoadIdEntry_t* findIdEntry(uint8_t channel, unsigned long id, bool extended) {
+  CANLoadIdEntry_t* reusable = nullptr;
+  for (uint8_t i = 0; i < CAN_LOAD_MAX_IDS; i++) {
+    CANLoadIdEntry_t* e = &idTable[i];
+    if (e->used && e->id == id && e->extended == extended && e->channel == channel) return e;
+    if (!reusable && (!e->used || bucketsIdle(e->bits))) reusable = e;
+  }
+  if (reusable) memset(reusable, 0, sizeof(CANLoadIdEntry_t));
+  return reusable;
+}
+
+static CANLoadNodeEntry_t* findNodeEntry(uint8_t protocol, uint8_t node) {
+  CANLoadNodeEntry_t* reusable = nullptr;
+  for (uint8_t i = 0; i < CAN_LOAD_MAX_NODES; i++) {
+    CANLoadNodeEntry_t* e = &nodeTable[i];
+    if (e->used && e->protocol == protocol && e->node == node) return e;
+    if (!reusable && (!e->used || bucketsIdle(e->bits))) reusable = e;
+  }
+  if (reusable) memset(reusable, 0, sizeof(CANLoadNodeEntry_t));
+  return reusable;
+}
+
+static const CANLoadIdEntry_t* topTalker(uint8_t channel) {
+  const CANLoadIdEntry_t* top = nullptr;
+  for (uint8_t i = 0; i < CAN_LOAD_MAX_IDS; i++) {
+    const CANLoadIdEntry_t* e = &idTable[i];
+    if (!e->used || e->channel != channel) continue;
+    if (!top || lastBucketBits(e->bits) > lastBucketBits(top->bits)) top = e;
+  }
+  return top;
+}
+
+static void evaluateAlert(uint8_t channel) {
+  CANLoadChannelStats_t* stats = &channelLoad[channel];
+
+  if (!stats->alertActive && stats->loadNow > CAN_LOAD_ALERT_PERCENT) {
+    stats->alertActive = true;
+    stats->alerts++;
+    stats->lastAlertAt = millis();
+    const CANLoadIdEntry_t* top = topTalker(channel);
+    Serial.printf("⚠️ CAN channel %d load %.1f%% above %.0f%% (top ID 0x%lX: %.1f%%)\n",
+                  channel, stats->loadNow, CAN_LOAD_ALERT_PERCENT,
+                  top ? top->id : 0UL, top ? toPercent(lastBucketBits(top->bits), channel, 1) : 0.0f);
+  } else if (stats->alertActive && stats->loadNow < CAN_LOAD_ALERT_CLEAR_PERCENT) {
+    stats->alertActive = false;
+    Serial.printf("✅ CAN channel %d load back to %.1f%%\n", channel, stats->loadNow);
+  }
+}
+
+// Close the current bucket: refresh percentages, open (and clear) the next one
+static void closeBucket() {
+  if (bucketsFilled < CAN_LOAD_WINDOW_BUCKETS) bucketsFilled++;
+  currentBucket = (currentBucket + 1) % CAN_LOAD_SLOTS;
+
+  for (uint8_t c = 0; c < CAN_CHANNEL_COUNT; c++) {
+    channelBits[c][currentBucket] = 0;
+  }
+  for (uint8_t p = 0; p < CAN_PROTOCOL_COUNT; p++) {
+    protocolBits[p][currentBucket] = 0;
+  }
+  for (uint8_t i = 0; i < CAN_LOAD_MAX_IDS; i++) {
+    idTable[i].bits[currentBucket] = 0;
+  }
+  for (uint8_t i = 0; i < CAN_LOAD_MAX_NODES; i++) {
+    nodeTable[i].bits[currentBucket] = 0;
+  }
+
+  for (uint8_t c = 0; c < CAN_CHANNEL_COUNT; c++) {
+    CANLoadChannelStats_t* stats = &channelLoad[c];
+    stats->loadNow = toPercent(lastBucketBits(channelBits[c]), c, 1);
+    stats->loadWindow = toPercent(windowBits(channelBits[c]), c, bucketsFilled);
+    if (stats->loadNow > stats->peakLoad) stats->peakLoad = stats->loadNow;
+    evaluateAlert(c);
+  }
+  for (uint8_t p = 0; p < CAN_PROTOCOL_COUNT; p++) {
+    uint8_t channel = getCANProtocolChannel((CANProtocol_t)p);
+    protocolLoad[p].loadNow = toPercent(lastBucketBits(protocolBits[p]), channel, 1);
+    protocolLoad[p].loadWindow = toPercent(windowBits(protocolBits[p]), channel, bucketsFilled);
+  }
+}
+
+// === ESTIMATOR FUNCTIONS ===
+
+void initCANLoad() {
+  if (loadInitialized) return;  // Survives BMS protocol restarts
+  bucketStart = millis();
+  loadInitialized = true;
+  Serial.printf("📶 CAN load estimator: %d x %dms window, alert > %.0f%%, poll budget %.0f%%\n",
+                CAN_LOAD_WINDOW_BUCKETS, CAN_LOAD_BUCKET_MS, CAN_LOAD_ALERT_PERCENT, CAN_LOAD_BUDGET_PERCENT);
+}
+
+uint16_t canLoadAccountFrame(uint8_t channel, CANProtocol_t protocol, unsigned long id,
+                             bool extended, uint8_t len, const uint8_t* data) {
+  uint8_t stuff = 0;
+  uint16_t bits = canFrameBitsExact(id, extended, len, data, &stuff);
+  if (channel >= CAN_CHANNEL_COUNT || protocol >= CAN_PROTOCOL_COUNT) return bits;
+
+  CANLoadChannelStats_t* stats = &channelLoad[channel];
+  stats->frames++;
+  stats->bits += bits;
+  stats->stuffBits += stuff;
+  channelBits[channel][currentBucket] += bits;
+
+  protocolLoad[protocol].frames++;
+  protocolLoad[protocol].bits += bits;
+  protocolBits[protocol][currentBucket] += bits;
+
+  CANLoadIdEntry_t* entry = findIdEntry(channel, id, extended);
+  if (entry) {
+    if (!entry->used) {
+      entry->used = true;
+      entry->id = id;
+      entry->extended = extended;
+      entry->channel = channel;
+      entry->protocol = protocol;
+      entry->node = deriveNode(protocol, id, extended);
+    }
+    entry->frames++;
+    entry->lastFrameBits = bits;
+    entry->bits[currentBucket] += bits;
+  } else {
+    untrackedFrames++;
+  }
+
+  uint8_t node = entry ? entry->node : deriveNode(protocol, id, extended);
+  if (node != CAN_LOAD_NODE_NONE) {
+    CANLoadNodeEntry_t* nodeEntry = findNodeEntry(protocol, node);
+    if (nodeEntry) {
+      if (!nodeEntry->used) {
+        nodeEntry->used = true;
+        nodeEntry->protocol = protocol;
+        nodeEntry->node = node;
+      }
+      nodeEntry->channel = channel;
+      nodeEntry->frames++;
+      nodeEntry->bits[currentBucket] += bits;
+    }
+  }
+  return bits;
+}
+
+void updateCANLoad() {
+  unsigned long now = millis();
+  uint8_t closed = 0;
+
+  // Catch up after a stall, at most one full window of empty buckets
+  while (now - bucketStart >= CAN_LOAD_BUCKET_MS && closed < CAN_LOAD_SLOTS) {
+    closeBucket();
+    bucketStart += CAN_LOAD_BUCKET_MS;
+    closed++;
+  }
+  if (now - bucketStart >= CAN_LOAD_BUCKET_MS) bucketStart = now;
+}
+
+bool canLoadAdmit(CANProtocol_t protocol, uint32_t bits) {
+  if (protocol >= CAN_PROTOCOL_COUNT) return false;
+  uint8_t channel = getCANProtocolChannel(protocol);
+  uint16_t kbps = channelKbps(channel);
+  if (kbps == 0) return true;  // No bitrate, nothing to budget against
+
+  // kbit/s * ms = bits per bucket
+  uint32_t budget = (uint32_t)(kbps * (float)CAN_LOAD_BUCKET_MS * CAN_LOAD_BUDGET_PERCENT / 100.0f);
+  uint32_t used = max(lastBucketBits(channelBits[channel]), channelBits[channel][currentBucket]);
+
+  if (used + bits > budget) {
+    protocolLoad[protocol].deferred++;
+    return false;
+  }
+  protocolLoad[protocol].admitted++;
+  return true;
+}
+
+float getCANLoadHeadroom(CANProtocol_t protocol) {
+  if (protocol >= CAN_PROTOCOL_COUNT) return 0.0f;
+  float headroom = CAN_LOAD_BUDGET_PERCENT - channelLoad[getCANProtocolChannel(protocol)].loadNow;
+  return headroom > 0.0f ? headroom : 0.0f;
+}
+
+// === STATISTICS ===
+
+const CANLoadChannelStats_t* getCANLoadChannelStats(uint8_t channel) {
+  if (channel >= CAN_CHANNEL_COUNT) return nullptr;
+  return &channelLoad[channel];
+}
+
+const CANLoadProtocolStats_t* getCANLoadProtocolStats(uint8_t protocol) {
+  if (protocol >= CAN_PROTOCOL_COUNT) return nullptr;
+  return &protocolLoad[protocol];
+}
+
+bool getCANLoadIdStats(uint8_t slot, CANLoadIdStats_t* out) {
+  if (slot >= CAN_LOAD_MAX_IDS || out == nullptr || !idTable[slot].used) return false;
+  const CANLoadIdEntry_t* e = &idTable[slot];
+  out->id = e->id;
+  out->extended = e->extended;
+  out->channel = e->channel;
+  out->protocol = e->protocol;
+  out->node = e->node;
+  out->frames = e->frames;
+  out->lastFrameBits = e->lastFrameBits;
+  out->loadNow = toPercent(lastBucketBits(e->bits), e->channel, 1);
+  out->loadWindow = toPercent(windowBits(e->bits), e->channel, bucketsFilled);
+  return true;
+}
+
+bool getCANLoadNodeStats(uint8_t slot, CANLoadNodeStats_t* out) {
+  if (slot >= CAN_LOAD_MAX_NODES || out == nullptr || !nodeTable[slot].used) return false;
+  const CANLoadNodeEntry_t* e = &nodeTable[slot];
+  out->protocol = e->protocol;
+  out->node = e->node;
+  out->channel = e->channel;
+  out->frames = e->frames;
+  out->loadNow = toPercent(lastBucketBits(e->bits), e->channel, 1);
+  out->loadWindow = toPercent(windowBits(e->bits), e->channel, bucketsFilled);
+  return true;
+}
+
+unsigned long getCANLoadUntrackedFrames() {
+  return untrackedFrames;
+}
+
+void printCANLoadStatus() {
+  Serial.println("=== CAN LOAD ===");
+  for (uint8_t c = 0; c < CAN_CHANNEL_COUNT; c++) {
+    const CANLoadChannelStats_t* s = &channelLoad[c];
+    if (s->frames == 0) continue;
+    Serial.printf("Channel %d: %.1f%% now, %.1f%% over %ds (peak %.1f%%), stuff bits %.1f/frame, alerts %lu%s\n",
+                  c, s->loadNow, s->loadWindow, bucketsFilled * CAN_LOAD_BUCKET_MS / 1000, s->peakLoad,
+                  (float)s->stuffBits / s->frames, s->alerts, s->alertActive ? " (ACTIVE)" : "");
+  }
+  for (uint8_t p = 0; p < CAN_PROTOCOL_COUNT; p++) {
+    const CANLoadProtocolStats_t* s = &protocolLoad[p];
+    Serial.printf("%s: %.1f%% now, %.1f%% window; poll bursts admitted %lu, deferred %lu\n",
+                  getCANProtocolName(p), s->loadNow, s->loadWindow, s->admitted, s->deferred);
+  }
+  for (uint8_t i = 0; i < CAN_LOAD_MAX_IDS; i++) {
+    CANLoadIdStats_t s;
+    if (!getCANLoadIdStats(i, &s)) continue;
+    Serial.printf("  CAN%d 0x%0*lX %s node %d: %lu frames, %u bits/frame, %.2f%% now, %.2f%% window\n",
+                  s.channel, s.extended ? 8 : 3, s.id, getCANProtocolName(s.protocol),
+                  s.node == CAN_LOAD_NODE_NONE ? -1 : s.node, s.frames, s.lastFrameBits, s.loadNow, s.loadWindow);
+  }
+  if (untrackedFrames > 0) Serial.printf("Untracked frames (ID table full): %lu\n", untrackedFrames);
+}
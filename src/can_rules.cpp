@@ -0,0 +1,704 @@
+// =====================================================================
+// === can_rules.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Runtime CAN-to-Register Mapping Rules Implementation
+//    Version: v1.0.1
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.1 - 18.10.2026 - Fields of a frame stored under the Modbus register table lock
+//    v1.0.0 - 18.10.2026 - JSON rules on LittleFS compiled into a hashed dispatch table
+//
+// 🎯 DEPENDENCIES:
+//    Internal: can_rules.h, bms_data.h, log_sink.h
+//    External: Arduino.h, LittleFS.h
+//
+// 📝 DESCRIPTION:
+//    The rule file is read by a small parser that knows only the rule
+//    format (objects of scalar values in a "rules" array), so no JSON
+//    library is linked for it. Compiling sorts the rules by (mask, ID) so
+//    every CAN ID owns one contiguous run of ops, and inserts one bucket
+//    per run into a linear-probing hash table. At run time the 8 data
+//    bytes are loaded once as a little endian and a big endian 64-bit word;
+//    each op is then a shift, an AND, an optional sign extension and an
+//    optional multiply-add.
+//
+// =====================================================================
+
+#include "can_rules.h"
+#include "bms_data.h"
+#include "modbus_tcp.h"
+#include "log_sink.h"
+#include <LittleFS.h>
+#include <stdarg.h>
+#include <math.h>
+
+#define CAN_RULES_HASH_SHIFT          25     // 32 - log2(CAN_RULES_TABLE_SIZE)
+#define CAN_RULES_BENCH_ID            0x191  // BMS frame 190 layout (node 17, never configured)
+#define CAN_RULES_BENCH_MAX           1000000
+
+// === COMPILED TABLE ===
+typedef struct {
+  uint32_t valueMask;
+  uint32_t signBit;                 // 0 = unsigned
+  float scale;
+  float offset;
+  unsigned long hits;
+  uint16_t reg;
+  uint8_t shift;                    // Into the little or big endian frame word
+  uint8_t minLength;                // Frame bytes the field needs
+  bool bigEndian;
+  bool scaled;                      // false: register = raw value
+} CANRuleOp_t;
+
+typedef struct {
+  uint32_t key;                     // id & masks[maskIndex]
+  uint16_t first;                   // First op of the run
+  uint8_t count;                    // 0 = empty bucket
+  uint8_t maskIndex;
+  bool extended;
+} CANRuleBucket_t;
+
+typedef struct {
+  CANRuleOp_t ops[CAN_RULES_MAX];
+  CANRuleInfo_t rules[CAN_RULES_MAX];    // Same order as ops
+  CANRuleBucket_t buckets[CAN_RULES_TABLE_SIZE];
+  uint32_t masks[CAN_RULES_MAX_MASKS];   // Most specific first
+  uint8_t maskCount;
+  uint8_t opCount;
+  uint8_t idCount;
+  uint8_t maxProbe;
+} CANRuleTable_t;
+
+// === GLOBAL VARIABLES ===
+static CANRuleTable_t ruleTable;
+static CANRulesStats_t rulesStats;
+static volatile bool reloadPending = false;
+static bool fsReady = false;
+static char parseError[64] = "";
+
+// === HELPERS ===
+
+static bool ruleError(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  vsnprintf(parseError, sizeof(parseError), format, args);
+  va_end(args);
+  return false;
+}
+
+static inline uint16_t hashKey(uint32_t key, uint8_t maskIndex, bool extended) {
+  uint32_t x = key ^ ((uint32_t)maskIndex << 29) ^ (extended ? 0x10000000UL : 0);
+  return (uint16_t)((x * 2654435761UL) >> CAN_RULES_HASH_SHIFT) & (CAN_RULES_TABLE_SIZE - 1);
+}
+
+static uint8_t popCount(uint32_t value) {
+  uint8_t count = 0;
+  while (value) {
+    value &= value - 1;
+    count++;
+  }
+  return count;
+}
+
+// === PARSER ===
+
+typedef struct {
+  const char* p;
+  const char* end;
+} JsonCursor_t;
+
+typedef struct {
+  bool isString;
+  bool isBool;
+  bool boolean;
+  double number;
+  char text[32];
+} JsonValue_t;
+
+static void skipSpace(JsonCursor_t* c) {
+  while (c->p < c->end && isspace((unsigned char)*c->p)) c->p++;
+}
+
+static bool consume(JsonCursor_t* c, char ch) {
+  skipSpace(c);
+  if (c->p < c->end && *c->p == ch) {
+    c->p++;
+    return true;
+  }
+  return false;
+}
+
+static bool parseString(JsonCursor_t* c, char* out, size_t size) {
+  skipSpace(c);
+  if (c->p >= c->end || *c->p != '"') return false;
+  c->p++;
+  size_t n = 0;
+  while (c->p < c->end && *c->p != '"') {
+    char ch = *c->p++;
+    if (ch == '\\') {
+      if (c->p >= c->end) return false;
+      ch = *c->p++;
+      if (ch == 'u') return false;       // Not needed for rule files
+      if (ch == 'n') ch = '\n';
+      if (ch == 't') ch = '\t';
+    }
+    if (n + 1 < size) out[n++] = ch;
+  }
+  if (c->p >= c->end) return false;
+  c->p++;
+  out[n] = '\0';
+  return true;
+}
+
+static bool parseValue(JsonCursor_t* c, JsonValue_t* value) {
+  memset(value, 0, sizeof(JsonValue_t));
+  skipSpace(c);
+  if (c->p >= c->end) return false;
+
+  if (*c->p == '"') {
+    value->isString = true;
+    return parseString(c, value->text, sizeof(value->text));
+  }
+  size_t remaining = c->end - c->p;
+  if (remaining >= 4 && strncmp(c->p, "true", 4) == 0) {
+    c->p += 4;
+    value->isBool = true;
+    value->boolean = true;
+    return true;
+  }
+  if (remaining >= 5 && strncmp(c->p, "false", 5) == 0) {
+    c->p += 5;
+    value->isBool = true;
+    return true;
+  }
+
+  // Number: copied out because the buffer need not be NUL terminated
+  char number[32];
+  size_t n = 0;
+  while (c->p < c->end && n + 1 < sizeof(number) && strchr("0123456789+-.eE", *c->p) != nullptr) {
+    number[n++] = *c->p++;
+  }
+  if (n == 0) return false;
+  number[n] = '\0';
+  char* endPtr = nullptr;
+  value->number = strtod(number, &endPtr);
+  return *endPtr == '\0';
+}
+
+static bool valueToUnsigned(const JsonValue_t* value, uint32_t* out) {
+  if (value->isString) {
+    char* endPtr = nullptr;
+    unsigned long parsed = strtoul(value->text, &endPtr, 0);
+    if (value->text[0] == '\0' || *endPtr != '\0') return false;
+    *out = (uint32_t)parsed;
+    return true;
+  }
+  if (value->isBool || value->number < 0 || value->number > 4294967295.0 ||
+      value->number != floor(value->number)) {
+    return false;
+  }
+  *out = (uint32_t)value->number;
+  return true;
+}
+
+static bool parseRule(JsonCursor_t* c, uint8_t index, CANRuleInfo_t* rule) {
+  memset(rule, 0, sizeof(CANRuleInfo_t));
+  snprintf(rule->name, sizeof(rule->name), "rule%u", index);
+  rule->scale = 1.0f;
+  bool hasId = false, hasMask = false, hasExtended = false;
+  bool hasByte = false, hasLength = false, hasRegister = false;
+  uint32_t number = 0;
+
+  if (!consume(c, '{')) return ruleError("rule %u: object expected", index);
+  if (consume(c, '}')) return ruleError("rule %u: empty", index);
+
+  do {
+    char key[16];
+    JsonValue_t value;
+    if (!parseString(c, key, sizeof(key)) || !consume(c, ':')) {
+      return ruleError("rule %u: key expected", index);
+    }
+    if (!parseValue(c, &value)) return ruleError("rule %u: bad value for %s", index, key);
+
+    if (strcmp(key, "name") == 0 && value.isString && strpbrk(value.text, "\"\\") == nullptr) {
+      strncpy(rule->name, value.text, sizeof(rule->name) - 1);
+      rule->name[sizeof(rule->name) - 1] = '\0';
+    } else if (strcmp(key, "id") == 0 && valueToUnsigned(&value, &number) && number <= 0x1FFFFFFF) {
+      rule->id = number;
+      hasId = true;
+    } else if (strcmp(key, "mask") == 0 && valueToUnsigned(&value, &number) && number <= 0x1FFFFFFF) {
+      rule->mask = number;
+      hasMask = true;
+    } else if (strcmp(key, "extended") == 0 && value.isBool) {
+      rule->extended = value.boolean;
+      hasExtended = true;
+    } else if (strcmp(key, "byte") == 0 && valueToUnsigned(&value, &number) && number <= 7) {
+      rule->byte = number;
+      hasByte = true;
+    } else if (strcmp(key, "bit") == 0 && valueToUnsigned(&value, &number) && number <= 7) {
+      rule->bit = number;
+    } else if (strcmp(key, "length") == 0 && valueToUnsigned(&value, &number) && number >= 1 && number <= 32) {
+      rule->length = number;
+      hasLength = true;
+    } else if (strcmp(key, "endian") == 0 && value.isString &&
+               (strcmp(value.text, "little") == 0 || strcmp(value.text, "big") == 0)) {
+      rule->bigEndian = value.text[0] == 'b';
+    } else if (strcmp(key, "signed") == 0 && value.isBool) {
+      rule->isSigned = value.boolean;
+    } else if (strcmp(key, "scale") == 0 && !value.isString && !value.isBool) {
+      rule->scale = (float)value.number;
+    } else if (strcmp(key, "offset") == 0 && !value.isString && !value.isBool) {
+      rule->offset = (float)value.number;
+    } else if (strcmp(key, "register") == 0 && valueToUnsigned(&value, &number) &&
+               number < MODBUS_MAX_HOLDING_REGISTERS) {
+      rule->reg = number;
+      hasRegister = true;
+    } else {
+      return ruleError("rule %u: invalid %s", index, key);
+    }
+  } while (consume(c, ','));
+
+  if (!consume(c, '}')) return ruleError("rule %u: '}' expected", index);
+  if (!hasId || !hasByte || !hasLength || !hasRegister) {
+    return ruleError("rule %u: id, byte, length and register required", index);
+  }
+  if (!hasExtended) rule->extended = rule->id > 0x7FF;
+  uint32_t idBits = rule->extended ? 0x1FFFFFFF : 0x7FF;
+  if (rule->id > idBits) return ruleError("rule %u: id exceeds 11 bits", index);
+  rule->mask = hasMask ? (rule->mask & idBits) : idBits;
+
+  uint8_t bytes = (rule->bit + rule->length + 7) / 8;
+  bool fits = rule->bigEndian ? (rule->byte + bytes <= 8) : (rule->byte * 8 + rule->bit + rule->length <= 64);
+  if (!fits) return ruleError("rule %u: field exceeds 8 bytes", index);
+  return true;
+}
+
+static bool parseRules(const char* json, size_t length, CANRuleInfo_t* rules, uint8_t* count) {
+  JsonCursor_t c = { json, json + length };
+  *count = 0;
+  bool wrapped = consume(&c, '{');
+
+  if (wrapped) {
+    // Only "rules" is interpreted; other top-level scalar keys are ignored
+    bool found = false;
+    do {
+      char key[16];
+      if (!parseString(&c, key, sizeof(key)) || !consume(&c, ':')) return ruleError("key expected");
+      if (strcmp(key, "rules") == 0) {
+        found = true;
+        break;
+      }
+      JsonValue_t ignored;
+      if (!parseValue(&c, &ignored)) return ruleError("bad value for %s", key);
+    } while (consume(&c, ','));
+    if (!found) return ruleError("\"rules\" array missing");
+  }
+
+  if (!consume(&c, '[')) return ruleError("'[' expected");
+  if (!consume(&c, ']')) {
+    do {
+      if (*count >= CAN_RULES_MAX) return ruleError("more than %d rules", CAN_RULES_MAX);
+      if (!parseRule(&c, *count, &rules[*count])) return false;
+      (*count)++;
+    } while (consume(&c, ','));
+    if (!consume(&c, ']')) return ruleError("']' expected after rule %u", *count);
+  }
+
+  if (wrapped) {
+    while (consume(&c, ',')) {
+      char key[16];
+      JsonValue_t ignored;
+      if (!parseString(&c, key, sizeof(key)) || !consume(&c, ':') || !parseValue(&c, &ignored)) {
+        return ruleError("bad trailing key");
+      }
+    }
+    if (!consume(&c, '}')) return ruleError("'}' expected");
+  }
+  skipSpace(&c);
+  if (c.p != c.end && *c.p != '\0') return ruleError("text after rules");
+  return true;
+}
+
+// === COMPILER ===
+
+static void compileOp(const CANRuleInfo_t* rule, CANRuleOp_t* op) {
+  memset(op, 0, sizeof(CANRuleOp_t));
+  uint8_t bytes = (rule->bit + rule->length + 7) / 8;
+  op->valueMask = (uint32_t)((1ULL << rule->length) - 1);
+  op->signBit = rule->isSigned ? (1UL << (rule->length - 1)) : 0;
+  op->bigEndian = rule->bigEndian;
+  if (rule->bigEndian) {
+    // Byte 0 is bits 63..56 of the big endian word; the field ends at byte + bytes - 1
+    op->shift = (7 - (rule->byte + bytes - 1)) * 8 + rule->bit;
+    op->minLength = rule->byte + bytes;
+  } else {
+    op->shift = rule->byte * 8 + rule->bit;
+    op->minLength = (rule->byte * 8 + rule->bit + rule->length + 7) / 8;
+  }
+  op->scaled = rule->scale != 1.0f || rule->offset != 0.0f;
+  op->scale = rule->scale;
+  op->offset = rule->offset;
+  op->reg = rule->reg;
+}
+
+static bool compileRules(const CANRuleInfo_t* rules, uint8_t count, CANRuleTable_t* table) {
+  memset(table, 0, sizeof(CANRuleTable_t));
+
+  // Distinct masks, most specific (most bits set) first
+  for (uint8_t i = 0; i < count; i++) {
+    bool known = false;
+    for (uint8_t m = 0; m < table->maskCount; m++) {
+      if (table->masks[m] == rules[i].mask) known = true;
+    }
+    if (known) continue;
+    if (table->maskCount >= CAN_RULES_MAX_MASKS) {
+      return ruleError("more than %d distinct masks", CAN_RULES_MAX_MASKS);
+    }
+    uint8_t pos = table->maskCount++;
+    while (pos > 0 && popCount(table->masks[pos - 1]) < popCount(rules[i].mask)) {
+      table->masks[pos] = table->masks[pos - 1];
+      pos--;
+    }
+    table->masks[pos] = rules[i].mask;
+  }
+
+  // Rules grouped by (mask, extended, key); file order kept inside a group
+  uint8_t maskOf[CAN_RULES_MAX];
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t pos = i;
+    uint8_t m = 0;
+    while (table->masks[m] != rules[i].mask) m++;
+    uint32_t key = rules[i].id & rules[i].mask;
+    while (pos > 0) {
+      const CANRuleInfo_t* prev = &table->rules[pos - 1];
+      uint32_t prevKey = prev->id & prev->mask;
+      bool after = maskOf[pos - 1] < m ||
+                   (maskOf[pos - 1] == m && (prev->extended < rules[i].extended ||
+                   (prev->extended == rules[i].extended && prevKey <= key)));
+      if (after) break;
+      table->rules[pos] = table->rules[pos - 1];
+      maskOf[pos] = maskOf[pos - 1];
+      pos--;
+    }
+    table->rules[pos] = rules[i];
+    maskOf[pos] = m;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    compileOp(&table->rules[i], &table->ops[i]);
+    table->rules[i].hits = 0;
+  }
+  table->opCount = count;
+
+  // One bucket per run of equal (mask, extended, key)
+  uint8_t i = 0;
+  while (i < count) {
+    const CANRuleInfo_t* rule = &table->rules[i];
+    uint32_t key = rule->id & rule->mask;
+    uint8_t run = 1;
+    while (i + run < count && maskOf[i + run] == maskOf[i] &&
+           table->rules[i + run].extended == rule->extended &&
+           (table->rules[i + run].id & table->rules[i + run].mask) == key) {
+      run++;
+    }
+
+    uint16_t slot = hashKey(key, maskOf[i], rule->extended);
+    uint8_t probe = 0;
+    while (table->buckets[slot].count != 0) {
+      slot = (slot + 1) & (CAN_RULES_TABLE_SIZE - 1);
+      probe++;
+    }
+    table->buckets[slot].key = key;
+    table->buckets[slot].first = i;
+    table->buckets[slot].count = run;
+    table->buckets[slot].maskIndex = maskOf[i];
+    table->buckets[slot].extended = rule->extended;
+    if (probe > table->maxProbe) table->maxProbe = probe;
+    table->idCount++;
+    i += run;
+  }
+  return true;
+}
+
+// === DISPATCH ===
+
+static const CANRuleBucket_t* findBucket(const CANRuleTable_t* table, uint32_t id, bool extended) {
+  for (uint8_t m = 0; m < table->maskCount; m++) {
+    uint32_t key = id & table->masks[m];
+    uint16_t slot = hashKey(key, m, extended);
+    for (uint8_t probe = 0; probe <= table->maxProbe; probe++) {
+      const CANRuleBucket_t* bucket = &table->buckets[slot];
+      if (bucket->count == 0) break;
+      if (bucket->key == key && bucket->maskIndex == m && bucket->extended == extended) return bucket;
+      slot = (slot + 1) & (CAN_RULES_TABLE_SIZE - 1);
+    }
+  }
+  return nullptr;
+}
+
+// Returns the number of fields written, -1 without a matching rule
+static int executeRules(CANRuleTable_t* table, uint32_t id, bool extended, uint8_t len,
+                        const uint8_t* data, uint16_t* registers) {
+  const CANRuleBucket_t* bucket = findBucket(table, id, extended);
+  if (bucket == nullptr) return -1;
+
+  uint64_t little = 0;
+  if (len >= 8) {
+    memcpy(&little, data, sizeof(little));    // Xtensa is little endian
+  } else {
+    memcpy(&little, data, len);               // Missing bytes read as zero
+  }
+  uint64_t big = __builtin_bswap64(little);
+
+  int written = 0;
+  CANRuleOp_t* op = &table->ops[bucket->first];
+  for (uint8_t i = 0; i < bucket->count; i++, op++) {
+    if (len < op->minLength) continue;
+    uint32_t raw = (uint32_t)((op->bigEndian ? big : little) >> op->shift) & op->valueMask;
+    int32_t value;
+    if (op->signBit != 0) {
+      value = (int32_t)((raw ^ op->signBit) - op->signBit);
+      if (op->scaled) value = (int32_t)lroundf((float)value * op->scale + op->offset);
+    } else if (op->scaled) {
+      value = (int32_t)lroundf((float)raw * op->scale + op->offset);
+    } else {
+      value = (int32_t)raw;
+    }
+    registers[op->reg] = (uint16_t)value;
+    op->hits++;
+    written++;
+  }
+  return written;
+}
+
+bool applyCANRules(unsigned long id, bool extended, uint8_t len, const uint8_t* data) {
+  if (ruleTable.opCount == 0) return false;
+  lockModbusRegisters();          // Fields of one frame land together for FC03 readers
+  int written = executeRules(&ruleTable, id, extended, len, data, holdingRegisters);
+  unlockModbusRegisters();
+  if (written < 0) return false;
+  rulesStats.framesMatched++;
+  rulesStats.fieldsDecoded += written;
+  return true;
+}
+
+// === LOADING ===
+
+bool loadCANRulesFromText(const char* json, size_t length) {
+  CANRuleInfo_t* rules = (CANRuleInfo_t*)malloc(sizeof(CANRuleInfo_t) * CAN_RULES_MAX);
+  CANRuleTable_t* staging = (CANRuleTable_t*)malloc(sizeof(CANRuleTable_t));
+  bool ok = rules != nullptr && staging != nullptr;
+  uint8_t count = 0;
+
+  if (!ok) {
+    ruleError("out of memory");
+  } else {
+    ok = parseRules(json, length, rules, &count) && compileRules(rules, count, staging);
+  }
+
+  if (ok) {
+    // Applied between frames: loading and dispatch both run in the main loop
+    memcpy(&ruleTable, staging, sizeof(CANRuleTable_t));
+    rulesStats.loads++;
+    rulesStats.rules = ruleTable.opCount;
+    rulesStats.ids = ruleTable.idCount;
+    rulesStats.masks = ruleTable.maskCount;
+    rulesStats.maxProbe = ruleTable.maxProbe;
+    rulesStats.loadedAt = millis();
+    rulesStats.lastError[0] = '\0';
+    LOG_I(LOG_MODULE_CAN, "CAN rules: %u rules, %u IDs, %u masks loaded",
+          ruleTable.opCount, ruleTable.idCount, ruleTable.maskCount);
+  } else {
+    rulesStats.loadErrors++;
+    strncpy(rulesStats.lastError, parseError, sizeof(rulesStats.lastError) - 1);
+    rulesStats.lastError[sizeof(rulesStats.lastError) - 1] = '\0';
+    LOG_E(LOG_MODULE_CAN, "CAN rules rejected (%s) - previous rules kept", parseError);
+  }
+
+  free(rules);
+  free(staging);
+  return ok;
+}
+
+bool loadCANRules(const char* path) {
+  if (!fsReady) {
+    ruleError("filesystem not mounted");
+  } else if (!LittleFS.exists(path)) {
+    ruleError("%s not found", path);
+  } else {
+    File file = LittleFS.open(path, "r");
+    size_t size = file ? file.size() : 0;
+    if (!file) {
+      ruleError("%s cannot be opened", path);
+    } else if (size > CAN_RULES_MAX_FILE_SIZE) {
+      file.close();
+      ruleError("%s larger than %d bytes", path, CAN_RULES_MAX_FILE_SIZE);
+    } else {
+      char* text = (char*)malloc(size + 1);
+      if (text == nullptr) {
+        file.close();
+        ruleError("out of memory");
+      } else {
+        size_t read = file.read((uint8_t*)text, size);
+        file.close();
+        text[read] = '\0';
+        bool ok = loadCANRulesFromText(text, read);
+        free(text);
+        return ok;
+      }
+    }
+  }
+
+  rulesStats.loadErrors++;
+  strncpy(rulesStats.lastError, parseError, sizeof(rulesStats.lastError) - 1);
+  rulesStats.lastError[sizeof(rulesStats.lastError) - 1] = '\0';
+  LOG_E(LOG_MODULE_CAN, "CAN rules not loaded: %s", parseError);
+  return false;
+}
+
+bool initCANRules() {
+  memset(&ruleTable, 0, sizeof(ruleTable));
+  memset(&rulesStats, 0, sizeof(rulesStats));
+
+  fsReady = LittleFS.begin(true);
+  if (!fsReady) {
+    Serial.println("❌ LittleFS mount failed - CAN mapping rules disabled");
+    return false;
+  }
+  if (!LittleFS.exists(CAN_RULES_FILE)) {
+    Serial.printf("📋 CAN rules: no %s - only built-in BMS decoding\n", CAN_RULES_FILE);
+    return true;
+  }
+  bool ok = loadCANRules(CAN_RULES_FILE);
+  if (ok) {
+    Serial.printf("📋 CAN rules: %u rules on %u IDs (%u masks, max probe %u)\n",
+                  ruleTable.opCount, ruleTable.idCount, ruleTable.maskCount, ruleTable.maxProbe);
+  } else {
+    Serial.printf("❌ CAN rules: %s\n", rulesStats.lastError);
+  }
+  return ok;
+}
+
+void requestCANRulesReload() {
+  reloadPending = true;
+}
+
+void processCANRulesReload() {
+  if (!reloadPending) return;
+  reloadPending = false;
+  loadCANRules(CAN_RULES_FILE);
+}
+
+// === STATISTICS ===
+
+const CANRulesStats_t* getCANRulesStats() {
+  return &rulesStats;
+}
+
+uint8_t getCANRuleCount() {
+  return ruleTable.opCount;
+}
+
+bool getCANRuleInfo(uint8_t index, CANRuleInfo_t* out) {
+  if (index >= ruleTable.opCount || out == nullptr) return false;
+  *out = ruleTable.rules[index];
+  out->hits = ruleTable.ops[index].hits;
+  return true;
+}
+
+// === BENCHMARK ===
+
+// Hand-written decoder of the fields described by benchRules
+static void __attribute__((noinline)) decodeFrame190ByHand(const uint8_t* d, uint16_t* registers) {
+  registers[0] = (uint16_t)lroundf((float)((d[0] << 8) | d[1]) * 0.1f);
+  registers[1] = (uint16_t)(int32_t)lroundf((float)(int16_t)((d[2] << 8) | d[3]) * 0.1f);
+  registers[2] = (uint16_t)lroundf((float)((d[4] << 8) | d[5]) * 0.1f);
+  registers[3] = (uint16_t)lroundf((float)d[6] * 0.5f);
+  registers[4] = d[7] & 0x01;
+  registers[5] = (d[7] >> 1) & 0x01;
+}
+
+static const CANRuleInfo_t benchRules[] = {
+  // name          id     mask   ext    byte bit len big   signed scale  offset reg
+  { "voltage",     0x191, 0x7FF, false, 0,   0,  16, true, false, 0.1f, 0.0f,  0, 0 },
+  { "current",     0x191, 0x7FF, false, 2,   0,  16, true, true,  0.1f, 0.0f,  1, 0 },
+  { "energy",      0x191, 0x7FF, false, 4,   0,  16, true, false, 0.1f, 0.0f,  2, 0 },
+  { "soc",         0x191, 0x7FF, false, 6,   0,  8,  true, false, 0.5f, 0.0f,  3, 0 },
+  { "ready",       0x191, 0x7FF, false, 7,   0,  1,  true, false, 1.0f, 0.0f,  4, 0 },
+  { "charging",    0x191, 0x7FF, false, 7,   1,  1,  true, false, 1.0f, 0.0f,  5, 0 },
+};
+
+bool benchmarkCANRules(uint32_t iterations, CANRulesBenchmark_t* out) {
+  if (out == nullptr || iterations == 0) return false;
+  if (iterations > CAN_RULES_BENCH_MAX) iterations = CAN_RULES_BENCH_MAX;
+
+  CANRuleTable_t* table = (CANRuleTable_t*)malloc(sizeof(CANRuleTable_t));
+  if (table == nullptr) return false;
+  if (!compileRules(benchRules, sizeof(benchRules) / sizeof(benchRules[0]), table)) {
+    free(table);
+    return false;
+  }
+
+  uint8_t frames[4][8] = {
+    { 0x14, 0xB4, 0x00, 0x64, 0x27, 0x10, 0xA0, 0x01 },
+    { 0x14, 0x82, 0xFF, 0x38, 0x26, 0xFC, 0x9F, 0x03 },
+    { 0x13, 0xEC, 0x01, 0xF4, 0x26, 0xE8, 0x64, 0x00 },
+    { 0x15, 0x18, 0xFE, 0x0C, 0x27, 0x24, 0xC8, 0x02 },
+  };
+  uint16_t handRegisters[8] = { 0 };
+  uint16_t ruleRegisters[8] = { 0 };
+
+  unsigned long start = micros();
+  for (uint32_t i = 0; i < iterations; i++) {
+    decodeFrame190ByHand(frames[i & 3], handRegisters);
+  }
+  unsigned long handUs = micros() - start;
+
+  start = micros();
+  for (uint32_t i = 0; i < iterations; i++) {
+    executeRules(table, CAN_RULES_BENCH_ID, false, 8, frames[i & 3], ruleRegisters);
+  }
+  unsigned long rulesUs = micros() - start;
+
+  out->outputsMatch = true;
+  for (uint8_t f = 0; f < 4; f++) {
+    decodeFrame190ByHand(frames[f], handRegisters);
+    executeRules(table, CAN_RULES_BENCH_ID, false, 8, frames[f], ruleRegisters);
+    if (memcmp(handRegisters, ruleRegisters, sizeof(handRegisters)) != 0) out->outputsMatch = false;
+  }
+  free(table);
+
+  out->iterations = iterations;
+  out->handNsPerFrame = handUs * 1000.0f / iterations;
+  out->rulesNsPerFrame = rulesUs * 1000.0f / iterations;
+  out->ratio = handUs > 0 ? (float)rulesUs / handUs : 0.0f;
+  return true;
+}
+
+void printCANRulesStatus() {
+  Serial.println("\n📋 CAN MAPPING RULES");
+  Serial.printf("   Rules: %u on %u IDs, %u masks, max probe %u\n",
+                rulesStats.rules, rulesStats.ids, rulesStats.masks, rulesStats.maxProbe);
+  Serial.printf("   Loads: %lu, errors: %lu%s%s\n", rulesStats.loads, rulesStats.loadErrors,
+                rulesStats.lastError[0] ? ", last: " : "", rulesStats.lastError);
+  Serial.printf("   Frames matched: %lu, fields decoded: %lu\n",
+                rulesStats.framesMatched, rulesStats.fieldsDecoded);
+  for (uint8_t i = 0; i < ruleTable.opCount; i++) {
+    const CANRuleInfo_t* rule = &ruleTable.rules[i];
+    Serial.printf("   %-15s 0x%08lX/0x%08lX b%u.%u:%u %s -> HR%u (%lu hits)\n",
+                  rule->name, (unsigned long)rule->id, (unsigned long)rule->mask, rule->byte,
+                  rule->bit, rule->length, rule->bigEndian ? "BE" : "LE", rule->reg,
+                  ruleTable.ops[i].hits);
+  }
+}
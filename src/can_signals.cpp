@@ -0,0 +1,418 @@
+// =====================================================================
+// === can_signals.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: DBC Signal Tables and Bit-Extraction Kernel Implementation
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Binary signal tables compiled from DBC, generic decode kernel, BMS parser check
+//
+// 🎯 DEPENDENCIES:
+//    Internal: can_signals.h, bms_protocol.h, bms_signal_table.h
+//    External: Arduino.h, LittleFS.h
+//
+// 📝 DESCRIPTION:
+//    The table image is validated once (sizes, sorted IDs, signal bounds,
+//    string offsets); the kernel then trusts it and does no checks of its
+//    own. The parser check decodes fixed and pseudo-random payloads with
+//    both the compiled BMS table and decodeBMSFrameData() and compares
+//    every field after conversion to the field's type, so it reports what
+//    the BMS data would actually hold.
+//
+// =====================================================================
+
+#include "can_signals.h"
+#include "bms_protocol.h"
+#include "bms_signal_table.h"
+#include <LittleFS.h>
+#include <math.h>
+#include <stddef.h>
+
+static_assert(sizeof(SignalTableHeader_t) == 16, "signal table header layout");
+static_assert(sizeof(SignalMessage_t) == 8, "signal message layout");
+static_assert(sizeof(SignalDef_t) == 24, "signal definition layout");
+
+// === GLOBAL VARIABLES ===
+static uint8_t* tableImage = nullptr;    // Heap copy of SIGNAL_TABLE_FILE
+static SignalTable_t loadedTable;
+static float* lastValues = nullptr;      // One per signal of the loaded table
+static CANSignalsStats_t signalsStats;
+static const char* tableError = "";
+
+// === KERNEL ===
+
+bool openSignalTable(const uint8_t* image, size_t size, SignalTable_t* table) {
+  if (image == nullptr || ((uintptr_t)image & 3) != 0 || size < sizeof(SignalTableHeader_t)) {
+    tableError = "image missing, unaligned or short";
+    return false;
+  }
+  const SignalTableHeader_t* header = (const SignalTableHeader_t*)image;
+  if (header->magic != SIGNAL_TABLE_MAGIC || header->version != SIGNAL_TABLE_VERSION) {
+    tableError = "not a SIGT v1 table";
+    return false;
+  }
+  size_t expected = sizeof(SignalTableHeader_t) + header->messageCount * sizeof(SignalMessage_t) +
+                    header->signalCount * sizeof(SignalDef_t) + header->stringBytes;
+  if (expected != size) {
+    tableError = "size does not match header";
+    return false;
+  }
+
+  table->header = header;
+  table->messages = (const SignalMessage_t*)(image + sizeof(SignalTableHeader_t));
+  table->signals = (const SignalDef_t*)(table->messages + header->messageCount);
+  table->strings = (const char*)(table->signals + header->signalCount);
+
+  if (header->stringBytes > 0 && table->strings[header->stringBytes - 1] != '\0') {
+    tableError = "string block not terminated";
+    return false;
+  }
+  for (uint16_t m = 0; m < header->messageCount; m++) {
+    const SignalMessage_t* message = &table->messages[m];
+    if (m > 0 && message->id <= table->messages[m - 1].id) {
+      tableError = "message IDs not sorted";
+      return false;
+    }
+    if ((uint32_t)message->firstSignal + message->signalCount > header->signalCount) {
+      tableError = "message signals out of range";
+      return false;
+    }
+  }
+  for (uint16_t s = 0; s < header->signalCount; s++) {
+    const SignalDef_t* signal = &table->signals[s];
+    if (signal->length < 1 || signal->length > 64 || signal->shift + signal->length > 64 ||
+        signal->nameOffset >= header->stringBytes) {
+      tableError = "signal layout invalid";
+      return false;
+    }
+  }
+  return true;
+}
+
+const SignalMessage_t* findSignalMessage(const SignalTable_t* table, uint32_t id, bool extended) {
+  uint32_t key = id | (extended ? SIGNAL_ID_EXTENDED : 0);
+  int low = 0;
+  int high = (int)table->header->messageCount - 1;
+  while (low <= high) {
+    int mid = (low + high) >> 1;
+    uint32_t midId = table->messages[mid].id;
+    if (midId == key) return &table->messages[mid];
+    if (midId < key) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return nullptr;
+}
+
+uint8_t decodeSignals(const SignalTable_t* table, const SignalMessage_t* message,
+                      const uint8_t* data, uint8_t len, float* values) {
+  // One load per frame; missing bytes of a short frame read as zero
+  uint64_t little = 0;
+  memcpy(&little, data, len < 8 ? len : 8);     // Xtensa is little endian
+  uint64_t big = __builtin_bswap64(little);
+
+  const SignalDef_t* signal = &table->signals[message->firstSignal];
+  int mux = -1;                                  // The multiplexor is the first signal
+  uint8_t decoded = 0;
+  for (uint8_t i = 0; i < message->signalCount; i++, signal++) {
+    bool motorola = (signal->flags & SIGNAL_FLAG_MOTOROLA) != 0;
+    uint8_t needed = motorola ? 8 - (signal->shift >> 3) : (signal->shift + signal->length + 7) >> 3;
+    if (len < needed || ((signal->flags & SIGNAL_FLAG_MULTIPLEXED) && signal->muxValue != mux)) {
+      values[i] = NAN;
+      continue;
+    }
+
+    uint64_t raw = ((motorola ? big : little) >> signal->shift) & (~0ULL >> (64 - signal->length));
+    float value;
+    if (signal->flags & SIGNAL_FLAG_SIGNED) {
+      uint8_t pad = 64 - signal->length;
+      value = (float)((int64_t)(raw << pad) >> pad);
+    } else {
+      value = (float)raw;
+    }
+    if (signal->flags & SIGNAL_FLAG_MULTIPLEXOR) mux = (int)raw;
+    values[i] = value * signal->scale + signal->offset;
+    decoded++;
+  }
+  return decoded;
+}
+
+const char* getSignalName(const SignalTable_t* table, uint16_t signal) {
+  if (signal >= table->header->signalCount) return "";
+  return table->strings + table->signals[signal].nameOffset;
+}
+
+// === LOADED TABLE ===
+
+static bool loadSignalTableFile(const char* path) {
+  File file = LittleFS.open(path, "r");
+  if (!file) {
+    tableError = "cannot be opened";
+    return false;
+  }
+  size_t size = file.size();
+  if (size > SIGNAL_TABLE_MAX_FILE_SIZE) {
+    file.close();
+    tableError = "file too large";
+    return false;
+  }
+
+  uint8_t* image = (uint8_t*)malloc(size > 0 ? size : 1);   // malloc is 4-byte aligned
+  if (image == nullptr) {
+    file.close();
+    tableError = "out of memory";
+    return false;
+  }
+  size_t read = file.read(image, size);
+  file.close();
+
+  SignalTable_t table;
+  if (read != size || !openSignalTable(image, size, &table)) {
+    if (read != size) tableError = "short read";
+    free(image);
+    return false;
+  }
+  float* values = (float*)malloc(sizeof(float) * (table.header->signalCount > 0 ? table.header->signalCount : 1));
+  if (values == nullptr) {
+    free(image);
+    tableError = "out of memory";
+    return false;
+  }
+  for (uint16_t s = 0; s < table.header->signalCount; s++) values[s] = NAN;
+
+  free(lastValues);
+  free(tableImage);
+  tableImage = image;
+  lastValues = values;
+  loadedTable = table;
+  signalsStats.loaded = true;
+  signalsStats.messages = table.header->messageCount;
+  signalsStats.signals = table.header->signalCount;
+  signalsStats.tableBytes = size;
+  return true;
+}
+
+bool initCANSignals() {
+  memset(&signalsStats, 0, sizeof(signalsStats));
+
+  // Our BMS frames through the kernel must match the hand-written parsers
+  SignalVerifyResult_t check;
+  if (verifyBMSSignalTable(&check)) {
+    Serial.printf("📡 CAN signals: BMS table matches the parsers (%lu checks)\n", (unsigned long)check.checks);
+  } else {
+    Serial.printf("❌ CAN signals: BMS table differs from the parsers (%lu of %lu, first: %s)\n",
+                  (unsigned long)check.mismatches, (unsigned long)check.checks, check.firstMismatch);
+  }
+
+  // LittleFS is mounted by initCANRules(); begin() again is a no-op when mounted
+  if (!LittleFS.begin(true) || !LittleFS.exists(SIGNAL_TABLE_FILE)) {
+    Serial.printf("📡 CAN signals: no %s\n", SIGNAL_TABLE_FILE);
+    return true;
+  }
+  if (!loadSignalTableFile(SIGNAL_TABLE_FILE)) {
+    signalsStats.loadErrors++;
+    snprintf(signalsStats.lastError, sizeof(signalsStats.lastError), "%s: %s", SIGNAL_TABLE_FILE, tableError);
+    Serial.printf("❌ CAN signals: %s\n", signalsStats.lastError);
+    return false;
+  }
+  Serial.printf("📡 CAN signals: %u messages, %u signals (%lu bytes)\n",
+                signalsStats.messages, signalsStats.signals, (unsigned long)signalsStats.tableBytes);
+  return true;
+}
+
+bool applyCANSignals(unsigned long id, bool extended, uint8_t len, const uint8_t* data) {
+  if (!signalsStats.loaded) return false;
+  const SignalMessage_t* message = findSignalMessage(&loadedTable, id, extended);
+  if (message == nullptr) return false;
+
+  float* values = &lastValues[message->firstSignal];
+  signalsStats.signalsDecoded += decodeSignals(&loadedTable, message, data, len, values);
+  signalsStats.framesDecoded++;
+
+  const SignalDef_t* signal = &loadedTable.signals[message->firstSignal];
+  for (uint8_t i = 0; i < message->signalCount; i++, signal++) {
+    // DBC [0|0] means no range; NAN (not decoded) compares false
+    if (signal->minimum < signal->maximum && (values[i] < signal->minimum || values[i] > signal->maximum)) {
+      signalsStats.outOfRange++;
+    }
+  }
+  return true;
+}
+
+const SignalTable_t* getCANSignalTable() {
+  return signalsStats.loaded ? &loadedTable : nullptr;
+}
+
+float getCANSignalValue(uint16_t signal) {
+  if (!signalsStats.loaded || signal >= signalsStats.signals) return NAN;
+  return lastValues[signal];
+}
+
+const CANSignalsStats_t* getCANSignalsStats() {
+  return &signalsStats;
+}
+
+// === BMS PARSER CHECK ===
+
+typedef enum {
+  BMS_FIELD_FLOAT = 0,
+  BMS_FIELD_U8,
+  BMS_FIELD_I8,
+  BMS_FIELD_BOOL
+} BMSFieldType_t;
+
+typedef struct {
+  uint8_t frameType;                // BMSFrameType_t
+  uint16_t canId;                   // Node 1 (as in docs/bms_frames.dbc)
+  const char* signal;
+  uint16_t offset;                  // In BMSData
+  uint8_t type;                     // BMSFieldType_t
+} BMSSignalCheck_t;
+
+#define BMS_CHECK(frame, id, signal, field, type) \
+  { BMS_FRAME_TYPE_##frame, id, signal, (uint16_t)offsetof(BMSData, field), BMS_FIELD_##type }
+
+static const BMSSignalCheck_t bmsSignalChecks[] = {
+  BMS_CHECK(190, 0x191, "BatteryVoltage", batteryVoltage, FLOAT),
+  BMS_CHECK(190, 0x191, "BatteryCurrent", batteryCurrent, FLOAT),
+  BMS_CHECK(190, 0x191, "RemainingEnergy", remainingEnergy, FLOAT),
+  BMS_CHECK(190, 0x191, "Soc", soc, FLOAT),
+  BMS_CHECK(190, 0x191, "MasterError", masterError, BOOL),
+  BMS_CHECK(190, 0x191, "CellVoltageError", cellVoltageError, BOOL),
+  BMS_CHECK(190, 0x191, "CellTempMinError", cellTempMinError, BOOL),
+  BMS_CHECK(190, 0x191, "CellTempMaxError", cellTempMaxError, BOOL),
+  BMS_CHECK(290, 0x291, "CellMinVoltage", cellMinVoltage, FLOAT),
+  BMS_CHECK(290, 0x291, "CellMeanVoltage", cellMeanVoltage, FLOAT),
+  BMS_CHECK(290, 0x291, "MinVoltageString", minVoltageString, U8),
+  BMS_CHECK(290, 0x291, "MinVoltageBlock", minVoltageBlock, U8),
+  BMS_CHECK(290, 0x291, "MinVoltageCell", minVoltageCell, U8),
+  BMS_CHECK(310, 0x311, "Soh", soh, FLOAT),
+  BMS_CHECK(310, 0x311, "Dcir", dcir, FLOAT),
+  BMS_CHECK(310, 0x311, "CellMinTemperature", cellMinTemperature, I8),
+  BMS_CHECK(310, 0x311, "CellMeanTemperature", cellMeanTemperature, I8),
+  BMS_CHECK(390, 0x391, "CellMaxVoltage", cellMaxVoltage, FLOAT),
+  BMS_CHECK(390, 0x391, "CellVoltageDelta", cellVoltageDelta, FLOAT),
+  BMS_CHECK(390, 0x391, "MaxVoltageString", maxVoltageString, U8),
+  BMS_CHECK(390, 0x391, "MaxVoltageBlock", maxVoltageBlock, U8),
+  BMS_CHECK(390, 0x391, "MaxVoltageCell", maxVoltageCell, U8),
+  BMS_CHECK(410, 0x411, "CellMaxTemperature", cellMaxTemperature, FLOAT),
+  BMS_CHECK(410, 0x411, "CellTempDelta", cellTempDelta, FLOAT),
+  BMS_CHECK(410, 0x411, "MaxTempString", maxTempString, U8),
+  BMS_CHECK(410, 0x411, "MaxTempBlock", maxTempBlock, U8),
+  BMS_CHECK(410, 0x411, "MaxTempSensor", maxTempSensor, U8),
+  BMS_CHECK(410, 0x411, "ReadyToCharge", readyToCharge, BOOL),
+  BMS_CHECK(410, 0x411, "ReadyToDischarge", readyToDischarge, BOOL),
+  BMS_CHECK(510, 0x511, "Dccl", dccl, FLOAT),
+  BMS_CHECK(510, 0x511, "Ddcl", ddcl, FLOAT),
+  BMS_CHECK(510, 0x511, "Inputs", inputs, U8),
+  BMS_CHECK(510, 0x511, "Outputs", outputs, U8),
+  BMS_CHECK(490, 0x491, "MuxType", mux490Type, U8),
+  BMS_CHECK(710, 0x711, "CanopenState", canopenState, U8),
+};
+
+#define BMS_SIGNAL_CHECK_COUNT (sizeof(bmsSignalChecks) / sizeof(bmsSignalChecks[0]))
+
+// Kernel value as the parser's field type would hold it
+static bool fieldMatches(const BMSData* bms, const BMSSignalCheck_t* check, float value) {
+  const uint8_t* field = (const uint8_t*)bms + check->offset;
+  switch (check->type) {
+    case BMS_FIELD_FLOAT: {
+      float expected = *(const float*)field;
+      return fabsf(value - expected) <= 1e-5f * fmaxf(1.0f, fabsf(expected));
+    }
+    case BMS_FIELD_U8:
+      return (uint8_t)lroundf(value) == *field;
+    case BMS_FIELD_I8:
+      return (int8_t)lroundf(value) == *(const int8_t*)field;
+    case BMS_FIELD_BOOL:
+      return (value != 0.0f) == *(const bool*)field;
+  }
+  return false;
+}
+
+bool verifyBMSSignalTable(SignalVerifyResult_t* result) {
+  memset(result, 0, sizeof(SignalVerifyResult_t));
+  SignalTable_t table;
+  if (!openSignalTable(bmsSignalTable, sizeof(bmsSignalTable), &table)) {
+    snprintf(result->firstMismatch, sizeof(result->firstMismatch), "table: %s", tableError);
+    result->mismatches = 1;
+    return false;
+  }
+
+  BMSData* scratch = new BMSData();
+  float values[32];
+  uint32_t seed = 0x12345678;
+
+  for (uint16_t p = 0; p < SIGNAL_VERIFY_PAYLOADS; p++) {
+    // Edge patterns first, then xorshift32 payloads
+    uint8_t payload[8];
+    for (uint8_t b = 0; b < 8; b++) {
+      if (p < 4) {
+        static const uint8_t patterns[4] = { 0x00, 0xFF, 0x55, 0xAA };
+        payload[b] = patterns[p];
+      } else {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        payload[b] = (uint8_t)seed;
+      }
+    }
+
+    uint8_t decodedFrame = BMS_FRAME_TYPE_UNKNOWN;
+    const SignalMessage_t* message = nullptr;
+    for (uint8_t c = 0; c < BMS_SIGNAL_CHECK_COUNT; c++) {
+      const BMSSignalCheck_t* check = &bmsSignalChecks[c];
+      if (check->frameType != decodedFrame) {
+        decodedFrame = check->frameType;
+        decodeBMSFrameData((BMSFrameType_t)decodedFrame, payload, scratch);
+        message = findSignalMessage(&table, check->canId, false);
+        if (message != nullptr && message->signalCount <= sizeof(values) / sizeof(values[0])) {
+          decodeSignals(&table, message, payload, 8, values);
+        } else {
+          message = nullptr;
+        }
+      }
+
+      int index = -1;
+      for (uint8_t s = 0; message != nullptr && s < message->signalCount; s++) {
+        if (strcmp(getSignalName(&table, message->firstSignal + s), check->signal) == 0) index = s;
+      }
+      result->checks++;
+      if (index >= 0 && fieldMatches(scratch, check, values[index])) continue;
+
+      if (result->mismatches++ == 0) {
+        snprintf(result->firstMismatch, sizeof(result->firstMismatch), "%s 0x%02X%02X%02X%02X%02X%02X%02X%02X",
+                 check->signal, payload[0], payload[1], payload[2], payload[3],
+                 payload[4], payload[5], payload[6], payload[7]);
+      }
+    }
+  }
+
+  delete scratch;
+  return result->mismatches == 0;
+}
+
+void printCANSignalsStatus() {
+  Serial.println("\n📡 CAN SIGNAL TABLE");
+  if (!signalsStats.loaded) {
+    Serial.printf("   No table loaded%s%s\n", signalsStats.lastError[0] ? " - " : "", signalsStats.lastError);
+    return;
+  }
+  Serial.printf("   Table: %u messages, %u signals, %lu bytes\n",
+                signalsStats.messages, signalsStats.signals, (unsigned long)signalsStats.tableBytes);
+  Serial.printf("   Frames decoded: %lu, signals: %lu, out of range: %lu\n",
+                signalsStats.framesDecoded, signalsStats.signalsDecoded, signalsStats.outOfRange);
+}
@@ -10,12 +10,13 @@
 //
 // 📋 MODULE INFO:
 //    Module: System Configuration Implementation
-//    Version: v4.0.2
+//    Version: v4.0.3
 //    Created: 12.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.0.3 - 18.10.2026 - EEPROM commit timed as a profiling zone
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v3.1.0 - 12.08.2025 - Enhanced configuration management
 //    v3.0.0 - 12.08.2025 - Initial configuration implementation
@@ -53,6 +54,7 @@
 
 #include "config.h"
 #include <EEPROM.h>
+#include "stall_monitor.h"
 #include <string.h>
 #include <mcp_can.h>
 
@@ -139,7 +141,9 @@ bool saveConfiguration() {
   // Zapisz magic number
   EEPROM.write(EEPROM_MAGIC, EEPROM_MAGIC_VALUE);
   
+  enterProfileZone(PROFILE_ZONE_EEPROM);
   bool result = EEPROM.commit();
+  leaveProfileZone();
   
   if (result) {
     DEBUG_PRINTLN("✅ Configuration saved successfully");
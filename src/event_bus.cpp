@@ -0,0 +1,201 @@
+// =====================================================================
+// === event_bus.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Internal Event Bus Implementation
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Typed events, per-subscriber SPSC queues, drop/depth statistics
+//
+// 🎯 DEPENDENCIES:
+//    Internal: event_bus.h
+//    External: Arduino.h, FreeRTOS
+//
+// 📝 DESCRIPTION:
+//    Ring indices run free (uint16_t, wrap naturally) and are masked on
+//    access; depth = head - tail. The producer only writes head and its
+//    own counters, the consumer only tail and "consumed". Slots are
+//    filled before head is released, and read before tail is released.
+//
+// =====================================================================
+
+#include "event_bus.h"
+
+// === SUBSCRIBER QUEUE ===
+typedef struct {
+  Event_t ring[EVENT_QUEUE_SIZE];
+  uint16_t head;                    // Producer
+  uint16_t tail;                    // Consumer
+  EventSubscriberStats_t stats;
+} EventQueue_t;
+
+// === GLOBAL VARIABLES ===
+static EventQueue_t eventQueues[EVENT_BUS_MAX_SUBSCRIBERS];
+static EventBusStats_t busStats;
+static TaskHandle_t producerTask = nullptr;
+
+// === BUS FUNCTIONS ===
+
+void initEventBus() {
+  producerTask = xTaskGetCurrentTaskHandle();
+  Serial.printf("📨 Event bus: %d subscribers x %d events\n", EVENT_BUS_MAX_SUBSCRIBERS, EVENT_QUEUE_SIZE);
+}
+
+int8_t subscribeEvents(const char* name, uint32_t typeMask) {
+  if (name == nullptr) return -1;
+
+  for (uint8_t i = 0; i < busStats.subscribers; i++) {
+    if (strncmp(eventQueues[i].stats.name, name, EVENT_SUBSCRIBER_NAME_LENGTH - 1) == 0) {
+      eventQueues[i].stats.typeMask = typeMask;
+      return i;
+    }
+  }
+  if (busStats.subscribers >= EVENT_BUS_MAX_SUBSCRIBERS) {
+    Serial.printf("❌ Event bus full, subscriber '%s' rejected\n", name);
+    return -1;
+  }
+
+  EventQueue_t* q = &eventQueues[busStats.subscribers];
+  memset(q, 0, sizeof(EventQueue_t));
+  strncpy(q->stats.name, name, EVENT_SUBSCRIBER_NAME_LENGTH - 1);
+  q->stats.typeMask = typeMask;
+
+  // Publish the queue before the producer can see it in the count
+  __atomic_store_n(&busStats.subscribers, busStats.subscribers + 1, __ATOMIC_RELEASE);
+  return busStats.subscribers - 1;
+}
+
+void publishEvent(Event_t* event) {
+  if (event == nullptr || event->type >= EVENT_TYPE_COUNT) return;
+  if (producerTask != nullptr && xTaskGetCurrentTaskHandle() != producerTask) {
+    busStats.foreignPublishes++;
+    return;
+  }
+
+  event->timestamp = millis();
+  busStats.published[event->type]++;
+
+  uint8_t subscribers = __atomic_load_n(&busStats.subscribers, __ATOMIC_ACQUIRE);
+  for (uint8_t i = 0; i < subscribers; i++) {
+    EventQueue_t* q = &eventQueues[i];
+    if (!(q->stats.typeMask & EVENT_MASK(event->type))) continue;
+
+    uint16_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+    uint16_t depth = (uint16_t)(q->head - tail);
+    if (depth >= EVENT_QUEUE_SIZE) {
+      q->stats.dropped++;
+      continue;
+    }
+
+    q->ring[q->head & (EVENT_QUEUE_SIZE - 1)] = *event;
+    __atomic_store_n(&q->head, (uint16_t)(q->head + 1), __ATOMIC_RELEASE);
+    q->stats.enqueued++;
+    if (depth + 1 > q->stats.peakDepth) q->stats.peakDepth = depth + 1;
+  }
+}
+
+void publishBMSFrameEvent(uint8_t nodeId, uint8_t frameType) {
+  Event_t event;
+  event.type = EVENT_BMS_FRAME_PARSED;
+  event.source = nodeId;
+  event.data.bmsFrame.frameType = frameType;
+  publishEvent(&event);
+}
+
+void publishModuleStateEvent(uint8_t moduleId, uint8_t oldState, uint8_t newState) {
+  Event_t event;
+  event.type = EVENT_MODULE_STATE_CHANGED;
+  event.source = moduleId;
+  event.data.moduleState.oldState = oldState;
+  event.data.moduleState.newState = newState;
+  publishEvent(&event);
+}
+
+void publishLimitsEvent(float dccl, float ddcl) {
+  Event_t event;
+  event.type = EVENT_LIMITS_CHANGED;
+  event.source = 0;
+  event.data.limits.dccl = dccl;
+  event.data.limits.ddcl = ddcl;
+  publishEvent(&event);
+}
+
+void publishRegisterWriteEvent(uint16_t address, uint16_t count, uint16_t value) {
+  Event_t event;
+  event.type = EVENT_REGISTER_WRITTEN;
+  event.source = 0;
+  event.data.registers.address = address;
+  event.data.registers.count = count;
+  event.data.registers.value = value;
+  publishEvent(&event);
+}
+
+bool pollEvent(int8_t subscriber, Event_t* event) {
+  if (subscriber < 0 || subscriber >= busStats.subscribers || event == nullptr) return false;
+  EventQueue_t* q = &eventQueues[subscriber];
+
+  uint16_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+  if (head == q->tail) return false;
+
+  *event = q->ring[q->tail & (EVENT_QUEUE_SIZE - 1)];
+  __atomic_store_n(&q->tail, (uint16_t)(q->tail + 1), __ATOMIC_RELEASE);
+  q->stats.consumed++;
+  return true;
+}
+
+unsigned long getEventDrops(int8_t subscriber) {
+  if (subscriber < 0 || subscriber >= busStats.subscribers) return 0;
+  return eventQueues[subscriber].stats.dropped;
+}
+
+// === STATISTICS ===
+
+bool getEventSubscriberStats(int8_t subscriber, EventSubscriberStats_t* out) {
+  if (subscriber < 0 || subscriber >= busStats.subscribers || out == nullptr) return false;
+  const EventQueue_t* q = &eventQueues[subscriber];
+  *out = q->stats;
+  out->depth = (uint16_t)(__atomic_load_n(&q->head, __ATOMIC_ACQUIRE) -
+                          __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE));
+  return true;
+}
+
+const EventBusStats_t* getEventBusStats() {
+  return &busStats;
+}
+
+const char* getEventTypeName(uint8_t type) {
+  switch (type) {
+    case EVENT_BMS_FRAME_PARSED:     return "bms_frame";
+    case EVENT_MODULE_STATE_CHANGED: return "module_state";
+    case EVENT_LIMITS_CHANGED:       return "limits";
+    case EVENT_REGISTER_WRITTEN:     return "register_write";
+    default:                         return "unknown";
+  }
+}
+
+void printEventBusStatus() {
+  Serial.println("=== EVENT BUS ===");
+  for (uint8_t t = 0; t < EVENT_TYPE_COUNT; t++) {
+    Serial.printf("%s: %lu published\n", getEventTypeName(t), busStats.published[t]);
+  }
+  if (busStats.foreignPublishes > 0) {
+    Serial.printf("Refused (wrong task): %lu\n", busStats.foreignPublishes);
+  }
+  for (int8_t i = 0; i < busStats.subscribers; i++) {
+    EventSubscriberStats_t s;
+    getEventSubscriberStats(i, &s);
+    Serial.printf("  %-12s mask 0x%02lX: enqueued %lu, consumed %lu, dropped %lu, depth %u (peak %u)\n",
+                  s.name, (unsigned long)s.typeMask, s.enqueued, s.consumed, s.dropped, s.depth, s.peakDepth);
+  }
+}
@@ -0,0 +1,354 @@
+// =====================================================================
+// === log_sink.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Asynchronous Log Sink Implementation
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Lock-free ring, drain task, per-module levels, per-site rate limit
+//
+// 🎯 DEPENDENCIES:
+//    Internal: log_sink.h, config.h (DEVICE_NAME)
+//    External: Arduino.h, WiFi.h, WiFiUdp.h
+//
+// 📝 DESCRIPTION:
+//    Bounded multi-producer / single-consumer ring. Every slot carries a
+//    sequence number: a producer claims position P by CAS on the head when
+//    the slot's sequence equals P, writes the message and publishes it by
+//    setting the sequence to P + 1. The drain task reads a slot whose
+//    sequence is tail + 1 and hands it back with tail + LOG_RING_SLOTS.
+//    Producers never wait on each other or on the consumer; a slot that is
+//    still unread means the ring is full and the message is dropped.
+//
+// =====================================================================
+
+#include "log_sink.h"
+#include "config.h"
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <stdarg.h>
+
+// === RING ===
+typedef struct {
+  volatile uint32_t sequence;
+  uint8_t module;
+  uint8_t level;
+  unsigned long timestamp;          // millis()
+  char text[LOG_MESSAGE_LENGTH];
+} LogSlot_t;
+
+static LogSlot_t logRing[LOG_RING_SLOTS];
+static uint32_t logHead = 0;        // Producers (CAS)
+static uint32_t logTail = 0;        // Drain task only
+
+// === GLOBAL VARIABLES ===
+volatile uint8_t logModuleLevels[LOG_MODULE_COUNT] = {
+  LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO,
+  LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO
+};
+
+static LogModuleStats_t moduleStats[LOG_MODULE_COUNT];
+static LogSinkStats_t sinkStats;
+static TaskHandle_t drainTask = nullptr;
+static bool logSinkReady = false;
+
+static portMUX_TYPE syslogMux = portMUX_INITIALIZER_UNLOCKED;
+static char syslogHost[64] = "";
+static uint16_t syslogPort = LOG_SYSLOG_DEFAULT_PORT;
+static WiFiUDP syslogUdp;
+
+static const char* moduleNames[LOG_MODULE_COUNT] = {
+  "system", "can", "bms", "modbus", "wifi", "web",
+  "trio_manager", "trio_monitor", "trio_control", "trio_limits"
+};
+
+static const char* levelNames[] = { "none", "error", "warn", "info", "debug" };
+
+// === HELPERS ===
+
+static inline void countStat(unsigned long* counter) {
+  __atomic_fetch_add(counter, 1UL, __ATOMIC_RELAXED);
+}
+
+// Charges one message to the call site; false when over budget
+static bool takeSiteToken(LogSite_t* site) {
+  unsigned long now = millis();
+  unsigned long elapsed = now - site->lastRefill;
+  if (elapsed > 0) {
+    if (elapsed > LOG_SITE_BURST * 1000UL) elapsed = LOG_SITE_BURST * 1000UL;
+    uint32_t tokens = site->milliTokens + elapsed * LOG_SITE_RATE_PER_S;   // N/s = N millitokens/ms
+    site->milliTokens = tokens > LOG_SITE_BURST * 1000 ? LOG_SITE_BURST * 1000 : tokens;
+    site->lastRefill = now;
+  }
+  if (site->milliTokens < 1000) return false;
+  site->milliTokens -= 1000;
+  return true;
+}
+
+static LogSlot_t* claimSlot(uint32_t* position) {
+  uint32_t pos = __atomic_load_n(&logHead, __ATOMIC_RELAXED);
+  for (;;) {
+    LogSlot_t* slot = &logRing[pos & (LOG_RING_SLOTS - 1)];
+    uint32_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+    int32_t diff = (int32_t)(seq - pos);
+    if (diff == 0) {
+      if (__atomic_compare_exchange_n(&logHead, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        *position = pos;
+        return slot;
+      }
+    } else if (diff < 0) {
+      return nullptr;               // Oldest slot not drained yet: full
+    } else {
+      pos = __atomic_load_n(&logHead, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+static void appendSuppressed(char* text, unsigned long count) {
+  size_t len = strlen(text);
+  if (len < LOG_MESSAGE_LENGTH - 1) {
+    snprintf(text + len, LOG_MESSAGE_LENGTH - len, " (+%lu suppressed)", count);
+  }
+}
+
+// === LOGGING ===
+
+void logWrite(uint8_t module, uint8_t level, LogSite_t* site, const char* format, ...) {
+  if (module >= LOG_MODULE_COUNT) module = LOG_MODULE_SYSTEM;
+
+  if (site != nullptr && !takeSiteToken(site)) {
+    site->suppressed++;
+    countStat(&moduleStats[module].suppressed);
+    return;
+  }
+  unsigned long suppressed = 0;
+  if (site != nullptr) {
+    suppressed = site->suppressed;
+    site->suppressed = 0;
+  }
+
+  va_list args;
+  if (!logSinkReady) {
+    char text[LOG_MESSAGE_LENGTH];
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (suppressed > 0) appendSuppressed(text, suppressed);
+    Serial.println(text);
+    return;
+  }
+
+  uint32_t pos;
+  LogSlot_t* slot = claimSlot(&pos);
+  if (slot == nullptr) {
+    countStat(&moduleStats[module].dropped);
+    if (site != nullptr) site->suppressed += suppressed;   // Report with the next one
+    return;
+  }
+
+  slot->module = module;
+  slot->level = level;
+  slot->timestamp = millis();
+  va_start(args, format);
+  vsnprintf(slot->text, LOG_MESSAGE_LENGTH, format, args);
+  va_end(args);
+  if (suppressed > 0) appendSuppressed(slot->text, suppressed);
+  __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+  countStat(&moduleStats[module].logged);
+
+  uint16_t depth = (uint16_t)(pos + 1 - logTail);
+  if (depth > sinkStats.peakDepth) sinkStats.peakDepth = depth;
+}
+
+// === DRAIN ===
+
+static uint8_t syslogSeverity(uint8_t level) {
+  switch (level) {
+    case LOG_LEVEL_ERROR: return 3;
+    case LOG_LEVEL_WARN:  return 4;
+    case LOG_LEVEL_INFO:  return 6;
+    default:              return 7;
+  }
+}
+
+static void sendSyslog(const LogSlot_t* slot, const char* host, uint16_t port) {
+  char packet[LOG_MESSAGE_LENGTH + 64];
+  int len = snprintf(packet, sizeof(packet), "<%u>%s %s: %s",
+                     16 * 8 + syslogSeverity(slot->level),    // facility local0
+                     DEVICE_NAME, moduleNames[slot->module], slot->text);
+  if (len <= 0) return;
+  if (len >= (int)sizeof(packet)) len = sizeof(packet) - 1;
+  // Drop the trailing newline kept for Serial
+  while (len > 0 && (packet[len - 1] == '\n' || packet[len - 1] == '\r')) len--;
+
+  if (syslogUdp.beginPacket(host, port) &&
+      syslogUdp.write((const uint8_t*)packet, len) == (size_t)len &&
+      syslogUdp.endPacket()) {
+    sinkStats.syslogSent++;
+  } else {
+    sinkStats.syslogErrors++;
+  }
+}
+
+uint16_t drainLogSink(uint16_t maxMessages) {
+  char host[sizeof(syslogHost)];
+  uint16_t port;
+  portENTER_CRITICAL(&syslogMux);
+  memcpy(host, syslogHost, sizeof(host));
+  port = syslogPort;
+  portEXIT_CRITICAL(&syslogMux);
+  bool syslog = host[0] != '\0' && WiFi.status() == WL_CONNECTED;
+
+  uint16_t drained = 0;
+  while (drained < maxMessages) {
+    LogSlot_t* slot = &logRing[logTail & (LOG_RING_SLOTS - 1)];
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != logTail + 1) break;
+
+    size_t len = strlen(slot->text);
+    Serial.write((const uint8_t*)slot->text, len);
+    if (len == 0 || slot->text[len - 1] != '\n') Serial.write('\n');
+    if (syslog) sendSyslog(slot, host, port);
+
+    __atomic_store_n(&slot->sequence, logTail + LOG_RING_SLOTS, __ATOMIC_RELEASE);
+    logTail++;
+    drained++;
+  }
+  sinkStats.drained += drained;
+  return drained;
+}
+
+static void logDrainTask(void* parameter) {
+  for (;;) {
+    drainLogSink(LOG_RING_SLOTS);
+    vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
+  }
+}
+
+bool initLogSink() {
+  if (logSinkReady) return true;
+
+  for (uint32_t i = 0; i < LOG_RING_SLOTS; i++) {
+    logRing[i].sequence = i;
+  }
+  logHead = 0;
+  logTail = 0;
+  memset(moduleStats, 0, sizeof(moduleStats));
+  memset(&sinkStats, 0, sizeof(sinkStats));
+
+  if (xTaskCreatePinnedToCore(logDrainTask, "log_drain", LOG_DRAIN_TASK_STACK_SIZE, nullptr,
+                              LOG_DRAIN_TASK_PRIORITY, &drainTask, LOG_DRAIN_TASK_CORE) != pdPASS) {
+    Serial.println("❌ Log drain task could not be created - logging stays synchronous");
+    drainTask = nullptr;
+    return false;
+  }
+  logSinkReady = true;
+  Serial.printf("📝 Log sink: %d x %d byte ring, %d msg/s per site (burst %d)\n",
+                LOG_RING_SLOTS, LOG_MESSAGE_LENGTH, LOG_SITE_RATE_PER_S, LOG_SITE_BURST);
+  return true;
+}
+
+// === LEVEL CONTROL ===
+
+void setLogLevel(uint8_t module, uint8_t level) {
+  if (module >= LOG_MODULE_COUNT || level > LOG_LEVEL_DEBUG) return;
+  logModuleLevels[module] = level;
+}
+
+uint8_t getLogLevel(uint8_t module) {
+  return module < LOG_MODULE_COUNT ? logModuleLevels[module] : LOG_LEVEL_NONE;
+}
+
+void setAllLogLevels(uint8_t level) {
+  for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++) setLogLevel(i, level);
+}
+
+const char* getLogModuleName(uint8_t module) {
+  return module < LOG_MODULE_COUNT ? moduleNames[module] : "unknown";
+}
+
+const char* getLogLevelName(uint8_t level) {
+  return level <= LOG_LEVEL_DEBUG ? levelNames[level] : "unknown";
+}
+
+int findLogModule(const char* name) {
+  if (name == nullptr) return -1;
+  for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++) {
+    if (strcasecmp(name, moduleNames[i]) == 0) return i;
+  }
+  return -1;
+}
+
+int findLogLevel(const char* name) {
+  if (name == nullptr) return -1;
+  for (uint8_t i = 0; i <= LOG_LEVEL_DEBUG; i++) {
+    if (strcasecmp(name, levelNames[i]) == 0) return i;
+  }
+  return -1;
+}
+
+// === SYSLOG ===
+
+bool setLogSyslogTarget(const char* host, uint16_t port) {
+  if (host != nullptr && strlen(host) >= sizeof(syslogHost)) return false;
+  portENTER_CRITICAL(&syslogMux);
+  if (host == nullptr) {
+    syslogHost[0] = '\0';
+  } else {
+    strcpy(syslogHost, host);
+  }
+  syslogPort = port != 0 ? port : LOG_SYSLOG_DEFAULT_PORT;
+  portEXIT_CRITICAL(&syslogMux);
+  return true;
+}
+
+const char* getLogSyslogHost() {
+  return syslogHost;
+}
+
+uint16_t getLogSyslogPort() {
+  return syslogPort;
+}
+
+// === STATISTICS ===
+
+const LogModuleStats_t* getLogModuleStats(uint8_t module) {
+  return module < LOG_MODULE_COUNT ? &moduleStats[module] : nullptr;
+}
+
+const LogSinkStats_t* getLogSinkStats() {
+  return &sinkStats;
+}
+
+uint16_t getLogRingDepth() {
+  return (uint16_t)(__atomic_load_n(&logHead, __ATOMIC_RELAXED) - logTail);
+}
+
+void printLogSinkStatus() {
+  Serial.println("=== LOG SINK ===");
+  Serial.printf("Ring: %u/%d in use (peak %u), %lu drained, drain task %s\n",
+                getLogRingDepth(), LOG_RING_SLOTS, sinkStats.peakDepth, sinkStats.drained,
+                drainTask != nullptr ? "running" : "not running");
+  if (syslogHost[0] != '\0') {
+    Serial.printf("Syslog: %s:%u, %lu sent, %lu errors\n",
+                  syslogHost, syslogPort, sinkStats.syslogSent, sinkStats.syslogErrors);
+  } else {
+    Serial.println("Syslog: off");
+  }
+  for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++) {
+    const LogModuleStats_t* s = &moduleStats[i];
+    Serial.printf("  %-13s %-5s logged %lu, suppressed %lu, dropped %lu\n",
+                  moduleNames[i], levelNames[logModuleLevels[i]],
+                  s->logged, s->suppressed, s->dropped);
+  }
+}
@@ -10,12 +10,27 @@
 //
 // 📋 MODULE INFO:
 //    Module: Main Application Entry Point
-//    Version: v4.0.2
+//    Version: v4.1.6
 //    Created: 13.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.1.6 - 18.10.2026 - Configuration web server started at boot when heap headroom allows,
+//                          free heap / largest block logged after init
+//    v4.1.5 - 18.10.2026 - BMS limits stale sweep runs every loop pass (250 ms internal rate)
+//    v4.1.4 - 18.10.2026 - TRIO HP startup/shutdown sequences ticked every loop pass
+//    v4.1.3 - 18.10.2026 - Virtual aggregated BMS emitter served from the CAN zone of the loop
+//    v4.1.2 - 18.10.2026 - DBC signal table loaded at boot, BMS table checked against the parsers
+//    v4.1.1 - 18.10.2026 - CAN mapping rules loaded from LittleFS at boot
+//    v4.1.0 - 18.10.2026 - Idle wait wakes on CAN RX instead of delay(1), CAN backlog served without sleeping
+//    v4.0.9 - 18.10.2026 - Asynchronous log sink started first, its status in diagnostics
+//    v4.0.8 - 18.10.2026 - Loop passes and subsystems timed in profiling zones, stall report in diagnostics
+//    v4.0.7 - 18.10.2026 - Status LED engine replaces heartbeat blinks, loop latency percentiles per heartbeat
+//    v4.0.6 - 18.10.2026 - Soak statistics sampler started, loop latency recorded
+//    v4.0.5 - 18.10.2026 - Heap fragmentation sampling, pool/heap report in diagnostics
+//    v4.0.4 - 18.10.2026 - Event bus initialised first, fleet limits consume frame events every loop
+//    v4.0.3 - 18.10.2026 - BMS limits aggregated per frame instead of rotating node poll
 //    v4.0.2 - 13.08.2025 - CAN Handler removed, consolidated into bms_protocol
 //    v4.0.1 - 13.08.2025 - Module consolidation and optimization
 //    v4.0.0 - 13.08.2025 - First stable modular release
@@ -61,7 +76,17 @@
 #include "modbus_tcp.h"
 #include "bms_data.h"
 #include "bms_protocol.h"  // 🔥 ZAWIERA: setupCAN, processCAN, isCANHealthy + parsery
+#include "can_bus.h"
 #include "utils.h"
+#include "event_bus.h"
+#include "mem_pool.h"
+#include "statistics.h"
+#include "status_led.h"
+#include "stall_monitor.h"
+#include "log_sink.h"
+#include "can_rules.h"
+#include "can_signals.h"
+#include "virtual_bms.h"
 #include "web_server.h"
 #include "trio_hp_manager.h"
 #include "trio_hp_monitor.h"
@@ -75,6 +100,11 @@ unsigned long systemStartTime = 0;
 unsigned long lastHeartbeat = 0;
 unsigned long lastDiagnostics = 0;
 unsigned long lastStatusCheck = 0;
+unsigned long lastStatusLEDUpdate = 0;
+
+// Loop latency histogram at the previous heartbeat, for per-interval percentiles
+static uint32_t heartbeatLoopHistogram[STATS_LATENCY_BUCKETS];
+static unsigned long lastHeartbeatDurationUs = 0;
 
 // === TRIO HP VARIABLES ===
 unsigned long lastTrioHPCheck = 0;
@@ -94,12 +124,15 @@ void processSystemLoop();
 void checkSystemHealth();
 void performSystemDiagnostics();
 void handleSystemHeartbeat();
+void updateStatusLED();
+void printLoopLatencySinceHeartbeat();
 void handleSystemState();
 void emergencyActions();
 void printStartupBanner();
 void printSystemStatus();
 bool setupTrioHPPhase3();
 void processTrioHPPhase3();
+void processTrioHPSequences();
 
 // === CALLBACK FUNCTIONS ===
 void onWiFiStateChange(WiFiState_t oldState, WiFiState_t newState);
@@ -158,6 +191,8 @@ void setup() {
 // === 🔥 MAIN LOOP FUNCTION ===
 void loop() {
   unsigned long now = millis();
+  unsigned long loopStart = micros();
+  stallLoopBegin();
   
   // Process main system loop
   processSystemLoop();
@@ -176,17 +211,35 @@ void loop() {
   // 🔥 ROZSZERZONY HEARTBEAT z danymi multipleksera
   if (now - lastHeartbeat >= HEARTBEAT_INTERVAL_MS) {
     lastHeartbeat = now;
+    unsigned long heartbeatStart = micros();
+    PROFILE_ZONE(PROFILE_ZONE_HEARTBEAT);
     handleSystemHeartbeat();
+    lastHeartbeatDurationUs = micros() - heartbeatStart;
+  }
+  
+  // Status LED pattern follows the system state (played by its own timer)
+  if (now - lastStatusLEDUpdate >= STATUS_LED_UPDATE_MS) {
+    lastStatusLEDUpdate = now;
+    updateStatusLED();
   }
   
   // System diagnostics
   if (now - lastDiagnostics >= DIAGNOSTICS_INTERVAL_MS) {
     lastDiagnostics = now;
+    PROFILE_ZONE(PROFILE_ZONE_DIAGNOSTICS);
     performSystemDiagnostics();
   }
   
-  // Minimal delay for optimal CAN responsiveness
-  delay(1);
+  stallLoopEnd();
+  recordLatency(LATENCY_MAIN_LOOP, micros() - loopStart);
+  
+  // Frames left by a budgeted CAN slice are served on the next pass after a yield;
+  // otherwise sleep until the MCP2515 signals a frame (at most one tick)
+  if (getCANBacklog() > 0) {
+    yield();
+  } else {
+    canBusWaitForFrame(1);
+  }
 }
 
 // === INITIALIZATION FUNCTIONS ===
@@ -234,6 +287,18 @@ bool initializeModules() {
   Serial.println("🔧 Initializing system modules...");
   bool success = true;
   
+  // Asynchronous log sink (LOG_* messages go straight to Serial until it runs)
+  initLogSink();
+  
+  // 0. Event bus (subscribers register in their init functions below)
+  initEventBus();
+  
+  // Soak statistics sampler (background task, reports on /metrics)
+  initStatistics();
+  
+  // Loop stall watchdog (zones are entered from the main loop from here on)
+  initStallMonitor();
+  
   // 1. Initialize BMS Data Manager
   Serial.print("📊 BMS Data Manager... ");
   if (initializeBMSData()) {
@@ -243,6 +308,13 @@ bool initializeModules() {
     success = false;
   }
   
+  // CAN mapping rules for third-party devices (a missing or broken file is not fatal)
+  initCANRules();
+  initCANSignals();
+  
+  // Virtual fleet BMS for upstream inverters (disabled unless configured)
+  initVirtualBMS();
+  
   // 2. Initialize WiFi Manager  
   Serial.print("📡 WiFi Manager... ");
   wifiManager.setCallbacks(onWiFiStateChange, onWiFiConnected, onWiFiDisconnected);
@@ -284,7 +356,8 @@ bool initializeModules() {
   Serial.print("📊 TRIO HP Monitor... ");
   if (initTrioHPMonitor()) {
     Serial.println("✅ OK");
-    Serial.printf("   🎯 Monitoring %d BMS nodes at 125 kbps\n", systemConfig.activeBmsNodes);
+    Serial.printf("   🎯 Monitoring %d BMS nodes at %u kbps\n", systemConfig.activeBmsNodes,
+                  getCANSpeedKbps(systemConfig.canSpeed));
     Serial.printf("   🔋 Node IDs: ");
     for (int i = 0; i < systemConfig.activeBmsNodes; i++) {
       Serial.printf("%d ", systemConfig.bmsNodeIds[i]);
@@ -317,18 +390,28 @@ bool initializeModules() {
     success = false;
   }
   
-  // 8. Initialize Web Server (TYMCZASOWO WYŁĄCZONY - memory issue)
+  // 8. Initialize Web Server (configuration pages, JSON API, /metrics)
+  // JSON and metrics renders come from the fixed arena pool; the server object and the
+  // AsyncTCP task are still heap allocated, so it starts only with headroom left
   Serial.print("🌐 Web Server... ");
-  Serial.println("⚠️ DISABLED (memory optimization)");
-  // TODO: Re-enable after fixing memory fragmentation
-  // if (configWebServer.begin()) {
-  //   Serial.println("✅ OK");
-  //   Serial.printf("   🌐 Web server running on port %d\n", WEB_SERVER_PORT);
-  //   Serial.println("   📋 Configuration interface available");
-  // } else {
-  //   Serial.println("❌ FAILED");
-  //   success = false;
-  // }
+  uint32_t freeHeap = ESP.getFreeHeap();
+  uint32_t largestBlock = ESP.getMaxAllocHeap();
+  if (freeHeap < WEB_SERVER_MIN_FREE_HEAP || largestBlock < WEB_SERVER_MIN_LARGEST_BLOCK) {
+    Serial.printf("⚠️ NOT STARTED (free %lu, largest block %lu)\n",
+                  (unsigned long)freeHeap, (unsigned long)largestBlock);
+    Serial.println("   📋 Configuration interface in CAN-triggered AP mode only");
+  } else if (configWebServer.begin()) {
+    Serial.println("✅ OK");
+    Serial.printf("   🌐 Web server running on port %d\n", WEB_SERVER_PORT);
+    Serial.println("   📋 Configuration interface and /api, /metrics available");
+  } else {
+    Serial.println("❌ FAILED");
+    success = false;
+  }
+  
+  // Boot figure with Modbus, the CAN rings and the web server up
+  Serial.printf("💾 Heap after init: free %lu B, largest block %lu B\n",
+                (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMaxAllocHeap());
   
   Serial.println();
   return success;
@@ -338,25 +421,44 @@ bool initializeModules() {
 
 void processSystemLoop() {
   // PRIORITY 1: Process CAN messages via BMS Protocol (highest priority - real-time data)
+  enterProfileZone(PROFILE_ZONE_CAN);
   processBMSProtocol();  // 🔥 ZMIANA: processCAN() → processBMSProtocol()
+  processBMSLimitEvents();  // Fleet limits follow frames 510/410 in the same iteration
+  processBMSLimitsAggregate();  // Stale pack sweep, rate limited to TRIO_HP_LIMITS_SWEEP_MS
+  processVirtualBMS();      // Fleet frames built from this iteration's aggregates
+  leaveProfileZone();
   
   // PRIORITY 2: Process TRIO HP management and monitoring
   unsigned long now = millis();
   if (now - lastTrioHPCheck >= TRIO_HP_CHECK_INTERVAL_MS) {
+    PROFILE_ZONE(PROFILE_ZONE_TRIO_HP);
     updateTrioHPManager();
     updateTrioHPMonitor();
     processTrioHPPhase3(); // Process Phase 3 controllers and limits
     lastTrioHPCheck = now;
   }
   
+  // Startup/shutdown steps advance on correlated module responses - every pass, not the 1 s gate
+  if (isStartupSequenceActive() || isShutdownSequenceActive()) {
+    PROFILE_ZONE(PROFILE_ZONE_TRIO_HP);
+    processTrioHPSequences();
+  }
+  
   // PRIORITY 3: Process WiFi management  
+  enterProfileZone(PROFILE_ZONE_WIFI);
   wifiManager.process();
+  leaveProfileZone();
   
   // PRIORITY 4: Process Modbus TCP requests
+  enterProfileZone(PROFILE_ZONE_MODBUS);
   processModbusTCP();
+  leaveProfileZone();
   
   // PRIORITY 5: Update BMS data timeouts
   checkCommunicationTimeouts();
+  
+  // PRIORITY 6: Heap fragmentation / steady-state allocation tracking
+  updateHeapMetrics();
 }
 
 // === 🔥 SYSTEM HEALTH AND MONITORING ===
@@ -415,6 +517,16 @@ void performSystemDiagnostics() {
   // 🔥 MODBUS STATISTICS
   printModbusStatistics();
   
+  // Heap and static pools
+  printMemPoolStatus();
+  printStatisticsStatus();
+  printStatusLEDStatus();
+  printStallReport();
+  printLogSinkStatus();
+  printCANRulesStatus();
+  printCANSignalsStatus();
+  printVirtualBMSStatus();
+  
   Serial.println(F("=================================="));
   Serial.println();
 }
@@ -460,11 +572,47 @@ void handleSystemHeartbeat() {
     Serial.println("   ❌ No active BMS communication detected");
   }
   
+  printLoopLatencySinceHeartbeat();
+  
   Serial.println(F("=========================================="));
   Serial.println();
+}
+
+void printLoopLatencySinceHeartbeat() {
+  uint32_t histogram[STATS_LATENCY_BUCKETS];
+  uint32_t delta[STATS_LATENCY_BUCKETS];
+  unsigned long passes = 0;
+  uint8_t worstBucket = 0;
+  
+  getLatencyHistogram(LATENCY_MAIN_LOOP, histogram);
+  for (uint8_t b = 0; b < STATS_LATENCY_BUCKETS; b++) {
+    delta[b] = histogram[b] - heartbeatLoopHistogram[b];
+    passes += delta[b];
+    if (delta[b] > 0) worstBucket = b;
+    heartbeatLoopHistogram[b] = histogram[b];
+  }
   
-  // Visual heartbeat blink (proportional to active BMS count)
-  blinkLED(max(1, activeBMSCount), 200);
+  if (passes == 0) return;
+  Serial.printf("⏱️ Loop latency (%lu passes): p50 %.0f us, p99 %.0f us, p99.9 %.0f us, max < %.0f us\n",
+                passes, getLatencyPercentile(delta, 0.50f), getLatencyPercentile(delta, 0.99f),
+                getLatencyPercentile(delta, 0.999f), getLatencyBucketUpperUs(worstBucket));
+  Serial.printf("⏱️ Previous heartbeat tick: %lu us\n", lastHeartbeatDurationUs);
+}
+
+void updateStatusLED() {
+  StatusLedState_t state;
+  state.packCount = getActiveBMSCount();
+  state.systemError = (currentSystemState == SYSTEM_STATE_ERROR);
+  state.apMode = wifiManager.isAPModeActive() || wifiManager.isTriggeredAPModeActive();
+  state.trio = STATUS_LED_TRIO_NONE;
+  if (isTrioHPManagerInitialized()) {
+    if (getActiveModuleCount() > 0 && calculateSystemHealth() < 50) {
+      state.trio = STATUS_LED_TRIO_FAULT;
+    } else {
+      state.trio = isSystemOperational() ? STATUS_LED_TRIO_OPERATIONAL : STATUS_LED_TRIO_OFF;
+    }
+  }
+  setStatusLEDState(&state);
 }
 
 // === CALLBACK FUNCTIONS ===
@@ -629,22 +777,15 @@ bool setupTrioHPPhase3() {
 }
 
 void processTrioHPPhase3() {
-  static uint8_t currentBMSNode = 0;
-  
-  // Update BMS limits from rotating BMS nodes
-  currentBMSNode = (currentBMSNode + 1) % systemConfig.activeBmsNodes;
-  if (currentBMSNode < systemConfig.activeBmsNodes) {
-    uint8_t nodeId = systemConfig.bmsNodeIds[currentBMSNode];
-    updateBMSLimits(nodeId);
-  }
-  
   // Update digital inputs (E-STOP + AC contactor) from all BMS
   updateDigitalInputs();
   
   // Process PID controllers (they have internal timing - 3s intervals)
   processTrioHPControllers();
   
-  // Process startup/shutdown sequences if active
+}
+
+void processTrioHPSequences() {
   if (isStartupSequenceActive()) {
     processStartupSequenceStep();
   }
@@ -0,0 +1,198 @@
+// =====================================================================
+// === mem_pool.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Static Memory Pools Implementation
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Fixed-block pools, text arenas, heap fragmentation tracking
+//
+// 🎯 DEPENDENCIES:
+//    Internal: mem_pool.h
+//    External: Arduino.h, esp_heap_caps.h
+//
+// =====================================================================
+
+#include "mem_pool.h"
+#include <stdarg.h>
+#include <esp_heap_caps.h>
+
+// === GLOBAL VARIABLES ===
+static MemPool_t* registeredPools[MEM_POOL_MAX_POOLS];
+static uint8_t registeredPoolCount = 0;
+static HeapMetrics_t heapMetrics;
+static unsigned long lastHeapSample = 0;
+
+// === POOL FUNCTIONS ===
+
+void memPoolInit(MemPool_t* pool) {
+  if (pool == nullptr) return;
+  if (pool->blockCount > MEM_POOL_MAX_BLOCKS) pool->blockCount = MEM_POOL_MAX_BLOCKS;
+
+  pool->freeMask = (pool->blockCount == 32) ? 0xFFFFFFFFUL : ((1UL << pool->blockCount) - 1);
+  pool->inUse = 0;
+
+  for (uint8_t i = 0; i < registeredPoolCount; i++) {
+    if (registeredPools[i] == pool) return;
+  }
+  if (registeredPoolCount < MEM_POOL_MAX_POOLS) {
+    registeredPools[registeredPoolCount++] = pool;
+  }
+  Serial.printf("🧱 Pool '%s': %u x %u bytes\n", pool->name, pool->blockCount, pool->blockSize);
+}
+
+void* memPoolAlloc(MemPool_t* pool) {
+  if (pool == nullptr) return nullptr;
+  if (pool->freeMask == 0) {
+    pool->failures++;
+    return nullptr;
+  }
+
+  uint8_t index = __builtin_ctz(pool->freeMask);
+  pool->freeMask &= ~(1UL << index);
+  pool->inUse++;
+  pool->allocations++;
+  if (pool->inUse > pool->peakInUse) pool->peakInUse = pool->inUse;
+  return pool->storage + (size_t)index * pool->blockSize;
+}
+
+void memPoolFree(MemPool_t* pool, void* block) {
+  if (pool == nullptr || block == nullptr) return;
+
+  uint8_t* p = (uint8_t*)block;
+  if (p < pool->storage) return;
+  size_t offset = p - pool->storage;
+  if (offset % pool->blockSize != 0) return;
+  size_t index = offset / pool->blockSize;
+  if (index >= pool->blockCount) return;
+
+  uint32_t bit = 1UL << index;
+  if (pool->freeMask & bit) return;  // Double free
+  pool->freeMask |= bit;
+  pool->inUse--;
+}
+
+// === ARENA FUNCTIONS ===
+
+void arenaInit(MemArena_t* arena, void* buffer, size_t capacity) {
+  arena->buffer = (char*)buffer;
+  arena->capacity = capacity;
+  arenaReset(arena);
+}
+
+void arenaReset(MemArena_t* arena) {
+  arena->used = 0;
+  arena->overflow = false;
+  if (arena->buffer != nullptr && arena->capacity > 0) arena->buffer[0] = '\0';
+}
+
+bool arenaAppend(MemArena_t* arena, const char* text) {
+  if (arena->overflow || text == nullptr) return false;
+  size_t length = strlen(text);
+  if (arena->used + length + 1 > arena->capacity) {
+    arena->overflow = true;
+    return false;
+  }
+  memcpy(arena->buffer + arena->used, text, length + 1);
+  arena->used += length;
+  return true;
+}
+
+bool arenaAppendf(MemArena_t* arena, const char* format, ...) {
+  if (arena->overflow) return false;
+  size_t space = arena->capacity - arena->used;
+
+  va_list args;
+  va_start(args, format);
+  int written = vsnprintf(arena->buffer + arena->used, space, format, args);
+  va_end(args);
+
+  if (written < 0 || (size_t)written >= space) {
+    arena->buffer[arena->used] = '\0';  // Drop the partial piece
+    arena->overflow = true;
+    return false;
+  }
+  arena->used += written;
+  return true;
+}
+
+// === HEAP METRICS ===
+
+void updateHeapMetrics() {
+  unsigned long now = millis();
+  if (heapMetrics.samples > 0 && now - lastHeapSample < HEAP_METRICS_INTERVAL_MS) return;
+  lastHeapSample = now;
+
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+
+  HeapMetrics_t* m = &heapMetrics;
+  m->freeBytes = info.total_free_bytes;
+  m->largestFreeBlock = info.largest_free_block;
+  m->allocatedBlocks = info.allocated_blocks;
+  m->fragmentation = m->freeBytes > 0 ? 100.0f * (1.0f - (float)m->largestFreeBlock / m->freeBytes) : 0.0f;
+
+  if (m->samples == 0 || m->freeBytes < m->minFreeBytes) m->minFreeBytes = m->freeBytes;
+  if (m->samples == 0 || m->largestFreeBlock < m->minLargestFreeBlock) m->minLargestFreeBlock = m->largestFreeBlock;
+  if (m->fragmentation > m->peakFragmentation) m->peakFragmentation = m->fragmentation;
+  m->samples++;
+
+  if (!m->steadyState) {
+    if (now >= HEAP_STEADY_STATE_AFTER_MS) {
+      m->steadyState = true;
+      m->baselineBlocks = m->allocatedBlocks;
+    }
+    return;
+  }
+
+  // New high-water mark of live blocks: something allocated and kept it
+  if (m->allocatedBlocks > m->baselineBlocks) {
+    m->steadyStateAllocations += m->allocatedBlocks - m->baselineBlocks;
+    m->baselineBlocks = m->allocatedBlocks;
+    Serial.printf("⚠️ Heap: %lu blocks allocated past steady state (free %lu, largest %lu)\n",
+                  m->steadyStateAllocations, (unsigned long)m->freeBytes, (unsigned long)m->largestFreeBlock);
+  }
+}
+
+const HeapMetrics_t* getHeapMetrics() {
+  return &heapMetrics;
+}
+
+// === STATISTICS ===
+
+uint8_t getMemPoolCount() {
+  return registeredPoolCount;
+}
+
+const MemPool_t* getMemPool(uint8_t index) {
+  return index < registeredPoolCount ? registeredPools[index] : nullptr;
+}
+
+void printMemPoolStatus() {
+  const HeapMetrics_t* m = &heapMetrics;
+  Serial.println("=== MEMORY ===");
+  Serial.printf("Heap: free %lu (min %lu), largest block %lu (min %lu)\n",
+                (unsigned long)m->freeBytes, (unsigned long)m->minFreeBytes,
+                (unsigned long)m->largestFreeBlock, (unsigned long)m->minLargestFreeBlock);
+  Serial.printf("Fragmentation: %.1f%% (peak %.1f%%), allocated blocks %lu\n",
+                m->fragmentation, m->peakFragmentation, (unsigned long)m->allocatedBlocks);
+  Serial.printf("Steady-state allocations: %lu%s\n", m->steadyStateAllocations,
+                m->steadyState ? "" : " (warming up)");
+  for (uint8_t i = 0; i < registeredPoolCount; i++) {
+    const MemPool_t* p = registeredPools[i];
+    Serial.printf("  %-8s %2u x %5u B: in use %u (peak %u), %lu allocs, %lu exhausted\n",
+                  p->name, p->blockCount, p->blockSize, p->inUse, p->peakInUse,
+                  p->allocations, p->failures);
+  }
+}
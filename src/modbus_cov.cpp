@@ -0,0 +1,298 @@
+// =====================================================================
+// === modbus_cov.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Modbus Change-of-Value Subscriptions Implementation
+//    Version: v1.0.1
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.1 - 18.10.2026 - SELECT kept per Modbus TCP connection instead of one for all clients
+//    v1.0.0 - 18.10.2026 - Range subscriptions with deadband, "changed since N" window
+//
+// 🎯 DEPENDENCIES:
+//    Internal: modbus_cov.h, bms_data.h (holding registers)
+//    External: Arduino.h
+//
+// 📝 DESCRIPTION:
+//    Each subscribed register keeps the value last counted as a change and
+//    the sequence number of that change; the bitmap for a SINCE value is
+//    built when it is read. Sequences are 16-bit and compared as signed
+//    differences, so the scan pulls every entry up to at most
+//    MODBUS_COV_HISTORY behind the current sequence, and an older SINCE is
+//    answered with a resync (all bits set). Scan and window both run in
+//    the main loop task.
+//
+// =====================================================================
+
+#include "modbus_cov.h"
+#include "bms_data.h"
+#include "modbus_tcp.h"
+
+// === SUBSCRIPTION STATE ===
+typedef struct {
+  ModbusCOVSubscription_t info;
+  uint16_t reference[MODBUS_COV_MAX_RANGE];     // Value at the last counted change
+  uint16_t changedSeq[MODBUS_COV_MAX_RANGE];    // Sequence of the last counted change
+} ModbusCOVSlot_t;
+
+// === GLOBAL VARIABLES ===
+static ModbusCOVSlot_t covSlots[MODBUS_COV_MAX_SUBSCRIPTIONS];
+static ModbusCOVStats_t covStats;
+static unsigned long lastCovScan = 0;
+
+// Window selection per transport slot; a new connection in the slot starts at 0
+typedef struct {
+  uint32_t session;
+  uint8_t selected;
+} ModbusCOVClient_t;
+static ModbusCOVClient_t covClients[MODBUS_TCP_MAX_CLIENTS];
+
+// === HELPERS ===
+
+// Distance on the 16-bit circle, so signed registers crossing zero count as small steps
+static uint16_t registerDistance(uint16_t a, uint16_t b) {
+  uint16_t d = a - b;
+  return d > 0x8000 ? (uint16_t)(0x10000 - d) : d;
+}
+
+static bool isSinceUsable(const ModbusCOVSubscription_t* s) {
+  uint16_t lag = s->sequence - s->since;
+  return lag <= MODBUS_COV_HISTORY;
+}
+
+static bool isChangedSince(const ModbusCOVSlot_t* slot, uint16_t offset) {
+  if (!isSinceUsable(&slot->info)) return true;
+  return (int16_t)(slot->changedSeq[offset] - slot->info.since) > 0;
+}
+
+static void scanSubscription(ModbusCOVSlot_t* slot) {
+  ModbusCOVSubscription_t* s = &slot->info;
+  uint16_t next = s->sequence + 1;
+  uint16_t oldest = s->sequence - MODBUS_COV_HISTORY;
+  bool changed = false;
+
+  for (uint16_t i = 0; i < s->count; i++) {
+    uint16_t value = holdingRegisters[s->start + i];
+    if (registerDistance(value, slot->reference[i]) > s->deadband) {
+      slot->reference[i] = value;
+      slot->changedSeq[i] = next;
+      s->changes++;
+      covStats.changes++;
+      changed = true;
+    } else if ((uint16_t)(s->sequence - slot->changedSeq[i]) > MODBUS_COV_HISTORY) {
+      slot->changedSeq[i] = oldest;
+    }
+  }
+  if (changed) s->sequence = next;
+}
+
+// === SUBSCRIPTION FUNCTIONS ===
+
+void initModbusCOV() {
+  memset(covSlots, 0, sizeof(covSlots));
+  memset(&covStats, 0, sizeof(covStats));
+  memset(covClients, 0, sizeof(covClients));
+  Serial.printf("🔔 Modbus COV: %d subscriptions x %d registers, window %d-%d\n",
+                MODBUS_COV_MAX_SUBSCRIPTIONS, MODBUS_COV_MAX_RANGE, MODBUS_COV_START_REGISTER,
+                MODBUS_COV_START_REGISTER + MODBUS_COV_MODBUS_REGISTERS - 1);
+}
+
+void processModbusCOV() {
+  unsigned long now = millis();
+  if (now - lastCovScan < MODBUS_COV_SCAN_MS) return;
+  lastCovScan = now;
+
+  unsigned long scanStart = micros();
+  for (uint8_t i = 0; i < MODBUS_COV_MAX_SUBSCRIPTIONS; i++) {
+    ModbusCOVSlot_t* slot = &covSlots[i];
+    if (!slot->info.active) continue;
+
+    if (now - slot->info.lastAccess > MODBUS_COV_LEASE_MS) {
+      Serial.printf("🔔 COV subscription %d (%u+%u) expired\n", i, slot->info.start, slot->info.count);
+      releaseModbusCOV(i);
+      covStats.expired++;
+      continue;
+    }
+    scanSubscription(slot);
+  }
+  covStats.scans++;
+  covStats.lastScanUs = micros() - scanStart;
+  if (covStats.lastScanUs > covStats.maxScanUs) covStats.maxScanUs = covStats.lastScanUs;
+}
+
+bool subscribeModbusCOV(uint8_t slotIndex, uint16_t start, uint16_t count, uint16_t deadband) {
+  if (slotIndex >= MODBUS_COV_MAX_SUBSCRIPTIONS) return false;
+  if (count == 0 || count > MODBUS_COV_MAX_RANGE) return false;
+  if ((uint32_t)start + count > MODBUS_MAX_HOLDING_REGISTERS) return false;
+
+  ModbusCOVSlot_t* slot = &covSlots[slotIndex];
+  ModbusCOVSubscription_t* s = &slot->info;
+  s->active = true;
+  s->start = start;
+  s->count = count;
+  s->deadband = deadband;
+  s->sequence = 1;                  // Everything changed relative to SINCE = 0
+  s->since = 0;
+  s->lastAccess = millis();
+  s->changes = 0;
+  s->reads = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    slot->reference[i] = holdingRegisters[start + i];
+    slot->changedSeq[i] = 1;
+  }
+  Serial.printf("🔔 COV subscription %d: %u+%u, deadband %u\n", slotIndex, start, count, deadband);
+  return true;
+}
+
+void releaseModbusCOV(uint8_t slotIndex) {
+  if (slotIndex >= MODBUS_COV_MAX_SUBSCRIPTIONS) return;
+  covSlots[slotIndex].info.active = false;
+  covSlots[slotIndex].info.count = 0;
+}
+
+// === STATISTICS ===
+
+bool getModbusCOVSubscription(uint8_t slotIndex, ModbusCOVSubscription_t* out) {
+  if (slotIndex >= MODBUS_COV_MAX_SUBSCRIPTIONS || out == nullptr) return false;
+  *out = covSlots[slotIndex].info;
+  return true;
+}
+
+const ModbusCOVStats_t* getModbusCOVStats() {
+  return &covStats;
+}
+
+void printModbusCOVStatus() {
+  Serial.println("=== MODBUS COV ===");
+  Serial.printf("Scans: %lu (last %lu us, max %lu us), changes %lu, expired %lu\n",
+                covStats.scans, covStats.lastScanUs, covStats.maxScanUs,
+                covStats.changes, covStats.expired);
+  for (uint8_t i = 0; i < MODBUS_COV_MAX_SUBSCRIPTIONS; i++) {
+    const ModbusCOVSubscription_t* s = &covSlots[i].info;
+    if (!s->active) continue;
+    Serial.printf("  #%u %4u+%-3u deadband %u: seq %u (client %u), %lu changes, %lu reads, idle %lus\n",
+                  i, s->start, s->count, s->deadband, s->sequence, s->since,
+                  s->changes, s->reads, (millis() - s->lastAccess) / 1000);
+  }
+}
+
+// === MODBUS WINDOW ===
+
+bool isModbusCOVRegisterRange(uint16_t startAddress, uint16_t count) {
+  uint32_t end = (uint32_t)startAddress + count;
+  return count > 0 &&
+         startAddress >= MODBUS_COV_START_REGISTER &&
+         end <= MODBUS_COV_START_REGISTER + MODBUS_COV_MODBUS_REGISTERS;
+}
+
+void setModbusCOVClientSession(uint8_t client, uint32_t session) {
+  if (client >= MODBUS_TCP_MAX_CLIENTS || covClients[client].session == session) return;
+  covClients[client].session = session;
+  covClients[client].selected = 0;
+}
+
+bool readModbusCOVRegister(uint8_t client, uint16_t address, uint16_t* value) {
+  if (value == nullptr || client >= MODBUS_TCP_MAX_CLIENTS || !isModbusCOVRegisterRange(address, 1)) return false;
+  uint16_t offset = address - MODBUS_COV_START_REGISTER;
+  uint8_t selected = covClients[client].selected;
+  ModbusCOVSlot_t* slot = &covSlots[selected];
+  ModbusCOVSubscription_t* s = &slot->info;
+  if (s->active) s->lastAccess = millis();
+
+  switch (offset) {
+    case MODBUS_COV_REG_SELECT:   *value = selected; return true;
+    case MODBUS_COV_REG_START:    *value = s->start; return true;
+    case MODBUS_COV_REG_COUNT:    *value = s->active ? s->count : 0; return true;
+    case MODBUS_COV_REG_DEADBAND: *value = s->deadband; return true;
+    case MODBUS_COV_REG_SINCE:    *value = s->since; return true;
+    case MODBUS_COV_REG_SEQUENCE: *value = s->sequence; return true;
+    case MODBUS_COV_REG_RESERVED: *value = 0; return true;
+    default: break;
+  }
+
+  if (!s->active) {
+    *value = (offset == MODBUS_COV_REG_FIRST_CHANGED) ? 0xFFFF : 0;
+    return true;
+  }
+
+  switch (offset) {
+    case MODBUS_COV_REG_CHANGED: {
+      uint16_t changed = 0;
+      for (uint16_t i = 0; i < s->count; i++) {
+        if (isChangedSince(slot, i)) changed++;
+      }
+      *value = changed;
+      return true;
+    }
+    case MODBUS_COV_REG_FIRST_CHANGED:
+      *value = 0xFFFF;
+      for (uint16_t i = 0; i < s->count; i++) {
+        if (isChangedSince(slot, i)) {
+          *value = i;
+          break;
+        }
+      }
+      return true;
+    case MODBUS_COV_REG_FLAGS:
+      *value = MODBUS_COV_FLAG_ACTIVE | (isSinceUsable(s) ? 0 : MODBUS_COV_FLAG_RESYNC);
+      return true;
+    default:
+      break;
+  }
+
+  // Change bitmap
+  uint16_t first = (offset - MODBUS_COV_REG_BITMAP) * 16;
+  uint16_t bits = 0;
+  for (uint16_t b = 0; b < 16 && first + b < s->count; b++) {
+    if (isChangedSince(slot, first + b)) bits |= (1U << b);
+  }
+  if (first == 0) s->reads++;
+  *value = bits;
+  return true;
+}
+
+bool writeModbusCOVRegister(uint8_t client, uint16_t address, uint16_t value) {
+  if (client >= MODBUS_TCP_MAX_CLIENTS || !isModbusCOVRegisterRange(address, 1)) return false;
+  uint8_t selected = covClients[client].selected;
+  ModbusCOVSubscription_t* s = &covSlots[selected].info;
+  if (s->active) s->lastAccess = millis();
+
+  switch (address - MODBUS_COV_START_REGISTER) {
+    case MODBUS_COV_REG_SELECT:
+      if (value >= MODBUS_COV_MAX_SUBSCRIPTIONS) return false;
+      covClients[client].selected = value;
+      return true;
+    case MODBUS_COV_REG_START:
+      if (!s->active) {
+        if (value >= MODBUS_MAX_HOLDING_REGISTERS) return false;
+        s->start = value;
+        return true;
+      }
+      return subscribeModbusCOV(selected, value, s->count, s->deadband);
+    case MODBUS_COV_REG_COUNT:
+      if (value == 0) {
+        releaseModbusCOV(selected);
+        return true;
+      }
+      return subscribeModbusCOV(selected, s->start, value, s->deadband);
+    case MODBUS_COV_REG_DEADBAND:
+      s->deadband = value;          // Applies from the next scan, no resync
+      return true;
+    case MODBUS_COV_REG_SINCE:
+      if (!s->active) return false;
+      s->since = value;
+      return true;
+    default:
+      return false;                 // Status and bitmap are read-only
+  }
+}
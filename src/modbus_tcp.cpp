@@ -10,19 +10,36 @@
 //
 // 📋 MODULE INFO:
 //    Module: Modbus TCP Server Implementation
-//    Version: v4.0.2
+//    Version: v4.1.6
 //    Created: 13.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.1.6 - 18.10.2026 - Rejected TRIO HP data register writes log the value
+//    v4.1.5 - 18.10.2026 - FC16 over the TRIO HP parameter window applied all or nothing
+//    v4.1.4 - 18.10.2026 - Register table lock around block stores and the FC03 copy; fast-path reads in the
+//                          statistics; COV selection per connection
+//    v4.1.3 - 18.10.2026 - SCADA-visible since v4.1.1: Base+0/1 (mV/mA), +2 (0.01kWh), +20/21/40/41 (0.1mV),
+//                          +60/61 (mA) read 1 LSB higher where the float path truncated (e.g. 0.29 V -> 290 mV, was 289);
+//                          SOC, SOH, DCIR unchanged; counts pinned in test/test_modbus_fixed_point
+//    v4.1.2 - 18.10.2026 - lwIP raw API transport (modbus_transport): FC03 served in the receive callback, rest from the main loop
+//    v4.1.1 - 18.10.2026 - Fixed-point BMS registers encoded from raw frame values (integer, no float round trip)
+//    v4.1.0 - 18.10.2026 - Change-of-value subscription window (5400+)
+//    v4.0.9 - 18.10.2026 - Per-field quality codes (Base+140-157) and frame ages (Base+160-169)
+//    v4.0.8 - 18.10.2026 - Request latency recorded for soak statistics
+//    v4.0.7 - 18.10.2026 - Request/response ADUs from a static pool instead of stack/new[]
+//    v4.0.6 - 18.10.2026 - BMS registers refreshed from frame events; writes published on the event bus
+//    v4.0.5 - 18.10.2026 - BMS SDO request/result window (5300+)
+//    v4.0.4 - 18.10.2026 - Per-BMS limit forecast registers (Base+125-133)
+//    v4.0.3 - 18.10.2026 - TRIO HP parameter window (5200+) served from trio_hp_params table
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v4.0.1 - 13.08.2025 - Fixed function definitions and removed default arguments from implementation
 //    v4.0.0 - 13.08.2025 - Initial Modbus TCP server implementation
 //
 // 🎯 DEPENDENCIES:
 //    Internal: modbus_tcp.h, bms_data.h for register mapping
-//    External: WiFi.h, AsyncTCP for network operations
+//    External: lwIP raw TCP API (through modbus_transport)
 //
 // 📝 DESCRIPTION:
 //    Complete Modbus TCP server implementation providing standard protocol compliance
@@ -34,7 +51,7 @@
 // 🔧 CONFIGURATION:
 //    - Server Port: 502 (standard Modbus TCP)
 //    - Register Count: 3200 (200 per BMS module)
-//    - Client Limits: Up to 8 concurrent connections
+//    - Client Limits: MODBUS_TCP_MAX_CLIENTS concurrent connections
 //    - Response Timeout: 1000ms configurable
 //    - Data Mapping: Real-time from BMS data structures
 //
@@ -42,15 +59,15 @@
 //    - Write operations limited to configuration registers only
 //
 // 🧪 TESTING STATUS:
-//    Unit Tests: NOT_TESTED
+//    Unit Tests: host tests test_modbus_transport (fake lwIP), test_modbus_fixed_point
 //    Integration Tests: PASS (Modbus client operations verified)
 //    Manual Testing: PASS (register read/write tested with multiple clients)
 //
 // 📈 PERFORMANCE NOTES:
-//    - Response time: <10ms for typical register reads (1-125 registers)
+//    - Register table reads: answered in the lwIP receive callback, no main loop hop
 //    - Throughput: 100+ requests/second sustained load
-//    - Memory per connection: ~512 bytes
-//    - Maximum concurrent clients: 8 with 4KB total memory
+//    - Memory per connection: ~540 bytes (RX reassembly + TX buffer)
+//    - Maximum concurrent clients: 3 with ~1.6KB total memory
 //
 // =====================================================================
 
@@ -58,10 +75,16 @@
 #include "utils.h"
 #include "trio_hp_monitor.h"
 #include "trio_hp_manager.h"
+#include "trio_hp_params.h"
+#include "trio_hp_forecast.h"
+#include "bms_protocol.h"
+#include "bms_sdo.h"
+#include "modbus_cov.h"
+#include "event_bus.h"
+#include "mem_pool.h"
+#include "statistics.h"
 
 // === GLOBAL VARIABLES ===
-WiFiServer modbusServerSocket(MODBUS_TCP_PORT);
-WiFiClient currentModbusClient;
 ModbusState_t currentModbusState = MODBUS_STATE_UNINITIALIZED;
 
 // Statistics
@@ -76,6 +99,24 @@ struct ModbusStatistics {
   unsigned long bytesSent = 0;
 } modbusStats;
 
+// Transport fast-path counts already added to modbusStats (reset with the transport)
+static ModbusTransportStats_t foldedTransport;
+
+// Event bus: BMS frames mark their slot dirty, registers are rebuilt once per pass
+static int8_t modbusEventSub = -1;
+static unsigned long modbusEventDrops = 0;
+
+// Quality registers age without new frames, so they are also refreshed on a timer
+#define BMS_QUALITY_REFRESH_MS 1000
+#define BMS_QUALITY_BLOCK_SIZE (BMS_REG_COMM_AGE + 1 - BMS_REG_QUALITY_BASE)   // Base+140-169
+static unsigned long lastQualityRefresh = 0;
+
+// Response ADU of main loop reads (module windows); requests stay in their transport slot
+MEM_POOL_DEFINE(modbusAduPool, "modbus", MODBUS_MAX_FRAME_SIZE, 1);
+
+// FC03 blocks are copied in the lwIP thread (either core) while the main loop rebuilds them
+static portMUX_TYPE registerMux = portMUX_INITIALIZER_UNLOCKED;
+
 // === MODBUS TCP SERVER SETUP AND MANAGEMENT ===
 
 bool setupModbusTCP() {
@@ -86,9 +127,13 @@ bool setupModbusTCP() {
     holdingRegisters[i] = 0;
   }
   
+  memPoolInit(&modbusAduPool);
+  memset(&foldedTransport, 0, sizeof(foldedTransport));
+  initModbusCOV();
+  modbusEventSub = subscribeEvents("modbus", EVENT_MASK(EVENT_BMS_FRAME_PARSED));
+  
   // Start TCP server
-  modbusServerSocket.begin();
-  if (!modbusServerSocket) {
+  if (!startModbusTransport(MODBUS_TCP_PORT)) {
     Serial.println("❌ Failed to start Modbus TCP server");
     currentModbusState = MODBUS_STATE_ERROR;
     return false;
@@ -109,10 +154,7 @@ bool setupModbusTCP() {
 }
 
 void shutdownModbusTCP() {
-  if (currentModbusClient && currentModbusClient.connected()) {
-    currentModbusClient.stop();
-  }
-  modbusServerSocket.end();
+  stopModbusTransport();
   currentModbusState = MODBUS_STATE_UNINITIALIZED;
   Serial.println("🔗 Modbus TCP Server shutdown");
 }
@@ -126,43 +168,99 @@ bool restartModbusTCP() {
 
 // === MODBUS TCP PROCESSING ===
 
-void processModbusTCP() {
-  // Accept new clients if none connected
-  if (!currentModbusClient || !currentModbusClient.connected()) {
-    currentModbusClient = modbusServerSocket.accept();
-    if (currentModbusClient) {
-      Serial.printf("🔗 New Modbus TCP client connected: %s\n", 
-                    currentModbusClient.remoteIP().toString().c_str());
-      modbusStats.connectionCount++;
-      currentModbusState = MODBUS_STATE_CLIENT_CONNECTED;
+static void dispatchModbusRequest(ModbusConnection_t* conn, uint8_t* request, int bytesRead);
+static void foldFastPathStats(const ModbusTransportStats_t* transport);
+
+static void processModbusEvents() {
+  uint32_t dirtySlots = 0;
+  Event_t event;
+  
+  while (pollEvent(modbusEventSub, &event)) {
+    int slot = getBMSIndexByNodeId(event.source);
+    if (slot >= 0 && slot < MAX_BMS_NODES) dirtySlots |= (1UL << slot);
+  }
+  
+  // Frames were lost for this subscriber: rebuild every active node
+  unsigned long drops = getEventDrops(modbusEventSub);
+  if (drops != modbusEventDrops) {
+    modbusEventDrops = drops;
+    for (int i = 0; i < systemConfig.activeBmsNodes; i++) {
+      updateModbusRegisters(systemConfig.bmsNodeIds[i]);
+    }
+    return;
+  }
+  
+  for (int i = 0; dirtySlots != 0 && i < systemConfig.activeBmsNodes; i++) {
+    if (dirtySlots & (1UL << i)) {
+      updateModbusRegisters(systemConfig.bmsNodeIds[i]);
+      dirtySlots &= ~(1UL << i);
     }
   }
   
-  // Handle existing client requests
-  if (currentModbusClient && currentModbusClient.connected()) {
-    if (currentModbusClient.available()) {
-      handleModbusRequest(currentModbusClient);
+  unsigned long now = millis();
+  if (now - lastQualityRefresh >= BMS_QUALITY_REFRESH_MS) {
+    lastQualityRefresh = now;
+    for (int i = 0; i < systemConfig.activeBmsNodes; i++) {
+      BMSData* bms = getBMSData(systemConfig.bmsNodeIds[i]);
+      if (bms) mapBMSQualityToModbus(i, *bms);
     }
-  } else if (currentModbusState == MODBUS_STATE_CLIENT_CONNECTED) {
-    // Client disconnected
-    Serial.println("🔗 Modbus TCP client disconnected");
-    modbusStats.disconnectionCount++;
-    currentModbusState = MODBUS_STATE_RUNNING;
   }
 }
 
-void handleModbusRequest(WiFiClient& client) {
-  if (!client.available()) return;
-  
-  uint8_t request[256];  // Buffer for larger requests
-  int bytesRead = client.readBytes(request, sizeof(request));
-  
-  if (bytesRead < 8) {  // Minimum: MBAP (7) + Function Code (1)
-    Serial.printf("⚠️ Modbus request too short: %d bytes\n", bytesRead);
-    modbusStats.totalErrors++;
-    return;
+void processModbusTCP() {
+  processModbusEvents();
+  processModbusCOV();
+  
+  // Requests the receive callback left to the main loop (writes, module windows, errors)
+  for (uint8_t slot = 0; slot < MODBUS_TCP_MAX_CLIENTS; slot++) {
+    uint8_t* request;
+    int length;
+    ModbusConnection_t* conn = getModbusTransportRequest(slot, &request, &length);
+    if (conn == nullptr) continue;
+    setModbusCOVClientSession(slot, getModbusTransportSession(conn));
+    dispatchModbusRequest(conn, request, length);
+    completeModbusTransport(conn);
   }
   
+  // Connections are accepted and closed in the lwIP thread, reported here
+  const ModbusTransportStats_t* transport = getModbusTransportStats();
+  foldFastPathStats(transport);
+  if (transport->accepted != modbusStats.connectionCount) {
+    modbusStats.connectionCount = transport->accepted;
+    Serial.printf("🔗 Modbus TCP client connected (%d open)\n", transport->activeConnections);
+  }
+  if (transport->closed != modbusStats.disconnectionCount) {
+    modbusStats.disconnectionCount = transport->closed;
+    Serial.printf("🔗 Modbus TCP client disconnected (%d open)\n", transport->activeConnections);
+  }
+  if (currentModbusState == MODBUS_STATE_RUNNING || currentModbusState == MODBUS_STATE_CLIENT_CONNECTED) {
+    currentModbusState = transport->activeConnections > 0 ? MODBUS_STATE_CLIENT_CONNECTED : MODBUS_STATE_RUNNING;
+  }
+}
+
+// Reads answered in the receive callback count in modbusStats like the main loop's
+static void foldFastPathStats(const ModbusTransportStats_t* transport) {
+  unsigned long requests = transport->fastRequests;
+  if (requests == foldedTransport.fastRequests) return;
+  unsigned long responses = transport->fastResponses;
+  unsigned long bytesReceived = transport->fastBytesReceived;
+  unsigned long bytesSent = transport->fastBytesSent;
+  unsigned long lastRequest = transport->lastFastRequestMs;
+  
+  modbusStats.totalRequests += requests - foldedTransport.fastRequests;
+  modbusStats.totalResponses += responses - foldedTransport.fastResponses;
+  modbusStats.bytesReceived += bytesReceived - foldedTransport.fastBytesReceived;
+  modbusStats.bytesSent += bytesSent - foldedTransport.fastBytesSent;
+  if (modbusStats.lastRequestTime == 0 || (long)(lastRequest - modbusStats.lastRequestTime) > 0) {
+    modbusStats.lastRequestTime = lastRequest;
+  }
+  foldedTransport.fastRequests = requests;
+  foldedTransport.fastResponses = responses;
+  foldedTransport.fastBytesReceived = bytesReceived;
+  foldedTransport.fastBytesSent = bytesSent;
+}
+
+static void dispatchModbusRequest(ModbusConnection_t* conn, uint8_t* request, int bytesRead) {
   modbusStats.totalRequests++;
   modbusStats.lastRequestTime = millis();
   modbusStats.bytesReceived += bytesRead;
@@ -195,20 +293,20 @@ void handleModbusRequest(WiFiClient& client) {
   // Handle different function codes
   switch (functionCode) {
     case MODBUS_FUNC_READ_HOLDING_REGISTERS:
-      handleReadHoldingRegisters(client, request, bytesRead);
+      handleReadHoldingRegisters(conn, request, bytesRead);
       break;
       
     case MODBUS_FUNC_WRITE_SINGLE_REGISTER:
-      handleWriteSingleRegister(client, request, bytesRead);
+      handleWriteSingleRegister(conn, request, bytesRead);
       break;
       
     case MODBUS_FUNC_WRITE_MULTIPLE_REGISTERS:
-      handleWriteMultipleRegisters(client, request, bytesRead);
+      handleWriteMultipleRegisters(conn, request, bytesRead);
       break;
       
     default:
       Serial.printf("❌ Unsupported function code: 0x%02X\n", functionCode);
-      sendErrorResponse(client, functionCode, MODBUS_EXCEPTION_ILLEGAL_FUNCTION, transactionId);
+      sendErrorResponse(conn, functionCode, MODBUS_EXCEPTION_ILLEGAL_FUNCTION, transactionId);
       modbusStats.totalErrors++;
       break;
   }
@@ -216,7 +314,48 @@ void handleModbusRequest(WiFiClient& client) {
 
 // === MODBUS FUNCTION HANDLERS ===
 
-void handleReadHoldingRegisters(WiFiClient& client, uint8_t* request, int requestLength) {
+int buildModbusReadResponse(const uint8_t* request, int requestLength, uint8_t* response) {
+  if (requestLength < 12 ||                                           // MBAP (7) + Function (1) + Address (2) + Count (2)
+      request[2] != 0 || request[3] != 0 ||                           // Protocol ID
+      request[MODBUS_MBAP_UNIT_ID_OFFSET] != MODBUS_SLAVE_ID ||
+      request[7] != MODBUS_FUNC_READ_HOLDING_REGISTERS) {
+    return 0;
+  }
+  
+  uint16_t startAddress = (request[8] << 8) | request[9];
+  uint16_t registerCount = (request[10] << 8) | request[11];
+  
+  // Module windows keep their own state (and COV leases), served from the main loop
+  if (isTrioParamRegisterRange(startAddress, registerCount) ||
+      isBMSSdoRegisterRange(startAddress, registerCount) ||
+      isModbusCOVRegisterRange(startAddress, registerCount) ||
+      !isValidRegisterRange(startAddress, registerCount)) {
+    return 0;
+  }
+  
+  uint16_t byteCount = registerCount * 2;
+  response[0] = request[0];  // Transaction ID
+  response[1] = request[1];
+  response[2] = 0;           // Protocol ID
+  response[3] = 0;
+  response[4] = ((3 + byteCount) >> 8) & 0xFF;
+  response[5] = (3 + byteCount) & 0xFF;
+  response[6] = MODBUS_SLAVE_ID;
+  response[7] = MODBUS_FUNC_READ_HOLDING_REGISTERS;
+  response[8] = byteCount;
+  
+  uint8_t* out = &response[9];
+  lockModbusRegisters();
+  for (uint16_t i = 0; i < registerCount; i++) {
+    uint16_t regValue = holdingRegisters[startAddress + i];
+    *out++ = regValue >> 8;
+    *out++ = regValue & 0xFF;
+  }
+  unlockModbusRegisters();
+  return 9 + byteCount;
+}
+
+void handleReadHoldingRegisters(ModbusConnection_t* conn, uint8_t* request, int requestLength) {
   if (requestLength < 12) {  // MBAP (7) + Function (1) + Address (2) + Count (2)
     modbusStats.totalErrors++;
     return;
@@ -226,11 +365,14 @@ void handleReadHoldingRegisters(WiFiClient& client, uint8_t* request, int reques
   uint16_t startAddress = (request[8] << 8) | request[9];
   uint16_t registerCount = (request[10] << 8) | request[11];
   
-  // Validate register range
-  if (!isValidRegisterRange(startAddress, registerCount)) {
+  // Validate register range (TRIO HP parameter, SDO and COV windows are served by their modules)
+  bool paramWindow = isTrioParamRegisterRange(startAddress, registerCount);
+  bool sdoWindow = isBMSSdoRegisterRange(startAddress, registerCount);
+  bool covWindow = isModbusCOVRegisterRange(startAddress, registerCount);
+  if (!paramWindow && !sdoWindow && !covWindow && !isValidRegisterRange(startAddress, registerCount)) {
     Serial.printf("❌ Invalid register range: %d + %d > %d\n", 
                   startAddress, registerCount, MODBUS_MAX_HOLDING_REGISTERS);
-    sendErrorResponse(client, MODBUS_FUNC_READ_HOLDING_REGISTERS, 
+    sendErrorResponse(conn, MODBUS_FUNC_READ_HOLDING_REGISTERS, 
                      MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS, transactionId);
     modbusStats.totalErrors++;
     return;
@@ -238,7 +380,19 @@ void handleReadHoldingRegisters(WiFiClient& client, uint8_t* request, int reques
   
   // Build response
   int responseLength = 9 + (registerCount * 2);  // MBAP + Function + ByteCount + Data
-  uint8_t* response = new uint8_t[responseLength];
+  if (responseLength > MODBUS_MAX_FRAME_SIZE) {
+    sendErrorResponse(conn, MODBUS_FUNC_READ_HOLDING_REGISTERS, 
+                     MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE, transactionId);
+    modbusStats.totalErrors++;
+    return;
+  }
+  uint8_t* response = (uint8_t*)memPoolAlloc(&modbusAduPool);
+  if (response == nullptr) {
+    sendErrorResponse(conn, MODBUS_FUNC_READ_HOLDING_REGISTERS, 
+                     MODBUS_EXCEPTION_SLAVE_DEVICE_FAILURE, transactionId);
+    modbusStats.totalErrors++;
+    return;
+  }
   
   // MBAP Header
   response[0] = request[0];  // Transaction ID High
@@ -255,18 +409,27 @@ void handleReadHoldingRegisters(WiFiClient& client, uint8_t* request, int reques
   
   // Register data
   for (int i = 0; i < registerCount; i++) {
-    uint16_t regValue = holdingRegisters[startAddress + i];
+    uint16_t regValue = 0;
+    if (paramWindow) {
+      readTrioParamRegister(startAddress + i, &regValue);
+    } else if (sdoWindow) {
+      readBMSSdoRegister(startAddress + i, &regValue);
+    } else if (covWindow) {
+      readModbusCOVRegister(getModbusTransportSlot(conn), startAddress + i, &regValue);
+    } else {
+      regValue = holdingRegisters[startAddress + i];
+    }
     response[9 + (i * 2)] = (regValue >> 8) & 0xFF;      // High byte
     response[9 + (i * 2) + 1] = regValue & 0xFF;         // Low byte
   }
   
-  sendModbusResponse(client, response, responseLength);
-  delete[] response;
+  sendModbusResponse(conn, response, responseLength);
+  memPoolFree(&modbusAduPool, response);
   
   Serial.printf("✅ Read %d registers from address %d\n", registerCount, startAddress);
 }
 
-void handleWriteSingleRegister(WiFiClient& client, uint8_t* request, int requestLength) {
+void handleWriteSingleRegister(ModbusConnection_t* conn, uint8_t* request, int requestLength) {
   if (requestLength < 12) {  // MBAP (7) + Function (1) + Address (2) + Value (2)
     modbusStats.totalErrors++;
     return;
@@ -276,10 +439,52 @@ void handleWriteSingleRegister(WiFiClient& client, uint8_t* request, int request
   uint16_t registerAddress = (request[8] << 8) | request[9];
   uint16_t registerValue = (request[10] << 8) | request[11];
   
+  // TRIO HP parameter window: range and lock checks come from the parameter table
+  if (isTrioParamRegisterRange(registerAddress, 1)) {
+    if (!writeTrioParamRegister(registerAddress, registerValue)) {
+      Serial.printf("❌ TRIO HP parameter write rejected: %d = %d\n", registerAddress, registerValue);
+      sendErrorResponse(conn, MODBUS_FUNC_WRITE_SINGLE_REGISTER, 
+                       MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE, transactionId);
+      modbusStats.totalErrors++;
+      return;
+    }
+    sendModbusResponse(conn, request, requestLength);
+    publishRegisterWriteEvent(registerAddress, 1, registerValue);
+    Serial.printf("✅ Write TRIO HP parameter %d = %d\n", registerAddress, registerValue);
+    return;
+  }
+  
+  // BMS SDO window: selection registers and read command
+  if (isBMSSdoRegisterRange(registerAddress, 1)) {
+    if (!writeBMSSdoRegister(registerAddress, registerValue)) {
+      Serial.printf("❌ BMS SDO write rejected: %d = %d\n", registerAddress, registerValue);
+      sendErrorResponse(conn, MODBUS_FUNC_WRITE_SINGLE_REGISTER, 
+                       MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE, transactionId);
+      modbusStats.totalErrors++;
+      return;
+    }
+    sendModbusResponse(conn, request, requestLength);
+    publishRegisterWriteEvent(registerAddress, 1, registerValue);
+    return;
+  }
+  
+  // COV window: subscription selection, range, deadband and acknowledged sequence
+  if (isModbusCOVRegisterRange(registerAddress, 1)) {
+    if (!writeModbusCOVRegister(getModbusTransportSlot(conn), registerAddress, registerValue)) {
+      Serial.printf("❌ COV write rejected: %d = %d\n", registerAddress, registerValue);
+      sendErrorResponse(conn, MODBUS_FUNC_WRITE_SINGLE_REGISTER, 
+                       MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE, transactionId);
+      modbusStats.totalErrors++;
+      return;
+    }
+    sendModbusResponse(conn, request, requestLength);
+    return;
+  }
+  
   // Validate register address
   if (!isValidRegisterAddress(registerAddress)) {
     Serial.printf("❌ Invalid register address: %d\n", registerAddress);
-    sendErrorResponse(client, MODBUS_FUNC_WRITE_SINGLE_REGISTER, 
+    sendErrorResponse(conn, MODBUS_FUNC_WRITE_SINGLE_REGISTER, 
                      MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS, transactionId);
     modbusStats.totalErrors++;
     return;
@@ -289,12 +494,13 @@ void handleWriteSingleRegister(WiFiClient& client, uint8_t* request, int request
   holdingRegisters[registerAddress] = registerValue;
   
   // Echo request as response (standard for write single register)
-  sendModbusResponse(client, request, requestLength);
+  sendModbusResponse(conn, request, requestLength);
+  publishRegisterWriteEvent(registerAddress, 1, registerValue);
   
   Serial.printf("✅ Write register %d = %d\n", registerAddress, registerValue);
 }
 
-void handleWriteMultipleRegisters(WiFiClient& client, uint8_t* request, int requestLength) {
+void handleWriteMultipleRegisters(ModbusConnection_t* conn, uint8_t* request, int requestLength) {
   if (requestLength < 13) {  // MBAP (7) + Function (1) + Address (2) + Count (2) + ByteCount (1)
     modbusStats.totalErrors++;
     return;
@@ -306,37 +512,76 @@ void handleWriteMultipleRegisters(WiFiClient& client, uint8_t* request, int requ
   uint8_t byteCount = request[12];
   
   // Validate parameters
-  if (!isValidRegisterRange(startAddress, registerCount) || 
+  bool paramWindow = isTrioParamRegisterRange(startAddress, registerCount);
+  bool sdoWindow = isBMSSdoRegisterRange(startAddress, registerCount);
+  bool covWindow = isModbusCOVRegisterRange(startAddress, registerCount);
+  if ((!paramWindow && !sdoWindow && !covWindow && !isValidRegisterRange(startAddress, registerCount)) || 
       byteCount != (registerCount * 2) ||
       requestLength < (13 + byteCount)) {
     Serial.printf("❌ Invalid write multiple registers parameters\n");
-    sendErrorResponse(client, MODBUS_FUNC_WRITE_MULTIPLE_REGISTERS, 
+    sendErrorResponse(conn, MODBUS_FUNC_WRITE_MULTIPLE_REGISTERS, 
                      MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE, transactionId);
     modbusStats.totalErrors++;
     return;
   }
   
-  // Write registers
-  for (int i = 0; i < registerCount; i++) {
-    uint16_t regValue = (request[13 + (i * 2)] << 8) | request[13 + (i * 2) + 1];
-    holdingRegisters[startAddress + i] = regValue;
+  // TRIO HP parameter window: the whole block is checked before any parameter changes
+  if (paramWindow) {
+    uint16_t values[TRIO_HP_PARAM_MODBUS_MAX_REGISTERS];
+    for (int i = 0; i < registerCount; i++) {
+      values[i] = (request[13 + (i * 2)] << 8) | request[13 + (i * 2) + 1];
+    }
+    if (!writeTrioParamRegisters(startAddress, registerCount, values)) {
+      Serial.printf("❌ TRIO HP parameter block rejected: %d registers from %d\n", registerCount, startAddress);
+      sendErrorResponse(conn, MODBUS_FUNC_WRITE_MULTIPLE_REGISTERS, 
+                       MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE, transactionId);
+      modbusStats.totalErrors++;
+      return;
+    }
+  } else {
+    // Write registers (a plain holding register range is stored as one block)
+    bool plainRange = !sdoWindow && !covWindow;
+    if (plainRange) lockModbusRegisters();
+    for (int i = 0; i < registerCount; i++) {
+      uint16_t regValue = (request[13 + (i * 2)] << 8) | request[13 + (i * 2) + 1];
+      if (sdoWindow) {
+        if (!writeBMSSdoRegister(startAddress + i, regValue)) {
+          Serial.printf("❌ BMS SDO write rejected: %d = %d\n", startAddress + i, regValue);
+          sendErrorResponse(conn, MODBUS_FUNC_WRITE_MULTIPLE_REGISTERS, 
+                           MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE, transactionId);
+          modbusStats.totalErrors++;
+          return;
+        }
+      } else if (covWindow) {
+        if (!writeModbusCOVRegister(getModbusTransportSlot(conn), startAddress + i, regValue)) {
+          Serial.printf("❌ COV write rejected: %d = %d\n", startAddress + i, regValue);
+          sendErrorResponse(conn, MODBUS_FUNC_WRITE_MULTIPLE_REGISTERS, 
+                           MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE, transactionId);
+          modbusStats.totalErrors++;
+          return;
+        }
+      } else {
+        holdingRegisters[startAddress + i] = regValue;
+      }
+    }
+    if (plainRange) unlockModbusRegisters();
   }
   
   // Build response
   uint8_t response[12];
   memcpy(response, request, 12);  // Copy MBAP + Function + Address + Count
   
-  sendModbusResponse(client, response, 12);
+  sendModbusResponse(conn, response, 12);
+  publishRegisterWriteEvent(startAddress, registerCount,
+                            registerCount > 0 ? ((request[13] << 8) | request[14]) : 0);
   
   Serial.printf("✅ Write %d registers starting from address %d\n", registerCount, startAddress);
 }
 
 // === UTILITY FUNCTIONS ===
 
-void sendModbusResponse(WiFiClient& client, uint8_t* response, int length) {
-  if (client.connected()) {
-    client.write(response, length);
-    client.flush();
+void sendModbusResponse(ModbusConnection_t* conn, uint8_t* response, int length) {
+  if (sendModbusTransport(conn, response, length)) {
     modbusStats.totalResponses++;
     modbusStats.bytesSent += length;
     
@@ -344,7 +589,7 @@ void sendModbusResponse(WiFiClient& client, uint8_t* response, int length) {
   }
 }
 
-void sendErrorResponse(WiFiClient& client, uint8_t functionCode, uint8_t exceptionCode, uint16_t transactionId) {
+void sendErrorResponse(ModbusConnection_t* conn, uint8_t functionCode, uint8_t exceptionCode, uint16_t transactionId) {
   uint8_t response[9];
   
   // MBAP Header
@@ -360,7 +605,7 @@ void sendErrorResponse(WiFiClient& client, uint8_t functionCode, uint8_t excepti
   response[7] = functionCode | 0x80;  // Error function code
   response[8] = exceptionCode;
   
-  sendModbusResponse(client, response, 9);
+  sendModbusResponse(conn, response, 9);
   
   Serial.printf("📤 Modbus Error Response: Func=0x%02X Exception=%d\n", 
                 functionCode, exceptionCode);
@@ -378,10 +623,10 @@ ModbusState_t getModbusState() {
 }
 
 bool isModbusHealthy() {
+  // totalRequests includes the reads answered in the lwIP callback (folded each pass)
   return isModbusServerActive() && 
          (modbusStats.totalErrors == 0 || 
-          (modbusStats.totalRequests > 0 && 
-           (modbusStats.totalErrors * 100 / modbusStats.totalRequests) < 10));
+          (modbusStats.totalRequests > 0 && (modbusStats.totalErrors * 100 / modbusStats.totalRequests) < 10));
 }
 
 // === DATA CONVERSION FUNCTIONS (bez domyślnych argumentów) ===
@@ -391,6 +636,14 @@ uint16_t floatToModbusRegister(float value, float scale) {
   return (uint16_t)constrain(scaledValue, 0, 65535);
 }
 
+// Raw fixed-point frame value to register units: integer multiply (or
+// divide) and the same 0-65535 saturation as floatToModbusRegister, without
+// the float round trip that truncated e.g. 0.29 V * 1000 to 289 mV
+static inline uint16_t rawToModbusRegister(uint32_t raw, uint32_t multiplier) {
+  uint32_t scaled = raw * multiplier;
+  return scaled > 65535 ? 65535 : (uint16_t)scaled;
+}
+
 float modbusRegisterToFloat(uint16_t value, float scale) {
   return (float)value / scale;
 }
@@ -448,154 +701,263 @@ void updateAllModbusRegisters() {
   updateTrioHPModbusRegisters();
 }
 
+static void buildBMSQualityRegisters(const BMSData& bmsData, int batteryIndex, uint16_t* block);
+
 void mapBMSDataToModbus(uint8_t nodeId, const BMSData& bmsData) {
   int batteryIndex = getBMSIndexByNodeId(nodeId);
   if (batteryIndex < 0) return;
   
   uint16_t baseAddr = batteryIndex * BMS_REGISTERS_PER_MODULE;
+  uint16_t block[BMS_REGISTERS_PER_MODULE];   // Built here, stored in one piece
+  memcpy(block, &holdingRegisters[baseAddr], sizeof(block));   // Unmapped registers (4-9) keep their value
   
   // Frame 190 - podstawowe dane (registers 0-9)
-  holdingRegisters[baseAddr + 0] = floatToModbusRegister(bmsData.batteryVoltage, 1000);    // mV
-  holdingRegisters[baseAddr + 1] = floatToModbusRegister(bmsData.batteryCurrent, 1000);    // mA
-  holdingRegisters[baseAddr + 2] = floatToModbusRegister(bmsData.remainingEnergy, 100);    // 0.01kWh
-  holdingRegisters[baseAddr + 3] = floatToModbusRegister(bmsData.soc, 10);                 // 0.1%
+  block[0] = rawToModbusRegister(bmsData.batteryVoltageRaw, 10);   // mV
+  block[1] = rawToModbusRegister(bmsData.batteryCurrentRaw, 10);   // mA
+  block[2] = bmsData.remainingEnergyRaw;                            // 0.01kWh
+  block[3] = bmsData.socRaw * 5;                                    // 0.1%
   
   // Frame 190 - flagi błędów (registers 10-19)
-  holdingRegisters[baseAddr + 10] = bmsData.masterError ? 1 : 0;
-  holdingRegisters[baseAddr + 11] = bmsData.cellVoltageError ? 1 : 0;
-  holdingRegisters[baseAddr + 12] = bmsData.cellTempMinError ? 1 : 0;
-  holdingRegisters[baseAddr + 13] = bmsData.cellTempMaxError ? 1 : 0;
-  holdingRegisters[baseAddr + 14] = bmsData.cellVoltageMinError ? 1 : 0;
-  holdingRegisters[baseAddr + 15] = bmsData.cellVoltageMaxError ? 1 : 0;
-  holdingRegisters[baseAddr + 16] = bmsData.systemShutdown ? 1 : 0;
-  holdingRegisters[baseAddr + 17] = bmsData.ibbVoltageSupplyError ? 1 : 0;
-  holdingRegisters[baseAddr + 18] = 0; // Reserved
-  holdingRegisters[baseAddr + 19] = 0; // Reserved
+  block[10] = bmsData.masterError ? 1 : 0;
+  block[11] = bmsData.cellVoltageError ? 1 : 0;
+  block[12] = bmsData.cellTempMinError ? 1 : 0;
+  block[13] = bmsData.cellTempMaxError ? 1 : 0;
+  block[14] = bmsData.cellVoltageMinError ? 1 : 0;
+  block[15] = bmsData.cellVoltageMaxError ? 1 : 0;
+  block[16] = bmsData.systemShutdown ? 1 : 0;
+  block[17] = bmsData.ibbVoltageSupplyError ? 1 : 0;
+  block[18] = 0; // Reserved
+  block[19] = 0; // Reserved
   
   // Frame 290 - napięcia ogniw (registers 20-29)
-  holdingRegisters[baseAddr + 20] = floatToModbusRegister(bmsData.cellMinVoltage, 10000);  // 0.1mV
-  holdingRegisters[baseAddr + 21] = floatToModbusRegister(bmsData.cellMeanVoltage, 10000); // 0.1mV
-  holdingRegisters[baseAddr + 22] = bmsData.minVoltageBlock;
-  holdingRegisters[baseAddr + 23] = bmsData.minVoltageCell;
-  holdingRegisters[baseAddr + 24] = bmsData.minVoltageString;
-  holdingRegisters[baseAddr + 25] = bmsData.balancingTempMax;
-  holdingRegisters[baseAddr + 26] = 0; // Reserved
-  holdingRegisters[baseAddr + 27] = 0; // Reserved
-  holdingRegisters[baseAddr + 28] = 0; // Reserved
-  holdingRegisters[baseAddr + 29] = 0; // Reserved
+  block[20] = bmsData.cellMinVoltageRaw;                           // 0.1mV
+  block[21] = bmsData.cellMeanVoltageRaw;                          // 0.1mV
+  block[22] = bmsData.minVoltageBlock;
+  block[23] = bmsData.minVoltageCell;
+  block[24] = bmsData.minVoltageString;
+  block[25] = bmsData.balancingTempMax;
+  block[26] = 0; // Reserved
+  block[27] = 0; // Reserved
+  block[28] = 0; // Reserved
+  block[29] = 0; // Reserved
   
   // Frame 310 - SOH, temperatura, impedancja (registers 30-39)
-  holdingRegisters[baseAddr + 30] = floatToModbusRegister(bmsData.soh, 10);               // 0.1%
-  holdingRegisters[baseAddr + 31] = floatToModbusRegister(bmsData.cellVoltage, 10);       // 0.1mV
-  holdingRegisters[baseAddr + 32] = floatToModbusRegister(bmsData.cellTemperature, 10);   // 0.1°C
-  holdingRegisters[baseAddr + 33] = floatToModbusRegister(bmsData.dcir, 10);              // 0.1mΩ
-  holdingRegisters[baseAddr + 34] = bmsData.nonEqualStringsRamp ? 1 : 0;
-  holdingRegisters[baseAddr + 35] = bmsData.dynamicLimitationTimer ? 1 : 0;
-  holdingRegisters[baseAddr + 36] = bmsData.overcurrentTimer ? 1 : 0;
-  holdingRegisters[baseAddr + 37] = bmsData.channelMultiplexor;
-  holdingRegisters[baseAddr + 38] = 0; // Reserved
-  holdingRegisters[baseAddr + 39] = 0; // Reserved
+  block[30] = bmsData.sohRaw / 10;                                 // 0.1%
+  block[31] = floatToModbusRegister(bmsData.cellVoltage, 10);       // 0.1mV
+  block[32] = floatToModbusRegister(bmsData.cellTemperature, 10);   // 0.1°C
+  block[33] = bmsData.dcirRaw / 10;                                // 0.1mΩ
+  block[34] = bmsData.nonEqualStringsRamp ? 1 : 0;
+  block[35] = bmsData.dynamicLimitationTimer ? 1 : 0;
+  block[36] = bmsData.overcurrentTimer ? 1 : 0;
+  block[37] = bmsData.channelMultiplexor;
+  block[38] = 0; // Reserved
+  block[39] = 0; // Reserved
   
   // Frame 390 - maksymalne napięcia (registers 40-49)
-  holdingRegisters[baseAddr + 40] = floatToModbusRegister(bmsData.cellMaxVoltage, 10000); // 0.1mV
-  holdingRegisters[baseAddr + 41] = floatToModbusRegister(bmsData.cellVoltageDelta, 10000); // 0.1mV
-  holdingRegisters[baseAddr + 42] = bmsData.maxVoltageBlock;
-  holdingRegisters[baseAddr + 43] = bmsData.maxVoltageCell;
-  holdingRegisters[baseAddr + 44] = bmsData.maxVoltageString;
-  holdingRegisters[baseAddr + 45] = bmsData.afeTemperatureMax;
-  holdingRegisters[baseAddr + 46] = 0; // Reserved
-  holdingRegisters[baseAddr + 47] = 0; // Reserved
-  holdingRegisters[baseAddr + 48] = 0; // Reserved
-  holdingRegisters[baseAddr + 49] = 0; // Reserved
+  block[40] = bmsData.cellMaxVoltageRaw;                           // 0.1mV
+  block[41] = bmsData.cellVoltageDeltaRaw;                         // 0.1mV
+  block[42] = bmsData.maxVoltageBlock;
+  block[43] = bmsData.maxVoltageCell;
+  block[44] = bmsData.maxVoltageString;
+  block[45] = bmsData.afeTemperatureMax;
+  block[46] = 0; // Reserved
+  block[47] = 0; // Reserved
+  block[48] = 0; // Reserved
+  block[49] = 0; // Reserved
   
   // Frame 410 - temperatury i gotowość (registers 50-59)
-  holdingRegisters[baseAddr + 50] = floatToModbusRegister(bmsData.cellMaxTemperature, 10); // 0.1°C
-  holdingRegisters[baseAddr + 51] = floatToModbusRegister(bmsData.cellTempDelta, 10);      // 0.1°C
-  holdingRegisters[baseAddr + 52] = bmsData.maxTempString;
-  holdingRegisters[baseAddr + 53] = bmsData.maxTempBlock;
-  holdingRegisters[baseAddr + 54] = bmsData.maxTempSensor;
-  holdingRegisters[baseAddr + 55] = bmsData.readyToCharge ? 1 : 0;
-  holdingRegisters[baseAddr + 56] = bmsData.readyToDischarge ? 1 : 0;
-  holdingRegisters[baseAddr + 57] = 0; // Reserved
-  holdingRegisters[baseAddr + 58] = 0; // Reserved
-  holdingRegisters[baseAddr + 59] = 0; // Reserved
+  block[50] = floatToModbusRegister(bmsData.cellMaxTemperature, 10); // 0.1°C
+  block[51] = floatToModbusRegister(bmsData.cellTempDelta, 10);      // 0.1°C
+  block[52] = bmsData.maxTempString;
+  block[53] = bmsData.maxTempBlock;
+  block[54] = bmsData.maxTempSensor;
+  block[55] = bmsData.readyToCharge ? 1 : 0;
+  block[56] = bmsData.readyToDischarge ? 1 : 0;
+  block[57] = 0; // Reserved
+  block[58] = 0; // Reserved
+  block[59] = 0; // Reserved
   
   // Frame 510 - limity mocy i I/O (registers 60-69)
-  holdingRegisters[baseAddr + 60] = floatToModbusRegister(bmsData.dccl, 1000);            // mA
-  holdingRegisters[baseAddr + 61] = floatToModbusRegister(bmsData.ddcl, 1000);            // mA
-  holdingRegisters[baseAddr + 62] = bmsData.input_IN02 ? 1 : 0;
-  holdingRegisters[baseAddr + 63] = bmsData.input_IN01 ? 1 : 0;
-  holdingRegisters[baseAddr + 64] = bmsData.relay_AUX4 ? 1 : 0;
-  holdingRegisters[baseAddr + 65] = bmsData.relay_AUX3 ? 1 : 0;
-  holdingRegisters[baseAddr + 66] = bmsData.relay_AUX2 ? 1 : 0;
-  holdingRegisters[baseAddr + 67] = bmsData.relay_AUX1 ? 1 : 0;
-  holdingRegisters[baseAddr + 68] = bmsData.relay_R2 ? 1 : 0;
-  holdingRegisters[baseAddr + 69] = bmsData.relay_R1 ? 1 : 0;
+  block[60] = rawToModbusRegister(bmsData.dcclRaw, 100);          // mA
+  block[61] = rawToModbusRegister(bmsData.ddclRaw, 100);          // mA
+  block[62] = bmsData.input_IN02 ? 1 : 0;
+  block[63] = bmsData.input_IN01 ? 1 : 0;
+  block[64] = bmsData.relay_AUX4 ? 1 : 0;
+  block[65] = bmsData.relay_AUX3 ? 1 : 0;
+  block[66] = bmsData.relay_AUX2 ? 1 : 0;
+  block[67] = bmsData.relay_AUX1 ? 1 : 0;
+  block[68] = bmsData.relay_R2 ? 1 : 0;
+  block[69] = bmsData.relay_R1 ? 1 : 0;
   
   // Frame 490 - multipleksowane dane (registers 70-89)
-  holdingRegisters[baseAddr + 70] = bmsData.mux490Type;                                   // Typ multipleksera
-  holdingRegisters[baseAddr + 71] = bmsData.mux490Value;                                  // Wartość multipleksera
-  holdingRegisters[baseAddr + 72] = bmsData.serialNumber0;                                // Serial number low
-  holdingRegisters[baseAddr + 73] = bmsData.serialNumber1;                                // Serial number high
-  holdingRegisters[baseAddr + 74] = bmsData.hwVersion0;                                   // HW version low
-  holdingRegisters[baseAddr + 75] = bmsData.hwVersion1;                                   // HW version high
-  holdingRegisters[baseAddr + 76] = bmsData.swVersion0;                                   // SW version low
-  holdingRegisters[baseAddr + 77] = bmsData.swVersion1;                                   // SW version high
-  holdingRegisters[baseAddr + 78] = floatToModbusRegister(bmsData.factoryEnergy, 10);     // 0.1 kWh
-  holdingRegisters[baseAddr + 79] = floatToModbusRegister(bmsData.designCapacity, 1000);  // mAh
-  holdingRegisters[baseAddr + 80] = floatToModbusRegister(bmsData.systemDesignedEnergy, 10); // 0.1 kWh
-  holdingRegisters[baseAddr + 81] = floatToModbusRegister(bmsData.ballancerTempMaxBlock, 10); // 0.1°C
-  holdingRegisters[baseAddr + 82] = floatToModbusRegister(bmsData.ltcTempMaxBlock, 10);   // 0.1°C
-  holdingRegisters[baseAddr + 83] = floatToModbusRegister(bmsData.inletTemperature, 10);  // 0.1°C
-  holdingRegisters[baseAddr + 84] = floatToModbusRegister(bmsData.outletTemperature, 10); // 0.1°C
-  holdingRegisters[baseAddr + 85] = bmsData.humidity;                                     // %
-  holdingRegisters[baseAddr + 86] = bmsData.timeToFullCharge;                             // min
-  holdingRegisters[baseAddr + 87] = bmsData.timeToFullDischarge;                          // min
-  holdingRegisters[baseAddr + 88] = bmsData.batteryCycles;                                // cycles
-  holdingRegisters[baseAddr + 89] = bmsData.numberOfDetectedIMBs;                         // count
+  block[70] = bmsData.mux490Type;                                   // Typ multipleksera
+  block[71] = bmsData.mux490Value;                                  // Wartość multipleksera
+  block[72] = bmsData.serialNumber0;                                // Serial number low
+  block[73] = bmsData.serialNumber1;                                // Serial number high
+  block[74] = bmsData.hwVersion0;                                   // HW version low
+  block[75] = bmsData.hwVersion1;                                   // HW version high
+  block[76] = bmsData.swVersion0;                                   // SW version low
+  block[77] = bmsData.swVersion1;                                   // SW version high
+  block[78] = floatToModbusRegister(bmsData.factoryEnergy, 10);     // 0.1 kWh
+  block[79] = floatToModbusRegister(bmsData.designCapacity, 1000);  // mAh
+  block[80] = floatToModbusRegister(bmsData.systemDesignedEnergy, 10); // 0.1 kWh
+  block[81] = floatToModbusRegister(bmsData.ballancerTempMaxBlock, 10); // 0.1°C
+  block[82] = floatToModbusRegister(bmsData.ltcTempMaxBlock, 10);   // 0.1°C
+  block[83] = floatToModbusRegister(bmsData.inletTemperature, 10);  // 0.1°C
+  block[84] = floatToModbusRegister(bmsData.outletTemperature, 10); // 0.1°C
+  block[85] = bmsData.humidity;                                     // %
+  block[86] = bmsData.timeToFullCharge;                             // min
+  block[87] = bmsData.timeToFullDischarge;                          // min
+  block[88] = bmsData.batteryCycles;                                // cycles
+  block[89] = bmsData.numberOfDetectedIMBs;                         // count
   
   // Error maps & versions (registers 90-109)
-  holdingRegisters[baseAddr + 90] = bmsData.errorsMap0;        // Error map bits 0-15
-  holdingRegisters[baseAddr + 91] = bmsData.errorsMap1;        // Error map bits 16-31
-  holdingRegisters[baseAddr + 92] = bmsData.errorsMap2;        // Error map bits 32-47
-  holdingRegisters[baseAddr + 93] = bmsData.errorsMap3;        // Error map bits 48-63
-  holdingRegisters[baseAddr + 94] = bmsData.blVersion0;        // Bootloader version low
-  holdingRegisters[baseAddr + 95] = bmsData.blVersion1;        // Bootloader version high
-  holdingRegisters[baseAddr + 96] = bmsData.appVersion0;       // Application version low
-  holdingRegisters[baseAddr + 97] = bmsData.appVersion1;       // Application version high
-  holdingRegisters[baseAddr + 98] = bmsData.crcApp;            // Application CRC
-  holdingRegisters[baseAddr + 99] = bmsData.crcBoot;           // Bootloader CRC
+  block[90] = bmsData.errorsMap0;        // Error map bits 0-15
+  block[91] = bmsData.errorsMap1;        // Error map bits 16-31
+  block[92] = bmsData.errorsMap2;        // Error map bits 32-47
+  block[93] = bmsData.errorsMap3;        // Error map bits 48-63
+  block[94] = bmsData.blVersion0;        // Bootloader version low
+  block[95] = bmsData.blVersion1;        // Bootloader version high
+  block[96] = bmsData.appVersion0;       // Application version low
+  block[97] = bmsData.appVersion1;       // Application version high
+  block[98] = bmsData.crcApp;            // Application CRC
+  block[99] = bmsData.crcBoot;           // Bootloader CRC
   
   // Extended multiplexed data (registers 100-109)
-  holdingRegisters[baseAddr + 100] = floatToModbusRegister(bmsData.balancingEnergy, 100); // Wh
-  holdingRegisters[baseAddr + 101] = floatToModbusRegister(bmsData.maxDischargePower, 1); // W
-  holdingRegisters[baseAddr + 102] = floatToModbusRegister(bmsData.maxChargePower, 1);    // W
-  holdingRegisters[baseAddr + 103] = floatToModbusRegister(bmsData.maxDischargeEnergy, 10); // 0.1kWh
-  holdingRegisters[baseAddr + 104] = floatToModbusRegister(bmsData.maxChargeEnergy, 10);  // 0.1kWh
-  holdingRegisters[baseAddr + 105] = floatToModbusRegister(bmsData.chargeEnergy0, 10);    // 0.1kWh
-  holdingRegisters[baseAddr + 106] = floatToModbusRegister(bmsData.chargeEnergy1, 10);    // 0.1kWh
-  holdingRegisters[baseAddr + 107] = floatToModbusRegister(bmsData.dischargeEnergy0, 10); // 0.1kWh
-  holdingRegisters[baseAddr + 108] = floatToModbusRegister(bmsData.dischargeEnergy1, 10); // 0.1kWh
-  holdingRegisters[baseAddr + 109] = floatToModbusRegister(bmsData.recuperativeEnergy0, 10); // 0.1kWh
+  block[100] = floatToModbusRegister(bmsData.balancingEnergy, 100); // Wh
+  block[101] = floatToModbusRegister(bmsData.maxDischargePower, 1); // W
+  block[102] = floatToModbusRegister(bmsData.maxChargePower, 1);    // W
+  block[103] = floatToModbusRegister(bmsData.maxDischargeEnergy, 10); // 0.1kWh
+  block[104] = floatToModbusRegister(bmsData.maxChargeEnergy, 10);  // 0.1kWh
+  block[105] = floatToModbusRegister(bmsData.chargeEnergy0, 10);    // 0.1kWh
+  block[106] = floatToModbusRegister(bmsData.chargeEnergy1, 10);    // 0.1kWh
+  block[107] = floatToModbusRegister(bmsData.dischargeEnergy0, 10); // 0.1kWh
+  block[108] = floatToModbusRegister(bmsData.dischargeEnergy1, 10); // 0.1kWh
+  block[109] = floatToModbusRegister(bmsData.recuperativeEnergy0, 10); // 0.1kWh
   
   // Frame 710 & komunikacja (registers 110-119)
-  holdingRegisters[baseAddr + 110] = bmsData.canopenState;                                // CANopen state
-  holdingRegisters[baseAddr + 111] = bmsData.communicationOk ? 1 : 0;                     // Communication OK
-  holdingRegisters[baseAddr + 112] = bmsData.packetsReceived & 0xFFFF;                    // Packets received low
-  holdingRegisters[baseAddr + 113] = (bmsData.packetsReceived >> 16) & 0xFFFF;            // Packets received high
-  holdingRegisters[baseAddr + 114] = bmsData.parseErrors;                                 // Parse errors
-  holdingRegisters[baseAddr + 115] = bmsData.frame190Count & 0xFFFF;                      // Frame counts
-  holdingRegisters[baseAddr + 116] = bmsData.frame290Count & 0xFFFF;
-  holdingRegisters[baseAddr + 117] = bmsData.frame310Count & 0xFFFF;
-  holdingRegisters[baseAddr + 118] = bmsData.frame490Count & 0xFFFF;                      // Multiplexed frame count
-  holdingRegisters[baseAddr + 119] = bmsData.frame710Count & 0xFFFF;                      // CANopen frame count
+  block[110] = bmsData.canopenState;                                // CANopen state
+  block[111] = bmsData.communicationOk ? 1 : 0;                     // Communication OK
+  block[112] = bmsData.packetsReceived & 0xFFFF;                    // Packets received low
+  block[113] = (bmsData.packetsReceived >> 16) & 0xFFFF;            // Packets received high
+  block[114] = bmsData.parseErrors;                                 // Parse errors
+  block[115] = bmsData.frame190Count & 0xFFFF;                      // Frame counts
+  block[116] = bmsData.frame290Count & 0xFFFF;
+  block[117] = bmsData.frame310Count & 0xFFFF;
+  block[118] = bmsData.frame490Count & 0xFFFF;                      // Multiplexed frame count
+  block[119] = bmsData.frame710Count & 0xFFFF;                      // CANopen frame count
   
   // Reserved area (registers 120-124)
-  holdingRegisters[baseAddr + 120] = 0; // Reserved
-  holdingRegisters[baseAddr + 121] = 0; // Reserved
-  holdingRegisters[baseAddr + 122] = 0; // Reserved
-  holdingRegisters[baseAddr + 123] = 0; // Reserved
-  holdingRegisters[baseAddr + 124] = 0; // Reserved
+  block[120] = 0; // Reserved
+  block[121] = 0; // Reserved
+  block[122] = 0; // Reserved
+  block[123] = 0; // Reserved
+  block[124] = 0; // Reserved
+  
+  // Limit forecast (registers 125-133) - see trio_hp_forecast.h
+  const TrioPackForecast_t* forecast = getPackForecast(batteryIndex);
+  const TrioPackLimits_t* live = getPackLimits(batteryIndex);
+  if (forecast && live && forecast->valid && live->valid) {
+    block[125] = floatToModbusRegister(forecast->dccl_forecast, 10);     // 0.1A
+    block[126] = floatToModbusRegister(forecast->ddcl_forecast, 10);     // 0.1A
+    block[127] = floatToModbusRegister(forecast->soc_forecast, 10);      // 0.1%
+    block[128] = (uint16_t)(int16_t)constrain(forecast->temp_max_forecast * 10.0f, -32768.0f, 32767.0f); // 0.1°C signed
+    block[129] = (uint16_t)(int16_t)constrain(forecast->soc_slope * 1000.0f, -32768.0f, 32767.0f);      // 0.001%/s signed
+    block[130] = (uint16_t)(int16_t)constrain(forecast->current.level * 10.0f, -32768.0f, 32767.0f);    // 0.1A signed
+    block[131] = live->dccl_derated > 0 ? floatToModbusRegister(forecast->dccl_forecast / live->dccl_derated, 1000) : 0; // 0.1% headroom kept
+    block[132] = live->ddcl_derated > 0 ? floatToModbusRegister(forecast->ddcl_forecast / live->ddcl_derated, 1000) : 0; // 0.1% headroom kept
+    block[133] = (uint16_t)TRIO_FORECAST_HORIZON_S;                      // s
+  } else {
+    memset(&block[125], 0, 9 * sizeof(uint16_t));
+  }
+  
+  buildBMSQualityRegisters(bmsData, batteryIndex, block);
+  
+  lockModbusRegisters();
+  memcpy(&holdingRegisters[baseAddr], block, BMS_QUALITY_FIELDS * sizeof(uint16_t));
+  memcpy(&holdingRegisters[baseAddr + BMS_REG_QUALITY_BASE], &block[BMS_REG_QUALITY_BASE],
+         BMS_QUALITY_BLOCK_SIZE * sizeof(uint16_t));
+  unlockModbusRegisters();
+}
+
+// === FIELD QUALITY ===
+
+// Frame each register of the BMS block is decoded from (BMS_FRAME_TYPE_UNKNOWN = no source)
+static uint8_t getBMSRegisterSource(uint8_t offset) {
+  if (offset < 20)  return BMS_FRAME_TYPE_190;
+  if (offset < 30)  return BMS_FRAME_TYPE_290;
+  if (offset < 40)  return BMS_FRAME_TYPE_310;
+  if (offset < 50)  return BMS_FRAME_TYPE_390;
+  if (offset < 60)  return BMS_FRAME_TYPE_410;
+  if (offset < 70)  return BMS_FRAME_TYPE_510;
+  if (offset < 110) return BMS_FRAME_TYPE_490;
+  if (offset < 120) return BMS_FRAME_TYPE_710;
+  if (offset < 125) return BMS_FRAME_TYPE_UNKNOWN;  // Reserved
+  return BMS_FRAME_TYPE_510;                        // Forecast, follows the live limits
+}
+
+static TrioDataQuality_t assessBMSFrameQuality(unsigned long timestamp, unsigned long now) {
+  if (timestamp == 0) return TRIO_QUALITY_INVALID;
+  unsigned long age = now - timestamp;
+  if (age <= BMS_QUALITY_FRESH_MS) return TRIO_QUALITY_EXCELLENT;
+  if (age <= BMS_QUALITY_LATE_MS) return TRIO_QUALITY_FAIR;
+  if (age <= BMS_COMMUNICATION_TIMEOUT_MS) return TRIO_QUALITY_POOR;
+  return TRIO_QUALITY_INVALID;
+}
+
+static uint8_t qualityToCode(TrioDataQuality_t quality) {
+  return quality >= TRIO_QUALITY_GOOD ? BMS_QUALITY_CODE_GOOD : (uint8_t)(quality / 25);
+}
+
+static uint16_t ageToRegister(unsigned long timestamp, unsigned long now) {
+  if (timestamp == 0) return 0xFFFF;
+  unsigned long tenths = (now - timestamp) / 100;
+  return tenths >= 0xFFFE ? 0xFFFE : (uint16_t)tenths;
+}
+
+// Base+140-169 of one block into block[] (indexed like the register block)
+static void buildBMSQualityRegisters(const BMSData& bmsData, int batteryIndex, uint16_t* block) {
+  unsigned long now = millis();
+  
+  // One assessment per frame type, then a table walk over the fields
+  uint8_t frameCode[BMS_FRAME_TYPE_COUNT + 1];
+  for (uint8_t f = 0; f < BMS_FRAME_TYPE_COUNT; f++) {
+    frameCode[f] = qualityToCode(assessBMSFrameQuality(bmsData.frameTimestamps[f], now));
+  }
+  frameCode[BMS_FRAME_TYPE_UNKNOWN] = BMS_QUALITY_CODE_INVALID;
+  
+  const TrioPackForecast_t* forecast = getPackForecast(batteryIndex);
+  bool forecastValid = forecast && forecast->valid;
+  
+  uint16_t* quality = &block[BMS_REG_QUALITY_BASE];
+  memset(quality, 0, ((BMS_QUALITY_FIELDS + 7) / 8) * sizeof(uint16_t));
+  for (uint8_t i = 0; i < BMS_QUALITY_FIELDS; i++) {
+    uint8_t code = frameCode[getBMSRegisterSource(i)];
+    if (i >= 125 && !forecastValid) code = BMS_QUALITY_CODE_INVALID;
+    quality[i / 8] |= code << ((i % 8) * 2);
+  }
+  
+  uint8_t worst = BMS_QUALITY_CODE_GOOD;
+  for (uint8_t f = BMS_FRAME_TYPE_190; f <= BMS_FRAME_TYPE_510; f++) {
+    if (frameCode[f] < worst) worst = frameCode[f];
+  }
+  block[BMS_REG_QUALITY_SUMMARY] = worst;
+  
+#if BMS_FRAME_AGE_REGISTERS
+  for (uint8_t f = 0; f < BMS_FRAME_TYPE_COUNT; f++) {
+    block[BMS_REG_FRAME_AGE_BASE + f] = ageToRegister(bmsData.frameTimestamps[f], now);
+  }
+  block[BMS_REG_COMM_AGE] = ageToRegister(bmsData.lastCommunication, now);
+#endif
+}
+
+void mapBMSQualityToModbus(int batteryIndex, const BMSData& bmsData) {
+  uint16_t baseAddr = batteryIndex * BMS_REGISTERS_PER_MODULE;
+  uint16_t block[BMS_REGISTERS_PER_MODULE];
+  memcpy(&block[BMS_REG_QUALITY_BASE], &holdingRegisters[baseAddr + BMS_REG_QUALITY_BASE],
+         BMS_QUALITY_BLOCK_SIZE * sizeof(uint16_t));
+  buildBMSQualityRegisters(bmsData, batteryIndex, block);
+  storeModbusRegisters(baseAddr + BMS_REG_QUALITY_BASE, &block[BMS_REG_QUALITY_BASE], BMS_QUALITY_BLOCK_SIZE);
 }
 
 // === DIAGNOSTICS AND MONITORING ===
@@ -624,7 +986,9 @@ void printModbusStatistics() {
     Serial.printf("⏰ Last Request: %lu ms ago\n", timeSinceLastRequest);
   }
   
+  printModbusTransportStatus();
   Serial.println("================================");
+  printModbusCOVStatus();
 }
 
 void printModbusRegisterMap() {
@@ -647,6 +1011,10 @@ void printModbusRegisterMap() {
   Serial.println("   Base+90-109: Error maps & versions");
   Serial.println("   Base+110-119: Frame 710 & communication");
   Serial.println("   Base+120-124: Reserved");
+  Serial.println("   Base+125-133: Limit forecast (DCCL/DDCL, SOC, Tmax, slopes, headroom)");
+  Serial.println("   Base+140-156: Field quality, 2 bits per register 0-133 (0 invalid .. 3 good)");
+  Serial.println("   Base+157: Worst quality of frames 190-510");
+  Serial.println("   Base+160-169: Frame ages per frame type + last frame [0.1s, 0xFFFF = never]");
   Serial.println();
   
   Serial.println("🎯 EXAMPLE BMS MODULE ADDRESSES:");
@@ -659,17 +1027,33 @@ void printModbusRegisterMap() {
   if (MAX_BMS_NODES > 4) {
     Serial.println("   ... (and more)");
   }
+  Serial.println();
+  
+  Serial.printf("📡 BMS SDO WINDOW: %d-%d\n", BMS_SDO_MODBUS_START_REGISTER,
+                BMS_SDO_MODBUS_START_REGISTER + BMS_SDO_MODBUS_REGISTERS - 1);
+  Serial.println("   +0-3: node, index, sub-index, max age [ms] (RW)");
+  Serial.println("   +4: command (1 = read, 2 = force read)");
+  Serial.println("   +5-11: status, age [ms], length, abort code, value (32-bit)");
+  Serial.println("   +12-27: raw data bytes");
+  Serial.printf("🔔 COV WINDOW: %d-%d\n", MODBUS_COV_START_REGISTER,
+                MODBUS_COV_START_REGISTER + MODBUS_COV_MODBUS_REGISTERS - 1);
+  Serial.println("   +0-4: slot, start, count (0 = release), deadband, since (RW)");
+  Serial.println("   +5-8: sequence, changed count, first changed, flags");
+  Serial.println("   +10-22: change bitmap since SINCE (bit i = start + i)");
   Serial.println("==============================");
 }
 
 void printModbusClientConnections() {
   Serial.println("🔗 === MODBUS CLIENT CONNECTIONS ===");
   
-  if (currentModbusClient && currentModbusClient.connected()) {
-    Serial.printf("✅ Active Client: %s\n", currentModbusClient.remoteIP().toString().c_str());
-    Serial.printf("   Port: %d\n", currentModbusClient.remotePort());
-    Serial.printf("   Connected: %lu ms ago\n", millis() - modbusStats.lastRequestTime);
-  } else {
+  bool anyClient = false;
+  for (uint8_t slot = 0; slot < MODBUS_TCP_MAX_CLIENTS; slot++) {
+    uint32_t remoteIP = getModbusTransportRemoteIP(slot);
+    if (remoteIP == 0) continue;
+    Serial.printf("✅ Client %d: %s\n", slot, IPAddress(remoteIP).toString().c_str());
+    anyClient = true;
+  }
+  if (!anyClient) {
     Serial.println("❌ No active client connections");
   }
   
@@ -803,13 +1187,24 @@ bool writeMultipleRegisters(uint16_t startAddress, uint16_t count, uint16_t* val
     return false;
   }
   
-  for (int i = 0; i < count; i++) {
-    holdingRegisters[startAddress + i] = values[i];
-  }
-  
+  storeModbusRegisters(startAddress, values, count);
   return true;
 }
 
+void lockModbusRegisters() {
+  portENTER_CRITICAL(&registerMux);
+}
+
+void unlockModbusRegisters() {
+  portEXIT_CRITICAL(&registerMux);
+}
+
+void storeModbusRegisters(uint16_t startAddress, const uint16_t* values, uint16_t count) {
+  lockModbusRegisters();
+  memcpy(&holdingRegisters[startAddress], values, count * sizeof(uint16_t));
+  unlockModbusRegisters();
+}
+
 // === TRIO HP REGISTER MAPPING FUNCTIONS ===
 
 void updateTrioHPModbusRegisters() {
@@ -832,32 +1227,35 @@ void mapTrioHPSystemDataToModbus() {
   if (systemData == nullptr) return;
   
   uint16_t baseAddr = TRIO_HP_MODBUS_START_REGISTER; // 5000
+  uint16_t block[20];
   
   // System-wide data (registers 5000-5019)
-  holdingRegisters[baseAddr + 0] = floatToModbusRegister(getLatestValue(&systemData->systemDCVoltage), 1000);  // System DC voltage (mV)
-  holdingRegisters[baseAddr + 1] = floatToModbusRegister(getLatestValue(&systemData->systemDCCurrent), 1000);  // System DC current (mA)
-  holdingRegisters[baseAddr + 2] = systemData->totalActiveModules;                                             // Active module count
-  holdingRegisters[baseAddr + 3] = floatToModbusRegister(systemData->totalActivePower, 1);                    // Total active power (W)
-  holdingRegisters[baseAddr + 4] = floatToModbusRegister(systemData->totalReactivePower, 1);                  // Total reactive power (VAr)
-  holdingRegisters[baseAddr + 5] = floatToModbusRegister(systemData->averageFrequency, 1000);                 // Average frequency (mHz)
-  holdingRegisters[baseAddr + 6] = floatToModbusRegister(systemData->averageTemperature, 10);                 // Average temperature (0.1°C)
-  holdingRegisters[baseAddr + 7] = floatToModbusRegister(systemData->systemEfficiency, 10);                   // System efficiency (0.1%)
+  block[0] = floatToModbusRegister(getLatestValue(&systemData->systemDCVoltage), 1000);  // System DC voltage (mV)
+  block[1] = floatToModbusRegister(getLatestValue(&systemData->systemDCCurrent), 1000);  // System DC current (mA)
+  block[2] = systemData->totalActiveModules;                                             // Active module count
+  block[3] = floatToModbusRegister(systemData->totalActivePower, 1);                    // Total active power (W)
+  block[4] = floatToModbusRegister(systemData->totalReactivePower, 1);                  // Total reactive power (VAr)
+  block[5] = floatToModbusRegister(systemData->averageFrequency, 1000);                 // Average frequency (mHz)
+  block[6] = floatToModbusRegister(systemData->averageTemperature, 10);                 // Average temperature (0.1°C)
+  block[7] = floatToModbusRegister(systemData->systemEfficiency, 10);                   // System efficiency (0.1%)
   
   // System status (registers 5008-5015)
-  holdingRegisters[baseAddr + 8] = systemData->broadcastPollingActive ? 1 : 0;                                // Broadcast polling status
-  holdingRegisters[baseAddr + 9] = systemData->multicastPollingActive ? 1 : 0;                               // Multicast polling status
-  holdingRegisters[baseAddr + 10] = (systemData->totalPollsExecuted & 0xFFFF);                               // Total polls low
-  holdingRegisters[baseAddr + 11] = ((systemData->totalPollsExecuted >> 16) & 0xFFFF);                       // Total polls high
-  holdingRegisters[baseAddr + 12] = (systemData->successfulDataReads & 0xFFFF);                              // Successful reads low
-  holdingRegisters[baseAddr + 13] = ((systemData->successfulDataReads >> 16) & 0xFFFF);                      // Successful reads high
-  holdingRegisters[baseAddr + 14] = (systemData->dataParsingErrors & 0xFFFF);                                // Parse errors
-  holdingRegisters[baseAddr + 15] = floatToModbusRegister(systemData->averagePollResponseTime, 10);          // Avg response time (0.1ms)
+  block[8] = systemData->broadcastPollingActive ? 1 : 0;                                // Broadcast polling status
+  block[9] = systemData->multicastPollingActive ? 1 : 0;                               // Multicast polling status
+  block[10] = (systemData->totalPollsExecuted & 0xFFFF);                               // Total polls low
+  block[11] = ((systemData->totalPollsExecuted >> 16) & 0xFFFF);                       // Total polls high
+  block[12] = (systemData->successfulDataReads & 0xFFFF);                              // Successful reads low
+  block[13] = ((systemData->successfulDataReads >> 16) & 0xFFFF);                      // Successful reads high
+  block[14] = (systemData->dataParsingErrors & 0xFFFF);                                // Parse errors
+  block[15] = floatToModbusRegister(systemData->averagePollResponseTime, 10);          // Avg response time (0.1ms)
   
   // Reserved system registers (5016-5019)
-  holdingRegisters[baseAddr + 16] = 0; // Reserved
-  holdingRegisters[baseAddr + 17] = 0; // Reserved  
-  holdingRegisters[baseAddr + 18] = 0; // Reserved
-  holdingRegisters[baseAddr + 19] = 0; // Reserved
+  block[16] = 0; // Reserved
+  block[17] = 0; // Reserved  
+  block[18] = 0; // Reserved
+  block[19] = 0; // Reserved
+  
+  storeModbusRegisters(baseAddr, block, 20);
 }
 
 void mapTrioHPModuleDataToModbus(uint8_t moduleId) {
@@ -872,10 +1270,12 @@ void mapTrioHPModuleDataToModbus(uint8_t moduleId) {
   if (baseAddr + TRIO_HP_REGISTERS_PER_MODULE > TRIO_HP_MODBUS_END_REGISTER) return;
   
   // Map module data to 4 registers
-  holdingRegisters[baseAddr + 0] = floatToModbusRegister(getLatestValue(&moduleData->dcVoltage), 1000);       // DC voltage (mV)
-  holdingRegisters[baseAddr + 1] = floatToModbusRegister(getLatestValue(&moduleData->dcCurrent), 1000);       // DC current (mA)  
-  holdingRegisters[baseAddr + 2] = floatToModbusRegister(getLatestValue(&moduleData->activePowerTotal), 1);   // Active power (W)
-  holdingRegisters[baseAddr + 3] = floatToModbusRegister(getLatestValue(&moduleData->temperature), 10);       // Temperature (0.1°C)
+  uint16_t block[TRIO_HP_REGISTERS_PER_MODULE];
+  block[0] = floatToModbusRegister(getLatestValue(&moduleData->dcVoltage), 1000);       // DC voltage (mV)
+  block[1] = floatToModbusRegister(getLatestValue(&moduleData->dcCurrent), 1000);       // DC current (mA)  
+  block[2] = floatToModbusRegister(getLatestValue(&moduleData->activePowerTotal), 1);   // Active power (W)
+  block[3] = floatToModbusRegister(getLatestValue(&moduleData->temperature), 10);       // Temperature (0.1°C)
+  storeModbusRegisters(baseAddr, block, TRIO_HP_REGISTERS_PER_MODULE);
 }
 
 bool readTrioHPRegister(uint16_t address, uint16_t* value) {
@@ -899,7 +1299,7 @@ bool writeTrioHPRegister(uint16_t address, uint16_t value) {
   }
   
   // For now, reject all writes to TRIO HP registers
-  Serial.printf("Write rejected: TRIO HP register %d is read-only\n", address);
+  Serial.printf("Write rejected: TRIO HP register %d is read-only (value %d)\n", address, value);
   return false;
 }
 
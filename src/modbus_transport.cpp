@@ -0,0 +1,478 @@
+// =====================================================================
+// === modbus_transport.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Modbus TCP Transport (lwIP raw API)
+//    Version: v1.0.1
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.1 - 18.10.2026 - Fast-path request/byte counters, connection slot and session for COV; unused callback parameters unnamed
+//    v1.0.0 - 18.10.2026 - Listener on the lwIP raw API, MBAP reassembly from pbufs, reads served in the receive callback
+//
+// 🎯 DEPENDENCIES:
+//    Internal: modbus_transport.h, modbus_tcp.h, statistics.h
+//    External: lwIP raw TCP API
+//
+// 📝 DESCRIPTION:
+//    See modbus_transport.h. Functions without a main loop entry point run
+//    in the lwIP thread (callbacks and tcpip_api_call bodies). A connection
+//    slot is shared with the main loop only through `pending`: set here
+//    after the ADU is in rx, cleared by completeModbusTransport().
+//
+// 🔧 CONFIGURATION:
+//    - Slots: MODBUS_TCP_MAX_CLIENTS
+//
+// ⚠️  KNOWN ISSUES:
+//    - A connection closed with a response still unacknowledged is aborted
+//      instead of closed: the TX buffer it is sent from belongs to the slot
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: host test test_modbus_transport (fake lwIP)
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Receive: one header read per ADU, pbuf_free_header() for what was used
+//    - Memory: ~1.6KB for 3 slots
+//
+// =====================================================================
+
+#include "modbus_transport.h"
+#include "modbus_tcp.h"
+#include "statistics.h"
+#include "lwip/tcp.h"
+#include "lwip/priv/tcpip_priv.h"
+
+struct ModbusConnection {
+  struct tcp_pcb* pcb;              // nullptr once lwIP dropped it
+  bool inUse;                       // Slot taken (kept while the main loop holds an ADU)
+  bool pending;                     // ADU in rx for the main loop (atomic)
+  bool stalled;                     // Waiting for send buffer
+  struct pbuf* held;                // Received, not yet consumed
+  uint16_t rxLength;
+  uint16_t aduLength;               // From the MBAP header, valid once rxLength >= 7
+  unsigned long aduStartUs;         // First byte of the current ADU taken
+  unsigned long lastActivity;
+  uint32_t remoteIP;
+  uint32_t session;                 // Accept number, tells a new client in a reused slot
+  uint32_t txQueued;                // Bytes written since accept
+  uint32_t txAcked;
+  uint32_t txBufferEnd;             // txQueued after the last no-copy write of tx
+  uint8_t rx[MODBUS_MAX_FRAME_SIZE];
+  uint8_t tx[MODBUS_MAX_FRAME_SIZE];
+};
+
+typedef struct {
+  struct tcpip_api_call_data call;  // First: tcpip_api_call() hands this pointer back
+  ModbusConnection_t* conn;
+  const uint8_t* data;
+  int length;
+  uint16_t port;
+  bool ok;
+} TransportCall_t;
+
+static ModbusConnection_t connections[MODBUS_TCP_MAX_CLIENTS];
+static struct tcp_pcb* listenPcb = nullptr;
+static ModbusTransportStats_t transportStats;
+static uint32_t lastSession = 0;
+
+static err_t onModbusRecv(void* arg, struct tcp_pcb* pcb, struct pbuf* p, err_t err);
+static err_t onModbusSent(void* arg, struct tcp_pcb* pcb, u16_t len);
+static void onModbusError(void* arg, err_t err);
+static err_t onModbusPoll(void* arg, struct tcp_pcb* pcb);
+
+// === CONNECTION HELPERS (lwIP thread) ===
+
+static uint16_t getMbapAduLength(const uint8_t* header) {
+  return 6 + ((header[MODBUS_MBAP_LENGTH_OFFSET] << 8) | header[MODBUS_MBAP_LENGTH_OFFSET + 1]);
+}
+
+static bool isMbapLengthValid(uint16_t aduLength) {
+  return aduLength > MODBUS_MBAP_HEADER_SIZE && aduLength <= MODBUS_MAX_FRAME_SIZE;
+}
+
+static bool isTxBufferFree(const ModbusConnection_t* conn) {
+  return (int32_t)(conn->txAcked - conn->txBufferEnd) >= 0;
+}
+
+// Room for the largest response, so a taken ADU can always be answered
+static bool hasSendRoom(const ModbusConnection_t* conn) {
+  return tcp_sndbuf(conn->pcb) >= MODBUS_MAX_FRAME_SIZE &&
+         tcp_sndqueuelen(conn->pcb) + 2 < TCP_SND_QUEUELEN;
+}
+
+static void clearCallbacks(struct tcp_pcb* pcb) {
+  tcp_arg(pcb, nullptr);
+  tcp_recv(pcb, nullptr);
+  tcp_sent(pcb, nullptr);
+  tcp_err(pcb, nullptr);
+  tcp_poll(pcb, nullptr, 0);
+}
+
+// pcb already released or about to be
+static void detachConnection(ModbusConnection_t* conn) {
+  if (conn->held != nullptr) {
+    pbuf_free(conn->held);
+    conn->held = nullptr;
+  }
+  conn->pcb = nullptr;
+  transportStats.closed++;
+  transportStats.activeConnections--;
+  if (!__atomic_load_n(&conn->pending, __ATOMIC_ACQUIRE)) conn->inUse = false;
+}
+
+static err_t abortConnection(ModbusConnection_t* conn) {
+  struct tcp_pcb* pcb = conn->pcb;
+  clearCallbacks(pcb);
+  detachConnection(conn);
+  tcp_abort(pcb);
+  return ERR_ABRT;
+}
+
+static err_t closeConnection(ModbusConnection_t* conn) {
+  // Unacknowledged no-copy data would be retransmitted from tx after the slot is reused
+  if (!isTxBufferFree(conn)) return abortConnection(conn);
+  struct tcp_pcb* pcb = conn->pcb;
+  clearCallbacks(pcb);
+  detachConnection(conn);
+  if (tcp_close(pcb) != ERR_OK) {
+    tcp_abort(pcb);
+    return ERR_ABRT;
+  }
+  return ERR_OK;
+}
+
+static bool writeResponse(ModbusConnection_t* conn, const uint8_t* data, int length, bool fromTx) {
+  err_t err = tcp_write(conn->pcb, data, length, fromTx ? 0 : TCP_WRITE_FLAG_COPY);
+  if (err != ERR_OK) {
+    transportStats.txErrors++;
+    return false;
+  }
+  conn->txQueued += length;
+  if (fromTx) conn->txBufferEnd = conn->txQueued;
+  tcp_output(conn->pcb);
+  transportStats.bytesSent += length;
+  return true;
+}
+
+// Reads of the register table are answered here, the rest goes to the main loop
+static void serveADU(ModbusConnection_t* conn, const uint8_t* adu, uint16_t length) {
+  uint8_t scratch[MODBUS_MAX_FRAME_SIZE];
+  bool txFree = isTxBufferFree(conn);
+  uint8_t* response = txFree ? conn->tx : scratch;
+
+  int responseLength = buildModbusReadResponse(adu, length, response);
+  if (responseLength > 0) {
+    if (!txFree) transportStats.copiedResponses++;
+    transportStats.fastRequests++;
+    transportStats.fastBytesReceived += length;
+    transportStats.lastFastRequestMs = millis();
+    if (writeResponse(conn, response, responseLength, txFree)) {
+      transportStats.fastResponses++;
+      transportStats.fastBytesSent += responseLength;
+    }
+    recordLatency(LATENCY_MODBUS_REQUEST, micros() - conn->aduStartUs);
+    return;
+  }
+
+  if (adu != conn->rx) memcpy(conn->rx, adu, length);
+  conn->rxLength = length;
+  transportStats.queuedRequests++;
+  __atomic_store_n(&conn->pending, true, __ATOMIC_RELEASE);
+}
+
+static void consumeHeld(ModbusConnection_t* conn, uint16_t length) {
+  conn->held = pbuf_free_header(conn->held, length);
+  tcp_recved(conn->pcb, length);
+}
+
+// Cuts held pbufs into ADUs; false if the connection was aborted
+static bool feedConnection(ModbusConnection_t* conn) {
+  while (conn->held != nullptr && !conn->pending) {
+    if (!hasSendRoom(conn)) {
+      if (!conn->stalled) transportStats.stalls++;
+      conn->stalled = true;
+      return true;                  // Resumed from onModbusSent()
+    }
+    conn->stalled = false;
+    struct pbuf* p = conn->held;
+
+    // Whole ADU in the first segment: served in place
+    if (conn->rxLength == 0 && p->len >= MODBUS_MBAP_HEADER_SIZE) {
+      const uint8_t* adu = (const uint8_t*)p->payload;
+      uint16_t aduLength = getMbapAduLength(adu);
+      if (!isMbapLengthValid(aduLength)) {
+        transportStats.framingErrors++;
+        abortConnection(conn);
+        return false;
+      }
+      if (p->len >= aduLength) {
+        conn->aduStartUs = micros();
+        serveADU(conn, adu, aduLength);
+        consumeHeld(conn, aduLength);
+        continue;
+      }
+    }
+
+    // Split across segments: header first, then the rest of the ADU, into rx
+    if (conn->rxLength == 0) conn->aduStartUs = micros();
+    bool header = conn->rxLength < MODBUS_MBAP_HEADER_SIZE;
+    uint16_t target = header ? MODBUS_MBAP_HEADER_SIZE : conn->aduLength;
+    uint16_t length = min((uint16_t)(target - conn->rxLength), p->tot_len);
+    pbuf_copy_partial(p, conn->rx + conn->rxLength, length, 0);
+    conn->rxLength += length;
+    consumeHeld(conn, length);
+    if (conn->rxLength < target) continue;
+
+    if (header) {
+      conn->aduLength = getMbapAduLength(conn->rx);
+      if (!isMbapLengthValid(conn->aduLength)) {
+        transportStats.framingErrors++;
+        abortConnection(conn);
+        return false;
+      }
+    } else {
+      transportStats.reassembled++;
+      serveADU(conn, conn->rx, conn->aduLength);
+      if (!conn->pending) conn->rxLength = 0;
+    }
+  }
+  return true;
+}
+
+// === LWIP CALLBACKS ===
+
+static err_t onModbusAccept(void*, struct tcp_pcb* pcb, err_t err) {
+  if (err != ERR_OK || pcb == nullptr) return ERR_VAL;
+
+  ModbusConnection_t* conn = nullptr;
+  for (int i = 0; i < MODBUS_TCP_MAX_CLIENTS; i++) {
+    if (!connections[i].inUse) {
+      conn = &connections[i];
+      break;
+    }
+  }
+  if (conn == nullptr) {
+    transportStats.rejected++;
+    tcp_abort(pcb);
+    return ERR_ABRT;
+  }
+
+  conn->pcb = pcb;
+  conn->inUse = true;
+  conn->pending = false;
+  conn->stalled = false;
+  conn->held = nullptr;
+  conn->rxLength = 0;
+  conn->aduLength = 0;
+  conn->lastActivity = millis();
+  conn->remoteIP = ip4_addr_get_u32(ip_2_ip4(&pcb->remote_ip));
+  conn->session = ++lastSession;
+  conn->txQueued = 0;
+  conn->txAcked = 0;
+  conn->txBufferEnd = 0;
+
+  tcp_nagle_disable(pcb);
+  tcp_arg(pcb, conn);
+  tcp_recv(pcb, onModbusRecv);
+  tcp_sent(pcb, onModbusSent);
+  tcp_err(pcb, onModbusError);
+  tcp_poll(pcb, onModbusPoll, MODBUS_TRANSPORT_POLL_INTERVAL);
+
+  transportStats.accepted++;
+  transportStats.activeConnections++;
+  return ERR_OK;
+}
+
+static err_t onModbusRecv(void* arg, struct tcp_pcb* pcb, struct pbuf* p, err_t err) {
+  ModbusConnection_t* conn = (ModbusConnection_t*)arg;
+  if (conn == nullptr) {
+    if (p != nullptr) {
+      tcp_recved(pcb, p->tot_len);
+      pbuf_free(p);
+    }
+    return ERR_OK;
+  }
+  if (p == nullptr) return closeConnection(conn);   // Closed by the client
+  if (err != ERR_OK) {
+    pbuf_free(p);
+    return err;
+  }
+
+  transportStats.bytesReceived += p->tot_len;
+  conn->lastActivity = millis();
+  if (conn->held != nullptr) {
+    pbuf_cat(conn->held, p);
+  } else {
+    conn->held = p;
+  }
+  return feedConnection(conn) ? ERR_OK : ERR_ABRT;
+}
+
+static err_t onModbusSent(void* arg, struct tcp_pcb*, u16_t len) {
+  ModbusConnection_t* conn = (ModbusConnection_t*)arg;
+  if (conn == nullptr) return ERR_OK;
+  conn->txAcked += len;
+  if (conn->stalled) return feedConnection(conn) ? ERR_OK : ERR_ABRT;
+  return ERR_OK;
+}
+
+static void onModbusError(void* arg, err_t) {
+  ModbusConnection_t* conn = (ModbusConnection_t*)arg;
+  if (conn == nullptr) return;
+  detachConnection(conn);           // lwIP has freed the pcb
+}
+
+static err_t onModbusPoll(void* arg, struct tcp_pcb*) {
+  ModbusConnection_t* conn = (ModbusConnection_t*)arg;
+  if (conn == nullptr || conn->pending) return ERR_OK;
+  if (millis() - conn->lastActivity < MODBUS_TCP_TIMEOUT_MS) return ERR_OK;
+  transportStats.idleClosed++;
+  return closeConnection(conn);
+}
+
+// === TCPIP_API_CALL BODIES ===
+
+static err_t doStart(struct tcpip_api_call_data* data) {
+  TransportCall_t* call = (TransportCall_t*)data;
+  call->ok = false;
+  struct tcp_pcb* pcb = tcp_new();
+  if (pcb == nullptr) return ERR_MEM;
+  if (tcp_bind(pcb, IP_ADDR_ANY, call->port) != ERR_OK) {
+    tcp_close(pcb);
+    return ERR_USE;
+  }
+  listenPcb = tcp_listen_with_backlog(pcb, MODBUS_TRANSPORT_BACKLOG);
+  if (listenPcb == nullptr) {
+    tcp_close(pcb);
+    return ERR_MEM;
+  }
+  tcp_accept(listenPcb, onModbusAccept);
+  call->ok = true;
+  return ERR_OK;
+}
+
+static err_t doStop(struct tcpip_api_call_data*) {
+  for (int i = 0; i < MODBUS_TCP_MAX_CLIENTS; i++) {
+    ModbusConnection_t* conn = &connections[i];
+    if (conn->pcb != nullptr) abortConnection(conn);
+    conn->pending = false;
+    conn->inUse = false;
+  }
+  if (listenPcb != nullptr) {
+    tcp_accept(listenPcb, nullptr);
+    tcp_close(listenPcb);
+    listenPcb = nullptr;
+  }
+  return ERR_OK;
+}
+
+static err_t doSend(struct tcpip_api_call_data* data) {
+  TransportCall_t* call = (TransportCall_t*)data;
+  call->ok = call->conn->pcb != nullptr &&
+             writeResponse(call->conn, call->data, call->length, false);
+  return ERR_OK;
+}
+
+static err_t doComplete(struct tcpip_api_call_data* data) {
+  ModbusConnection_t* conn = ((TransportCall_t*)data)->conn;
+  recordLatency(LATENCY_MODBUS_REQUEST, micros() - conn->aduStartUs);
+  conn->rxLength = 0;
+  __atomic_store_n(&conn->pending, false, __ATOMIC_RELEASE);
+  if (conn->pcb == nullptr) {
+    conn->inUse = false;            // Closed while the main loop held the ADU
+    return ERR_OK;
+  }
+  feedConnection(conn);             // ADUs received meanwhile
+  return ERR_OK;
+}
+
+// === LISTENER ===
+
+bool startModbusTransport(uint16_t port) {
+  memset(connections, 0, sizeof(connections));
+  memset(&transportStats, 0, sizeof(transportStats));
+
+  TransportCall_t call = {};
+  call.port = port;
+  tcpip_api_call(doStart, &call.call);
+  if (!call.ok) {
+    Serial.printf("❌ Modbus transport: cannot listen on port %d\n", port);
+    return false;
+  }
+  Serial.printf("🔗 Modbus transport: lwIP raw API, port %d, %d connections, Nagle off\n",
+                port, MODBUS_TCP_MAX_CLIENTS);
+  return true;
+}
+
+void stopModbusTransport() {
+  TransportCall_t call = {};
+  tcpip_api_call(doStop, &call.call);
+}
+
+// === MAIN LOOP SIDE ===
+
+ModbusConnection_t* getModbusTransportRequest(uint8_t slot, uint8_t** request, int* length) {
+  if (slot >= MODBUS_TCP_MAX_CLIENTS) return nullptr;
+  ModbusConnection_t* conn = &connections[slot];
+  if (!__atomic_load_n(&conn->pending, __ATOMIC_ACQUIRE)) return nullptr;
+  *request = conn->rx;
+  *length = conn->rxLength;
+  return conn;
+}
+
+bool sendModbusTransport(ModbusConnection_t* conn, const uint8_t* response, int length) {
+  TransportCall_t call = {};
+  call.conn = conn;
+  call.data = response;
+  call.length = length;
+  tcpip_api_call(doSend, &call.call);
+  return call.ok;
+}
+
+void completeModbusTransport(ModbusConnection_t* conn) {
+  TransportCall_t call = {};
+  call.conn = conn;
+  tcpip_api_call(doComplete, &call.call);
+}
+
+// Valid while the main loop holds the connection's ADU
+uint8_t getModbusTransportSlot(const ModbusConnection_t* conn) {
+  return (uint8_t)(conn - connections);
+}
+
+uint32_t getModbusTransportSession(const ModbusConnection_t* conn) {
+  return conn->session;
+}
+
+// === STATISTICS ===
+
+const ModbusTransportStats_t* getModbusTransportStats() {
+  return &transportStats;
+}
+
+uint32_t getModbusTransportRemoteIP(uint8_t slot) {
+  if (slot >= MODBUS_TCP_MAX_CLIENTS || connections[slot].pcb == nullptr) return 0;
+  return connections[slot].remoteIP;
+}
+
+void printModbusTransportStatus() {
+  const ModbusTransportStats_t* s = &transportStats;
+  Serial.printf("🔗 Transport: %d open, %lu accepted, %lu rejected, %lu closed (%lu idle)\n",
+                s->activeConnections, s->accepted, s->rejected, s->closed, s->idleClosed);
+  Serial.printf("   Requests: %lu in callback, %lu via main loop, %lu reassembled\n",
+                s->fastRequests, s->queuedRequests, s->reassembled);
+  Serial.printf("   Errors: %lu framing, %lu TX; %lu stalls, %lu copied responses\n",
+                s->framingErrors, s->txErrors, s->stalls, s->copiedResponses);
+  Serial.printf("   Data: %lu bytes received, %lu bytes sent\n", s->bytesReceived, s->bytesSent);
+}
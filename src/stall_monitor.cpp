@@ -0,0 +1,493 @@
+// =====================================================================
+// === stall_monitor.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Loop Stall Watchdog and Profiling Zones Implementation
+//    Version: v1.3.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Zone timing, stall records with backtrace, ranked sources
+//    v1.1.0 - 18.10.2026 - Per-zone service gap (worst time between two entries)
+//    v1.2.0 - 18.10.2026 - Watchdog samples the main task's stack while a zone is still stalled
+//    v1.3.0 - 18.10.2026 - Watchdog is a low-priority task that never suspends the loop; a busy
+//                          loop is reported with the call site of the zone it entered
+//
+// 🎯 DEPENDENCIES:
+//    Internal: stall_monitor.h
+//    External: Arduino.h, esp_debug_helpers.h, freertos/task_snapshot.h
+//
+// 📝 DESCRIPTION:
+//    The zone stack is only touched by the main loop task. A zone frame
+//    remembers how long its nested zones ran (for exclusive time) and
+//    whether one of them was already recorded as a stall, so one slow
+//    EEPROM commit is reported once and not again for every enclosing
+//    zone. The watchdog task reads a few volatile words published by the
+//    loop (zone, zone frame, call site that entered the zone); records
+//    shared with it are guarded by a spinlock.
+//
+//    Once the innermost zone is past the stall threshold and the main task
+//    is blocked, the watchdog unwinds its saved context from a task
+//    snapshot: the backtrace shows the call that is blocking (delay(), a
+//    full Serial TX buffer, commit()), not the place where the zone is
+//    closed. The loop is never suspended: while it is busy on its core
+//    there is no saved context to unwind, and the watchdog only keeps the
+//    published call site. The sample is keyed by the zone frame and picked
+//    up by recordStall() when that frame is left. Stalls without a sample
+//    fall back to the backtrace at the zone's exit.
+//
+// =====================================================================
+
+#include "stall_monitor.h"
+#if defined(__XTENSA__)
+#include <esp_debug_helpers.h>
+#include <freertos/task_snapshot.h>
+#include <xtensa_context.h>
+#endif
+
+// Frames of the monitor itself at the start of a backtrace:
+// captureBacktrace, recordStall, leaveProfileZone/stallLoopEnd
+#define STALL_BACKTRACE_SKIP 3
+
+// === ZONE STACK (main loop task) ===
+typedef struct {
+  uint8_t zone;
+  bool childStalled;                // A nested zone was already recorded
+  unsigned long startUs;
+  unsigned long childUs;            // Time spent in nested zones
+  uint32_t site;                    // Call site that entered the zone
+} ZoneFrame_t;
+
+// === GLOBAL VARIABLES ===
+static ZoneFrame_t zoneStack[STALL_ZONE_STACK_DEPTH];
+static uint8_t zoneDepth = 0;
+static uint8_t zoneOverflow = 0;    // Zones entered past the stack depth
+static unsigned long zoneLastEnterUs[PROFILE_ZONE_COUNT];   // 0 = no entry since the last gap reset
+static volatile bool gapResetPending = false;               // Applied by the main loop
+
+static StallSource_t stallSources[STALL_MAX_SOURCES];
+static uint8_t stallSourceCount = 0;
+static StallEvent_t recentStalls[STALL_RECENT_COUNT];
+static uint8_t recentHead = 0;
+static StallStats_t stallStats;
+static portMUX_TYPE stallMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t watchdogTask = nullptr;
+
+// Published for the watchdog tick
+static volatile bool loopActive = false;
+static volatile unsigned long loopStartUs = 0;
+static volatile uint8_t activeZone = PROFILE_ZONE_LOOP;
+static volatile uint8_t activeParentZone = PROFILE_ZONE_LOOP;
+static volatile bool liveReported = false;
+static volatile uint8_t activeFrameIndex = 0;
+static volatile unsigned long activeZoneStartUs = 0;
+static volatile uint32_t activeZoneSite = 0;
+
+// Main task stack sampled by the watchdog while a zone frame is stalled (stallMux)
+typedef struct {
+  uint8_t frameIndex;               // Zone stack index and entry time identify the frame
+  unsigned long frameStartUs;
+  uint8_t depth;                    // 0 = no sample pending
+  uint32_t backtrace[STALL_BACKTRACE_DEPTH];
+} StallSample_t;
+
+static StallSample_t stallSample;
+static TaskHandle_t mainTask = nullptr;
+
+// === HELPERS ===
+
+static void publishActiveZone() {
+  activeZone = zoneDepth > 0 ? zoneStack[zoneDepth - 1].zone : (uint8_t)PROFILE_ZONE_LOOP;
+  activeParentZone = zoneDepth > 1 ? zoneStack[zoneDepth - 2].zone : (uint8_t)PROFILE_ZONE_LOOP;
+  activeFrameIndex = zoneDepth > 0 ? zoneDepth - 1 : 0;
+  activeZoneStartUs = zoneDepth > 0 ? zoneStack[zoneDepth - 1].startUs : 0;
+  activeZoneSite = zoneDepth > 0 ? zoneStack[zoneDepth - 1].site : 0;
+}
+
+static void addRecentStall(uint8_t zone, uint8_t parent, bool live, unsigned long us, uint32_t site) {
+  StallEvent_t* e = &recentStalls[recentHead & (STALL_RECENT_COUNT - 1)];
+  e->zone = zone;
+  e->parentZone = parent;
+  e->live = live;
+  e->durationUs = us;
+  e->at = millis();
+  e->site = site;
+  recentHead++;
+}
+
+#if defined(__XTENSA__)
+// Windowed call: top bits hold the window size, return address points past the call
+static uint32_t toCallSite(uint32_t returnAddress) {
+  return ((returnAddress & 0x3FFFFFFFUL) | 0x40000000UL) - 3;
+}
+#else
+static uint32_t toCallSite(uint32_t returnAddress) {
+  return returnAddress;
+}
+#endif
+
+#if defined(__XTENSA__)
+
+// Unwind a context saved on a task's stack by a context switch
+static uint8_t unwindSavedContext(void* topOfStack, uint32_t* pcs, uint8_t max) {
+  const XtExcFrame* exc = (const XtExcFrame*)topOfStack;
+  esp_backtrace_frame_t frame = {};
+  uint8_t n = 0;
+  if (exc->exit != 0) {
+    // Preempted: interrupt frame, the PC is exact
+    frame.pc = exc->pc;
+    frame.sp = exc->a1;
+    frame.next_pc = exc->a0;
+    if (max > 0) pcs[n++] = exc->pc;
+  } else {
+    // Blocked: solicited frame on vPortYield's stack, windows spilled; the first
+    // caller is the blocking call (vTaskDelay, xQueueReceive, ...)
+    const XtSolFrame* sol = (const XtSolFrame*)topOfStack;
+    frame.sp = (uint32_t)(uintptr_t)topOfStack;
+    frame.next_pc = sol->pc;
+  }
+  while (n < max && esp_backtrace_get_next_frame(&frame)) {
+    pcs[n++] = toCallSite(frame.pc);
+  }
+  return n;
+}
+#endif
+
+// Watchdog: backtrace of the main loop task while it is switched out (blocked or
+// preempted); 0 while it is running - it is never stopped to be sampled
+static uint8_t sampleMainTaskBacktrace(uint32_t* pcs, uint8_t max) {
+  uint8_t n = 0;
+#if defined(__XTENSA__)
+  if (mainTask == nullptr || eTaskGetState(mainTask) == eRunning) return 0;
+  TaskSnapshot_t before;
+  vTaskGetSnapshot(mainTask, &before);
+  n = unwindSavedContext(before.pxTopOfStack, pcs, max);
+  // Discard the unwind if the task ran in the meantime
+  TaskSnapshot_t after;
+  vTaskGetSnapshot(mainTask, &after);
+  if (after.pxTopOfStack != before.pxTopOfStack || eTaskGetState(mainTask) == eRunning) n = 0;
+#else
+  (void)pcs;
+  (void)max;
+#endif
+  return n;
+}
+
+static uint8_t __attribute__((noinline)) captureBacktrace(uint32_t* pcs, uint8_t max) {
+  uint8_t n = 0;
+#if defined(__XTENSA__)
+  esp_backtrace_frame_t frame;
+  esp_backtrace_get_start(&frame.pc, &frame.sp, &frame.next_pc);
+  uint8_t skip = STALL_BACKTRACE_SKIP - 1;  // get_start already yields this frame
+  while (n < max && esp_backtrace_get_next_frame(&frame)) {
+    if (skip > 0) {
+      skip--;
+      continue;
+    }
+    pcs[n++] = toCallSite(frame.pc);
+  }
+#else
+  if (max > 0) pcs[n++] = (uint32_t)(uintptr_t)__builtin_return_address(0);
+#endif
+  return n;
+}
+
+static void __attribute__((noinline)) recordStall(uint8_t zone, uint8_t parent, unsigned long us,
+                                                  uint8_t frameIndex, unsigned long frameStartUs) {
+  uint32_t backtrace[STALL_BACKTRACE_DEPTH];
+  uint8_t depth = 0;
+  portENTER_CRITICAL(&stallMux);
+  if (stallSample.depth > 0 && stallSample.frameIndex == frameIndex && stallSample.frameStartUs == frameStartUs) {
+    depth = stallSample.depth;
+    memcpy(backtrace, stallSample.backtrace, depth * sizeof(uint32_t));
+  }
+  stallSample.depth = 0;
+  portEXIT_CRITICAL(&stallMux);
+
+  // Ended before the watchdog sampled it: the zone's exit is the best site available
+  bool sampled = depth > 0;
+  if (!sampled) depth = captureBacktrace(backtrace, STALL_BACKTRACE_DEPTH);
+  uint32_t site = depth > 0 ? backtrace[0] : 0;
+
+  portENTER_CRITICAL(&stallMux);
+  stallStats.stalls++;
+  if (us > stallStats.longestUs) stallStats.longestUs = us;
+  addRecentStall(zone, parent, false, us, site);
+
+  StallSource_t* source = nullptr;
+  for (uint8_t i = 0; i < stallSourceCount; i++) {
+    if (stallSources[i].zone == zone && stallSources[i].site == site) {
+      source = &stallSources[i];
+      break;
+    }
+  }
+  if (source == nullptr && stallSourceCount < STALL_MAX_SOURCES) {
+    source = &stallSources[stallSourceCount++];
+    memset(source, 0, sizeof(StallSource_t));
+    source->zone = zone;
+    source->site = site;
+  }
+  if (source == nullptr) {
+    stallStats.droppedSources++;
+  } else {
+    source->parentZone = parent;
+    source->count++;
+    source->totalUs += us;
+    source->lastAt = millis();
+    if (us >= source->maxUs) {
+      source->maxUs = us;
+      memcpy(source->backtrace, backtrace, depth * sizeof(uint32_t));
+      source->depth = depth;
+      source->sampled = sampled;
+    }
+  }
+  portEXIT_CRITICAL(&stallMux);
+}
+
+// Watchdog: sample the stack of a zone past the threshold, report a pass that
+// started too long ago while the main loop is still inside it
+static void stallWatchdogTick() {
+  static uint8_t sampledFrameIndex = 0;
+  static unsigned long sampledFrameStartUs = 0;
+  if (!loopActive) return;
+
+  unsigned long now = micros();
+  uint8_t frameIndex = activeFrameIndex;
+  unsigned long frameStartUs = activeZoneStartUs;
+  bool frameSampled = frameIndex == sampledFrameIndex && frameStartUs == sampledFrameStartUs;
+  if (!frameSampled && now - frameStartUs > STALL_THRESHOLD_US) {
+    uint32_t backtrace[STALL_BACKTRACE_DEPTH];
+    uint8_t depth = sampleMainTaskBacktrace(backtrace, STALL_BACKTRACE_DEPTH);
+    // Keep it only if the same frame is still active (not left during the unwind)
+    if (depth > 0 && activeFrameIndex == frameIndex && activeZoneStartUs == frameStartUs) {
+      sampledFrameIndex = frameIndex;
+      sampledFrameStartUs = frameStartUs;
+      portENTER_CRITICAL(&stallMux);
+      stallSample.frameIndex = frameIndex;
+      stallSample.frameStartUs = frameStartUs;
+      memcpy(stallSample.backtrace, backtrace, depth * sizeof(uint32_t));
+      stallSample.depth = depth;
+      portEXIT_CRITICAL(&stallMux);
+    }
+  }
+
+  if (liveReported) return;
+  unsigned long elapsed = now - loopStartUs;
+  if (elapsed < STALL_WATCHDOG_REPORT_MS * 1000UL) return;
+
+  // Where it is stuck now (a hang may never reach recordStall); busy: the zone's call site
+  uint32_t backtrace[STALL_BACKTRACE_DEPTH];
+  uint8_t depth = sampleMainTaskBacktrace(backtrace, STALL_BACKTRACE_DEPTH);
+  if (depth == 0 && activeZoneSite != 0) backtrace[depth++] = activeZoneSite;
+  liveReported = true;
+  portENTER_CRITICAL(&stallMux);
+  stallStats.liveStalls++;
+  memcpy(stallStats.liveBacktrace, backtrace, depth * sizeof(uint32_t));
+  stallStats.liveDepth = depth;
+  addRecentStall(activeZone, activeParentZone, true, elapsed, depth > 0 ? backtrace[0] : 0);
+  portEXIT_CRITICAL(&stallMux);
+}
+
+static void stallWatchdogTask(void*) {
+  TickType_t lastWake = xTaskGetTickCount();
+  for (;;) {
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(STALL_WATCHDOG_TICK_MS));
+    stallWatchdogTick();
+  }
+}
+
+// === MONITOR FUNCTIONS ===
+
+bool initStallMonitor() {
+  if (watchdogTask != nullptr) return true;
+
+  memset(&stallStats, 0, sizeof(stallStats));
+  stallSourceCount = 0;
+  recentHead = 0;
+  mainTask = xTaskGetCurrentTaskHandle();   // Called from setup() on the loop task
+
+  if (xTaskCreatePinnedToCore(stallWatchdogTask, "stall_wdt", STALL_WATCHDOG_TASK_STACK_SIZE, nullptr,
+                              STALL_WATCHDOG_TASK_PRIORITY, &watchdogTask, STALL_WATCHDOG_TASK_CORE) != pdPASS) {
+    Serial.println("❌ Stall watchdog task could not be created");
+    watchdogTask = nullptr;
+    return false;
+  }
+  Serial.printf("🐢 Stall monitor: threshold %lums, watchdog %lums\n",
+                (unsigned long)(STALL_THRESHOLD_US / 1000), (unsigned long)STALL_WATCHDOG_REPORT_MS);
+  return true;
+}
+
+void stallLoopBegin() {
+  if (gapResetPending) {
+    gapResetPending = false;
+    memset(zoneLastEnterUs, 0, sizeof(zoneLastEnterUs));
+    memset(stallStats.zoneMaxGapUs, 0, sizeof(stallStats.zoneMaxGapUs));
+  }
+  zoneDepth = 0;
+  zoneOverflow = 0;
+  liveReported = false;
+  loopStartUs = micros();
+  enterProfileZone(PROFILE_ZONE_LOOP);
+  loopActive = true;
+}
+
+void __attribute__((noinline)) stallLoopEnd() {
+  if (zoneDepth == 0) return;
+  // Close zones left open by an early return without a scope guard
+  while (zoneDepth > 1) leaveProfileZone();
+
+  ZoneFrame_t* frame = &zoneStack[0];
+  unsigned long elapsed = micros() - frame->startUs;
+  unsigned long exclusive = elapsed - frame->childUs;
+  loopActive = false;
+  zoneDepth = 0;
+  publishActiveZone();
+
+  stallStats.loopPasses++;
+  stallStats.zoneUs[PROFILE_ZONE_LOOP] += exclusive;
+  if (exclusive > stallStats.zoneMaxUs[PROFILE_ZONE_LOOP]) stallStats.zoneMaxUs[PROFILE_ZONE_LOOP] = exclusive;
+  if (elapsed > STALL_THRESHOLD_US && !frame->childStalled) {
+    recordStall(PROFILE_ZONE_LOOP, PROFILE_ZONE_LOOP, elapsed, 0, frame->startUs);
+  }
+}
+
+uint8_t __attribute__((noinline)) enterProfileZone(uint8_t zone) {
+  uint8_t parent = zoneDepth > 0 ? zoneStack[zoneDepth - 1].zone : (uint8_t)PROFILE_ZONE_LOOP;
+  if (zoneDepth >= STALL_ZONE_STACK_DEPTH) {
+    zoneOverflow++;
+    return parent;
+  }
+  ZoneFrame_t* frame = &zoneStack[zoneDepth++];
+  frame->zone = zone < PROFILE_ZONE_COUNT ? zone : (uint8_t)PROFILE_ZONE_LOOP;
+  frame->childStalled = false;
+  frame->childUs = 0;
+  frame->startUs = micros();
+  frame->site = toCallSite((uint32_t)(uintptr_t)__builtin_return_address(0));
+  if (zoneLastEnterUs[frame->zone] != 0) {
+    unsigned long gap = frame->startUs - zoneLastEnterUs[frame->zone];
+    if (gap > stallStats.zoneMaxGapUs[frame->zone]) stallStats.zoneMaxGapUs[frame->zone] = gap;
+  }
+  zoneLastEnterUs[frame->zone] = frame->startUs;
+  publishActiveZone();
+  return parent;
+}
+
+void __attribute__((noinline)) leaveProfileZone() {
+  if (zoneOverflow > 0) {
+    zoneOverflow--;
+    return;
+  }
+  if (zoneDepth <= 1) return;       // The loop frame is closed by stallLoopEnd()
+
+  ZoneFrame_t* frame = &zoneStack[--zoneDepth];
+  ZoneFrame_t* parent = &zoneStack[zoneDepth - 1];
+  unsigned long elapsed = micros() - frame->startUs;
+  unsigned long exclusive = elapsed - frame->childUs;
+  publishActiveZone();
+
+  stallStats.zoneUs[frame->zone] += exclusive;
+  if (exclusive > stallStats.zoneMaxUs[frame->zone]) stallStats.zoneMaxUs[frame->zone] = exclusive;
+  parent->childUs += elapsed;
+
+  if (frame->childStalled) {
+    parent->childStalled = true;
+  } else if (elapsed > STALL_THRESHOLD_US) {
+    recordStall(frame->zone, parent->zone, elapsed, zoneDepth, frame->startUs);
+    parent->childStalled = true;
+  }
+}
+
+// === REPORTS ===
+
+uint8_t getStallSources(StallSource_t* out, uint8_t max) {
+  if (out == nullptr) return 0;
+  portENTER_CRITICAL(&stallMux);
+  uint8_t n = stallSourceCount < max ? stallSourceCount : max;
+  // Insertion sort by total stalled time, largest first
+  uint8_t filled = 0;
+  for (uint8_t i = 0; i < stallSourceCount; i++) {
+    const StallSource_t* s = &stallSources[i];
+    uint8_t pos = filled;
+    while (pos > 0 && out[pos - 1].totalUs < s->totalUs) {
+      if (pos < max) out[pos] = out[pos - 1];
+      pos--;
+    }
+    if (pos < max) out[pos] = *s;
+    if (filled < max) filled++;
+  }
+  portEXIT_CRITICAL(&stallMux);
+  return n;
+}
+
+uint8_t getRecentStalls(StallEvent_t* out, uint8_t max) {
+  if (out == nullptr) return 0;
+  portENTER_CRITICAL(&stallMux);
+  uint8_t available = recentHead < STALL_RECENT_COUNT ? recentHead : STALL_RECENT_COUNT;
+  uint8_t n = available < max ? available : max;
+  for (uint8_t i = 0; i < n; i++) {
+    out[i] = recentStalls[(uint8_t)(recentHead - 1 - i) & (STALL_RECENT_COUNT - 1)];
+  }
+  portEXIT_CRITICAL(&stallMux);
+  return n;
+}
+
+const StallStats_t* getStallStats() {
+  return &stallStats;
+}
+
+void resetProfileZoneGaps() {
+  gapResetPending = true;
+}
+
+const char* getProfileZoneName(uint8_t zone) {
+  switch (zone) {
+    case PROFILE_ZONE_LOOP:        return "loop";
+    case PROFILE_ZONE_CAN:         return "can";
+    case PROFILE_ZONE_TRIO_HP:     return "trio_hp";
+    case PROFILE_ZONE_WIFI:        return "wifi";
+    case PROFILE_ZONE_MODBUS:      return "modbus";
+    case PROFILE_ZONE_HEARTBEAT:   return "heartbeat";
+    case PROFILE_ZONE_DIAGNOSTICS: return "diagnostics";
+    case PROFILE_ZONE_EEPROM:      return "eeprom";
+    case PROFILE_ZONE_LED:         return "led";
+    default:                       return "unknown";
+  }
+}
+
+void printStallReport() {
+  Serial.println("=== LOOP STALLS ===");
+  Serial.printf("Passes: %lu, stalls: %lu (watchdog %lu), longest %lu ms\n",
+                stallStats.loopPasses, stallStats.stalls, stallStats.liveStalls,
+                stallStats.longestUs / 1000);
+  for (uint8_t z = 0; z < PROFILE_ZONE_COUNT; z++) {
+    if (stallStats.zoneUs[z] == 0) continue;
+    Serial.printf("  %-11s %8lu ms total, max %lu us, worst gap %lu us\n", getProfileZoneName(z),
+                  stallStats.zoneUs[z] / 1000, stallStats.zoneMaxUs[z], stallStats.zoneMaxGapUs[z]);
+  }
+
+  StallSource_t sources[5];
+  uint8_t n = getStallSources(sources, 5);
+  for (uint8_t i = 0; i < n; i++) {
+    const StallSource_t* s = &sources[i];
+    Serial.printf("  #%u %s (in %s) at 0x%08lX: %lu stalls, %lu ms total, max %lu ms\n",
+                  i + 1, getProfileZoneName(s->zone), getProfileZoneName(s->parentZone),
+                  (unsigned long)s->site, s->count, s->totalUs / 1000, s->maxUs / 1000);
+  }
+  if (stallStats.liveDepth > 0) {
+    Serial.print("  Last watchdog report stuck at:");
+    for (uint8_t f = 0; f < stallStats.liveDepth; f++) Serial.printf(" 0x%08lX", (unsigned long)stallStats.liveBacktrace[f]);
+    Serial.println();
+  }
+  if (stallStats.droppedSources > 0) {
+    Serial.printf("  Sources not tracked (table full): %lu\n", stallStats.droppedSources);
+  }
+}
@@ -10,17 +10,20 @@
 //
 // = MODULE INFO:
 //    Module: System Statistics Implementation
-//    Version: v4.0.2
+//    Version: v4.1.2
 //    Created: 27.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // = VERSION HISTORY:
+//    v4.1.2 - 18.10.2026 - Host soak run (test/test_soak) drives the sampler; unnamed task parameter
+//    v4.1.1 - 18.10.2026 - Percentiles of caller-held histogram deltas
+//    v4.1.0 - 18.10.2026 - Background soak sampler: heap, queues, latency percentiles, drift
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers and structure
 //    v4.0.0 - 27.08.2025 - Initial statistics module implementation
 //
 // < DEPENDENCIES:
-//    Internal: statistics.h, config.h, bms_data.h for data access
+//    Internal: statistics.h, config.h, event_bus.h, can_bus.h
 //    External: Arduino.h for core functionality
 //
 // = DESCRIPTION:
@@ -56,6 +59,275 @@
 #include "statistics.h"
 #include "config.h"
 #include "bms_data.h"
+#include "event_bus.h"
+#include "can_bus.h"
 
-// Statistics implementation to be developed as needed
-// This module provides framework for future statistics collection
\ No newline at end of file
+// === GLOBAL VARIABLES ===
+// Histograms: each channel has a single writer task, the sampler only reads
+static volatile uint32_t latencyBuckets[LATENCY_CHANNEL_COUNT][STATS_LATENCY_BUCKETS];
+static uint32_t sampledBuckets[LATENCY_CHANNEL_COUNT][STATS_LATENCY_BUCKETS];  // Sampler task only
+
+static StatsSample_t history[STATS_HISTORY_SAMPLES];
+static uint8_t historyHead = 0;
+static uint8_t historyCount = 0;
+static StatsDrift_t drift;
+static TaskHandle_t statsTask = nullptr;
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// === LATENCY HISTOGRAMS ===
+
+void recordLatency(LatencyChannel_t channel, unsigned long us) {
+  if (channel >= LATENCY_CHANNEL_COUNT) return;
+  uint8_t bucket = (us == 0) ? 0 : 32 - __builtin_clz((uint32_t)us);
+  if (bucket >= STATS_LATENCY_BUCKETS) bucket = STATS_LATENCY_BUCKETS - 1;
+  latencyBuckets[channel][bucket]++;
+}
+
+float getLatencyBucketUpperUs(uint8_t bucket) {
+  return (float)(1UL << bucket);
+}
+
+static float getLatencyBucketLowerUs(uint8_t bucket) {
+  return bucket == 0 ? 0.0f : (float)(1UL << (bucket - 1));
+}
+
+// Linear interpolation inside the bucket holding the percentile
+static float histogramPercentile(const uint32_t* counts, unsigned long total, float fraction) {
+  if (total == 0) return 0.0f;
+  float target = fraction * total;
+  unsigned long cumulative = 0;
+  for (uint8_t b = 0; b < STATS_LATENCY_BUCKETS; b++) {
+    if (counts[b] == 0) continue;
+    if (cumulative + counts[b] >= target) {
+      float lower = getLatencyBucketLowerUs(b);
+      float upper = getLatencyBucketUpperUs(b);
+      return lower + (upper - lower) * (target - cumulative) / counts[b];
+    }
+    cumulative += counts[b];
+  }
+  return getLatencyBucketUpperUs(STATS_LATENCY_BUCKETS - 1);
+}
+
+float getLatencyPercentile(const uint32_t* counts, float fraction) {
+  if (counts == nullptr) return 0.0f;
+  unsigned long total = 0;
+  for (uint8_t b = 0; b < STATS_LATENCY_BUCKETS; b++) total += counts[b];
+  return histogramPercentile(counts, total, fraction);
+}
+
+// === DRIFT ===
+
+static float leastSquaresSlope(const float* x, const float* y, uint8_t n) {
+  float meanX = 0.0f, meanY = 0.0f;
+  for (uint8_t i = 0; i < n; i++) {
+    meanX += x[i];
+    meanY += y[i];
+  }
+  meanX /= n;
+  meanY /= n;
+
+  float sxx = 0.0f, sxy = 0.0f;
+  for (uint8_t i = 0; i < n; i++) {
+    sxx += (x[i] - meanX) * (x[i] - meanX);
+    sxy += (x[i] - meanX) * (y[i] - meanY);
+  }
+  return sxx > 0.0f ? sxy / sxx : 0.0f;
+}
+
+// Sampler task only: history is not modified while this runs
+static void evaluateDrift(StatsDrift_t* d) {
+  static float x[STATS_HISTORY_SAMPLES];
+  static float y[STATS_HISTORY_SAMPLES];
+
+  d->samples = historyCount;
+  if (historyCount < STATS_DRIFT_MIN_SAMPLES) return;
+
+  uint8_t oldest = (historyHead + STATS_HISTORY_SAMPLES - historyCount) % STATS_HISTORY_SAMPLES;
+  unsigned long t0 = history[oldest].timestamp;
+  for (uint8_t i = 0; i < historyCount; i++) {
+    x[i] = (history[(oldest + i) % STATS_HISTORY_SAMPLES].timestamp - t0) / 3600000.0f;
+  }
+
+  for (uint8_t i = 0; i < historyCount; i++) y[i] = history[(oldest + i) % STATS_HISTORY_SAMPLES].freeHeap;
+  d->heapSlope = leastSquaresSlope(x, y, historyCount);
+  d->heapDrift = d->heapSlope < -STATS_HEAP_DRIFT_BYTES_PER_HOUR;
+
+  for (uint8_t i = 0; i < historyCount; i++) y[i] = history[(oldest + i) % STATS_HISTORY_SAMPLES].fragmentation;
+  d->fragmentationSlope = leastSquaresSlope(x, y, historyCount);
+  d->fragmentationDrift = d->fragmentationSlope > STATS_FRAG_DRIFT_PCT_PER_HOUR;
+
+  // Latency: only periods that saw traffic, slope relative to the mean p99
+  static float xl[STATS_HISTORY_SAMPLES];
+  for (uint8_t ch = 0; ch < LATENCY_CHANNEL_COUNT; ch++) {
+    uint8_t n = 0;
+    float mean = 0.0f;
+    for (uint8_t i = 0; i < historyCount; i++) {
+      const StatsSample_t* s = &history[(oldest + i) % STATS_HISTORY_SAMPLES];
+      if (s->latencyCount[ch] == 0) continue;
+      xl[n] = x[i];
+      y[n] = s->latencyP99[ch];
+      mean += y[n];
+      n++;
+    }
+    if (n < STATS_DRIFT_MIN_SAMPLES || mean <= 0.0f) {
+      d->latencySlope[ch] = 0.0f;
+      d->latencyDrift[ch] = false;
+      continue;
+    }
+    mean /= n;
+    d->latencySlope[ch] = 100.0f * leastSquaresSlope(xl, y, n) / mean;
+    d->latencyDrift[ch] = d->latencySlope[ch] > STATS_LATENCY_DRIFT_PCT_PER_HOUR;
+  }
+}
+
+// === SAMPLER ===
+
+static void takeStatisticsSample() {
+  StatsSample_t s;
+  memset(&s, 0, sizeof(s));
+  s.timestamp = millis();
+
+  // Read directly so the sample stays valid while the main loop is stuck
+  s.freeHeap = ESP.getFreeHeap();
+  s.minFreeHeap = ESP.getMinFreeHeap();
+  s.largestFreeBlock = ESP.getMaxAllocHeap();
+  s.fragmentation = s.freeHeap > 0 ? 100.0f * (1.0f - (float)s.largestFreeBlock / s.freeHeap) : 0.0f;
+
+  const EventBusStats_t* bus = getEventBusStats();
+  for (int8_t i = 0; i < bus->subscribers; i++) {
+    EventSubscriberStats_t sub;
+    if (getEventSubscriberStats(i, &sub) && sub.depth > s.eventQueueDepth) s.eventQueueDepth = sub.depth;
+  }
+  for (uint8_t ch = 0; ch < CAN_CHANNEL_COUNT; ch++) {
+    const CANChannelStats_t* c = getCANChannelStats(ch);
+    if (c != nullptr && c->ringDepth > s.canRingDepth) s.canRingDepth = c->ringDepth;
+  }
+  s.statsStackFree = uxTaskGetStackHighWaterMark(nullptr);
+
+  // Percentiles of this period only: difference against the previous read
+  for (uint8_t ch = 0; ch < LATENCY_CHANNEL_COUNT; ch++) {
+    uint32_t period[STATS_LATENCY_BUCKETS];
+    for (uint8_t b = 0; b < STATS_LATENCY_BUCKETS; b++) {
+      uint32_t now = latencyBuckets[ch][b];
+      period[b] = now - sampledBuckets[ch][b];
+      sampledBuckets[ch][b] = now;
+      s.latencyCount[ch] += period[b];
+    }
+    s.latencyP50[ch] = histogramPercentile(period, s.latencyCount[ch], 0.50f);
+    s.latencyP99[ch] = histogramPercentile(period, s.latencyCount[ch], 0.99f);
+  }
+
+  portENTER_CRITICAL(&statsMux);
+  history[historyHead] = s;
+  historyHead = (historyHead + 1) % STATS_HISTORY_SAMPLES;
+  if (historyCount < STATS_HISTORY_SAMPLES) historyCount++;
+  portEXIT_CRITICAL(&statsMux);
+
+  StatsDrift_t next = drift;
+  evaluateDrift(&next);
+
+  bool raised = (next.heapDrift && !drift.heapDrift) ||
+                (next.fragmentationDrift && !drift.fragmentationDrift);
+  for (uint8_t ch = 0; ch < LATENCY_CHANNEL_COUNT; ch++) {
+    if (next.latencyDrift[ch] && !drift.latencyDrift[ch]) raised = true;
+  }
+  if (raised) {
+    next.driftAlerts++;
+    Serial.printf("⚠️ Soak drift: heap %.0f B/h, fragmentation %.2f %%/h, loop p99 %.1f %%/h\n",
+                  next.heapSlope, next.fragmentationSlope, next.latencySlope[LATENCY_MAIN_LOOP]);
+  }
+
+  portENTER_CRITICAL(&statsMux);
+  drift = next;
+  portEXIT_CRITICAL(&statsMux);
+}
+
+static void statisticsTask(void*) {
+  TickType_t lastWake = xTaskGetTickCount();
+  for (;;) {
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(STATS_SAMPLE_INTERVAL_MS));
+    takeStatisticsSample();
+  }
+}
+
+bool initStatistics() {
+  if (statsTask != nullptr) return true;
+  if (xTaskCreatePinnedToCore(statisticsTask, "stats", STATS_TASK_STACK_SIZE, nullptr,
+                              STATS_TASK_PRIORITY, &statsTask, STATS_TASK_CORE) != pdPASS) {
+    Serial.println("❌ Statistics sampler task could not be created");
+    statsTask = nullptr;
+    return false;
+  }
+  Serial.printf("📈 Statistics sampler: every %ds, %d samples for drift\n",
+                STATS_SAMPLE_INTERVAL_MS / 1000, STATS_HISTORY_SAMPLES);
+  return true;
+}
+
+// === ACCESSORS ===
+
+bool getLatestStatsSample(StatsSample_t* out) {
+  if (out == nullptr) return false;
+  portENTER_CRITICAL(&statsMux);
+  bool available = historyCount > 0;
+  if (available) *out = history[(historyHead + STATS_HISTORY_SAMPLES - 1) % STATS_HISTORY_SAMPLES];
+  portEXIT_CRITICAL(&statsMux);
+  return available;
+}
+
+void getStatsDrift(StatsDrift_t* out) {
+  if (out == nullptr) return;
+  portENTER_CRITICAL(&statsMux);
+  *out = drift;
+  portEXIT_CRITICAL(&statsMux);
+}
+
+void getLatencyHistogram(LatencyChannel_t channel, uint32_t* out) {
+  if (channel >= LATENCY_CHANNEL_COUNT || out == nullptr) return;
+  for (uint8_t b = 0; b < STATS_LATENCY_BUCKETS; b++) out[b] = latencyBuckets[channel][b];
+}
+
+const char* getLatencyChannelName(uint8_t channel) {
+  switch (channel) {
+    case LATENCY_MAIN_LOOP:      return "loop";
+    case LATENCY_MODBUS_REQUEST: return "modbus";
+    case LATENCY_WEB_REQUEST:    return "web";
+    default:                     return "unknown";
+  }
+}
+
+bool isStatsDriftActive() {
+  StatsDrift_t d;
+  getStatsDrift(&d);
+  bool active = d.heapDrift || d.fragmentationDrift;
+  for (uint8_t ch = 0; ch < LATENCY_CHANNEL_COUNT; ch++) active = active || d.latencyDrift[ch];
+  return active;
+}
+
+void printStatisticsStatus() {
+  StatsSample_t s;
+  StatsDrift_t d;
+  Serial.println("=== SOAK STATISTICS ===");
+  if (!getLatestStatsSample(&s)) {
+    Serial.println("No sample yet");
+    return;
+  }
+  getStatsDrift(&d);
+
+  Serial.printf("Heap: free %lu (min %lu), largest %lu, fragmentation %.1f%%\n",
+                (unsigned long)s.freeHeap, (unsigned long)s.minFreeHeap,
+                (unsigned long)s.largestFreeBlock, s.fragmentation);
+  Serial.printf("Queues: event bus %u, CAN ring %u; sampler stack free %lu\n",
+                s.eventQueueDepth, s.canRingDepth, (unsigned long)s.statsStackFree);
+  for (uint8_t ch = 0; ch < LATENCY_CHANNEL_COUNT; ch++) {
+    Serial.printf("  %-7s %6lu events, p50 %.0f us, p99 %.0f us, drift %.1f %%/h%s\n",
+                  getLatencyChannelName(ch), s.latencyCount[ch], s.latencyP50[ch], s.latencyP99[ch],
+                  d.latencySlope[ch], d.latencyDrift[ch] ? " DRIFT" : "");
+  }
+  if (d.samples < STATS_DRIFT_MIN_SAMPLES) {
+    Serial.printf("Drift: collecting (%u/%u samples)\n", d.samples, STATS_DRIFT_MIN_SAMPLES);
+  } else {
+    Serial.printf("Drift: heap %.0f B/h%s, fragmentation %.2f %%/h%s, %lu alerts\n",
+                  d.heapSlope, d.heapDrift ? " DRIFT" : "",
+                  d.fragmentationSlope, d.fragmentationDrift ? " DRIFT" : "", d.driftAlerts);
+  }
+}
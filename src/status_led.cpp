@@ -0,0 +1,239 @@
+// =====================================================================
+// === status_led.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Status LED Pattern Engine Implementation
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Timer-driven blink sequences encoding system state
+//
+// 🎯 DEPENDENCIES:
+//    Internal: status_led.h
+//    External: Arduino.h, esp_timer.h
+//
+// 📝 DESCRIPTION:
+//    The tick callback runs in the esp_timer task. Patterns handed over by
+//    the main loop are copied under a spinlock into "pending" slots; the
+//    callback takes them over at its own step boundaries and writes the
+//    GPIO after leaving the lock.
+//
+// =====================================================================
+
+#include "status_led.h"
+#include <esp_timer.h>
+
+// === TIMING (ticks) ===
+#define LED_ERROR_TICKS       2    // 100ms on/off
+#define LED_AP_ON_TICKS       20   // 1s
+#define LED_AP_GAP_TICKS      10
+#define LED_PACK_ON_TICKS     3    // 150ms
+#define LED_PACK_OFF_TICKS    5
+#define LED_NO_PACK_ON_TICKS  10   // 500ms
+#define LED_TRIO_GAP_TICKS    10
+#define LED_TRIO_ON_TICKS     12   // 600ms
+#define LED_TRIO_OFF_TICKS    6
+#define LED_PAUSE_TICKS       40   // 2s
+
+// === GLOBAL VARIABLES ===
+static esp_timer_handle_t ledTimer = nullptr;
+static portMUX_TYPE ledMux = portMUX_INITIALIZER_UNLOCKED;
+static StatusLedStats_t ledStats;
+
+// Shared with the tick callback (ledMux)
+static StatusLedPattern_t pendingStatus;
+static bool pendingStatusValid = false;
+static StatusLedPattern_t pendingOneShot;
+static bool pendingOneShotValid = false;
+
+// Tick callback only
+static StatusLedPattern_t statusPattern;
+static StatusLedPattern_t running;
+static bool runningOneShot = false;
+static uint8_t runningStep = 0;
+static uint8_t remainingTicks = 0;
+
+// Main loop only: last pattern handed over, to skip unchanged states
+static StatusLedPattern_t lastRequested;
+
+// === PATTERN BUILDING ===
+
+static void appendStep(StatusLedPattern_t* p, bool on, uint8_t ticks) {
+  if (ticks == 0) return;
+  bool lastOn = (p->length % 2) == 1;  // Step length-1 is on when length is odd
+  if (p->length > 0 && lastOn == on) {
+    uint16_t merged = p->steps[p->length - 1] + ticks;
+    p->steps[p->length - 1] = merged > 255 ? 255 : merged;
+    return;
+  }
+  if (p->length == 0 && !on) {
+    p->steps[p->length++] = 0;         // Zero-length on step keeps the parity
+  }
+  if (p->length < STATUS_LED_MAX_STEPS) p->steps[p->length++] = ticks;
+}
+
+void buildStatusLEDPattern(const StatusLedState_t* state, StatusLedPattern_t* p) {
+  memset(p, 0, sizeof(StatusLedPattern_t));
+  if (state == nullptr) return;
+
+  if (state->systemError) {
+    appendStep(p, true, LED_ERROR_TICKS);
+    appendStep(p, false, LED_ERROR_TICKS);
+    return;
+  }
+
+  if (state->apMode) {
+    appendStep(p, true, LED_AP_ON_TICKS);
+    appendStep(p, false, LED_AP_GAP_TICKS);
+  }
+
+  if (state->packCount == 0) {
+    appendStep(p, true, LED_NO_PACK_ON_TICKS);
+    appendStep(p, false, LED_PACK_OFF_TICKS);
+  }
+  for (uint8_t i = 0; i < state->packCount && i < MAX_BMS_NODES; i++) {
+    appendStep(p, true, LED_PACK_ON_TICKS);
+    appendStep(p, false, LED_PACK_OFF_TICKS);
+  }
+
+  if (state->trio != STATUS_LED_TRIO_NONE) {
+    appendStep(p, false, LED_TRIO_GAP_TICKS);
+    for (uint8_t i = 0; i < state->trio; i++) {
+      appendStep(p, true, LED_TRIO_ON_TICKS);
+      appendStep(p, false, LED_TRIO_OFF_TICKS);
+    }
+  }
+
+  appendStep(p, false, LED_PAUSE_TICKS);
+}
+
+// === TICK ===
+
+static void startRunning(const StatusLedPattern_t* pattern, bool oneShot) {
+  running = *pattern;
+  runningOneShot = oneShot;
+  runningStep = 0;
+  remainingTicks = running.length > 0 ? running.steps[0] : 0;
+}
+
+static void ledTick(void* arg) {
+  bool level;
+
+  portENTER_CRITICAL(&ledMux);
+  ledStats.ticks++;
+
+  if (pendingOneShotValid) {
+    pendingOneShotValid = false;
+    startRunning(&pendingOneShot, true);
+  } else {
+    if (remainingTicks > 0) remainingTicks--;
+    // Advance past finished (and zero-length) steps
+    while (remainingTicks == 0) {
+      runningStep++;
+      if (runningStep >= running.length) {
+        if (!runningOneShot && running.length > 0) ledStats.cycles++;
+        if (pendingStatusValid) {
+          statusPattern = pendingStatus;
+          pendingStatusValid = false;
+          ledStats.patternChanges++;
+        }
+        startRunning(&statusPattern, false);
+        if (running.length == 0) break;
+        if (remainingTicks > 0) break;
+      } else {
+        remainingTicks = running.steps[runningStep];
+      }
+    }
+  }
+  level = running.length > 0 && (runningStep % 2) == 0;
+  portEXIT_CRITICAL(&ledMux);
+
+  digitalWrite(LED_PIN, level ? HIGH : LOW);
+}
+
+// === ENGINE FUNCTIONS ===
+
+bool initStatusLED() {
+  if (ledTimer != nullptr) return true;
+
+  memset(&ledStats, 0, sizeof(ledStats));
+  memset(&statusPattern, 0, sizeof(statusPattern));
+  memset(&lastRequested, 0, sizeof(lastRequested));
+  startRunning(&statusPattern, false);
+
+  esp_timer_create_args_t args = {};
+  args.callback = ledTick;
+  args.name = "status_led";
+  if (esp_timer_create(&args, &ledTimer) != ESP_OK) {
+    Serial.println("❌ Status LED timer create failed");
+    ledTimer = nullptr;
+    return false;
+  }
+  if (esp_timer_start_periodic(ledTimer, STATUS_LED_TICK_MS * 1000ULL) != ESP_OK) {
+    Serial.println("❌ Status LED timer start failed");
+    esp_timer_delete(ledTimer);
+    ledTimer = nullptr;
+    return false;
+  }
+  Serial.printf("💡 Status LED engine: GPIO%d, %dms tick\n", LED_PIN, STATUS_LED_TICK_MS);
+  return true;
+}
+
+bool isStatusLEDRunning() {
+  return ledTimer != nullptr;
+}
+
+void setStatusLEDState(const StatusLedState_t* state) {
+  StatusLedPattern_t pattern;
+  buildStatusLEDPattern(state, &pattern);
+  if (memcmp(&pattern, &lastRequested, sizeof(pattern)) == 0) return;
+  lastRequested = pattern;
+
+  portENTER_CRITICAL(&ledMux);
+  pendingStatus = pattern;
+  pendingStatusValid = true;
+  portEXIT_CRITICAL(&ledMux);
+}
+
+void playStatusLEDOnce(uint8_t count, uint16_t durationMs) {
+  uint16_t ticks = (durationMs + STATUS_LED_TICK_MS / 2) / STATUS_LED_TICK_MS;
+  if (ticks == 0) ticks = 1;
+  if (ticks > 255) ticks = 255;
+
+  StatusLedPattern_t pattern;
+  memset(&pattern, 0, sizeof(pattern));
+  for (uint8_t i = 0; i < count && pattern.length + 2 <= STATUS_LED_MAX_STEPS; i++) {
+    appendStep(&pattern, true, ticks);
+    appendStep(&pattern, false, ticks);
+  }
+
+  portENTER_CRITICAL(&ledMux);
+  pendingOneShot = pattern;
+  pendingOneShotValid = true;
+  ledStats.oneShots++;
+  portEXIT_CRITICAL(&ledMux);
+}
+
+// === STATISTICS ===
+
+const StatusLedStats_t* getStatusLEDStats() {
+  return &ledStats;
+}
+
+void printStatusLEDStatus() {
+  Serial.println("=== STATUS LED ===");
+  Serial.printf("Engine: %s, %lu ticks, %lu sequences, %lu pattern changes, %lu one-shots\n",
+                isStatusLEDRunning() ? "running" : "stopped", ledStats.ticks, ledStats.cycles,
+                ledStats.patternChanges, ledStats.oneShots);
+  Serial.printf("Sequence: %u steps\n", lastRequested.length);
+}
@@ -10,13 +10,18 @@
 //
 // 📋 MODULE INFO:
 //    Module: TRIO HP Configuration Management Implementation
-//    Version: v1.0.0
+//    Version: v1.2.2
 //    Created: 28.08.2025 (Warsaw Time)
-//    Last Modified: 28.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
 //    v1.0.0 - 28.08.2025 - Initial TRIO HP configuration implementation
+//    v1.1.0 - 18.10.2026 - Timing setters and parameter locks go through trio_hp_params table
+//    v1.1.1 - 18.10.2026 - Startup/shutdown step machines moved to trio_hp_sequencer.cpp
+//    v1.2.0 - 18.10.2026 - Profiles and defaults delegated to trio_hp_profiles/trio_hp_params
+//    v1.2.1 - 18.10.2026 - EEPROM commits timed as profiling zones
+//    v1.2.2 - 18.10.2026 - Multi-parameter setters applied as one validated batch (no partial writes)
 //
 // 🎯 DEPENDENCIES:
 //    Internal: trio_hp_config.h, trio_hp_protocol.h, config.h
@@ -48,17 +53,21 @@
 //    - EEPROM access: <10ms for load/save operations
 //    - Validation time: <5ms for complete configuration
 //    - CRC calculation: <1ms for configuration structure
-//    - Profile switching: <15ms for complete reconfiguration
+//    - Profile switching: changed parameters only, no EEPROM write (see trio_hp_profiles.h)
 //
 // =====================================================================
 
 #include "trio_hp_config.h"
+#include "trio_hp_params.h"
+#include "trio_hp_profiles.h"
+#include "trio_hp_sequencer.h"
 #include "trio_hp_protocol.h"
 #include "trio_hp_limits.h"
 #include "trio_hp_controllers.h"
 #include "trio_hp_manager.h"
 #include "config.h"
 #include <EEPROM.h>
+#include "stall_monitor.h"
 
 // === GLOBAL VARIABLES ===
 TrioHPSystemConfig_t trioHPConfig;
@@ -76,6 +85,10 @@ static const uint32_t CONFIG_SAVE_INTERVAL = 60000; // Auto-save every minute
 
 // === CONFIGURATION INITIALIZATION FUNCTIONS ===
 
+void markTrioHPConfigDirty() {
+    configDirty = true;
+}
+
 bool initTrioHPConfig() {
     if (configInitialized) return true;
     
@@ -99,6 +112,8 @@ bool initTrioHPConfig() {
     }
     
     configInitialized = true;
+    initTrioHPParams();
+    initTrioHPProfiles();
     
     // Auto-save if configuration was modified
     if (configDirty) {
@@ -161,7 +176,9 @@ bool saveTrioHPConfig() {
     EEPROM.put(TRIO_HP_CONFIG_EEPROM_START + 4, trioHPConfig);
     
     // Commit to EEPROM
+    enterProfileZone(PROFILE_ZONE_EEPROM);
     bool success = EEPROM.commit();
+    leaveProfileZone();
     
     if (success) {
         // Create backup
@@ -247,87 +264,33 @@ bool validateTrioHPConfig() {
 bool applyConfigurationProfile(TrioConfigProfile_t profile) {
     Serial.printf("Applying configuration profile: %s\n", getConfigProfileName(profile));
     
-    switch (profile) {
-        case TRIO_CONFIG_PROFILE_DEFAULT:
-            return loadDefaultProfile();
-        case TRIO_CONFIG_PROFILE_HIGH_PERFORMANCE:
-            return loadHighPerformanceProfile();
-        case TRIO_CONFIG_PROFILE_POWER_SAVE:
-            return loadPowerSaveProfile();
-        case TRIO_CONFIG_PROFILE_DIAGNOSTIC:
-            return loadDiagnosticProfile();
-        default:
-            return false;
-    }
+    // Built-in profiles are diffs against the registry defaults; custom
+    // profiles are named slots (loadCustomProfile)
+    return switchTrioProfile(profile);
 }
 
 bool loadDefaultProfile() {
-    // Standard configuration for typical operation
-    trioHPConfig.timing.broadcastInterval = 5000;      // 5 seconds
-    trioHPConfig.timing.multicastFastInterval = 500;   // 500ms
-    trioHPConfig.timing.multicastSlowInterval = 1000;  // 1 second
-    trioHPConfig.timing.enableAdaptivePolling = true;
-    trioHPConfig.timing.maxConcurrentPolls = 3;
-    trioHPConfig.timing.pollResponseTimeout = 2000;
-    
-    trioHPConfig.activeProfile = TRIO_CONFIG_PROFILE_DEFAULT;
-    trioHPConfig.maxActiveModules = 16; // Conservative limit
-    trioHPConfig.dataHistorySize = 10;
-    
-    configDirty = true;
-    return true;
+    return switchTrioProfile(TRIO_CONFIG_PROFILE_DEFAULT);
 }
 
 bool loadHighPerformanceProfile() {
-    // Fast polling for maximum responsiveness
-    trioHPConfig.timing.broadcastInterval = 2000;      // 2 seconds
-    trioHPConfig.timing.multicastFastInterval = 250;   // 250ms
-    trioHPConfig.timing.multicastSlowInterval = 500;   // 500ms
-    trioHPConfig.timing.enableAdaptivePolling = true;
-    trioHPConfig.timing.maxConcurrentPolls = 5;
-    trioHPConfig.timing.pollResponseTimeout = 1000;
-    
-    trioHPConfig.activeProfile = TRIO_CONFIG_PROFILE_HIGH_PERFORMANCE;
-    trioHPConfig.maxActiveModules = 48; // Maximum modules
-    trioHPConfig.dataHistorySize = 20;  // More history
-    
-    configDirty = true;
-    return true;
+    return switchTrioProfile(TRIO_CONFIG_PROFILE_HIGH_PERFORMANCE);
 }
 
 bool loadPowerSaveProfile() {
-    // Slow polling for power conservation
-    trioHPConfig.timing.broadcastInterval = 10000;     // 10 seconds
-    trioHPConfig.timing.multicastFastInterval = 2000;  // 2 seconds
-    trioHPConfig.timing.multicastSlowInterval = 5000;  // 5 seconds
-    trioHPConfig.timing.enableAdaptivePolling = false;
-    trioHPConfig.timing.maxConcurrentPolls = 1;
-    trioHPConfig.timing.pollResponseTimeout = 3000;
-    
-    trioHPConfig.activeProfile = TRIO_CONFIG_PROFILE_POWER_SAVE;
-    trioHPConfig.maxActiveModules = 8;  // Reduced load
-    trioHPConfig.dataHistorySize = 5;   // Less history
-    
-    configDirty = true;
-    return true;
+    return switchTrioProfile(TRIO_CONFIG_PROFILE_POWER_SAVE);
 }
 
 bool loadDiagnosticProfile() {
-    // Maximum data collection for debugging
-    trioHPConfig.timing.broadcastInterval = 1000;      // 1 second
-    trioHPConfig.timing.multicastFastInterval = 100;   // 100ms
-    trioHPConfig.timing.multicastSlowInterval = 200;   // 200ms
-    trioHPConfig.timing.enableAdaptivePolling = false;
-    trioHPConfig.timing.maxConcurrentPolls = 8;
-    trioHPConfig.timing.pollResponseTimeout = 500;
-    
-    trioHPConfig.activeProfile = TRIO_CONFIG_PROFILE_DIAGNOSTIC;
-    trioHPConfig.maxActiveModules = 48;
-    trioHPConfig.dataHistorySize = 50;  // Maximum history
-    trioHPConfig.enableDataBackup = true;
-    
-    configDirty = true;
-    return true;
+    return switchTrioProfile(TRIO_CONFIG_PROFILE_DIAGNOSTIC);
+}
+
+bool saveCustomProfile(const char* profileName) {
+    return saveTrioProfileSlot(profileName);
+}
+
+bool loadCustomProfile(const char* profileName) {
+    return loadTrioProfileSlot(profileName);
 }
 
 // === TIMING CONFIGURATION FUNCTIONS ===
@@ -348,29 +311,22 @@ const TrioHPTimingConfig_t* getTimingConfiguration() {
 }
 
 bool setBroadcastInterval(uint32_t intervalMs) {
-    if (intervalMs < TRIO_HP_MIN_BROADCAST_INTERVAL || 
-        intervalMs > TRIO_HP_MAX_BROADCAST_INTERVAL) {
-        return false;
-    }
-    
-    trioHPConfig.timing.broadcastInterval = intervalMs;
-    configDirty = true;
-    return true;
+    return setTrioParamById(TRIO_PARAM_ID_BROADCAST_INTERVAL, (float)intervalMs);
 }
 
 bool setMulticastIntervals(uint32_t fastMs, uint32_t slowMs) {
-    if (fastMs < TRIO_HP_MIN_MULTICAST_INTERVAL || 
-        fastMs > TRIO_HP_MAX_MULTICAST_INTERVAL ||
-        slowMs < TRIO_HP_MIN_MULTICAST_INTERVAL || 
-        slowMs > TRIO_HP_MAX_MULTICAST_INTERVAL ||
-        fastMs >= slowMs) {
-        return false;
-    }
+    if (fastMs >= slowMs) return false;
     
-    trioHPConfig.timing.multicastFastInterval = fastMs;
-    trioHPConfig.timing.multicastSlowInterval = slowMs;
-    configDirty = true;
-    return true;
+    // Both or neither; fast < slow is checked once on the final state
+    const TrioParamValue_t batch[] = {
+        { TRIO_PARAM_ID_MULTICAST_FAST_INTERVAL, (float)fastMs },
+        { TRIO_PARAM_ID_MULTICAST_SLOW_INTERVAL, (float)slowMs }
+    };
+    return setTrioParams(batch, 2, true);
+}
+
+bool setHeartbeatTimeout(uint32_t timeoutMs) {
+    return setTrioParamById(TRIO_PARAM_ID_HEARTBEAT_TIMEOUT, (float)timeoutMs);
 }
 
 bool validateTimingLimits(const TrioHPTimingConfig_t* timing) {
@@ -403,6 +359,33 @@ bool validateTimingLimits(const TrioHPTimingConfig_t* timing) {
     return true;
 }
 
+// === RUNTIME CONFIGURATION FUNCTIONS ===
+
+bool enableAdaptiveTiming(bool enable) {
+    return setTrioParamById(TRIO_PARAM_ID_ADAPTIVE_POLLING, enable ? 1.0f : 0.0f);
+}
+
+bool enableErrorRecovery(bool enable) {
+    return setTrioParamById(TRIO_PARAM_ID_ERROR_RECOVERY, enable ? 1.0f : 0.0f);
+}
+
+bool setSystemLimits(float maxV, float maxA, float maxW, float maxT) {
+    if (maxV <= trioHPConfig.systemVoltageMin) return false;
+    
+    // All four are range and lock checked before any of them is written
+    const TrioParamValue_t batch[] = {
+        { TRIO_PARAM_ID_SYSTEM_VOLTAGE_MAX, maxV },
+        { TRIO_PARAM_ID_SYSTEM_CURRENT_MAX, maxA },
+        { TRIO_PARAM_ID_SYSTEM_POWER_MAX,   maxW / 1000.0f },  // Stored in kW
+        { TRIO_PARAM_ID_SYSTEM_TEMP_MAX,    maxT }
+    };
+    return setTrioParams(batch, 4, true);
+}
+
+bool setModbusUpdateInterval(uint32_t intervalMs) {
+    return setTrioParamById(TRIO_PARAM_ID_MODBUS_UPDATE_INTERVAL, (float)intervalMs);
+}
+
 // === MODULE CONFIGURATION FUNCTIONS ===
 
 bool configureModule(uint8_t moduleId, const TrioHPModuleConfig_t* config) {
@@ -430,6 +413,11 @@ bool configureModule(uint8_t moduleId, const TrioHPModuleConfig_t* config) {
     return true;
 }
 
+const TrioHPModuleConfig_t* getModuleConfig(uint8_t moduleId) {
+    int8_t index = findModuleConfigIndex(moduleId);
+    return (index >= 0) ? &trioHPConfig.modules[index] : nullptr;
+}
+
 bool setModuleDefaults(uint8_t moduleId, TrioModuleType_t type) {
     if (!isValidModuleId(moduleId)) return false;
     
@@ -545,37 +533,20 @@ void setDefaultSystemConfiguration() {
     // System defaults
     trioHPConfig.configVersion = TRIO_HP_CONFIG_VERSION;
     trioHPConfig.configMagic = TRIO_HP_CONFIG_MAGIC;
-    trioHPConfig.systemEnabled = true;
     trioHPConfig.activeProfile = TRIO_CONFIG_PROFILE_DEFAULT;
     trioHPConfig.defaultStandard = TRIO_STANDARD_GERMANY_VDE4105;
-    trioHPConfig.maxActiveModules = 16;
     
-    // Load default timing
-    setDefaultTimingConfiguration();
-    
-    // System limits
-    trioHPConfig.systemVoltageMin = 300.0f;
-    trioHPConfig.systemVoltageMax = 500.0f;
-    trioHPConfig.systemCurrentMax = 100.0f;
-    trioHPConfig.systemPowerMax = 50.0f; // 50kW
-    trioHPConfig.systemTempMax = 70.0f;
-    
-    // Communication settings
-    trioHPConfig.heartbeatTimeout = 10000;
-    trioHPConfig.communicationTimeout = 5000;
-    trioHPConfig.maxRetryCount = 3;
-    trioHPConfig.enableErrorRecovery = true;
+    // Timing, limits, communication and data settings: factory defaults
+    // from the parameter table
+    applyTrioParamDefaults(false);
     
     // Data management
-    trioHPConfig.dataHistorySize = 10;
     trioHPConfig.dataRetentionTime = 3600000; // 1 hour
-    trioHPConfig.enableDataBackup = false;
     
     // Modbus integration
     trioHPConfig.modbusStartRegister = 5000;
     trioHPConfig.modbusRegisterCount = 200;
     trioHPConfig.enableModbusDataExport = true;
-    trioHPConfig.modbusUpdateInterval = 1000; // 1 second
     
     // Parameter locking system defaults
     trioHPConfig.parameterLock.parameters_locked = false;
@@ -613,18 +584,7 @@ void setDefaultSystemConfiguration() {
 }
 
 void setDefaultTimingConfiguration() {
-    trioHPConfig.timing.broadcastInterval = 5000;
-    trioHPConfig.timing.multicastFastInterval = 500;
-    trioHPConfig.timing.multicastSlowInterval = 1000;
-    trioHPConfig.timing.onDemandTimeout = 2000;
-    trioHPConfig.timing.enableAdaptivePolling = true;
-    trioHPConfig.timing.enablePriorityPolling = true;
-    trioHPConfig.timing.maxConcurrentPolls = 3;
-    trioHPConfig.timing.pollResponseTimeout = 2000;
-    trioHPConfig.timing.busyBackoffDelay = 50;
-    trioHPConfig.timing.errorRetryDelay = 1000;
-    trioHPConfig.timing.adaptiveScaleFactor = 1.1f;
-    trioHPConfig.timing.maxRetryAttempts = 3;
+    applyTrioParamDefaults(true);
 }
 
 // === UTILITY FUNCTIONS ===
@@ -710,6 +670,7 @@ bool backupConfigToEEPROM() {
     EEPROM.put(backupStart, TRIO_HP_CONFIG_MAGIC);
     EEPROM.put(backupStart + 4, trioHPConfig);
     
+    PROFILE_ZONE(PROFILE_ZONE_EEPROM);
     return EEPROM.commit();
 }
 
@@ -836,31 +797,12 @@ bool canModifyParameter(uint16_t parameter_id) {
     // If not locked, allow all modifications
     if (!lock->parameters_locked) return true;
     
-    // Check specific parameter categories
-    switch (parameter_id) {
-        // Power-related commands
-        case 0x1002:  // System current
-        case 0x2108:  // Reactive power
-            return !lock->power_parameters_locked;
-            
-        // Mode-related commands  
-        case 0x2110:  // Work mode
-        case 0x2117:  // Reactive type
-            return !lock->mode_parameters_locked;
-            
-        // System configuration commands
-        case 0x1110:  // System operational state
-            return !lock->config_parameters_locked;
-            
-        // Default: check general permission based on lock level
-        default:
-            if (lock->lock_level >= 2) return false;  // Full lock blocks everything
-            if (lock->lock_level == 1) {
-                // Basic lock - block power but allow others
-                return true;
-            }
-            return true;
-    }
+    // Lock class comes from the parameter table
+    const TrioParamDescriptor_t* param = findTrioParamById(parameter_id);
+    if (param != nullptr) return !isTrioParamLocked(param);
+    
+    // Unknown parameter: full lock blocks everything
+    return lock->lock_level < 2;
 }
 
 bool isParameterLocked(const char* parameter_name) {
@@ -868,24 +810,10 @@ bool isParameterLocked(const char* parameter_name) {
     
     if (!lock->parameters_locked) return false;
     
-    // Check parameter categories by name
-    if (strstr(parameter_name, "power") || strstr(parameter_name, "current")) {
-        return lock->power_parameters_locked;
-    }
-    
-    if (strstr(parameter_name, "mode") || strstr(parameter_name, "work")) {
-        return lock->mode_parameters_locked;
-    }
-    
-    if (strstr(parameter_name, "config") || strstr(parameter_name, "system")) {
-        return lock->config_parameters_locked;
-    }
-    
-    if (strstr(parameter_name, "safety") || strstr(parameter_name, "threshold")) {
-        return lock->safety_parameters_locked;
-    }
+    const TrioParamDescriptor_t* param = findTrioParamByName(parameter_name);
+    if (param != nullptr) return isTrioParamLocked(param);
     
-    // Default based on lock level
+    // Unknown parameter: default based on lock level
     return (lock->lock_level >= 2);
 }
 
@@ -898,240 +826,8 @@ bool unlockAllParameters() {
     return setParameterLockMode(0);
 }
 
-// === STARTUP SEQUENCE FUNCTIONS ===
-
-bool startTrioHPStartupSequence() {
-    if (trioHPConfig.startup.startup_in_progress) {
-        Serial.println("[TRIO HP STARTUP] ERROR: Startup already in progress");
-        return false;
-    }
-    
-    Serial.println("[TRIO HP STARTUP] Starting 10-step startup sequence");
-    
-    trioHPConfig.startup.current_step = TRIO_STARTUP_STEP_ESTOP_CHECK;
-    trioHPConfig.startup.startup_in_progress = true;
-    trioHPConfig.startup.startup_successful = false;
-    trioHPConfig.startup.step_start_time = millis();
-    trioHPConfig.startup.step_timeout = 5000; // 5s default timeout
-    trioHPConfig.startup.step_retry_count = 0;
-    memset(trioHPConfig.startup.step_error_message, 0, sizeof(trioHPConfig.startup.step_error_message));
-    
-    return true;
-}
-
-bool processStartupSequenceStep() {
-    if (!trioHPConfig.startup.startup_in_progress) return true;
-    
-    unsigned long now = millis();
-    TrioStartupStep_t step = trioHPConfig.startup.current_step;
-    bool stepSuccess = false;
-    
-    // Check step timeout
-    if (now - trioHPConfig.startup.step_start_time > trioHPConfig.startup.step_timeout) {
-        trioHPConfig.startup.step_retry_count++;
-        if (trioHPConfig.startup.step_retry_count >= 3) {
-            snprintf(trioHPConfig.startup.step_error_message, 64, 
-                    "Step %s timeout after 3 retries", getStartupStepName(step));
-            Serial.printf("[TRIO HP STARTUP] ERROR: %s\n", trioHPConfig.startup.step_error_message);
-            trioHPConfig.startup.startup_in_progress = false;
-            return false;
-        }
-        Serial.printf("[TRIO HP STARTUP] Retry %d for step %s\n", 
-                      trioHPConfig.startup.step_retry_count, getStartupStepName(step));
-        trioHPConfig.startup.step_start_time = now;
-    }
-    
-    // Process current startup step
-    switch (step) {
-        case TRIO_STARTUP_STEP_ESTOP_CHECK:
-            stepSuccess = !isEstopActive();  // E-STOP must be INACTIVE
-            if (stepSuccess) {
-                Serial.println("[TRIO HP STARTUP] Step 1: E-STOP check PASSED");
-            } else {
-                strcpy(trioHPConfig.startup.step_error_message, "E-STOP is ACTIVE");
-            }
-            break;
-            
-        case TRIO_STARTUP_STEP_READY_TO_CHARGE:
-            // Check readyToCharge from any BMS
-            for (int i = 0; i < MAX_BMS_NODES && !stepSuccess; i++) {
-                if (isBMSNodeActive(i) && isBMSDataRecent(i, 5000)) {
-                    BMSData* bmsData = getBMSData(i);
-                    if (bmsData && bmsData->readyToCharge) {
-                        stepSuccess = true;
-                    }
-                }
-            }
-            if (stepSuccess) {
-                Serial.println("[TRIO HP STARTUP] Step 2: Ready to charge PASSED");
-            } else {
-                strcpy(trioHPConfig.startup.step_error_message, "No BMS ready to charge");
-            }
-            break;
-            
-        case TRIO_STARTUP_STEP_AC_CONTACTOR:
-            stepSuccess = isACContactorClosed();  // AC contactor must be CLOSED
-            if (stepSuccess) {
-                Serial.println("[TRIO HP STARTUP] Step 3: AC contactor check PASSED");
-            } else {
-                strcpy(trioHPConfig.startup.step_error_message, "AC contactor is OPEN");
-            }
-            break;
-            
-        case TRIO_STARTUP_STEP_HEARTBEAT_DETECTION:
-            // Check for heartbeat from TRIO HP modules (simplified - check active modules)
-            stepSuccess = (getActiveModuleCount() > 0);
-            if (stepSuccess) {
-                Serial.printf("[TRIO HP STARTUP] Step 4: Heartbeat detection PASSED (%d modules)\n", 
-                              getActiveModuleCount());
-            } else {
-                strcpy(trioHPConfig.startup.step_error_message, "No TRIO HP modules detected");
-            }
-            break;
-            
-        case TRIO_STARTUP_STEP_BROADCAST_SETTINGS:
-            // Send broadcast system settings (simplified)
-            stepSuccess = true; // Assume success for now
-            Serial.println("[TRIO HP STARTUP] Step 5: Broadcast settings SENT");
-            break;
-            
-        case TRIO_STARTUP_STEP_MODULE_STATE_READ:
-            // Start 0x23 command polling (simplified)
-            stepSuccess = true; // Assume success for now
-            Serial.println("[TRIO HP STARTUP] Step 6: Module state read STARTED");
-            break;
-            
-        case TRIO_STARTUP_STEP_MULTICAST_SETTINGS:
-            // Send multicast module settings (simplified)
-            stepSuccess = true; // Assume success for now
-            Serial.println("[TRIO HP STARTUP] Step 7: Multicast settings SENT");
-            break;
-            
-        case TRIO_STARTUP_STEP_CALCULATE_CURRENT:
-            // Calculate required current from target power (simplified)
-            stepSuccess = true; // Assume calculation done
-            Serial.println("[TRIO HP STARTUP] Step 8: Current calculation COMPLETED");
-            break;
-            
-        case TRIO_STARTUP_STEP_SEND_POWER_COMMANDS:
-            // Send power commands (current + direction + reactive if set)
-            stepSuccess = true; // Assume commands sent
-            Serial.println("[TRIO HP STARTUP] Step 9: Power commands SENT");
-            break;
-            
-        case TRIO_STARTUP_STEP_OPERATIONAL_ON:
-            // Set operational state ON (0x11 0x10 A0)
-            stepSuccess = setSystemOperationalReadiness(true);
-            if (stepSuccess) {
-                Serial.println("[TRIO HP STARTUP] Step 10: System OPERATIONAL");
-                trioHPConfig.startup.startup_successful = true;
-                trioHPConfig.startup.startup_in_progress = false;
-                return true;
-            } else {
-                strcpy(trioHPConfig.startup.step_error_message, "Failed to set operational state");
-            }
-            break;
-            
-        case TRIO_STARTUP_STEP_COMPLETED:
-            // Should not reach here
-            trioHPConfig.startup.startup_in_progress = false;
-            return true;
-    }
-    
-    // Move to next step if current step succeeded
-    if (stepSuccess) {
-        trioHPConfig.startup.current_step = (TrioStartupStep_t)(step + 1);
-        trioHPConfig.startup.step_start_time = millis();
-        trioHPConfig.startup.step_retry_count = 0;
-        memset(trioHPConfig.startup.step_error_message, 0, sizeof(trioHPConfig.startup.step_error_message));
-    }
-    
-    return true;
-}
-
-bool startTrioHPShutdownSequence() {
-    if (trioHPConfig.shutdown.shutdown_in_progress) {
-        Serial.println("[TRIO HP SHUTDOWN] ERROR: Shutdown already in progress");
-        return false;
-    }
-    
-    Serial.println("[TRIO HP SHUTDOWN] Starting 2-step shutdown sequence");
-    
-    trioHPConfig.shutdown.current_step = TRIO_SHUTDOWN_STEP_CURRENT_ZERO;
-    trioHPConfig.shutdown.shutdown_in_progress = true;
-    trioHPConfig.shutdown.shutdown_successful = false;
-    trioHPConfig.shutdown.step_start_time = millis();
-    trioHPConfig.shutdown.step_timeout = 10000; // 10s timeout for current zero
-    trioHPConfig.shutdown.step_retry_count = 0;
-    memset(trioHPConfig.shutdown.step_error_message, 0, sizeof(trioHPConfig.shutdown.step_error_message));
-    
-    return true;
-}
-
-bool processShutdownSequenceStep() {
-    if (!trioHPConfig.shutdown.shutdown_in_progress) return true;
-    
-    unsigned long now = millis();
-    TrioShutdownStep_t step = trioHPConfig.shutdown.current_step;
-    bool stepSuccess = false;
-    
-    // Check step timeout
-    if (now - trioHPConfig.shutdown.step_start_time > trioHPConfig.shutdown.step_timeout) {
-        trioHPConfig.shutdown.step_retry_count++;
-        if (trioHPConfig.shutdown.step_retry_count >= 3) {
-            snprintf(trioHPConfig.shutdown.step_error_message, 64,
-                    "Step %s timeout after 3 retries", getShutdownStepName(step));
-            Serial.printf("[TRIO HP SHUTDOWN] ERROR: %s\n", trioHPConfig.shutdown.step_error_message);
-            trioHPConfig.shutdown.shutdown_in_progress = false;
-            return false;
-        }
-        Serial.printf("[TRIO HP SHUTDOWN] Retry %d for step %s\n",
-                      trioHPConfig.shutdown.step_retry_count, getShutdownStepName(step));
-        trioHPConfig.shutdown.step_start_time = now;
-    }
-    
-    // Process current shutdown step
-    switch (step) {
-        case TRIO_SHUTDOWN_STEP_CURRENT_ZERO:
-            // Set current to zero (through active power controller)
-            stepSuccess = setActivePowerTarget(0.0f); // Set power target to zero
-            if (stepSuccess) {
-                Serial.println("[TRIO HP SHUTDOWN] Step 1: Current set to ZERO");
-            } else {
-                strcpy(trioHPConfig.shutdown.step_error_message, "Failed to set current to zero");
-            }
-            break;
-            
-        case TRIO_SHUTDOWN_STEP_OPERATIONAL_OFF:
-            // Set operational state OFF (0x11 0x10 A1)  
-            stepSuccess = setSystemOperationalReadiness(false);
-            if (stepSuccess) {
-                Serial.println("[TRIO HP SHUTDOWN] Step 2: System set to OFF");
-                trioHPConfig.shutdown.shutdown_successful = true;
-                trioHPConfig.shutdown.shutdown_in_progress = false;
-                return true;
-            } else {
-                strcpy(trioHPConfig.shutdown.step_error_message, "Failed to set OFF state");
-            }
-            break;
-            
-        case TRIO_SHUTDOWN_STEP_COMPLETED:
-            // Should not reach here
-            trioHPConfig.shutdown.shutdown_in_progress = false;
-            return true;
-    }
-    
-    // Move to next step if current step succeeded
-    if (stepSuccess) {
-        trioHPConfig.shutdown.current_step = (TrioShutdownStep_t)(step + 1);
-        trioHPConfig.shutdown.step_start_time = millis();
-        trioHPConfig.shutdown.step_retry_count = 0;
-        trioHPConfig.shutdown.step_timeout = 5000; // 5s timeout for operational OFF
-        memset(trioHPConfig.shutdown.step_error_message, 0, sizeof(trioHPConfig.shutdown.step_error_message));
-    }
-    
-    return true;
-}
+// === STARTUP/SHUTDOWN SEQUENCE FUNCTIONS ===
+// Sequence control (start/process) lives in trio_hp_sequencer.cpp
 
 bool isStartupSequenceActive() {
     return trioHPConfig.startup.startup_in_progress;
@@ -1180,6 +876,8 @@ void printStartupSequenceStatus() {
     if (strlen(trioHPConfig.startup.step_error_message) > 0) {
         Serial.printf("Last Error: %s\n", trioHPConfig.startup.step_error_message);
     }
+    
+    printModuleSequencerStatus();
 }
 
 void printShutdownSequenceStatus() {
@@ -10,13 +10,14 @@
 //
 // 📋 MODULE INFO:
 //    Module: TRIO HP Configuration Management System
-//    Version: v1.0.0
+//    Version: v1.1.0
 //    Created: 28.08.2025 (Warsaw Time)
-//    Last Modified: 28.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
 //    v1.0.0 - 28.08.2025 - Initial TRIO HP configuration implementation
+//    v1.1.0 - 18.10.2026 - markTrioHPConfigDirty() for parameter registry
 //
 // 🎯 DEPENDENCIES:
 //    Internal: trio_hp_protocol.h, config.h
@@ -294,6 +295,7 @@ bool loadTrioHPConfig();
 bool saveTrioHPConfig();
 bool validateTrioHPConfig();
 bool isTrioHPConfigValid();
+void markTrioHPConfigDirty();           // Schedule EEPROM save on next auto-save
 
 // === CONFIGURATION PROFILE FUNCTIONS ===
 bool applyConfigurationProfile(TrioConfigProfile_t profile);
@@ -451,6 +453,8 @@ const TrioParameterLock_t* getParameterLockStatus();
 bool unlockAllParameters();
 
 // === STARTUP/SHUTDOWN SEQUENCE FUNCTIONS ===
+// start/process functions are implemented in trio_hp_sequencer.cpp
+// (per-module step machines, see trio_hp_sequencer.h)
 
 /**
  * @brief Start 10-step TRIO HP startup sequence
@@ -10,13 +10,15 @@
 //
 // 📋 MODULE INFO:
 //    Module: TRIO HP PID Controllers and Efficiency Monitoring
-//    Version: v1.0.0
+//    Version: v1.0.2
 //    Created: 29.08.2025 (Warsaw Time)
-//    Last Modified: 29.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
 //    v1.0.0 - 29.08.2025 - Initial TRIO HP Phase 3 PID controllers implementation
+//    v1.0.1 - 18.10.2026 - Active power current clamped to forecast limit headroom
+//    v1.0.2 - 18.10.2026 - Operational messages through the async log sink
 //
 // 🎯 DEPENDENCIES:
 //    Internal: trio_hp_controllers.h for structure definitions
@@ -45,6 +47,8 @@
 
 #include "trio_hp_controllers.h"
 #include "trio_hp_monitor.h"
+#include "trio_hp_forecast.h"
+#include "log_sink.h"
 
 // === GLOBAL CONTROLLER INSTANCES ===
 static TrioActivePowerController_t activePowerController;
@@ -201,14 +205,14 @@ bool updateActivePowerController() {
     
     // Safety check
     if (!validateControllerSafety()) {
-        Serial.println("[ACTIVE POWER PID] SAFETY: Controller update blocked");
+        LOG_W(LOG_MODULE_TRIO_CONTROL, "[ACTIVE POWER PID] SAFETY: Controller update blocked");
         return false;
     }
     
     // Get current measurements
     float battery_voltage = calculateBatteryVoltage();
     if (battery_voltage <= 0) {
-        Serial.println("[ACTIVE POWER PID] ERROR: Invalid battery voltage");
+        LOG_E(LOG_MODULE_TRIO_CONTROL, "[ACTIVE POWER PID] ERROR: Invalid battery voltage");
         return false;
     }
     
@@ -222,8 +226,8 @@ bool updateActivePowerController() {
     activePowerController.target_reached = (abs(activePowerController.error) <= activePowerController.tolerance);
     
     if (activePowerController.target_reached) {
-        Serial.printf("[ACTIVE POWER PID] Target reached: %.1fW (error: ±%.1fW)\n",
-                      activePowerController.current_power, activePowerController.error);
+        LOG_D(LOG_MODULE_TRIO_CONTROL, "[ACTIVE POWER PID] Target reached: %.1fW (error: ±%.1fW)",
+                                       activePowerController.current_power, activePowerController.error);
         activePowerController.last_update = now;
         return true;
     }
@@ -252,10 +256,13 @@ bool updateActivePowerController() {
     // Calculate target current: I = P / V
     activePowerController.calculated_current = activePowerController.target_power / battery_voltage + activePowerController.output;
     
+    // Ramp down ahead of a forecast BMS limit reduction instead of after it
+    activePowerController.calculated_current = applyForecastHeadroom(activePowerController.calculated_current);
+    
     // Validate calculated current against safety limits
     if (!validateRequestedCurrent(activePowerController.calculated_current)) {
-        Serial.printf("[ACTIVE POWER PID] ERROR: Calculated current %.1fA exceeds safety limits\n",
-                      activePowerController.calculated_current);
+        LOG_E(LOG_MODULE_TRIO_CONTROL, "[ACTIVE POWER PID] ERROR: Calculated current %.1fA exceeds safety limits",
+                                       activePowerController.calculated_current);
         return false;
     }
     
@@ -264,9 +271,9 @@ bool updateActivePowerController() {
     activePowerController.last_update = now;
     activePowerController.update_count++;
     
-    Serial.printf("[ACTIVE POWER PID] Update: target=%.1fW, current=%.1fW, error=%.1fW, output=%.2fA\n",
-                  activePowerController.target_power, activePowerController.current_power,
-                  activePowerController.error, activePowerController.calculated_current);
+    LOG_D(LOG_MODULE_TRIO_CONTROL, "[ACTIVE POWER PID] Update: target=%.1fW, current=%.1fW, error=%.1fW, output=%.2fA",
+                                   activePowerController.target_power, activePowerController.current_power,
+                                   activePowerController.error, activePowerController.calculated_current);
     
     return true;
 }
@@ -274,7 +281,7 @@ bool updateActivePowerController() {
 bool setActivePowerTarget(float target_watts) {
     // Validate power target against safety limits
     if (!validateRequestedPower(target_watts)) {
-        Serial.printf("[ACTIVE POWER PID] ERROR: Target power %.1fW exceeds safety limits\n", target_watts);
+        LOG_E(LOG_MODULE_TRIO_CONTROL, "[ACTIVE POWER PID] ERROR: Target power %.1fW exceeds safety limits", target_watts);
         return false;
     }
     
@@ -287,7 +294,7 @@ bool setActivePowerTarget(float target_watts) {
     activePowerController.integral = 0.0f;
     activePowerController.derivative = 0.0f;
     
-    Serial.printf("[ACTIVE POWER PID] Target set: %.1fW\n", target_watts);
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[ACTIVE POWER PID] Target set: %.1fW", target_watts);
     return true;
 }
 
@@ -303,12 +310,12 @@ void setActivePowerControllerEnabled(bool enabled) {
         activePowerController.target_reached = false;
     }
     
-    Serial.printf("[ACTIVE POWER PID] Controller %s\n", enabled ? "ENABLED" : "DISABLED");
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[ACTIVE POWER PID] Controller %s", enabled ? "ENABLED" : "DISABLED");
 }
 
 bool setActivePowerPIDParams(float kp, float ki, float kd) {
     if (kp < 0 || ki < 0 || kd < 0) {
-        Serial.printf("[ACTIVE POWER PID] ERROR: Invalid PID parameters: kp=%.3f, ki=%.3f, kd=%.3f\n", kp, ki, kd);
+        LOG_E(LOG_MODULE_TRIO_CONTROL, "[ACTIVE POWER PID] ERROR: Invalid PID parameters: kp=%.3f, ki=%.3f, kd=%.3f", kp, ki, kd);
         return false;
     }
     
@@ -319,7 +326,7 @@ bool setActivePowerPIDParams(float kp, float ki, float kd) {
     // Reset integral when parameters change
     activePowerController.integral = 0.0f;
     
-    Serial.printf("[ACTIVE POWER PID] Parameters updated: kp=%.3f, ki=%.3f, kd=%.3f\n", kp, ki, kd);
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[ACTIVE POWER PID] Parameters updated: kp=%.3f, ki=%.3f, kd=%.3f", kp, ki, kd);
     return true;
 }
 
@@ -341,7 +348,7 @@ bool updateReactivePowerController() {
     
     // Safety check
     if (!validateControllerSafety()) {
-        Serial.println("[REACTIVE POWER PID] SAFETY: Controller update blocked");
+        LOG_W(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] SAFETY: Controller update blocked");
         return false;
     }
     
@@ -350,7 +357,7 @@ bool updateReactivePowerController() {
     if (systemData) {
         reactivePowerController.current_reactive = systemData->totalReactivePower;
     } else {
-        Serial.println("[REACTIVE POWER PID] WARNING: No system data available");
+        LOG_W(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] WARNING: No system data available");
         return false;
     }
     
@@ -362,8 +369,8 @@ bool updateReactivePowerController() {
     reactivePowerController.target_reached = (abs(reactivePowerController.error) <= reactivePowerController.tolerance);
     
     if (reactivePowerController.target_reached) {
-        Serial.printf("[REACTIVE POWER PID] Target reached: %.1fVAr (error: ±%.1fVAr)\n",
-                      reactivePowerController.current_reactive, reactivePowerController.error);
+        LOG_D(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] Target reached: %.1fVAr (error: ±%.1fVAr)",
+                                       reactivePowerController.current_reactive, reactivePowerController.error);
         reactivePowerController.last_update = now;
         return true;
     }
@@ -403,7 +410,7 @@ bool updateReactivePowerController() {
         }
         reactivePowerController.active_modules = 1;
         
-        Serial.printf("[REACTIVE POWER PID] Single module: %.1fVAr\n", reactivePowerController.per_module_reactive[0]);
+        LOG_D(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] Single module: %.1fVAr", reactivePowerController.per_module_reactive[0]);
     } else {
         // Multi-module distribution
         // Count active modules (simplified - assume all 16 active for now)
@@ -413,14 +420,14 @@ bool updateReactivePowerController() {
         // Apply per-module limits
         if (abs(per_module) > reactivePowerController.max_per_module) {
             per_module = (per_module > 0) ? reactivePowerController.max_per_module : -reactivePowerController.max_per_module;
-            Serial.printf("[REACTIVE POWER PID] WARNING: Limited to %.1fkVAr per module\n", per_module / 1000.0f);
+            LOG_W(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] WARNING: Limited to %.1fkVAr per module", per_module / 1000.0f);
         }
         
         for (int i = 0; i < 16; i++) {
             reactivePowerController.per_module_reactive[i] = per_module;
         }
         
-        Serial.printf("[REACTIVE POWER PID] Multi-module: %.1fVAr × 16 modules\n", per_module);
+        LOG_D(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] Multi-module: %.1fVAr × 16 modules", per_module);
     }
     
     // Update controller state
@@ -441,7 +448,7 @@ bool setReactivePowerTarget(float target_var) {
     reactivePowerController.integral = 0.0f;
     reactivePowerController.derivative = 0.0f;
     
-    Serial.printf("[REACTIVE POWER PID] Target set: %.1fVAr\n", target_var);
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] Target set: %.1fVAr", target_var);
     return true;
 }
 
@@ -462,12 +469,12 @@ void setReactivePowerControllerEnabled(bool enabled) {
         }
     }
     
-    Serial.printf("[REACTIVE POWER PID] Controller %s\n", enabled ? "ENABLED" : "DISABLED");
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] Controller %s", enabled ? "ENABLED" : "DISABLED");
 }
 
 bool setReactivePowerPIDParams(float kp, float ki, float kd) {
     if (kp < 0 || ki < 0 || kd < 0) {
-        Serial.printf("[REACTIVE POWER PID] ERROR: Invalid PID parameters: kp=%.3f, ki=%.3f, kd=%.3f\n", kp, ki, kd);
+        LOG_E(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] ERROR: Invalid PID parameters: kp=%.3f, ki=%.3f, kd=%.3f", kp, ki, kd);
         return false;
     }
     
@@ -478,22 +485,22 @@ bool setReactivePowerPIDParams(float kp, float ki, float kd) {
     // Reset integral when parameters change
     reactivePowerController.integral = 0.0f;
     
-    Serial.printf("[REACTIVE POWER PID] Parameters updated: kp=%.3f, ki=%.3f, kd=%.3f\n", kp, ki, kd);
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] Parameters updated: kp=%.3f, ki=%.3f, kd=%.3f", kp, ki, kd);
     return true;
 }
 
 bool setReactivePowerLimits(float threshold, float single_max) {
     if (threshold <= 0 || single_max <= 0 || single_max > reactivePowerController.max_per_module) {
-        Serial.printf("[REACTIVE POWER PID] ERROR: Invalid limits: threshold=%.1f, single_max=%.1f\n", 
-                      threshold, single_max);
+        LOG_E(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] ERROR: Invalid limits: threshold=%.1f, single_max=%.1f", 
+                                       threshold, single_max);
         return false;
     }
     
     reactivePowerController.module_threshold = threshold;
     reactivePowerController.single_module_max = single_max; // ✅ CONFIGURABLE
     
-    Serial.printf("[REACTIVE POWER PID] Limits updated: threshold=%.0fVA, single_max=%.1fkVAr\n",
-                  threshold, single_max / 1000.0f);
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[REACTIVE POWER PID] Limits updated: threshold=%.0fVA, single_max=%.1fkVAr",
+                                   threshold, single_max / 1000.0f);
     return true;
 }
 
@@ -527,7 +534,7 @@ bool updateEfficiencyMeasurement() {
     
     if (battery_voltage <= 0) {
         efficiencyMonitor.valid = false;
-        Serial.println("[EFFICIENCY MONITOR] ERROR: Invalid battery voltage");
+        LOG_E(LOG_MODULE_TRIO_CONTROL, "[EFFICIENCY MONITOR] ERROR: Invalid battery voltage");
         return false;
     }
     
@@ -576,21 +583,21 @@ bool startEnergyCounting() {
     efficiencyMonitor.energy_counters.energy_start_time = millis();
     efficiencyMonitor.energy_counters.energy_duration = 0;
     
-    Serial.println("[EFFICIENCY MONITOR] Energy counting STARTED");
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[EFFICIENCY MONITOR] Energy counting STARTED");
     return true;
 }
 
 bool stopEnergyCounting() {
     if (!efficiencyMonitor.energy_counters.energy_counting_enabled) {
-        Serial.println("[EFFICIENCY MONITOR] WARNING: Energy counting not active");
+        LOG_W(LOG_MODULE_TRIO_CONTROL, "[EFFICIENCY MONITOR] WARNING: Energy counting not active");
         return false;
     }
     
     efficiencyMonitor.energy_counters.energy_counting_enabled = false;
     efficiencyMonitor.energy_counters.energy_duration = millis() - efficiencyMonitor.energy_counters.energy_start_time;
     
-    Serial.printf("[EFFICIENCY MONITOR] Energy counting STOPPED after %.1f hours\n",
-                  efficiencyMonitor.energy_counters.energy_duration / 3600000.0f);
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[EFFICIENCY MONITOR] Energy counting STOPPED after %.1f hours",
+                                   efficiencyMonitor.energy_counters.energy_duration / 3600000.0f);
     return true;
 }
 
@@ -606,18 +613,18 @@ bool resetEnergyCounters() {
     efficiencyMonitor.energy_counters.energy_start_time = 0;
     efficiencyMonitor.energy_counters.energy_duration = 0;
     
-    Serial.println("[EFFICIENCY MONITOR] Energy counters RESET");
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[EFFICIENCY MONITOR] Energy counters RESET");
     return true;
 }
 
 bool setEfficiencyMeasurementInterval(uint32_t interval_ms) {
     if (interval_ms < 100) {  // Minimum 100ms
-        Serial.printf("[EFFICIENCY MONITOR] ERROR: Interval too short: %dms\n", interval_ms);
+        LOG_E(LOG_MODULE_TRIO_CONTROL, "[EFFICIENCY MONITOR] ERROR: Interval too short: %dms", interval_ms);
         return false;
     }
     
     efficiencyMonitor.measurement_interval = interval_ms;
-    Serial.printf("[EFFICIENCY MONITOR] Measurement interval set: %dms\n", interval_ms);
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[EFFICIENCY MONITOR] Measurement interval set: %dms", interval_ms);
     return true;
 }
 
@@ -661,7 +668,7 @@ bool areControllersActive() {
 }
 
 bool emergencyStopControllers() {
-    Serial.println("[TRIO HP CONTROLLERS] EMERGENCY STOP - Disabling all controllers");
+    LOG_E(LOG_MODULE_TRIO_CONTROL, "[TRIO HP CONTROLLERS] EMERGENCY STOP - Disabling all controllers");
     
     setActivePowerControllerEnabled(false);
     setReactivePowerControllerEnabled(false);
@@ -674,7 +681,7 @@ bool emergencyStopControllers() {
 }
 
 bool resetAllControllers() {
-    Serial.println("[TRIO HP CONTROLLERS] Resetting all controllers to initial state");
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[TRIO HP CONTROLLERS] Resetting all controllers to initial state");
     
     bool success = true;
     success &= initActivePowerController();
@@ -688,31 +695,31 @@ bool resetAllControllers() {
 
 bool setControllerIntervals(uint32_t active_interval, uint32_t reactive_interval) {
     if (active_interval < 1000 || reactive_interval < 1000) {
-        Serial.printf("[TRIO HP CONTROLLERS] ERROR: Intervals too short: active=%dms, reactive=%dms\n",
-                      active_interval, reactive_interval);
+        LOG_E(LOG_MODULE_TRIO_CONTROL, "[TRIO HP CONTROLLERS] ERROR: Intervals too short: active=%dms, reactive=%dms",
+                                       active_interval, reactive_interval);
         return false;
     }
     
     activePowerController.loop_interval = active_interval;
     reactivePowerController.loop_interval = reactive_interval;
     
-    Serial.printf("[TRIO HP CONTROLLERS] Intervals updated: active=%dms, reactive=%dms\n",
-                  active_interval, reactive_interval);
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[TRIO HP CONTROLLERS] Intervals updated: active=%dms, reactive=%dms",
+                                   active_interval, reactive_interval);
     return true;
 }
 
 bool setControllerTolerances(float active_tolerance, float reactive_tolerance) {
     if (active_tolerance <= 0 || reactive_tolerance <= 0) {
-        Serial.printf("[TRIO HP CONTROLLERS] ERROR: Invalid tolerances: active=%.1f, reactive=%.1f\n",
-                      active_tolerance, reactive_tolerance);
+        LOG_E(LOG_MODULE_TRIO_CONTROL, "[TRIO HP CONTROLLERS] ERROR: Invalid tolerances: active=%.1f, reactive=%.1f",
+                                       active_tolerance, reactive_tolerance);
         return false;
     }
     
     activePowerController.tolerance = active_tolerance;
     reactivePowerController.tolerance = reactive_tolerance;
     
-    Serial.printf("[TRIO HP CONTROLLERS] Tolerances updated: active=±%.1fW, reactive=±%.1fVAr\n",
-                  active_tolerance, reactive_tolerance);
+    LOG_I(LOG_MODULE_TRIO_CONTROL, "[TRIO HP CONTROLLERS] Tolerances updated: active=±%.1fW, reactive=±%.1fVAr",
+                                   active_tolerance, reactive_tolerance);
     return true;
 }
 
@@ -743,7 +750,7 @@ static float calculateTotalACActivePower() {
         return systemData->totalActivePower;
     }
     
-    Serial.println("[TRIO HP CONTROLLERS] WARNING: No system data available for active power");
+    LOG_W(LOG_MODULE_TRIO_CONTROL, "[TRIO HP CONTROLLERS] WARNING: No system data available for active power");
     return 0.0f;
 }
 
@@ -757,20 +764,20 @@ static float calculateTotalACApparentPower() {
         return sqrt(active * active + reactive * reactive);
     }
     
-    Serial.println("[TRIO HP CONTROLLERS] WARNING: No system data available for apparent power");
+    LOG_W(LOG_MODULE_TRIO_CONTROL, "[TRIO HP CONTROLLERS] WARNING: No system data available for apparent power");
     return 0.0f;
 }
 
 static bool validateControllerSafety() {
     // Check if safety limits are valid
     if (!areBMSLimitsValid()) {
-        Serial.println("[TRIO HP CONTROLLERS] SAFETY: BMS limits invalid");
+        LOG_W(LOG_MODULE_TRIO_CONTROL, "[TRIO HP CONTROLLERS] SAFETY: BMS limits invalid");
         return false;
     }
     
     // Check if inputs are safe for operation
     if (!areInputsSafeForOperation()) {
-        Serial.println("[TRIO HP CONTROLLERS] SAFETY: Digital inputs unsafe");
+        LOG_W(LOG_MODULE_TRIO_CONTROL, "[TRIO HP CONTROLLERS] SAFETY: Digital inputs unsafe");
         return false;
     }
     
@@ -0,0 +1,240 @@
+// =====================================================================
+// === trio_hp_forecast.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: TRIO HP BMS Limit Headroom Forecast Implementation
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Per-pack Holt smoothing forecast of DCCL/DDCL
+//
+// 🎯 DEPENDENCIES:
+//    Internal: trio_hp_forecast.h, trio_hp_limits.h
+//    External: Arduino.h for millis() and Serial functions
+//
+// 📝 DESCRIPTION:
+//    Smoothing runs on irregular frame intervals, so the trend is updated
+//    with the observed slope (delta level / dt) rather than per sample.
+//    Violation counters compare the commanded current with every new live
+//    limit: "violations" for what was actually commanded (forecast
+//    clamping), "reactive_violations" for the unclamped controller request
+//    (behaviour without the forecast). Both are edge-triggered, so a long
+//    clamp counts once.
+//
+// ⚠️  SAFETY CRITICAL:
+//    The forecast only ever lowers the commanded current. Live limit
+//    validation in trio_hp_limits remains the authority.
+//
+// =====================================================================
+
+#include "trio_hp_forecast.h"
+
+// === GLOBAL VARIABLES ===
+static TrioPackForecast_t packForecasts[MAX_BMS_NODES];
+static TrioForecastStats_t forecastStats;
+static bool violationActive = false;
+static bool reactiveViolationActive = false;
+
+// === PRIVATE HELPERS ===
+
+static void holtUpdate(TrioHoltState_t* state, float value, float dt) {
+    if (!state->primed) {
+        state->level = value;
+        state->trend = 0.0f;
+        state->primed = true;
+        return;
+    }
+
+    if (dt <= 0.0f) {
+        state->level = TRIO_FORECAST_ALPHA * value + (1.0f - TRIO_FORECAST_ALPHA) * state->level;
+        return;
+    }
+
+    float previous = state->level;
+    state->level = TRIO_FORECAST_ALPHA * value +
+                   (1.0f - TRIO_FORECAST_ALPHA) * (state->level + state->trend * dt);
+    state->trend = TRIO_FORECAST_BETA * ((state->level - previous) / dt) +
+                   (1.0f - TRIO_FORECAST_BETA) * state->trend;
+}
+
+static float holtForecast(const TrioHoltState_t* state, float horizon) {
+    return state->level + state->trend * horizon;
+}
+
+// Aggregate like the live limits: min(sum, packs x weakest)
+static void aggregateForecast(float* dcclOut, float* ddclOut, uint8_t* packsOut) {
+    float dcclSum = 0.0f, ddclSum = 0.0f;
+    float dcclWeakest = 0.0f, ddclWeakest = 0.0f;
+    uint8_t packs = 0;
+
+    for (int i = 0; i < MAX_BMS_NODES; i++) {
+        const TrioPackLimits_t* live = getPackLimits(i);
+        const TrioPackForecast_t* fc = &packForecasts[i];
+        if (!live || !live->valid || !fc->valid || fc->node_id != live->node_id) continue;
+
+        dcclSum += fc->dccl_forecast;
+        ddclSum += fc->ddcl_forecast;
+        if (packs == 0 || fc->dccl_forecast < dcclWeakest) dcclWeakest = fc->dccl_forecast;
+        if (packs == 0 || fc->ddcl_forecast < ddclWeakest) ddclWeakest = fc->ddcl_forecast;
+        packs++;
+    }
+
+    *dcclOut = packs ? min(dcclSum, packs * dcclWeakest) : 0.0f;
+    *ddclOut = packs ? min(ddclSum, packs * ddclWeakest) : 0.0f;
+    *packsOut = packs;
+}
+
+// Edge-triggered count of a current exceeding the live limit in its direction
+static void countViolation(float current, bool* active, uint32_t* counter) {
+    float limit = getEffectiveCurrentLimit(current >= 0.0f);
+    bool exceeded = fabs(current) > limit + 0.1f && current != 0.0f;
+    if (exceeded && !*active) (*counter)++;
+    *active = exceeded;
+}
+
+// === FORECAST FUNCTIONS ===
+
+bool initTrioHPForecast() {
+    memset(packForecasts, 0, sizeof(packForecasts));
+    memset(&forecastStats, 0, sizeof(forecastStats));
+    violationActive = false;
+    reactiveViolationActive = false;
+
+    Serial.printf("[TRIO HP FORECAST] Initialized: horizon %.0fs, alpha %.2f, beta %.2f\n",
+                  TRIO_FORECAST_HORIZON_S, TRIO_FORECAST_ALPHA, TRIO_FORECAST_BETA);
+    return true;
+}
+
+void updatePackForecast(uint8_t slot, const BMSData* bms, const TrioPackLimits_t* pack) {
+    if (slot >= MAX_BMS_NODES || bms == nullptr || pack == nullptr) return;
+
+    TrioPackForecast_t* fc = &packForecasts[slot];
+    unsigned long now = millis();
+
+    // Slot reassigned to another node - start over
+    if (fc->node_id != pack->node_id) {
+        memset(fc, 0, sizeof(TrioPackForecast_t));
+        fc->node_id = pack->node_id;
+    }
+
+    unsigned long elapsed = fc->valid ? now - fc->last_sample : 0;
+    float dt = elapsed >= TRIO_FORECAST_MIN_DT_MS ? elapsed / 1000.0f : 0.0f;
+
+    holtUpdate(&fc->current, bms->batteryCurrent, dt);
+    holtUpdate(&fc->dccl, pack->dccl_raw, dt);
+    holtUpdate(&fc->ddcl, pack->ddcl_raw, dt);
+    if (bms->frame190Count > 0) holtUpdate(&fc->soc, bms->soc, dt);
+    if (bms->frame410Count > 0) holtUpdate(&fc->temp_max, bms->cellMaxTemperature, dt);
+    if (bms->frame310Count > 0) holtUpdate(&fc->temp_min, (float)bms->cellMinTemperature, dt);
+    if (dt > 0.0f || !fc->valid) fc->last_sample = now;
+
+    // SOC slope: coulomb counting when capacity is known, SOC trend otherwise
+    if (bms->designCapacity > 0.0f) {
+        fc->soc_slope = fc->current.level / (bms->designCapacity * 36.0f);  // A / (Ah * 3600) * 100
+    } else {
+        fc->soc_slope = fc->soc.trend;
+    }
+
+    TrioPackConditions_t cond;
+    cond.soc = constrain(fc->soc.level + fc->soc_slope * TRIO_FORECAST_HORIZON_S, 0.0f, 100.0f);
+    cond.temp_max = holtForecast(&fc->temp_max, TRIO_FORECAST_HORIZON_S);
+    cond.temp_min = holtForecast(&fc->temp_min, TRIO_FORECAST_HORIZON_S);
+    cond.soc_valid = fc->soc.primed;
+    cond.temp_max_valid = fc->temp_max.primed;
+    cond.temp_min_valid = fc->temp_min.primed;
+
+    // BMS limits only forecast downwards; never above what is reported now
+    float dcclBms = constrain(holtForecast(&fc->dccl, TRIO_FORECAST_HORIZON_S), 0.0f, pack->dccl_raw);
+    float ddclBms = constrain(holtForecast(&fc->ddcl, TRIO_FORECAST_HORIZON_S), 0.0f, pack->ddcl_raw);
+
+    fc->soc_forecast = cond.soc;
+    fc->temp_max_forecast = cond.temp_max;
+    fc->dccl_forecast = min(pack->dccl_derated, dcclBms * getDeratingFactor(&cond, false));
+    fc->ddcl_forecast = min(pack->ddcl_derated, ddclBms * getDeratingFactor(&cond, true));
+    fc->valid = true;
+}
+
+void publishFleetForecast(const TrioHPLimits_t* limits) {
+    if (limits == nullptr) return;
+
+    aggregateForecast(&forecastStats.dccl_forecast, &forecastStats.ddcl_forecast, &forecastStats.packs);
+
+    if (!limits->limits_valid || forecastStats.packs == 0) {
+        forecastStats.dccl_effective = limits->dccl_effective;
+        forecastStats.ddcl_effective = limits->ddcl_effective;
+    } else {
+        forecastStats.dccl_effective = min(limits->dccl_effective,
+                                           forecastStats.dccl_forecast * limits->dccl_threshold);
+        forecastStats.ddcl_effective = min(limits->ddcl_effective,
+                                           forecastStats.ddcl_forecast * limits->ddcl_threshold);
+    }
+
+    // A new live limit arrived: did the running command (or the unclamped
+    // request) end up above it?
+    if (limits->limits_valid) {
+        countViolation(forecastStats.last_commanded, &violationActive, &forecastStats.violations);
+        countViolation(forecastStats.last_requested, &reactiveViolationActive, &forecastStats.reactive_violations);
+    }
+}
+
+float getForecastCurrentLimit(bool charging) {
+    if (!areBMSLimitsValid()) return 0.0f;
+    return charging ? forecastStats.ddcl_effective : forecastStats.dccl_effective;
+}
+
+float applyForecastHeadroom(float requested) {
+    float commanded = requested;
+    if (areBMSLimitsValid() && forecastStats.packs > 0) {
+        float limit = getForecastCurrentLimit(requested >= 0.0f);
+        if (fabs(requested) > limit) {
+            commanded = requested >= 0.0f ? limit : -limit;
+            forecastStats.preemptive_clamps++;
+        }
+    }
+
+    forecastStats.last_requested = requested;
+    forecastStats.last_commanded = commanded;
+    return commanded;
+}
+
+// === FORECAST ACCESS ===
+
+const TrioPackForecast_t* getPackForecast(uint8_t slot) {
+    if (slot >= MAX_BMS_NODES) return nullptr;
+    return &packForecasts[slot];
+}
+
+const TrioForecastStats_t* getForecastStats() {
+    return &forecastStats;
+}
+
+void printTrioForecastStatus() {
+    Serial.println("=== TRIO HP LIMIT FORECAST ===");
+    Serial.printf("Horizon: %.0fs, packs: %d\n", TRIO_FORECAST_HORIZON_S, forecastStats.packs);
+    Serial.printf("Fleet forecast DCCL/DDCL: %.1f/%.1fA (effective %.1f/%.1fA)\n",
+                  forecastStats.dccl_forecast, forecastStats.ddcl_forecast,
+                  forecastStats.dccl_effective, forecastStats.ddcl_effective);
+    Serial.printf("Last request %.1fA -> commanded %.1fA, pre-emptive clamps: %lu\n",
+                  forecastStats.last_requested, forecastStats.last_commanded,
+                  (unsigned long)forecastStats.preemptive_clamps);
+    Serial.printf("Limit violations: %lu with forecast, %lu reactive-only\n",
+                  (unsigned long)forecastStats.violations,
+                  (unsigned long)forecastStats.reactive_violations);
+    for (int i = 0; i < MAX_BMS_NODES; i++) {
+        const TrioPackForecast_t* fc = &packForecasts[i];
+        if (!fc->valid) continue;
+        Serial.printf("  BMS %d: SOC %.1f%%->%.1f%%, Tmax %.1f->%.1fC, DCCL->%.1fA, DDCL->%.1fA\n",
+                      fc->node_id, fc->soc.level, fc->soc_forecast, fc->temp_max.level,
+                      fc->temp_max_forecast, fc->dccl_forecast, fc->ddcl_forecast);
+    }
+}
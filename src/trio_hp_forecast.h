@@ -0,0 +1,118 @@
+// =====================================================================
+// === trio_hp_forecast.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: TRIO HP BMS Limit Headroom Forecast
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Per-pack Holt smoothing forecast of DCCL/DDCL
+//
+// 🎯 DEPENDENCIES:
+//    Internal: trio_hp_limits.h (pack contributions, derating curves)
+//    Internal: bms_data.h for BMSData
+//    External: Arduino.h for standard types
+//
+// 📝 DESCRIPTION:
+//    Forecasts each pack's charge/discharge limit a short horizon ahead so
+//    the active power controller can ramp down before the BMS clamps. SOC,
+//    cell temperatures, pack current and the BMS limits themselves are
+//    smoothed with double exponential smoothing (level + trend) on every
+//    frame 510/410. The SOC slope comes from smoothed current and design
+//    capacity when available (SOC is only 0.5% resolution), otherwise from
+//    the SOC trend. Forecast values go through the same derating curves as
+//    the live limits; the forecast never exceeds the live limit.
+//
+// 🔧 CONFIGURATION:
+//    - Horizon: 30s, alpha 0.3 (level), beta 0.1 (trend)
+//    - Modbus (per BMS block): Base+125-133, see modbus_tcp.cpp
+//
+// ⚠️  KNOWN ISSUES:
+//    - None currently identified
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Per frame: 6 smoothing updates + 2 LUT lookups per direction
+//    - getForecastCurrentLimit(): O(1), cached
+//    - Memory: ~110 bytes per pack
+//
+// =====================================================================
+
+#ifndef TRIO_HP_FORECAST_H
+#define TRIO_HP_FORECAST_H
+
+#include <Arduino.h>
+#include "trio_hp_limits.h"
+
+// === FORECAST CONSTANTS ===
+#define TRIO_FORECAST_HORIZON_S       30.0f   // Forecast horizon [s]
+#define TRIO_FORECAST_ALPHA           0.3f    // Level smoothing factor
+#define TRIO_FORECAST_BETA            0.1f    // Trend smoothing factor
+#define TRIO_FORECAST_MIN_DT_MS       50      // Samples closer than this only update level
+
+// === DOUBLE EXPONENTIAL SMOOTHING STATE ===
+typedef struct {
+    float level;             // Smoothed value
+    float trend;             // Smoothed slope [unit/s]
+    bool primed;             // First sample seen
+} TrioHoltState_t;
+
+// === PER-PACK FORECAST ===
+typedef struct {
+    uint8_t node_id;           // BMS node owning this slot
+    bool valid;                // Forecast available
+    unsigned long last_sample; // Timestamp of last update [ms]
+    TrioHoltState_t soc;       // [%]
+    TrioHoltState_t temp_max;  // [°C]
+    TrioHoltState_t temp_min;  // [°C]
+    TrioHoltState_t current;   // [A], + = charge
+    TrioHoltState_t dccl;      // BMS discharge limit [A]
+    TrioHoltState_t ddcl;      // BMS charge limit [A]
+    float soc_slope;           // SOC slope used for the forecast [%/s]
+    float soc_forecast;        // SOC at horizon [%]
+    float temp_max_forecast;   // Hottest cell at horizon [°C]
+    float dccl_forecast;       // Derated discharge limit at horizon [A]
+    float ddcl_forecast;       // Derated charge limit at horizon [A]
+} TrioPackForecast_t;
+
+// === FLEET FORECAST AND VIOLATION STATISTICS ===
+typedef struct {
+    float dccl_forecast;         // Fleet discharge limit at horizon [A]
+    float ddcl_forecast;         // Fleet charge limit at horizon [A]
+    float dccl_effective;        // Forecast x threshold, capped by live limit [A]
+    float ddcl_effective;        // Forecast x threshold, capped by live limit [A]
+    uint8_t packs;               // Packs with a forecast
+    float last_requested;        // Controller request before headroom clamp [A]
+    float last_commanded;        // Current actually commanded [A]
+    uint32_t preemptive_clamps;  // Requests reduced by the forecast
+    uint32_t violations;         // Commanded current exceeded a new live limit
+    uint32_t reactive_violations; // Unclamped request would have exceeded it
+} TrioForecastStats_t;
+
+// === FORECAST FUNCTIONS ===
+bool initTrioHPForecast();
+void updatePackForecast(uint8_t slot, const BMSData* bms, const TrioPackLimits_t* pack);
+void publishFleetForecast(const TrioHPLimits_t* limits);  // Also counts limit violations
+float getForecastCurrentLimit(bool charging);             // O(1), threshold applied
+float applyForecastHeadroom(float requested);             // Clamp controller request
+
+// === FORECAST ACCESS ===
+const TrioPackForecast_t* getPackForecast(uint8_t slot);
+const TrioForecastStats_t* getForecastStats();
+void printTrioForecastStatus();
+
+#endif // TRIO_HP_FORECAST_H
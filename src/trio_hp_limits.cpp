@@ -10,18 +10,24 @@
 //
 // 📋 MODULE INFO:
 //    Module: TRIO HP Safety Limits and Digital Inputs Integration
-//    Version: v1.0.0
+//    Version: v1.2.2
 //    Created: 29.08.2025 (Warsaw Time)
-//    Last Modified: 29.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
 //    v1.0.0 - 29.08.2025 - Initial TRIO HP Phase 3 safety limits implementation
+//    v1.1.0 - 18.10.2026 - Fleet aggregation with SOC/temperature derating, updated per 510/410 frame
+//    v1.1.1 - 18.10.2026 - Derating factor exposed, pack updates feed trio_hp_forecast
+//    v1.2.0 - 18.10.2026 - Fed by BMS frame events, publishes effective limit changes
+//    v1.2.1 - 18.10.2026 - Operational messages through the async log sink
+//    v1.2.2 - 18.10.2026 - Fleet limit is n x weakest pack (sum is diagnostic), stale sweep every loop pass
 //
 // 🎯 DEPENDENCIES:
 //    Internal: trio_hp_limits.h for structure definitions
 //    Internal: bms_data.h for BMSData structure and bmsModules array
 //    Internal: config.h for system constants
+//    Internal: event_bus.h for BMS frame events and limit change events
 //    External: Arduino.h for millis() and Serial functions
 //
 // 📝 DESCRIPTION:
@@ -32,7 +38,13 @@
 //    seamless integration with the BMS communication system.
 //
 // 🔧 IMPLEMENTATION DETAILS:
-//    - BMS Limits: Read from bmsModules[].dccl/ddcl with safety thresholds
+//    - BMS Limits: Per-pack bmsModules[].dccl/ddcl derated by SOC/temperature LUTs,
+//      cached per slot and folded into fleet sums on every frame 510/410
+//    - Fleet limit: fresh packs x weakest pack - parallel packs share current
+//      roughly equally, so the weakest pack saturates first. The sum of pack
+//      limits (the ceiling with ideal sharing) is kept for diagnostics only
+//    - Stale packs are dropped and sums re-added exactly every 250ms, swept
+//      from every main loop pass (processBMSLimitsAggregate is rate limited)
 //    - Digital Inputs: Parse bmsModules[].inputs bit fields (bits 1,2)
 //    - Validation: Current and power validation with dynamic limit calculation
 //    - Safety: E-STOP override and AC contactor verification
@@ -45,10 +57,40 @@
 // =====================================================================
 
 #include "trio_hp_limits.h"
+#include "../include/bms_protocol.h"
+#include "trio_hp_forecast.h"
+#include "../include/event_bus.h"
+#include "../include/log_sink.h"
 
 // === GLOBAL VARIABLES ===
 static TrioHPLimits_t trioHPLimits;
 static TrioHPDigitalInputs_t trioHPInputs;
+static TrioPackLimits_t packLimits[MAX_BMS_NODES];
+static unsigned long lastLimitsSweep = 0;
+static int8_t limitsEventSub = -1;
+static unsigned long limitsEventDrops = 0;
+static float publishedDccl = -1.0f;   // Last effective limits sent as an event
+static float publishedDdcl = -1.0f;
+
+// === DERATING CURVES ===
+// Charge tapers towards full SOC and outside the cell charging window,
+// discharge tapers towards empty SOC and at high temperature.
+static const TrioDeratePoint_t CHARGE_SOC_LUT[] = {
+    {  0.0f, 1.00f }, { 85.0f, 1.00f }, { 90.0f, 0.80f }, { 95.0f, 0.50f }, { 98.0f, 0.20f }, { 100.0f, 0.00f }
+};
+static const TrioDeratePoint_t DISCHARGE_SOC_LUT[] = {
+    {  0.0f, 0.00f }, {  3.0f, 0.20f }, {  5.0f, 0.50f }, { 10.0f, 0.80f }, { 15.0f, 1.00f }, { 100.0f, 1.00f }
+};
+static const TrioDeratePoint_t CHARGE_TEMP_LUT[] = {
+    {  0.0f, 0.00f }, {  5.0f, 0.30f }, { 10.0f, 0.60f }, { 15.0f, 1.00f },
+    { 40.0f, 1.00f }, { 45.0f, 0.60f }, { 50.0f, 0.30f }, { 55.0f, 0.00f }
+};
+static const TrioDeratePoint_t DISCHARGE_TEMP_LUT[] = {
+    { -20.0f, 0.30f }, { -10.0f, 0.50f }, { 0.0f, 0.80f }, { 10.0f, 1.00f },
+    {  45.0f, 1.00f }, {  50.0f, 0.60f }, { 55.0f, 0.30f }, { 60.0f, 0.00f }
+};
+
+#define LUT_SIZE(lut) ((uint8_t)(sizeof(lut) / sizeof((lut)[0])))
 
 // === INITIALIZATION FUNCTIONS ===
 
@@ -60,6 +102,17 @@ bool initTrioHPLimits() {
     trioHPLimits.ddcl_threshold = TRIO_HP_DEFAULT_THRESHOLD;
     trioHPLimits.limits_valid = false;
     trioHPLimits.last_update = 0;
+    trioHPLimits.dccl_sum = 0.0f;
+    trioHPLimits.ddcl_sum = 0.0f;
+    trioHPLimits.dccl_weakest = 0.0f;
+    trioHPLimits.ddcl_weakest = 0.0f;
+    trioHPLimits.fresh_packs = 0;
+    trioHPLimits.dccl_effective = 0.0f;
+    trioHPLimits.ddcl_effective = 0.0f;
+    memset(packLimits, 0, sizeof(packLimits));
+    lastLimitsSweep = 0;
+    initTrioHPForecast();
+    limitsEventSub = subscribeEvents("limits", EVENT_MASK(EVENT_BMS_FRAME_PARSED));
     
     // Initialize inputs structure with safe defaults
     trioHPInputs.estop_active = true;      // Default to E-STOP active (safe state)
@@ -77,89 +130,230 @@ bool initTrioHPLimits() {
 
 // === BMS LIMITS FUNCTIONS ===
 
+float interpolateDerating(const TrioDeratePoint_t* lut, uint8_t count, float x) {
+    if (lut == nullptr || count == 0) return 1.0f;
+    if (x <= lut[0].x) return lut[0].factor;
+    
+    for (uint8_t i = 1; i < count; i++) {
+        if (x <= lut[i].x) {
+            float span = lut[i].x - lut[i - 1].x;
+            float t = span > 0.0f ? (x - lut[i - 1].x) / span : 1.0f;
+            return lut[i - 1].factor + t * (lut[i].factor - lut[i - 1].factor);
+        }
+    }
+    return lut[count - 1].factor;
+}
+
+// Derive fleet limits from the running sums (O(1)) and cache effective values
+static void publishFleetLimits() {
+    if (trioHPLimits.fresh_packs == 0) {
+        trioHPLimits.dccl_bms = 0.0f;
+        trioHPLimits.ddcl_bms = 0.0f;
+        trioHPLimits.limits_valid = false;
+    } else {
+        // Equal sharing: the weakest pack hits its limit first (n x weakest <= sum always)
+        float n = (float)trioHPLimits.fresh_packs;
+        trioHPLimits.dccl_bms = n * trioHPLimits.dccl_weakest;
+        trioHPLimits.ddcl_bms = n * trioHPLimits.ddcl_weakest;
+        trioHPLimits.limits_valid = true;
+    }
+    trioHPLimits.dccl_effective = trioHPLimits.dccl_bms * trioHPLimits.dccl_threshold;
+    trioHPLimits.ddcl_effective = trioHPLimits.ddcl_bms * trioHPLimits.ddcl_threshold;
+    publishFleetForecast(&trioHPLimits);
+}
+
+static void updateWeakestPack() {
+    bool first = true;
+    for (int i = 0; i < MAX_BMS_NODES; i++) {
+        if (!packLimits[i].valid) continue;
+        if (first || packLimits[i].dccl_derated < trioHPLimits.dccl_weakest) {
+            trioHPLimits.dccl_weakest = packLimits[i].dccl_derated;
+        }
+        if (first || packLimits[i].ddcl_derated < trioHPLimits.ddcl_weakest) {
+            trioHPLimits.ddcl_weakest = packLimits[i].ddcl_derated;
+        }
+        first = false;
+    }
+    if (first) {
+        trioHPLimits.dccl_weakest = 0.0f;
+        trioHPLimits.ddcl_weakest = 0.0f;
+    }
+}
+
+float getDeratingFactor(const TrioPackConditions_t* cond, bool charging) {
+    if (cond == nullptr) return 1.0f;
+    
+    const TrioDeratePoint_t* socLut = charging ? CHARGE_SOC_LUT : DISCHARGE_SOC_LUT;
+    uint8_t socCount = charging ? LUT_SIZE(CHARGE_SOC_LUT) : LUT_SIZE(DISCHARGE_SOC_LUT);
+    const TrioDeratePoint_t* tempLut = charging ? CHARGE_TEMP_LUT : DISCHARGE_TEMP_LUT;
+    uint8_t tempCount = charging ? LUT_SIZE(CHARGE_TEMP_LUT) : LUT_SIZE(DISCHARGE_TEMP_LUT);
+    
+    // Unknown SOC/temperature leaves the BMS limit as reported
+    float factor = 1.0f;
+    if (cond->soc_valid) {
+        factor *= interpolateDerating(socLut, socCount, cond->soc);
+    }
+    if (cond->temp_max_valid) {
+        float tempFactor = interpolateDerating(tempLut, tempCount, cond->temp_max);
+        if (cond->temp_min_valid) {
+            // Cold limit comes from the coldest cell (frame 310)
+            tempFactor = min(tempFactor, interpolateDerating(tempLut, tempCount, cond->temp_min));
+        }
+        factor *= tempFactor;
+    }
+    return factor;
+}
+
+// Rebuild one slot's contribution from its BMS record
+static void deratePack(TrioPackLimits_t* pack, const BMSData* bms) {
+    TrioPackConditions_t cond;
+    cond.soc = bms->soc;
+    cond.temp_max = bms->cellMaxTemperature;
+    cond.temp_min = (float)bms->cellMinTemperature;
+    cond.soc_valid = bms->frame190Count > 0;
+    cond.temp_max_valid = bms->frame410Count > 0;
+    cond.temp_min_valid = bms->frame310Count > 0;
+    
+    pack->dccl_raw = bms->dccl;
+    pack->ddcl_raw = bms->ddcl;
+    pack->charge_factor = getDeratingFactor(&cond, true);
+    pack->discharge_factor = getDeratingFactor(&cond, false);
+    pack->dccl_derated = bms->dccl * pack->discharge_factor;
+    pack->ddcl_derated = bms->ddcl * pack->charge_factor;
+    pack->last_update = bms->frameTimestamps[BMS_FRAME_TYPE_510];
+}
+
 bool updateBMSLimits(uint8_t bmsNodeId) {
-    // Get BMS data using existing function
-    BMSData* bmsData = getBMSData(bmsNodeId);
-    if (!bmsData) {
-        Serial.printf("[TRIO HP LIMITS] ERROR: Invalid BMS node ID: %d\n", bmsNodeId);
-        return false;
+    int slot = getBMSIndexByNodeId(bmsNodeId);
+    if (slot < 0 || slot >= MAX_BMS_NODES) return false;
+    
+    const BMSData* bms = &bmsModules[slot];
+    TrioPackLimits_t* pack = &packLimits[slot];
+    
+    // Remove this slot's previous contribution
+    if (pack->valid) {
+        trioHPLimits.dccl_sum -= pack->dccl_derated;
+        trioHPLimits.ddcl_sum -= pack->ddcl_derated;
+        trioHPLimits.fresh_packs--;
+        pack->valid = false;
     }
+    pack->node_id = bmsNodeId;
     
-    // Check if BMS data is recent and valid
-    if (!isBMSDataRecent(bmsNodeId, TRIO_HP_LIMITS_TIMEOUT)) {
-        Serial.printf("[TRIO HP LIMITS] WARNING: BMS node %d data is stale\n", bmsNodeId);
-        trioHPLimits.limits_valid = false;
-        return false;
+    // A pack contributes only once it has reported limits recently
+    unsigned long now = millis();
+    bool fresh = bms->frame510Count > 0 &&
+                 now - bms->frameTimestamps[BMS_FRAME_TYPE_510] <= TRIO_HP_LIMITS_TIMEOUT;
+    if (fresh) {
+        deratePack(pack, bms);
+        updatePackForecast(slot, bms, pack);
+        pack->valid = true;
+        trioHPLimits.dccl_sum += pack->dccl_derated;
+        trioHPLimits.ddcl_sum += pack->ddcl_derated;
+        trioHPLimits.fresh_packs++;
+        trioHPLimits.last_update = now;
     }
     
-    // Update limits from BMS data
-    trioHPLimits.dccl_bms = bmsData->dccl;  // Discharge Current Continuous Limit
-    trioHPLimits.ddcl_bms = bmsData->ddcl;  // Dynamic Charge Current Limit
-    trioHPLimits.last_update = millis();
-    trioHPLimits.limits_valid = true;
+    updateWeakestPack();
+    publishFleetLimits();
+    return fresh;
+}
+
+bool updateAllBMSLimits() {
+    extern SystemConfig systemConfig;
     
-    Serial.printf("[TRIO HP LIMITS] Updated from BMS %d: DCCL=%.1fA, DDCL=%.1fA\n", 
-                  bmsNodeId, trioHPLimits.dccl_bms, trioHPLimits.ddcl_bms);
+    memset(packLimits, 0, sizeof(packLimits));
+    trioHPLimits.dccl_sum = 0.0f;
+    trioHPLimits.ddcl_sum = 0.0f;
+    trioHPLimits.fresh_packs = 0;
     
-    return true;
+    for (int i = 0; i < systemConfig.activeBmsNodes && i < MAX_BMS_NODES; i++) {
+        updateBMSLimits(systemConfig.bmsNodeIds[i]);
+    }
+    
+    return trioHPLimits.limits_valid;
 }
 
-bool updateAllBMSLimits() {
-    float max_dccl = 0.0f;
-    float max_ddcl = 0.0f;
-    bool any_valid = false;
-    int valid_nodes = 0;
+void processBMSLimitsAggregate() {
+    extern SystemConfig systemConfig;
+    unsigned long now = millis();
+    if (now - lastLimitsSweep < TRIO_HP_LIMITS_SWEEP_MS) return;
+    lastLimitsSweep = now;
+    
+    bool wasValid = trioHPLimits.limits_valid;
     
-    // Search through all BMS nodes for highest limits
+    // Exact re-sum from the cache: drops stale or reassigned slots and
+    // clears float drift from incremental add/subtract
+    trioHPLimits.dccl_sum = 0.0f;
+    trioHPLimits.ddcl_sum = 0.0f;
+    trioHPLimits.fresh_packs = 0;
     for (int i = 0; i < MAX_BMS_NODES; i++) {
-        if (!isBMSNodeActive(i)) continue;
-        
-        BMSData* bmsData = getBMSData(i);
-        if (!bmsData || !isBMSDataRecent(i, TRIO_HP_LIMITS_TIMEOUT)) continue;
-        
-        // Use highest limits from all active BMS nodes
-        if (bmsData->dccl > max_dccl) max_dccl = bmsData->dccl;
-        if (bmsData->ddcl > max_ddcl) max_ddcl = bmsData->ddcl;
+        TrioPackLimits_t* pack = &packLimits[i];
+        if (!pack->valid) continue;
         
-        valid_nodes++;
-        any_valid = true;
+        bool assigned = i < systemConfig.activeBmsNodes && systemConfig.bmsNodeIds[i] == pack->node_id;
+        if (!assigned || now - pack->last_update > TRIO_HP_LIMITS_TIMEOUT) {
+            pack->valid = false;
+            continue;
+        }
+        trioHPLimits.dccl_sum += pack->dccl_derated;
+        trioHPLimits.ddcl_sum += pack->ddcl_derated;
+        trioHPLimits.fresh_packs++;
     }
     
-    if (any_valid) {
-        trioHPLimits.dccl_bms = max_dccl;
-        trioHPLimits.ddcl_bms = max_ddcl;
-        trioHPLimits.last_update = millis();
-        trioHPLimits.limits_valid = true;
-        
-        Serial.printf("[TRIO HP LIMITS] Updated from %d BMS nodes: DCCL=%.1fA, DDCL=%.1fA\n", 
-                      valid_nodes, max_dccl, max_ddcl);
-    } else {
-        trioHPLimits.limits_valid = false;
-        Serial.println("[TRIO HP LIMITS] WARNING: No valid BMS limits available");
+    updateWeakestPack();
+    publishFleetLimits();
+    
+    if (wasValid && !trioHPLimits.limits_valid) {
+        LOG_W(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] WARNING: No fresh BMS limits - fleet limit 0A");
+    } else if (!wasValid && trioHPLimits.limits_valid) {
+        LOG_I(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] Fleet limits from %d packs: DCCL=%.1fA, DDCL=%.1fA",
+                                      trioHPLimits.fresh_packs, trioHPLimits.dccl_bms, trioHPLimits.ddcl_bms);
+    }
+}
+
+void processBMSLimitEvents() {
+    Event_t event;
+    while (pollEvent(limitsEventSub, &event)) {
+        uint8_t frameType = event.data.bmsFrame.frameType;
+        if (frameType == BMS_FRAME_TYPE_510 || frameType == BMS_FRAME_TYPE_410) {
+            updateBMSLimits(event.source);
+        }
     }
     
-    return any_valid;
+    // Missed events: rebuild from the BMS data rather than wait for the next 510/410
+    unsigned long drops = getEventDrops(limitsEventSub);
+    if (drops != limitsEventDrops) {
+        limitsEventDrops = drops;
+        updateAllBMSLimits();
+    }
+    
+    // Frames, the stale sweep and threshold changes all end up here
+    if (fabs(trioHPLimits.dccl_effective - publishedDccl) >= TRIO_HP_LIMITS_EVENT_DELTA ||
+        fabs(trioHPLimits.ddcl_effective - publishedDdcl) >= TRIO_HP_LIMITS_EVENT_DELTA) {
+        publishedDccl = trioHPLimits.dccl_effective;
+        publishedDdcl = trioHPLimits.ddcl_effective;
+        publishLimitsEvent(publishedDccl, publishedDdcl);
+    }
 }
 
 float getEffectiveCurrentLimit(bool charging) {
     if (!trioHPLimits.limits_valid) {
-        Serial.println("[TRIO HP LIMITS] ERROR: BMS limits not valid");
         return 0.0f;
     }
     
-    if (charging) {
-        // Charging: apply threshold to DDCL
-        return trioHPLimits.ddcl_bms * trioHPLimits.ddcl_threshold;
-    } else {
-        // Discharging: apply threshold to DCCL  
-        return trioHPLimits.dccl_bms * trioHPLimits.dccl_threshold;
-    }
+    // Charging: DDCL, discharging: DCCL - both pre-multiplied by threshold
+    return charging ? trioHPLimits.ddcl_effective : trioHPLimits.dccl_effective;
+}
+
+const TrioPackLimits_t* getPackLimits(uint8_t slot) {
+    if (slot >= MAX_BMS_NODES) return nullptr;
+    return &packLimits[slot];
 }
 
 bool validateRequestedCurrent(float current) {
     // Check if limits are valid
     if (!areBMSLimitsValid()) {
-        Serial.println("[TRIO HP LIMITS] ERROR: Cannot validate - BMS limits invalid");
+        LOG_E(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] ERROR: Cannot validate - BMS limits invalid");
         return false;
     }
     
@@ -169,16 +363,16 @@ bool validateRequestedCurrent(float current) {
         // Positive current = charging
         effective_limit = getEffectiveCurrentLimit(true);
         if (current > effective_limit) {
-            Serial.printf("[TRIO HP LIMITS] ERROR: Charge current %.1fA exceeds limit %.1fA\n", 
-                          current, effective_limit);
+            LOG_E(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] ERROR: Charge current %.1fA exceeds limit %.1fA", 
+                                          current, effective_limit);
             return false;
         }
     } else {
         // Negative current = discharging
         effective_limit = getEffectiveCurrentLimit(false);
         if (-current > effective_limit) {
-            Serial.printf("[TRIO HP LIMITS] ERROR: Discharge current %.1fA exceeds limit %.1fA\n", 
-                          -current, effective_limit);
+            LOG_E(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] ERROR: Discharge current %.1fA exceeds limit %.1fA", 
+                                          -current, effective_limit);
             return false;
         }
     }
@@ -202,15 +396,15 @@ bool validateRequestedPower(float power) {
     }
     
     if (battery_voltage <= 0) {
-        Serial.println("[TRIO HP LIMITS] ERROR: No valid battery voltage for power validation");
+        LOG_E(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] ERROR: No valid battery voltage for power validation");
         return false;
     }
     
     // Calculate equivalent current: I = P / V
     float equivalent_current = power / battery_voltage;
     
-    Serial.printf("[TRIO HP LIMITS] Power validation: %.1fW @ %.1fV = %.1fA\n", 
-                  power, battery_voltage, equivalent_current);
+    LOG_D(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] Power validation: %.1fW @ %.1fV = %.1fA", 
+                                  power, battery_voltage, equivalent_current);
     
     // Use current validation logic
     return validateRequestedCurrent(equivalent_current);
@@ -242,22 +436,25 @@ bool updateDigitalInputs() {
         estop_detected |= estop_bit;
         
         any_valid = true;
-        
-        Serial.printf("[TRIO HP LIMITS] BMS %d inputs: 0x%02X (AC:%d, ESTOP:%d)\n", 
-                      i, inputs, ac_bit ? 1 : 0, estop_bit ? 1 : 0);
     }
     
     if (any_valid) {
+        // Log transitions only - this runs every loop iteration
+        if (!trioHPInputs.inputs_valid ||
+            trioHPInputs.ac_contactor != ac_contactor_closed ||
+            trioHPInputs.estop_active != estop_detected) {
+            LOG_I(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] Digital inputs changed: AC=%d, E-STOP=%d", 
+                                          ac_contactor_closed ? 1 : 0, estop_detected ? 1 : 0);
+        }
         trioHPInputs.ac_contactor = ac_contactor_closed;
         trioHPInputs.estop_active = estop_detected;
         trioHPInputs.inputs_valid = true;
         trioHPInputs.last_update = millis();
-        
-        Serial.printf("[TRIO HP LIMITS] Digital inputs updated: AC=%d, E-STOP=%d\n", 
-                      ac_contactor_closed ? 1 : 0, estop_detected ? 1 : 0);
     } else {
+        if (trioHPInputs.inputs_valid) {
+            LOG_W(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] WARNING: No valid digital inputs available");
+        }
         trioHPInputs.inputs_valid = false;
-        Serial.println("[TRIO HP LIMITS] WARNING: No valid digital inputs available");
     }
     
     return any_valid;
@@ -265,7 +462,7 @@ bool updateDigitalInputs() {
 
 bool isEstopActive() {
     if (!areDigitalInputsValid()) {
-        Serial.println("[TRIO HP LIMITS] WARNING: E-STOP status unknown - assuming ACTIVE");
+        LOG_W(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] WARNING: E-STOP status unknown - assuming ACTIVE");
         return true;  // Default to safe state
     }
     
@@ -274,7 +471,7 @@ bool isEstopActive() {
 
 bool isACContactorClosed() {
     if (!areDigitalInputsValid()) {
-        Serial.println("[TRIO HP LIMITS] WARNING: AC contactor status unknown - assuming OPEN");
+        LOG_W(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] WARNING: AC contactor status unknown - assuming OPEN");
         return false;  // Default to safe state
     }
     
@@ -284,19 +481,19 @@ bool isACContactorClosed() {
 bool areInputsSafeForOperation() {
     // Update inputs first
     if (!updateDigitalInputs()) {
-        Serial.println("[TRIO HP LIMITS] ERROR: Cannot update digital inputs");
+        LOG_E(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] ERROR: Cannot update digital inputs");
         return false;
     }
     
     // Check E-STOP (ACTIVE = unsafe)
     if (isEstopActive()) {
-        Serial.println("[TRIO HP LIMITS] SAFETY: E-STOP ACTIVE - operation not allowed");
+        LOG_W(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] SAFETY: E-STOP ACTIVE - operation not allowed");
         return false;
     }
     
     // Check AC contactor (CLOSED = safe)
     if (!isACContactorClosed()) {
-        Serial.println("[TRIO HP LIMITS] SAFETY: AC contactor OPEN - operation not allowed");
+        LOG_W(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] SAFETY: AC contactor OPEN - operation not allowed");
         return false;
     }
     
@@ -315,11 +512,11 @@ bool areInputsSafeForOperation() {
     }
     
     if (!any_ready) {
-        Serial.println("[TRIO HP LIMITS] SAFETY: No BMS ready for operation");
+        LOG_W(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] SAFETY: No BMS ready for operation");
         return false;
     }
     
-    Serial.println("[TRIO HP LIMITS] SAFETY: All inputs safe for operation");
+    LOG_D(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] SAFETY: All inputs safe for operation");
     return true;
 }
 
@@ -329,16 +526,17 @@ bool setLimitsThresholds(float dccl_thresh, float ddcl_thresh) {
     // Validate thresholds
     if (dccl_thresh < TRIO_HP_MIN_THRESHOLD || dccl_thresh > TRIO_HP_MAX_THRESHOLD ||
         ddcl_thresh < TRIO_HP_MIN_THRESHOLD || ddcl_thresh > TRIO_HP_MAX_THRESHOLD) {
-        Serial.printf("[TRIO HP LIMITS] ERROR: Invalid thresholds: DCCL=%.2f, DDCL=%.2f\n", 
-                      dccl_thresh, ddcl_thresh);
+        LOG_E(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] ERROR: Invalid thresholds: DCCL=%.2f, DDCL=%.2f", 
+                                      dccl_thresh, ddcl_thresh);
         return false;
     }
     
     trioHPLimits.dccl_threshold = dccl_thresh;
     trioHPLimits.ddcl_threshold = ddcl_thresh;
+    publishFleetLimits();
     
-    Serial.printf("[TRIO HP LIMITS] Thresholds updated: DCCL=%.1f%%, DDCL=%.1f%%\n", 
-                  dccl_thresh * 100.0f, ddcl_thresh * 100.0f);
+    LOG_I(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] Thresholds updated: DCCL=%.1f%%, DDCL=%.1f%%", 
+                                  dccl_thresh * 100.0f, ddcl_thresh * 100.0f);
     
     return true;
 }
@@ -356,8 +554,8 @@ bool areBMSLimitsValid() {
     // Check timeout
     unsigned long now = millis();
     if (now - trioHPLimits.last_update > TRIO_HP_LIMITS_TIMEOUT) {
-        Serial.printf("[TRIO HP LIMITS] WARNING: BMS limits timeout (%lu ms)\n", 
-                      now - trioHPLimits.last_update);
+        LOG_W(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] WARNING: BMS limits timeout (%lu ms)", 
+                                      now - trioHPLimits.last_update);
         trioHPLimits.limits_valid = false;
         return false;
     }
@@ -371,8 +569,8 @@ bool areDigitalInputsValid() {
     // Check timeout
     unsigned long now = millis();
     if (now - trioHPInputs.last_update > TRIO_HP_INPUTS_TIMEOUT) {
-        Serial.printf("[TRIO HP LIMITS] WARNING: Digital inputs timeout (%lu ms)\n", 
-                      now - trioHPInputs.last_update);
+        LOG_W(LOG_MODULE_TRIO_LIMITS, "[TRIO HP LIMITS] WARNING: Digital inputs timeout (%lu ms)", 
+                                      now - trioHPInputs.last_update);
         trioHPInputs.inputs_valid = false;
         return false;
     }
@@ -392,6 +590,15 @@ const TrioHPDigitalInputs_t* getCurrentDigitalInputs() {
 
 void printTrioHPLimitsStatus() {
     Serial.println("=== TRIO HP LIMITS STATUS ===");
+    Serial.printf("Fleet: %d packs, sum DCCL/DDCL=%.1f/%.1fA, weakest=%.1f/%.1fA\n",
+                  trioHPLimits.fresh_packs, trioHPLimits.dccl_sum, trioHPLimits.ddcl_sum,
+                  trioHPLimits.dccl_weakest, trioHPLimits.ddcl_weakest);
+    for (int i = 0; i < MAX_BMS_NODES; i++) {
+        const TrioPackLimits_t* pack = &packLimits[i];
+        if (!pack->valid) continue;
+        Serial.printf("  BMS %d: DCCL %.1fA x%.2f, DDCL %.1fA x%.2f\n", pack->node_id,
+                      pack->dccl_raw, pack->discharge_factor, pack->ddcl_raw, pack->charge_factor);
+    }
     Serial.printf("DCCL BMS: %.1fA (threshold: %.1f%% = %.1fA effective)\n", 
                   trioHPLimits.dccl_bms, 
                   trioHPLimits.dccl_threshold * 100.0f,
@@ -10,13 +10,17 @@
 //
 // 📋 MODULE INFO:
 //    Module: TRIO HP Safety Limits and Digital Inputs Integration
-//    Version: v1.0.0
+//    Version: v1.2.1
 //    Created: 29.08.2025 (Warsaw Time)
-//    Last Modified: 29.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
 //    v1.0.0 - 29.08.2025 - Initial TRIO HP Phase 3 safety limits implementation
+//    v1.1.0 - 18.10.2026 - Fleet aggregation with SOC/temperature derating, updated per 510/410 frame
+//    v1.1.1 - 18.10.2026 - Derating factor exposed, pack updates feed trio_hp_forecast
+//    v1.2.0 - 18.10.2026 - Fed by BMS frame events, publishes effective limit changes
+//    v1.2.1 - 18.10.2026 - Pack limit sums documented as diagnostics, sweep called every loop pass
 //
 // 🎯 DEPENDENCIES:
 //    Internal: bms_data.h for BMSData structure and bmsModules array
@@ -35,6 +39,8 @@
 //    - E-STOP Input: Input 10 (bit 2 in BMS inputs)
 //    - AC Contactor Input: Input 9 (bit 1 in BMS inputs)
 //    - BMS Integration: All 16 BMS nodes from bmsModules array
+//    - Fleet limit: min(sum of pack limits, fresh packs x weakest pack limit)
+//    - Derating: piecewise-linear SOC and temperature curves per direction
 //
 // ⚠️  SAFETY CRITICAL:
 //    This module implements safety-critical functions for TRIO HP operation.
@@ -43,6 +49,8 @@
 //
 // 📈 PERFORMANCE NOTES:
 //    - Limit validation: <10μs per check
+//    - getEffectiveCurrentLimit(): O(1), returns cached aggregate
+//    - Per 510/410 frame: one pack re-derated, sums updated incrementally
 //    - BMS data access: Direct pointer access O(1)
 //    - Digital input parsing: Bit operations <1μs
 //    - Memory overhead: <200 bytes total
@@ -58,14 +66,50 @@
 
 // === BMS LIMITS INTEGRATION STRUCTURE ===
 typedef struct {
-    float dccl_bms;          // Dynamic Discharge Current Limit from BMS [A]
-    float ddcl_bms;          // Dynamic Charge Current Limit from BMS [A]  
+    float dccl_bms;          // Fleet Discharge Current Limit (aggregated, derated) [A]
+    float ddcl_bms;          // Fleet Charge Current Limit (aggregated, derated) [A]  
     float dccl_threshold;    // Configurable safety threshold (max 100%, default 90%)
     float ddcl_threshold;    // Configurable safety threshold (max 100%, default 90%)
     bool limits_valid;       // True if BMS limits are valid and recent
     unsigned long last_update; // Timestamp of last limits update [ms]
+    float dccl_sum;          // Sum of derated pack discharge limits, diagnostics only [A]
+    float ddcl_sum;          // Sum of derated pack charge limits, diagnostics only [A]
+    float dccl_weakest;      // Lowest derated pack discharge limit [A]
+    float ddcl_weakest;      // Lowest derated pack charge limit [A]
+    uint8_t fresh_packs;     // Packs contributing to the aggregate
+    float dccl_effective;    // dccl_bms * dccl_threshold, cached [A]
+    float ddcl_effective;    // ddcl_bms * ddcl_threshold, cached [A]
 } TrioHPLimits_t;
 
+// === PER-PACK LIMIT CONTRIBUTION ===
+typedef struct {
+    uint8_t node_id;         // BMS node owning this slot (0 = no contribution)
+    bool valid;              // Frame 510 seen within TRIO_HP_LIMITS_TIMEOUT
+    float dccl_raw;          // Discharge limit from frame 510 [A]
+    float ddcl_raw;          // Charge limit from frame 510 [A]
+    float discharge_factor;  // SOC x temperature derating for discharge (0-1)
+    float charge_factor;     // SOC x temperature derating for charge (0-1)
+    float dccl_derated;      // dccl_raw * discharge_factor [A]
+    float ddcl_derated;      // ddcl_raw * charge_factor [A]
+    unsigned long last_update; // Timestamp of last frame 510 [ms]
+} TrioPackLimits_t;
+
+// === DERATING CURVE POINT ===
+typedef struct {
+    float x;                 // SOC [%] or temperature [°C], ascending
+    float factor;            // Allowed fraction of the BMS limit (0-1)
+} TrioDeratePoint_t;
+
+// === PACK CONDITIONS FOR DERATING ===
+typedef struct {
+    float soc;               // State of charge [%]
+    float temp_max;          // Hottest cell [°C]
+    float temp_min;          // Coldest cell [°C]
+    bool soc_valid;          // Frame 190 received
+    bool temp_max_valid;     // Frame 410 received
+    bool temp_min_valid;     // Frame 310 received
+} TrioPackConditions_t;
+
 // === DIGITAL INPUTS INTEGRATION STRUCTURE ===
 typedef struct {
     bool estop_active;       // E-STOP status from Input 10 (bit 2 in bms_data.inputs)
@@ -80,6 +124,8 @@ typedef struct {
 #define TRIO_HP_MIN_THRESHOLD      0.50f    // 50% minimum threshold
 #define TRIO_HP_LIMITS_TIMEOUT     5000     // 5s timeout for limits validity [ms]
 #define TRIO_HP_INPUTS_TIMEOUT     2000     // 2s timeout for inputs validity [ms]
+#define TRIO_HP_LIMITS_SWEEP_MS    250      // Stale pack sweep / exact re-sum interval [ms]
+#define TRIO_HP_LIMITS_EVENT_DELTA 0.1f     // Effective limit change published as an event [A]
 
 // === INPUT BIT MAPPING ===
 #define TRIO_HP_INPUT_9_BIT        0x02     // AC Contactor - bit 1 (0x02)
@@ -98,25 +144,63 @@ bool initTrioHPLimits();
 // === BMS LIMITS FUNCTIONS ===
 
 /**
- * @brief Update BMS limits from specific BMS node
- * @param bmsNodeId BMS node ID to read limits from
- * @return true if limits updated successfully, false if BMS data invalid
+ * @brief Re-derate one pack and update the fleet aggregate incrementally
+ * @param bmsNodeId BMS node ID whose frame 510/410 was just parsed
+ * @return true if the pack contributes to the aggregate, false otherwise
+ * @note Called from processBMSLimitEvents() for frame 510/410 events
  */
 bool updateBMSLimits(uint8_t bmsNodeId);
 
 /**
- * @brief Update BMS limits from all active BMS nodes (uses highest limits)
+ * @brief Rebuild all pack contributions and the fleet aggregate from scratch
  * @return true if any valid limits found, false if no BMS data available
  */
 bool updateAllBMSLimits();
 
+/**
+ * @brief Drop stale packs and re-sum the aggregate (rate limited internally)
+ * @note Call every main loop pass; frames keep the aggregate current in between
+ */
+void processBMSLimitsAggregate();
+
+/**
+ * @brief Consume BMS frame events (510/410 update their pack) and publish
+ *        EVENT_LIMITS_CHANGED when the effective limits move
+ * @note Call from the main loop right after processBMSProtocol()
+ */
+void processBMSLimitEvents();
+
 /**
  * @brief Get effective current limit with applied safety threshold
  * @param charging true for charge limit (DDCL), false for discharge limit (DCCL)
- * @return Effective current limit [A] with threshold applied
+ * @return Effective current limit [A] with threshold applied (cached, O(1))
  */
 float getEffectiveCurrentLimit(bool charging);
 
+/**
+ * @brief Interpolate a derating curve (clamped at both ends)
+ * @param lut Curve points with ascending x
+ * @param count Number of points
+ * @param x SOC [%] or temperature [°C]
+ * @return Derating factor 0-1
+ */
+float interpolateDerating(const TrioDeratePoint_t* lut, uint8_t count, float x);
+
+/**
+ * @brief Combined SOC x temperature derating factor for one direction
+ * @param cond Pack conditions (unknown values are not derated)
+ * @param charging true for charge curves, false for discharge curves
+ * @return Derating factor 0-1
+ */
+float getDeratingFactor(const TrioPackConditions_t* cond, bool charging);
+
+/**
+ * @brief Get the cached limit contribution of a BMS slot (read-only)
+ * @param slot Slot index 0..MAX_BMS_NODES-1
+ * @return Pointer to pack contribution, nullptr if slot out of range
+ */
+const TrioPackLimits_t* getPackLimits(uint8_t slot);
+
 /**
  * @brief Validate requested current against BMS limits
  * @param current Requested current [A] (positive = charge, negative = discharge)
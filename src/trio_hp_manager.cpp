@@ -10,13 +10,19 @@
 //
 // 📋 MODULE INFO:
 //    Module: TRIO HP Module Management Implementation
-//    Version: v1.0.0
+//    Version: v1.3.2
 //    Created: 28.08.2025 (Warsaw Time)
-//    Last Modified: 28.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
 //    v1.0.0 - 28.08.2025 - Initial TRIO HP manager implementation
+//    v1.1.0 - 18.10.2026 - Per-module command/response correlation
+//    v1.2.0 - 18.10.2026 - Frames transmitted on the CAN channel bound to TRIO HP
+//    v1.3.0 - 18.10.2026 - Module state transitions published on the event bus
+//    v1.3.1 - 18.10.2026 - Operational messages through the async log sink
+//    v1.3.2 - 18.10.2026 - sendModuleReadRequest(); read responses correlated by
+//                          command no. 0x23, status read stored in statusWord
 //
 // 🎯 DEPENDENCIES:
 //    Internal: trio_hp_manager.h, trio_hp_protocol.h, config.h
@@ -55,6 +61,9 @@
 #include "trio_hp_manager.h"
 #include "trio_hp_protocol.h"
 #include "config.h"
+#include "log_sink.h"
+#include "can_bus.h"
+#include "event_bus.h"
 
 // === GLOBAL VARIABLES ===
 TrioModuleInfo_t trioModules[TRIO_HP_MAX_MODULES];
@@ -112,13 +121,13 @@ bool startTrioHPDiscovery() {
     
     trioSystemStatus.discoveryActive = true;
     lastDiscoveryTime = millis();
-    Serial.println("TRIO HP module discovery started");
+    LOG_I(LOG_MODULE_TRIO_MANAGER, "TRIO HP module discovery started");
     return true;
 }
 
 void stopTrioHPDiscovery() {
     trioSystemStatus.discoveryActive = false;
-    Serial.println("TRIO HP module discovery stopped");
+    LOG_I(LOG_MODULE_TRIO_MANAGER, "TRIO HP module discovery stopped");
 }
 
 bool isTrioHPManagerInitialized() {
@@ -136,7 +145,7 @@ bool processHeartbeatFrame(uint32_t canId, const uint8_t* data, uint8_t length)
     
     // Validate heartbeat frame
     if (!trioHPValidateHeartbeatFrame(canId, data, length)) {
-        Serial.printf("Invalid heartbeat frame from module %d\n", moduleId);
+        LOG_W(LOG_MODULE_TRIO_MANAGER, "Invalid heartbeat frame from module %d", moduleId);
         return false;
     }
     
@@ -145,7 +154,7 @@ bool processHeartbeatFrame(uint32_t canId, const uint8_t* data, uint8_t length)
     if (slotIndex == TRIO_HP_INVALID_MODULE_ID) {
         // Try to register new module
         if (!registerModule(moduleId, canId)) {
-            Serial.printf("Failed to register new module %d\n", moduleId);
+            LOG_E(LOG_MODULE_TRIO_MANAGER, "Failed to register new module %d", moduleId);
             return false;
         }
         slotIndex = findModuleSlot(moduleId);
@@ -187,12 +196,12 @@ bool registerModule(uint8_t moduleId, uint32_t heartbeatCanId) {
             trioModules[i].maxPower = 20.0f;
             
             trioSystemStatus.totalModules++;
-            Serial.printf("Module %d registered in slot %d\n", moduleId, i);
+            LOG_I(LOG_MODULE_TRIO_MANAGER, "Module %d registered in slot %d", moduleId, i);
             return true;
         }
     }
     
-    Serial.println("No free slots for new module");
+    LOG_W(LOG_MODULE_TRIO_MANAGER, "No free slots for new module");
     return false;
 }
 
@@ -308,11 +317,12 @@ void updateModuleState(uint8_t slotIndex, TrioModuleState_t newState) {
     
     // Update system counters
     updateSystemCounters(oldState, newState);
+    publishModuleStateEvent(trioModules[slotIndex].moduleId, oldState, newState);
     
-    Serial.printf("Module %d state: %s -> %s\n", 
-                  trioModules[slotIndex].moduleId,
-                  getModuleStateName(oldState),
-                  getModuleStateName(newState));
+    LOG_I(LOG_MODULE_TRIO_MANAGER, "Module %d state: %s -> %s", 
+                                   trioModules[slotIndex].moduleId,
+                                   getModuleStateName(oldState),
+                                   getModuleStateName(newState));
 }
 
 TrioModuleState_t getModuleState(uint8_t moduleId) {
@@ -386,7 +396,7 @@ void checkModuleTimeouts() {
         
         if (timeSinceLastHeartbeat > TRIO_HP_HEARTBEAT_TIMEOUT_MS) {
             if (trioModules[i].isOnline) {
-                Serial.printf("Module %d timeout detected\n", trioModules[i].moduleId);
+                LOG_W(LOG_MODULE_TRIO_MANAGER, "Module %d timeout detected", trioModules[i].moduleId);
                 trioModules[i].isOnline = false;
                 updateModuleState(i, TRIO_MODULE_STATE_TIMEOUT);
                 handleModuleError(i, TRIO_HP_ERROR_START_PROCESSING);
@@ -454,10 +464,10 @@ void handleModuleError(uint8_t slotIndex, uint8_t errorCode) {
     trioModules[slotIndex].lastErrorCode = errorCode;
     trioSystemStatus.communicationErrors++;
     
-    Serial.printf("Module %d error: %s (count: %d)\n", 
-                  trioModules[slotIndex].moduleId,
-                  trioHPGetErrorCodeName(errorCode),
-                  trioModules[slotIndex].errorCount);
+    LOG_E(LOG_MODULE_TRIO_MANAGER, "Module %d error: %s (count: %d)", 
+                                   trioModules[slotIndex].moduleId,
+                                   trioHPGetErrorCodeName(errorCode),
+                                   trioModules[slotIndex].errorCount);
     
     if (trioModules[slotIndex].errorCount >= TRIO_HP_MAX_ERROR_COUNT) {
         updateModuleState(slotIndex, TRIO_MODULE_STATE_ERROR);
@@ -474,9 +484,9 @@ bool sendModuleCommand(uint8_t moduleId, uint16_t command, uint32_t data) {
     TrioHPCanFrame_t frame;
     if (!trioHPBuildCommandFrame(moduleId, command, data, &frame)) return false;
     
-    // Here we would send via CAN - for now just log
-    Serial.printf("Sending command 0x%04X to module %d with data 0x%08X\n", 
-                  command, moduleId, data);
+    LOG_D(LOG_MODULE_TRIO_MANAGER, "Sending command 0x%04X to module %d with data 0x%08X", 
+                                   command, moduleId, data);
+    if (!transmitTrioHPFrame(&frame)) return false;
     
     uint8_t slotIndex = findModuleSlot(moduleId);
     if (slotIndex != TRIO_HP_INVALID_MODULE_ID) {
@@ -496,8 +506,9 @@ bool sendControlCommand(uint8_t moduleId, uint16_t command, uint8_t controlValue
     TrioHPCanFrame_t frame;
     if (!trioHPBuildControlFrame(moduleId, command, controlValue, &frame)) return false;
     
-    Serial.printf("Sending control command 0x%04X to module %d: %s\n", 
-                  command, moduleId, trioHPGetControlValueName(controlValue));
+    LOG_D(LOG_MODULE_TRIO_MANAGER, "Sending control command 0x%04X to module %d: %s", 
+                                   command, moduleId, trioHPGetControlValueName(controlValue));
+    if (!transmitTrioHPFrame(&frame)) return false;
     
     uint8_t slotIndex = findModuleSlot(moduleId);
     if (slotIndex != TRIO_HP_INVALID_MODULE_ID) {
@@ -514,8 +525,29 @@ bool sendFloatCommand(uint8_t moduleId, uint16_t command, float value) {
     TrioHPCanFrame_t frame;
     if (!trioHPBuildFloatFrame(moduleId, command, value, &frame)) return false;
     
-    Serial.printf("Sending float command 0x%04X to module %d: %.2f\n", 
-                  command, moduleId, value);
+    LOG_D(LOG_MODULE_TRIO_MANAGER, "Sending float command 0x%04X to module %d: %.2f", 
+                                   command, moduleId, value);
+    if (!transmitTrioHPFrame(&frame)) return false;
+    
+    uint8_t slotIndex = findModuleSlot(moduleId);
+    if (slotIndex != TRIO_HP_INVALID_MODULE_ID) {
+        trioModules[slotIndex].lastCommandTime = millis();
+        trioSystemStatus.totalCommandsSent++;
+    }
+    
+    return true;
+}
+
+bool sendModuleReadRequest(uint8_t moduleId, uint16_t command) {
+    if (!managerInitialized) return false;
+    if (!trioHPValidateCommand(command)) return false;
+    if (!isModuleOnline(moduleId)) return false;
+    
+    TrioHPCanFrame_t frame;
+    if (!trioHPBuildReadFrame(moduleId, command, &frame)) return false;
+    
+    LOG_D(LOG_MODULE_TRIO_MANAGER, "Sending read 0x%04X to module %d", command, moduleId);
+    if (!transmitTrioHPFrame(&frame)) return false;
     
     uint8_t slotIndex = findModuleSlot(moduleId);
     if (slotIndex != TRIO_HP_INVALID_MODULE_ID) {
@@ -532,12 +564,23 @@ bool sendBroadcastCommand(uint16_t command, uint32_t data) {
     TrioHPCanFrame_t frame;
     if (!trioHPBuildBroadcastFrame(command, data, &frame)) return false;
     
-    Serial.printf("Sending broadcast command 0x%04X with data 0x%08X\n", command, data);
+    LOG_D(LOG_MODULE_TRIO_MANAGER, "Sending broadcast command 0x%04X with data 0x%08X", command, data);
+    if (!transmitTrioHPFrame(&frame)) return false;
     trioSystemStatus.totalCommandsSent++;
     
     return true;
 }
 
+bool transmitTrioHPFrame(const TrioHPCanFrame_t* frame) {
+    if (frame == nullptr) return false;
+    
+    if (!canBusSend(CAN_PROTOCOL_TRIO, frame->canId, true, frame->length, frame->data)) {
+        trioSystemStatus.communicationErrors++;
+        return false;
+    }
+    return true;
+}
+
 // === UTILITY FUNCTIONS ===
 
 const char* getModuleStateName(TrioModuleState_t state) {
@@ -665,8 +708,25 @@ bool processTrioHPCanFrame(uint32_t canId, const uint8_t* data, uint8_t length)
         // This is a response from a module
         uint8_t slotIndex = findModuleSlot(components.sourceAddr);
         if (slotIndex != TRIO_HP_INVALID_MODULE_ID) {
-            trioModules[slotIndex].lastResponseTime = millis();
+            TrioModuleInfo_t* module = &trioModules[slotIndex];
+            module->lastResponseTime = millis();
             trioSystemStatus.totalResponsesReceived++;
+            
+            // Correlate with awaited command (data[0..1] echo the command code)
+            if (module->awaitedStatus == TRIO_RESPONSE_PENDING && length >= 2) {
+                uint16_t command = ((uint16_t)data[0] << 8) | data[1];
+                bool isRead = (components.commandNo == TRIO_HP_CMD_NO_READ);
+                if (command == module->awaitedCommand && isRead == module->awaitedRead) {
+                    module->awaitedStatus = (components.errorCode == TRIO_HP_ERROR_NORMAL) ?
+                                            TRIO_RESPONSE_ACK : TRIO_RESPONSE_NACK;
+                    if (module->awaitedStatus == TRIO_RESPONSE_NACK) {
+                        module->lastErrorCode = components.errorCode;
+                    } else if (isRead && command == TRIO_HP_CMD_MODULE_STATUS && length >= 8) {
+                        trioHPParseStatusData(data, length, &module->statusWord);
+                        module->statusTime = millis();
+                    }
+                }
+            }
             return true;
         }
     }
@@ -674,6 +734,32 @@ bool processTrioHPCanFrame(uint32_t canId, const uint8_t* data, uint8_t length)
     return false;
 }
 
+// === RESPONSE CORRELATION FUNCTIONS ===
+
+bool expectModuleResponse(uint8_t moduleId, uint16_t command) {
+    uint8_t slotIndex = findModuleSlot(moduleId);
+    if (slotIndex == TRIO_HP_INVALID_MODULE_ID) return false;
+    
+    trioModules[slotIndex].awaitedCommand = command;
+    trioModules[slotIndex].awaitedSince = millis();
+    trioModules[slotIndex].awaitedStatus = TRIO_RESPONSE_PENDING;
+    trioModules[slotIndex].awaitedRead = false;
+    return true;
+}
+
+bool expectModuleReadResponse(uint8_t moduleId, uint16_t command) {
+    if (!expectModuleResponse(moduleId, command)) return false;
+    trioModules[findModuleSlot(moduleId)].awaitedRead = true;
+    return true;
+}
+
+TrioResponseStatus_t getModuleResponseStatus(uint8_t moduleId, uint16_t command) {
+    uint8_t slotIndex = findModuleSlot(moduleId);
+    if (slotIndex == TRIO_HP_INVALID_MODULE_ID) return TRIO_RESPONSE_NONE;
+    if (trioModules[slotIndex].awaitedCommand != command) return TRIO_RESPONSE_NONE;
+    return trioModules[slotIndex].awaitedStatus;
+}
+
 // === HELPER FUNCTIONS ===
 
 void updateSystemCounters(TrioModuleState_t oldState, TrioModuleState_t newState) {
@@ -710,11 +796,11 @@ void updateSystemCounters(TrioModuleState_t oldState, TrioModuleState_t newState
         }
     }
     
-    Serial.printf("[TRIO HP MANAGER] System counters updated: Total=%d, Active=%d, Error=%d, Offline=%d\n",
-                  trioSystemStatus.totalModules,
-                  trioSystemStatus.activeModules,
-                  trioSystemStatus.errorModules,
-                  trioSystemStatus.offlineModules);
+    LOG_D(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] System counters updated: Total=%d, Active=%d, Error=%d, Offline=%d",
+                                   trioSystemStatus.totalModules,
+                                   trioSystemStatus.activeModules,
+                                   trioSystemStatus.errorModules,
+                                   trioSystemStatus.offlineModules);
 }
 
 void processCommandQueue() {
@@ -730,17 +816,17 @@ void processCommandQueue() {
         // Find module slot
         uint8_t slotIndex = findModuleSlot(commandQueue[i].moduleId);
         if (slotIndex == TRIO_HP_INVALID_MODULE_ID) {
-            Serial.printf("[TRIO HP MANAGER] Command queue: Module %d not found, removing from queue\n", commandQueue[i].moduleId);
+            LOG_W(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] Command queue: Module %d not found, removing from queue", commandQueue[i].moduleId);
             commandQueue[i].moduleId = TRIO_HP_INVALID_MODULE_ID;
             continue;
         }
         
         // Check if we can send this command
         if (!canSendCommand(commandQueue[i].command)) {
-            Serial.printf("[TRIO HP MANAGER] Command queue: Command 0x%04X not allowed in current state\n", commandQueue[i].command);
+            LOG_W(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] Command queue: Command 0x%04X not allowed in current state", commandQueue[i].command);
             commandQueue[i].retryCount++;
             if (commandQueue[i].retryCount > 3) {
-                Serial.printf("[TRIO HP MANAGER] Command queue: Dropping command after 3 retries\n");
+                LOG_W(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] Command queue: Dropping command after 3 retries");
                 commandQueue[i].moduleId = TRIO_HP_INVALID_MODULE_ID;
             }
             continue;
@@ -755,14 +841,14 @@ void processCommandQueue() {
         }
         
         if (success) {
-            Serial.printf("[TRIO HP MANAGER] Command queue: Successfully sent command 0x%04X to module %d\n", 
-                         commandQueue[i].command, commandQueue[i].moduleId);
+            LOG_D(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] Command queue: Successfully sent command 0x%04X to module %d", 
+                                          commandQueue[i].command, commandQueue[i].moduleId);
             commandQueue[i].moduleId = TRIO_HP_INVALID_MODULE_ID; // Remove from queue
         } else {
             commandQueue[i].retryCount++;
             commandQueue[i].timestamp = now; // Update timestamp for next retry
             if (commandQueue[i].retryCount > 5) {
-                Serial.printf("[TRIO HP MANAGER] Command queue: Dropping command after 5 failed attempts\n");
+                LOG_W(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] Command queue: Dropping command after 5 failed attempts");
                 commandQueue[i].moduleId = TRIO_HP_INVALID_MODULE_ID;
             }
         }
@@ -776,7 +862,7 @@ void autoInitializeModules() {
             trioModules[i].state == TRIO_MODULE_STATE_DISCOVERED &&
             !trioModules[i].initializationComplete) {
             
-            Serial.printf("Auto-initializing module %d\n", trioModules[i].moduleId);
+            LOG_I(LOG_MODULE_TRIO_MANAGER, "Auto-initializing module %d", trioModules[i].moduleId);
             initializeModule(trioModules[i].moduleId);
         }
     }
@@ -802,7 +888,7 @@ bool isValidModuleId(uint8_t moduleId) {
 
 bool setSystemOperationalReadiness(bool ready) {
     if (!managerInitialized) {
-        Serial.println("[TRIO HP MANAGER] ERROR: Manager not initialized");
+        LOG_E(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] ERROR: Manager not initialized");
         return false;
     }
     
@@ -827,15 +913,15 @@ bool setSystemOperationalReadiness(bool ready) {
     bool success = sendBroadcastCommand(command, controlValue);
     
     if (success) {
-        Serial.printf("[TRIO HP MANAGER] System state changed: %s -> %s (command: 0x%04X 0x%02X)\n",
-                      oldState == TRIO_SYSTEM_OFF ? "OFF" : "OPERATIONAL",
-                      newState == TRIO_SYSTEM_OFF ? "OFF" : "OPERATIONAL",
-                      command, controlValue);
+        LOG_I(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] System state changed: %s -> %s (command: 0x%04X 0x%02X)",
+                                       oldState == TRIO_SYSTEM_OFF ? "OFF" : "OPERATIONAL",
+                                       newState == TRIO_SYSTEM_OFF ? "OFF" : "OPERATIONAL",
+                                       command, controlValue);
     } else {
         // Revert state change on command failure
         trioSystemStatus.systemState = oldState;
-        Serial.printf("[TRIO HP MANAGER] ERROR: Failed to set system state to %s\n",
-                      ready ? "OPERATIONAL" : "OFF");
+        LOG_E(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] ERROR: Failed to set system state to %s",
+                                       ready ? "OPERATIONAL" : "OFF");
         return false;
     }
     
@@ -844,7 +930,7 @@ bool setSystemOperationalReadiness(bool ready) {
 
 bool canSendCommand(uint16_t command) {
     if (!managerInitialized) {
-        Serial.println("[TRIO HP MANAGER] ERROR: Manager not initialized");
+        LOG_E(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] ERROR: Manager not initialized");
         return false;
     }
     
@@ -864,13 +950,13 @@ bool canSendCommand(uint16_t command) {
             case 0x2117:  // Reactive type command
                 return true;
             default:
-                Serial.printf("[TRIO HP MANAGER] Command 0x%04X not allowed in OPERATIONAL state\n", command);
+                LOG_W(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] Command 0x%04X not allowed in OPERATIONAL state", command);
                 return false;
         }
     }
     
     // Unknown state - default to not allowed
-    Serial.printf("[TRIO HP MANAGER] ERROR: Unknown system state: %d\n", (int)state);
+    LOG_E(LOG_MODULE_TRIO_MANAGER, "[TRIO HP MANAGER] ERROR: Unknown system state: %d", (int)state);
     return false;
 }
 
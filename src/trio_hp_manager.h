@@ -10,13 +10,16 @@
 //
 // 📋 MODULE INFO:
 //    Module: TRIO HP Module Management and Discovery
-//    Version: v1.0.0
+//    Version: v1.2.1
 //    Created: 28.08.2025 (Warsaw Time)
-//    Last Modified: 28.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
 //    v1.0.0 - 28.08.2025 - Initial TRIO HP manager implementation
+//    v1.1.0 - 18.10.2026 - Per-module command/response correlation
+//    v1.2.0 - 18.10.2026 - Frames transmitted on the CAN channel bound to TRIO HP
+//    v1.2.1 - 18.10.2026 - Correlated 0x23 read requests, module status word kept
 //
 // 🎯 DEPENDENCIES:
 //    Internal: trio_hp_protocol.h, config.h
@@ -99,6 +102,14 @@ typedef enum {
     TRIO_SYSTEM_OPERATIONAL = 1    // System OPERATIONAL - 0x11 0x10 A0 (only operational commands allowed)
 } TrioSystemState_t;
 
+// === RESPONSE CORRELATION STATUS ===
+typedef enum {
+    TRIO_RESPONSE_NONE = 0,             // No command awaiting response
+    TRIO_RESPONSE_PENDING,              // Command sent, response not yet received
+    TRIO_RESPONSE_ACK,                  // Matching response with normal error code
+    TRIO_RESPONSE_NACK                  // Matching response with error code set
+} TrioResponseStatus_t;
+
 // === MODULE INFORMATION STRUCTURE ===
 typedef struct {
     uint8_t moduleId;                   // Module ID (0-47)
@@ -122,6 +133,8 @@ typedef struct {
     bool ledBlinking;                   // LED blink status
     bool sleepMode;                     // Sleep mode status
     uint8_t lastErrorCode;              // Last CAN error code received
+    uint32_t statusWord;                // Last status read (ST2 ST1 ST0)
+    unsigned long statusTime;           // When statusWord was received (0 = never)
     
     // Module capabilities
     bool supportsGridTie;               // Supports grid-tie mode
@@ -133,6 +146,12 @@ typedef struct {
     bool initializationComplete;        // Initialization status
     uint8_t initializationStep;         // Current init step
     
+    // Response correlation
+    uint16_t awaitedCommand;            // Command awaiting response (0 = none)
+    unsigned long awaitedSince;         // When awaited command was sent
+    TrioResponseStatus_t awaitedStatus; // Correlation result
+    bool awaitedRead;                   // Awaiting a 0x23 read response, not a write ACK
+    
 } TrioModuleInfo_t;
 
 // === SYSTEM STATUS STRUCTURE ===
@@ -221,6 +240,8 @@ bool sendModuleCommand(uint8_t moduleId, uint16_t command, uint32_t data);
 bool sendControlCommand(uint8_t moduleId, uint16_t command, uint8_t controlValue);
 bool sendFloatCommand(uint8_t moduleId, uint16_t command, float value);
 bool sendBroadcastCommand(uint16_t command, uint32_t data);
+bool sendModuleReadRequest(uint8_t moduleId, uint16_t command);  // 0x23 read
+bool transmitTrioHPFrame(const TrioHPCanFrame_t* frame);       // 29-bit ID, bound CAN channel
 bool queueModuleCommand(uint8_t moduleId, uint16_t command, uint32_t data, bool isControl);
 
 // === OPERATIONAL READINESS CONTROL FUNCTIONS ===
@@ -270,6 +291,9 @@ void autoInitializeModules();
 
 // === RESPONSE PROCESSING FUNCTIONS ===
 bool processModuleResponse(uint32_t canId, const uint8_t* data, uint8_t length);
+bool expectModuleResponse(uint8_t moduleId, uint16_t command);
+bool expectModuleReadResponse(uint8_t moduleId, uint16_t command);  // Matches 0x23 responses only
+TrioResponseStatus_t getModuleResponseStatus(uint8_t moduleId, uint16_t command);
 void handleCommandResponse(uint8_t moduleId, const TrioHPCanFrame_t* frame);
 void handleErrorResponse(uint8_t moduleId, uint8_t errorCode);
 bool validateResponseFrame(const TrioHPCanFrame_t* frame, uint8_t expectedModuleId);
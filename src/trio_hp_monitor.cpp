@@ -10,16 +10,20 @@
 //
 // 📋 MODULE INFO:
 //    Module: TRIO HP Data Monitoring Implementation
-//    Version: v1.0.0
+//    Version: v1.2.2
 //    Created: 28.08.2025 (Warsaw Time)
-//    Last Modified: 28.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
 //    v1.0.0 - 28.08.2025 - Initial TRIO HP monitoring implementation
+//    v1.1.0 - 18.10.2026 - Poll frames transmitted on the TRIO HP CAN channel
+//    v1.2.0 - 18.10.2026 - Adaptive polling defers bursts that exceed the CAN load budget
+//    v1.2.1 - 18.10.2026 - Operational messages through the async log sink
+//    v1.2.2 - 18.10.2026 - No blocking delay after each poll frame
 //
 // 🎯 DEPENDENCIES:
-//    Internal: trio_hp_monitor.h, trio_hp_protocol.h, trio_hp_manager.h, config.h
+//    Internal: trio_hp_monitor.h, trio_hp_protocol.h, trio_hp_manager.h, config.h, can_load.h
 //    External: Arduino.h
 //
 // 📝 DESCRIPTION:
@@ -56,7 +60,9 @@
 #include "trio_hp_monitor.h"
 #include "trio_hp_protocol.h"
 #include "trio_hp_manager.h"
+#include "log_sink.h"
 #include "config.h"
+#include "can_load.h"
 
 // === GLOBAL VARIABLES ===
 TrioHPModuleData_t trioModuleData[TRIO_HP_MAX_MODULES];
@@ -81,6 +87,15 @@ static unsigned long lastMulticastSlowPoll = 0;
 static uint8_t currentFastPollModule = 0;
 static uint8_t currentSlowPollModule = 0;
 
+// === PRIVATE HELPERS ===
+
+// Request + response per poll, at worst-case frame length
+static bool pollBurstAdmitted(uint8_t polls) {
+    if (!adaptivePollingEnabled) return true;
+    uint32_t bits = (uint32_t)polls * 2 * canFrameBitsWorstCase(true, TRIO_HP_CAN_FRAME_LENGTH);
+    return canLoadAdmit(CAN_PROTOCOL_TRIO, bits);
+}
+
 // === MONITOR INITIALIZATION FUNCTIONS ===
 
 bool initTrioHPMonitor() {
@@ -134,7 +149,7 @@ bool startTrioHPMonitoring() {
     lastMulticastFastPoll = millis();
     lastMulticastSlowPoll = millis();
     
-    Serial.println("TRIO HP monitoring started");
+    LOG_I(LOG_MODULE_TRIO_MONITOR, "TRIO HP monitoring started");
     return true;
 }
 
@@ -147,7 +162,7 @@ bool enableBroadcastPolling(uint32_t intervalMs) {
     broadcastPollingEnabled = true;
     trioSystemData.broadcastPollingActive = true;
     
-    Serial.printf("Broadcast polling enabled: %d ms interval\n", intervalMs);
+    LOG_I(LOG_MODULE_TRIO_MONITOR, "Broadcast polling enabled: %d ms interval", intervalMs);
     return true;
 }
 
@@ -160,8 +175,8 @@ bool enableMulticastPolling(uint32_t fastIntervalMs, uint32_t slowIntervalMs) {
     multicastPollingEnabled = true;
     trioSystemData.multicastPollingActive = true;
     
-    Serial.printf("Multicast polling enabled: Fast=%d ms, Slow=%d ms\n", 
-                  fastIntervalMs, slowIntervalMs);
+    LOG_I(LOG_MODULE_TRIO_MONITOR, "Multicast polling enabled: Fast=%d ms, Slow=%d ms", 
+                                   fastIntervalMs, slowIntervalMs);
     return true;
 }
 
@@ -173,21 +188,26 @@ bool performSystemBroadcastPoll() {
     unsigned long currentTime = millis();
     if (currentTime - lastBroadcastPoll < broadcastInterval) return true;
     
-    Serial.println("Executing system broadcast poll...");
+    if (!pollBurstAdmitted(3)) {
+        lastBroadcastPoll = currentTime - broadcastInterval + CAN_LOAD_RETRY_MS;
+        return true;
+    }
+    
+    LOG_D(LOG_MODULE_TRIO_MONITOR, "Executing system broadcast poll...");
     
     // Poll system DC voltage
     if (!pollSystemParameter(TRIO_HP_CMD_SYSTEM_DC_VOLTAGE, TRIO_DATA_TYPE_DC_VOLTAGE)) {
-        Serial.println("Failed to poll system DC voltage");
+        LOG_E(LOG_MODULE_TRIO_MONITOR, "Failed to poll system DC voltage");
     }
     
     // Poll system DC current  
     if (!pollSystemParameter(TRIO_HP_CMD_SYSTEM_DC_CURRENT, TRIO_DATA_TYPE_DC_CURRENT)) {
-        Serial.println("Failed to poll system DC current");
+        LOG_E(LOG_MODULE_TRIO_MONITOR, "Failed to poll system DC current");
     }
     
     // Poll module count
     if (!pollSystemParameter(TRIO_HP_CMD_SYSTEM_MODULE_COUNT, TRIO_DATA_TYPE_COUNT)) {
-        Serial.println("Failed to poll module count");
+        LOG_E(LOG_MODULE_TRIO_MONITOR, "Failed to poll module count");
     }
     
     lastBroadcastPoll = currentTime;
@@ -213,7 +233,12 @@ bool performModuleMulticastPoll(uint8_t moduleId) {
     
     if (currentTime - moduleData->lastPollTime < interval) return true;
     
-    Serial.printf("Polling module %d...\n", moduleId);
+    if (!pollBurstAdmitted(6)) {
+        moduleData->lastPollTime = currentTime - interval + CAN_LOAD_RETRY_MS;
+        return true;
+    }
+    
+    LOG_D(LOG_MODULE_TRIO_MONITOR, "Polling module %d...", moduleId);
     
     // Poll DC measurements
     pollModuleParameter(moduleId, 0x1101, TRIO_DATA_TYPE_DC_VOLTAGE);    // DC voltage
@@ -242,15 +267,9 @@ bool pollModuleParameter(uint8_t moduleId, uint16_t command, TrioDataType_t data
         return false;
     }
     
-    // Here we would send via actual CAN bus - for now simulate
-    Serial.printf("Poll cmd 0x%04X -> module %d (%s)\n", 
-                  command, moduleId, getDataTypeName(dataType));
-    
-    // Simulate response processing delay
-    delay(1);
-    
-    // For now, simulate successful poll
-    return true;
+    LOG_D(LOG_MODULE_TRIO_MONITOR, "Poll cmd 0x%04X -> module %d (%s)", 
+                                   command, moduleId, getDataTypeName(dataType));
+    return transmitTrioHPFrame(&pollFrame);
 }
 
 bool pollSystemParameter(uint16_t command, TrioDataType_t dataType) {
@@ -259,12 +278,8 @@ bool pollSystemParameter(uint16_t command, TrioDataType_t dataType) {
         return false;
     }
     
-    Serial.printf("System poll cmd 0x%04X (%s)\n", command, getDataTypeName(dataType));
-    
-    // Simulate processing delay
-    delay(1);
-    
-    return true;
+    LOG_D(LOG_MODULE_TRIO_MONITOR, "System poll cmd 0x%04X (%s)", command, getDataTypeName(dataType));
+    return transmitTrioHPFrame(&pollFrame);
 }
 
 // === DATA PARSING FUNCTIONS ===
@@ -844,8 +859,8 @@ void checkDataFreshness() {
 }
 
 void handleStaleData(uint8_t moduleId, TrioDataType_t dataType) {
-    Serial.printf("Stale data detected for module %d (%s)\n", 
-                  moduleId, getDataTypeName(dataType));
+    LOG_W(LOG_MODULE_TRIO_MONITOR, "Stale data detected for module %d (%s)", 
+                                   moduleId, getDataTypeName(dataType));
     
     // Mark module for priority polling
     setPollingPriority(moduleId, 0); // Highest priority
@@ -0,0 +1,532 @@
+// =====================================================================
+// === trio_hp_params.cpp - TRIO HP Parameter Registry Implementation ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: TRIO HP Parameter Registry Implementation
+//    Version: v1.2.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Initial declarative parameter table with O(1) lookup
+//    v1.1.0 - 18.10.2026 - Factory defaults, profile persistence class, transactional batch set
+//    v1.2.0 - 18.10.2026 - Register block writes (FC16) applied as one batch; batch edits mark profiles custom
+//
+// 🎯 DEPENDENCIES:
+//    Internal: trio_hp_params.h, trio_hp_config.h
+//    External: Arduino.h, stddef.h (offsetof)
+//
+// 📝 DESCRIPTION:
+//    Parameter table and perfect-hash indexes. Each index is a 128-slot byte
+//    array mapping (key ^ seed) * golden-ratio >> 25 to a table index; the
+//    seed is searched once at startup so that no two parameters collide, so
+//    every lookup is a single multiply plus one verification compare.
+//
+// 🔧 IMPLEMENTATION DETAILS:
+//    - Table is constexpr and lives in flash
+//    - Name hashes are computed at compile time (FNV-1a)
+//    - Uniqueness of IDs, name hashes and Modbus offsets is checked by static_assert
+//    - setTrioParam() rolls back when cross-field validation fails
+//    - setTrioParams() checks a whole batch first and validates cross-field
+//      rules once on the final state, so profile switches never fail halfway
+//    - Editing a profile-class parameter marks the active profile as custom
+//    - writeTrioParamRegisters() turns a register block into one batch, so a
+//      rejected register leaves the whole block unapplied
+//
+// ⚠️  KNOWN ISSUES:
+//    - None currently identified
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Lookup: O(1), ~1μs
+//    - Index build: <1ms once, falls back to linear scan if no seed is found
+//
+// =====================================================================
+
+#include "trio_hp_params.h"
+#include "trio_hp_config.h"
+#include "trio_hp_profiles.h"
+#include <stddef.h>
+
+// === TABLE HELPERS ===
+#define TRIO_CFG_OFFSET(field)    ((uint16_t)offsetof(TrioHPSystemConfig_t, field))
+#define TRIO_PARAM(id, name, unit, field, type, defV, minV, maxV, lockClass, persist, regOffset, scale) \
+    { (uint16_t)(id), trioParamHash(name), name, unit, TRIO_CFG_OFFSET(field), type, \
+      defV, minV, maxV, lockClass, persist, regOffset, scale }
+#define TRIO_COMMAND(id, name, unit, minV, maxV, lockClass) \
+    { (uint16_t)(id), trioParamHash(name), name, unit, TRIO_HP_PARAM_NO_STORAGE, TRIO_PARAM_TYPE_FLOAT, \
+      0.0f, minV, maxV, lockClass, TRIO_PARAM_PERSIST_RUNTIME, TRIO_HP_PARAM_NO_REGISTER, 1.0f }
+
+#define P_PROFILE TRIO_PARAM_PERSIST_PROFILE
+#define P_EEPROM  TRIO_PARAM_PERSIST_EEPROM
+
+// === PARAMETER TABLE ===
+// Factory defaults live here; setDefaultSystemConfiguration() applies them
+static constexpr TrioParamDescriptor_t TRIO_PARAM_TABLE[] = {
+    // Timing (config lock, part of profiles)
+    TRIO_PARAM(TRIO_PARAM_ID_BROADCAST_INTERVAL,      "broadcast_interval",      "ms", timing.broadcastInterval,     TRIO_PARAM_TYPE_U32,   5000,  TRIO_HP_MIN_BROADCAST_INTERVAL, TRIO_HP_MAX_BROADCAST_INTERVAL, TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 0,  1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_MULTICAST_FAST_INTERVAL, "multicast_fast_interval", "ms", timing.multicastFastInterval, TRIO_PARAM_TYPE_U32,   500,   TRIO_HP_MIN_MULTICAST_INTERVAL, TRIO_HP_MAX_MULTICAST_INTERVAL, TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 1,  1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_MULTICAST_SLOW_INTERVAL, "multicast_slow_interval", "ms", timing.multicastSlowInterval, TRIO_PARAM_TYPE_U32,   1000,  TRIO_HP_MIN_MULTICAST_INTERVAL, TRIO_HP_MAX_MULTICAST_INTERVAL, TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 2,  1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_ON_DEMAND_TIMEOUT,       "on_demand_timeout",       "ms", timing.onDemandTimeout,       TRIO_PARAM_TYPE_U32,   2000,  100,   10000, TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 3,  1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_POLL_RESPONSE_TIMEOUT,   "poll_response_timeout",   "ms", timing.pollResponseTimeout,   TRIO_PARAM_TYPE_U32,   2000,  50,    10000, TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 4,  1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_MAX_CONCURRENT_POLLS,    "max_concurrent_polls",    "",   timing.maxConcurrentPolls,    TRIO_PARAM_TYPE_U8,    3,     1,     10,    TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 5,  1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_BUSY_BACKOFF_DELAY,      "busy_backoff_delay",      "ms", timing.busyBackoffDelay,      TRIO_PARAM_TYPE_U32,   50,    0,     5000,  TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 6,  1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_ERROR_RETRY_DELAY,       "error_retry_delay",       "ms", timing.errorRetryDelay,       TRIO_PARAM_TYPE_U32,   1000,  0,     30000, TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 7,  1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_ADAPTIVE_SCALE_FACTOR,   "adaptive_scale_factor",   "",   timing.adaptiveScaleFactor,   TRIO_PARAM_TYPE_FLOAT, 1.1f,  0.1f,  10.0f, TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 8,  100.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_MAX_RETRY_ATTEMPTS,      "max_retry_attempts",      "",   timing.maxRetryAttempts,      TRIO_PARAM_TYPE_U8,    3,     0,     10,    TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 9,  1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_ADAPTIVE_POLLING,        "adaptive_polling",        "",   timing.enableAdaptivePolling, TRIO_PARAM_TYPE_BOOL,  1,     0,     1,     TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 10, 1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_PRIORITY_POLLING,        "priority_polling",        "",   timing.enablePriorityPolling, TRIO_PARAM_TYPE_BOOL,  1,     0,     1,     TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 11, 1.0f),
+
+    // System / communication (config lock)
+    TRIO_PARAM(TRIO_PARAM_ID_SYSTEM_ENABLED,          "system_enabled",          "",   systemEnabled,        TRIO_PARAM_TYPE_BOOL, 1,     0,     1,     TRIO_PARAM_LOCK_CONFIG, P_EEPROM,  16, 1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_MAX_ACTIVE_MODULES,      "max_active_modules",      "",   maxActiveModules,     TRIO_PARAM_TYPE_U8,   16,    1,     TRIO_HP_MAX_MODULES, TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 17, 1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_HEARTBEAT_TIMEOUT,       "heartbeat_timeout",       "ms", heartbeatTimeout,     TRIO_PARAM_TYPE_U32,  10000, TRIO_HP_MIN_HEARTBEAT_TIMEOUT, TRIO_HP_MAX_HEARTBEAT_TIMEOUT, TRIO_PARAM_LOCK_CONFIG, P_EEPROM, 18, 1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_COMMUNICATION_TIMEOUT,   "communication_timeout",   "ms", communicationTimeout, TRIO_PARAM_TYPE_U32,  5000,  100,   60000, TRIO_PARAM_LOCK_CONFIG, P_EEPROM,  19, 1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_MAX_RETRY_COUNT,         "max_retry_count",         "",   maxRetryCount,        TRIO_PARAM_TYPE_U8,   3,     0,     10,    TRIO_PARAM_LOCK_CONFIG, P_EEPROM,  20, 1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_ERROR_RECOVERY,          "error_recovery",          "",   enableErrorRecovery,  TRIO_PARAM_TYPE_BOOL, 1,     0,     1,     TRIO_PARAM_LOCK_CONFIG, P_EEPROM,  21, 1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_DATA_HISTORY_SIZE,       "data_history_size",       "",   dataHistorySize,      TRIO_PARAM_TYPE_U8,   10,    1,     50,    TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 22, 1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_MODBUS_UPDATE_INTERVAL,  "modbus_update_interval",  "ms", modbusUpdateInterval, TRIO_PARAM_TYPE_U32,  1000,  100,   60000, TRIO_PARAM_LOCK_CONFIG, P_EEPROM,  23, 1.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_DATA_BACKUP,             "data_backup",             "",   enableDataBackup,     TRIO_PARAM_TYPE_BOOL, 0,     0,     1,     TRIO_PARAM_LOCK_CONFIG, P_PROFILE, 24, 1.0f),
+
+    // Global safety limits (safety lock)
+    TRIO_PARAM(TRIO_PARAM_ID_SYSTEM_VOLTAGE_MIN,      "system_voltage_min",      "V",  systemVoltageMin,     TRIO_PARAM_TYPE_FLOAT, 300.0f, 0.0f, 1000.0f, TRIO_PARAM_LOCK_SAFETY, P_EEPROM, 32, 10.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_SYSTEM_VOLTAGE_MAX,      "system_voltage_max",      "V",  systemVoltageMax,     TRIO_PARAM_TYPE_FLOAT, 500.0f, 0.0f, 1000.0f, TRIO_PARAM_LOCK_SAFETY, P_EEPROM, 33, 10.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_SYSTEM_CURRENT_MAX,      "system_current_max",      "A",  systemCurrentMax,     TRIO_PARAM_TYPE_FLOAT, 100.0f, 0.0f, 2000.0f, TRIO_PARAM_LOCK_SAFETY, P_EEPROM, 34, 10.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_SYSTEM_POWER_MAX,        "system_power_max",        "kW", systemPowerMax,       TRIO_PARAM_TYPE_FLOAT, 50.0f,  0.0f, 5000.0f, TRIO_PARAM_LOCK_SAFETY, P_EEPROM, 35, 10.0f),
+    TRIO_PARAM(TRIO_PARAM_ID_SYSTEM_TEMP_MAX,         "system_temp_max",         "C",  systemTempMax,        TRIO_PARAM_TYPE_FLOAT, 70.0f,  0.0f, 150.0f,  TRIO_PARAM_LOCK_SAFETY, P_EEPROM, 36, 10.0f),
+
+    // TRIO HP runtime commands (lock class only, no storage)
+    TRIO_COMMAND(TRIO_PARAM_ID_SYSTEM_CURRENT,        "system_current",          "A",  -2000.0f, 2000.0f, TRIO_PARAM_LOCK_POWER),
+    TRIO_COMMAND(TRIO_PARAM_ID_REACTIVE_POWER,        "reactive_power",          "VAr", -1.0e6f, 1.0e6f,  TRIO_PARAM_LOCK_POWER),
+    TRIO_COMMAND(TRIO_PARAM_ID_WORK_MODE,             "work_mode",               "",   0.0f,     255.0f,  TRIO_PARAM_LOCK_MODE),
+    TRIO_COMMAND(TRIO_PARAM_ID_REACTIVE_TYPE,         "reactive_type",           "",   0.0f,     255.0f,  TRIO_PARAM_LOCK_MODE),
+    TRIO_COMMAND(TRIO_PARAM_ID_SYSTEM_STATE,          "system_state",            "",   0.0f,     255.0f,  TRIO_PARAM_LOCK_CONFIG)
+};
+
+static constexpr uint8_t TRIO_PARAM_COUNT = sizeof(TRIO_PARAM_TABLE) / sizeof(TRIO_PARAM_TABLE[0]);
+
+// === COMPILE-TIME TABLE CHECKS ===
+constexpr bool paramKeysDiffer(uint8_t a, uint8_t b) {
+    return TRIO_PARAM_TABLE[a].id != TRIO_PARAM_TABLE[b].id &&
+           TRIO_PARAM_TABLE[a].nameHash != TRIO_PARAM_TABLE[b].nameHash &&
+           (TRIO_PARAM_TABLE[a].modbusOffset == TRIO_HP_PARAM_NO_REGISTER ||
+            TRIO_PARAM_TABLE[a].modbusOffset != TRIO_PARAM_TABLE[b].modbusOffset);
+}
+
+constexpr bool paramUniqueAgainst(uint8_t a, uint8_t b) {
+    return b >= TRIO_PARAM_COUNT ? true : (paramKeysDiffer(a, b) && paramUniqueAgainst(a, b + 1));
+}
+
+constexpr bool paramTableUnique(uint8_t a) {
+    return a >= TRIO_PARAM_COUNT ? true : (paramUniqueAgainst(a, a + 1) && paramTableUnique(a + 1));
+}
+
+static_assert(TRIO_PARAM_COUNT <= TRIO_HP_PARAM_MAX_COUNT, "TRIO HP parameter table exceeds TRIO_HP_PARAM_MAX_COUNT");
+static_assert(paramTableUnique(0), "TRIO HP parameter IDs, names and Modbus offsets must be unique");
+
+// === PERFECT HASH INDEXES ===
+#define TRIO_PARAM_INDEX_BITS   7
+#define TRIO_PARAM_INDEX_SIZE   (1 << TRIO_PARAM_INDEX_BITS)
+#define TRIO_PARAM_INDEX_EMPTY  0xFF
+#define TRIO_PARAM_SEED_TRIES   2048
+
+typedef struct {
+    uint32_t seed;
+    bool perfect;
+    uint8_t slots[TRIO_PARAM_INDEX_SIZE];
+} TrioParamIndex_t;
+
+static TrioParamIndex_t idIndex;
+static TrioParamIndex_t nameIndex;
+static uint8_t registerIndex[TRIO_HP_PARAM_MODBUS_MAX_REGISTERS];
+static bool paramsInitialized = false;
+
+static inline uint8_t indexSlot(uint32_t key, uint32_t seed) {
+    return (uint8_t)(((key ^ seed) * 2654435761u) >> (32 - TRIO_PARAM_INDEX_BITS));
+}
+
+static uint32_t idKey(uint8_t i)   { return TRIO_PARAM_TABLE[i].id; }
+static uint32_t nameKey(uint8_t i) { return TRIO_PARAM_TABLE[i].nameHash; }
+
+static bool buildIndex(TrioParamIndex_t* index, uint32_t (*keyOf)(uint8_t)) {
+    for (uint32_t seed = 0; seed < TRIO_PARAM_SEED_TRIES; seed++) {
+        memset(index->slots, TRIO_PARAM_INDEX_EMPTY, sizeof(index->slots));
+        bool collision = false;
+
+        for (uint8_t i = 0; i < TRIO_PARAM_COUNT && !collision; i++) {
+            uint8_t slot = indexSlot(keyOf(i), seed);
+            if (index->slots[slot] != TRIO_PARAM_INDEX_EMPTY) {
+                collision = true;
+            } else {
+                index->slots[slot] = i;
+            }
+        }
+
+        if (!collision) {
+            index->seed = seed;
+            index->perfect = true;
+            return true;
+        }
+    }
+
+    index->perfect = false;
+    return false;
+}
+
+static int16_t lookupIndex(const TrioParamIndex_t* index, uint32_t key, uint32_t (*keyOf)(uint8_t)) {
+    if (index->perfect) {
+        uint8_t i = index->slots[indexSlot(key, index->seed)];
+        return (i != TRIO_PARAM_INDEX_EMPTY && keyOf(i) == key) ? i : -1;
+    }
+
+    // Fallback: no perfect seed found
+    for (uint8_t i = 0; i < TRIO_PARAM_COUNT; i++) {
+        if (keyOf(i) == key) return i;
+    }
+    return -1;
+}
+
+static inline void ensureParamsInitialized() {
+    if (!paramsInitialized) initTrioHPParams();
+}
+
+// === REGISTRY FUNCTIONS ===
+
+bool initTrioHPParams() {
+    bool idOk = buildIndex(&idIndex, idKey);
+    bool nameOk = buildIndex(&nameIndex, nameKey);
+
+    memset(registerIndex, TRIO_PARAM_INDEX_EMPTY, sizeof(registerIndex));
+    for (uint8_t i = 0; i < TRIO_PARAM_COUNT; i++) {
+        uint8_t offset = TRIO_PARAM_TABLE[i].modbusOffset;
+        if (offset < TRIO_HP_PARAM_MODBUS_MAX_REGISTERS) {
+            registerIndex[offset] = i;
+        }
+    }
+
+    paramsInitialized = true;
+
+    Serial.printf("[TRIO HP PARAMS] %d parameters, ID seed %lu%s, name seed %lu%s\n",
+                  TRIO_PARAM_COUNT,
+                  (unsigned long)idIndex.seed, idOk ? "" : " (linear)",
+                  (unsigned long)nameIndex.seed, nameOk ? "" : " (linear)");
+    return idOk && nameOk;
+}
+
+uint8_t getTrioParamCount() {
+    return TRIO_PARAM_COUNT;
+}
+
+const TrioParamDescriptor_t* getTrioParamByIndex(uint8_t index) {
+    return index < TRIO_PARAM_COUNT ? &TRIO_PARAM_TABLE[index] : nullptr;
+}
+
+const TrioParamDescriptor_t* findTrioParamById(uint16_t id) {
+    ensureParamsInitialized();
+    int16_t i = lookupIndex(&idIndex, id, idKey);
+    return i >= 0 ? &TRIO_PARAM_TABLE[i] : nullptr;
+}
+
+const TrioParamDescriptor_t* findTrioParamByName(const char* name) {
+    if (name == nullptr) return nullptr;
+    ensureParamsInitialized();
+
+    int16_t i = lookupIndex(&nameIndex, trioParamHash(name), nameKey);
+    if (i < 0 || strcmp(TRIO_PARAM_TABLE[i].name, name) != 0) return nullptr;
+    return &TRIO_PARAM_TABLE[i];
+}
+
+const TrioParamDescriptor_t* findTrioParamByRegister(uint16_t address) {
+    if (address < TRIO_HP_PARAM_MODBUS_START_REGISTER ||
+        address >= TRIO_HP_PARAM_MODBUS_START_REGISTER + TRIO_HP_PARAM_MODBUS_MAX_REGISTERS) {
+        return nullptr;
+    }
+    ensureParamsInitialized();
+
+    uint8_t i = registerIndex[address - TRIO_HP_PARAM_MODBUS_START_REGISTER];
+    return i != TRIO_PARAM_INDEX_EMPTY ? &TRIO_PARAM_TABLE[i] : nullptr;
+}
+
+// === GENERIC ACCESS ===
+
+static void* paramStorage(const TrioParamDescriptor_t* param) {
+    if (param->offset == TRIO_HP_PARAM_NO_STORAGE) return nullptr;
+    return reinterpret_cast<uint8_t*>(&trioHPConfig) + param->offset;
+}
+
+static float readStorage(const TrioParamDescriptor_t* param, const void* ptr) {
+    switch (param->type) {
+        case TRIO_PARAM_TYPE_BOOL:  return *static_cast<const bool*>(ptr) ? 1.0f : 0.0f;
+        case TRIO_PARAM_TYPE_U8:    return (float)*static_cast<const uint8_t*>(ptr);
+        case TRIO_PARAM_TYPE_U16:   return (float)*static_cast<const uint16_t*>(ptr);
+        case TRIO_PARAM_TYPE_U32:   return (float)*static_cast<const uint32_t*>(ptr);
+        case TRIO_PARAM_TYPE_FLOAT: return *static_cast<const float*>(ptr);
+    }
+    return 0.0f;
+}
+
+static void writeStorage(const TrioParamDescriptor_t* param, void* ptr, float value) {
+    switch (param->type) {
+        case TRIO_PARAM_TYPE_BOOL:  *static_cast<bool*>(ptr) = (value != 0.0f); break;
+        case TRIO_PARAM_TYPE_U8:    *static_cast<uint8_t*>(ptr) = (uint8_t)(value + 0.5f); break;
+        case TRIO_PARAM_TYPE_U16:   *static_cast<uint16_t*>(ptr) = (uint16_t)(value + 0.5f); break;
+        case TRIO_PARAM_TYPE_U32:   *static_cast<uint32_t*>(ptr) = (uint32_t)(value + 0.5f); break;
+        case TRIO_PARAM_TYPE_FLOAT: *static_cast<float*>(ptr) = value; break;
+    }
+}
+
+bool getTrioParam(const TrioParamDescriptor_t* param, float* value) {
+    if (param == nullptr || value == nullptr) return false;
+
+    const void* ptr = paramStorage(param);
+    if (ptr == nullptr) return false;
+
+    *value = readStorage(param, ptr);
+    return true;
+}
+
+bool isTrioParamValueValid(const TrioParamDescriptor_t* param, float value) {
+    if (param == nullptr) return false;
+    return value >= param->minValue && value <= param->maxValue;
+}
+
+bool isTrioParamLocked(const TrioParamDescriptor_t* param) {
+    if (param == nullptr) return true;
+
+    const TrioParameterLock_t* lock = &trioHPConfig.parameterLock;
+    if (!lock->parameters_locked) return false;
+
+    switch (param->lockClass) {
+        case TRIO_PARAM_LOCK_POWER:  return lock->power_parameters_locked;
+        case TRIO_PARAM_LOCK_MODE:   return lock->mode_parameters_locked;
+        case TRIO_PARAM_LOCK_CONFIG: return lock->config_parameters_locked;
+        case TRIO_PARAM_LOCK_SAFETY: return lock->safety_parameters_locked;
+        case TRIO_PARAM_LOCK_NONE:   break;
+    }
+    return lock->lock_level >= 2;
+}
+
+bool isTrioParamWritable(const TrioParamDescriptor_t* param) {
+    return param != nullptr && param->offset != TRIO_HP_PARAM_NO_STORAGE && !isTrioParamLocked(param);
+}
+
+// Rules spanning several parameters (fast < slow multicast, min < max voltage)
+static bool crossFieldValid(const TrioParamDescriptor_t* param) {
+    if (isTrioTimingParam(param)) {
+        return validateTimingLimits(&trioHPConfig.timing);
+    }
+    if (param->id == TRIO_PARAM_ID_SYSTEM_VOLTAGE_MIN || param->id == TRIO_PARAM_ID_SYSTEM_VOLTAGE_MAX) {
+        return trioHPConfig.systemVoltageMin < trioHPConfig.systemVoltageMax;
+    }
+    return true;
+}
+
+bool setTrioParam(const TrioParamDescriptor_t* param, float value) {
+    if (param == nullptr) return false;
+
+    void* ptr = paramStorage(param);
+    if (ptr == nullptr) return false;
+
+    if (isTrioParamLocked(param)) {
+        Serial.printf("[TRIO HP PARAMS] %s is locked\n", param->name);
+        return false;
+    }
+
+    if (!isTrioParamValueValid(param, value)) {
+        Serial.printf("[TRIO HP PARAMS] %s=%.2f out of range [%.2f, %.2f]\n",
+                      param->name, value, param->minValue, param->maxValue);
+        return false;
+    }
+
+    float oldValue = readStorage(param, ptr);
+    writeStorage(param, ptr, value);
+
+    if (!crossFieldValid(param)) {
+        writeStorage(param, ptr, oldValue);
+        Serial.printf("[TRIO HP PARAMS] %s=%.2f rejected by cross-field validation\n", param->name, value);
+        return false;
+    }
+
+    if (param->persist != TRIO_PARAM_PERSIST_RUNTIME && readStorage(param, ptr) != oldValue) {
+        markTrioHPConfigDirty();
+        if (param->persist == TRIO_PARAM_PERSIST_PROFILE) {
+            noteTrioProfileParamEdited();
+        }
+    }
+    return true;
+}
+
+bool setTrioParams(const TrioParamValue_t* values, uint8_t count, bool markDirty) {
+    if (values == nullptr || count > TRIO_HP_PARAM_MAX_COUNT) return false;
+
+    const TrioParamDescriptor_t* params[TRIO_HP_PARAM_MAX_COUNT];
+    float oldValues[TRIO_HP_PARAM_MAX_COUNT];
+
+    // Pass 1: resolve, lock and range check everything before touching storage
+    for (uint8_t i = 0; i < count; i++) {
+        params[i] = findTrioParamById(values[i].id);
+        if (params[i] == nullptr || paramStorage(params[i]) == nullptr) {
+            Serial.printf("[TRIO HP PARAMS] Batch: unknown parameter 0x%04X\n", values[i].id);
+            return false;
+        }
+        if (isTrioParamLocked(params[i])) {
+            Serial.printf("[TRIO HP PARAMS] Batch: %s is locked\n", params[i]->name);
+            return false;
+        }
+        if (!isTrioParamValueValid(params[i], values[i].value)) {
+            Serial.printf("[TRIO HP PARAMS] Batch: %s=%.2f out of range\n", params[i]->name, values[i].value);
+            return false;
+        }
+    }
+
+    // Pass 2: write, then validate cross-field rules once on the final state
+    bool persistentChanged = false;
+    bool profileChanged = false;
+    bool timingTouched = false;
+    bool voltageTouched = false;
+    for (uint8_t i = 0; i < count; i++) {
+        void* ptr = paramStorage(params[i]);
+        oldValues[i] = readStorage(params[i], ptr);
+        writeStorage(params[i], ptr, values[i].value);
+        if (readStorage(params[i], ptr) != oldValues[i]) {
+            persistentChanged |= (params[i]->persist != TRIO_PARAM_PERSIST_RUNTIME);
+            profileChanged |= (params[i]->persist == TRIO_PARAM_PERSIST_PROFILE);
+        }
+        timingTouched |= isTrioTimingParam(params[i]);
+        voltageTouched |= (params[i]->id == TRIO_PARAM_ID_SYSTEM_VOLTAGE_MIN ||
+                           params[i]->id == TRIO_PARAM_ID_SYSTEM_VOLTAGE_MAX);
+    }
+
+    bool valid = (!timingTouched || validateTimingLimits(&trioHPConfig.timing)) &&
+                 (!voltageTouched || trioHPConfig.systemVoltageMin < trioHPConfig.systemVoltageMax);
+    if (!valid) {
+        // Roll back in reverse order so duplicate IDs restore the original value
+        for (int16_t i = (int16_t)count - 1; i >= 0; i--) {
+            writeStorage(params[i], paramStorage(params[i]), oldValues[i]);
+        }
+        Serial.printf("[TRIO HP PARAMS] Batch of %d rejected by cross-field validation\n", count);
+        return false;
+    }
+
+    if (markDirty && persistentChanged) {
+        markTrioHPConfigDirty();
+        if (profileChanged) {
+            noteTrioProfileParamEdited();
+        }
+    }
+    return true;
+}
+
+void applyTrioParamDefaults(bool timingOnly) {
+    for (uint8_t i = 0; i < TRIO_PARAM_COUNT; i++) {
+        const TrioParamDescriptor_t* param = &TRIO_PARAM_TABLE[i];
+        void* ptr = paramStorage(param);
+        if (ptr == nullptr) continue;
+        if (timingOnly && !isTrioTimingParam(param)) continue;
+        writeStorage(param, ptr, param->defaultValue);
+    }
+}
+
+bool isTrioTimingParam(const TrioParamDescriptor_t* param) {
+    return param != nullptr &&
+           param->offset >= TRIO_CFG_OFFSET(timing) &&
+           param->offset < TRIO_CFG_OFFSET(timing) + sizeof(TrioHPTimingConfig_t);
+}
+
+bool getTrioParamById(uint16_t id, float* value) {
+    return getTrioParam(findTrioParamById(id), value);
+}
+
+bool setTrioParamById(uint16_t id, float value) {
+    return setTrioParam(findTrioParamById(id), value);
+}
+
+bool setTrioParamByName(const char* name, float value) {
+    return setTrioParam(findTrioParamByName(name), value);
+}
+
+// === MODBUS PARAMETER WINDOW ===
+
+bool isTrioParamRegisterRange(uint16_t startAddress, uint16_t count) {
+    uint32_t end = (uint32_t)startAddress + count;
+    return count > 0 &&
+           startAddress >= TRIO_HP_PARAM_MODBUS_START_REGISTER &&
+           end <= TRIO_HP_PARAM_MODBUS_START_REGISTER + TRIO_HP_PARAM_MODBUS_MAX_REGISTERS;
+}
+
+bool readTrioParamRegister(uint16_t address, uint16_t* value) {
+    if (value == nullptr) return false;
+
+    const TrioParamDescriptor_t* param = findTrioParamByRegister(address);
+    float raw;
+    if (!getTrioParam(param, &raw)) {
+        *value = 0;  // Unassigned registers read as zero
+        return param == nullptr && isTrioParamRegisterRange(address, 1);
+    }
+
+    float scaled = raw * param->modbusScale;
+    if (scaled < 0.0f) scaled = 0.0f;
+    if (scaled > 65535.0f) scaled = 65535.0f;
+    *value = (uint16_t)(scaled + 0.5f);
+    return true;
+}
+
+bool writeTrioParamRegister(uint16_t address, uint16_t value) {
+    const TrioParamDescriptor_t* param = findTrioParamByRegister(address);
+    if (param == nullptr) return false;
+
+    return setTrioParam(param, (float)value / param->modbusScale);
+}
+
+bool writeTrioParamRegisters(uint16_t startAddress, uint16_t count, const uint16_t* values) {
+    if (values == nullptr || !isTrioParamRegisterRange(startAddress, count)) return false;
+
+    // Each register maps to a distinct parameter, so the block fits one batch
+    TrioParamValue_t batch[TRIO_HP_PARAM_MODBUS_MAX_REGISTERS];
+    for (uint16_t i = 0; i < count; i++) {
+        const TrioParamDescriptor_t* param = findTrioParamByRegister(startAddress + i);
+        if (param == nullptr) {
+            Serial.printf("[TRIO HP PARAMS] Register %u is not assigned\n", startAddress + i);
+            return false;
+        }
+        batch[i].id = param->id;
+        batch[i].value = (float)values[i] / param->modbusScale;
+    }
+    return setTrioParams(batch, (uint8_t)count, true);
+}
+
+// === UTILITY FUNCTIONS ===
+
+const char* getTrioParamTypeName(TrioParamType_t type) {
+    switch (type) {
+        case TRIO_PARAM_TYPE_BOOL:  return "bool";
+        case TRIO_PARAM_TYPE_U8:    return "u8";
+        case TRIO_PARAM_TYPE_U16:   return "u16";
+        case TRIO_PARAM_TYPE_U32:   return "u32";
+        case TRIO_PARAM_TYPE_FLOAT: return "float";
+        default:                    return "unknown";
+    }
+}
+
+const char* getTrioParamLockClassName(TrioParamLockClass_t lockClass) {
+    switch (lockClass) {
+        case TRIO_PARAM_LOCK_NONE:   return "none";
+        case TRIO_PARAM_LOCK_POWER:  return "power";
+        case TRIO_PARAM_LOCK_MODE:   return "mode";
+        case TRIO_PARAM_LOCK_CONFIG: return "config";
+        case TRIO_PARAM_LOCK_SAFETY: return "safety";
+        default:                     return "unknown";
+    }
+}
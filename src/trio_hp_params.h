@@ -0,0 +1,190 @@
+// =====================================================================
+// === trio_hp_params.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: TRIO HP Parameter Registry
+//    Version: v1.2.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Initial declarative parameter table with O(1) lookup
+//    v1.1.0 - 18.10.2026 - Factory defaults, profile persistence class, transactional batch set
+//    v1.2.0 - 18.10.2026 - Register block writes (FC16) applied as one batch; batch edits mark profiles custom
+//
+// 🎯 DEPENDENCIES:
+//    Internal: trio_hp_config.h for TrioHPSystemConfig_t and parameter locking
+//    External: Arduino.h for standard types
+//
+// 📝 DESCRIPTION:
+//    Single constexpr table describing every tunable TRIO HP parameter: ID,
+//    name hash, storage offset in TrioHPSystemConfig_t, type, range, lock
+//    class, persistence class and Modbus register. Lookups by name, ID and
+//    Modbus register are O(1) through perfect-hash indexes built once at
+//    startup. Generic get/set validates ranges and lock state from the table,
+//    and the web form, config export and Modbus parameter window are all
+//    generated by iterating the same table.
+//
+// 🔧 CONFIGURATION:
+//    - Modbus parameter window: 5200 + modbusOffset (one register per parameter)
+//    - Register encoding: value * modbusScale, unsigned 16-bit
+//    - Command parameters (TRIO command codes) carry lock class only
+//
+// ⚠️  KNOWN ISSUES:
+//    - None currently identified
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Name/ID/register lookup: O(1), one hash + one compare
+//    - Index build: <1ms once at startup (perfect-hash seed search)
+//    - Memory: table in flash, ~400 bytes RAM for indexes
+//
+// =====================================================================
+
+#ifndef TRIO_HP_PARAMS_H
+#define TRIO_HP_PARAMS_H
+
+#include <Arduino.h>
+#include "trio_hp_config.h"
+
+// === MODBUS PARAMETER WINDOW ===
+#define TRIO_HP_PARAM_MODBUS_START_REGISTER 5200  // Directly after TRIO HP data (5000-5199)
+#define TRIO_HP_PARAM_MODBUS_MAX_REGISTERS  64
+#define TRIO_HP_PARAM_NO_STORAGE            0xFFFF
+#define TRIO_HP_PARAM_NO_REGISTER           0xFF
+#define TRIO_HP_PARAM_MAX_COUNT             48    // Upper bound for batch/profile buffers
+
+// === PARAMETER IDS ===
+// Command parameters use the TRIO HP command code as ID, configuration
+// parameters live in the 0x8xxx range.
+typedef enum {
+    TRIO_PARAM_ID_SYSTEM_CURRENT          = 0x1002,  // System current command
+    TRIO_PARAM_ID_SYSTEM_STATE            = 0x1110,  // System operational state
+    TRIO_PARAM_ID_REACTIVE_POWER          = 0x2108,  // Reactive power command
+    TRIO_PARAM_ID_WORK_MODE               = 0x2110,  // Work mode command
+    TRIO_PARAM_ID_REACTIVE_TYPE           = 0x2117,  // Reactive type command
+
+    TRIO_PARAM_ID_BROADCAST_INTERVAL      = 0x8001,
+    TRIO_PARAM_ID_MULTICAST_FAST_INTERVAL = 0x8002,
+    TRIO_PARAM_ID_MULTICAST_SLOW_INTERVAL = 0x8003,
+    TRIO_PARAM_ID_ON_DEMAND_TIMEOUT       = 0x8004,
+    TRIO_PARAM_ID_POLL_RESPONSE_TIMEOUT   = 0x8005,
+    TRIO_PARAM_ID_MAX_CONCURRENT_POLLS    = 0x8006,
+    TRIO_PARAM_ID_BUSY_BACKOFF_DELAY      = 0x8007,
+    TRIO_PARAM_ID_ERROR_RETRY_DELAY       = 0x8008,
+    TRIO_PARAM_ID_ADAPTIVE_SCALE_FACTOR   = 0x8009,
+    TRIO_PARAM_ID_MAX_RETRY_ATTEMPTS      = 0x800A,
+    TRIO_PARAM_ID_ADAPTIVE_POLLING        = 0x800B,
+    TRIO_PARAM_ID_PRIORITY_POLLING        = 0x800C,
+
+    TRIO_PARAM_ID_SYSTEM_ENABLED          = 0x8020,
+    TRIO_PARAM_ID_MAX_ACTIVE_MODULES      = 0x8021,
+    TRIO_PARAM_ID_HEARTBEAT_TIMEOUT       = 0x8022,
+    TRIO_PARAM_ID_COMMUNICATION_TIMEOUT   = 0x8023,
+    TRIO_PARAM_ID_MAX_RETRY_COUNT         = 0x8024,
+    TRIO_PARAM_ID_ERROR_RECOVERY          = 0x8025,
+    TRIO_PARAM_ID_DATA_HISTORY_SIZE       = 0x8026,
+    TRIO_PARAM_ID_MODBUS_UPDATE_INTERVAL  = 0x8027,
+    TRIO_PARAM_ID_DATA_BACKUP             = 0x8028,
+
+    TRIO_PARAM_ID_SYSTEM_VOLTAGE_MIN      = 0x8040,
+    TRIO_PARAM_ID_SYSTEM_VOLTAGE_MAX      = 0x8041,
+    TRIO_PARAM_ID_SYSTEM_CURRENT_MAX      = 0x8042,
+    TRIO_PARAM_ID_SYSTEM_POWER_MAX        = 0x8043,
+    TRIO_PARAM_ID_SYSTEM_TEMP_MAX         = 0x8044
+} TrioParamId_t;
+
+// === PARAMETER DESCRIPTOR ===
+typedef enum {
+    TRIO_PARAM_TYPE_BOOL = 0,
+    TRIO_PARAM_TYPE_U8,
+    TRIO_PARAM_TYPE_U16,
+    TRIO_PARAM_TYPE_U32,
+    TRIO_PARAM_TYPE_FLOAT
+} TrioParamType_t;
+
+typedef enum {
+    TRIO_PARAM_LOCK_NONE = 0,    // Locked only by full lock (level 2)
+    TRIO_PARAM_LOCK_POWER,       // power_parameters_locked
+    TRIO_PARAM_LOCK_MODE,        // mode_parameters_locked
+    TRIO_PARAM_LOCK_CONFIG,      // config_parameters_locked
+    TRIO_PARAM_LOCK_SAFETY       // safety_parameters_locked
+} TrioParamLockClass_t;
+
+typedef enum {
+    TRIO_PARAM_PERSIST_RUNTIME = 0,  // Runtime command, never stored
+    TRIO_PARAM_PERSIST_EEPROM,       // Site setting in TrioHPSystemConfig_t, marks config dirty
+    TRIO_PARAM_PERSIST_PROFILE       // Like EEPROM, and part of configuration profiles
+} TrioParamPersist_t;
+
+typedef struct {
+    uint16_t id;                     // TrioParamId_t
+    uint32_t nameHash;               // trioParamHash(name)
+    const char* name;                // Web form / export / lookup key
+    const char* unit;                // Display unit
+    uint16_t offset;                 // Offset in TrioHPSystemConfig_t or TRIO_HP_PARAM_NO_STORAGE
+    TrioParamType_t type;
+    float defaultValue;              // Factory default
+    float minValue;
+    float maxValue;
+    TrioParamLockClass_t lockClass;
+    TrioParamPersist_t persist;
+    uint8_t modbusOffset;            // Register = 5200 + offset, or TRIO_HP_PARAM_NO_REGISTER
+    float modbusScale;               // Register value = parameter * scale
+} TrioParamDescriptor_t;
+
+// Parameter/value pair for batch updates and profile diffs
+typedef struct {
+    uint16_t id;
+    float value;
+} TrioParamValue_t;
+
+// === COMPILE-TIME NAME HASH (FNV-1a) ===
+constexpr uint32_t trioParamHash(const char* str, uint32_t hash = 2166136261u) {
+    return *str ? trioParamHash(str + 1, (hash ^ (uint8_t)*str) * 16777619u) : hash;
+}
+
+// === REGISTRY FUNCTIONS ===
+bool initTrioHPParams();
+uint8_t getTrioParamCount();
+const TrioParamDescriptor_t* getTrioParamByIndex(uint8_t index);
+const TrioParamDescriptor_t* findTrioParamById(uint16_t id);
+const TrioParamDescriptor_t* findTrioParamByName(const char* name);
+const TrioParamDescriptor_t* findTrioParamByRegister(uint16_t address);
+
+// === GENERIC ACCESS ===
+bool getTrioParam(const TrioParamDescriptor_t* param, float* value);
+bool setTrioParam(const TrioParamDescriptor_t* param, float value);
+bool getTrioParamById(uint16_t id, float* value);
+bool setTrioParamById(uint16_t id, float value);
+bool setTrioParamByName(const char* name, float value);
+bool isTrioParamValueValid(const TrioParamDescriptor_t* param, float value);
+bool isTrioParamLocked(const TrioParamDescriptor_t* param);
+bool isTrioParamWritable(const TrioParamDescriptor_t* param);
+bool setTrioParams(const TrioParamValue_t* values, uint8_t count, bool markDirty);  // All or nothing
+void applyTrioParamDefaults(bool timingOnly);                                       // No lock checks
+bool isTrioTimingParam(const TrioParamDescriptor_t* param);
+
+// === MODBUS PARAMETER WINDOW ===
+bool isTrioParamRegisterRange(uint16_t startAddress, uint16_t count);
+bool readTrioParamRegister(uint16_t address, uint16_t* value);
+bool writeTrioParamRegister(uint16_t address, uint16_t value);
+bool writeTrioParamRegisters(uint16_t startAddress, uint16_t count, const uint16_t* values);  // All or nothing
+
+// === UTILITY FUNCTIONS ===
+const char* getTrioParamTypeName(TrioParamType_t type);
+const char* getTrioParamLockClassName(TrioParamLockClass_t lockClass);
+
+#endif // TRIO_HP_PARAMS_H
@@ -0,0 +1,403 @@
+// =====================================================================
+// === trio_hp_profiles.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: TRIO HP Configuration Profiles Implementation
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Sparse diff profiles in NVS with in-place switching
+//
+// 🎯 DEPENDENCIES:
+//    Internal: trio_hp_profiles.h, trio_hp_params.h, trio_hp_config.h
+//    External: Arduino.h, Preferences.h
+//
+// 📝 DESCRIPTION:
+//    Built-in profiles are constexpr diff tables; named slots are NVS blobs
+//    holding the same diff format. Only slot names are cached in RAM, the
+//    diff itself is read from NVS when a slot is loaded.
+//
+// 🔧 IMPLEMENTATION DETAILS:
+//    - Slot blob: name[16], count, count x {uint16 id, float value}
+//    - Switch = defaults overridden by diff, minus values already running
+//    - Batch applied through setTrioParams() without marking EEPROM dirty
+//    - Selector is written only when it changes
+//
+// ⚠️  KNOWN ISSUES:
+//    - None currently identified
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Built-in switch touches no flash except the 1-byte selector
+//    - Slot load: one NVS read of at most 17 + 6 * 48 bytes
+//
+// =====================================================================
+
+#include "trio_hp_profiles.h"
+#include "trio_hp_params.h"
+#include <Preferences.h>
+
+// === SLOT RECORD ===
+typedef struct __attribute__((packed)) {
+    uint16_t id;
+    float value;
+} TrioProfileEntry_t;
+
+typedef struct __attribute__((packed)) {
+    char name[TRIO_PROFILE_NAME_LENGTH];
+    uint8_t count;
+    TrioProfileEntry_t entries[TRIO_HP_PARAM_MAX_COUNT];
+} TrioProfileRecord_t;
+
+#define TRIO_PROFILE_RECORD_HEADER  (TRIO_PROFILE_NAME_LENGTH + 1)
+
+// === BUILT-IN PROFILE DIFFS (against registry factory defaults) ===
+static constexpr TrioParamValue_t PROFILE_HIGH_PERFORMANCE[] = {
+    { TRIO_PARAM_ID_BROADCAST_INTERVAL,      2000.0f },
+    { TRIO_PARAM_ID_MULTICAST_FAST_INTERVAL, 250.0f },
+    { TRIO_PARAM_ID_MULTICAST_SLOW_INTERVAL, 500.0f },
+    { TRIO_PARAM_ID_MAX_CONCURRENT_POLLS,    5.0f },
+    { TRIO_PARAM_ID_POLL_RESPONSE_TIMEOUT,   1000.0f },
+    { TRIO_PARAM_ID_MAX_ACTIVE_MODULES,      48.0f },
+    { TRIO_PARAM_ID_DATA_HISTORY_SIZE,       20.0f }
+};
+
+static constexpr TrioParamValue_t PROFILE_POWER_SAVE[] = {
+    { TRIO_PARAM_ID_BROADCAST_INTERVAL,      10000.0f },
+    { TRIO_PARAM_ID_MULTICAST_FAST_INTERVAL, 2000.0f },
+    { TRIO_PARAM_ID_MULTICAST_SLOW_INTERVAL, 5000.0f },
+    { TRIO_PARAM_ID_ADAPTIVE_POLLING,        0.0f },
+    { TRIO_PARAM_ID_MAX_CONCURRENT_POLLS,    1.0f },
+    { TRIO_PARAM_ID_POLL_RESPONSE_TIMEOUT,   3000.0f },
+    { TRIO_PARAM_ID_MAX_ACTIVE_MODULES,      8.0f },
+    { TRIO_PARAM_ID_DATA_HISTORY_SIZE,       5.0f }
+};
+
+static constexpr TrioParamValue_t PROFILE_DIAGNOSTIC[] = {
+    { TRIO_PARAM_ID_BROADCAST_INTERVAL,      1000.0f },
+    { TRIO_PARAM_ID_MULTICAST_FAST_INTERVAL, 100.0f },
+    { TRIO_PARAM_ID_MULTICAST_SLOW_INTERVAL, 200.0f },
+    { TRIO_PARAM_ID_ADAPTIVE_POLLING,        0.0f },
+    { TRIO_PARAM_ID_MAX_CONCURRENT_POLLS,    8.0f },
+    { TRIO_PARAM_ID_POLL_RESPONSE_TIMEOUT,   500.0f },
+    { TRIO_PARAM_ID_MAX_ACTIVE_MODULES,      48.0f },
+    { TRIO_PARAM_ID_DATA_HISTORY_SIZE,       50.0f },
+    { TRIO_PARAM_ID_DATA_BACKUP,             1.0f }
+};
+
+// === PRIVATE VARIABLES ===
+static char slotNames[TRIO_PROFILE_MAX_SLOTS][TRIO_PROFILE_NAME_LENGTH];  // "" = empty
+static TrioProfileStats_t profileStats;
+static bool profilesInitialized = false;
+
+// === PRIVATE HELPERS ===
+
+static void slotKey(uint8_t slot, char* key) {
+    key[0] = 'p';
+    key[1] = (char)('0' + slot);
+    key[2] = '\0';
+}
+
+static void writeSelector(uint8_t selector) {
+    if (selector == profileStats.activeSelector) return;
+
+    Preferences prefs;
+    if (prefs.begin(TRIO_PROFILE_NVS_NAMESPACE, false)) {
+        prefs.putUChar("active", selector);
+        prefs.end();
+    }
+    profileStats.activeSelector = selector;
+}
+
+static int8_t findSlot(const char* name) {
+    if (name == nullptr || name[0] == '\0') return -1;
+    for (uint8_t i = 0; i < TRIO_PROFILE_MAX_SLOTS; i++) {
+        if (slotNames[i][0] != '\0' && strncmp(slotNames[i], name, TRIO_PROFILE_NAME_LENGTH) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool readSlot(uint8_t slot, TrioProfileRecord_t* record) {
+    char key[3];
+    slotKey(slot, key);
+
+    Preferences prefs;
+    if (!prefs.begin(TRIO_PROFILE_NVS_NAMESPACE, true)) return false;
+    size_t length = prefs.getBytes(key, record, sizeof(TrioProfileRecord_t));
+    prefs.end();
+
+    if (length < TRIO_PROFILE_RECORD_HEADER || record->count > TRIO_HP_PARAM_MAX_COUNT ||
+        length != TRIO_PROFILE_RECORD_HEADER + record->count * sizeof(TrioProfileEntry_t)) {
+        return false;
+    }
+    record->name[TRIO_PROFILE_NAME_LENGTH - 1] = '\0';
+    return true;
+}
+
+// Bring every profile parameter to default-or-diff value, writing only what differs
+static bool applyProfileDiff(const TrioParamValue_t* diff, uint8_t diffCount,
+                             TrioConfigProfile_t profile, uint8_t selector) {
+    unsigned long start = micros();
+
+    TrioParamValue_t batch[TRIO_HP_PARAM_MAX_COUNT];
+    uint8_t batchCount = 0;
+
+    for (uint8_t i = 0; i < getTrioParamCount(); i++) {
+        const TrioParamDescriptor_t* param = getTrioParamByIndex(i);
+        if (param->persist != TRIO_PARAM_PERSIST_PROFILE) continue;
+
+        float target = param->defaultValue;
+        for (uint8_t d = 0; d < diffCount; d++) {
+            if (diff[d].id == param->id) {
+                target = diff[d].value;
+                break;
+            }
+        }
+
+        float current;
+        if (getTrioParam(param, &current) && current != target) {
+            batch[batchCount].id = param->id;
+            batch[batchCount].value = target;
+            batchCount++;
+        }
+    }
+
+    bool success = batchCount == 0 || setTrioParams(batch, batchCount, false);
+    uint32_t elapsed = (uint32_t)(micros() - start);
+
+    if (!success) {
+        profileStats.failedSwitches++;
+        Serial.printf("[TRIO HP PROFILES] Switch to %s rejected\n", getConfigProfileName(profile));
+        return false;
+    }
+
+    trioHPConfig.activeProfile = profile;
+    profileStats.switchCount++;
+    profileStats.lastSwitchUs = elapsed;
+    profileStats.lastChangedParams = batchCount;
+    if (elapsed > profileStats.maxSwitchUs) profileStats.maxSwitchUs = elapsed;
+
+    writeSelector(selector);
+
+    Serial.printf("[TRIO HP PROFILES] Switched to %s: %d params in %lu us\n",
+                  getConfigProfileName(profile), batchCount, (unsigned long)elapsed);
+    return true;
+}
+
+// === PROFILE FUNCTIONS ===
+
+bool initTrioHPProfiles() {
+    if (profilesInitialized) return true;
+
+    memset(slotNames, 0, sizeof(slotNames));
+    memset(&profileStats, 0, sizeof(profileStats));
+    profileStats.activeSelector = TRIO_PROFILE_SELECTOR_NONE;
+
+    uint8_t savedSelector = TRIO_PROFILE_SELECTOR_NONE;
+    Preferences prefs;
+    if (prefs.begin(TRIO_PROFILE_NVS_NAMESPACE, true)) {
+        savedSelector = prefs.getUChar("active", TRIO_PROFILE_SELECTOR_NONE);
+        prefs.end();
+    }
+
+    TrioProfileRecord_t record;
+    for (uint8_t i = 0; i < TRIO_PROFILE_MAX_SLOTS; i++) {
+        if (readSlot(i, &record)) {
+            strncpy(slotNames[i], record.name, TRIO_PROFILE_NAME_LENGTH);
+        }
+    }
+    profileStats.activeSelector = savedSelector;
+    profilesInitialized = true;
+
+    Serial.printf("[TRIO HP PROFILES] %d named slots, active selector 0x%02X\n",
+                  getTrioProfileSlotCount(), savedSelector);
+
+    // Re-apply the selected profile on top of the EEPROM configuration
+    if (savedSelector <= TRIO_CONFIG_PROFILE_DIAGNOSTIC) {
+        return switchTrioProfile((TrioConfigProfile_t)savedSelector);
+    }
+    if (savedSelector >= TRIO_PROFILE_SELECTOR_SLOT &&
+        savedSelector < TRIO_PROFILE_SELECTOR_SLOT + TRIO_PROFILE_MAX_SLOTS) {
+        const char* name = slotNames[savedSelector - TRIO_PROFILE_SELECTOR_SLOT];
+        if (name[0] != '\0') return loadTrioProfileSlot(name);
+        writeSelector(TRIO_PROFILE_SELECTOR_NONE);
+    }
+    return true;
+}
+
+bool switchTrioProfile(TrioConfigProfile_t profile) {
+    switch (profile) {
+        case TRIO_CONFIG_PROFILE_DEFAULT:
+            return applyProfileDiff(nullptr, 0, profile, profile);
+        case TRIO_CONFIG_PROFILE_HIGH_PERFORMANCE:
+            return applyProfileDiff(PROFILE_HIGH_PERFORMANCE,
+                                    sizeof(PROFILE_HIGH_PERFORMANCE) / sizeof(PROFILE_HIGH_PERFORMANCE[0]),
+                                    profile, profile);
+        case TRIO_CONFIG_PROFILE_POWER_SAVE:
+            return applyProfileDiff(PROFILE_POWER_SAVE,
+                                    sizeof(PROFILE_POWER_SAVE) / sizeof(PROFILE_POWER_SAVE[0]),
+                                    profile, profile);
+        case TRIO_CONFIG_PROFILE_DIAGNOSTIC:
+            return applyProfileDiff(PROFILE_DIAGNOSTIC,
+                                    sizeof(PROFILE_DIAGNOSTIC) / sizeof(PROFILE_DIAGNOSTIC[0]),
+                                    profile, profile);
+        default:
+            return false;
+    }
+}
+
+bool saveTrioProfileSlot(const char* name) {
+    if (name == nullptr || name[0] == '\0' || strlen(name) >= TRIO_PROFILE_NAME_LENGTH) {
+        Serial.println("[TRIO HP PROFILES] Invalid profile name");
+        return false;
+    }
+
+    int8_t slot = findSlot(name);
+    if (slot < 0) {
+        for (uint8_t i = 0; i < TRIO_PROFILE_MAX_SLOTS; i++) {
+            if (slotNames[i][0] == '\0') {
+                slot = i;
+                break;
+            }
+        }
+    }
+    if (slot < 0) {
+        Serial.println("[TRIO HP PROFILES] No free profile slot");
+        return false;
+    }
+
+    // Store only parameters that differ from factory defaults
+    TrioProfileRecord_t record;
+    memset(&record, 0, sizeof(record));
+    strncpy(record.name, name, TRIO_PROFILE_NAME_LENGTH - 1);
+    for (uint8_t i = 0; i < getTrioParamCount(); i++) {
+        const TrioParamDescriptor_t* param = getTrioParamByIndex(i);
+        float current;
+        if (param->persist != TRIO_PARAM_PERSIST_PROFILE || !getTrioParam(param, &current)) continue;
+        if (current != param->defaultValue) {
+            record.entries[record.count].id = param->id;
+            record.entries[record.count].value = current;
+            record.count++;
+        }
+    }
+
+    char key[3];
+    slotKey(slot, key);
+    size_t length = TRIO_PROFILE_RECORD_HEADER + record.count * sizeof(TrioProfileEntry_t);
+
+    Preferences prefs;
+    if (!prefs.begin(TRIO_PROFILE_NVS_NAMESPACE, false)) return false;
+    bool written = prefs.putBytes(key, &record, length) == length;
+    prefs.end();
+
+    if (!written) {
+        Serial.printf("[TRIO HP PROFILES] Failed to write slot %d\n", slot);
+        return false;
+    }
+
+    strncpy(slotNames[slot], record.name, TRIO_PROFILE_NAME_LENGTH);
+    trioHPConfig.activeProfile = TRIO_CONFIG_PROFILE_CUSTOM;
+    writeSelector(TRIO_PROFILE_SELECTOR_SLOT + slot);
+
+    Serial.printf("[TRIO HP PROFILES] Saved '%s' to slot %d (%d params, %d bytes)\n",
+                  record.name, slot, record.count, (int)length);
+    return true;
+}
+
+bool loadTrioProfileSlot(const char* name) {
+    int8_t slot = findSlot(name);
+    if (slot < 0) {
+        Serial.printf("[TRIO HP PROFILES] Profile '%s' not found\n", name ? name : "");
+        return false;
+    }
+
+    TrioProfileRecord_t record;
+    if (!readSlot(slot, &record)) {
+        Serial.printf("[TRIO HP PROFILES] Slot %d is corrupt\n", slot);
+        return false;
+    }
+
+    TrioParamValue_t diff[TRIO_HP_PARAM_MAX_COUNT];
+    for (uint8_t i = 0; i < record.count; i++) {
+        diff[i].id = record.entries[i].id;
+        diff[i].value = record.entries[i].value;
+    }
+    return applyProfileDiff(diff, record.count, TRIO_CONFIG_PROFILE_CUSTOM, TRIO_PROFILE_SELECTOR_SLOT + slot);
+}
+
+bool deleteTrioProfileSlot(const char* name) {
+    int8_t slot = findSlot(name);
+    if (slot < 0) return false;
+
+    char key[3];
+    slotKey(slot, key);
+
+    Preferences prefs;
+    if (!prefs.begin(TRIO_PROFILE_NVS_NAMESPACE, false)) return false;
+    prefs.remove(key);
+    prefs.end();
+
+    slotNames[slot][0] = '\0';
+    if (profileStats.activeSelector == TRIO_PROFILE_SELECTOR_SLOT + slot) {
+        writeSelector(TRIO_PROFILE_SELECTOR_NONE);
+    }
+    return true;
+}
+
+void noteTrioProfileParamEdited() {
+    trioHPConfig.activeProfile = TRIO_CONFIG_PROFILE_CUSTOM;
+    if (profilesInitialized) {
+        writeSelector(TRIO_PROFILE_SELECTOR_NONE);  // Keep edited values from EEPROM at boot
+    }
+}
+
+// === PROFILE ACCESS ===
+
+uint8_t getTrioProfileSlotCount() {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < TRIO_PROFILE_MAX_SLOTS; i++) {
+        if (slotNames[i][0] != '\0') count++;
+    }
+    return count;
+}
+
+const char* getTrioProfileSlotName(uint8_t slot) {
+    if (slot >= TRIO_PROFILE_MAX_SLOTS || slotNames[slot][0] == '\0') return nullptr;
+    return slotNames[slot];
+}
+
+const TrioProfileStats_t* getTrioProfileStats() {
+    return &profileStats;
+}
+
+void printTrioProfileStatus() {
+    Serial.printf("\n=== TRIO HP Profiles ===\n");
+    Serial.printf("Active: %s (selector 0x%02X)\n",
+                  getConfigProfileName(trioHPConfig.activeProfile), profileStats.activeSelector);
+    Serial.printf("Switches: %lu (failed %lu)\n",
+                  (unsigned long)profileStats.switchCount, (unsigned long)profileStats.failedSwitches);
+    Serial.printf("Last switch: %lu us, %d params changed (max %lu us)\n",
+                  (unsigned long)profileStats.lastSwitchUs, profileStats.lastChangedParams,
+                  (unsigned long)profileStats.maxSwitchUs);
+    for (uint8_t i = 0; i < TRIO_PROFILE_MAX_SLOTS; i++) {
+        if (slotNames[i][0] != '\0') {
+            Serial.printf("  Slot %d: %s\n", i, slotNames[i]);
+        }
+    }
+}
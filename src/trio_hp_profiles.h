@@ -0,0 +1,92 @@
+// =====================================================================
+// === trio_hp_profiles.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: TRIO HP Configuration Profiles
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Sparse diff profiles in NVS with in-place switching
+//
+// 🎯 DEPENDENCIES:
+//    Internal: trio_hp_params.h (parameter table, factory defaults, batch set)
+//    External: Arduino.h, Preferences.h (NVS)
+//
+// 📝 DESCRIPTION:
+//    A profile is the set of profile-class parameters from the registry
+//    (timing, module count, history, data backup). Built-in profiles and
+//    named user slots are stored only as the parameters that differ from
+//    the factory defaults. Switching computes the target value of every
+//    profile parameter, applies just the ones that differ from the running
+//    configuration as one validated batch, and does not rewrite the EEPROM
+//    configuration. The active profile selector is kept in NVS and
+//    re-applied at boot.
+//
+// 🔧 CONFIGURATION:
+//    - NVS namespace: "trio_prof", slot keys "p0".."p7", selector key "active"
+//    - Named slots: 8, names up to 15 characters
+//    - Slot record: name + count + 6 bytes per differing parameter
+//
+// ⚠️  KNOWN ISSUES:
+//    - None currently identified
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Switch: O(profile params) table walk plus one batch set, no flash write
+//      of the main configuration; latency measured with micros()
+//    - Memory: ~140 bytes RAM for the slot directory
+//
+// =====================================================================
+
+#ifndef TRIO_HP_PROFILES_H
+#define TRIO_HP_PROFILES_H
+
+#include <Arduino.h>
+#include "trio_hp_config.h"
+
+// === PROFILE CONSTANTS ===
+#define TRIO_PROFILE_MAX_SLOTS        8
+#define TRIO_PROFILE_NAME_LENGTH      16     // Including terminator
+#define TRIO_PROFILE_NVS_NAMESPACE    "trio_prof"
+#define TRIO_PROFILE_SELECTOR_NONE    0xFF   // Running values are custom / from EEPROM
+#define TRIO_PROFILE_SELECTOR_SLOT    0x10   // Selector 0x10 + n = named slot n
+
+// === SWITCH STATISTICS ===
+typedef struct {
+    uint32_t switchCount;             // Successful switches since boot
+    uint32_t failedSwitches;          // Rejected by lock or validation
+    uint32_t lastSwitchUs;            // Duration of last switch [us]
+    uint32_t maxSwitchUs;             // Slowest switch since boot [us]
+    uint8_t lastChangedParams;        // Parameters written by last switch
+    uint8_t activeSelector;           // Built-in profile, 0x10 + slot, or NONE
+} TrioProfileStats_t;
+
+// === PROFILE FUNCTIONS ===
+bool initTrioHPProfiles();
+bool switchTrioProfile(TrioConfigProfile_t profile);
+bool saveTrioProfileSlot(const char* name);
+bool loadTrioProfileSlot(const char* name);
+bool deleteTrioProfileSlot(const char* name);
+void noteTrioProfileParamEdited();    // Called by the registry on manual edits
+
+// === PROFILE ACCESS ===
+uint8_t getTrioProfileSlotCount();
+const char* getTrioProfileSlotName(uint8_t slot);   // nullptr if slot is empty
+const TrioProfileStats_t* getTrioProfileStats();
+void printTrioProfileStatus();
+
+#endif // TRIO_HP_PROFILES_H
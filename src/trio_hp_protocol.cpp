@@ -10,13 +10,14 @@
 //
 // 📋 MODULE INFO:
 //    Module: TRIO HP CAN Protocol Implementation
-//    Version: v1.0.0
+//    Version: v1.1.0
 //    Created: 28.08.2025 (Warsaw Time)
-//    Last Modified: 28.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
 //    v1.0.0 - 28.08.2025 - Initial TRIO HP protocol implementation
+//    v1.1.0 - 18.10.2026 - trioHPBuildReadFrame() for 0x23 read requests
 //
 // 🎯 DEPENDENCIES:
 //    Internal: trio_hp_protocol.h, config.h
@@ -218,6 +219,21 @@ bool trioHPBuildBroadcastFrame(uint16_t command, uint32_t data, TrioHPCanFrame_t
     return trioHPBuildCommandFrame(TRIO_HP_ADDR_BROADCAST, command, data, frame);
 }
 
+bool trioHPBuildReadFrame(uint8_t targetAddr, uint16_t command, TrioHPCanFrame_t* frame) {
+    if (frame == nullptr) return false;
+    
+    // Read request: command no. 0x23 in the CAN ID, command code echoed in the response
+    frame->canId = trioHPEncodeCanId(TRIO_HP_ERROR_NORMAL, TRIO_HP_DEVICE_SINGLE_MODULE,
+                                     TRIO_HP_CMD_NO_READ, targetAddr, TRIO_HP_ADDR_CONTROLLER);
+    
+    frame->length = TRIO_HP_CAN_FRAME_LENGTH;
+    memset(frame->data, 0, sizeof(frame->data));
+    frame->data[0] = (command >> 8) & 0xFF;
+    frame->data[1] = command & 0xFF;
+    
+    return true;
+}
+
 // === FRAME PARSING FUNCTIONS ===
 
 bool trioHPParseResponseFrame(const TrioHPCanFrame_t* frame, TrioHPCommand_t* command) {
@@ -10,13 +10,14 @@
 //
 // 📋 MODULE INFO:
 //    Module: TRIO HP CAN Protocol Handler
-//    Version: v1.0.0
+//    Version: v1.1.0
 //    Created: 28.08.2025 (Warsaw Time)
-//    Last Modified: 28.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
 //    v1.0.0 - 28.08.2025 - Initial TRIO HP protocol implementation
+//    v1.1.0 - 18.10.2026 - Read request frames (command no. 0x23)
 //
 // 🎯 DEPENDENCIES:
 //    Internal: config.h
@@ -81,6 +82,9 @@
 #define TRIO_HP_ERROR_DATA_INVALID 0x03
 #define TRIO_HP_ERROR_START_PROCESSING 0x07
 
+// === COMMAND NUMBERS (CAN ID) ===
+#define TRIO_HP_CMD_NO_READ 0x23            // Read data (protocol doc section 3)
+
 // === DEVICE NUMBERS ===
 #define TRIO_HP_DEVICE_SINGLE_MODULE 0x0A
 #define TRIO_HP_DEVICE_MODULE_GROUP 0x0B
@@ -92,6 +96,7 @@
 
 // === COMMAND DEFINITIONS - MODULE DC (0x11 series) ===
 #define TRIO_HP_CMD_MODULE_ON_OFF 0x1110
+#define TRIO_HP_CMD_MODULE_STATUS 0x1110    // Read (0x23): TEMP ST2 ST1 ST0 in data[4..7]
 #define TRIO_HP_CMD_MODULE_LED_BLINK 0x1120
 #define TRIO_HP_CMD_MODULE_SLEEP 0x1121
 #define TRIO_HP_CMD_MODULE_WALKIN 0x1122
@@ -188,6 +193,7 @@ bool trioHPBuildControlFrame(uint8_t targetAddr, uint16_t command, uint8_t contr
 bool trioHPBuildFloatFrame(uint8_t targetAddr, uint16_t command, float floatValue, 
                            TrioHPCanFrame_t* frame);
 bool trioHPBuildBroadcastFrame(uint16_t command, uint32_t data, TrioHPCanFrame_t* frame);
+bool trioHPBuildReadFrame(uint8_t targetAddr, uint16_t command, TrioHPCanFrame_t* frame);
 
 // === FRAME PARSING FUNCTIONS ===
 bool trioHPParseResponseFrame(const TrioHPCanFrame_t* frame, TrioHPCommand_t* command);
@@ -0,0 +1,674 @@
+// =====================================================================
+// === trio_hp_sequencer.cpp - TRIO HP Startup/Shutdown Sequencer ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: TRIO HP Startup/Shutdown Sequencer Implementation
+//    Version: v1.0.2
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.2 - 18.10.2026 - STATE_READ sends a 0x23 status read (was a 0x1110 ON/OFF write
+//                          with payload 0x00) and waits for the correlated read response
+//    v1.0.1 - 18.10.2026 - Join window closes on a stable registered set; step never drops
+//                          back to heartbeat detection; ticked every loop pass from main
+//    v1.0.0 - 18.10.2026 - Concurrent per-module step machines with fleet barriers
+//                          (replaces single global step machine from trio_hp_config.cpp)
+//
+// 🎯 DEPENDENCIES:
+//    Internal: trio_hp_sequencer.h, trio_hp_config.h, trio_hp_manager.h,
+//              trio_hp_limits.h, trio_hp_controllers.h, bms_data.h
+//    External: Arduino.h
+//
+// 📝 DESCRIPTION:
+//    Startup: steps 1-5 and 10 are fleet steps, steps 4 and 6-9 run per module.
+//    Fleet step 4 collects registered modules, step 5 broadcasts settings once,
+//    then every module walks STATE_READ -> MULTICAST_SETTINGS ->
+//    CALCULATE_CURRENT -> POWER_COMMAND on its own response ACKs. Step 10
+//    (operational ON broadcast) is the only barrier after that: it waits until
+//    every module is READY or excluded and the heartbeat join window is closed.
+//    The window closes once no module was discovered for TRIO_SEQ_JOIN_SETTLE_MS
+//    and none is waiting for a heartbeat (at the latest after 5 s).
+//    trioHPConfig.startup.current_step reports the slowest module's step, never
+//    below step 6 once the module phase has started.
+//
+//    Shutdown: zero-current commands go to all modules at once, operational
+//    OFF is broadcast when all have ACKed or been excluded (or on timeout -
+//    shutdown never aborts).
+//
+// ⚠️  KNOWN ISSUES:
+//    - None currently identified
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: PASS (test/test_trio_sequencer host simulation)
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - No blocking calls, one O(n) pass per loop iteration while active
+//
+// =====================================================================
+
+#include "trio_hp_sequencer.h"
+#include "trio_hp_config.h"
+#include "trio_hp_manager.h"
+#include "trio_hp_protocol.h"
+#include "trio_hp_limits.h"
+#include "trio_hp_controllers.h"
+#include "../include/bms_data.h"
+
+// === PRIVATE VARIABLES ===
+static TrioModuleSequence_t moduleSeq[TRIO_HP_MAX_MODULES];
+static uint8_t moduleSeqCount = 0;
+static TrioSequencerStats_t seqStats;
+static unsigned long modulePhaseStartTime = 0;
+static bool shutdownPowerTargetZeroed = false;
+
+// === PER-MODULE HELPERS ===
+
+static TrioModuleSequence_t* findModuleSequence(uint8_t moduleId) {
+    for (uint8_t i = 0; i < moduleSeqCount; i++) {
+        if (moduleSeq[i].moduleId == moduleId) return &moduleSeq[i];
+    }
+    return nullptr;
+}
+
+static void resetModuleSequences() {
+    memset(moduleSeq, 0, sizeof(moduleSeq));
+    moduleSeqCount = 0;
+    seqStats.participatingModules = 0;
+    seqStats.readyModules = 0;
+    seqStats.failedModules = 0;
+    seqStats.commandRetries = 0;
+}
+
+static TrioModuleSequence_t* addModuleSequence(uint8_t moduleId) {
+    if (findModuleSequence(moduleId) != nullptr) return nullptr;
+    if (moduleSeqCount >= TRIO_HP_MAX_MODULES || moduleSeqCount >= trioHPConfig.maxActiveModules) return nullptr;
+
+    TrioModuleSequence_t* seq = &moduleSeq[moduleSeqCount++];
+    memset(seq, 0, sizeof(TrioModuleSequence_t));
+    seq->moduleId = moduleId;
+    seq->state = TRIO_MODULE_SEQ_IDLE;
+    seqStats.participatingModules = moduleSeqCount;
+    return seq;
+}
+
+// Add registered modules not yet in the sequence, returns number added
+static uint8_t collectRegisteredModules(bool onlineOnly) {
+    uint8_t added = 0;
+    for (uint8_t i = 0; i < TRIO_HP_MAX_MODULES; i++) {
+        const TrioModuleInfo_t* info = &trioModules[i];
+        if (info->moduleId == TRIO_HP_INVALID_MODULE_ID) continue;
+        if (info->state == TRIO_MODULE_STATE_OFFLINE) continue;
+        if (onlineOnly && !info->isOnline) continue;
+
+        TrioModuleSequence_t* seq = addModuleSequence(info->moduleId);
+        if (seq != nullptr) {
+            seq->state = TRIO_MODULE_SEQ_WAIT_HEARTBEAT;
+            added++;
+        }
+    }
+    return added;
+}
+
+static TrioWorkMode_t moduleStartupWorkMode(uint8_t moduleId) {
+    uint8_t slotIndex = findModuleSlot(moduleId);
+    if (slotIndex != TRIO_HP_INVALID_MODULE_ID && trioModules[slotIndex].workMode != TRIO_WORK_MODE_UNKNOWN) {
+        return trioModules[slotIndex].workMode;
+    }
+
+    const TrioHPModuleConfig_t* config = getModuleConfig(moduleId);
+    if (config != nullptr && config->isConfigured && config->defaultWorkMode != TRIO_WORK_MODE_UNKNOWN) {
+        return config->defaultWorkMode;
+    }
+    return TRIO_WORK_MODE_AC_DC;
+}
+
+// Registered set is stable: nothing discovered for a settle period, nobody waiting for a heartbeat
+static bool isModuleRegistrySettled(unsigned long now) {
+    for (uint8_t i = 0; i < TRIO_HP_MAX_MODULES; i++) {
+        const TrioModuleInfo_t* info = &trioModules[i];
+        if (info->moduleId == TRIO_HP_INVALID_MODULE_ID) continue;
+        if (now - info->discoveryTime < TRIO_SEQ_JOIN_SETTLE_MS) return false;
+    }
+    for (uint8_t i = 0; i < moduleSeqCount; i++) {
+        if (moduleSeq[i].state == TRIO_MODULE_SEQ_WAIT_HEARTBEAT) return false;
+    }
+    return true;
+}
+
+// Equal share of the active power controller's DC current over non-excluded modules
+static float calculateModuleCurrentShare() {
+    uint8_t sharing = seqStats.participatingModules - seqStats.failedModules;
+    const TrioActivePowerController_t* apc = getActivePowerControllerStatus();
+    if (apc == nullptr || sharing == 0) return 0.0f;
+
+    float share = apc->calculated_current / sharing;
+    float maxShare = trioHPConfig.systemCurrentMax / sharing;
+    if (share > maxShare) share = maxShare;
+    if (share < -maxShare) share = -maxShare;
+    return share;
+}
+
+static bool sendModuleStepCommand(TrioModuleSequence_t* seq) {
+    uint16_t command = 0;
+    switch (seq->state) {
+        case TRIO_MODULE_SEQ_STATE_READ:         command = TRIO_HP_CMD_MODULE_STATUS; break;
+        case TRIO_MODULE_SEQ_MULTICAST_SETTINGS: command = TRIO_HP_CMD_AC_WORK_MODE; break;
+        case TRIO_MODULE_SEQ_POWER_COMMAND:      command = TRIO_HP_CMD_SYSTEM_DC_CURRENT; break;
+        case TRIO_MODULE_SEQ_CURRENT_ZERO:       command = TRIO_HP_CMD_SYSTEM_DC_CURRENT; break;
+        default: return true;  // Step has no command
+    }
+
+    // Arm correlation before sending so an immediate response is not missed
+    if (seq->state == TRIO_MODULE_SEQ_STATE_READ) {
+        expectModuleReadResponse(seq->moduleId, command);
+    } else {
+        expectModuleResponse(seq->moduleId, command);
+    }
+    seq->awaitedCommand = command;
+    seq->stepStartTime = millis();
+
+    switch (seq->state) {
+        case TRIO_MODULE_SEQ_STATE_READ:
+            return sendModuleReadRequest(seq->moduleId, command);
+        case TRIO_MODULE_SEQ_MULTICAST_SETTINGS:
+            return setModuleWorkMode(seq->moduleId, moduleStartupWorkMode(seq->moduleId));
+        case TRIO_MODULE_SEQ_POWER_COMMAND:
+            return sendFloatCommand(seq->moduleId, command, seq->currentSetpoint);
+        case TRIO_MODULE_SEQ_CURRENT_ZERO:
+            return sendFloatCommand(seq->moduleId, command, 0.0f);
+        default:
+            return true;
+    }
+}
+
+static void enterModuleStep(TrioModuleSequence_t* seq, TrioModuleSeqState_t state) {
+    seq->state = state;
+    seq->retryCount = 0;
+    seq->awaitedCommand = 0;
+    // A failed send is handled like a missing response (timeout -> retry)
+    sendModuleStepCommand(seq);
+}
+
+static void failModule(TrioModuleSequence_t* seq, const char* reason) {
+    Serial.printf("[TRIO HP SEQ] Module %d excluded in %s: %s\n",
+                  seq->moduleId, getModuleSeqStateName(seq->state), reason);
+    seq->state = TRIO_MODULE_SEQ_FAILED;
+    seq->awaitedCommand = 0;
+}
+
+// Move to nextState on ACK, resend on NACK/timeout, exclude after retries
+static void advanceOnResponse(TrioModuleSequence_t* seq, unsigned long now, TrioModuleSeqState_t nextState) {
+    TrioResponseStatus_t status = getModuleResponseStatus(seq->moduleId, seq->awaitedCommand);
+
+    if (status == TRIO_RESPONSE_ACK) {
+        enterModuleStep(seq, nextState);
+        return;
+    }
+
+    if (status == TRIO_RESPONSE_NACK || now - seq->stepStartTime > TRIO_SEQ_RESPONSE_TIMEOUT_MS) {
+        if (seq->retryCount >= TRIO_SEQ_MAX_RETRIES) {
+            failModule(seq, status == TRIO_RESPONSE_NACK ? "rejected" : "no response");
+            return;
+        }
+        seq->retryCount++;
+        seqStats.commandRetries++;
+        sendModuleStepCommand(seq);
+    }
+}
+
+static void tickModuleSequence(TrioModuleSequence_t* seq, unsigned long now) {
+    switch (seq->state) {
+        case TRIO_MODULE_SEQ_WAIT_HEARTBEAT:
+            if (isModuleOnline(seq->moduleId)) {
+                enterModuleStep(seq, TRIO_MODULE_SEQ_STATE_READ);
+            }
+            break;
+        case TRIO_MODULE_SEQ_STATE_READ:
+            advanceOnResponse(seq, now, TRIO_MODULE_SEQ_MULTICAST_SETTINGS);
+            break;
+        case TRIO_MODULE_SEQ_MULTICAST_SETTINGS:
+            advanceOnResponse(seq, now, TRIO_MODULE_SEQ_CALCULATE_CURRENT);
+            break;
+        case TRIO_MODULE_SEQ_CALCULATE_CURRENT:
+            seq->currentSetpoint = calculateModuleCurrentShare();
+            enterModuleStep(seq, TRIO_MODULE_SEQ_POWER_COMMAND);
+            break;
+        case TRIO_MODULE_SEQ_POWER_COMMAND:
+            advanceOnResponse(seq, now, TRIO_MODULE_SEQ_READY);
+            break;
+        case TRIO_MODULE_SEQ_CURRENT_ZERO:
+            advanceOnResponse(seq, now, TRIO_MODULE_SEQ_STOPPED);
+            break;
+        default:
+            break;
+    }
+}
+
+static TrioStartupStep_t moduleSeqToStartupStep(TrioModuleSeqState_t state) {
+    switch (state) {
+        case TRIO_MODULE_SEQ_WAIT_HEARTBEAT:     return TRIO_STARTUP_STEP_HEARTBEAT_DETECTION;
+        case TRIO_MODULE_SEQ_STATE_READ:         return TRIO_STARTUP_STEP_MODULE_STATE_READ;
+        case TRIO_MODULE_SEQ_MULTICAST_SETTINGS: return TRIO_STARTUP_STEP_MULTICAST_SETTINGS;
+        case TRIO_MODULE_SEQ_CALCULATE_CURRENT:  return TRIO_STARTUP_STEP_CALCULATE_CURRENT;
+        default:                                 return TRIO_STARTUP_STEP_SEND_POWER_COMMANDS;
+    }
+}
+
+// Tick all module machines, refresh counters, return true when none is still in progress
+static bool tickAllModules(unsigned long now, TrioModuleSeqState_t settledState,
+                           TrioStartupStep_t* slowestStep) {
+    bool settled = true;
+    seqStats.readyModules = 0;
+    seqStats.failedModules = 0;
+    if (slowestStep != nullptr) *slowestStep = TRIO_STARTUP_STEP_SEND_POWER_COMMANDS;
+
+    for (uint8_t i = 0; i < moduleSeqCount; i++) {
+        TrioModuleSequence_t* seq = &moduleSeq[i];
+        tickModuleSequence(seq, now);
+
+        if (seq->state == settledState) {
+            seqStats.readyModules++;
+        } else if (seq->state == TRIO_MODULE_SEQ_FAILED) {
+            seqStats.failedModules++;
+        } else {
+            settled = false;
+            if (slowestStep != nullptr) {
+                TrioStartupStep_t step = moduleSeqToStartupStep(seq->state);
+                if (step < *slowestStep) *slowestStep = step;
+            }
+        }
+    }
+    return settled;
+}
+
+static void failUnsettledModules(TrioModuleSeqState_t settledState, const char* reason) {
+    for (uint8_t i = 0; i < moduleSeqCount; i++) {
+        if (moduleSeq[i].state != settledState && moduleSeq[i].state != TRIO_MODULE_SEQ_FAILED) {
+            failModule(&moduleSeq[i], reason);
+            seqStats.failedModules++;
+        }
+    }
+}
+
+// === FLEET STEP HELPERS ===
+
+static void advanceStartupStep(TrioStartupStep_t next) {
+    trioHPConfig.startup.current_step = next;
+    trioHPConfig.startup.step_start_time = millis();
+    trioHPConfig.startup.step_retry_count = 0;
+    memset(trioHPConfig.startup.step_error_message, 0, sizeof(trioHPConfig.startup.step_error_message));
+}
+
+static void failStartup(const char* reason) {
+    snprintf(trioHPConfig.startup.step_error_message, 64, "%s", reason);
+    Serial.printf("[TRIO HP STARTUP] ERROR: %s\n", trioHPConfig.startup.step_error_message);
+    trioHPConfig.startup.startup_in_progress = false;
+}
+
+// Fleet step timeout with 3 retries (interlocks, broadcasts); false when sequence aborted
+static bool checkFleetStepTimeout(unsigned long now) {
+    if (now - trioHPConfig.startup.step_start_time <= trioHPConfig.startup.step_timeout) return true;
+
+    TrioStartupStep_t step = trioHPConfig.startup.current_step;
+    trioHPConfig.startup.step_retry_count++;
+    if (trioHPConfig.startup.step_retry_count >= 3) {
+        char reason[64];
+        snprintf(reason, sizeof(reason), "Step %s timeout after 3 retries", getStartupStepName(step));
+        failStartup(reason);
+        return false;
+    }
+    Serial.printf("[TRIO HP STARTUP] Retry %d for step %s\n",
+                  trioHPConfig.startup.step_retry_count, getStartupStepName(step));
+    trioHPConfig.startup.step_start_time = now;
+    return true;
+}
+
+// === STARTUP SEQUENCE FUNCTIONS ===
+
+bool startTrioHPStartupSequence() {
+    if (trioHPConfig.startup.startup_in_progress) {
+        Serial.println("[TRIO HP STARTUP] ERROR: Startup already in progress");
+        return false;
+    }
+    if (trioHPConfig.shutdown.shutdown_in_progress) {
+        Serial.println("[TRIO HP STARTUP] ERROR: Shutdown in progress");
+        return false;
+    }
+
+    Serial.println("[TRIO HP STARTUP] Starting 10-step startup sequence");
+
+    resetModuleSequences();
+    seqStats.sequenceStartTime = millis();
+
+    trioHPConfig.startup.current_step = TRIO_STARTUP_STEP_ESTOP_CHECK;
+    trioHPConfig.startup.startup_in_progress = true;
+    trioHPConfig.startup.startup_successful = false;
+    trioHPConfig.startup.step_start_time = millis();
+    trioHPConfig.startup.step_timeout = 5000; // 5s default timeout
+    trioHPConfig.startup.step_retry_count = 0;
+    memset(trioHPConfig.startup.step_error_message, 0, sizeof(trioHPConfig.startup.step_error_message));
+
+    return true;
+}
+
+bool processStartupSequenceStep() {
+    if (!trioHPConfig.startup.startup_in_progress) return true;
+
+    unsigned long now = millis();
+    TrioStartupStep_t step = trioHPConfig.startup.current_step;
+
+    // Module phase (steps 6-9): per-module machines, fleet timeout is the barrier timeout
+    if (step >= TRIO_STARTUP_STEP_MODULE_STATE_READ && step <= TRIO_STARTUP_STEP_SEND_POWER_COMMANDS) {
+        // Late modules may join until the registered set is stable (or the window expires)
+        bool joinOpen = (now - seqStats.sequenceStartTime < TRIO_SEQ_HEARTBEAT_WINDOW_MS) &&
+                        (moduleSeqCount < trioHPConfig.maxActiveModules);
+        if (joinOpen && collectRegisteredModules(false) > 0) {
+            Serial.printf("[TRIO HP STARTUP] %d modules participating\n", moduleSeqCount);
+        }
+
+        TrioStartupStep_t slowest;
+        bool settled = tickAllModules(now, TRIO_MODULE_SEQ_READY, &slowest);
+        joinOpen = joinOpen && !isModuleRegistrySettled(now);
+
+        // Modules still waiting for a heartbeat are reported in step 6 - dropping below
+        // it would re-enter fleet steps 4-5 (national settings broadcast, phase timer reset)
+        if (slowest < TRIO_STARTUP_STEP_MODULE_STATE_READ) slowest = TRIO_STARTUP_STEP_MODULE_STATE_READ;
+        trioHPConfig.startup.current_step = slowest;
+
+        if (!joinOpen) {
+            for (uint8_t i = 0; i < moduleSeqCount; i++) {
+                if (moduleSeq[i].state == TRIO_MODULE_SEQ_WAIT_HEARTBEAT) {
+                    failModule(&moduleSeq[i], "no heartbeat");
+                    seqStats.failedModules++;
+                }
+            }
+            settled = (seqStats.readyModules + seqStats.failedModules == moduleSeqCount);
+        }
+
+        if (!settled && now - modulePhaseStartTime > TRIO_SEQ_BARRIER_TIMEOUT_MS) {
+            failUnsettledModules(TRIO_MODULE_SEQ_READY, "barrier timeout");
+            settled = true;
+        }
+
+        if (!settled || joinOpen) return true;
+
+        if (seqStats.readyModules == 0) {
+            failStartup("No module accepted power command");
+            return false;
+        }
+
+        Serial.printf("[TRIO HP STARTUP] Steps 6-9 completed: %d ready, %d excluded (%lu ms)\n",
+                      seqStats.readyModules, seqStats.failedModules, now - seqStats.sequenceStartTime);
+        advanceStartupStep(TRIO_STARTUP_STEP_OPERATIONAL_ON);
+        return true;
+    }
+
+    // Fleet steps
+    if (!checkFleetStepTimeout(now)) return false;
+
+    bool stepSuccess = false;
+    switch (step) {
+        case TRIO_STARTUP_STEP_ESTOP_CHECK:
+            stepSuccess = !isEstopActive();  // E-STOP must be INACTIVE
+            if (stepSuccess) {
+                Serial.println("[TRIO HP STARTUP] Step 1: E-STOP check PASSED");
+            } else {
+                strcpy(trioHPConfig.startup.step_error_message, "E-STOP is ACTIVE");
+            }
+            break;
+
+        case TRIO_STARTUP_STEP_READY_TO_CHARGE:
+            // Check readyToCharge from any BMS
+            for (int i = 0; i < MAX_BMS_NODES && !stepSuccess; i++) {
+                if (isBMSNodeActive(i) && isBMSDataRecent(i, 5000)) {
+                    BMSData* bmsData = getBMSData(i);
+                    if (bmsData && bmsData->readyToCharge) {
+                        stepSuccess = true;
+                    }
+                }
+            }
+            if (stepSuccess) {
+                Serial.println("[TRIO HP STARTUP] Step 2: Ready to charge PASSED");
+            } else {
+                strcpy(trioHPConfig.startup.step_error_message, "No BMS ready to charge");
+            }
+            break;
+
+        case TRIO_STARTUP_STEP_AC_CONTACTOR:
+            stepSuccess = isACContactorClosed();  // AC contactor must be CLOSED
+            if (stepSuccess) {
+                Serial.println("[TRIO HP STARTUP] Step 3: AC contactor check PASSED");
+            } else {
+                strcpy(trioHPConfig.startup.step_error_message, "AC contactor is OPEN");
+            }
+            break;
+
+        case TRIO_STARTUP_STEP_HEARTBEAT_DETECTION:
+            // Registered modules join now, late ones during the heartbeat window
+            collectRegisteredModules(false);
+            stepSuccess = (getActiveModuleCount() > 0 && moduleSeqCount > 0);
+            if (stepSuccess) {
+                Serial.printf("[TRIO HP STARTUP] Step 4: Heartbeat detection PASSED (%d modules)\n",
+                              moduleSeqCount);
+            } else {
+                strcpy(trioHPConfig.startup.step_error_message, "No TRIO HP modules detected");
+            }
+            break;
+
+        case TRIO_STARTUP_STEP_BROADCAST_SETTINGS:
+            // Broadcast has no per-module response - fleet step
+            stepSuccess = sendBroadcastCommand(TRIO_HP_CMD_NATIONAL_SETTINGS, (uint32_t)trioHPConfig.defaultStandard);
+            if (stepSuccess) {
+                Serial.println("[TRIO HP STARTUP] Step 5: Broadcast settings SENT");
+                modulePhaseStartTime = now;
+            } else {
+                strcpy(trioHPConfig.startup.step_error_message, "Broadcast settings failed");
+            }
+            break;
+
+        case TRIO_STARTUP_STEP_OPERATIONAL_ON:
+            // Barrier: operational state is a broadcast for the whole fleet (0x11 0x10 A0)
+            stepSuccess = setSystemOperationalReadiness(true);
+            if (stepSuccess) {
+                for (uint8_t i = 0; i < moduleSeqCount; i++) {
+                    if (moduleSeq[i].state == TRIO_MODULE_SEQ_READY) {
+                        moduleSeq[i].state = TRIO_MODULE_SEQ_DELIVERING;
+                    }
+                }
+                seqStats.lastStartupDurationMs = now - seqStats.sequenceStartTime;
+                Serial.printf("[TRIO HP STARTUP] Step 10: System OPERATIONAL (%d modules delivering, %lu ms)\n",
+                              seqStats.readyModules, seqStats.lastStartupDurationMs);
+                trioHPConfig.startup.startup_successful = true;
+                trioHPConfig.startup.startup_in_progress = false;
+                trioHPConfig.startup.current_step = TRIO_STARTUP_STEP_COMPLETED;
+                return true;
+            } else {
+                strcpy(trioHPConfig.startup.step_error_message, "Failed to set operational state");
+            }
+            break;
+
+        default:
+            // Should not reach here
+            trioHPConfig.startup.startup_in_progress = false;
+            return true;
+    }
+
+    // Move to next step if current step succeeded
+    if (stepSuccess) {
+        advanceStartupStep((TrioStartupStep_t)(step + 1));
+    }
+
+    return true;
+}
+
+// === SHUTDOWN SEQUENCE FUNCTIONS ===
+
+bool startTrioHPShutdownSequence() {
+    if (trioHPConfig.shutdown.shutdown_in_progress) {
+        Serial.println("[TRIO HP SHUTDOWN] ERROR: Shutdown already in progress");
+        return false;
+    }
+
+    // Shutdown always wins over a running startup
+    if (trioHPConfig.startup.startup_in_progress) {
+        failStartup("Aborted by shutdown");
+    }
+
+    Serial.println("[TRIO HP SHUTDOWN] Starting 2-step shutdown sequence");
+
+    resetModuleSequences();
+    seqStats.sequenceStartTime = millis();
+    shutdownPowerTargetZeroed = false;
+
+    trioHPConfig.shutdown.current_step = TRIO_SHUTDOWN_STEP_CURRENT_ZERO;
+    trioHPConfig.shutdown.shutdown_in_progress = true;
+    trioHPConfig.shutdown.shutdown_successful = false;
+    trioHPConfig.shutdown.step_start_time = millis();
+    trioHPConfig.shutdown.step_timeout = 10000; // 10s timeout for current zero
+    trioHPConfig.shutdown.step_retry_count = 0;
+    memset(trioHPConfig.shutdown.step_error_message, 0, sizeof(trioHPConfig.shutdown.step_error_message));
+
+    // Zero-current commands go to every online module concurrently
+    collectRegisteredModules(true);
+    for (uint8_t i = 0; i < moduleSeqCount; i++) {
+        enterModuleStep(&moduleSeq[i], TRIO_MODULE_SEQ_CURRENT_ZERO);
+    }
+
+    return true;
+}
+
+bool processShutdownSequenceStep() {
+    if (!trioHPConfig.shutdown.shutdown_in_progress) return true;
+
+    unsigned long now = millis();
+    TrioShutdownStep_t step = trioHPConfig.shutdown.current_step;
+    bool stepSuccess = false;
+
+    switch (step) {
+        case TRIO_SHUTDOWN_STEP_CURRENT_ZERO: {
+            // Stop the controller from ramping current back up
+            if (!shutdownPowerTargetZeroed) {
+                shutdownPowerTargetZeroed = setActivePowerTarget(0.0f);
+            }
+
+            bool settled = tickAllModules(now, TRIO_MODULE_SEQ_STOPPED, nullptr);
+            bool timedOut = (now - trioHPConfig.shutdown.step_start_time > trioHPConfig.shutdown.step_timeout);
+            if (!settled && timedOut) {
+                // Shutdown never aborts - unresponsive modules get the OFF broadcast anyway
+                failUnsettledModules(TRIO_MODULE_SEQ_STOPPED, "zero current timeout");
+                strcpy(trioHPConfig.shutdown.step_error_message, "Some modules did not confirm zero current");
+                settled = true;
+            }
+
+            stepSuccess = settled && (shutdownPowerTargetZeroed || timedOut);
+            if (stepSuccess) {
+                Serial.printf("[TRIO HP SHUTDOWN] Step 1: Current set to ZERO (%d confirmed, %d excluded)\n",
+                              seqStats.readyModules, seqStats.failedModules);
+            }
+            break;
+        }
+
+        case TRIO_SHUTDOWN_STEP_OPERATIONAL_OFF:
+            // Check step timeout
+            if (now - trioHPConfig.shutdown.step_start_time > trioHPConfig.shutdown.step_timeout) {
+                trioHPConfig.shutdown.step_retry_count++;
+                if (trioHPConfig.shutdown.step_retry_count >= 3) {
+                    snprintf(trioHPConfig.shutdown.step_error_message, 64,
+                            "Step %s timeout after 3 retries", getShutdownStepName(step));
+                    Serial.printf("[TRIO HP SHUTDOWN] ERROR: %s\n", trioHPConfig.shutdown.step_error_message);
+                    trioHPConfig.shutdown.shutdown_in_progress = false;
+                    return false;
+                }
+                Serial.printf("[TRIO HP SHUTDOWN] Retry %d for step %s\n",
+                              trioHPConfig.shutdown.step_retry_count, getShutdownStepName(step));
+                trioHPConfig.shutdown.step_start_time = now;
+            }
+
+            // Set operational state OFF (0x11 0x10 A1)
+            stepSuccess = setSystemOperationalReadiness(false);
+            if (stepSuccess) {
+                seqStats.lastShutdownDurationMs = now - seqStats.sequenceStartTime;
+                Serial.printf("[TRIO HP SHUTDOWN] Step 2: System set to OFF (%lu ms)\n",
+                              seqStats.lastShutdownDurationMs);
+                trioHPConfig.shutdown.shutdown_successful = true;
+                trioHPConfig.shutdown.shutdown_in_progress = false;
+                trioHPConfig.shutdown.current_step = TRIO_SHUTDOWN_STEP_COMPLETED;
+                return true;
+            } else {
+                strcpy(trioHPConfig.shutdown.step_error_message, "Failed to set OFF state");
+            }
+            break;
+
+        case TRIO_SHUTDOWN_STEP_COMPLETED:
+            // Should not reach here
+            trioHPConfig.shutdown.shutdown_in_progress = false;
+            return true;
+    }
+
+    // Move to next step if current step succeeded
+    if (stepSuccess) {
+        trioHPConfig.shutdown.current_step = (TrioShutdownStep_t)(step + 1);
+        trioHPConfig.shutdown.step_start_time = millis();
+        trioHPConfig.shutdown.step_retry_count = 0;
+        trioHPConfig.shutdown.step_timeout = 5000; // 5s timeout for operational OFF
+    }
+
+    return true;
+}
+
+// === SEQUENCER ACCESS FUNCTIONS ===
+
+uint8_t getSequencedModuleCount() {
+    return moduleSeqCount;
+}
+
+const TrioModuleSequence_t* getModuleSequence(uint8_t index) {
+    return index < moduleSeqCount ? &moduleSeq[index] : nullptr;
+}
+
+const TrioSequencerStats_t* getSequencerStats() {
+    return &seqStats;
+}
+
+const char* getModuleSeqStateName(TrioModuleSeqState_t state) {
+    switch (state) {
+        case TRIO_MODULE_SEQ_IDLE:               return "Idle";
+        case TRIO_MODULE_SEQ_WAIT_HEARTBEAT:     return "Wait Heartbeat";
+        case TRIO_MODULE_SEQ_STATE_READ:         return "State Read";
+        case TRIO_MODULE_SEQ_MULTICAST_SETTINGS: return "Multicast Settings";
+        case TRIO_MODULE_SEQ_CALCULATE_CURRENT:  return "Calculate Current";
+        case TRIO_MODULE_SEQ_POWER_COMMAND:      return "Power Command";
+        case TRIO_MODULE_SEQ_READY:              return "Ready";
+        case TRIO_MODULE_SEQ_DELIVERING:         return "Delivering";
+        case TRIO_MODULE_SEQ_CURRENT_ZERO:       return "Current Zero";
+        case TRIO_MODULE_SEQ_STOPPED:            return "Stopped";
+        case TRIO_MODULE_SEQ_FAILED:             return "Failed";
+        default:                                 return "Unknown";
+    }
+}
+
+void printModuleSequencerStatus() {
+    Serial.println("=== TRIO HP MODULE SEQUENCER STATUS ===");
+    Serial.printf("Participating: %d, Ready: %d, Excluded: %d, Retries: %lu\n",
+                  seqStats.participatingModules, seqStats.readyModules,
+                  seqStats.failedModules, (unsigned long)seqStats.commandRetries);
+    Serial.printf("Last startup: %lu ms, last shutdown: %lu ms\n",
+                  seqStats.lastStartupDurationMs, seqStats.lastShutdownDurationMs);
+
+    for (uint8_t i = 0; i < moduleSeqCount; i++) {
+        Serial.printf("  Module %2d: %-18s retries=%d setpoint=%.2fA\n",
+                      moduleSeq[i].moduleId, getModuleSeqStateName(moduleSeq[i].state),
+                      moduleSeq[i].retryCount, moduleSeq[i].currentSetpoint);
+    }
+}
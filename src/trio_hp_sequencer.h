@@ -0,0 +1,114 @@
+// =====================================================================
+// === trio_hp_sequencer.h - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: TRIO HP Startup/Shutdown Sequencer
+//    Version: v1.0.2
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.2 - 18.10.2026 - Module state read is a 0x23 status read
+//    v1.0.1 - 18.10.2026 - Join window closes once the registered module set is stable
+//    v1.0.0 - 18.10.2026 - Concurrent per-module step machines with fleet barriers
+//
+// 🎯 DEPENDENCIES:
+//    Internal: trio_hp_config.h (sequence state), trio_hp_manager.h (commands,
+//              response correlation), trio_hp_limits.h, trio_hp_controllers.h
+//    External: Arduino.h for standard types
+//
+// 📝 DESCRIPTION:
+//    Implements the 10-step startup and 2-step shutdown sequences declared in
+//    trio_hp_config.h. Fleet-wide interlocks (E-STOP, ready to charge, AC
+//    contactor), the broadcast settings and the operational ON/OFF broadcast
+//    are fleet barriers. Everything addressed to a single module (state read,
+//    work mode, current setpoint, zero current) runs in a per-module step
+//    machine that advances as soon as the manager correlates the module's
+//    response, so modules never wait for the slowest one between steps.
+//
+// 🔧 CONFIGURATION:
+//    - Per-command response timeout: 1000ms, 3 retries, then module excluded
+//    - Heartbeat join window: closes 2000ms after the last module discovery,
+//      at the latest 5000ms after start (or when maxActiveModules joined)
+//    - Module phase barrier timeout: 15000ms
+//
+// ⚠️  KNOWN ISSUES:
+//    - None currently identified
+//
+// 🧪 TESTING STATUS:
+//    Unit Tests: NOT_TESTED
+//    Integration Tests: NOT_TESTED
+//    Manual Testing: NOT_TESTED
+//
+// 📈 PERFORMANCE NOTES:
+//    - Startup time ~ slowest module's 3 round trips instead of sum over fleet,
+//      provided the sequencer is ticked every loop pass (main.cpp does)
+//    - Per tick: O(n) over participating modules, no blocking calls
+//    - Memory: ~20 bytes per module
+//
+// =====================================================================
+
+#ifndef TRIO_HP_SEQUENCER_H
+#define TRIO_HP_SEQUENCER_H
+
+#include <Arduino.h>
+#include "trio_hp_config.h"
+
+// === SEQUENCER CONSTANTS ===
+#define TRIO_SEQ_RESPONSE_TIMEOUT_MS   1000   // Per-command response timeout
+#define TRIO_SEQ_MAX_RETRIES           3      // Retries before module is excluded
+#define TRIO_SEQ_HEARTBEAT_WINDOW_MS   5000   // Max window for late modules to join
+#define TRIO_SEQ_JOIN_SETTLE_MS        2000   // No new module for this long -> join window closed
+#define TRIO_SEQ_BARRIER_TIMEOUT_MS    15000  // Max time spent in module phase
+
+// === PER-MODULE STEP MACHINE ===
+typedef enum {
+    TRIO_MODULE_SEQ_IDLE = 0,
+    TRIO_MODULE_SEQ_WAIT_HEARTBEAT,     // Startup step 4 (per module)
+    TRIO_MODULE_SEQ_STATE_READ,         // Startup step 6 - awaiting 0x23 status read response
+    TRIO_MODULE_SEQ_MULTICAST_SETTINGS, // Startup step 7 - awaiting 0x2110 response
+    TRIO_MODULE_SEQ_CALCULATE_CURRENT,  // Startup step 8 - local calculation
+    TRIO_MODULE_SEQ_POWER_COMMAND,      // Startup step 9 - awaiting 0x1002 response
+    TRIO_MODULE_SEQ_READY,              // Waiting for operational ON barrier
+    TRIO_MODULE_SEQ_DELIVERING,         // Operational, setpoint applied
+    TRIO_MODULE_SEQ_CURRENT_ZERO,       // Shutdown step 1 - awaiting 0x1002 response
+    TRIO_MODULE_SEQ_STOPPED,            // Waiting for operational OFF barrier
+    TRIO_MODULE_SEQ_FAILED              // Excluded after retries
+} TrioModuleSeqState_t;
+
+typedef struct {
+    uint8_t moduleId;                   // TRIO HP module ID
+    TrioModuleSeqState_t state;         // Current per-module step
+    uint16_t awaitedCommand;            // Command whose response advances the step
+    unsigned long stepStartTime;        // When current command was (re)sent [ms]
+    uint8_t retryCount;                 // Retries for current step
+    float currentSetpoint;              // Calculated DC current share [A]
+} TrioModuleSequence_t;
+
+typedef struct {
+    uint8_t participatingModules;       // Modules in current sequence
+    uint8_t readyModules;               // Modules READY/DELIVERING/STOPPED
+    uint8_t failedModules;              // Modules excluded after retries
+    uint32_t commandRetries;            // Total per-module retries
+    unsigned long sequenceStartTime;    // Start command timestamp [ms]
+    unsigned long lastStartupDurationMs;  // Start command -> all modules delivering
+    unsigned long lastShutdownDurationMs; // Shutdown command -> operational OFF
+} TrioSequencerStats_t;
+
+// === SEQUENCER ACCESS FUNCTIONS ===
+// Sequence control (start/process) is declared in trio_hp_config.h
+uint8_t getSequencedModuleCount();
+const TrioModuleSequence_t* getModuleSequence(uint8_t index);
+const TrioSequencerStats_t* getSequencerStats();
+const char* getModuleSeqStateName(TrioModuleSeqState_t state);
+void printModuleSequencerStatus();
+
+#endif // TRIO_HP_SEQUENCER_H
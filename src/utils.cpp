@@ -10,12 +10,15 @@
 //
 // 📋 MODULE INFO:
 //    Module: System Utilities Implementation
-//    Version: v4.0.2
+//    Version: v4.0.5
 //    Created: 17.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.0.5 - 18.10.2026 - Signed/unsigned loop bounds in the validators, protocol ID in the Modbus frame dump
+//    v4.0.4 - 18.10.2026 - Blocking LED fallback timed as a profiling zone
+//    v4.0.3 - 18.10.2026 - LED blinks played by the status LED engine, no delay()
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v4.0.1 - 17.08.2025 - Added missing functions used in main.cpp
 //    v4.0.0 - 17.08.2025 - Initial utilities implementation
@@ -56,6 +59,8 @@
 
 #include "utils.h"
 #include "bms_data.h"  // 🔥 Potrzebne dla getActiveBMSCount()
+#include "status_led.h"
+#include "stall_monitor.h"
 #include <WiFi.h>
 
 // === 🔥 BRAKUJĄCE FUNKCJE Z MAIN.CPP ===
@@ -116,9 +121,16 @@ void setupLED() {
   pinMode(LED_PIN, OUTPUT);
   digitalWrite(LED_PIN, LOW);
   DEBUG_PRINTF("✅ LED initialized on GPIO%d\n", LED_PIN);
+  initStatusLED();
 }
 
 void blinkLED(int count, int duration) {
+  // Engine running: played from its timer, the caller does not wait
+  if (isStatusLEDRunning()) {
+    playStatusLEDOnce(constrain(count, 0, 255), constrain(duration, 0, 65535));
+    return;
+  }
+  PROFILE_ZONE(PROFILE_ZONE_LED);
   for (int i = 0; i < count; i++) {
     digitalWrite(LED_PIN, HIGH);
     delay(duration);
@@ -238,9 +250,10 @@ size_t getMaxAllocHeap() {
 bool isValidIPAddress(const String& ip) {
   int parts = 0;
   int lastDot = -1;
+  int length = ip.length();
   
-  for (int i = 0; i <= ip.length(); i++) {
-    if (i == ip.length() || ip[i] == '.') {
+  for (int i = 0; i <= length; i++) {
+    if (i == length || ip[i] == '.') {
       if (i - lastDot - 1 == 0) return false; // Empty part
       String part = ip.substring(lastDot + 1, i);
       int num = part.toInt();
@@ -258,7 +271,7 @@ bool isValidIPAddress(const String& ip) {
 bool isValidMACAddress(const String& mac) {
   if (mac.length() != 17) return false;
   
-  for (int i = 0; i < mac.length(); i++) {
+  for (unsigned int i = 0; i < mac.length(); i++) {
     if (i % 3 == 2) {
       if (mac[i] != ':') return false;
     } else {
@@ -306,9 +319,9 @@ void printModbusFrame(const uint8_t* frame, size_t length, bool isRequest) {
   uint8_t slaveId = frame[6];
   uint8_t functionCode = frame[7];
   
-  DEBUG_PRINTF("📦 Modbus %s: TxID=%d SlaveID=%d Func=0x%02X Len=%d Data=", 
+  DEBUG_PRINTF("📦 Modbus %s: TxID=%d Proto=%d SlaveID=%d Func=0x%02X Len=%d Data=", 
                isRequest ? "Request" : "Response", 
-               transactionId, slaveId, functionCode, frameLength);
+               transactionId, protocolId, slaveId, functionCode, frameLength);
   
   if (length > 8) {
     printHexDump(&frame[8], length - 8, "");
@@ -0,0 +1,542 @@
+// =====================================================================
+// === virtual_bms.cpp - ESP32S3 CAN to Modbus TCP Bridge ===
+// =====================================================================
+//
+// 📋 PROJECT INFO:
+//    Repository: https://github.com/user/esp32s3-can-modbus-tcp
+//    Project: ESP32S3 CAN to Modbus TCP Bridge
+//    Branch: main
+//    Created: 18.10.2026 (Warsaw Time)
+//
+// 📋 MODULE INFO:
+//    Module: Virtual Aggregated BMS Emitter Implementation
+//    Version: v1.0.0
+//    Created: 18.10.2026 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
+//    Author: ESP32 Development Team
+//
+// 📊 VERSION HISTORY:
+//    v1.0.0 - 18.10.2026 - Fleet-level 190/290/510 frames on a configurable ID set and period
+//
+// 🎯 DEPENDENCIES:
+//    Internal: virtual_bms.h, event_bus.h, bms_data.h, bms_protocol.h, can_bus.h,
+//              trio_hp_limits.h, log_sink.h
+//    External: Preferences.h
+//
+// 📝 DESCRIPTION:
+//    Each BMS slot caches what it contributes to the fleet sums. A frame
+//    event takes the slot's old contribution out of the sums and puts the
+//    new one in; flags, inputs and outputs are kept as per-bit counts so a
+//    pack clearing an error also clears it in the ORed byte. The lowest
+//    cell is tracked by slot and only rescanned when that slot's value
+//    rises or the slot goes away. The sweep re-sums exactly from the slot
+//    cache, which also removes float drift from add/subtract.
+//
+//    Everything runs in the main loop, like the CAN drain: the TX path
+//    shares the SPI bus with RX, so no other task sends.
+//
+// =====================================================================
+
+#include "virtual_bms.h"
+#include "event_bus.h"
+#include "bms_data.h"
+#include "bms_protocol.h"
+#include "can_bus.h"
+#include "log_sink.h"
+#include "trio_hp_limits.h"
+#include <Preferences.h>
+#include <math.h>
+
+// === PACK SLOT CACHE ===
+typedef struct {
+  uint8_t nodeId;                   // 0 = slot unused
+  bool has190;
+  bool has290;
+  bool has510;
+  unsigned long last190;            // millis() of the frame folded in
+  unsigned long last290;
+  unsigned long last510;
+  float voltage;
+  float current;
+  float energy;
+  float soc;
+  uint8_t errorFlags;               // Frame 190 byte 7 bits 0-3
+  float cellMin;
+  float cellMean;
+  uint8_t minString;
+  uint8_t minBlock;
+  uint8_t minCell;
+  uint8_t inputs;
+  uint8_t outputs;
+} VirtualPackSlot_t;
+
+// === FLEET SUMS ===
+typedef struct {
+  uint8_t packs190;
+  uint8_t packs290;
+  float voltage;
+  float current;
+  float energy;
+  float soc;
+  float cellMean;
+  uint8_t errorBits[4];             // Packs with each frame 190 error flag set
+  uint8_t inputBits[8];
+  uint8_t outputBits[8];
+} VirtualFleetSums_t;
+
+static VirtualBMSConfig_t vbmsConfig = {
+  false, CAN_CHANNEL_PRIMARY, false,
+  { VBMS_DEFAULT_ID_190, VBMS_DEFAULT_ID_290, VBMS_DEFAULT_ID_510 },
+  VBMS_DEFAULT_PERIOD_MS
+};
+static VirtualPackSlot_t packSlots[MAX_BMS_NODES];
+static VirtualFleetSums_t fleetSums;
+static int8_t minSlot = -1;
+static bool minDirty = false;
+static VirtualBMSAggregate_t aggregate;
+static VirtualBMSStats_t vbmsStats;
+static uint64_t latenessSumUs = 0;
+static unsigned long latenessSamples = 0;
+
+static int8_t vbmsEventSub = -1;
+static unsigned long vbmsEventDrops = 0;
+static unsigned long lastSweep = 0;
+static unsigned long nextDueUs[VBMS_FRAME_COUNT];
+static bool scheduleArmed = false;
+
+// === SUM HELPERS ===
+
+static void countBits(uint8_t* counts, uint8_t bits, uint8_t width, int8_t delta) {
+  for (uint8_t b = 0; b < width; b++) {
+    if (bits & (1 << b)) counts[b] += delta;
+  }
+}
+
+static uint8_t bitsFromCounts(const uint8_t* counts, uint8_t width) {
+  uint8_t bits = 0;
+  for (uint8_t b = 0; b < width; b++) {
+    if (counts[b] > 0) bits |= 1 << b;
+  }
+  return bits;
+}
+
+static void apply190(const VirtualPackSlot_t* slot, int8_t sign) {
+  fleetSums.packs190 += sign;
+  fleetSums.voltage += sign * slot->voltage;
+  fleetSums.current += sign * slot->current;
+  fleetSums.energy += sign * slot->energy;
+  fleetSums.soc += sign * slot->soc;
+  countBits(fleetSums.errorBits, slot->errorFlags, 4, sign);
+}
+
+static void apply290(const VirtualPackSlot_t* slot, int8_t sign) {
+  fleetSums.packs290 += sign;
+  fleetSums.cellMean += sign * slot->cellMean;
+}
+
+static void apply510(const VirtualPackSlot_t* slot, int8_t sign) {
+  countBits(fleetSums.inputBits, slot->inputs, 8, sign);
+  countBits(fleetSums.outputBits, slot->outputs, 8, sign);
+}
+
+static void drop290(uint8_t index) {
+  VirtualPackSlot_t* slot = &packSlots[index];
+  if (!slot->has290) return;
+  apply290(slot, -1);
+  slot->has290 = false;
+  if (minSlot == index) minDirty = true;
+}
+
+static void dropSlot(uint8_t index) {
+  VirtualPackSlot_t* slot = &packSlots[index];
+  if (slot->has190) apply190(slot, -1);
+  if (slot->has510) apply510(slot, -1);
+  drop290(index);
+  slot->has190 = false;
+  slot->has510 = false;
+}
+
+static void rescanMinCell() {
+  minSlot = -1;
+  for (uint8_t i = 0; i < MAX_BMS_NODES; i++) {
+    if (packSlots[i].has290 && (minSlot < 0 || packSlots[i].cellMin < packSlots[minSlot].cellMin)) {
+      minSlot = i;
+    }
+  }
+  minDirty = false;
+}
+
+// === FOLDING FRAMES ===
+
+static void foldFrame(uint8_t nodeId, uint8_t frameType, unsigned long timestamp) {
+  int index = getBMSIndexByNodeId(nodeId);
+  BMSData* bms = getBMSData(nodeId);
+  if (index < 0 || index >= MAX_BMS_NODES || bms == nullptr) return;
+
+  VirtualPackSlot_t* slot = &packSlots[index];
+  if (slot->nodeId != nodeId) {
+    // Slot reassigned by a configuration change
+    dropSlot(index);
+    slot->nodeId = nodeId;
+  }
+
+  switch (frameType) {
+    case BMS_FRAME_TYPE_190:
+      if (slot->has190) apply190(slot, -1);
+      slot->voltage = bms->batteryVoltage;
+      slot->current = bms->batteryCurrent;
+      slot->energy = bms->remainingEnergy;
+      slot->soc = bms->soc;
+      slot->errorFlags = (bms->masterError ? 0x01 : 0) | (bms->cellVoltageError ? 0x02 : 0) |
+                         (bms->cellTempMinError ? 0x04 : 0) | (bms->cellTempMaxError ? 0x08 : 0);
+      slot->has190 = true;
+      slot->last190 = timestamp;
+      apply190(slot, 1);
+      break;
+
+    case BMS_FRAME_TYPE_290: {
+      float previous = slot->cellMin;
+      bool had = slot->has290;
+      if (had) apply290(slot, -1);
+      slot->cellMin = bms->cellMinVoltage;
+      slot->cellMean = bms->cellMeanVoltage;
+      slot->minString = bms->minVoltageString;
+      slot->minBlock = bms->minVoltageBlock;
+      slot->minCell = bms->minVoltageCell;
+      slot->has290 = true;
+      slot->last290 = timestamp;
+      apply290(slot, 1);
+
+      if (!minDirty) {
+        if (minSlot < 0 || (minSlot != index && slot->cellMin < packSlots[minSlot].cellMin)) {
+          minSlot = index;
+        } else if (minSlot == index && had && slot->cellMin > previous) {
+          minDirty = true;          // The lowest cell rose: another pack may be lower now
+        }
+      }
+      break;
+    }
+
+    case BMS_FRAME_TYPE_510:
+      if (slot->has510) apply510(slot, -1);
+      slot->inputs = bms->inputs;
+      slot->outputs = bms->outputs;
+      slot->has510 = true;
+      slot->last510 = timestamp;
+      apply510(slot, 1);
+      break;
+
+    default:
+      break;
+  }
+}
+
+static void rebuildFromBMSData() {
+  extern SystemConfig systemConfig;
+  memset(packSlots, 0, sizeof(packSlots));
+  memset(&fleetSums, 0, sizeof(fleetSums));
+  minSlot = -1;
+  minDirty = false;
+
+  unsigned long now = millis();
+  const uint8_t frames[] = { BMS_FRAME_TYPE_190, BMS_FRAME_TYPE_290, BMS_FRAME_TYPE_510 };
+  for (int i = 0; i < systemConfig.activeBmsNodes && i < MAX_BMS_NODES; i++) {
+    uint8_t nodeId = systemConfig.bmsNodeIds[i];
+    BMSData* bms = getBMSData(nodeId);
+    if (bms == nullptr) continue;
+    for (uint8_t f = 0; f < sizeof(frames); f++) {
+      unsigned long timestamp = bms->frameTimestamps[frames[f]];
+      if (timestamp != 0 && now - timestamp <= VBMS_PACK_TIMEOUT_MS) {
+        foldFrame(nodeId, frames[f], timestamp);
+      }
+    }
+  }
+  vbmsStats.rebuilds++;
+}
+
+static void sweepStalePacks() {
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < MAX_BMS_NODES; i++) {
+    VirtualPackSlot_t* slot = &packSlots[i];
+    if (slot->has190 && now - slot->last190 > VBMS_PACK_TIMEOUT_MS) slot->has190 = false;
+    if (slot->has290 && now - slot->last290 > VBMS_PACK_TIMEOUT_MS) slot->has290 = false;
+    if (slot->has510 && now - slot->last510 > VBMS_PACK_TIMEOUT_MS) slot->has510 = false;
+  }
+
+  // Exact re-sum from the cache (also clears add/subtract drift)
+  memset(&fleetSums, 0, sizeof(fleetSums));
+  for (uint8_t i = 0; i < MAX_BMS_NODES; i++) {
+    const VirtualPackSlot_t* slot = &packSlots[i];
+    if (slot->has190) apply190(slot, 1);
+    if (slot->has290) apply290(slot, 1);
+    if (slot->has510) apply510(slot, 1);
+  }
+  rescanMinCell();
+}
+
+static void refreshAggregate() {
+  if (minDirty) rescanMinCell();
+
+  const VirtualFleetSums_t* s = &fleetSums;
+  aggregate.packs190 = s->packs190;
+  aggregate.packs290 = s->packs290;
+  aggregate.voltage = s->packs190 ? s->voltage / s->packs190 : 0.0f;
+  aggregate.current = s->packs190 ? s->current : 0.0f;
+  aggregate.energy = s->packs190 ? s->energy : 0.0f;
+  aggregate.soc = s->packs190 ? s->soc / s->packs190 : 0.0f;
+  // No fresh pack: the virtual BMS reports a master error
+  aggregate.errorFlags = s->packs190 ? bitsFromCounts(s->errorBits, 4) : 0x01;
+  aggregate.cellMeanVoltage = s->packs290 ? s->cellMean / s->packs290 : 0.0f;
+  aggregate.cellMinVoltage = minSlot >= 0 ? packSlots[minSlot].cellMin : 0.0f;
+  aggregate.cellMinNode = minSlot >= 0 ? packSlots[minSlot].nodeId : 0;
+
+  // Fleet limits come aggregated and derated from trio_hp_limits; zero when invalid
+  const TrioHPLimits_t* limits = getCurrentBMSLimits();
+  bool limitsValid = limits != nullptr && limits->limits_valid && limits->fresh_packs > 0;
+  aggregate.dccl = limitsValid ? limits->dccl_bms : 0.0f;
+  aggregate.ddcl = limitsValid ? limits->ddcl_bms : 0.0f;
+}
+
+// === FRAME ENCODING (inverse of decodeBMSFrameData) ===
+
+static uint16_t encodeField(float value, float resolution, bool countSaturation) {
+  float raw = roundf(value / resolution);
+  if (raw < 0.0f || raw > 65535.0f || isnan(raw)) {
+    if (countSaturation) vbmsStats.saturated++;
+    return (raw > 65535.0f) ? 65535 : 0;
+  }
+  return (uint16_t)raw;
+}
+
+static void encodeFrame(VirtualBMSFrame_t frame, uint8_t* data, bool countSaturation) {
+  memset(data, 0, 8);
+  const VirtualBMSAggregate_t* a = &aggregate;
+  uint16_t v;
+
+  switch (frame) {
+    case VBMS_FRAME_190:
+      v = encodeField(a->voltage, 0.01f, countSaturation);
+      data[0] = v >> 8; data[1] = v & 0xFF;
+      v = encodeField(a->current, 0.01f, countSaturation);
+      data[2] = v >> 8; data[3] = v & 0xFF;
+      v = encodeField(a->energy, 0.01f, countSaturation);
+      data[4] = v >> 8; data[5] = v & 0xFF;
+      v = encodeField(a->soc, 0.5f, countSaturation);
+      data[6] = v > 255 ? 255 : v;
+      data[7] = a->errorFlags;
+      break;
+
+    case VBMS_FRAME_290:
+      v = encodeField(a->cellMinVoltage, 0.0001f, countSaturation);
+      data[0] = v & 0xFF; data[1] = v >> 8;
+      v = encodeField(a->cellMeanVoltage, 0.0001f, countSaturation);
+      data[2] = v & 0xFF; data[3] = v >> 8;
+      if (minSlot >= 0) {
+        data[4] = packSlots[minSlot].minString;
+        data[5] = packSlots[minSlot].minBlock;
+        data[6] = packSlots[minSlot].minCell;
+      }
+      break;
+
+    case VBMS_FRAME_510:
+      v = encodeField(a->dccl, 0.1f, countSaturation);
+      data[0] = v & 0xFF; data[1] = v >> 8;
+      v = encodeField(a->ddcl, 0.1f, countSaturation);
+      data[2] = v & 0xFF; data[3] = v >> 8;
+      data[4] = bitsFromCounts(fleetSums.inputBits, 8);
+      data[5] = bitsFromCounts(fleetSums.outputBits, 8);
+      break;
+
+    default:
+      break;
+  }
+}
+
+// === SCHEDULING ===
+
+static void recordLateness(uint32_t latenessUs) {
+  vbmsStats.lastLatenessUs = latenessUs;
+  if (latenessUs > vbmsStats.maxLatenessUs) vbmsStats.maxLatenessUs = latenessUs;
+  latenessSumUs += latenessUs;
+  latenessSamples++;
+  vbmsStats.meanLatenessUs = (float)latenessSumUs / latenessSamples;
+
+  uint8_t bucket = latenessUs < 250 ? VBMS_JITTER_UNDER_250US :
+                   latenessUs < 1000 ? VBMS_JITTER_UNDER_1MS :
+                   latenessUs < 5000 ? VBMS_JITTER_UNDER_5MS : VBMS_JITTER_OVER_5MS;
+  vbmsStats.jitterHistogram[bucket]++;
+  if (latenessUs > VBMS_MAX_JITTER_US) vbmsStats.lateFrames++;
+}
+
+static void sendDueFrames() {
+  uint32_t periodUs = (uint32_t)vbmsConfig.periodMs * 1000UL;
+  unsigned long now = micros();
+
+  if (!scheduleArmed) {
+    // Frames a third of a period apart so they do not hit the bus back to back
+    for (uint8_t f = 0; f < VBMS_FRAME_COUNT; f++) nextDueUs[f] = now + f * (periodUs / VBMS_FRAME_COUNT);
+    scheduleArmed = true;
+  }
+
+  bool refreshed = false;
+  for (uint8_t f = 0; f < VBMS_FRAME_COUNT; f++) {
+    int32_t lateness = (int32_t)(now - nextDueUs[f]);
+    if (lateness < 0) continue;
+
+    if ((uint32_t)lateness >= periodUs) {
+      // Whole periods missed (loop stall): skip them rather than send a burst
+      uint32_t missed = (uint32_t)lateness / periodUs;
+      vbmsStats.skipped += missed;
+      nextDueUs[f] += missed * periodUs;
+      lateness -= missed * periodUs;
+    }
+
+    if (!refreshed) {
+      refreshAggregate();
+      refreshed = true;
+    }
+    uint8_t data[8];
+    encodeFrame((VirtualBMSFrame_t)f, data, true);
+    if (canBusSendChannel(vbmsConfig.channel, CAN_PROTOCOL_BMS, vbmsConfig.ids[f], vbmsConfig.extended, 8, data)) {
+      vbmsStats.sent[f]++;
+    } else {
+      vbmsStats.txErrors++;
+    }
+    recordLateness((uint32_t)lateness);
+    nextDueUs[f] += periodUs;
+  }
+}
+
+// === PUBLIC FUNCTIONS ===
+
+bool initVirtualBMS() {
+  Preferences prefs;
+  if (prefs.begin(VBMS_NVS_NAMESPACE, true)) {
+    VirtualBMSConfig_t stored = vbmsConfig;
+    stored.enabled = prefs.getBool("enabled", stored.enabled);
+    stored.channel = prefs.getUChar("channel", stored.channel);
+    stored.extended = prefs.getBool("extended", stored.extended);
+    stored.ids[VBMS_FRAME_190] = prefs.getULong("id190", stored.ids[VBMS_FRAME_190]);
+    stored.ids[VBMS_FRAME_290] = prefs.getULong("id290", stored.ids[VBMS_FRAME_290]);
+    stored.ids[VBMS_FRAME_510] = prefs.getULong("id510", stored.ids[VBMS_FRAME_510]);
+    stored.periodMs = prefs.getUShort("period", stored.periodMs);
+    prefs.end();
+    if (stored.channel < CAN_CHANNEL_COUNT && stored.periodMs >= VBMS_MIN_PERIOD_MS &&
+        stored.periodMs <= VBMS_MAX_PERIOD_MS) {
+      vbmsConfig = stored;
+    }
+  }
+
+  vbmsEventSub = subscribeEvents("vbms", EVENT_MASK(EVENT_BMS_FRAME_PARSED));
+  rebuildFromBMSData();
+  vbmsStats.rebuilds = 0;
+
+  Serial.printf("🔋 Virtual BMS: %s, channel %u, IDs 0x%lX/0x%lX/0x%lX%s, %u ms\n",
+                vbmsConfig.enabled ? "enabled" : "disabled", vbmsConfig.channel,
+                (unsigned long)vbmsConfig.ids[VBMS_FRAME_190], (unsigned long)vbmsConfig.ids[VBMS_FRAME_290],
+                (unsigned long)vbmsConfig.ids[VBMS_FRAME_510], vbmsConfig.extended ? " (29-bit)" : "",
+                vbmsConfig.periodMs);
+  return vbmsEventSub >= 0;
+}
+
+void processVirtualBMS() {
+  // Fold frame events even while disabled: the aggregate stays live for /api/vbms
+  Event_t event;
+  while (pollEvent(vbmsEventSub, &event)) {
+    foldFrame(event.source, event.data.bmsFrame.frameType, event.timestamp);
+  }
+
+  unsigned long drops = getEventDrops(vbmsEventSub);
+  if (drops != vbmsEventDrops) {
+    vbmsEventDrops = drops;
+    rebuildFromBMSData();
+  }
+
+  unsigned long now = millis();
+  if (now - lastSweep >= VBMS_SWEEP_MS) {
+    lastSweep = now;
+    sweepStalePacks();
+  }
+
+  if (!vbmsConfig.enabled || !isCANChannelAvailable(vbmsConfig.channel)) {
+    scheduleArmed = false;          // Restart the schedule instead of catching up
+    return;
+  }
+  sendDueFrames();
+}
+
+bool setVirtualBMSConfig(const VirtualBMSConfig_t* config) {
+  if (config == nullptr || config->channel >= CAN_CHANNEL_COUNT ||
+      config->periodMs < VBMS_MIN_PERIOD_MS || config->periodMs > VBMS_MAX_PERIOD_MS) {
+    return false;
+  }
+  uint32_t idLimit = config->extended ? 0x1FFFFFFFUL : 0x7FFUL;
+  for (uint8_t f = 0; f < VBMS_FRAME_COUNT; f++) {
+    if (config->ids[f] > idLimit) return false;
+    // Never impersonate a pack: IDs of the BMS node ranges are refused
+    if (!config->extended && isValidBMSFrame(config->ids[f])) return false;
+    for (uint8_t g = 0; g < f; g++) {
+      if (config->ids[g] == config->ids[f]) return false;
+    }
+  }
+
+  vbmsConfig = *config;
+  scheduleArmed = false;
+
+  Preferences prefs;
+  if (prefs.begin(VBMS_NVS_NAMESPACE, false)) {
+    prefs.putBool("enabled", vbmsConfig.enabled);
+    prefs.putUChar("channel", vbmsConfig.channel);
+    prefs.putBool("extended", vbmsConfig.extended);
+    prefs.putULong("id190", vbmsConfig.ids[VBMS_FRAME_190]);
+    prefs.putULong("id290", vbmsConfig.ids[VBMS_FRAME_290]);
+    prefs.putULong("id510", vbmsConfig.ids[VBMS_FRAME_510]);
+    prefs.putUShort("period", vbmsConfig.periodMs);
+    prefs.end();
+  }
+
+  LOG_I(LOG_MODULE_CAN, "Virtual BMS %s: channel %u, %u ms", vbmsConfig.enabled ? "enabled" : "disabled",
+        vbmsConfig.channel, vbmsConfig.periodMs);
+  return true;
+}
+
+const VirtualBMSConfig_t* getVirtualBMSConfig() {
+  return &vbmsConfig;
+}
+
+void buildVirtualBMSFrame(VirtualBMSFrame_t frame, uint8_t* data) {
+  refreshAggregate();
+  encodeFrame(frame, data, false);
+}
+
+const VirtualBMSAggregate_t* getVirtualBMSAggregate() {
+  refreshAggregate();
+  return &aggregate;
+}
+
+const VirtualBMSStats_t* getVirtualBMSStats() {
+  return &vbmsStats;
+}
+
+void resetVirtualBMSStats() {
+  memset(&vbmsStats, 0, sizeof(vbmsStats));
+  latenessSumUs = 0;
+  latenessSamples = 0;
+}
+
+void printVirtualBMSStatus() {
+  const VirtualBMSAggregate_t* a = getVirtualBMSAggregate();
+  const VirtualBMSStats_t* s = &vbmsStats;
+  Serial.printf("🔋 Virtual BMS: %s, ch%u, %u ms, packs %u/%u\n",
+                vbmsConfig.enabled ? "ON" : "off", vbmsConfig.channel, vbmsConfig.periodMs,
+                a->packs190, a->packs290);
+  Serial.printf("   %.2f V, %.2f A, %.2f kWh, SOC %.1f%%, min cell %.4f V (node %u), DCCL %.1f A, DDCL %.1f A\n",
+                a->voltage, a->current, a->energy, a->soc, a->cellMinVoltage, a->cellMinNode, a->dccl, a->ddcl);
+  Serial.printf("   Sent %lu/%lu/%lu, TX errors %lu, skipped %lu, saturated %lu\n",
+                s->sent[VBMS_FRAME_190], s->sent[VBMS_FRAME_290], s->sent[VBMS_FRAME_510],
+                s->txErrors, s->skipped, s->saturated);
+  Serial.printf("   Lateness: mean %.0f us, max %lu us, late %lu (<250us %lu, <1ms %lu, <5ms %lu, >=5ms %lu)\n",
+                s->meanLatenessUs, (unsigned long)s->maxLatenessUs, s->lateFrames,
+                s->jitterHistogram[VBMS_JITTER_UNDER_250US], s->jitterHistogram[VBMS_JITTER_UNDER_1MS],
+                s->jitterHistogram[VBMS_JITTER_UNDER_5MS], s->jitterHistogram[VBMS_JITTER_OVER_5MS]);
+}
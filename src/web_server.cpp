@@ -10,12 +10,29 @@
 //
 // 📋 MODULE INFO:
 //    Module: Web Configuration Server Implementation
-//    Version: v4.0.2
+//    Version: v4.1.9
 //    Created: 17.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.1.9 - 18.10.2026 - /can pending indicator against the effective bitrate, failed CAN re-init shown as an error
+//    v4.1.8 - 18.10.2026 - CAN error counters and bus-off recovery per channel on /can and /api/status
+//    v4.1.7 - 18.10.2026 - /api/can/dispatch: duplicate payload suppression counters, saved parse time, toggle
+//    v4.1.6 - 18.10.2026 - /api/vbms: virtual BMS aggregate, frame payloads, TX jitter and settings
+//    v4.1.5 - 18.10.2026 - /api/can/signals: DBC table messages, decoded values, BMS parser check
+//    v4.1.4 - 18.10.2026 - /api/can/rules: loaded mapping rules with hit counts, reload, decode benchmark
+//    v4.1.3 - 18.10.2026 - /api/can/dispatch slice budget and backlog, burst replay with per-zone worst gaps
+//    v4.1.2 - 18.10.2026 - /api/log per-module levels, syslog target and suppression counters
+//    v4.1.1 - 18.10.2026 - /api/stalls ranked loop stall sources with backtraces, per-zone time
+//    v4.1.0 - 18.10.2026 - /metrics (Prometheus text): heap, pools, queues, latency histograms, drift
+//    v4.0.9 - 18.10.2026 - JSON APIs rendered into pooled per-request arenas instead of String
+//    v4.0.8 - 18.10.2026 - /api/events recent bus events and per-subscriber queue statistics
+//    v4.0.7 - 18.10.2026 - /api/can/load per-ID/node/protocol bus load, load columns on /can
+//    v4.0.6 - 18.10.2026 - Per-channel CAN statistics and protocol binding on /can and /api/status
+//    v4.0.5 - 18.10.2026 - CAN error counters and bus-off recovery on /can and /api/status
+//    v4.0.4 - 18.10.2026 - /api/bms/sdo on-demand object reads with freshness tags
+//    v4.0.3 - 18.10.2026 - TRIO HP system parameters form/export generated from parameter table
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v1.0.1 - 17.08.2025 - Clean implementation without emojis
 //    v1.0.0 - 17.08.2025 - Initial web server implementation
@@ -61,13 +78,69 @@
 #include "trio_hp_manager.h"
 #include "trio_hp_controllers.h"
 #include "trio_hp_limits.h"
+#include "trio_hp_params.h"
 #include "../include/bms_data.h"
+#include "../include/bms_protocol.h"
+#include "../include/bms_sdo.h"
+#include "../include/can_bus.h"
+#include "../include/can_load.h"
+#include "../include/event_bus.h"
+#include "../include/mem_pool.h"
+#include "../include/statistics.h"
+#include "../include/stall_monitor.h"
+#include "../include/log_sink.h"
+#include "../include/can_rules.h"
+#include "../include/can_signals.h"
+#include "../include/virtual_bms.h"
 #include <WiFi.h>
 #include <mcp_can.h>
 
 // === GLOBAL INSTANCE ===
 ConfigWebServer configWebServer;
 
+// Event bus consumer: drained by the async web task on each /api/events request
+#define WEB_RECENT_EVENTS 32
+static int8_t webEventSub = -1;
+static Event_t webRecentEvents[WEB_RECENT_EVENTS];
+static uint8_t webRecentHead = 0;
+static uint8_t webRecentCount = 0;
+
+// JSON API responses: each request renders into its own pooled arena, which
+// stays alive until the connection closes (the response is sent from it
+// asynchronously) and is then released in one piece
+#define WEB_RENDER_ARENA_SIZE  12288
+#define WEB_RENDER_ARENAS      2
+MEM_POOL_DEFINE(webRenderPool, "web", WEB_RENDER_ARENA_SIZE, WEB_RENDER_ARENAS);
+
+static unsigned long renderStartUs = 0;  // Async web task only
+
+static bool beginArenaRender(AsyncWebServerRequest *request, MemArena_t* arena) {
+  renderStartUs = micros();
+  void* block = memPoolAlloc(&webRenderPool);
+  if (block == nullptr) {
+    request->send(503, "application/json", "{\"error\":\"busy, retry\"}");
+    return false;
+  }
+  arenaInit(arena, block, WEB_RENDER_ARENA_SIZE);
+  return true;
+}
+
+static void sendArenaRender(AsyncWebServerRequest *request, int code, const char* contentType, MemArena_t* arena) {
+  void* block = arena->buffer;
+  if (arena->overflow) {
+    memPoolFree(&webRenderPool, block);
+    request->send(500, "application/json", "{\"error\":\"response too large\"}");
+    return;
+  }
+  request->onDisconnect([block]() { memPoolFree(&webRenderPool, block); });
+  request->send_P(code, contentType, (const uint8_t*)arena->buffer, arena->used);
+  recordLatency(LATENCY_WEB_REQUEST, micros() - renderStartUs);
+}
+
+static const char* jsonBool(bool value) {
+  return value ? "true" : "false";
+}
+
 // === CONSTRUCTOR & DESTRUCTOR ===
 
 ConfigWebServer::ConfigWebServer() 
@@ -91,6 +164,11 @@ bool ConfigWebServer::begin() {
   Serial.println("Starting configuration web server...");
   
   server = new AsyncWebServer(WEB_SERVER_PORT);
+  memPoolInit(&webRenderPool);
+  
+  webEventSub = subscribeEvents("web", EVENT_MASK(EVENT_MODULE_STATE_CHANGED) |
+                                       EVENT_MASK(EVENT_LIMITS_CHANGED) |
+                                       EVENT_MASK(EVENT_REGISTER_WRITTEN));
   
   // === ROUTE HANDLERS ===
   
@@ -172,6 +250,57 @@ bool ConfigWebServer::begin() {
     handleSystemStatusAPI(request);
   });
   
+  // CAN bus load per channel, protocol, node and CAN ID
+  server->on("/api/can/load", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    handleCANLoadAPI(request);
+  });
+  
+  // CAN dispatch slices (?replay=<frames>&bursts=<n>&channel=<c> replays a recent burst,
+  // ?dedup=0|1, ?dedup_types=<frame type mask>, ?dedup_reset=1 for duplicate payload suppression)
+  server->on("/api/can/dispatch", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    handleCANDispatchAPI(request);
+  });
+  
+  // CAN mapping rules (?reload=1 re-reads /can_rules.json, ?bench=<iterations> times the decoder)
+  server->on("/api/can/rules", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    handleCANRulesAPI(request);
+  });
+  
+  // DBC signal table (?id=<can id> lists one message's signals, ?verify=1 checks the BMS table)
+  server->on("/api/can/signals", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    handleCANSignalsAPI(request);
+  });
+  
+  // Virtual aggregated BMS (?enable=0|1, ?period=<ms>, ?channel=, ?extended=0|1, ?id190= ?id290= ?id510=, ?reset=1)
+  server->on("/api/vbms", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    handleVirtualBMSAPI(request);
+  });
+  
+  // Recent event bus traffic and queue statistics
+  server->on("/api/events", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    handleEventsAPI(request);
+  });
+  
+  // Soak metrics, Prometheus text format
+  server->on("/metrics", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    handleMetrics(request);
+  });
+  
+  // Main loop stalls ranked by source, with backtraces
+  server->on("/api/stalls", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    handleStallsAPI(request);
+  });
+  
+  // Log sink (?module=<name|all>&level=<none|error|warn|info|debug>, ?syslog=<host|off>&port=)
+  server->on("/api/log", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    handleLogAPI(request);
+  });
+  
+  // BMS SDO on-demand read API (?node=&index=&sub=&max_age=, no params = cache listing)
+  server->on("/api/bms/sdo", HTTP_GET, [this](AsyncWebServerRequest *request) {
+    handleBMSSdoAPI(request);
+  });
+  
   // 404 handler
   server->onNotFound([this](AsyncWebServerRequest *request) {
     handleNotFound(request);
@@ -243,7 +372,7 @@ String ConfigWebServer::generateMainPage() {
   html += "<div>";
   html += "<h3>BMS Status</h3>";
   html += "<p><strong>Active Batteries:</strong> " + String(systemConfig.activeBmsNodes) + "</p>";
-  html += "<p><strong>CAN Speed:</strong> " + String(systemConfig.canSpeed == CAN_500KBPS ? "500" : "125") + " kbps</p>";
+  html += "<p><strong>CAN Speed:</strong> " + String(getCANSpeedKbps(systemConfig.canSpeed)) + " kbps</p>";
   html += "<p><strong>Node IDs:</strong> ";
   for (int i = 0; i < systemConfig.activeBmsNodes; i++) {
     html += String(systemConfig.bmsNodeIds[i]);
@@ -388,8 +517,97 @@ String ConfigWebServer::generateCANMonitorPage() {
   // CAN Configuration Info
   html += "<h2>CAN Configuration</h2>";
   html += "<table>";
-  html += "<tr><td><strong>CAN Speed:</strong></td><td>" + String(systemConfig.canSpeed == CAN_500KBPS ? "500" : "125") + " kbps</td></tr>";
+  const BMSReconfigStats_t* reconfig = getBMSReconfigStats();
+  uint8_t configuredSpeed = getEffectiveCANSpeed(systemConfig.canSpeed);
+  html += "<tr><td><strong>CAN Speed:</strong></td><td>" + String(getCANSpeedKbps(reconfig->activeCanSpeed)) + " kbps";
+  if (reconfig->reinitFailed) {
+    html += " <span class='status error'>re-init at " + String(getCANSpeedKbps(reconfig->failedCanSpeed)) +
+            " kbps FAILED " + String((millis() - reconfig->lastFailureTime) / 1000) + " s ago, CAN down</span>";
+  } else if (isBMSReconfigurationPending() || reconfig->activeCanSpeed != configuredSpeed) {
+    html += " (configured " + String(getCANSpeedKbps(configuredSpeed)) + " kbps, pending)";
+  }
+  html += "</td></tr>";
   html += "<tr><td><strong>Active BMS Nodes:</strong></td><td>" + String(systemConfig.activeBmsNodes) + "</td></tr>";
+  html += "<tr><td><strong>Live Reconfigurations:</strong></td><td>" + String(reconfig->reconfigCount) +
+          " (CAN re-init: " + String(reconfig->canReinitCount) + ", failed: " + String(reconfig->failedReconfigCount) + ")</td></tr>";
+  html += "<tr><td><strong>Reconfig Downtime:</strong></td><td>last " + String(reconfig->lastDowntimeUs) +
+          " us, max " + String(reconfig->maxDowntimeUs) + " us</td></tr>";
+  html += "</table>";
+  
+  // Controller error state per channel (MCP2515 EFLG/TEC/REC, TWAI status)
+  html += "<h2>CAN Error Counters</h2>";
+  html += "<table>";
+  html += "<thead>";
+  html += "<tr><th>Channel</th><th>Error State</th><th>TEC / REC (peak)</th><th>Error Frames (est.)</th>"
+          "<th>Warning / Passive / Bus-off</th><th>Bus-off Recovery</th><th>RX Overflows</th></tr>";
+  html += "</thead>";
+  html += "<tbody>";
+  for (int ch = 0; ch < CAN_CHANNEL_COUNT; ch++) {
+    const CANChannelStats_t* s = getCANChannelStats(ch);
+    if (s->driver == CAN_DRIVER_NONE) continue;
+    const CANErrorStats_t* e = &s->errors;
+    html += "<tr><td>" + String(ch) + " (" + String(getCANDriverName(s->driver)) + ")</td>";
+    html += "<td>" + String(getCANErrorStateName(e->state)) + (e->recoveryActive ? " (recovering)" : "") + "</td>";
+    html += "<td>" + String(e->tec) + " / " + String(e->rec) + " (" + String(e->peakTec) + " / " + String(e->peakRec) + ")</td>";
+    html += "<td>" + String(e->errorFrameEstimate) + " (" + String(e->errorFrameRate, 2) + "/s)</td>";
+    html += "<td>" + String(e->warningCount) + " / " + String(e->errorPassiveCount) + " / " + String(e->busOffCount) + "</td>";
+    html += "<td>" + String(e->recoveries) + " recovered, " + String(e->recoveryAttempts) + " attempts (" +
+            String(e->failedRecoveries) + " failed), last " + String(e->lastRecoveryMs) + " ms, max " +
+            String(e->maxRecoveryMs) + " ms</td>";
+    html += "<td>" + String(e->rxOverflowCount) + "</td></tr>";
+  }
+  html += "</tbody>";
+  html += "</table>";
+  
+  // Per-channel traffic (primary MCP2515 + optional second controller)
+  html += "<h2>CAN Channels</h2>";
+  html += "<table>";
+  html += "<thead>";
+  html += "<tr><th>Channel</th><th>Driver</th><th>Protocols</th><th>RX / TX</th><th>Errors (read / TX)</th>"
+          "<th>Ring (peak)</th><th>Overflows</th><th>Load (peak)</th></tr>";
+  html += "</thead>";
+  html += "<tbody>";
+  for (int ch = 0; ch < CAN_CHANNEL_COUNT; ch++) {
+    const CANChannelStats_t* s = getCANChannelStats(ch);
+    if (s->driver == CAN_DRIVER_NONE) continue;
+    String protocols = "";
+    for (int p = 0; p < CAN_PROTOCOL_COUNT; p++) {
+      if (getCANProtocolChannel((CANProtocol_t)p) != ch) continue;
+      if (protocols.length() > 0) protocols += ", ";
+      protocols += getCANProtocolName(p);
+    }
+    html += "<tr><td>" + String(ch) + (s->initialized ? "" : " (down)") + "</td>";
+    html += "<td>" + String(getCANDriverName(s->driver)) + " " + String(s->bitrateKbps) + " kbps</td>";
+    html += "<td>" + (protocols.length() > 0 ? protocols : String("-")) + "</td>";
+    html += "<td>" + String(s->rxFrames) + " / " + String(s->txFrames) + "</td>";
+    html += "<td>" + String(s->rxReadErrors) + " / " + String(s->txErrors) + "</td>";
+    html += "<td>" + String(s->ringDepth) + " (" + String(s->ringPeakDepth) + ")</td>";
+    html += "<td>" + String(s->ringOverflows) + "</td>";
+    html += "<td>" + String(s->utilisation, 1) + "% (" + String(s->peakUtilisation, 1) + "%)</td></tr>";
+  }
+  html += "</tbody>";
+  html += "</table>";
+  html += "<p>Single-bus equivalent load: " + String(getCANCombinedUtilisation(), 1) + "%</p>";
+  
+  // Sliding-window load per protocol (per ID and node: /api/can/load)
+  html += "<h2>CAN Load</h2>";
+  html += "<table>";
+  html += "<thead>";
+  html += "<tr><th>Protocol</th><th>Channel</th><th>Load now</th><th>Load " + String(CAN_LOAD_WINDOW_BUCKETS) +
+          "s</th><th>Poll bursts (deferred)</th></tr>";
+  html += "</thead>";
+  html += "<tbody>";
+  for (int p = 0; p < CAN_PROTOCOL_COUNT; p++) {
+    const CANLoadProtocolStats_t* s = getCANLoadProtocolStats(p);
+    uint8_t ch = getCANProtocolChannel((CANProtocol_t)p);
+    const CANLoadChannelStats_t* chLoad = getCANLoadChannelStats(ch);
+    html += "<tr><td>" + String(getCANProtocolName(p)) + "</td>";
+    html += "<td>" + String(ch) + (chLoad->alertActive ? " (ALERT)" : "") + "</td>";
+    html += "<td>" + String(s->loadNow, 1) + "%</td>";
+    html += "<td>" + String(s->loadWindow, 1) + "%</td>";
+    html += "<td>" + String(s->admitted) + " (" + String(s->deferred) + ")</td></tr>";
+  }
+  html += "</tbody>";
   html += "</table>";
   
   // Frame Address Mapping
@@ -664,6 +882,38 @@ String ConfigWebServer::generateTrioHPConfigPage() {
   html += "<small>Percentage of BMS DCCL/DDCL to use as safety limit</small>";
   html += "</div>";
   
+  // System parameters - generated from the TRIO HP parameter table
+  html += "<h2>System Parameters</h2>";
+  html += "<div class='grid'>";
+  for (uint8_t i = 0; i < getTrioParamCount(); i++) {
+    const TrioParamDescriptor_t* param = getTrioParamByIndex(i);
+    float value;
+    if (!getTrioParam(param, &value)) continue;  // Runtime commands have no form field
+    
+    bool locked = isTrioParamLocked(param);
+    html += "<div class='form-group'>";
+    html += "<label>" + String(param->name);
+    if (param->unit[0] != '\0') html += " (" + String(param->unit) + ")";
+    html += ":</label>";
+    if (param->type == TRIO_PARAM_TYPE_BOOL) {
+      html += "<select name='" + String(param->name) + "'" + String(locked ? " disabled" : "") + ">";
+      html += "<option value='1'" + String(value != 0.0f ? " selected" : "") + ">Enabled</option>";
+      html += "<option value='0'" + String(value == 0.0f ? " selected" : "") + ">Disabled</option>";
+      html += "</select>";
+    } else {
+      bool isFloat = (param->type == TRIO_PARAM_TYPE_FLOAT);
+      html += "<input type='number' name='" + String(param->name) + "'";
+      html += " min='" + String(param->minValue, isFloat ? 1 : 0) + "'";
+      html += " max='" + String(param->maxValue, isFloat ? 1 : 0) + "'";
+      html += " step='" + String(isFloat ? "0.1" : "1") + "'";
+      html += " value='" + String(value, isFloat ? 2 : 0) + "'";
+      html += String(locked ? " disabled" : "") + ">";
+    }
+    if (locked) html += "<small>Locked (" + String(getTrioParamLockClassName(param->lockClass)) + ")</small>";
+    html += "</div>";
+  }
+  html += "</div>";
+  
   html += "<button type='submit' class='btn'>Save Configuration</button>";
   html += "</form>";
   
@@ -732,51 +982,34 @@ String ConfigWebServer::generateTrioHPEfficiencyPage() {
   return html;
 }
 
-String ConfigWebServer::generateTrioHPDataJSON() {
-  String json = "{";
-  
+void ConfigWebServer::renderTrioHPDataJSON(MemArena_t* arena) {
   // System status
   const TrioSystemStatus_t* systemStatus = getSystemStatus();
   const TrioEfficiencyMonitor_t* effMonitor = getEfficiencyMonitorStatus();
-  json += "\"system_status\":{";
-  json += "\"operational\":" + String((systemStatus->systemState == TRIO_SYSTEM_OPERATIONAL) ? "true" : "false") + ",";
-  json += "\"active_modules\":" + String(systemStatus->activeModules) + ",";
-  json += "\"safety_ok\":" + String((systemStatus->systemHealth > 80) ? "true" : "false") + ",";
-  json += "\"ac_active_power\":" + String(effMonitor->ac_active_power) + ",";
-  json += "\"ac_apparent_power\":" + String(effMonitor->ac_apparent_power) + ",";
-  json += "\"dc_power\":" + String(effMonitor->dc_power) + ",";
-  json += "\"active_efficiency\":" + String(effMonitor->active_efficiency);
-  json += "},";
+  arenaAppendf(arena, "{\"system_status\":{\"operational\":%s,\"active_modules\":%u,\"safety_ok\":%s,"
+               "\"ac_active_power\":%.2f,\"ac_apparent_power\":%.2f,\"dc_power\":%.2f,\"active_efficiency\":%.2f},",
+               jsonBool(systemStatus->systemState == TRIO_SYSTEM_OPERATIONAL), systemStatus->activeModules,
+               jsonBool(systemStatus->systemHealth > 80), effMonitor->ac_active_power,
+               effMonitor->ac_apparent_power, effMonitor->dc_power, effMonitor->active_efficiency);
   
   // Safety limits
   const TrioHPLimits_t* limits = getCurrentBMSLimits();
-  json += "\"safety_limits\":{";
-  json += "\"dccl_limit\":" + String(limits->dccl_bms * limits->dccl_threshold) + ",";
-  json += "\"ddcl_limit\":" + String(limits->ddcl_bms * limits->ddcl_threshold) + ",";
-  json += "\"limits_valid\":" + String(limits->limits_valid ? "true" : "false");
-  json += "},";
+  arenaAppendf(arena, "\"safety_limits\":{\"dccl_limit\":%.2f,\"ddcl_limit\":%.2f,\"limits_valid\":%s},",
+               limits->dccl_bms * limits->dccl_threshold, limits->ddcl_bms * limits->ddcl_threshold,
+               jsonBool(limits->limits_valid));
   
   // Digital inputs
   const TrioHPDigitalInputs_t* inputs = getCurrentDigitalInputs();
-  json += "\"digital_inputs\":{";
-  json += "\"estop_active\":" + String(inputs->estop_active ? "true" : "false") + ",";
-  json += "\"ac_contactor\":" + String(inputs->ac_contactor ? "true" : "false");
-  json += "},";
+  arenaAppendf(arena, "\"digital_inputs\":{\"estop_active\":%s,\"ac_contactor\":%s},",
+               jsonBool(inputs->estop_active), jsonBool(inputs->ac_contactor));
   
   // Efficiency data
   const TrioEfficiencyMonitor_t* effData = getEfficiencyMonitorStatus();
-  json += "\"efficiency\":{";
-  json += "\"instantaneous\":" + String(effData->active_efficiency) + ",";
-  json += "\"ac_power\":" + String(effData->ac_active_power) + ",";
-  json += "\"dc_power\":" + String(effData->dc_power) + ",";
-  json += "\"cumulative_ac_energy\":" + String(effData->energy_counters.total_ac_active_energy) + ",";
-  json += "\"cumulative_dc_energy\":" + String(effData->energy_counters.total_dc_energy) + ",";
-  json += "\"monitoring_active\":" + String(effData->energy_counters.energy_counting_enabled ? "true" : "false");
-  json += "}";
-  
-  json += "}";
-  
-  return json;
+  arenaAppendf(arena, "\"efficiency\":{\"instantaneous\":%.2f,\"ac_power\":%.2f,\"dc_power\":%.2f,"
+               "\"cumulative_ac_energy\":%.2f,\"cumulative_dc_energy\":%.2f,\"monitoring_active\":%s}}",
+               effData->active_efficiency, effData->ac_active_power, effData->dc_power,
+               effData->energy_counters.total_ac_active_energy, effData->energy_counters.total_dc_energy,
+               jsonBool(effData->energy_counters.energy_counting_enabled));
 }
 
 // === REQUEST HANDLERS ===
@@ -830,7 +1063,7 @@ void ConfigWebServer::handleBMSConfig(AsyncWebServerRequest *request) {
 
 void ConfigWebServer::handleBMSSave(AsyncWebServerRequest *request) {
   int batteryCount = 0;
-  uint8_t canSpeed = CAN_500KBPS; // Default to 500 kbps
+  uint8_t canSpeed = systemConfig.canSpeed; // Keep current speed if not submitted
   
   if (request->hasParam("battery_count", true)) {
     batteryCount = request->getParam("battery_count", true)->value().toInt();
@@ -871,21 +1104,16 @@ void ConfigWebServer::handleBMSSave(AsyncWebServerRequest *request) {
     return;
   }
   
-  // Save configuration
-  systemConfig.activeBmsNodes = batteryCount;
-  systemConfig.canSpeed = canSpeed;
-  for (int i = 0; i < batteryCount; i++) {
-    systemConfig.bmsNodeIds[i] = newBmsIds[i];
-  }
-  
-  if (saveConfiguration()) {
-    String response = "BMS configuration saved!<br>";
+  // Applied live by the main loop (no restart) and persisted to EEPROM there
+  if (requestBMSReconfiguration(newBmsIds, batteryCount, canSpeed, true)) {
+    String response = "BMS configuration saved - live reconfiguration scheduled (no restart needed)<br>";
     response += "Batteries: " + String(batteryCount) + "<br>";
-    response += "CAN Speed: " + String(canSpeed == CAN_500KBPS ? "500" : "125") + " kbps<br>";
+    response += "CAN Speed: " + String(getCANSpeedKbps(canSpeed)) + " kbps<br>";
+    response += "<a href='/can'>CAN monitor (applied speed and reconfiguration result)</a> | ";
     response += "<a href='/bms'>Back to BMS config</a> | <a href='/'>Home</a>";
     request->send(200, "text/html", response);
   } else {
-    request->send(500, "text/plain", "Failed to save configuration");
+    request->send(500, "text/plain", "Failed to apply configuration");
   }
 }
 
@@ -903,7 +1131,25 @@ void ConfigWebServer::handleConfigExport(AsyncWebServerRequest *request) {
   json += "\"device\":\"" + String(DEVICE_NAME) + "\",";
   json += "\"wifi_ssid\":\"" + String(systemConfig.wifiSSID) + "\",";
   json += "\"battery_count\":" + String(systemConfig.activeBmsNodes) + ",";
-  json += "\"can_speed\":" + String(systemConfig.canSpeed) + "";
+  json += "\"can_speed\":" + String(systemConfig.canSpeed) + ",";
+  
+  // TRIO HP parameters - generated from the parameter table
+  json += "\"trio_hp\":{";
+  bool first = true;
+  for (uint8_t i = 0; i < getTrioParamCount(); i++) {
+    const TrioParamDescriptor_t* param = getTrioParamByIndex(i);
+    float value;
+    if (!getTrioParam(param, &value)) continue;
+    if (!first) json += ",";
+    json += "\"" + String(param->name) + "\":";
+    if (param->type == TRIO_PARAM_TYPE_BOOL) {
+      json += String(value != 0.0f ? "true" : "false");
+    } else {
+      json += String(value, param->type == TRIO_PARAM_TYPE_FLOAT ? 2 : 0);
+    }
+    first = false;
+  }
+  json += "}";
   json += "}";
   
   AsyncWebServerResponse *response = request->beginResponse(200, "application/json", json);
@@ -932,14 +1178,41 @@ void ConfigWebServer::handleTrioHPConfig(AsyncWebServerRequest *request) {
 }
 
 void ConfigWebServer::handleTrioHPConfigSave(AsyncWebServerRequest *request) {
-  String response = "TRIO HP configuration saved!<br>";
+  uint8_t applied = 0;
+  String rejected = "";
+  
+  for (uint8_t i = 0; i < getTrioParamCount(); i++) {
+    const TrioParamDescriptor_t* param = getTrioParamByIndex(i);
+    if (!request->hasParam(param->name, true)) continue;
+    
+    float oldValue;
+    float newValue = request->getParam(param->name, true)->value().toFloat();
+    if (!getTrioParam(param, &oldValue) || oldValue == newValue) continue;
+    
+    if (setTrioParam(param, newValue)) {
+      applied++;
+    } else {
+      rejected += String(param->name) + " ";
+    }
+  }
+  
+  if (applied > 0) {
+    saveTrioHPConfig();
+  }
+  
+  String response = "TRIO HP configuration saved! (" + String(applied) + " parameters changed)<br>";
+  if (rejected.length() > 0) {
+    response += "Rejected (locked or out of range): " + rejected + "<br>";
+  }
   response += "<a href='/trio-hp/config'>Back to TRIO HP Config</a> | <a href='/trio-hp'>Dashboard</a>";
   request->send(200, "text/html", response);
 }
 
 void ConfigWebServer::handleTrioHPAPI(AsyncWebServerRequest *request) {
-  String json = generateTrioHPDataJSON();
-  request->send(200, "application/json", json);
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
+  renderTrioHPDataJSON(&arena);
+  sendArenaRender(request, 200, "application/json", &arena);
 }
 
 void ConfigWebServer::handleTrioHPEfficiency(AsyncWebServerRequest *request) {
@@ -947,33 +1220,662 @@ void ConfigWebServer::handleTrioHPEfficiency(AsyncWebServerRequest *request) {
 }
 
 void ConfigWebServer::handleSystemStatusAPI(AsyncWebServerRequest *request) {
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
   SystemStatusData_t data = collectSystemStatusData();
   
-  String json = "{";
-  json += "\"system\":{";
-  json += "\"cpu\":" + String(data.cpuUsage, 1) + ",";
-  json += "\"free_memory\":" + String(data.freeMemory) + ",";
-  json += "\"total_memory\":" + String(data.totalMemory);
-  json += "},";
-  
-  json += "\"battery\":{";
-  json += "\"soc\":" + String(data.batterySoC, 1) + ",";
-  json += "\"current\":" + String(data.batteryCurrent, 1) + ",";
-  json += "\"charging_limit\":" + String(data.chargingLimit, 0) + ",";
-  json += "\"discharging_limit\":" + String(data.dischargingLimit, 0);
-  json += "},";
+  arenaAppendf(&arena, "{\"system\":{\"cpu\":%.1f,\"free_memory\":%lu,\"total_memory\":%lu},",
+               data.cpuUsage, (unsigned long)data.freeMemory, (unsigned long)data.totalMemory);
+  
+  arenaAppendf(&arena, "\"battery\":{\"soc\":%.1f,\"current\":%.1f,\"charging_limit\":%.0f,\"discharging_limit\":%.0f},",
+               data.batterySoC, data.batteryCurrent, data.chargingLimit, data.dischargingLimit);
+  
+  arenaAppendf(&arena, "\"trio_hp\":{\"target_active_power\":%.0f,\"actual_active_power\":%.0f,"
+               "\"target_reactive_power\":%.0f,\"actual_reactive_power\":%.0f},",
+               data.targetActivePower, data.actualActivePower, data.targetReactivePower, data.actualReactivePower);
+  
+  const BMSReconfigStats_t* reconfig = getBMSReconfigStats();
+  arenaAppendf(&arena, "\"can\":{\"active_kbps\":%u,\"reinit_failed\":%s,\"failed_reinits\":%lu,"
+               "\"combined_utilisation\":%.1f,\"channels\":[", getCANSpeedKbps(reconfig->activeCanSpeed),
+               jsonBool(reconfig->reinitFailed), reconfig->failedReconfigCount, getCANCombinedUtilisation());
+  for (int ch = 0; ch < CAN_CHANNEL_COUNT; ch++) {
+    const CANChannelStats_t* s = getCANChannelStats(ch);
+    const CANErrorStats_t* e = &s->errors;
+    arenaAppendf(&arena, "%s{\"driver\":\"%s\",\"up\":%s,\"kbps\":%u,\"rx\":%lu,\"tx\":%lu,\"read_errors\":%lu,"
+                 "\"tx_errors\":%lu,\"ring_overflows\":%lu,\"ring_peak\":%u,\"utilisation\":%.1f,\"peak_utilisation\":%.1f,",
+                 ch > 0 ? "," : "", getCANDriverName(s->driver), jsonBool(s->initialized), s->bitrateKbps,
+                 s->rxFrames, s->txFrames, s->rxReadErrors, s->txErrors, s->ringOverflows, s->ringPeakDepth,
+                 s->utilisation, s->peakUtilisation);
+    arenaAppendf(&arena, "\"error_state\":\"%s\",\"tec\":%u,\"rec\":%u,\"error_frames\":%lu,\"error_frame_rate\":%.2f,"
+                 "\"error_passive_count\":%lu,\"bus_off_count\":%lu,\"recovering\":%s,\"recoveries\":%lu,"
+                 "\"recovery_attempts\":%lu,\"last_recovery_ms\":%lu,\"max_recovery_ms\":%lu,\"rx_overflows\":%lu}",
+                 getCANErrorStateName(e->state), e->tec, e->rec, e->errorFrameEstimate, e->errorFrameRate,
+                 e->errorPassiveCount, e->busOffCount, jsonBool(e->recoveryActive), e->recoveries,
+                 e->recoveryAttempts, e->lastRecoveryMs, e->maxRecoveryMs, e->rxOverflowCount);
+  }
+  arenaAppendf(&arena, "],\"bms_channel\":%u,\"trio_channel\":%u},",
+               getCANProtocolChannel(CAN_PROTOCOL_BMS), getCANProtocolChannel(CAN_PROTOCOL_TRIO));
   
-  json += "\"trio_hp\":{";
-  json += "\"target_active_power\":" + String(data.targetActivePower, 0) + ",";
-  json += "\"actual_active_power\":" + String(data.actualActivePower, 0) + ",";
-  json += "\"target_reactive_power\":" + String(data.targetReactivePower, 0) + ",";
-  json += "\"actual_reactive_power\":" + String(data.actualReactivePower, 0);
-  json += "},";
+  arenaAppendf(&arena, "\"timestamp\":%lu}", data.lastUpdate);
   
-  json += "\"timestamp\":" + String(data.lastUpdate);
-  json += "}";
+  sendArenaRender(request, 200, "application/json", &arena);
+}
+
+static void renderBMSSdoEntryJSON(MemArena_t* arena, const BMSSdoEntry_t& e, unsigned long maxAgeMs) {
+  unsigned long age = millis() - e.validAt;
+  arenaAppendf(arena, "{\"node\":%u,\"index\":%u,\"sub\":%u,\"status\":\"%s\",\"fresh\":%s,",
+               e.nodeId, e.index, e.subIndex, getBMSSdoStatusName(e.status),
+               jsonBool(e.everValid && age <= maxAgeMs));
+  if (e.everValid) {
+    arenaAppendf(arena, "\"age_ms\":%lu,", age);
+  } else {
+    arenaAppend(arena, "\"age_ms\":null,");
+  }
+  arenaAppendf(arena, "\"length\":%u,\"data\":\"", e.everValid ? e.length : 0);
+  for (int i = 0; e.everValid && i < e.length; i++) {
+    arenaAppendf(arena, "%02X", e.data[i]);
+  }
+  arenaAppend(arena, "\",");
+  if (e.everValid && e.length <= 4) {
+    uint32_t value = 0;
+    for (int i = e.length - 1; i >= 0; i--) value = (value << 8) | e.data[i];
+    arenaAppendf(arena, "\"value\":%lu,", (unsigned long)value);
+  }
+  arenaAppendf(arena, "\"abort_code\":\"0x%08lX\"}", (unsigned long)e.abortCode);
+}
+
+void ConfigWebServer::handleBMSSdoAPI(AsyncWebServerRequest *request) {
+  // Without an object: statistics and cache listing
+  if (!request->hasParam("node") || !request->hasParam("index")) {
+    MemArena_t arena;
+    if (!beginArenaRender(request, &arena)) return;
+    BMSSdoStats_t stats;
+    getBMSSdoStats(&stats);
+    
+    arenaAppendf(&arena, "{\"stats\":{\"requests\":%lu,\"cache_hits\":%lu,\"expedited\":%lu,\"segmented\":%lu,"
+                 "\"aborts\":%lu,\"timeouts\":%lu,\"last_latency_ms\":%lu,\"avg_latency_ms\":%lu,"
+                 "\"max_latency_ms\":%lu,\"queued\":%u,\"in_flight\":%u},\"objects\":[",
+                 stats.requests, stats.cacheHits, stats.expeditedReads, stats.segmentedReads,
+                 stats.aborts, stats.timeouts, stats.lastLatencyMs, stats.avgLatencyMs,
+                 stats.maxLatencyMs, stats.queued, stats.inFlight);
+    
+    BMSSdoEntry_t entry;
+    bool first = true;
+    for (uint8_t i = 0; i < BMS_SDO_CACHE_SIZE; i++) {
+      if (!getBMSSdoEntryAt(i, &entry)) continue;
+      if (!first) arenaAppend(&arena, ",");
+      renderBMSSdoEntryJSON(&arena, entry, BMS_SDO_DEFAULT_MAX_AGE_MS);
+      first = false;
+    }
+    arenaAppend(&arena, "]}");
+    
+    sendArenaRender(request, 200, "application/json", &arena);
+    return;
+  }
+  
+  // Index/sub accept decimal or 0x-prefixed hex
+  uint8_t nodeId = request->getParam("node")->value().toInt();
+  uint16_t index = strtoul(request->getParam("index")->value().c_str(), nullptr, 0);
+  uint8_t subIndex = request->hasParam("sub") ? strtoul(request->getParam("sub")->value().c_str(), nullptr, 0) : 0;
+  unsigned long maxAgeMs = request->hasParam("max_age") ?
+                           request->getParam("max_age")->value().toInt() : BMS_SDO_DEFAULT_MAX_AGE_MS;
+  
+  if (!requestBMSSdoRead(nodeId, index, subIndex, maxAgeMs)) {
+    request->send(400, "application/json", "{\"error\":\"unknown node or SDO queue full\"}");
+    return;
+  }
+  
+  // 200 with a fresh value, 202 while the read is in progress (poll again)
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
+  BMSSdoEntry_t entry;
+  getBMSSdoEntry(nodeId, index, subIndex, &entry);
+  renderBMSSdoEntryJSON(&arena, entry, maxAgeMs);
+  sendArenaRender(request, entry.status == BMS_SDO_STATUS_PENDING ? 202 : 200, "application/json", &arena);
+}
+
+void ConfigWebServer::handleCANDispatchAPI(AsyncWebServerRequest *request) {
+  // Burst replay: worst zone gaps restart so they show the subsystems' latency under the burst
+  if (request->hasParam("replay")) {
+    uint8_t channel = request->hasParam("channel") ? request->getParam("channel")->value().toInt() : CAN_CHANNEL_PRIMARY;
+    uint8_t frames = request->getParam("replay")->value().toInt();
+    uint16_t bursts = request->hasParam("bursts") ? request->getParam("bursts")->value().toInt() : 1;
+    if (!requestCANBurstReplay(channel, frames, bursts)) {
+      request->send(400, "application/json", "{\"error\":\"channel unavailable or frames not 1-63\"}");
+      return;
+    }
+    resetProfileZoneGaps();
+  }
+  
+  // Duplicate suppression on/off against the same replayed traffic shows the saving
+  if (request->hasParam("dedup")) setBMSDedupEnabled(request->getParam("dedup")->value().toInt() != 0);
+  if (request->hasParam("dedup_types")) {
+    setBMSDedupTypes(strtoul(request->getParam("dedup_types")->value().c_str(), nullptr, 0));
+  }
+  if (request->hasParam("dedup_reset")) resetBMSDedupStats();
+  
+  const CANSliceStats_t* s = getCANSliceStats();
+  const StallStats_t* stall = getStallStats();
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
+  
+  arenaAppendf(&arena, "{\"budget\":{\"min_frames\":%d,\"max_frames\":%d,\"time_us\":%d},"
+               "\"slices\":%lu,\"frames\":%lu,\"frame_limit_hits\":%lu,\"time_limit_hits\":%lu,"
+               "\"backlog_slices\":%lu,\"last_budget\":%u,\"backlog\":%u,\"peak_backlog\":%u,"
+               "\"last_slice_us\":%lu,\"max_slice_us\":%lu,\"channels\":[",
+               CAN_SLICE_MIN_FRAMES, CAN_SLICE_MAX_FRAMES, CAN_SLICE_BUDGET_US,
+               s->slices, s->framesDispatched, s->frameLimitHits, s->timeLimitHits,
+               s->backlogSlices, s->lastFrameBudget, s->lastBacklog, s->peakBacklog,
+               s->lastSliceUs, s->maxSliceUs);
+  for (int ch = 0; ch < CAN_CHANNEL_COUNT; ch++) {
+    const CANChannelStats_t* c = getCANChannelStats(ch);
+    arenaAppendf(&arena, "%s{\"channel\":%d,\"ring\":%u,\"peak\":%u,\"overflows\":%lu,\"replayed\":%lu}",
+                 ch > 0 ? "," : "", ch, canBusBacklog(ch), c->ringPeakDepth, c->ringOverflows, c->replayedFrames);
+  }
+  
+  // Subsystem service latency (worst gap between two loop visits)
+  arenaAppend(&arena, "],\"max_gap_us\":{");
+  const uint8_t zones[] = { PROFILE_ZONE_LOOP, PROFILE_ZONE_CAN, PROFILE_ZONE_TRIO_HP, PROFILE_ZONE_WIFI, PROFILE_ZONE_MODBUS };
+  for (uint8_t i = 0; i < sizeof(zones); i++) {
+    arenaAppendf(&arena, "%s\"%s\":%lu", i > 0 ? "," : "", getProfileZoneName(zones[i]), stall->zoneMaxGapUs[zones[i]]);
+  }
+  
+  // Parsed vs suppressed per frame type; saved_us excludes the skipped Modbus remaps
+  const BMSDedupStats_t* d = getBMSDedupStats();
+  static const char* frameNames[BMS_FRAME_TYPE_COUNT] = { "190", "290", "310", "390", "410", "510", "490", "1B0", "710" };
+  arenaAppendf(&arena, "},\"dedup\":{\"enabled\":%s,\"types\":%u,\"reparse_ms\":%d,\"timing_sample\":%d,"
+               "\"mean_suppressed_us\":%.2f,\"saved_us\":%lu,\"frames\":{",
+               jsonBool(d->enabled), d->typeMask, BMS_DEDUP_REPARSE_MS, BMS_DEDUP_TIMING_SAMPLE,
+               d->suppressedSamples > 0 ? (float)d->suppressedUs / d->suppressedSamples : 0.0f, d->savedUs);
+  bool first = true;
+  for (uint8_t t = 0; t < BMS_FRAME_TYPE_COUNT; t++) {
+    if (d->parsed[t] == 0 && d->suppressed[t] == 0) continue;
+    float parseUs = d->parseSamples[t] > 0 ? (float)d->parseUs[t] / d->parseSamples[t] : 0.0f;
+    arenaAppendf(&arena, "%s\"%s\":{\"parsed\":%lu,\"suppressed\":%lu,\"mean_parse_us\":%.2f}",
+                 first ? "" : ",", frameNames[t], d->parsed[t], d->suppressed[t], parseUs);
+    first = false;
+  }
+  arenaAppend(&arena, "}}}");
+  
+  sendArenaRender(request, 200, "application/json", &arena);
+}
+
+void ConfigWebServer::handleCANRulesAPI(AsyncWebServerRequest *request) {
+  // Reload runs in the main loop between frames; the response shows the previous load
+  bool reloadRequested = request->hasParam("reload");
+  if (reloadRequested) requestCANRulesReload();
+  
+  CANRulesBenchmark_t bench;
+  bool benchRun = false;
+  if (request->hasParam("bench")) {
+    long iterations = request->getParam("bench")->value().toInt();
+    if (iterations <= 0 || !benchmarkCANRules(iterations, &bench)) {
+      request->send(400, "application/json", "{\"error\":\"bench needs 1-1000000 iterations\"}");
+      return;
+    }
+    benchRun = true;
+  }
+  
+  const CANRulesStats_t* s = getCANRulesStats();
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
+  
+  arenaAppendf(&arena, "{\"file\":\"%s\",\"reload_requested\":%s,\"loads\":%lu,\"load_errors\":%lu,"
+               "\"last_error\":\"%s\",\"ids\":%u,\"masks\":%u,\"max_probe\":%u,"
+               "\"frames_matched\":%lu,\"fields_decoded\":%lu,\"rules\":[",
+               CAN_RULES_FILE, jsonBool(reloadRequested), s->loads, s->loadErrors, s->lastError,
+               s->ids, s->masks, s->maxProbe, s->framesMatched, s->fieldsDecoded);
+  for (uint8_t i = 0; i < getCANRuleCount(); i++) {
+    CANRuleInfo_t r;
+    if (!getCANRuleInfo(i, &r)) break;
+    arenaAppendf(&arena, "%s{\"name\":\"%s\",\"id\":%lu,\"mask\":%lu,\"extended\":%s,\"byte\":%u,"
+                 "\"bit\":%u,\"length\":%u,\"endian\":\"%s\",\"signed\":%s,\"scale\":%g,"
+                 "\"offset\":%g,\"register\":%u,\"hits\":%lu}",
+                 i > 0 ? "," : "", r.name, (unsigned long)r.id, (unsigned long)r.mask, jsonBool(r.extended),
+                 r.byte, r.bit, r.length, r.bigEndian ? "big" : "little", jsonBool(r.isSigned),
+                 r.scale, r.offset, r.reg, r.hits);
+  }
+  arenaAppend(&arena, "]");
+  
+  if (benchRun) {
+    arenaAppendf(&arena, ",\"bench\":{\"iterations\":%lu,\"hand_ns\":%.1f,\"rules_ns\":%.1f,"
+                 "\"ratio\":%.2f,\"outputs_match\":%s}",
+                 (unsigned long)bench.iterations, bench.handNsPerFrame, bench.rulesNsPerFrame,
+                 bench.ratio, jsonBool(bench.outputsMatch));
+  }
+  arenaAppend(&arena, "}");
+  
+  sendArenaRender(request, 200, "application/json", &arena);
+}
+
+void ConfigWebServer::handleCANSignalsAPI(AsyncWebServerRequest *request) {
+  const SignalTable_t* table = getCANSignalTable();
+  const SignalMessage_t* message = nullptr;
+  if (request->hasParam("id")) {
+    String idText = request->getParam("id")->value();
+    uint32_t id = strtoul(idText.c_str(), nullptr, 0);
+    bool extended = request->hasParam("extended") || id > 0x7FF;
+    message = table != nullptr ? findSignalMessage(table, id, extended) : nullptr;
+    if (message == nullptr) {
+      request->send(404, "application/json", "{\"error\":\"message not in the signal table\"}");
+      return;
+    }
+  }
+  
+  SignalVerifyResult_t check;
+  bool checkRun = request->hasParam("verify");
+  if (checkRun) verifyBMSSignalTable(&check);
+  
+  const CANSignalsStats_t* s = getCANSignalsStats();
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
+  
+  arenaAppendf(&arena, "{\"file\":\"%s\",\"loaded\":%s,\"messages\":%u,\"signals\":%u,\"bytes\":%lu,"
+               "\"frames_decoded\":%lu,\"signals_decoded\":%lu,\"out_of_range\":%lu,\"last_error\":\"%s\"",
+               SIGNAL_TABLE_FILE, jsonBool(s->loaded), s->messages, s->signals, (unsigned long)s->tableBytes,
+               s->framesDecoded, s->signalsDecoded, s->outOfRange, s->lastError);
+  
+  if (checkRun) {
+    arenaAppendf(&arena, ",\"bms_check\":{\"checks\":%lu,\"mismatches\":%lu,\"first_mismatch\":\"%s\"}",
+                 (unsigned long)check.checks, (unsigned long)check.mismatches, check.firstMismatch);
+  }
+  
+  if (message != nullptr) {
+    // One message: its signals with the last decoded values (null = not decoded yet / other mux)
+    arenaAppendf(&arena, ",\"id\":%lu,\"extended\":%s,\"dlc\":%u,\"values\":[",
+                 (unsigned long)(message->id & ~SIGNAL_ID_EXTENDED), jsonBool(message->id & SIGNAL_ID_EXTENDED),
+                 message->dlc);
+    for (uint8_t i = 0; i < message->signalCount; i++) {
+      uint16_t index = message->firstSignal + i;
+      float value = getCANSignalValue(index);
+      if (isnan(value)) {
+        arenaAppendf(&arena, "%s{\"name\":\"%s\",\"value\":null}", i > 0 ? "," : "", getSignalName(table, index));
+      } else {
+        arenaAppendf(&arena, "%s{\"name\":\"%s\",\"value\":%g}", i > 0 ? "," : "", getSignalName(table, index), value);
+      }
+    }
+    arenaAppend(&arena, "]");
+  } else if (table != nullptr) {
+    arenaAppend(&arena, ",\"message_ids\":[");
+    for (uint16_t m = 0; m < table->header->messageCount; m++) {
+      arenaAppendf(&arena, "%s%lu", m > 0 ? "," : "", (unsigned long)table->messages[m].id);
+    }
+    arenaAppend(&arena, "]");
+  }
+  arenaAppend(&arena, "}");
+  
+  sendArenaRender(request, 200, "application/json", &arena);
+}
+
+void ConfigWebServer::handleVirtualBMSAPI(AsyncWebServerRequest *request) {
+  // Any setting in the query: validate the whole set, persist, restart the schedule
+  VirtualBMSConfig_t config = *getVirtualBMSConfig();
+  bool changed = false;
+  if (request->hasParam("enable")) {
+    config.enabled = request->getParam("enable")->value().toInt() != 0;
+    changed = true;
+  }
+  if (request->hasParam("period")) {
+    config.periodMs = request->getParam("period")->value().toInt();
+    changed = true;
+  }
+  if (request->hasParam("channel")) {
+    config.channel = request->getParam("channel")->value().toInt();
+    changed = true;
+  }
+  if (request->hasParam("extended")) {
+    config.extended = request->getParam("extended")->value().toInt() != 0;
+    changed = true;
+  }
+  const char* idParams[VBMS_FRAME_COUNT] = { "id190", "id290", "id510" };
+  for (uint8_t f = 0; f < VBMS_FRAME_COUNT; f++) {
+    if (request->hasParam(idParams[f])) {
+      config.ids[f] = strtoul(request->getParam(idParams[f])->value().c_str(), nullptr, 0);
+      changed = true;
+    }
+  }
+  if (changed && !setVirtualBMSConfig(&config)) {
+    request->send(400, "application/json",
+                  "{\"error\":\"invalid settings (period 20-5000 ms, distinct IDs in range, outside the BMS node ranges)\"}");
+    return;
+  }
+  if (request->hasParam("reset")) resetVirtualBMSStats();
+  
+  const VirtualBMSConfig_t* c = getVirtualBMSConfig();
+  const VirtualBMSAggregate_t* a = getVirtualBMSAggregate();
+  const VirtualBMSStats_t* s = getVirtualBMSStats();
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
+  
+  arenaAppendf(&arena, "{\"enabled\":%s,\"channel\":%u,\"extended\":%s,\"period_ms\":%u,"
+               "\"packs_190\":%u,\"packs_290\":%u,\"voltage\":%.2f,\"current\":%.2f,\"energy\":%.2f,"
+               "\"soc\":%.1f,\"error_flags\":%u,\"cell_min_v\":%.4f,\"cell_min_node\":%u,"
+               "\"cell_mean_v\":%.4f,\"dccl\":%.1f,\"ddcl\":%.1f,\"frames\":[",
+               jsonBool(c->enabled), c->channel, jsonBool(c->extended), c->periodMs,
+               a->packs190, a->packs290, a->voltage, a->current, a->energy, a->soc, a->errorFlags,
+               a->cellMinVoltage, a->cellMinNode, a->cellMeanVoltage, a->dccl, a->ddcl);
+  for (uint8_t f = 0; f < VBMS_FRAME_COUNT; f++) {
+    uint8_t data[8];
+    buildVirtualBMSFrame((VirtualBMSFrame_t)f, data);
+    arenaAppendf(&arena, "%s{\"id\":%lu,\"sent\":%lu,\"data\":\"%02X%02X%02X%02X%02X%02X%02X%02X\"}",
+                 f > 0 ? "," : "", (unsigned long)c->ids[f], s->sent[f],
+                 data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]);
+  }
+  arenaAppendf(&arena, "],\"tx_errors\":%lu,\"skipped\":%lu,\"saturated\":%lu,\"rebuilds\":%lu,"
+               "\"jitter\":{\"last_us\":%lu,\"max_us\":%lu,\"mean_us\":%.1f,\"bound_us\":%d,\"late\":%lu,"
+               "\"histogram\":{\"lt_250us\":%lu,\"lt_1ms\":%lu,\"lt_5ms\":%lu,\"ge_5ms\":%lu}}}",
+               s->txErrors, s->skipped, s->saturated, s->rebuilds,
+               (unsigned long)s->lastLatenessUs, (unsigned long)s->maxLatenessUs, s->meanLatenessUs,
+               VBMS_MAX_JITTER_US, s->lateFrames,
+               s->jitterHistogram[VBMS_JITTER_UNDER_250US], s->jitterHistogram[VBMS_JITTER_UNDER_1MS],
+               s->jitterHistogram[VBMS_JITTER_UNDER_5MS], s->jitterHistogram[VBMS_JITTER_OVER_5MS]);
+  
+  sendArenaRender(request, 200, "application/json", &arena);
+}
+
+void ConfigWebServer::handleCANLoadAPI(AsyncWebServerRequest *request) {
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
+  
+  arenaAppendf(&arena, "{\"window_s\":%d,\"alert_percent\":%.0f,\"budget_percent\":%.0f,\"channels\":[",
+               CAN_LOAD_WINDOW_BUCKETS * CAN_LOAD_BUCKET_MS / 1000, CAN_LOAD_ALERT_PERCENT, CAN_LOAD_BUDGET_PERCENT);
+  for (int ch = 0; ch < CAN_CHANNEL_COUNT; ch++) {
+    const CANLoadChannelStats_t* s = getCANLoadChannelStats(ch);
+    arenaAppendf(&arena, "%s{\"channel\":%d,\"frames\":%lu,\"stuff_bits_per_frame\":%.2f,\"load_now\":%.2f,"
+                 "\"load_window\":%.2f,\"peak_load\":%.2f,\"alert\":%s,\"alerts\":%lu}",
+                 ch > 0 ? "," : "", ch, s->frames, s->frames ? (float)s->stuffBits / s->frames : 0.0f,
+                 s->loadNow, s->loadWindow, s->peakLoad, jsonBool(s->alertActive), s->alerts);
+  }
+  
+  arenaAppend(&arena, "],\"protocols\":[");
+  for (int p = 0; p < CAN_PROTOCOL_COUNT; p++) {
+    const CANLoadProtocolStats_t* s = getCANLoadProtocolStats(p);
+    arenaAppendf(&arena, "%s{\"protocol\":\"%s\",\"channel\":%u,\"frames\":%lu,\"load_now\":%.2f,"
+                 "\"load_window\":%.2f,\"headroom\":%.2f,\"admitted\":%lu,\"deferred\":%lu}",
+                 p > 0 ? "," : "", getCANProtocolName(p), getCANProtocolChannel((CANProtocol_t)p), s->frames,
+                 s->loadNow, s->loadWindow, getCANLoadHeadroom((CANProtocol_t)p), s->admitted, s->deferred);
+  }
+  
+  arenaAppend(&arena, "],\"nodes\":[");
+  bool first = true;
+  for (uint8_t i = 0; i < CAN_LOAD_MAX_NODES; i++) {
+    CANLoadNodeStats_t n;
+    if (!getCANLoadNodeStats(i, &n)) continue;
+    arenaAppendf(&arena, "%s{\"protocol\":\"%s\",\"node\":%u,\"frames\":%lu,\"load_now\":%.2f,\"load_window\":%.2f}",
+                 first ? "" : ",", getCANProtocolName(n.protocol), n.node, n.frames, n.loadNow, n.loadWindow);
+    first = false;
+  }
+  
+  arenaAppend(&arena, "],\"ids\":[");
+  first = true;
+  for (uint8_t i = 0; i < CAN_LOAD_MAX_IDS; i++) {
+    CANLoadIdStats_t e;
+    if (!getCANLoadIdStats(i, &e)) continue;
+    arenaAppendf(&arena, "%s{\"id\":\"0x%lx\",\"extended\":%s,\"channel\":%u,\"protocol\":\"%s\",\"frames\":%lu,"
+                 "\"bits_per_frame\":%u,\"load_now\":%.2f,\"load_window\":%.2f}",
+                 first ? "" : ",", e.id, jsonBool(e.extended), e.channel, getCANProtocolName(e.protocol),
+                 e.frames, e.lastFrameBits, e.loadNow, e.loadWindow);
+    first = false;
+  }
+  arenaAppendf(&arena, "],\"untracked_frames\":%lu}", getCANLoadUntrackedFrames());
+  
+  sendArenaRender(request, 200, "application/json", &arena);
+}
+
+void ConfigWebServer::handleEventsAPI(AsyncWebServerRequest *request) {
+  Event_t event;
+  while (pollEvent(webEventSub, &event)) {
+    webRecentEvents[webRecentHead] = event;
+    webRecentHead = (webRecentHead + 1) % WEB_RECENT_EVENTS;
+    if (webRecentCount < WEB_RECENT_EVENTS) webRecentCount++;
+  }
+  
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
+  
+  const EventBusStats_t* bus = getEventBusStats();
+  arenaAppend(&arena, "{\"published\":{");
+  for (uint8_t t = 0; t < EVENT_TYPE_COUNT; t++) {
+    arenaAppendf(&arena, "%s\"%s\":%lu", t > 0 ? "," : "", getEventTypeName(t), bus->published[t]);
+  }
+  arenaAppendf(&arena, "},\"foreign_publishes\":%lu,\"subscribers\":[", bus->foreignPublishes);
+  
+  for (int8_t i = 0; i < bus->subscribers; i++) {
+    EventSubscriberStats_t s;
+    if (!getEventSubscriberStats(i, &s)) continue;
+    arenaAppendf(&arena, "%s{\"name\":\"%s\",\"enqueued\":%lu,\"consumed\":%lu,\"dropped\":%lu,"
+                 "\"depth\":%u,\"peak_depth\":%u}",
+                 i > 0 ? "," : "", s.name, s.enqueued, s.consumed, s.dropped, s.depth, s.peakDepth);
+  }
+  
+  // Newest first
+  arenaAppend(&arena, "],\"recent\":[");
+  for (uint8_t n = 0; n < webRecentCount; n++) {
+    const Event_t& e = webRecentEvents[(webRecentHead + WEB_RECENT_EVENTS - 1 - n) % WEB_RECENT_EVENTS];
+    arenaAppendf(&arena, "%s{\"type\":\"%s\",\"timestamp\":%lu,", n > 0 ? "," : "",
+                 getEventTypeName(e.type), e.timestamp);
+    if (e.type == EVENT_MODULE_STATE_CHANGED) {
+      arenaAppendf(&arena, "\"module\":%u,\"old_state\":\"%s\",\"new_state\":\"%s\"}", e.source,
+                   getModuleStateName((TrioModuleState_t)e.data.moduleState.oldState),
+                   getModuleStateName((TrioModuleState_t)e.data.moduleState.newState));
+    } else if (e.type == EVENT_LIMITS_CHANGED) {
+      arenaAppendf(&arena, "\"dccl\":%.1f,\"ddcl\":%.1f}", e.data.limits.dccl, e.data.limits.ddcl);
+    } else if (e.type == EVENT_REGISTER_WRITTEN) {
+      arenaAppendf(&arena, "\"address\":%u,\"count\":%u,\"value\":%u}", e.data.registers.address,
+                   e.data.registers.count, e.data.registers.value);
+    } else {
+      arenaAppendf(&arena, "\"source\":%u}", e.source);
+    }
+  }
+  arenaAppend(&arena, "]}");
+  
+  sendArenaRender(request, 200, "application/json", &arena);
+}
+
+void ConfigWebServer::handleStallsAPI(AsyncWebServerRequest *request) {
+  StallSource_t sources[STALL_MAX_SOURCES];
+  StallEvent_t recent[STALL_RECENT_COUNT];
+  uint8_t sourceCount = getStallSources(sources, STALL_MAX_SOURCES);
+  uint8_t recentCount = getRecentStalls(recent, STALL_RECENT_COUNT);
+  const StallStats_t* stats = getStallStats();
+  
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
+  
+  arenaAppendf(&arena, "{\"threshold_us\":%lu,\"loop_passes\":%lu,\"stalls\":%lu,\"watchdog_stalls\":%lu,"
+               "\"longest_us\":%lu,\"untracked\":%lu,\"zones\":{",
+               (unsigned long)STALL_THRESHOLD_US, stats->loopPasses, stats->stalls, stats->liveStalls,
+               stats->longestUs, stats->droppedSources);
+  for (uint8_t z = 0; z < PROFILE_ZONE_COUNT; z++) {
+    arenaAppendf(&arena, "%s\"%s\":{\"total_ms\":%lu,\"max_us\":%lu,\"max_gap_us\":%lu}", z > 0 ? "," : "",
+                 getProfileZoneName(z), stats->zoneUs[z] / 1000, stats->zoneMaxUs[z], stats->zoneMaxGapUs[z]);
+  }
+  
+  // Ranked by total stalled time; resolve PCs with addr2line against the firmware ELF
+  arenaAppend(&arena, "},\"sources\":[");
+  for (uint8_t i = 0; i < sourceCount; i++) {
+    const StallSource_t* s = &sources[i];
+    arenaAppendf(&arena, "%s{\"zone\":\"%s\",\"in\":\"%s\",\"site\":\"0x%08lX\",\"count\":%lu,"
+                 "\"total_ms\":%lu,\"max_us\":%lu,\"last\":%lu,\"sampled\":%s,\"backtrace\":[",
+                 i > 0 ? "," : "", getProfileZoneName(s->zone), getProfileZoneName(s->parentZone),
+                 (unsigned long)s->site, s->count, s->totalUs / 1000, s->maxUs, s->lastAt, jsonBool(s->sampled));
+    for (uint8_t f = 0; f < s->depth; f++) {
+      arenaAppendf(&arena, "%s\"0x%08lX\"", f > 0 ? "," : "", (unsigned long)s->backtrace[f]);
+    }
+    arenaAppend(&arena, "]}");
+  }
+  
+  // Newest first
+  arenaAppend(&arena, "],\"recent\":[");
+  for (uint8_t i = 0; i < recentCount; i++) {
+    const StallEvent_t* e = &recent[i];
+    arenaAppendf(&arena, "%s{\"zone\":\"%s\",\"in\":\"%s\",\"duration_us\":%lu,\"at\":%lu,\"watchdog\":%s,"
+                 "\"site\":\"0x%08lX\"}",
+                 i > 0 ? "," : "", getProfileZoneName(e->zone), getProfileZoneName(e->parentZone),
+                 e->durationUs, e->at, jsonBool(e->live), (unsigned long)e->site);
+  }
+  
+  // Main task stack at the last watchdog report
+  arenaAppend(&arena, "],\"watchdog_backtrace\":[");
+  for (uint8_t f = 0; f < stats->liveDepth; f++) {
+    arenaAppendf(&arena, "%s\"0x%08lX\"", f > 0 ? "," : "", (unsigned long)stats->liveBacktrace[f]);
+  }
+  arenaAppend(&arena, "]}");
+  
+  sendArenaRender(request, 200, "application/json", &arena);
+}
+
+void ConfigWebServer::handleLogAPI(AsyncWebServerRequest *request) {
+  if (request->hasParam("level")) {
+    int level = findLogLevel(request->getParam("level")->value().c_str());
+    String module = request->hasParam("module") ? request->getParam("module")->value() : String("all");
+    if (level < 0) {
+      request->send(400, "application/json", "{\"error\":\"unknown level\"}");
+      return;
+    }
+    if (module == "all") {
+      setAllLogLevels(level);
+    } else {
+      int index = findLogModule(module.c_str());
+      if (index < 0) {
+        request->send(400, "application/json", "{\"error\":\"unknown module\"}");
+        return;
+      }
+      setLogLevel(index, level);
+    }
+  }
+  
+  if (request->hasParam("syslog")) {
+    String host = request->getParam("syslog")->value();
+    uint16_t port = request->hasParam("port") ? request->getParam("port")->value().toInt() : LOG_SYSLOG_DEFAULT_PORT;
+    if (!setLogSyslogTarget(host == "off" ? nullptr : host.c_str(), port)) {
+      request->send(400, "application/json", "{\"error\":\"syslog host too long\"}");
+      return;
+    }
+  }
+  
+  const LogSinkStats_t* stats = getLogSinkStats();
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
+  
+  arenaAppendf(&arena, "{\"ring\":{\"slots\":%d,\"in_use\":%u,\"peak\":%u,\"drained\":%lu},"
+               "\"syslog\":{\"host\":\"%s\",\"port\":%u,\"sent\":%lu,\"errors\":%lu},\"modules\":[",
+               LOG_RING_SLOTS, getLogRingDepth(), stats->peakDepth, stats->drained,
+               getLogSyslogHost(), getLogSyslogPort(), stats->syslogSent, stats->syslogErrors);
+  for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++) {
+    const LogModuleStats_t* m = getLogModuleStats(i);
+    arenaAppendf(&arena, "%s{\"module\":\"%s\",\"level\":\"%s\",\"logged\":%lu,\"suppressed\":%lu,\"dropped\":%lu}",
+                 i > 0 ? "," : "", getLogModuleName(i), getLogLevelName(getLogLevel(i)),
+                 m->logged, m->suppressed, m->dropped);
+  }
+  arenaAppend(&arena, "]}");
+  
+  sendArenaRender(request, 200, "application/json", &arena);
+}
+
+void ConfigWebServer::handleMetrics(AsyncWebServerRequest *request) {
+  MemArena_t arena;
+  if (!beginArenaRender(request, &arena)) return;
+  
+  arenaAppendf(&arena, "# TYPE bridge_uptime_seconds counter\nbridge_uptime_seconds %lu\n", millis() / 1000);
+  
+  // Heap (sampler values when available, live otherwise)
+  StatsSample_t sample;
+  if (!getLatestStatsSample(&sample)) {
+    memset(&sample, 0, sizeof(sample));
+    sample.freeHeap = ESP.getFreeHeap();
+    sample.minFreeHeap = ESP.getMinFreeHeap();
+    sample.largestFreeBlock = ESP.getMaxAllocHeap();
+  }
+  const HeapMetrics_t* heap = getHeapMetrics();
+  arenaAppendf(&arena, "# TYPE bridge_heap_free_bytes gauge\nbridge_heap_free_bytes %lu\n"
+               "# TYPE bridge_heap_min_free_bytes gauge\nbridge_heap_min_free_bytes %lu\n"
+               "# TYPE bridge_heap_largest_free_block_bytes gauge\nbridge_heap_largest_free_block_bytes %lu\n"
+               "# TYPE bridge_heap_fragmentation_percent gauge\nbridge_heap_fragmentation_percent %.2f\n"
+               "# TYPE bridge_heap_steady_state_allocations_total counter\nbridge_heap_steady_state_allocations_total %lu\n",
+               (unsigned long)sample.freeHeap, (unsigned long)sample.minFreeHeap,
+               (unsigned long)sample.largestFreeBlock, sample.fragmentation, heap->steadyStateAllocations);
+  
+  // Static pools
+  arenaAppend(&arena, "# TYPE bridge_pool_in_use gauge\n");
+  for (uint8_t i = 0; i < getMemPoolCount(); i++) {
+    const MemPool_t* pool = getMemPool(i);
+    arenaAppendf(&arena, "bridge_pool_in_use{pool=\"%s\"} %u\n", pool->name, pool->inUse);
+  }
+  arenaAppend(&arena, "# TYPE bridge_pool_exhausted_total counter\n");
+  for (uint8_t i = 0; i < getMemPoolCount(); i++) {
+    const MemPool_t* pool = getMemPool(i);
+    arenaAppendf(&arena, "bridge_pool_exhausted_total{pool=\"%s\"} %lu\n", pool->name, pool->failures);
+  }
+  
+  // Queues
+  const EventBusStats_t* bus = getEventBusStats();
+  arenaAppend(&arena, "# TYPE bridge_event_queue_depth gauge\n");
+  for (int8_t i = 0; i < bus->subscribers; i++) {
+    EventSubscriberStats_t s;
+    if (!getEventSubscriberStats(i, &s)) continue;
+    arenaAppendf(&arena, "bridge_event_queue_depth{subscriber=\"%s\"} %u\n", s.name, s.depth);
+  }
+  arenaAppend(&arena, "# TYPE bridge_event_dropped_total counter\n");
+  for (int8_t i = 0; i < bus->subscribers; i++) {
+    EventSubscriberStats_t s;
+    if (!getEventSubscriberStats(i, &s)) continue;
+    arenaAppendf(&arena, "bridge_event_dropped_total{subscriber=\"%s\"} %lu\n", s.name, s.dropped);
+  }
+  arenaAppend(&arena, "# TYPE bridge_can_ring_depth gauge\n");
+  for (int ch = 0; ch < CAN_CHANNEL_COUNT; ch++) {
+    arenaAppendf(&arena, "bridge_can_ring_depth{channel=\"%d\"} %u\n", ch, getCANChannelStats(ch)->ringDepth);
+  }
+  arenaAppend(&arena, "# TYPE bridge_can_ring_overflows_total counter\n");
+  for (int ch = 0; ch < CAN_CHANNEL_COUNT; ch++) {
+    arenaAppendf(&arena, "bridge_can_ring_overflows_total{channel=\"%d\"} %lu\n", ch, getCANChannelStats(ch)->ringOverflows);
+  }
+  
+  // Latency histograms (cumulative since boot) and per-sample percentiles
+  arenaAppend(&arena, "# TYPE bridge_latency_seconds histogram\n");
+  for (uint8_t ch = 0; ch < LATENCY_CHANNEL_COUNT; ch++) {
+    uint32_t buckets[STATS_LATENCY_BUCKETS];
+    getLatencyHistogram((LatencyChannel_t)ch, buckets);
+    unsigned long cumulative = 0;
+    for (uint8_t b = 0; b < STATS_LATENCY_BUCKETS - 1; b++) {
+      cumulative += buckets[b];
+      arenaAppendf(&arena, "bridge_latency_seconds_bucket{path=\"%s\",le=\"%.6f\"} %lu\n",
+                   getLatencyChannelName(ch), getLatencyBucketUpperUs(b) / 1e6f, cumulative);
+    }
+    cumulative += buckets[STATS_LATENCY_BUCKETS - 1];
+    arenaAppendf(&arena, "bridge_latency_seconds_bucket{path=\"%s\",le=\"+Inf\"} %lu\n"
+                 "bridge_latency_seconds_count{path=\"%s\"} %lu\n",
+                 getLatencyChannelName(ch), cumulative, getLatencyChannelName(ch), cumulative);
+  }
+  arenaAppend(&arena, "# TYPE bridge_latency_p99_seconds gauge\n");
+  for (uint8_t ch = 0; ch < LATENCY_CHANNEL_COUNT; ch++) {
+    arenaAppendf(&arena, "bridge_latency_p99_seconds{path=\"%s\"} %.6f\n",
+                 getLatencyChannelName(ch), sample.latencyP99[ch] / 1e6f);
+  }
+  
+  // Drift over the sampler history
+  StatsDrift_t drift;
+  getStatsDrift(&drift);
+  arenaAppendf(&arena, "# TYPE bridge_drift_samples gauge\nbridge_drift_samples %u\n"
+               "# TYPE bridge_drift_slope_per_hour gauge\n"
+               "bridge_drift_slope_per_hour{metric=\"heap_free_bytes\"} %.1f\n"
+               "bridge_drift_slope_per_hour{metric=\"fragmentation_percent\"} %.3f\n",
+               drift.samples, drift.heapSlope, drift.fragmentationSlope);
+  for (uint8_t ch = 0; ch < LATENCY_CHANNEL_COUNT; ch++) {
+    arenaAppendf(&arena, "bridge_drift_slope_per_hour{metric=\"%s_p99_percent\"} %.2f\n",
+                 getLatencyChannelName(ch), drift.latencySlope[ch]);
+  }
+  arenaAppendf(&arena, "# TYPE bridge_drift_active gauge\n"
+               "bridge_drift_active{metric=\"heap_free_bytes\"} %d\n"
+               "bridge_drift_active{metric=\"fragmentation_percent\"} %d\n",
+               drift.heapDrift ? 1 : 0, drift.fragmentationDrift ? 1 : 0);
+  for (uint8_t ch = 0; ch < LATENCY_CHANNEL_COUNT; ch++) {
+    arenaAppendf(&arena, "bridge_drift_active{metric=\"%s_p99_percent\"} %d\n",
+                 getLatencyChannelName(ch), drift.latencyDrift[ch] ? 1 : 0);
+  }
+  arenaAppendf(&arena, "# TYPE bridge_drift_alerts_total counter\nbridge_drift_alerts_total %lu\n", drift.driftAlerts);
   
-  request->send(200, "application/json", json);
+  sendArenaRender(request, 200, "text/plain; version=0.0.4", &arena);
 }
 
 // === SYSTEM STATUS BAR FUNCTIONS ===
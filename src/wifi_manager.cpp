@@ -10,18 +10,21 @@
 //
 // 📋 MODULE INFO:
 //    Module: WiFi Management Implementation
-//    Version: v4.0.2
+//    Version: v4.0.5
 //    Created: 13.08.2025 (Warsaw Time)
-//    Last Modified: 27.08.2025 (Warsaw Time)
+//    Last Modified: 18.10.2026 (Warsaw Time)
 //    Author: ESP32 Development Team
 //
 // 📊 VERSION HISTORY:
+//    v4.0.5 - 18.10.2026 - Triggered AP mode keeps a web server started at boot running
+//    v4.0.4 - 18.10.2026 - Blocking connect timed as a profiling zone
+//    v4.0.3 - 18.10.2026 - Scan results in a fixed array (no std::vector)
 //    v4.0.2 - 27.08.2025 - Added professional documentation headers
 //    v4.0.1 - 13.08.2025 - Fixed all compilation errors and added complete functionality
 //    v4.0.0 - 13.08.2025 - Initial WiFi manager implementation
 //
 // 🎯 DEPENDENCIES:
-//    Internal: wifi_manager.h, utils.h, web_server.h
+//    Internal: wifi_manager.h, utils.h, web_server.h, stall_monitor.h
 //    External: WiFi.h, ESP32 WiFi stack
 //
 // 📝 DESCRIPTION:
@@ -57,6 +60,7 @@
 #include "wifi_manager.h"
 #include "utils.h"
 #include "web_server.h"
+#include "stall_monitor.h"
 
 // === GLOBAL WIFI MANAGER INSTANCE ===
 WiFiManager wifiManager;
@@ -85,7 +89,7 @@ WiFiManager::WiFiManager()
   configPassword = String(WIFI_PASSWORD);
   
   // Clear scanned networks
-  scannedNetworks.clear();
+  scannedNetworkCount = 0;
 }
 
 WiFiManager::~WiFiManager() {
@@ -193,6 +197,7 @@ bool WiFiManager::connect(const char* ssid, const char* password) {
   }
   
   Serial.printf("📡 Connecting to WiFi: %s\n", ssid);
+  PROFILE_ZONE(PROFILE_ZONE_WIFI);
   
   // Store credentials
   setCredentials(ssid, password);
@@ -482,7 +487,7 @@ int WiFiManager::getScanResults(WiFiNetwork* networks, int maxResults) {
     return 0;
   }
   
-  int count = min(static_cast<int>(scannedNetworks.size()), maxResults);
+  int count = min(static_cast<int>(scannedNetworkCount), maxResults);
   
   for (int i = 0; i < count; i++) {
     networks[i] = scannedNetworks[i];
@@ -492,7 +497,7 @@ int WiFiManager::getScanResults(WiFiNetwork* networks, int maxResults) {
 }
 
 void WiFiManager::clearScanResults() {
-  scannedNetworks.clear();
+  scannedNetworkCount = 0;
 }
 
 // === DIAGNOSTICS ===
@@ -565,13 +570,13 @@ void WiFiManager::printNetworkInfo() const {
 
 void WiFiManager::printScanResults() const {
   Serial.printf("🔍 === WIFI SCAN RESULTS (%d networks) ===\n", 
-                static_cast<int>(scannedNetworks.size()));
+                static_cast<int>(scannedNetworkCount));
   
-  for (size_t i = 0; i < scannedNetworks.size(); i++) {
+  for (size_t i = 0; i < scannedNetworkCount; i++) {
     const WiFiNetwork& network = scannedNetworks[i];
     Serial.printf("  %2d. %-20s %4d dBm  Ch:%2d  %s %s\n",
                   static_cast<int>(i + 1),
-                  network.ssid.c_str(),
+                  network.ssid,
                   network.rssi,
                   network.channel,
                   network.isEncrypted ? "🔐" : "📖",
@@ -697,18 +702,19 @@ void WiFiManager::processScan() {
 }
 
 void WiFiManager::populateScanResults() {
-  scannedNetworks.clear();
+  scannedNetworkCount = 0;
   
-  int networkCount = WiFi.scanComplete();
+  int networkCount = min(WiFi.scanComplete(), WIFI_MAX_SCAN_RESULTS);
   for (int i = 0; i < networkCount; i++) {
-    WiFiNetwork network;
-    network.ssid = WiFi.SSID(i);
+    WiFiNetwork& network = scannedNetworks[scannedNetworkCount];
+    strncpy(network.ssid, WiFi.SSID(i).c_str(), sizeof(network.ssid) - 1);
+    network.ssid[sizeof(network.ssid) - 1] = '\0';
     network.rssi = WiFi.RSSI(i);
     network.authMode = WiFi.encryptionType(i);
     network.channel = WiFi.channel(i);
     network.isEncrypted = (network.authMode != WIFI_AUTH_OPEN);
     
-    scannedNetworks.push_back(network);
+    scannedNetworkCount++;
   }
   
   WiFi.scanDelete(); // Free memory
@@ -716,6 +722,9 @@ void WiFiManager::populateScanResults() {
 
 // === TRIGGERED AP MODE FUNCTIONS ===
 
+// Web server started for the triggered AP (not already running from boot)
+static bool webServerStartedForAP = false;
+
 /**
  * @brief Uruchom tryb AP wyzwalany przez CAN
  */
@@ -734,7 +743,8 @@ bool WiFiManager::startTriggeredAPMode() {
     Serial.printf("   IP: 192.168.4.1\n");
     Serial.printf("   Duration: %d seconds\n", AP_MODE_DURATION_MS / 1000);
     
-    // 🔥 Start configuration web server
+    // 🔥 Start configuration web server (normally already running since boot)
+    webServerStartedForAP = !isConfigWebServerRunning();
     if (startConfigWebServer()) {
       Serial.println("🌐 Configuration web server started");
       Serial.printf("   URL: http://192.168.4.1/\n");
@@ -755,11 +765,12 @@ void WiFiManager::stopTriggeredAPMode() {
   if (isAPModeActive()) {
     Serial.println("🛑 Stopping triggered AP mode...");
     
-    // 🔥 Stop configuration web server first
-    if (isConfigWebServerRunning()) {
+    // 🔥 Stop configuration web server first, unless it serves the station side too
+    if (webServerStartedForAP && isConfigWebServerRunning()) {
       stopConfigWebServer();
       Serial.println("🌐 Configuration web server stopped");
     }
+    webServerStartedForAP = false;
     
     stopAPMode();
     
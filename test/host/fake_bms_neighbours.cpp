@@ -0,0 +1,103 @@
+// =====================================================================
+// === fake_bms_neighbours.cpp - Modules around the BMS/Modbus path ===
+// =====================================================================
+//
+// For host tests that link bms_protocol.cpp, bms_data.cpp and
+// modbus_tcp.cpp without the CAN driver, TRIO HP, SDO, COV, rule/signal
+// and parameter modules: only BMS frames on one bus, no TRIO modules, no
+// SDO/COV/parameter register windows, no lwIP transport. Also provides
+// systemConfig and saveConfiguration() (config.cpp). Every symbol those
+// sources reference outside the test's HOST_SOURCES is defined here, so
+// the tests link without ignoring unresolved symbols. List it on the
+// test's HOST_SOURCES line.
+//
+// =====================================================================
+
+#include "host_runtime.h"
+#include "config.h"
+#include "bms_sdo.h"
+#include "can_bus.h"
+#include "can_load.h"
+#include "can_rules.h"
+#include "can_signals.h"
+#include "modbus_cov.h"
+#include "modbus_transport.h"
+#include "trio_hp_forecast.h"
+#include "trio_hp_limits.h"
+#include "trio_hp_params.h"
+#include "trio_hp_protocol.h"
+#include "trio_hp_manager.h"
+#include "trio_hp_monitor.h"
+
+SystemConfig systemConfig;
+bool saveConfiguration() { return true; }
+
+static ModbusTransportStats_t transportStats;
+static CANChannelStats_t channelStats;
+
+bool processAPTriggerFrame(unsigned long, unsigned char, unsigned char*) { return false; }
+bool isBMSSdoResponseFrame(unsigned long) { return false; }
+void handleBMSSdoResponse(unsigned long, const unsigned char*) {}
+bool isBMSSdoRegisterRange(uint16_t, uint16_t) { return false; }
+bool isModbusCOVRegisterRange(uint16_t, uint16_t) { return false; }
+bool isTrioParamRegisterRange(uint16_t, uint16_t) { return false; }
+bool trioHPIsHeartbeatFrame(uint32_t) { return false; }
+bool processTrioHPCanFrame(uint32_t, const uint8_t*, uint8_t) { return false; }
+const TrioPackForecast_t* getPackForecast(uint8_t) { return nullptr; }
+const TrioPackLimits_t* getPackLimits(uint8_t) { return nullptr; }
+const ModbusTransportStats_t* getModbusTransportStats() { return &transportStats; }
+bool isCANChannelAvailable(uint8_t channel) { return channel == CAN_CHANNEL_PRIMARY; }
+uint8_t getCANProtocolChannel(CANProtocol_t) { return CAN_CHANNEL_PRIMARY; }
+uint8_t canBusBacklog(uint8_t) { return 0; }
+const CANChannelStats_t* getCANChannelStats(uint8_t) { return &channelStats; }
+
+// CAN channel layer: frames are fed to the protocol directly, the rings stay empty
+bool initCANBus() { return true; }
+uint8_t canBusDrain(uint8_t) { return 0; }
+bool canBusPop(uint8_t, CANFrame_t*) { return false; }
+CANProtocol_t getCANFrameProtocol(uint8_t, bool) { return CAN_PROTOCOL_BMS; }
+void updateCANBusUtilisation() {}
+void printCANBusStatus() {}
+void sampleCANErrorCounters() {}
+const CANErrorStats_t* getCANErrorStats(uint8_t) { return &channelStats.errors; }
+const char* getCANErrorStateName(uint8_t) { return "ERROR_ACTIVE"; }
+void updateCANLoad() {}
+void printCANLoadStatus() {}
+
+// Mapping rules and DBC signal table: nothing loaded
+bool applyCANRules(unsigned long, bool, uint8_t, const uint8_t*) { return false; }
+bool applyCANSignals(unsigned long, bool, uint8_t, const uint8_t*) { return false; }
+void processCANRulesReload() {}
+
+// SDO client, COV and parameter windows (never addressed, see the range checks above)
+void initBMSSdo() {}
+void processBMSSdo() {}
+bool readBMSSdoRegister(uint16_t, uint16_t*) { return false; }
+bool writeBMSSdoRegister(uint16_t, uint16_t) { return false; }
+void initModbusCOV() {}
+void processModbusCOV() {}
+void printModbusCOVStatus() {}
+bool readModbusCOVRegister(uint8_t, uint16_t, uint16_t*) { return false; }
+bool writeModbusCOVRegister(uint8_t, uint16_t, uint16_t) { return false; }
+void setModbusCOVClientSession(uint8_t, uint32_t) {}
+bool readTrioParamRegister(uint16_t, uint16_t*) { return false; }
+bool writeTrioParamRegister(uint16_t, uint16_t) { return false; }
+bool writeTrioParamRegisters(uint16_t, uint16_t, const uint16_t*) { return false; }
+
+// lwIP transport: no listener, no connections
+bool startModbusTransport(uint16_t) { return false; }
+void stopModbusTransport() {}
+void printModbusTransportStatus() {}
+ModbusConnection_t* getModbusTransportRequest(uint8_t, uint8_t**, int*) { return nullptr; }
+bool sendModbusTransport(ModbusConnection_t*, const uint8_t*, int) { return false; }
+void completeModbusTransport(ModbusConnection_t*) {}
+uint8_t getModbusTransportSlot(const ModbusConnection_t*) { return 0; }
+uint32_t getModbusTransportSession(const ModbusConnection_t*) { return 0; }
+uint32_t getModbusTransportRemoteIP(uint8_t) { return 0; }
+
+// TRIO HP manager/monitor: not initialized, no modules
+bool isTrioHPManagerInitialized() { return false; }
+bool isModuleActive(uint8_t) { return false; }
+float getLatestValue(const TrioHPDataBuffer_t*) { return 0.0f; }
+const TrioHPModuleData_t* getModuleData(uint8_t) { return nullptr; }
+const TrioHPSystemData_t* getSystemData() { return nullptr; }
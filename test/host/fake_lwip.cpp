@@ -0,0 +1,155 @@
+// =====================================================================
+// === fake_lwip.cpp - lwIP raw TCP API driven by a host test ===
+// =====================================================================
+
+#include "fake_lwip.h"
+#include "lwip/priv/tcpip_priv.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+ip_addr_t ip_addr_any;
+int hostLivePbufs = 0;
+
+static struct tcp_pcb listener;
+
+static HostTcpConnection_t* hostConnection(struct tcp_pcb* pcb) {
+  return (HostTcpConnection_t*)pcb;
+}
+
+// === PCB ===
+struct tcp_pcb* tcp_new(void) { return &listener; }
+err_t tcp_bind(struct tcp_pcb*, const ip_addr_t*, u16_t) { return ERR_OK; }
+struct tcp_pcb* tcp_listen_with_backlog(struct tcp_pcb* pcb, u8_t) { return pcb; }
+void tcp_accept(struct tcp_pcb* pcb, tcp_accept_fn accept) { pcb->accept = accept; }
+void tcp_arg(struct tcp_pcb* pcb, void* arg) { pcb->callback_arg = arg; }
+void tcp_recv(struct tcp_pcb* pcb, tcp_recv_fn recv) { pcb->recv = recv; }
+void tcp_sent(struct tcp_pcb* pcb, tcp_sent_fn sent) { pcb->sent = sent; }
+void tcp_err(struct tcp_pcb* pcb, tcp_err_fn err) { pcb->errf = err; }
+void tcp_poll(struct tcp_pcb* pcb, tcp_poll_fn poll, u8_t) { pcb->poll = poll; }
+void tcp_recved(struct tcp_pcb* pcb, u16_t len) { hostConnection(pcb)->recved += len; }
+err_t tcp_output(struct tcp_pcb* pcb) { hostConnection(pcb)->outputs++; return ERR_OK; }
+
+err_t tcp_write(struct tcp_pcb* pcb, const void* data, u16_t len, u8_t flags) {
+  if (pcb->snd_buf < len) return ERR_MEM;
+  HostTcpSegment_t segment;
+  segment.data = (const uint8_t*)data;
+  segment.length = len;
+  segment.noCopy = !(flags & TCP_WRITE_FLAG_COPY);
+  if (!segment.noCopy) segment.copy.assign(segment.data, segment.data + len);
+  hostConnection(pcb)->unacked.push_back(segment);
+  pcb->snd_buf -= len;
+  pcb->snd_queuelen++;
+  return ERR_OK;
+}
+
+err_t tcp_close(struct tcp_pcb* pcb) {
+  if (pcb != &listener) hostConnection(pcb)->closed = true;
+  return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb* pcb) { hostConnection(pcb)->aborted = true; }
+
+// === PBUF ===
+u8_t pbuf_free(struct pbuf* p) {
+  u8_t count = 0;
+  while (p != nullptr) {
+    struct pbuf* next = p->next;
+    free(p);
+    hostLivePbufs--;
+    count++;
+    p = next;
+  }
+  return count;
+}
+
+void pbuf_cat(struct pbuf* head, struct pbuf* tail) {
+  struct pbuf* p = head;
+  for (; p->next != nullptr; p = p->next) p->tot_len += tail->tot_len;
+  p->tot_len += tail->tot_len;
+  p->next = tail;
+}
+
+u16_t pbuf_copy_partial(const struct pbuf* p, void* data, u16_t len, u16_t offset) {
+  u16_t done = 0;
+  for (; p != nullptr && done < len; p = p->next) {
+    if (offset >= p->len) {
+      offset -= p->len;
+      continue;
+    }
+    u16_t n = std::min<u16_t>(p->len - offset, len - done);
+    memcpy((uint8_t*)data + done, (uint8_t*)p->payload + offset, n);
+    done += n;
+    offset = 0;
+  }
+  return done;
+}
+
+struct pbuf* pbuf_free_header(struct pbuf* q, u16_t size) {
+  while (q != nullptr && size > 0) {
+    if (size >= q->len) {
+      size -= q->len;
+      struct pbuf* next = q->next;
+      q->next = nullptr;
+      pbuf_free(q);
+      q = next;
+    } else {
+      q->payload = (uint8_t*)q->payload + size;
+      q->len -= size;
+      q->tot_len -= size;
+      size = 0;
+    }
+  }
+  return q;
+}
+
+err_t tcpip_api_call(tcpip_api_call_fn fn, struct tcpip_api_call_data* call) {
+  return fn(call);
+}
+
+// === TEST SIDE ===
+HostTcpConnection_t* hostTcpConnect(uint32_t remoteIP) {
+  HostTcpConnection_t* conn = new HostTcpConnection_t();
+  conn->pcb.snd_buf = HOST_TCP_SNDBUF;
+  conn->pcb.remote_ip.ip4.addr = remoteIP;
+  if (listener.accept == nullptr || listener.accept(nullptr, &conn->pcb, ERR_OK) != ERR_OK) return nullptr;
+  return conn;
+}
+
+static struct pbuf* makeChain(const std::vector<uint8_t>& bytes, size_t segment) {
+  struct pbuf* head = nullptr;
+  for (size_t pos = 0; pos < bytes.size();) {
+    size_t n = segment == 0 ? bytes.size() - pos : std::min(segment, bytes.size() - pos);
+    struct pbuf* p = (struct pbuf*)malloc(sizeof(struct pbuf) + n);
+    hostLivePbufs++;
+    p->next = nullptr;
+    p->payload = p + 1;
+    memcpy(p->payload, &bytes[pos], n);
+    p->len = p->tot_len = (u16_t)n;
+    pos += n;
+    if (head != nullptr) pbuf_cat(head, p);
+    else head = p;
+  }
+  return head;
+}
+
+err_t hostTcpDeliver(HostTcpConnection_t* conn, const std::vector<uint8_t>& bytes, size_t segment) {
+  return conn->pcb.recv(conn->pcb.callback_arg, &conn->pcb, makeChain(bytes, segment), ERR_OK);
+}
+
+err_t hostTcpRemoteClose(HostTcpConnection_t* conn) {
+  return conn->pcb.recv(conn->pcb.callback_arg, &conn->pcb, nullptr, ERR_OK);
+}
+
+void hostTcpAckAll(HostTcpConnection_t* conn) {
+  u16_t total = 0;
+  for (const HostTcpSegment_t& s : conn->unacked) {
+    if (s.noCopy) conn->delivered.insert(conn->delivered.end(), s.data, s.data + s.length);
+    else conn->delivered.insert(conn->delivered.end(), s.copy.begin(), s.copy.end());
+    total += s.length;
+  }
+  conn->unacked.clear();
+  conn->pcb.snd_buf += total;
+  conn->pcb.snd_queuelen = 0;
+  if (conn->pcb.sent != nullptr && total > 0) conn->pcb.sent(conn->pcb.callback_arg, &conn->pcb, total);
+}
@@ -0,0 +1,48 @@
+// =====================================================================
+// === fake_lwip.h - lwIP raw TCP API driven by a host test ===
+// =====================================================================
+//
+// The test plays the network side: it opens connections through the
+// listener's accept callback, delivers byte streams cut into pbuf chains
+// and acknowledges what the firmware wrote. tcpip_api_call() runs its
+// body in the caller, so the "lwIP thread" and the main loop are the
+// same thread. List test/host/fake_lwip.cpp on HOST_SOURCES.
+//
+// =====================================================================
+
+#pragma once
+
+#include "lwip/tcp.h"
+#include <stddef.h>
+#include <vector>
+
+typedef struct {
+  const uint8_t* data;              // Firmware buffer, read at acknowledge when noCopy
+  u16_t length;
+  std::vector<uint8_t> copy;        // Bytes taken at tcp_write() otherwise
+  bool noCopy;
+} HostTcpSegment_t;
+
+typedef struct {
+  struct tcp_pcb pcb;               // First: the firmware only sees this
+  std::vector<HostTcpSegment_t> unacked;
+  std::vector<uint8_t> delivered;   // Acknowledged bytes, as the client read them
+  unsigned recved;                  // Bytes opened in the receive window
+  int outputs;                      // tcp_output() calls
+  bool closed;
+  bool aborted;
+} HostTcpConnection_t;
+
+#define HOST_TCP_SNDBUF 5744
+
+extern int hostLivePbufs;           // Allocated and not yet freed
+
+// New connection through the accept callback; nullptr if it was refused
+HostTcpConnection_t* hostTcpConnect(uint32_t remoteIP);
+
+// Bytes to the receive callback, in pbufs of `segment` bytes (0 = one pbuf)
+err_t hostTcpDeliver(HostTcpConnection_t* conn, const std::vector<uint8_t>& bytes, size_t segment = 0);
+err_t hostTcpRemoteClose(HostTcpConnection_t* conn);
+
+// Everything written so far reaches the client and is acknowledged
+void hostTcpAckAll(HostTcpConnection_t* conn);
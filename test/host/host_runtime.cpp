@@ -0,0 +1,134 @@
+// =====================================================================
+// === host_runtime.cpp - Arduino/FreeRTOS behaviour for host tests ===
+// =====================================================================
+
+#include "host_runtime.h"
+#include <SPI.h>
+#include <WiFi.h>
+#include <esp_heap_caps.h>
+#include <stdarg.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+SPIClass SPI;
+WiFiClass WiFi;
+
+bool hostSerialEcho = true;
+uint32_t hostFreeHeap = 200000;
+uint32_t hostLargestFreeBlock = 100000;
+uint32_t hostAllocatedBlocks = 0;
+
+static unsigned long long hostClockUs = 0;
+static int hostFailures = 0;
+static int hostChecks = 0;
+
+// === CLOCK ===
+void hostSetMillis(unsigned long ms) { hostClockUs = (unsigned long long)ms * 1000ULL; }
+void hostAdvanceMs(unsigned long ms) { hostClockUs += (unsigned long long)ms * 1000ULL; }
+void hostAdvanceUs(unsigned long us) { hostClockUs += us; }
+
+unsigned long millis() { return (unsigned long)(hostClockUs / 1000ULL); }
+unsigned long micros() { return (unsigned long)hostClockUs; }
+int64_t esp_timer_get_time() { return (int64_t)hostClockUs; }
+void delay(unsigned long ms) { hostAdvanceMs(ms); }
+void delayMicroseconds(unsigned int us) { hostAdvanceUs(us); }
+void yield() {}
+
+// === CHECKS ===
+int hostCheck(bool ok, const char* expr, const char* file, int line) {
+  hostChecks++;
+  if (!ok) {
+    hostFailures++;
+    fprintf(stderr, "FAIL %s:%d: %s\n", file, line, expr);
+  }
+  return ok;
+}
+
+int hostTestResult() {
+  fprintf(stderr, "%d checks, %d failed\n", hostChecks, hostFailures);
+  return hostFailures == 0 ? 0 : 1;
+}
+
+// === SERIAL ===
+static size_t emit(const char* text) {
+  if (hostSerialEcho) fputs(text, stdout);
+  return strlen(text);
+}
+
+size_t Print::printf(const char* format, ...) {
+  char buf[512];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  return emit(buf);
+}
+
+size_t Print::print(const String& v) { return emit(v.c_str()); }
+size_t Print::print(const char* v) { return emit(v); }
+size_t Print::print(char v) { char b[2] = { v, 0 }; return emit(b); }
+size_t Print::print(unsigned char v, int base) { return print((unsigned long)v, base); }
+size_t Print::print(int v, int base) { return print((long)v, base); }
+size_t Print::print(unsigned v, int base) { return print((unsigned long)v, base); }
+size_t Print::print(long v, int base) { return printf(base == HEX ? "%lx" : "%ld", v); }
+size_t Print::print(unsigned long v, int base) { return printf(base == HEX ? "%lx" : "%lu", v); }
+size_t Print::print(double v, int decimals) { return printf("%.*f", decimals, v); }
+size_t Print::println() { return emit("\n"); }
+size_t Print::println(const String& v) { return print(v) + println(); }
+size_t Print::println(const char* v) { return print(v) + println(); }
+size_t Print::println(char v) { return print(v) + println(); }
+size_t Print::println(unsigned char v, int base) { return print(v, base) + println(); }
+size_t Print::println(int v, int base) { return print(v, base) + println(); }
+size_t Print::println(unsigned v, int base) { return print(v, base) + println(); }
+size_t Print::println(long v, int base) { return print(v, base) + println(); }
+size_t Print::println(unsigned long v, int base) { return print(v, base) + println(); }
+size_t Print::println(double v, int decimals) { return print(v, decimals) + println(); }
+
+// === CHIP / HEAP ===
+uint32_t EspClass::getFreeHeap() { return hostFreeHeap; }
+uint32_t EspClass::getMinFreeHeap() { return hostFreeHeap; }
+uint32_t EspClass::getMaxAllocHeap() { return hostLargestFreeBlock; }
+size_t heap_caps_get_free_size(uint32_t) { return hostFreeHeap; }
+size_t heap_caps_get_largest_free_block(uint32_t) { return hostLargestFreeBlock; }
+size_t heap_caps_get_minimum_free_size(uint32_t) { return hostFreeHeap; }
+
+void heap_caps_get_info(multi_heap_info_t* info, uint32_t) {
+  memset(info, 0, sizeof(*info));
+  info->total_free_bytes = hostFreeHeap;
+  info->largest_free_block = hostLargestFreeBlock;
+  info->minimum_free_bytes = hostFreeHeap;
+  info->allocated_blocks = hostAllocatedBlocks;
+}
+
+// === FREERTOS (single task) ===
+static int hostMainTask;
+TaskHandle_t xTaskGetCurrentTaskHandle() { return &hostMainTask; }
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 2048; }
+TickType_t xTaskGetTickCount() { return millis(); }
+void vTaskDelay(TickType_t ticks) { hostAdvanceMs(ticks); }
+void vTaskDelayUntil(TickType_t* last, TickType_t ticks) { *last += ticks; hostSetMillis(*last); }
+
+// Background tasks are not started on the host - tests call the task bodies' steps directly
+BaseType_t xTaskCreate(void (*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t* handle) {
+  if (handle) *handle = nullptr;
+  return pdPASS;
+}
+BaseType_t xTaskCreatePinnedToCore(void (*)(void*), const char*, uint32_t, void*, UBaseType_t,
+                                   TaskHandle_t* handle, int) {
+  if (handle) *handle = nullptr;
+  return pdPASS;
+}
+void vTaskDelete(TaskHandle_t) {}
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t*) {}
+SemaphoreHandle_t xSemaphoreCreateMutex() { return &hostMainTask; }
+BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+
+// === GPIO ===
+void pinMode(int, int) {}
+void digitalWrite(int, int) {}
+int digitalRead(int) { return LOW; }
+void attachInterrupt(uint8_t, void (*)(void), int) {}
+long random(long max) { return max > 0 ? rand() % max : 0; }
+long random(long min, long max) { return max > min ? min + rand() % (max - min) : min; }
@@ -0,0 +1,30 @@
+// =====================================================================
+// === host_runtime.h - Shared support for the host tests ===
+// =====================================================================
+//
+// Virtual clock behind millis()/micros(), Serial echo control and a
+// minimal check macro. A test's main() returns hostTestResult().
+//
+// =====================================================================
+
+#pragma once
+
+#include <Arduino.h>
+
+// Virtual time: starts at 0, only moves when a test advances it (delay() too)
+void hostSetMillis(unsigned long ms);
+void hostAdvanceMs(unsigned long ms);
+void hostAdvanceUs(unsigned long us);
+
+// Serial output goes to stdout while true
+extern bool hostSerialEcho;
+
+// Values returned by ESP.getFreeHeap() / getMaxAllocHeap() and heap_caps_*
+extern uint32_t hostFreeHeap;
+extern uint32_t hostLargestFreeBlock;
+extern uint32_t hostAllocatedBlocks;
+
+int hostCheck(bool ok, const char* expr, const char* file, int line);
+int hostTestResult();
+
+#define HOST_CHECK(cond) hostCheck((cond), #cond, __FILE__, __LINE__)
@@ -0,0 +1,273 @@
+// =====================================================================
+// === Arduino.h - Host stand-in for the Arduino-ESP32 core ===
+// =====================================================================
+//
+// Only what the firmware sources linked by the host tests use. Behaviour
+// lives in test/host/host_runtime.cpp (virtual clock, Serial to stdout);
+// FreeRTOS critical sections are no-ops because host tests are single
+// threaded.
+//
+// =====================================================================
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define FALLING 2
+#define HEX 16
+#define DEC 10
+#define PI 3.14159265
+#define IRAM_ATTR
+#define CONFIG_IDF_TARGET_ESP32S3 1   // From sdkconfig on the target; config.h checks it
+#define F(x) x
+#define constrain(x, a, b) ((x) < (a) ? (a) : ((x) > (b) ? (b) : (x)))
+#define digitalPinToInterrupt(p) (p)
+
+// === TIME / GPIO ===
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+int digitalRead(int pin);
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+long random(long max);
+long random(long min, long max);
+
+inline bool isDigit(int c) { return c >= '0' && c <= '9'; }
+inline bool isAlpha(int c) { return isalpha(c); }
+inline bool isAlphaNumeric(int c) { return isalnum(c); }
+inline bool isHexadecimalDigit(int c) { return isxdigit(c); }
+
+// === STRING ===
+class String {
+public:
+  std::string s;
+
+  String() {}
+  String(const char* c) : s(c ? c : "") {}
+  String(const std::string& x) : s(x) {}
+  String(char c) : s(1, c) {}
+  String(bool b) : s(b ? "1" : "0") {}
+  String(unsigned char v, int = DEC) : s(std::to_string(v)) {}
+  String(int v, int = DEC) : s(std::to_string(v)) {}
+  String(unsigned v, int = DEC) : s(std::to_string(v)) {}
+  String(long v, int = DEC) : s(std::to_string(v)) {}
+  String(unsigned long v, int = DEC) : s(std::to_string(v)) {}
+  String(long long v) : s(std::to_string(v)) {}
+  String(unsigned long long v) : s(std::to_string(v)) {}
+  String(float v, int decimals = 2) { format(v, decimals); }
+  String(double v, int decimals = 2) { format(v, decimals); }
+
+  String& operator+=(const String& o) { s += o.s; return *this; }
+  String& operator+=(const char* o) { s += o; return *this; }
+  String& operator+=(char c) { s += c; return *this; }
+  template <typename T> String& operator+=(T v) { s += String(v).s; return *this; }
+  bool concat(const String& o) { s += o.s; return true; }
+  bool concat(const char* o) { s += o; return true; }
+  bool concat(char c) { s += c; return true; }
+
+  bool operator==(const String& o) const { return s == o.s; }
+  bool operator==(const char* o) const { return s == o; }
+  bool operator!=(const String& o) const { return s != o.s; }
+  bool operator!=(const char* o) const { return s != o; }
+  bool operator<(const String& o) const { return s < o.s; }
+  bool equals(const String& o) const { return s == o.s; }
+
+  const char* c_str() const { return s.c_str(); }
+  unsigned length() const { return s.size(); }
+  bool isEmpty() const { return s.empty(); }
+  char charAt(unsigned i) const { return s[i]; }
+  char operator[](unsigned i) const { return s[i]; }
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return atof(s.c_str()); }
+  int indexOf(const char* x, unsigned from = 0) const { return pos(s.find(x, from)); }
+  int indexOf(char x, unsigned from = 0) const { return pos(s.find(x, from)); }
+  String substring(unsigned a) const { return String(s.substr(a)); }
+  String substring(unsigned a, unsigned b) const { return String(s.substr(a, b - a)); }
+  bool startsWith(const String& p) const { return s.compare(0, p.s.size(), p.s) == 0; }
+  bool endsWith(const String& p) const {
+    return s.size() >= p.s.size() && s.compare(s.size() - p.s.size(), p.s.size(), p.s) == 0;
+  }
+  void toCharArray(char* buf, unsigned n) const { strncpy(buf, s.c_str(), n); }
+  void trim() {}
+  void toLowerCase() {}
+  void toUpperCase() {}
+  void reserve(unsigned n) { s.reserve(n); }
+  void replace(const String&, const String&) {}
+  void remove(unsigned i) { s.erase(i); }
+  void remove(unsigned i, unsigned n) { s.erase(i, n); }
+
+private:
+  static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+  void format(double v, int decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    s = buf;
+  }
+};
+
+inline String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+inline String operator+(const String& a, const char* b) { return String(a.s + b); }
+inline String operator+(const char* a, const String& b) { return String(std::string(a) + b.s); }
+inline String operator+(const String& a, char b) { return String(a.s + b); }
+inline String operator+(const String& a, int b) { return String(a.s + std::to_string(b)); }
+inline String operator+(const String& a, unsigned long b) { return String(a.s + std::to_string(b)); }
+
+// === PRINT / SERIAL ===
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) { return 1; }
+  virtual size_t write(const uint8_t*, size_t n) { return n; }
+  size_t write(const char* str) { return str ? strlen(str) : 0; }
+  void flush() {}
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+  size_t print(const String& v);
+  size_t print(const char* v);
+  size_t print(char v);
+  size_t print(unsigned char v, int base = DEC);
+  size_t print(int v, int base = DEC);
+  size_t print(unsigned v, int base = DEC);
+  size_t print(long v, int base = DEC);
+  size_t print(unsigned long v, int base = DEC);
+  size_t print(double v, int decimals = 2);
+  size_t println();
+  size_t println(const String& v);
+  size_t println(const char* v);
+  size_t println(char v);
+  size_t println(unsigned char v, int base = DEC);
+  size_t println(int v, int base = DEC);
+  size_t println(unsigned v, int base = DEC);
+  size_t println(long v, int base = DEC);
+  size_t println(unsigned long v, int base = DEC);
+  size_t println(double v, int decimals = 2);
+};
+
+class Stream : public Print {
+public:
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  int peek() { return -1; }
+  size_t readBytes(uint8_t*, size_t) { return 0; }
+  size_t readBytes(char*, size_t) { return 0; }
+  String readStringUntil(char) { return String(); }
+  void setTimeout(unsigned long) {}
+};
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  operator bool() { return true; }
+};
+extern HardwareSerial Serial;
+
+// === NETWORK ADDRESS ===
+class IPAddress {
+public:
+  IPAddress() : addr(0) {}
+  IPAddress(uint32_t a) : addr(a) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+    : addr((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+  uint8_t operator[](int i) const { return (addr >> (8 * i)) & 0xFF; }
+  operator uint32_t() const { return addr; }
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(buf);
+  }
+
+private:
+  uint32_t addr;
+};
+
+// === CHIP ===
+class EspClass {
+public:
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getHeapSize() { return 320 * 1024; }
+  uint32_t getFreePsram() { return 0; }
+  uint32_t getPsramSize() { return 0; }
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint32_t getCycleCount() { return (uint32_t)micros() * 240; }
+  uint32_t getFlashChipSize() { return 8 * 1024 * 1024; }
+  uint32_t getFlashChipSpeed() { return 80000000; }
+  uint32_t getSketchSize() { return 0; }
+  uint32_t getFreeSketchSpace() { return 0; }
+  uint8_t getChipRevision() { return 0; }
+  uint64_t getEfuseMac() { return 0; }
+  const char* getChipModel() { return "host"; }
+  const char* getSdkVersion() { return "host"; }
+  void restart() {}
+};
+extern EspClass ESP;
+
+// === FREERTOS ===
+typedef void* TaskHandle_t;
+typedef void* QueueHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+struct portMUX_TYPE { int owner; };
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(m) (void)(m)
+#define portEXIT_CRITICAL(m) (void)(m)
+#define portENTER_CRITICAL_ISR(m) (void)(m)
+#define portEXIT_CRITICAL_ISR(m) (void)(m)
+#define portYIELD_FROM_ISR() do {} while (0)
+#define portMAX_DELAY 0xffffffff
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(x) (x)
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+
+TaskHandle_t xTaskGetCurrentTaskHandle();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+BaseType_t xTaskCreate(void (*fn)(void*), const char* name, uint32_t stack, void* arg,
+                       UBaseType_t prio, TaskHandle_t* handle);
+BaseType_t xTaskCreatePinnedToCore(void (*fn)(void*), const char* name, uint32_t stack, void* arg,
+                                   UBaseType_t prio, TaskHandle_t* handle, int core);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* last, TickType_t ticks);
+void vTaskDelete(TaskHandle_t task);
+TickType_t xTaskGetTickCount();
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken);
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+
+// === HEAP / TIMER ===
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+int64_t esp_timer_get_time();
@@ -0,0 +1,42 @@
+// Host stand-in for LittleFS: paths map to the host file system (test working directory)
+#pragma once
+
+#include <Arduino.h>
+
+class File {
+public:
+  File() {}
+  File(FILE* fp) : f(fp) {}
+  operator bool() const { return f != nullptr; }
+  size_t size() {
+    long pos = ftell(f);
+    fseek(f, 0, SEEK_END);
+    long end = ftell(f);
+    fseek(f, pos, SEEK_SET);
+    return (size_t)end;
+  }
+  size_t read(uint8_t* buf, size_t n) { return fread(buf, 1, n, f); }
+  void close() {
+    if (f) fclose(f);
+    f = nullptr;
+  }
+
+private:
+  FILE* f = nullptr;
+};
+
+class LittleFSFS {
+public:
+  bool begin(bool = false) { return true; }
+  bool exists(const char* path) { return path && path[0] == '/' && access(path + 1); }
+  File open(const char* path, const char* mode = "r") { return File(fopen(path + 1, mode)); }
+
+private:
+  static bool access(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f) fclose(f);
+    return f != nullptr;
+  }
+};
+
+static LittleFSFS LittleFS;
@@ -0,0 +1,31 @@
+// Host stand-in for the Arduino-ESP32 WiFi class: station never connected
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <WiFiServer.h>
+
+#define WL_IDLE_STATUS 0
+#define WL_NO_SSID_AVAIL 1
+#define WL_CONNECTED 3
+#define WL_CONNECT_FAILED 4
+#define WL_CONNECTION_LOST 5
+#define WL_DISCONNECTED 6
+
+typedef int wl_status_t;
+
+class WiFiClass {
+public:
+  wl_status_t status() { return WL_DISCONNECTED; }
+  bool isConnected() { return false; }
+  IPAddress localIP() { return IPAddress(); }
+  IPAddress gatewayIP() { return IPAddress(); }
+  IPAddress subnetMask() { return IPAddress(); }
+  IPAddress dnsIP(int = 0) { return IPAddress(); }
+  String SSID() { return String(); }
+  String macAddress() { return String("00:00:00:00:00:00"); }
+  int32_t RSSI() { return 0; }
+  int32_t channel() { return 0; }
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,15 @@
+// Host stand-in for the Arduino-ESP32 WiFiClient: never connected
+#pragma once
+
+#include <Arduino.h>
+
+class WiFiClient : public Stream {
+public:
+  bool connected() { return false; }
+  void stop() {}
+  operator bool() { return false; }
+  IPAddress remoteIP() { return IPAddress(); }
+  uint16_t remotePort() { return 0; }
+  int read(uint8_t*, size_t) { return 0; }
+  int setNoDelay(bool) { return 0; }
+};
@@ -0,0 +1,16 @@
+// Host stand-in for the Arduino-ESP32 WiFiServer: never accepts
+#pragma once
+
+#include <WiFiClient.h>
+
+class WiFiServer {
+public:
+  WiFiServer(uint16_t = 80, uint8_t = 4) {}
+  void begin(uint16_t = 0) {}
+  void end() {}
+  WiFiClient accept() { return WiFiClient(); }
+  WiFiClient available() { return WiFiClient(); }
+  bool hasClient() { return false; }
+  void setNoDelay(bool) {}
+  operator bool() { return true; }
+};
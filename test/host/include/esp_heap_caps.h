@@ -0,0 +1,16 @@
+// Host stand-in for ESP-IDF heap_caps_get_info(), backed by host_runtime's heap values
+#pragma once
+
+#include <Arduino.h>
+
+typedef struct {
+  size_t total_free_bytes;
+  size_t total_allocated_bytes;
+  size_t largest_free_block;
+  size_t minimum_free_bytes;
+  size_t allocated_blocks;
+  size_t free_blocks;
+  size_t total_blocks;
+} multi_heap_info_t;
+
+void heap_caps_get_info(multi_heap_info_t* info, uint32_t caps);
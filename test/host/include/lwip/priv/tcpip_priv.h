@@ -0,0 +1,9 @@
+// Host stand-in for lwIP tcpip_api_call(): the body runs in the caller
+#pragma once
+
+#include "lwip/tcp.h"
+
+struct tcpip_api_call_data { err_t err; };
+typedef err_t (*tcpip_api_call_fn)(struct tcpip_api_call_data* call);
+
+err_t tcpip_api_call(tcpip_api_call_fn fn, struct tcpip_api_call_data* call);
@@ -0,0 +1,80 @@
+// Host stand-in for the lwIP raw TCP API: the declarations modbus_transport
+// uses. The behaviour is in test/host/fake_lwip.cpp.
+#pragma once
+
+#include <stdint.h>
+
+typedef int8_t err_t;
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef uint32_t u32_t;
+
+#define ERR_OK    0
+#define ERR_MEM  -1
+#define ERR_VAL  -6
+#define ERR_USE  -8
+#define ERR_ABRT -13
+
+#define TCP_WRITE_FLAG_COPY 0x01
+#define TCP_SND_QUEUELEN    32
+#define TF_NODELAY          0x40
+
+struct ip4_addr { u32_t addr; };
+typedef struct { struct ip4_addr ip4; } ip_addr_t;
+#define ip_2_ip4(a) (&(a)->ip4)
+#define ip4_addr_get_u32(a) ((a)->addr)
+extern ip_addr_t ip_addr_any;
+#define IP_ADDR_ANY (&ip_addr_any)
+
+struct pbuf {
+  struct pbuf* next;
+  void* payload;
+  u16_t tot_len;
+  u16_t len;
+};
+
+struct tcp_pcb;
+
+typedef err_t (*tcp_accept_fn)(void* arg, struct tcp_pcb* newpcb, err_t err);
+typedef err_t (*tcp_recv_fn)(void* arg, struct tcp_pcb* tpcb, struct pbuf* p, err_t err);
+typedef err_t (*tcp_sent_fn)(void* arg, struct tcp_pcb* tpcb, u16_t len);
+typedef void (*tcp_err_fn)(void* arg, err_t err);
+typedef err_t (*tcp_poll_fn)(void* arg, struct tcp_pcb* tpcb);
+
+// Callbacks and send state the fake keeps per pcb
+struct tcp_pcb {
+  ip_addr_t remote_ip;
+  u16_t snd_buf;
+  u16_t snd_queuelen;
+  u8_t flags;
+  void* callback_arg;
+  tcp_accept_fn accept;
+  tcp_recv_fn recv;
+  tcp_sent_fn sent;
+  tcp_err_fn errf;
+  tcp_poll_fn poll;
+};
+
+#define tcp_sndbuf(pcb)         ((pcb)->snd_buf)
+#define tcp_sndqueuelen(pcb)    ((pcb)->snd_queuelen)
+#define tcp_nagle_disable(pcb)  ((pcb)->flags |= TF_NODELAY)
+
+struct tcp_pcb* tcp_new(void);
+err_t tcp_bind(struct tcp_pcb* pcb, const ip_addr_t* ipaddr, u16_t port);
+struct tcp_pcb* tcp_listen_with_backlog(struct tcp_pcb* pcb, u8_t backlog);
+void tcp_accept(struct tcp_pcb* pcb, tcp_accept_fn accept);
+void tcp_arg(struct tcp_pcb* pcb, void* arg);
+void tcp_recv(struct tcp_pcb* pcb, tcp_recv_fn recv);
+void tcp_sent(struct tcp_pcb* pcb, tcp_sent_fn sent);
+void tcp_err(struct tcp_pcb* pcb, tcp_err_fn err);
+void tcp_poll(struct tcp_pcb* pcb, tcp_poll_fn poll, u8_t interval);
+void tcp_recved(struct tcp_pcb* pcb, u16_t len);
+err_t tcp_write(struct tcp_pcb* pcb, const void* dataptr, u16_t len, u8_t apiflags);
+err_t tcp_output(struct tcp_pcb* pcb);
+err_t tcp_close(struct tcp_pcb* pcb);
+void tcp_abort(struct tcp_pcb* pcb);
+
+u8_t pbuf_free(struct pbuf* p);
+void pbuf_cat(struct pbuf* head, struct pbuf* tail);
+u16_t pbuf_copy_partial(const struct pbuf* p, void* dataptr, u16_t len, u16_t offset);
+struct pbuf* pbuf_free_header(struct pbuf* q, u16_t size);
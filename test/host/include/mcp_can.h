@@ -0,0 +1,45 @@
+// Host stand-in for the MCP2515 library: no controller, nothing received
+#pragma once
+
+#include <Arduino.h>
+
+#define CAN_OK 0
+#define CAN_FAILINIT 1
+#define CAN_MSGAVAIL 3
+#define CAN_NOMSG 4
+#define CAN_CTRLERROR 5
+#define CAN_FAIL 0xff
+
+#define CAN_5KBPS 1
+#define CAN_10KBPS 2
+#define CAN_20KBPS 3
+#define CAN_31K25BPS 4
+#define CAN_33KBPS 5
+#define CAN_40KBPS 6
+#define CAN_50KBPS 7
+#define CAN_80KBPS 8
+#define CAN_83K3BPS 9
+#define CAN_95KBPS 10
+#define CAN_100KBPS 11
+#define CAN_125KBPS 12
+#define CAN_200KBPS 13
+#define CAN_250KBPS 14
+#define CAN_500KBPS 15
+#define CAN_666KBPS 16
+#define CAN_1000KBPS 17
+
+class MCP_CAN {
+public:
+  MCP_CAN(uint8_t) {}
+  uint8_t begin(uint8_t) { return CAN_OK; }
+  uint8_t checkReceive() { return CAN_NOMSG; }
+  uint8_t readMsgBuf(uint8_t*, uint8_t*) { return CAN_NOMSG; }
+  unsigned long getCanId() { return 0; }
+  uint8_t isExtendedFrame() { return 0; }
+  uint8_t isRemoteRequest() { return 0; }
+  uint8_t sendMsgBuf(unsigned long, uint8_t, uint8_t, uint8_t*) { return CAN_OK; }
+  uint8_t checkError() { return CAN_OK; }
+  uint8_t getError() { return 0; }
+  uint8_t errorCountRX() { return 0; }
+  uint8_t errorCountTX() { return 0; }
+};
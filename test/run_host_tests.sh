@@ -0,0 +1,61 @@
+#!/bin/bash
+# =====================================================================
+# run_host_tests.sh - Build and run the host tests in test/test_*/
+# =====================================================================
+#
+# Each test is one program, test/test_<name>/test_<name>.cpp, built with
+# g++ -Wall -Wextra against the stand-in headers in test/host/include and
+# the firmware sources named on its "// HOST_SOURCES:" line. Every symbol
+# must resolve: modules a test does not link are replaced by stubs in
+# test/host/fake_*.cpp or in the test itself. A test passes when it exits
+# with 0.
+#
+#   test/run_host_tests.sh                  # all tests
+#   test/run_host_tests.sh trio_sequencer   # selected tests
+#
+# Build output goes to $HOST_TEST_BUILD (default /tmp/esp32s3_host_tests).
+# =====================================================================
+
+set -u
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT=${HOST_TEST_BUILD:-/tmp/esp32s3_host_tests}
+CXX=${CXX:-g++}
+mkdir -p "$OUT"
+
+passed=0
+failed=0
+for dir in "$ROOT"/test/test_*/; do
+  name=$(basename "$dir")
+  name=${name#test_}
+  if [ $# -gt 0 ] && [[ " $* " != *" $name "* ]]; then
+    continue
+  fi
+
+  main="$dir/test_$name.cpp"
+  sources=""
+  for src in $(sed -n 's|^// HOST_SOURCES:||p' "$main"); do
+    sources="$sources $ROOT/$src"
+  done
+
+  echo "=== $name"
+  if ! $CXX -std=gnu++17 -O1 -g -Wall -Wextra \
+      -isystem "$ROOT/test/host/include" -I "$ROOT/test/host" -I "$ROOT/include" -I "$ROOT/src" \
+      "$main" "$ROOT/test/host/host_runtime.cpp" $sources \
+      -o "$OUT/$name"; then
+    echo "--- $name: BUILD FAILED"
+    failed=$((failed + 1))
+    continue
+  fi
+
+  if (cd "$dir" && "$OUT/$name"); then
+    echo "--- $name: PASS"
+    passed=$((passed + 1))
+  else
+    echo "--- $name: FAIL"
+    failed=$((failed + 1))
+  fi
+done
+
+echo "=== $passed passed, $failed failed"
+[ $failed -eq 0 ]
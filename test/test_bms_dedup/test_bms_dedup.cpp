@@ -0,0 +1,167 @@
+// =====================================================================
+// === test_bms_dedup.cpp - Duplicate BMS payload suppression ===
+// =====================================================================
+//
+// Replays a synthetic trace of 16 packs x 9 frame types, one cycle per
+// 100 ms: 190/290/490 change every cycle, the slow frames change in one
+// cycle out of 20. The frame events are consumed like the Modbus
+// subscriber (register block remap per 16 frames). The same trace runs
+// with suppression off and on.
+//
+// Checked: fewer frame events with suppression, every eligible frame
+// counted as parsed or suppressed, identical register blocks and frame
+// freshness at the end of both runs.
+//
+// Printed, not checked: host CPU time of parse + remap in both runs. It
+// varies with the host and says nothing about a whole loop pass on the
+// device; measure that with a burst replay (/api/can/dispatch?dedup=0|1).
+//
+// HOST_SOURCES: src/bms_protocol.cpp src/bms_data.cpp src/event_bus.cpp src/mem_pool.cpp
+// HOST_SOURCES: src/modbus_tcp.cpp test/host/fake_bms_neighbours.cpp
+//
+// =====================================================================
+
+#include "host_runtime.h"
+#include "bms_protocol.h"
+#include "bms_data.h"
+#include "modbus_tcp.h"
+#include "event_bus.h"
+#include <chrono>
+
+extern SystemConfig systemConfig;
+
+static const int TRACE_PACKS = 16;
+static const int TRACE_CYCLES = 2000;
+static const unsigned long TRACE_CYCLE_MS = 100;
+static const int TRACE_SLICE_FRAMES = 16;
+
+static const unsigned long frameBases[] = {
+  CAN_FRAME_190_BASE, CAN_FRAME_290_BASE, CAN_FRAME_310_BASE, CAN_FRAME_390_BASE, CAN_FRAME_410_BASE,
+  CAN_FRAME_510_BASE, CAN_FRAME_490_BASE, CAN_FRAME_1B0_BASE, CAN_FRAME_710_BASE
+};
+static const BMSFrameType_t frameTypes[] = {
+  BMS_FRAME_TYPE_190, BMS_FRAME_TYPE_290, BMS_FRAME_TYPE_310, BMS_FRAME_TYPE_390, BMS_FRAME_TYPE_410,
+  BMS_FRAME_TYPE_510, BMS_FRAME_TYPE_490, BMS_FRAME_TYPE_1B0, BMS_FRAME_TYPE_710
+};
+static const int FRAME_KINDS = sizeof(frameBases) / sizeof(frameBases[0]);
+
+typedef struct {
+  unsigned long events;
+  unsigned long eligibleFrames;
+  unsigned long parsed;
+  unsigned long suppressed;
+  unsigned long cpuUs;
+  uint16_t registers[TRACE_PACKS * 200];
+  unsigned long timestamps[TRACE_PACKS][BMS_FRAME_TYPE_COUNT];
+} TraceRun_t;
+
+static int8_t traceSub = -1;
+
+static void consumeFrameEvents(TraceRun_t* run) {
+  Event_t event;
+  uint32_t dirty = 0;
+  while (pollEvent(traceSub, &event)) {
+    run->events++;
+    int slot = getBMSIndexByNodeId(event.source);
+    if (slot >= 0 && slot < TRACE_PACKS) dirty |= 1UL << slot;
+  }
+  for (int i = 0; i < TRACE_PACKS; i++) {
+    if (dirty & (1UL << i)) updateModbusRegisters(systemConfig.bmsNodeIds[i]);
+  }
+}
+
+static void runTrace(bool dedup, TraceRun_t* run) {
+  memset(run, 0, sizeof(*run));
+  hostSetMillis(10000);
+  initializeBMSData();
+  setBMSDedupEnabled(dedup);
+  setBMSDedupTypes(BMS_DEDUP_DEFAULT_TYPES);
+  resetBMSDedupStats();
+  consumeFrameEvents(run);
+  run->events = 0;
+
+  srand(98);
+  unsigned char payload[TRACE_PACKS][FRAME_KINDS][8];
+  for (int n = 0; n < TRACE_PACKS; n++) {
+    for (int f = 0; f < FRAME_KINDS; f++) {
+      for (int k = 0; k < 8; k++) payload[n][f][k] = (unsigned char)(n * 7 + f * 13 + k);
+    }
+  }
+
+  int sliceFrames = 0;
+  unsigned long cpuUs = 0;
+  for (int c = 0; c < TRACE_CYCLES; c++) {
+    for (int n = 0; n < TRACE_PACKS; n++) {
+      for (int f = 0; f < FRAME_KINDS; f++) {
+        unsigned char* buf = payload[n][f];
+        if (f <= 1 || frameTypes[f] == BMS_FRAME_TYPE_490) {
+          buf[c % 8] ^= rand() & 0xFF;             // Fast frames change every cycle
+        } else if (rand() % 20 == 0) {
+          buf[3] ^= 1;                             // Slow frames now and then
+        }
+        if (BMS_DEDUP_DEFAULT_TYPES & (1U << frameTypes[f])) run->eligibleFrames++;
+
+        auto t0 = std::chrono::steady_clock::now();
+        parseCANFrame(frameBases[f] + n, 8, buf);
+        if (++sliceFrames == TRACE_SLICE_FRAMES) {
+          sliceFrames = 0;
+          consumeFrameEvents(run);
+        }
+        cpuUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+      }
+    }
+    hostAdvanceMs(TRACE_CYCLE_MS);
+  }
+  consumeFrameEvents(run);
+
+  const BMSDedupStats_t* stats = getBMSDedupStats();
+  for (uint8_t t = 0; t < BMS_FRAME_TYPE_COUNT; t++) {
+    run->parsed += stats->parsed[t];
+    run->suppressed += stats->suppressed[t];
+  }
+  run->cpuUs = cpuUs;
+  for (int n = 0; n < TRACE_PACKS; n++) {
+    updateModbusRegisters(systemConfig.bmsNodeIds[n]);   // Same refresh time for both runs
+    BMSData* bms = getBMSData(systemConfig.bmsNodeIds[n]);
+    if (bms) memcpy(run->timestamps[n], bms->frameTimestamps, sizeof(run->timestamps[n]));
+  }
+  memcpy(run->registers, holdingRegisters, sizeof(run->registers));
+}
+
+static TraceRun_t runs[2];
+
+int main() {
+  hostSerialEcho = false;
+  systemConfig.activeBmsNodes = TRACE_PACKS;
+  for (int i = 0; i < TRACE_PACKS; i++) systemConfig.bmsNodeIds[i] = i + 1;
+  initEventBus();
+  traceSub = subscribeEvents("trace", EVENT_MASK(EVENT_BMS_FRAME_PARSED));
+
+  runTrace(false, &runs[0]);
+  runTrace(true, &runs[1]);
+  const TraceRun_t* off = &runs[0];
+  const TraceRun_t* on = &runs[1];
+
+  unsigned long frames = (unsigned long)TRACE_CYCLES * TRACE_PACKS * FRAME_KINDS;
+  printf("%lu frames, %lu eligible\n", frames, on->eligibleFrames);
+  printf("suppression off: %lu events, %lu us\n", off->events, off->cpuUs);
+  printf("suppression on:  %lu events, %lu us (%+.1f%%), %lu parsed, %lu suppressed\n", on->events, on->cpuUs,
+         off->cpuUs > 0 ? 100.0f * ((float)on->cpuUs - off->cpuUs) / off->cpuUs : 0.0f, on->parsed, on->suppressed);
+
+  HOST_CHECK(off->events == frames);
+  HOST_CHECK(off->suppressed == 0);
+  HOST_CHECK(on->events + on->suppressed == frames);
+  HOST_CHECK(on->parsed + on->suppressed == on->eligibleFrames);
+  HOST_CHECK(on->suppressed > on->eligibleFrames / 2);
+
+  int differing = 0;
+  for (int r = 0; r < TRACE_PACKS * 200; r++) {
+    if (off->registers[r] != on->registers[r]) {
+      if (differing++ < 5) printf("register %d: %u (off) vs %u (on)\n", r, off->registers[r], on->registers[r]);
+    }
+  }
+  HOST_CHECK(differing == 0);
+  HOST_CHECK(memcmp(off->timestamps, on->timestamps, sizeof(off->timestamps)) == 0);
+
+  return hostTestResult();
+}
@@ -0,0 +1,128 @@
+// =====================================================================
+// === test_modbus_fixed_point.cpp - Fixed-point BMS register encoding ===
+// =====================================================================
+//
+// Feeds every 16-bit raw value (every 8-bit value for SOC) through the
+// fixed-point fields of frames 190/290/310/390/510, decodes them with
+// decodeBMSFrameData() and maps them with mapBMSDataToModbus(). Each
+// register is compared with:
+//   - the exact integer result (raw x multiplier, saturated at 65535),
+//   - the float path used before modbus_tcp.cpp v4.1.1
+//     (floatToModbusRegister(float field, scale)).
+//
+// The integer path must be exact. Against the old float path a register
+// may only be equal or +1 LSB (where float truncated below the exact
+// value); the number of +1 values per register is pinned so any further
+// SCADA-visible change shows up here.
+//
+// HOST_SOURCES: src/bms_protocol.cpp src/bms_data.cpp src/event_bus.cpp src/mem_pool.cpp
+// HOST_SOURCES: src/modbus_tcp.cpp test/host/fake_bms_neighbours.cpp
+//
+// =====================================================================
+
+#include "host_runtime.h"
+#include "bms_protocol.h"
+#include "bms_data.h"
+#include "modbus_tcp.h"
+
+extern SystemConfig systemConfig;
+
+typedef struct {
+  const char* name;
+  uint8_t offset;                   // Register in the BMS block
+  uint32_t limit;                   // Raw values tested: 0 .. limit-1
+  unsigned long expectedPlusOne;    // Registers +1 LSB against the float path
+  unsigned long plusOne;
+  unsigned long otherDiffs;
+  unsigned long inexact;
+} FieldCheck_t;
+
+// Counts of +1 values as published in the modbus_tcp.cpp v4.1.1 history
+static FieldCheck_t fields[] = {
+  { "voltage [mV]",         0, 65536,  1905, 0, 0, 0 },
+  { "current [mA]",         1, 65536,  1905, 0, 0, 0 },
+  { "energy [0.01kWh]",     2, 65536, 16172, 0, 0, 0 },
+  { "soc [0.1%]",           3,   256,     0, 0, 0, 0 },
+  { "cell min [0.1mV]",    20, 65536,  4580, 0, 0, 0 },
+  { "cell mean [0.1mV]",   21, 65536,  4580, 0, 0, 0 },
+  { "soh [0.1%]",          30, 65536,     0, 0, 0, 0 },
+  { "dcir [0.1mOhm]",      33, 65536,     0, 0, 0, 0 },
+  { "cell max [0.1mV]",    40, 65536,  4580, 0, 0, 0 },
+  { "cell delta [0.1mV]",  41, 65536,  4580, 0, 0, 0 },
+  { "dccl [mA]",           60, 65536,     6, 0, 0, 0 },
+  { "ddcl [mA]",           61, 65536,     6, 0, 0, 0 },
+};
+static const int FIELD_COUNT = sizeof(fields) / sizeof(fields[0]);
+
+static uint16_t saturate(uint32_t value) {
+  return value > 65535 ? 65535 : (uint16_t)value;
+}
+
+// Register value before v4.1.1 and the exact value, from the decoded fields
+static void referenceValues(int field, const BMSData* b, uint32_t raw, uint16_t* oldValue, uint16_t* exact) {
+  switch (fields[field].offset) {
+    case 0:  *oldValue = floatToModbusRegister(b->batteryVoltage, 1000);     *exact = saturate(raw * 10);  break;
+    case 1:  *oldValue = floatToModbusRegister(b->batteryCurrent, 1000);     *exact = saturate(raw * 10);  break;
+    case 2:  *oldValue = floatToModbusRegister(b->remainingEnergy, 100);     *exact = raw;                 break;
+    case 3:  *oldValue = floatToModbusRegister(b->soc, 10);                  *exact = raw * 5;             break;
+    case 20: *oldValue = floatToModbusRegister(b->cellMinVoltage, 10000);    *exact = raw;                 break;
+    case 21: *oldValue = floatToModbusRegister(b->cellMeanVoltage, 10000);   *exact = raw;                 break;
+    case 30: *oldValue = floatToModbusRegister(b->soh, 10);                  *exact = raw / 10;            break;
+    case 33: *oldValue = floatToModbusRegister(b->dcir, 10);                 *exact = raw / 10;            break;
+    case 40: *oldValue = floatToModbusRegister(b->cellMaxVoltage, 10000);    *exact = raw;                 break;
+    case 41: *oldValue = floatToModbusRegister(b->cellVoltageDelta, 10000);  *exact = raw;                 break;
+    case 60: *oldValue = floatToModbusRegister(b->dccl, 1000);               *exact = saturate(raw * 100); break;
+    default: *oldValue = floatToModbusRegister(b->ddcl, 1000);               *exact = saturate(raw * 100); break;
+  }
+}
+
+int main() {
+  hostSerialEcho = false;
+  systemConfig.activeBmsNodes = 1;
+  systemConfig.bmsNodeIds[0] = 1;
+  initializeBMSData();
+  BMSData* bms = getBMSData(1);
+  HOST_CHECK(bms != nullptr);
+  if (bms == nullptr) return hostTestResult();
+
+  unsigned char frame190[8] = { 0 };
+  unsigned char frameLE[8] = { 0 };
+  for (uint32_t raw = 0; raw < 65536; raw++) {
+    // 190 is big-endian, 290/310/390/510 little-endian; all fields get the same raw value
+    frame190[0] = frame190[2] = frame190[4] = raw >> 8;
+    frame190[1] = frame190[3] = frame190[5] = raw & 0xFF;
+    frame190[6] = raw & 0xFF;
+    frameLE[0] = frameLE[2] = raw & 0xFF;
+    frameLE[1] = frameLE[3] = raw >> 8;
+    decodeBMSFrameData(BMS_FRAME_TYPE_190, frame190, bms);
+    decodeBMSFrameData(BMS_FRAME_TYPE_290, frameLE, bms);
+    decodeBMSFrameData(BMS_FRAME_TYPE_310, frameLE, bms);
+    decodeBMSFrameData(BMS_FRAME_TYPE_390, frameLE, bms);
+    decodeBMSFrameData(BMS_FRAME_TYPE_510, frameLE, bms);
+    mapBMSDataToModbus(1, *bms);
+
+    for (int f = 0; f < FIELD_COUNT; f++) {
+      FieldCheck_t* check = &fields[f];
+      if (raw >= check->limit) continue;
+      uint16_t oldValue, exact;
+      referenceValues(f, bms, raw, &oldValue, &exact);
+      uint16_t value = holdingRegisters[GET_BMS_BASE_ADDRESS(0) + check->offset];
+      if (value != exact) check->inexact++;
+      if (value == (uint16_t)(oldValue + 1)) {
+        check->plusOne++;
+      } else if (value != oldValue) {
+        check->otherDiffs++;
+      }
+    }
+  }
+
+  for (int f = 0; f < FIELD_COUNT; f++) {
+    const FieldCheck_t* check = &fields[f];
+    printf("%-20s +1 LSB: %5lu (expected %5lu), other: %lu, inexact: %lu\n", check->name,
+           check->plusOne, check->expectedPlusOne, check->otherDiffs, check->inexact);
+    HOST_CHECK(check->inexact == 0);
+    HOST_CHECK(check->otherDiffs == 0);
+    HOST_CHECK(check->plusOne == check->expectedPlusOne);
+  }
+  return hostTestResult();
+}
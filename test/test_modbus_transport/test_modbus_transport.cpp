@@ -0,0 +1,272 @@
+// =====================================================================
+// === test_modbus_transport.cpp - Modbus TCP on the lwIP raw API ===
+// =====================================================================
+//
+// Runs modbus_transport.cpp and modbus_tcp.cpp against the fake lwIP in
+// test/host/fake_lwip.cpp: the test accepts connections, delivers request
+// streams cut into pbufs and acknowledges what was written.
+//
+// Checked:
+//   - FC03 answered in the receive callback, in place and without copy,
+//     one tcp_output() per response, Nagle off
+//   - pipelined requests cut at every segment size, reassembled in order
+//   - writes and errors via the main loop; a read behind a write waits
+//   - backpressure (no send room: held until acknowledged), no-copy TX
+//     buffer never reused while unacknowledged
+//   - 3 connection slots, framing errors abort, a slot held by the main
+//     loop survives the client's close, idle timeout
+//   - fast-path reads counted in the Modbus statistics
+//   - COV window selection per connection, reset for a new client
+//   - no pbuf left allocated
+//
+// Printed, not checked: host time per 125-register FC03 in the callback.
+//
+// HOST_SOURCES: src/modbus_tcp.cpp src/modbus_transport.cpp src/modbus_cov.cpp
+// HOST_SOURCES: src/bms_data.cpp src/event_bus.cpp src/mem_pool.cpp src/statistics.cpp
+// HOST_SOURCES: test/host/fake_lwip.cpp
+//
+// =====================================================================
+
+#include "host_runtime.h"
+#include "fake_lwip.h"
+#include "modbus_tcp.h"
+#include "modbus_transport.h"
+#include "modbus_cov.h"
+#include "event_bus.h"
+#include "bms_sdo.h"
+#include "can_bus.h"
+#include "trio_hp_forecast.h"
+#include "trio_hp_limits.h"
+#include "trio_hp_params.h"
+#include "trio_hp_manager.h"
+#include "trio_hp_monitor.h"
+#include <chrono>
+#include <unistd.h>
+
+// === NEIGHBOURS (no TRIO HP parameter or SDO windows, no BMS nodes) ===
+SystemConfig systemConfig;
+static CANChannelStats_t channelStats;
+bool isTrioParamRegisterRange(uint16_t, uint16_t) { return false; }
+bool readTrioParamRegister(uint16_t, uint16_t*) { return false; }
+bool writeTrioParamRegister(uint16_t, uint16_t) { return false; }
+bool writeTrioParamRegisters(uint16_t, uint16_t, const uint16_t*) { return false; }
+bool isBMSSdoRegisterRange(uint16_t, uint16_t) { return false; }
+bool readBMSSdoRegister(uint16_t, uint16_t*) { return false; }
+bool writeBMSSdoRegister(uint16_t, uint16_t) { return false; }
+const CANChannelStats_t* getCANChannelStats(uint8_t) { return &channelStats; }
+const TrioPackForecast_t* getPackForecast(uint8_t) { return nullptr; }
+const TrioPackLimits_t* getPackLimits(uint8_t) { return nullptr; }
+bool isTrioHPManagerInitialized() { return false; }
+bool isModuleActive(uint8_t) { return false; }
+float getLatestValue(const TrioHPDataBuffer_t*) { return 0.0f; }
+const TrioHPModuleData_t* getModuleData(uint8_t) { return nullptr; }
+const TrioHPSystemData_t* getSystemData() { return nullptr; }
+
+typedef std::vector<uint8_t> Bytes;
+
+static Bytes fc03(uint16_t tx, uint16_t start, uint16_t count) {
+  return { (uint8_t)(tx >> 8), (uint8_t)tx, 0, 0, 0, 6, MODBUS_SLAVE_ID, 0x03,
+           (uint8_t)(start >> 8), (uint8_t)start, (uint8_t)(count >> 8), (uint8_t)count };
+}
+
+static Bytes fc06(uint16_t tx, uint16_t address, uint16_t value) {
+  return { (uint8_t)(tx >> 8), (uint8_t)tx, 0, 0, 0, 6, MODBUS_SLAVE_ID, 0x06,
+           (uint8_t)(address >> 8), (uint8_t)address, (uint8_t)(value >> 8), (uint8_t)value };
+}
+
+// Response to fc03() from the current register table
+static Bytes readResponse(uint16_t tx, uint16_t start, uint16_t count) {
+  Bytes r = { (uint8_t)(tx >> 8), (uint8_t)tx, 0, 0, (uint8_t)((3 + 2 * count) >> 8), (uint8_t)(3 + 2 * count),
+              MODBUS_SLAVE_ID, 0x03, (uint8_t)(2 * count) };
+  for (uint16_t i = 0; i < count; i++) {
+    r.push_back(holdingRegisters[start + i] >> 8);
+    r.push_back(holdingRegisters[start + i] & 0xFF);
+  }
+  return r;
+}
+
+static Bytes join(Bytes a, const Bytes& b) {
+  a.insert(a.end(), b.begin(), b.end());
+  return a;
+}
+
+// Value of one register read over `conn` through the main loop (COV window)
+static uint16_t readWindowRegister(HostTcpConnection_t* conn, uint16_t address) {
+  conn->delivered.clear();
+  hostTcpDeliver(conn, fc03(50, address, 1));
+  processModbusTCP();
+  hostTcpAckAll(conn);
+  if (conn->delivered.size() != 11) return 0xFFFF;
+  return (conn->delivered[9] << 8) | conn->delivered[10];
+}
+
+// printModbusStatistics() output, for the counters modbus_tcp keeps to itself
+static unsigned long printedStatistic(const char* label) {
+  static char text[4096];
+  fflush(stdout);
+  int saved = dup(fileno(stdout));
+  FILE* capture = tmpfile();
+  dup2(fileno(capture), fileno(stdout));
+  hostSerialEcho = true;
+  printModbusStatistics();
+  hostSerialEcho = false;
+  fflush(stdout);
+  dup2(saved, fileno(stdout));
+  close(saved);
+  rewind(capture);
+  size_t n = fread(text, 1, sizeof(text) - 1, capture);
+  text[n] = 0;
+  fclose(capture);
+
+  const char* line = strstr(text, label);
+  return line ? strtoul(line + strlen(label), nullptr, 10) : (unsigned long)-1;
+}
+
+int main() {
+  hostSerialEcho = false;
+  hostSetMillis(1000);
+  systemConfig.activeBmsNodes = 0;
+  initEventBus();
+  HOST_CHECK(setupModbusTCP());
+  for (int i = 0; i < 3200; i++) holdingRegisters[i] = i * 7 + 1;
+  const ModbusTransportStats_t* st = getModbusTransportStats();
+
+  // 1. Single read: answered in the callback from the pbuf, no copy
+  HostTcpConnection_t* a = hostTcpConnect(0x0100A8C0);
+  HOST_CHECK(a != nullptr);
+  HOST_CHECK(hostTcpDeliver(a, fc03(1, 10, 5)) == ERR_OK);
+  HOST_CHECK(a->unacked.size() == 1 && a->unacked[0].noCopy);
+  hostTcpAckAll(a);
+  HOST_CHECK(a->delivered == readResponse(1, 10, 5));
+  HOST_CHECK(a->recved == 12 && a->outputs == 1 && (a->pcb.flags & TF_NODELAY));
+
+  // 2. Statistics: fast-path reads count like main loop requests
+  HOST_CHECK(hostTcpDeliver(a, fc03(2, 0, 125)) == ERR_OK);
+  hostTcpAckAll(a);
+  HOST_CHECK(hostTcpDeliver(a, fc06(3, 30, 77)) == ERR_OK);
+  hostAdvanceMs(5);
+  processModbusTCP();
+  hostTcpAckAll(a);
+  HOST_CHECK(printedStatistic("Total Requests: ") == 3);
+  HOST_CHECK(printedStatistic("Total Responses: ") == 3);
+  HOST_CHECK(printedStatistic("Data: ") == 3 * 12);                          // Bytes received
+  HOST_CHECK(printedStatistic("bytes received, ") == (9 + 5 * 2) + (9 + 125 * 2) + 12);   // Bytes sent
+  HOST_CHECK(printedStatistic("Last Request: ") == 0);
+  HOST_CHECK(st->fastRequests == 2 && st->fastResponses == 2);
+
+  // 3. Pipelined reads cut at every segment size; responses written while
+  //    the previous one is unacknowledged are copied
+  for (size_t cut = 1; cut < 24; cut++) {
+    a->delivered.clear();
+    a->recved = 0;
+    Bytes in = join(join(fc03(100 + cut, 0, 125), fc03(200 + cut, 3000, 3)), fc03(300 + cut, 7, 1));
+    HOST_CHECK(hostTcpDeliver(a, in, cut) == ERR_OK);
+    hostTcpAckAll(a);
+    Bytes expected = join(join(readResponse(100 + cut, 0, 125), readResponse(200 + cut, 3000, 3)), readResponse(300 + cut, 7, 1));
+    HOST_CHECK(a->delivered == expected);
+    HOST_CHECK(a->recved == in.size());
+  }
+  HOST_CHECK(st->copiedResponses > 0 && st->reassembled > 0);
+
+  // 4. A write goes through the main loop; the read behind it waits (order kept)
+  a->delivered.clear();
+  Bytes in = join(fc06(7, 20, 0xBEEF), fc03(8, 20, 1));
+  HOST_CHECK(hostTcpDeliver(a, in, 5) == ERR_OK);
+  HOST_CHECK(a->unacked.empty());
+  processModbusTCP();
+  hostTcpAckAll(a);
+  HOST_CHECK(a->delivered == join(fc06(7, 20, 0xBEEF), readResponse(8, 20, 1)));
+  HOST_CHECK(holdingRegisters[20] == 0xBEEF);
+
+  // 5. Out of range read: exception from the main loop
+  a->delivered.clear();
+  HOST_CHECK(hostTcpDeliver(a, fc03(9, 3190, 20)) == ERR_OK);
+  processModbusTCP();
+  hostTcpAckAll(a);
+  HOST_CHECK(a->delivered.size() == 9 && a->delivered[7] == 0x83 && a->delivered[8] == MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+
+  // 6. Backpressure: no send room, the ADU stays held until an acknowledge
+  a->delivered.clear();
+  a->pcb.snd_buf = 100;
+  unsigned long stalls = st->stalls;
+  HOST_CHECK(hostTcpDeliver(a, fc03(10, 0, 2)) == ERR_OK);
+  HOST_CHECK(a->unacked.empty() && st->stalls == stalls + 1);
+  a->pcb.snd_buf = HOST_TCP_SNDBUF;
+  a->pcb.sent(a->pcb.callback_arg, &a->pcb, 0);
+  hostTcpAckAll(a);
+  HOST_CHECK(a->delivered == readResponse(10, 0, 2));
+
+  // 7. TX buffer lifetime: first response unacknowledged, second copied, both intact
+  a->delivered.clear();
+  HOST_CHECK(hostTcpDeliver(a, fc03(11, 0, 4)) == ERR_OK);
+  HOST_CHECK(hostTcpDeliver(a, fc03(12, 100, 4)) == ERR_OK);
+  HOST_CHECK(a->unacked.size() == 2 && a->unacked[0].noCopy && !a->unacked[1].noCopy);
+  hostTcpAckAll(a);
+  HOST_CHECK(a->delivered == join(readResponse(11, 0, 4), readResponse(12, 100, 4)));
+
+  // 8. COV selection is per connection; a new client in a slot starts at 0
+  HostTcpConnection_t* b = hostTcpConnect(2);
+  HOST_CHECK(b != nullptr);
+  uint16_t select = MODBUS_COV_START_REGISTER + MODBUS_COV_REG_SELECT;
+  hostTcpDeliver(a, fc06(20, select, 5));
+  processModbusTCP();
+  hostTcpAckAll(a);
+  HOST_CHECK(readWindowRegister(a, select) == 5);
+  HOST_CHECK(readWindowRegister(b, select) == 0);
+  hostTcpDeliver(b, fc06(21, select, 2));
+  processModbusTCP();
+  hostTcpAckAll(b);
+  HOST_CHECK(readWindowRegister(a, select) == 5);
+  HOST_CHECK(readWindowRegister(b, select) == 2);
+  HOST_CHECK(hostTcpRemoteClose(b) == ERR_OK && b->closed);
+  HostTcpConnection_t* b2 = hostTcpConnect(3);   // Same slot as b
+  HOST_CHECK(b2 != nullptr);
+  HOST_CHECK(readWindowRegister(b2, select) == 0);
+
+  // 9. Three slots: the fourth connection is refused
+  HostTcpConnection_t* c = hostTcpConnect(4);
+  HOST_CHECK(c != nullptr);
+  unsigned long rejected = st->rejected;
+  HOST_CHECK(hostTcpConnect(5) == nullptr && st->rejected == rejected + 1 && st->activeConnections == 3);
+  HOST_CHECK(getModbusTransportRemoteIP(1) == 3);
+
+  // 10. Bad MBAP length aborts the connection
+  HOST_CHECK(hostTcpDeliver(b2, { 0, 1, 0, 0, 0, 0, 1, 3 }) == ERR_ABRT && b2->aborted);
+  HOST_CHECK(st->framingErrors == 1 && st->activeConnections == 2);
+
+  // 11. Client closes while the main loop holds its ADU: slot kept until completed
+  HOST_CHECK(hostTcpDeliver(c, fc06(13, 21, 5)) == ERR_OK);
+  HOST_CHECK(hostTcpRemoteClose(c) == ERR_OK && c->closed);
+  HOST_CHECK(hostTcpConnect(6) != nullptr);      // Takes b2's slot
+  HOST_CHECK(hostTcpConnect(7) == nullptr);      // c's slot still held
+  processModbusTCP();
+  HOST_CHECK(holdingRegisters[21] == 5 && c->unacked.empty());
+  HOST_CHECK(hostTcpConnect(8) != nullptr);      // c's slot released
+
+  // 12. Idle connections closed from the poll callback
+  hostAdvanceMs(MODBUS_TCP_TIMEOUT_MS + 1);
+  unsigned long idleClosed = st->idleClosed;
+  HOST_CHECK(a->pcb.poll(a->pcb.callback_arg, &a->pcb) == ERR_OK && a->closed && st->idleClosed == idleClosed + 1);
+
+  // Host service time of a 125-register read in the callback
+  HostTcpConnection_t* h = hostTcpConnect(9);
+  HOST_CHECK(h != nullptr);
+  Bytes request = fc03(1, 0, 125);
+  auto t0 = std::chrono::steady_clock::now();
+  const int rounds = 100000;
+  for (int i = 0; i < rounds; i++) {
+    hostTcpDeliver(h, request);
+    h->unacked.clear();
+    h->pcb.snd_buf = HOST_TCP_SNDBUF;
+    h->pcb.snd_queuelen = 0;
+    h->pcb.sent(h->pcb.callback_arg, &h->pcb, 259);
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  printf("host FC03 x125 in the callback: %.2f us per request\n", us / rounds);
+
+  stopModbusTransport();
+  HOST_CHECK(hostLivePbufs == 0);
+  printf("fast %lu, queued %lu, reassembled %lu, copied %lu, stalls %lu, closed %lu\n", st->fastRequests,
+         st->queuedRequests, st->reassembled, st->copiedResponses, st->stalls, st->closed);
+  return hostTestResult();
+}
@@ -0,0 +1,259 @@
+// =====================================================================
+// === test_soak.cpp - Compressed soak run with heap/latency drift gate ===
+// =====================================================================
+//
+// Replays a 16-pack CAN traffic pattern (every frame type once per
+// simulated second), rebuilds the Modbus register blocks from the frame
+// events and polls every block with FC03, while the statistics sampler
+// from src/statistics.cpp takes its 10 s samples on the virtual clock.
+// SOAK_DAYS (default 1) simulated days run in seconds of host time.
+//
+// The run fails when:
+//   - the sampler raises heap or fragmentation drift (its own latency
+//     flag is not used: host scheduling noise trips it),
+//   - live heap blocks/bytes change after the one-hour warm-up,
+//   - an event subscriber drops frames or its queue keeps growing,
+//   - loop or Modbus p99 of the last simulated hour exceeds 1.5x (+2 us)
+//     the p99 of the first hour after warm-up.
+// A final canary phase leaks 64 B every 16 s and must raise heap drift.
+//
+// Heap: every operator new/delete of the linked firmware is counted; the
+// values feed ESP.getFreeHeap()/heap_caps_get_info(). Latencies are real
+// host time of each simulated loop pass and Modbus request.
+//
+// Web requests and WiFi reconnects are not simulated: the AsyncWebServer
+// and WiFi stacks do not exist on the host.
+//
+// HOST_SOURCES: src/bms_protocol.cpp src/bms_data.cpp src/event_bus.cpp
+// HOST_SOURCES: src/modbus_tcp.cpp src/mem_pool.cpp src/utils.cpp test/host/fake_bms_neighbours.cpp
+//
+// =====================================================================
+
+#include "host_runtime.h"
+#include "bms_protocol.h"
+#include "bms_data.h"
+#include "modbus_tcp.h"
+#include "event_bus.h"
+#include "mem_pool.h"
+#include "stall_monitor.h"
+#include "status_led.h"
+#include <chrono>
+#include <new>
+
+// Sampler internals (takeStatisticsSample) are file-static: build them into this test
+#include "../../src/statistics.cpp"
+
+extern SystemConfig systemConfig;
+
+// === NEIGHBOURS OF utils.cpp (no LED engine, no stall watchdog) ===
+bool initStatusLED() { return false; }
+bool isStatusLEDRunning() { return false; }
+void playStatusLEDOnce(uint8_t, uint16_t) {}
+uint8_t enterProfileZone(uint8_t) { return 0; }
+void leaveProfileZone() {}
+
+// === HEAP ACCOUNTING ===
+static const uint32_t SOAK_HEAP_BUDGET = 300000;
+static size_t liveBytes = 0;
+static size_t liveBlocks = 0;
+
+void* operator new(size_t size) {
+  size_t* p = (size_t*)malloc(size + sizeof(size_t) * 2);
+  if (p == nullptr) throw std::bad_alloc();
+  p[0] = size;
+  liveBytes += size;
+  liveBlocks++;
+  return p + 2;
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr == nullptr) return;
+  size_t* p = (size_t*)ptr - 2;
+  liveBytes -= p[0];
+  liveBlocks--;
+  free(p);
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { operator delete(ptr); }
+
+static void publishHeap() {
+  hostFreeHeap = liveBytes < SOAK_HEAP_BUDGET ? SOAK_HEAP_BUDGET - (uint32_t)liveBytes : 0;
+  hostLargestFreeBlock = hostFreeHeap;   // Counted heap only - no allocator layout on the host
+  hostAllocatedBlocks = (uint32_t)liveBlocks;
+}
+
+// === TRAFFIC ===
+static const int SOAK_PACKS = 16;
+static const unsigned long SOAK_PASS_MS = 1000;       // One full frame cycle per pass
+static const unsigned long SOAK_HOUR_PASSES = 3600000UL / SOAK_PASS_MS;
+
+static const unsigned long frameBases[] = {
+  CAN_FRAME_190_BASE, CAN_FRAME_290_BASE, CAN_FRAME_310_BASE, CAN_FRAME_390_BASE, CAN_FRAME_410_BASE,
+  CAN_FRAME_510_BASE, CAN_FRAME_490_BASE, CAN_FRAME_1B0_BASE, CAN_FRAME_710_BASE
+};
+
+static int8_t soakSub = -1;
+static unsigned long long passCounter = 0;
+static uint16_t maxQueueDepth = 0;
+
+static unsigned long elapsedUs(std::chrono::steady_clock::time_point start) {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+// Voltage/current/SOC wander slowly, 490 walks its multiplexer, the rest changes now and then
+static void sendPackFrames(int pack) {
+  unsigned char buf[8];
+  for (unsigned f = 0; f < sizeof(frameBases) / sizeof(frameBases[0]); f++) {
+    for (int k = 0; k < 8; k++) buf[k] = (unsigned char)(pack * 7 + f * 13 + k);
+    if (f <= 1) {
+      buf[0] = (unsigned char)(passCounter + pack);
+      buf[2] = (unsigned char)(passCounter >> 3);
+    } else if (frameBases[f] == CAN_FRAME_490_BASE) {
+      buf[0] = (unsigned char)(passCounter % 32);
+      buf[1] = (unsigned char)(passCounter >> 2);
+    } else if ((passCounter + f) % 7 == 0) {
+      buf[3] ^= 1;
+    }
+    parseCANFrame(frameBases[f] + pack, 8, buf);
+  }
+}
+
+static void consumeFrameEvents() {
+  EventSubscriberStats_t sub;
+  if (getEventSubscriberStats(soakSub, &sub) && sub.depth > maxQueueDepth) maxQueueDepth = sub.depth;
+
+  Event_t event;
+  uint32_t dirty = 0;
+  while (pollEvent(soakSub, &event)) {
+    int slot = getBMSIndexByNodeId(event.source);
+    if (slot >= 0 && slot < MAX_BMS_NODES) dirty |= 1UL << slot;
+  }
+  for (int i = 0; i < SOAK_PACKS; i++) {
+    if (dirty & (1UL << i)) updateModbusRegisters(systemConfig.bmsNodeIds[i]);
+  }
+}
+
+// SCADA poll: two FC03 reads (125 + 75 registers) per BMS block
+static void pollModbus() {
+  uint8_t request[12] = { 0x00, 0x01, 0x00, 0x00, 0x00, 0x06, 0x01, 0x03, 0, 0, 0, 0 };
+  static uint8_t response[MODBUS_MAX_FRAME_SIZE];
+  for (int i = 0; i < SOAK_PACKS; i++) {
+    for (int part = 0; part < 2; part++) {
+      uint16_t start = GET_BMS_BASE_ADDRESS(i) + part * 125;
+      uint16_t count = part == 0 ? 125 : 75;
+      request[1] = (uint8_t)(i * 2 + part);
+      request[8] = start >> 8;
+      request[9] = start & 0xFF;
+      request[10] = count >> 8;
+      request[11] = count & 0xFF;
+      auto t0 = std::chrono::steady_clock::now();
+      int len = buildModbusReadResponse(request, sizeof(request), response);
+      recordLatency(LATENCY_MODBUS_REQUEST, elapsedUs(t0));
+      if (len <= 0) HOST_CHECK(len > 0);
+    }
+  }
+}
+
+static void runPass() {
+  auto t0 = std::chrono::steady_clock::now();
+  for (int p = 0; p < SOAK_PACKS; p++) {
+    sendPackFrames(p);
+    consumeFrameEvents();            // The loop drains between receive batches
+  }
+  pollModbus();
+  updateHeapMetrics();
+  recordLatency(LATENCY_MAIN_LOOP, elapsedUs(t0));
+
+  passCounter++;
+  hostAdvanceMs(SOAK_PASS_MS);
+  publishHeap();
+  if (passCounter % (STATS_SAMPLE_INTERVAL_MS / SOAK_PASS_MS) == 0) takeStatisticsSample();
+}
+
+// Mean of the sampler's per-period p99 over the last hour of samples
+static float hourP99(LatencyChannel_t channel) {
+  uint8_t n = min((unsigned long)historyCount, 3600000UL / STATS_SAMPLE_INTERVAL_MS);
+  float sum = 0.0f;
+  for (uint8_t i = 0; i < n; i++) {
+    sum += history[(historyHead + STATS_HISTORY_SAMPLES - 1 - i) % STATS_HISTORY_SAMPLES].latencyP99[channel];
+  }
+  return n > 0 ? sum / n : 0.0f;
+}
+
+int main() {
+  hostSerialEcho = false;
+  const char* daysEnv = getenv("SOAK_DAYS");
+  float days = daysEnv ? atof(daysEnv) : 1.0f;
+  unsigned long totalPasses = (unsigned long)(days * 24 * SOAK_HOUR_PASSES);
+  if (totalPasses < 3 * SOAK_HOUR_PASSES) totalPasses = 3 * SOAK_HOUR_PASSES;
+
+  systemConfig.activeBmsNodes = SOAK_PACKS;
+  for (int i = 0; i < SOAK_PACKS; i++) systemConfig.bmsNodeIds[i] = i + 1;
+  initEventBus();
+  initializeBMSData();
+  soakSub = subscribeEvents("soak", EVENT_MASK(EVENT_BMS_FRAME_PARSED));
+  // setupModbusTCP() is not called: it opens the lwIP listener; FC03 is driven directly
+  publishHeap();
+
+  auto wall = std::chrono::steady_clock::now();
+
+  // Warm-up: first data from every pack, pools and tables settle
+  for (unsigned long i = 0; i < SOAK_HOUR_PASSES; i++) runPass();
+  size_t warmBytes = liveBytes;
+  size_t warmBlocks = liveBlocks;
+  for (unsigned long i = 0; i < SOAK_HOUR_PASSES; i++) runPass();
+  float firstLoopP99 = hourP99(LATENCY_MAIN_LOOP);
+  float firstModbusP99 = hourP99(LATENCY_MODBUS_REQUEST);
+
+  bool driftSeen = false;
+  for (unsigned long i = 2 * SOAK_HOUR_PASSES; i < totalPasses; i++) {
+    runPass();
+    StatsDrift_t d;
+    getStatsDrift(&d);
+    if (!driftSeen && (d.heapDrift || d.fragmentationDrift)) {
+      driftSeen = true;
+      printf("drift at %.2f h: heap %.0f B/h, fragmentation %.2f %%/h\n",
+             passCounter / (float)SOAK_HOUR_PASSES, d.heapSlope, d.fragmentationSlope);
+    }
+  }
+  float lastLoopP99 = hourP99(LATENCY_MAIN_LOOP);
+  float lastModbusP99 = hourP99(LATENCY_MODBUS_REQUEST);
+
+  StatsDrift_t drift;
+  getStatsDrift(&drift);
+  printf("soak: %.1f days (%lu passes, %llu frames) in %.1f s\n", passCounter / (24.0f * SOAK_HOUR_PASSES),
+         totalPasses, passCounter * SOAK_PACKS * 9, elapsedUs(wall) / 1e6f);
+  printf("heap: %zu B in %zu blocks after warm-up, %zu B in %zu blocks at end\n",
+         warmBytes, warmBlocks, liveBytes, liveBlocks);
+  printf("queue: max depth %u, drops %lu\n", maxQueueDepth, getEventDrops(soakSub));
+  printf("p99 loop: %.1f -> %.1f us, modbus: %.1f -> %.1f us\n",
+         firstLoopP99, lastLoopP99, firstModbusP99, lastModbusP99);
+  printf("slopes: heap %.1f B/h, fragmentation %.3f %%/h, alerts %lu\n",
+         drift.heapSlope, drift.fragmentationSlope, drift.driftAlerts);
+
+  HOST_CHECK(!driftSeen);
+  HOST_CHECK(liveBytes == warmBytes);
+  HOST_CHECK(liveBlocks == warmBlocks);
+  HOST_CHECK(getEventDrops(soakSub) == 0);
+  HOST_CHECK(maxQueueDepth < EVENT_QUEUE_SIZE);
+  HOST_CHECK(lastLoopP99 <= 1.5f * firstLoopP99 + 2.0f);
+  HOST_CHECK(lastModbusP99 <= 1.5f * firstModbusP99 + 2.0f);
+
+  // Canary: a slow leak must be reported as heap drift within the history window
+  static void* leaked[1024];
+  int leakCount = 0;
+  for (unsigned long i = 0; i < 2 * SOAK_HOUR_PASSES && leakCount < 1024; i++) {
+    if (i % 16 == 0) leaked[leakCount++] = operator new(64);
+    runPass();
+  }
+  getStatsDrift(&drift);
+  printf("canary: leaked %d B, heap slope %.0f B/h, drift %d\n", leakCount * 64, drift.heapSlope, drift.heapDrift);
+  HOST_CHECK(drift.heapDrift);
+  for (int i = 0; i < leakCount; i++) operator delete(leaked[i]);
+
+  return hostTestResult();
+}
@@ -0,0 +1,127 @@
+// =====================================================================
+// === test_trio_params.cpp - TRIO HP parameter batch writes ===
+// =====================================================================
+//
+// Host checks of trio_hp_params.cpp: a batch (setSystemLimits, profile
+// switch) and an FC16 block over the 5200 parameter window are applied
+// all or nothing, whether the rejection comes from a range check, a lock,
+// an unassigned register or a cross-field rule.
+//
+// HOST_SOURCES: src/trio_hp_params.cpp
+//
+// =====================================================================
+
+#include "host_runtime.h"
+#include "trio_hp_params.h"
+#include "trio_hp_config.h"
+#include "trio_hp_profiles.h"
+
+// === FAKE CONFIG / PROFILES ===
+TrioHPSystemConfig_t trioHPConfig;
+static int dirtyMarks = 0;
+static int profileEdits = 0;
+
+void markTrioHPConfigDirty() { dirtyMarks++; }
+void noteTrioProfileParamEdited() { profileEdits++; }
+
+bool validateTimingLimits(const TrioHPTimingConfig_t* timing) {
+  return timing->multicastFastInterval < timing->multicastSlowInterval;
+}
+
+static void resetConfig() {
+  memset(&trioHPConfig, 0, sizeof(trioHPConfig));
+  applyTrioParamDefaults(false);
+  dirtyMarks = 0;
+  profileEdits = 0;
+}
+
+static uint16_t reg(uint8_t offset) { return TRIO_HP_PARAM_MODBUS_START_REGISTER + offset; }
+
+static bool limitsUnchanged() {
+  return trioHPConfig.systemVoltageMax == 500.0f && trioHPConfig.systemCurrentMax == 100.0f &&
+         trioHPConfig.systemPowerMax == 50.0f && trioHPConfig.systemTempMax == 70.0f;
+}
+
+// Same batch as setSystemLimits(): one bad value leaves all four untouched
+static void testLimitsBatch() {
+  resetConfig();
+  TrioParamValue_t limits[] = {
+    { TRIO_PARAM_ID_SYSTEM_VOLTAGE_MAX, 800.0f },
+    { TRIO_PARAM_ID_SYSTEM_CURRENT_MAX, 250.0f },
+    { TRIO_PARAM_ID_SYSTEM_POWER_MAX,   120.0f },
+    { TRIO_PARAM_ID_SYSTEM_TEMP_MAX,    200.0f }  // Above 150 C
+  };
+  HOST_CHECK(!setTrioParams(limits, 4, true));
+  HOST_CHECK(limitsUnchanged());
+  HOST_CHECK(dirtyMarks == 0);
+
+  limits[3].value = 85.0f;
+  HOST_CHECK(setTrioParams(limits, 4, true));
+  HOST_CHECK(trioHPConfig.systemVoltageMax == 800.0f);
+  HOST_CHECK(trioHPConfig.systemTempMax == 85.0f);
+  HOST_CHECK(dirtyMarks == 1);
+  HOST_CHECK(profileEdits == 0);  // EEPROM-class limits do not touch the profile
+}
+
+// FC16 over 5233-5236 (V/A/kW/C max, x10)
+static void testRegisterBlockRange() {
+  resetConfig();
+  uint16_t values[] = { 8000, 2500, 1200, 2000 };
+  HOST_CHECK(!writeTrioParamRegisters(reg(33), 4, values));
+  HOST_CHECK(limitsUnchanged());
+
+  values[3] = 850;
+  HOST_CHECK(writeTrioParamRegisters(reg(33), 4, values));
+  HOST_CHECK(trioHPConfig.systemVoltageMax == 800.0f);
+  HOST_CHECK(trioHPConfig.systemCurrentMax == 250.0f);
+  HOST_CHECK(trioHPConfig.systemPowerMax == 120.0f);
+  HOST_CHECK(trioHPConfig.systemTempMax == 85.0f);
+}
+
+static void testRegisterBlockLockedAndUnassigned() {
+  resetConfig();
+  uint16_t limits[] = { 8000, 2500 };
+  trioHPConfig.parameterLock.parameters_locked = true;
+  trioHPConfig.parameterLock.safety_parameters_locked = true;
+  HOST_CHECK(!writeTrioParamRegisters(reg(33), 2, limits));
+  HOST_CHECK(limitsUnchanged());
+  trioHPConfig.parameterLock.parameters_locked = false;
+
+  // 5211 is priority_polling, 5212 has no parameter
+  uint16_t flags[] = { 0, 1 };
+  HOST_CHECK(findTrioParamByRegister(reg(12)) == nullptr);
+  HOST_CHECK(!writeTrioParamRegisters(reg(11), 2, flags));
+  HOST_CHECK(trioHPConfig.timing.enablePriorityPolling);
+}
+
+// Cross-field rules see the whole block: min above the current max is fine
+// when the same block raises max, and rolled back when it does not
+static void testRegisterBlockCrossField() {
+  resetConfig();
+  uint16_t raise[] = { 6000, 8000 };
+  HOST_CHECK(writeTrioParamRegisters(reg(32), 2, raise));
+  HOST_CHECK(trioHPConfig.systemVoltageMin == 600.0f);
+  HOST_CHECK(trioHPConfig.systemVoltageMax == 800.0f);
+
+  uint16_t inverted[] = { 7000, 6500 };
+  HOST_CHECK(!writeTrioParamRegisters(reg(32), 2, inverted));
+  HOST_CHECK(trioHPConfig.systemVoltageMin == 600.0f);
+  HOST_CHECK(trioHPConfig.systemVoltageMax == 800.0f);
+
+  // Fast/slow multicast swapped in one block (5201-5202): 1500/3000 from 500/1000
+  uint16_t multicast[] = { 1500, 3000 };
+  HOST_CHECK(writeTrioParamRegisters(reg(1), 2, multicast));
+  HOST_CHECK(trioHPConfig.timing.multicastFastInterval == 1500);
+  HOST_CHECK(trioHPConfig.timing.multicastSlowInterval == 3000);
+  HOST_CHECK(profileEdits == 1);
+}
+
+int main() {
+  hostSerialEcho = false;
+  initTrioHPParams();
+  testLimitsBatch();
+  testRegisterBlockRange();
+  testRegisterBlockLockedAndUnassigned();
+  testRegisterBlockCrossField();
+  return hostTestResult();
+}
@@ -0,0 +1,241 @@
+// =====================================================================
+// === test_trio_sequencer.cpp - TRIO HP startup/shutdown sequencer ===
+// =====================================================================
+//
+// Host simulation of trio_hp_sequencer.cpp against stubbed modules that
+// answer each command after 5-45 ms. The sequencer is ticked every 1 ms,
+// like the main loop does while a sequence is active.
+//
+// HOST_SOURCES: src/trio_hp_sequencer.cpp
+//
+// =====================================================================
+
+#include "host_runtime.h"
+#include "trio_hp_sequencer.h"
+#include "trio_hp_manager.h"
+#include "trio_hp_limits.h"
+#include "trio_hp_controllers.h"
+#include "bms_data.h"
+
+// === FAKE MANAGER / CONTROLLERS ===
+TrioHPSystemConfig_t trioHPConfig;
+TrioModuleInfo_t trioModules[TRIO_HP_MAX_MODULES];
+
+static TrioActivePowerController_t activePower;
+static BMSData bms;
+static unsigned long ackAt[256];
+static uint16_t awaited[256];
+static bool awaitedRead[256];
+static int nationalSettingsBroadcasts = 0;
+static int statusReads = 0;      // 0x23 status reads sent while a read response was armed
+static int onOffWrites = 0;      // 0x1110 writes addressed to a single module
+
+uint8_t findModuleSlot(uint8_t moduleId) {
+  for (uint8_t i = 0; i < TRIO_HP_MAX_MODULES; i++) {
+    if (trioModules[i].moduleId == moduleId) return i;
+  }
+  return TRIO_HP_INVALID_MODULE_ID;
+}
+
+bool isModuleOnline(uint8_t moduleId) {
+  uint8_t slot = findModuleSlot(moduleId);
+  return slot != TRIO_HP_INVALID_MODULE_ID && trioModules[slot].isOnline;
+}
+
+uint8_t getActiveModuleCount() {
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < TRIO_HP_MAX_MODULES; i++) {
+    if (trioModules[i].moduleId != TRIO_HP_INVALID_MODULE_ID && trioModules[i].isOnline) count++;
+  }
+  return count;
+}
+
+bool expectModuleResponse(uint8_t moduleId, uint16_t command) {
+  awaited[moduleId] = command;
+  awaitedRead[moduleId] = false;
+  ackAt[moduleId] = millis() + 5 + rand() % 41;
+  return true;
+}
+
+bool expectModuleReadResponse(uint8_t moduleId, uint16_t command) {
+  expectModuleResponse(moduleId, command);
+  awaitedRead[moduleId] = true;
+  return true;
+}
+
+bool sendModuleReadRequest(uint8_t moduleId, uint16_t command) {
+  if (command == TRIO_HP_CMD_MODULE_STATUS && awaited[moduleId] == command && awaitedRead[moduleId]) statusReads++;
+  return true;
+}
+
+TrioResponseStatus_t getModuleResponseStatus(uint8_t moduleId, uint16_t command) {
+  if (awaited[moduleId] != command) return TRIO_RESPONSE_NONE;
+  return millis() >= ackAt[moduleId] ? TRIO_RESPONSE_ACK : TRIO_RESPONSE_PENDING;
+}
+
+bool sendBroadcastCommand(uint16_t command, uint32_t) {
+  if (command == TRIO_HP_CMD_NATIONAL_SETTINGS) nationalSettingsBroadcasts++;
+  return true;
+}
+
+bool sendModuleCommand(uint8_t, uint16_t command, uint32_t) {
+  if (command == TRIO_HP_CMD_MODULE_ON_OFF) onOffWrites++;
+  return true;
+}
+bool setModuleWorkMode(uint8_t, TrioWorkMode_t) { return true; }
+bool sendFloatCommand(uint8_t, uint16_t, float) { return true; }
+bool setSystemOperationalReadiness(bool) { return true; }
+bool setActivePowerTarget(float) { return true; }
+const TrioHPModuleConfig_t* getModuleConfig(uint8_t) { return nullptr; }
+const TrioActivePowerController_t* getActivePowerControllerStatus() { return &activePower; }
+bool isEstopActive() { return false; }
+bool isACContactorClosed() { return true; }
+bool isBMSNodeActive(uint8_t) { return true; }
+BMSData* getBMSData(uint8_t) {
+  bms.readyToCharge = true;
+  bms.communicationOk = true;
+  bms.lastUpdate = millis();
+  return &bms;
+}
+const char* getStartupStepName(TrioStartupStep_t) { return "step"; }
+const char* getShutdownStepName(TrioShutdownStep_t) { return "step"; }
+
+// === SCENARIO HELPERS ===
+
+static void resetFleet(uint8_t maxActiveModules) {
+  for (uint8_t i = 0; i < TRIO_HP_MAX_MODULES; i++) {
+    memset(&trioModules[i], 0, sizeof(TrioModuleInfo_t));
+    trioModules[i].moduleId = TRIO_HP_INVALID_MODULE_ID;
+  }
+  memset(awaited, 0, sizeof(awaited));
+  trioHPConfig.maxActiveModules = maxActiveModules;
+  trioHPConfig.systemCurrentMax = 500.0f;
+  activePower.calculated_current = 480.0f;
+  nationalSettingsBroadcasts = 0;
+  statusReads = 0;
+  onOffWrites = 0;
+  srand(78);
+}
+
+static void registerFakeModule(uint8_t slot, uint8_t moduleId, bool online) {
+  trioModules[slot].moduleId = moduleId;
+  trioModules[slot].state = TRIO_MODULE_STATE_DISCOVERED;
+  trioModules[slot].discoveryTime = millis();
+  trioModules[slot].isOnline = online;
+}
+
+typedef struct {
+  unsigned long durationMs;
+  bool steppedBack;   // current_step dropped below step 6 after the module phase started
+} StartupRun_t;
+
+// lateModuleAtMs: register one more online module that many ms after step 6 started (0 = none)
+static StartupRun_t runStartup(unsigned long lateModuleAtMs, uint8_t lateSlot) {
+  StartupRun_t run = { 0, false };
+  bool modulePhase = false;
+  unsigned long modulePhaseStart = 0;
+  unsigned long start = millis();
+
+  HOST_CHECK(startTrioHPStartupSequence());
+  while (trioHPConfig.startup.startup_in_progress && millis() - start < 60000) {
+    processStartupSequenceStep();
+    TrioStartupStep_t step = trioHPConfig.startup.current_step;
+    if (!modulePhase && step == TRIO_STARTUP_STEP_MODULE_STATE_READ) {
+      modulePhase = true;
+      modulePhaseStart = millis();
+    }
+    if (modulePhase && step < TRIO_STARTUP_STEP_MODULE_STATE_READ) run.steppedBack = true;
+    if (modulePhase && lateModuleAtMs > 0 && millis() - modulePhaseStart == lateModuleAtMs) {
+      registerFakeModule(lateSlot, 100 + lateSlot, true);
+    }
+    hostAdvanceMs(1);
+  }
+  run.durationMs = millis() - start;
+  return run;
+}
+
+// === SCENARIOS ===
+
+// 48 modules, all known before the start: every module walks its own steps
+static void testFullFleet() {
+  resetFleet(48);
+  for (uint8_t i = 0; i < 48; i++) registerFakeModule(i, i + 1, true);
+  hostAdvanceMs(10000);
+
+  StartupRun_t run = runStartup(0, 0);
+  const TrioSequencerStats_t* stats = getSequencerStats();
+  printf("full fleet: %lu ms, %d ready, %d excluded, %lu retries\n", run.durationMs,
+         stats->readyModules, stats->failedModules, (unsigned long)stats->commandRetries);
+  HOST_CHECK(trioHPConfig.startup.startup_successful);
+  HOST_CHECK(stats->readyModules == 48);
+  HOST_CHECK(stats->failedModules == 0);
+  HOST_CHECK(run.durationMs < 300);
+  HOST_CHECK(!run.steppedBack);
+  HOST_CHECK(statusReads == 48);     // Step 6 reads the state, no ON/OFF write
+  HOST_CHECK(onOffWrites == 0);
+
+  HOST_CHECK(startTrioHPShutdownSequence());
+  unsigned long start = millis();
+  while (trioHPConfig.shutdown.shutdown_in_progress && millis() - start < 60000) {
+    processShutdownSequenceStep();
+    hostAdvanceMs(1);
+  }
+  printf("shutdown: %lu ms\n", stats->lastShutdownDurationMs);
+  HOST_CHECK(trioHPConfig.shutdown.shutdown_successful);
+  HOST_CHECK(stats->lastShutdownDurationMs < 100);
+}
+
+// Fewer modules than maxActiveModules: a stable registered set closes the join window
+static void testStableSetClosesJoinWindow() {
+  resetFleet(48);
+  for (uint8_t i = 0; i < 8; i++) registerFakeModule(i, i + 1, true);
+  hostAdvanceMs(10000);
+
+  StartupRun_t run = runStartup(0, 0);
+  printf("8 of 48: %lu ms\n", run.durationMs);
+  HOST_CHECK(trioHPConfig.startup.startup_successful);
+  HOST_CHECK(getSequencerStats()->readyModules == 8);
+  HOST_CHECK(run.durationMs < TRIO_SEQ_HEARTBEAT_WINDOW_MS / 10);
+}
+
+// A module discovered during the module phase joins without re-running steps 4-5
+static void testLateModuleJoins() {
+  resetFleet(48);
+  for (uint8_t i = 0; i < 8; i++) registerFakeModule(i, i + 1, true);
+  hostAdvanceMs(10000);
+
+  StartupRun_t run = runStartup(20, 8);
+  printf("late module: %lu ms, broadcasts %d\n", run.durationMs, nationalSettingsBroadcasts);
+  HOST_CHECK(trioHPConfig.startup.startup_successful);
+  HOST_CHECK(getSequencerStats()->readyModules == 9);
+  HOST_CHECK(!run.steppedBack);
+  HOST_CHECK(nationalSettingsBroadcasts == 1);
+  HOST_CHECK(run.durationMs >= TRIO_SEQ_JOIN_SETTLE_MS);
+  HOST_CHECK(run.durationMs < TRIO_SEQ_HEARTBEAT_WINDOW_MS);
+}
+
+// A registered module that never sends a heartbeat is excluded when the window expires
+static void testSilentModuleExcluded() {
+  resetFleet(48);
+  for (uint8_t i = 0; i < 4; i++) registerFakeModule(i, i + 1, true);
+  registerFakeModule(4, 5, false);
+  hostAdvanceMs(10000);
+
+  StartupRun_t run = runStartup(0, 0);
+  printf("silent module: %lu ms\n", run.durationMs);
+  HOST_CHECK(trioHPConfig.startup.startup_successful);
+  HOST_CHECK(getSequencerStats()->readyModules == 4);
+  HOST_CHECK(getSequencerStats()->failedModules == 1);
+  HOST_CHECK(!run.steppedBack);
+  HOST_CHECK(nationalSettingsBroadcasts == 1);
+  HOST_CHECK(run.durationMs >= TRIO_SEQ_HEARTBEAT_WINDOW_MS);
+}
+
+int main() {
+  hostSerialEcho = false;
+  testFullFleet();
+  testStableSetClosesJoinWindow();
+  testLateModuleJoins();
+  testSilentModuleExcluded();
+  return hostTestResult();
+}